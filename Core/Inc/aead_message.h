@@ -0,0 +1,38 @@
+/**
+ ******************************************************************************
+ * @file    aead_message.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   descriptors of the messages of an AEAD batch
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef AEAD_MESSAGE_H
+#define AEAD_MESSAGE_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * A message sealed with the key of its batch, the output can be the input
+ * (in place)
+ */
+typedef struct {
+    const uint8_t* nonce; // 96 bits
+    const uint8_t* aad;   // can be NULL if aad_length is 0
+    uint32_t aad_length;
+    const uint8_t* input;
+    uint8_t* output;
+    uint32_t length;
+    uint8_t* tag;         // 128 bits
+} aead_message_t;
+
+#endif
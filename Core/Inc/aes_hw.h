@@ -4,6 +4,10 @@
  * @author  nicolas.brunner@heig-vd.ch
  * @date    05-August-2016
  * @brief   hardware AES
+ *
+ * The output of an operation can be its input (in place), also by DMA and
+ * for the asynchronous jobs: the peripheral reads a block before writing its
+ * result. An output which partly overlaps the input is rejected.
  ******************************************************************************
  * @copyright HEIG-VD
  *
@@ -20,26 +24,369 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "aead_message.h"
+#include "fragment.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * Completion callback of an asynchronous operation, called from the AES interrupt
+ * @param result true if the operation success
+ * @param context the pointer given when the operation was queued
+ */
+typedef void (*aes_hw_callback_t)(bool result, void* context);
+
+/**
+ * Priority of the asynchronous jobs, an urgent job suspends the running bulk
+ * job, which is resumed when no urgent job is left
+ */
+typedef enum {
+    AES_HW_PRIORITY_BULK,
+    AES_HW_PRIORITY_URGENT,
+} aes_hw_priority_t;
+
+/**
+ * Key context of the hardware AES, the key is loaded in the peripheral by the
+ * first operation and kept as long as no other key is used.
+ */
+typedef struct {
+    uint8_t key[32];
+    uint8_t decryption_key[32]; // derived once at init, for ECB/CBC decryption
+    uint32_t key_size; // CRYP_KEYSIZE_xxx
+} aes_hw_session_t;
+
+/**
+ * Context of a CTR or GCM operation processed in pieces, the counter and the
+ * GCM hash stay in the peripheral between the pieces
+ */
+typedef struct {
+    bool gcm;
+    uint32_t aad_length;
+    uint32_t length; // payload processed so far
+    bool partial; // a piece not a multiple of 16 was processed, it was the last one
+} aes_hw_stream_t;
+
 /* Exported functions --------------------------------------------------------*/
 
 void aes_hw_init(void);
 
+/**
+ * Select the key size of the next operations, 128 bits after aes_hw_init()
+ * The queued asynchronous jobs and the sessions keep the size they were
+ * created with.
+ * @param size the size of the key in byte, 16 or 32 (the peripheral has no
+ * 192 bits keys)
+ * @return true if the size is supported
+ */
+bool aes_hw_set_key_size(uint32_t size);
+
 /**
  * Encrypt using AES in CTR Mode
- * @param key the 128 bits key used for AES algorithm.
+ * The data longer than the 64 KB of a HAL call are processed in chunks, the
+ * counter continues in the peripheral. The last partial block is encrypted in
+ * a copy, no byte past the length is written.
+ * @param key the key used for AES algorithm, of the size given to aes_hw_set_key_size()
  * @param init_vector Initialization Vector used for AES algorithm.
  * @param plain_data pointer to the data to encrypt
  * @param length the length of the data to encrypt in byte
  * @param cipher_data: pointer to the encrypted data
  * @return true if operation success
  */
-bool aes_hw_ctr_encrypt(uint8_t* key, uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data);
+bool aes_hw_ctr_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data);
 
 // AES CTR decryption is the same than encryption
 #define aes_hw_ctr_decrypt aes_ctr_encrypt
 
-bool aes_hw_gcm_encrypt(uint8_t* key, uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic);
+/**
+ * Encrypt using AES in ECB Mode
+ * @param key the key used for AES algorithm, of the size given to aes_hw_set_key_size()
+ * @param plain_data pointer to the data to encrypt
+ * @param length the length of the data to encrypt in byte, multiple of 16
+ * @param cipher_data pointer to the encrypted data
+ * @return true if operation success
+ */
+bool aes_hw_ecb_encrypt(const uint8_t* key, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data);
+
+/**
+ * Decrypt using AES in ECB Mode
+ * The decryption key is derived by the peripheral the first time a key is
+ * used and kept for the next calls with the same key.
+ * @see aes_hw_ecb_encrypt()
+ */
+bool aes_hw_ecb_decrypt(const uint8_t* key, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data);
+
+/**
+ * Encrypt using AES in CBC Mode
+ * @param init_vector Initialization Vector used for AES algorithm.
+ * @see aes_hw_ecb_encrypt()
+ */
+bool aes_hw_cbc_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data);
+
+/**
+ * Decrypt using AES in CBC Mode, with the cached decryption key
+ * @see aes_hw_ecb_decrypt()
+ */
+bool aes_hw_cbc_decrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data);
 
-bool aes_hw_gcm_decrypt(uint8_t* key, uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, uint8_t* mic);
+bool aes_hw_gcm_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic);
+
+bool aes_hw_gcm_decrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, uint8_t* mic);
+
+/**
+ * Encrypt using AES in GCM Mode with additional authenticated data
+ * The header and the payload can have any length, the last partial blocks are
+ * copied to an aligned block so the peripheral never reads or writes past the
+ * buffers.
+ * @param key the key used for AES algorithm, of the size given to aes_hw_set_key_size()
+ * @param init_vector the 96 bits IV (the counter starts at 2, as in SP 800-38D)
+ * @param aad the additional authenticated data, can be NULL if aad_length is 0
+ * @param aad_length the length of the additional authenticated data in byte
+ * @param plain_data pointer to the data to encrypt
+ * @param length the length of the data to encrypt in byte
+ * @param cipher_data pointer to the encrypted data
+ * @param tag the 128 bits authentication tag
+ * @return true if operation success
+ */
+bool aes_hw_gcm_aad_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* aad, uint32_t aad_length,
+        const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* tag);
+
+/**
+ * Decrypt using AES in GCM Mode with additional authenticated data and verify
+ * the tag, the comparison takes the same time whatever the tag
+ * @param tag the 128 bits authentication tag to verify
+ * @return true if the operation success and the tag is valid, the plain data
+ * are cleared if the tag is not valid
+ * @see aes_hw_gcm_aad_encrypt()
+ */
+bool aes_hw_gcm_aad_decrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* aad, uint32_t aad_length,
+        const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, const uint8_t* tag);
+
+/**
+ * Encrypt a batch of messages using AES in GCM Mode under one key, each with
+ * its nonce and additional authenticated data
+ * The key is written to the peripheral by the first message only.
+ * @param key the key used for AES algorithm, of the size given to aes_hw_set_key_size()
+ * @param messages the messages, processed in order, of any length
+ * @param number the number of messages
+ * @return true if operation success for every message, false at once during
+ * a DMA or an asynchronous operation
+ */
+bool aes_hw_gcm_encrypt_batch(const uint8_t* key, const aead_message_t* messages, uint32_t number);
+
+/**
+ * Start the encryption of a batch by DMA, the end is given by aes_hw_busy()
+ * and aes_hw_wait()
+ * Each message starts from the interrupt of the end of the previous one, its
+ * init, header and final phases are short and done in polling there.
+ * @param messages the messages, their payloads are whole blocks (at least
+ * one), the array must be kept until the end
+ * @return true if the batch is started
+ * @see aes_hw_gcm_encrypt_batch()
+ */
+bool aes_hw_gcm_encrypt_batch_dma(const uint8_t* key, const aead_message_t* messages, uint32_t number);
+
+/**
+ * Start an encryption using AES in CTR Mode of data given in pieces
+ * The peripheral is reserved to the stream until aes_hw_stream_end(), no other
+ * operation can be done in between.
+ * @param stream the context of the stream
+ * @param key the key used for AES algorithm, of the size given to aes_hw_set_key_size()
+ * @param init_vector Initialization Vector used for AES algorithm.
+ * @return true if operation success
+ */
+bool aes_hw_stream_ctr_begin(aes_hw_stream_t* stream, const uint8_t* key, const uint8_t* init_vector);
+
+/**
+ * Start an encryption or a decryption using AES in GCM Mode of a payload
+ * given in pieces, the init and header phases are done before returning
+ * @param decrypt true to decrypt, the plain data are given before the tag is
+ * known, the caller must compare it before using them
+ * @see aes_hw_gcm_aad_encrypt()
+ * @return true if operation success
+ */
+bool aes_hw_stream_gcm_begin(aes_hw_stream_t* stream, bool decrypt, const uint8_t* key, const uint8_t* init_vector,
+        const uint8_t* aad, uint32_t aad_length);
+
+/**
+ * Process the next piece of a stream
+ * @param length the length of the piece in byte, multiple of 16 except for
+ * the last piece
+ * @return true if operation success, false after a last piece
+ */
+bool aes_hw_stream_update(aes_hw_stream_t* stream, const uint8_t* input, uint32_t length, uint8_t* output);
+
+/**
+ * Process the next piece of a stream given as a list of fragments, without
+ * copying them to a contiguous buffer
+ * The fragments can have any length, the blocks across two fragments are
+ * gathered by fragment_process().
+ * @param fragments the fragments, their total length is a multiple of 16
+ * except for the last piece of the stream
+ * @param number the number of fragments
+ * @return true if operation success
+ */
+bool aes_hw_stream_update_fragments(aes_hw_stream_t* stream, const fragment_t* fragments, uint32_t number);
+
+/**
+ * End a stream and release the peripheral
+ * @param tag the 128 bits GCM tag, unused (can be NULL) for CTR
+ * @return true if operation success
+ */
+bool aes_hw_stream_end(aes_hw_stream_t* stream, uint8_t* tag);
+
+/**
+ * Encrypt using AES in CCM Mode (SP 800-38C, also the CCM* of IEEE 802.15.4
+ * with a 13 bytes nonce)
+ * The payload is encrypted in CTR mode and the tag computed by the CBC-MAC of
+ * the peripheral (CMAC chaining mode), one pass each.
+ * @param key the key used for AES algorithm, of the size given to aes_hw_set_key_size()
+ * @param nonce the nonce, 7 to 13 bytes
+ * @param nonce_length the length of the nonce in byte
+ * @param aad the additional authenticated data, can be NULL if aad_length is 0
+ * @param aad_length the length of the additional authenticated data in byte,
+ * less than 0xFF00
+ * @param plain_data pointer to the data to encrypt
+ * @param length the length of the data to encrypt in byte
+ * @param cipher_data pointer to the encrypted data
+ * @param tag the authentication tag
+ * @param tag_length the length of the tag in byte, 4 to 16 and even
+ * @return true if operation success
+ */
+bool aes_hw_ccm_encrypt(const uint8_t* key, const uint8_t* nonce, uint32_t nonce_length, const uint8_t* aad, uint32_t aad_length,
+        const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* tag, uint32_t tag_length);
+
+/**
+ * Decrypt using AES in CCM Mode and verify the tag in constant time
+ * @param tag the authentication tag to verify
+ * @return true if the operation success and the tag is valid, the plain data
+ * are cleared if the tag is not valid
+ * @see aes_hw_ccm_encrypt()
+ */
+bool aes_hw_ccm_decrypt(const uint8_t* key, const uint8_t* nonce, uint32_t nonce_length, const uint8_t* aad, uint32_t aad_length,
+        const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, const uint8_t* tag, uint32_t tag_length);
+
+/**
+ * Compute the AES-CMAC of a message (SP 800-38B, RFC 4493)
+ * The subkey is computed by an ECB encryption and the message authenticated
+ * by the CBC-MAC of the peripheral.
+ * @param key the key used for AES algorithm, of the size given to aes_hw_set_key_size()
+ * @param data the message, can be NULL if length is 0
+ * @param length the length of the message in byte
+ * @param tag the 128 bits tag
+ * @return true if operation success
+ */
+bool aes_hw_cmac_generate(const uint8_t* key, const uint8_t* data, uint32_t length, uint8_t* tag);
+
+/**
+ * Verify the AES-CMAC of a message, the comparison takes the same time
+ * whatever the tag
+ * @param tag the 128 bits tag to verify
+ * @return true if the operation success and the tag is valid
+ * @see aes_hw_cmac_generate()
+ */
+bool aes_hw_cmac_verify(const uint8_t* key, const uint8_t* data, uint32_t length, const uint8_t* tag);
+
+/**
+ * Start an encryption using AES in CTR Mode, the data are moved by DMA
+ * The function returns as soon as the transfer is started, use aes_hw_wait()
+ * or aes_hw_busy() to know when the cipher data are available.
+ * @param key the key used for AES algorithm, of the size given to aes_hw_set_key_size()
+ * @param init_vector Initialization Vector used for AES algorithm.
+ * @param plain_data pointer to the data to encrypt, must be 32-bit aligned
+ * @param length the length of the data to encrypt in byte, multiple of 16
+ * @param cipher_data: pointer to the encrypted data, must be 32-bit aligned
+ * @return true if the operation is started
+ */
+bool aes_hw_ctr_encrypt_dma(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data);
+
+/**
+ * Start an encryption using AES in GCM Mode, the payload is moved by DMA
+ * The init and header phases are done before returning, the final phase
+ * (mic) is done from the DMA interrupt.
+ * @return true if the operation is started
+ */
+bool aes_hw_gcm_encrypt_dma(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic);
+
+bool aes_hw_gcm_decrypt_dma(const uint8_t* key, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, uint8_t* mic);
+
+/**
+ * @return true while a DMA operation is on-going
+ */
+bool aes_hw_busy(void);
+
+/**
+ * Wait the end of the on-going DMA operation
+ * @return true if the operation success
+ */
+bool aes_hw_wait(void);
+
+/**
+ * Initialize a session, compute the decryption key
+ * @param session the session to initialize
+ * @param key the key used for AES algorithm, copied in the session with the
+ * current key size
+ * @return true if operation success
+ */
+bool aes_hw_session_init(aes_hw_session_t* session, const uint8_t* key);
+
+/**
+ * Encrypt using AES in CTR Mode with the key of the session, the key is
+ * written in the peripheral only if it is not already loaded.
+ * @see aes_hw_ctr_encrypt()
+ * @return true if operation success
+ */
+bool aes_hw_session_ctr_encrypt(aes_hw_session_t* session, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data);
+
+bool aes_hw_session_gcm_encrypt(aes_hw_session_t* session, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic);
+
+bool aes_hw_session_gcm_decrypt(aes_hw_session_t* session, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, uint8_t* mic);
+
+/**
+ * Queue an encryption using AES in CTR Mode, processed under interrupt
+ * The jobs are processed in order, back-to-back from the AES interrupt. The
+ * buffers must stay valid until the callback is called. The polling and DMA
+ * functions must not be used while jobs are pending.
+ * @param key the key used for AES algorithm, of the size given to aes_hw_set_key_size()
+ * @param init_vector Initialization Vector used for AES algorithm.
+ * @param plain_data pointer to the data to encrypt, must be 32-bit aligned
+ * @param length the length of the data to encrypt in byte, multiple of 16
+ * @param cipher_data: pointer to the encrypted data, must be 32-bit aligned
+ * @param callback called when the job is done, can be NULL
+ * @param context given back to the callback
+ * @return true if the job is queued, false if the queue is full
+ */
+bool aes_hw_ctr_encrypt_async(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data,
+        aes_hw_callback_t callback, void* context);
+
+/**
+ * Queue an encryption using AES in GCM Mode, processed under interrupt
+ * @see aes_hw_ctr_encrypt_async()
+ * @return true if the job is queued, false if the queue is full
+ */
+bool aes_hw_gcm_encrypt_async(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic,
+        aes_hw_callback_t callback, void* context);
+
+bool aes_hw_gcm_decrypt_async(const uint8_t* key, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, uint8_t* mic,
+        aes_hw_callback_t callback, void* context);
+
+/**
+ * Select the priority of the next queued asynchronous jobs, bulk after aes_hw_init()
+ * The jobs of a priority are processed in order. A bulk job is suspended at
+ * the next block of its CTR or GCM payload (else at the end of its GCM phase)
+ * when an urgent job is queued, its context is saved and restored by software.
+ */
+void aes_hw_set_priority(aes_hw_priority_t priority);
+
+/**
+ * @return the number of queued asynchronous jobs, including the running and
+ * the suspended ones
+ */
+uint32_t aes_hw_async_pending(void);
+
+/**
+ * Complete a suspension of the HAL, called from the AES interrupt after
+ * HAL_CRYP_IRQHandler()
+ */
+void aes_hw_irq_handler(void);
 
 #endif
@@ -0,0 +1,72 @@
+/**
+ ******************************************************************************
+ * @file    aes_hybrid.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   AES CTR split between the peripheral and CMOX
+ *
+ * The keystream of CTR only depends on the position, so the peripheral
+ * encrypts the beginning of the buffer by DMA while the CPU encrypts the end
+ * with CMOX, starting at the right counter. The share of the peripheral is
+ * tuned after every call from the measured times, so both parts end at the
+ * same time. The cycle counter must be enabled (bench_init()).
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef AES_HYBRID_H
+#define AES_HYBRID_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "aes_sw.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+// the share of the peripheral is in 1/AES_HYBRID_SHARE_ONE of the length
+#define AES_HYBRID_SHARE_ONE 256
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef struct {
+    uint8_t key[32]; // the first key_size bytes
+    aes_sw_ctr_context_t sw;
+    uint32_t share; // of the peripheral, tuned by every call
+} aes_hybrid_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * Initialize a hybrid context, the peripheral and CMOX start with half of
+ * the data each
+ * @param hybrid the context to initialize
+ * @param key the key used for AES algorithm
+ * @param key_size the size of the key in byte, the one given to both
+ * aes_hw_set_key_size() and aes_sw_set_key_size()
+ * @return true if operation success
+ */
+bool aes_hybrid_init(aes_hybrid_t* hybrid, const uint8_t* key, uint32_t key_size);
+
+/**
+ * Encrypt using AES in CTR Mode with both engines, then update the share
+ * The DMA of the peripheral must be free.
+ * @param hybrid an initialized context
+ * @param init_vector Initialization Vector used for AES algorithm, the
+ * counter is the last 32 bits, as for the peripheral
+ * @param plain_data pointer to the data to encrypt, must be 32-bit aligned
+ * @param length the length of the data to encrypt in byte
+ * @param cipher_data pointer to the encrypted data, must be 32-bit aligned
+ * @return true if operation success
+ */
+bool aes_hybrid_ctr_encrypt(aes_hybrid_t* hybrid, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data);
+
+void aes_hybrid_cleanup(aes_hybrid_t* hybrid);
+
+#endif
@@ -0,0 +1,135 @@
+/**
+ ******************************************************************************
+ * @file    aes_select.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   AES engine selected at every call from a calibration table
+ *
+ * The table gives, for each mode and engine (the peripheral, CMOX FAST and
+ * CMOX SMALL), the linear fit t = slope * length + intercept of a message
+ * and the time of a key change. It is measured at startup by
+ * aes_select_calibrate() or given by aes_select_set_table(), e.g. from the
+ * fits of a benchmark run. Every call takes the engine of the lowest
+ * estimated time for its length, the key setup being weighted by the rate of
+ * the key changes of the last calls. The choices are counted.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef AES_SELECT_H
+#define AES_SELECT_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+// the rate of the key changes is in 1/AES_SELECT_RATE_ONE of the calls
+#define AES_SELECT_RATE_ONE 256
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef enum {
+    AES_SELECT_HW,
+    AES_SELECT_SW_FAST,
+    AES_SELECT_SW_SMALL,
+    AES_SELECT_ENGINE_NUMBER
+} aes_select_engine_t;
+
+typedef enum {
+    AES_SELECT_CTR,
+    AES_SELECT_GCM, // encryption, with the 16 bytes header of aes_sw
+    AES_SELECT_MODE_NUMBER
+} aes_select_mode_t;
+
+typedef struct {
+    uint32_t slope_thousandths; // in thousandths of cycle per byte
+    int32_t intercept;          // the fixed overhead of a call in cycles
+    uint32_t key_setup;         // cycles added by a new key
+} aes_select_cost_t;
+
+typedef struct {
+    aes_select_cost_t costs[AES_SELECT_MODE_NUMBER][AES_SELECT_ENGINE_NUMBER];
+} aes_select_table_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * Reset the table (every engine costs the same, the peripheral is chosen),
+ * the counters and the key size to 128 bits
+ * aes_hw_init() and aes_sw_init() must have been called.
+ */
+void aes_select_init(void);
+
+/**
+ * Select the key size of the next operations of both engines, the peripheral
+ * is not chosen for 192 bits keys
+ * @param size the size of the key in byte, 16, 24 or 32
+ * @return true if the size is supported
+ */
+bool aes_select_set_key_size(uint32_t size);
+
+void aes_select_set_table(const aes_select_table_t* table);
+
+const aes_select_table_t* aes_select_get_table(void);
+
+/**
+ * Measure the table, each engine is timed at 16 bytes and at length bytes
+ * The cycle counter must be enabled (bench_init()), the peripheral must be
+ * free.
+ * @param key the key used for the measurements
+ * @param input the data to encrypt, length bytes
+ * @param length the length of the longest measurement in byte, more than 16
+ * @param output the encrypted data, length bytes
+ * @return true if every measurement success
+ */
+bool aes_select_calibrate(const uint8_t* key, const uint8_t* input, uint32_t length, uint8_t* output);
+
+/**
+ * @return the engine chosen for a message of the mode and length, with the
+ * current rate of key changes
+ */
+aes_select_engine_t aes_select_choose(aes_select_mode_t mode, uint32_t length);
+
+/**
+ * Encrypt using AES in CTR Mode with the chosen engine
+ * The counter is the last 32 bits for the peripheral and the whole block for
+ * CMOX, the output is the same while the 32 bits counter does not wrap.
+ * @param key the key used for AES algorithm, of the size given to aes_select_set_key_size()
+ * @see aes_sw_ctr_encrypt()
+ */
+bool aes_select_ctr_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data);
+
+/**
+ * Encrypt using AES in GCM Mode with the chosen engine
+ * @param init_vector the 96 bits IV
+ * @param mic pointer to the generated tag
+ * @see aes_sw_gcm_encrypt()
+ */
+bool aes_select_gcm_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic);
+
+/**
+ * @return the rate of the key changes of the last calls, in 1/AES_SELECT_RATE_ONE
+ */
+uint32_t aes_select_get_key_rate(void);
+
+/**
+ * @return the number of calls of the mode done by the engine since the last
+ * aes_select_reset_counters()
+ */
+uint32_t aes_select_get_counter(aes_select_mode_t mode, aes_select_engine_t engine);
+
+void aes_select_reset_counters(void);
+
+/**
+ * Release the CMOX contexts of the last key
+ */
+void aes_select_cleanup(void);
+
+#endif
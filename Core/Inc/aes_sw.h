@@ -4,6 +4,9 @@
  * @author  nicolas.brunner@heig-vd.ch
  * @date    05-August-2016
  * @brief   software AES
+ *
+ * The output of an operation can be its input (in place). An output which
+ * partly overlaps the input is rejected.
  ******************************************************************************
  * @copyright HEIG-VD
  *
@@ -20,26 +23,175 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "cmox_crypto.h"
+
+#include "aead_message.h"
+#include "fragment.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * CMOX implementation, FAST uses larger tables than SMALL
+ */
+typedef enum {
+    AES_SW_FAST,
+    AES_SW_SMALL,
+} aes_sw_variant_t;
+
+/**
+ * CTR context, the expanded key is kept between the messages
+ */
+typedef struct {
+    cmox_ctr_handle_t handle;
+    cmox_cipher_handle_t* cipher;
+} aes_sw_ctr_context_t;
+
+/**
+ * GCM context, the expanded key and the GHASH tables are kept between the
+ * messages. A context is used either for encryption or for decryption.
+ */
+typedef struct {
+    union {
+        cmox_gcmFast_handle_t fast;
+        cmox_gcmSmall_handle_t small;
+    } handle;
+    cmox_cipher_handle_t* cipher;
+} aes_sw_gcm_context_t;
+
 /* Exported functions --------------------------------------------------------*/
 
 void aes_sw_init(void);
 
+/**
+ * Select the key size of the next operations, 128 bits after aes_sw_init()
+ * The contexts keep the size they were initialized with.
+ * @param size the size of the key in byte, 16, 24 or 32
+ * @return true if the size is supported
+ */
+bool aes_sw_set_key_size(uint32_t size);
+
+/**
+ * Select the implementation of the next operations, FAST after aes_sw_init()
+ * unless FAST is not defined in aes_sw.c. The contexts keep the implementation
+ * they were initialized with.
+ */
+void aes_sw_set_variant(aes_sw_variant_t variant);
+
+aes_sw_variant_t aes_sw_get_variant(void);
+
 /**
  * Encrypt using AES in CTR Mode
- * @param key the 128 bits key used for AES algorithm.
+ * @param key the key used for AES algorithm, of the size given to aes_sw_set_key_size()
  * @param initVector Initialization Vector used for AES algorithm.
  * @param plainData pointer to the data to encrypt
  * @param length the length of the data to encrypt in byte
  * @param cipherData: pointer to the encrypted data
  * @return true if operation success
  */
-bool aes_sw_ctr_encrypt(uint8_t* key, uint8_t* initVector, const uint8_t* plainData, uint32_t length, uint8_t* cipherData);
+bool aes_sw_ctr_encrypt(const uint8_t* key, const uint8_t* initVector, const uint8_t* plainData, uint32_t length, uint8_t* cipherData);
 
 // AES CTR decryption is the same than encryption
 #define aes_sw_ctr_decrypt aes_sw_ctr_encrypt
 
-bool aes_sw_gcm_encrypt(uint8_t* key, uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic);
+/**
+ * Encrypt using AES in CBC Mode
+ * @param key the key used for AES algorithm, of the size given to aes_sw_set_key_size()
+ * @param init_vector Initialization Vector used for AES algorithm.
+ * @param plain_data pointer to the data to encrypt
+ * @param length the length of the data to encrypt in byte, multiple of 16
+ * @param cipher_data pointer to the encrypted data
+ * @return true if operation success
+ */
+bool aes_sw_cbc_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data);
+
+/**
+ * Decrypt using AES in CBC Mode
+ * @see aes_sw_cbc_encrypt()
+ */
+bool aes_sw_cbc_decrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data);
+
+bool aes_sw_gcm_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic);
+
+bool aes_sw_gcm_decrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, uint8_t* mic);
+
+/**
+ * Initialize a CTR context, the key is expanded once
+ * @param context the context to initialize
+ * @param key the key used for AES algorithm, of the size given to aes_sw_set_key_size()
+ * @return true if operation success
+ */
+bool aes_sw_ctr_context_init(aes_sw_ctr_context_t* context, const uint8_t* key);
+
+/**
+ * Encrypt a message using AES in CTR Mode with the key of the context
+ * @param context an initialized context
+ * @param init_vector Initialization Vector of this message
+ * @param plain_data pointer to the data to encrypt
+ * @param length the length of the data to encrypt in byte
+ * @param cipher_data: pointer to the encrypted data
+ * @return true if operation success
+ */
+bool aes_sw_ctr_context_encrypt(aes_sw_ctr_context_t* context, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data);
+
+/**
+ * Encrypt a message given as a list of fragments, without copying them to a
+ * contiguous buffer, the fragments can have any length
+ * @param fragments the fragments of the message, in order
+ * @param number the number of fragments
+ * @see aes_sw_ctr_context_encrypt()
+ */
+bool aes_sw_ctr_context_encrypt_fragments(aes_sw_ctr_context_t* context, const uint8_t* init_vector,
+        const fragment_t* fragments, uint32_t number);
+
+void aes_sw_ctr_context_cleanup(aes_sw_ctr_context_t* context);
+
+/**
+ * Initialize a GCM context, the key is expanded and the GHASH tables computed once
+ * @param context the context to initialize
+ * @param key the key used for AES algorithm, of the size given to aes_sw_set_key_size()
+ * @param decrypt true for a decryption context, false for an encryption context
+ * @return true if operation success
+ */
+bool aes_sw_gcm_context_init(aes_sw_gcm_context_t* context, const uint8_t* key, bool decrypt);
+
+/**
+ * Encrypt a message using AES in GCM Mode with the key of the context
+ * @param mic pointer to the generated tag
+ * @return true if operation success
+ */
+bool aes_sw_gcm_context_encrypt(aes_sw_gcm_context_t* context, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic);
+
+/**
+ * Decrypt a message using AES in GCM Mode with the key of the context
+ * @param mic pointer to the tag to verify
+ * @return true if operation success and the tag is valid
+ */
+bool aes_sw_gcm_context_decrypt(aes_sw_gcm_context_t* context, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, const uint8_t* mic);
+
+/**
+ * Encrypt a message given as a list of fragments using AES in GCM Mode
+ * @see aes_sw_ctr_context_encrypt_fragments()
+ * @see aes_sw_gcm_context_encrypt()
+ */
+bool aes_sw_gcm_context_encrypt_fragments(aes_sw_gcm_context_t* context, const uint8_t* init_vector,
+        const fragment_t* fragments, uint32_t number, uint8_t* mic);
+
+/**
+ * Decrypt a message given as a list of fragments using AES in GCM Mode
+ * @see aes_sw_gcm_context_decrypt()
+ */
+bool aes_sw_gcm_context_decrypt_fragments(aes_sw_gcm_context_t* context, const uint8_t* init_vector,
+        const fragment_t* fragments, uint32_t number, const uint8_t* mic);
+
+/**
+ * Encrypt a batch of messages using AES in GCM Mode with the key of the
+ * context, each with its nonce and additional authenticated data
+ * @param messages the messages, processed in order
+ * @param number the number of messages
+ * @return true if operation success for every message
+ */
+bool aes_sw_gcm_context_encrypt_batch(aes_sw_gcm_context_t* context, const aead_message_t* messages, uint32_t number);
 
-bool aes_sw_gcm_decrypt(uint8_t* key, uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, uint8_t* mic);
+void aes_sw_gcm_context_cleanup(aes_sw_gcm_context_t* context);
 
 #endif
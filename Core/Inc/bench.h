@@ -0,0 +1,97 @@
+/**
+ ******************************************************************************
+ * @file    bench.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   measurement engine
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+#define BENCH_MAX_RUNS 128
+
+// length of the text written by bench_format()
+#define BENCH_TEXT_SIZE 96
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * Statistics of the timed runs, in cycles, the overhead of the engine is
+ * already removed
+ */
+typedef struct {
+    uint32_t min;
+    uint32_t median;
+    uint32_t p99;
+    uint32_t max;
+    uint32_t mean;
+    uint32_t stddev;
+    uint32_t outliers; // runs out of the Tukey far-out fences
+    uint32_t runs;
+} bench_stats_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * Enable the cycle counter and measure the overhead of the engine
+ * @param warmup_runs the number of runs before the timed ones
+ * @param runs the number of timed runs, at most BENCH_MAX_RUNS
+ */
+void bench_init(uint32_t warmup_runs, uint32_t runs);
+
+/**
+ * Change the number of timed runs of the next measurements
+ * @param runs the number of timed runs, at most BENCH_MAX_RUNS
+ */
+void bench_set_runs(uint32_t runs);
+
+/**
+ * Start a measurement, SysTick is masked until the end of the measurement.
+ * Usage:
+ *     bench_begin(&stats);
+ *     while (bench_next(&stats)) {
+ *         // code to measure
+ *     }
+ * @param stats the statistics of the measurement, available at the end
+ */
+void bench_begin(bench_stats_t* stats);
+
+/**
+ * Record the run which just ended and start the next one
+ * @param stats the statistics given to bench_begin()
+ * @return true if the code has to be run again, false when the measurement
+ * is over and the statistics are computed
+ */
+bool bench_next(bench_stats_t* stats);
+
+/**
+ * Fill the statistics with a single measurement, for the code which can be
+ * run only once (initialization)
+ * @param stats the statistics to fill
+ * @param t the measured time in cycles
+ */
+void bench_set_single(bench_stats_t* stats, uint32_t t);
+
+/**
+ * Write the statistics as text, "min = ..., median = ..., ..."
+ * @param text buffer of at least BENCH_TEXT_SIZE bytes
+ * @param stats the statistics to write
+ * @return text
+ */
+char* bench_format(char* text, const bench_stats_t* stats);
+
+#endif
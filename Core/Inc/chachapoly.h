@@ -0,0 +1,107 @@
+/**
+ ******************************************************************************
+ * @file    chachapoly.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   streaming ChaCha20-Poly1305, the fallback without the AES peripheral
+ *
+ * A context keeps the key of the CMOX handle, a message only sets its nonce.
+ * The additional data and the payload are appended in chunks of any size: the
+ * whole blocks of a chunk are given directly to CMOX, only a block across two
+ * chunks (or more) is gathered in the context. The output of such a block is
+ * written when the block is complete or by the tag, so a chunk of a multiple
+ * of CHACHAPOLY_BLOCK_SIZE bytes is output at once. The output of a chunk can
+ * be its input (in place), an output which partly overlaps the input is
+ * rejected.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef CHACHAPOLY_H
+#define CHACHAPOLY_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cmox_crypto.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+#define CHACHAPOLY_KEY_SIZE 32
+#define CHACHAPOLY_NONCE_SIZE 12
+#define CHACHAPOLY_TAG_SIZE 16
+#define CHACHAPOLY_BLOCK_SIZE 64 // of ChaCha20
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * Context of the messages of one key, used either for encryption or for
+ * decryption
+ */
+typedef struct {
+    cmox_chachapoly_handle_t handle;
+    cmox_cipher_handle_t* cipher;
+    bool payload; // the additional data are complete
+    // the block across the chunks, with the destination of every byte
+    uint8_t data[CHACHAPOLY_BLOCK_SIZE];
+    uint8_t* output[CHACHAPOLY_BLOCK_SIZE];
+    uint32_t length;
+} chachapoly_context_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * Initialize a context, the key is set once
+ * @param context the context to initialize
+ * @param key the key, of CHACHAPOLY_KEY_SIZE bytes
+ * @param decrypt true for a decryption context, false for an encryption context
+ * @return true if operation success
+ */
+bool chachapoly_context_init(chachapoly_context_t* context, const uint8_t* key, bool decrypt);
+
+/**
+ * Start a message, only the nonce changes
+ * @param nonce the nonce of this message, of CHACHAPOLY_NONCE_SIZE bytes
+ * @return true if operation success
+ */
+bool chachapoly_context_start(chachapoly_context_t* context, const uint8_t* nonce);
+
+/**
+ * Append a chunk of the additional data, before the payload
+ * @return true if operation success
+ */
+bool chachapoly_context_append_aad(chachapoly_context_t* context, const uint8_t* aad, uint32_t length);
+
+/**
+ * Encrypt or decrypt a chunk of the payload
+ * @param input the chunk
+ * @param length its length in byte, any
+ * @param output the output of the chunk, completed later if the chunk ends
+ * inside a block
+ * @return true if operation success
+ */
+bool chachapoly_context_append(chachapoly_context_t* context, const uint8_t* input, uint32_t length, uint8_t* output);
+
+/**
+ * End an encrypted message, the pending bytes are output
+ * @param mic the generated tag, of CHACHAPOLY_TAG_SIZE bytes
+ * @return true if operation success
+ */
+bool chachapoly_context_generate_tag(chachapoly_context_t* context, uint8_t* mic);
+
+/**
+ * End a decrypted message, the pending bytes are output
+ * @param mic the tag to verify
+ * @return true if operation success and the tag is valid
+ */
+bool chachapoly_context_verify_tag(chachapoly_context_t* context, const uint8_t* mic);
+
+void chachapoly_context_cleanup(chachapoly_context_t* context);
+
+#endif
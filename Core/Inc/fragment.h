@@ -0,0 +1,61 @@
+/**
+ ******************************************************************************
+ * @file    fragment.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   scatter-gather lists of the packet buffers
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef FRAGMENT_H
+#define FRAGMENT_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+#define FRAGMENT_BLOCK_SIZE 16
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * A buffer of a packet, the output can be the input (in place)
+ */
+typedef struct {
+    const uint8_t* input;
+    uint8_t* output;
+    uint32_t length;
+} fragment_t;
+
+/**
+ * Process a piece of a message, of a multiple of FRAGMENT_BLOCK_SIZE bytes
+ * except for the last piece
+ * @param context the pointer given to fragment_process()
+ * @return true if operation success
+ */
+typedef bool (*fragment_function_t)(void* context, const uint8_t* input, uint32_t length, uint8_t* output);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * Process the fragments of a message as if they were contiguous
+ * The whole blocks of a fragment are given directly to the function, only a
+ * block across two fragments (or more) is gathered in a local block and its
+ * output scattered back.
+ * @param fragments the fragments, in order
+ * @param number the number of fragments
+ * @param function called for every piece
+ * @param context given back to the function
+ * @return true if operation success
+ */
+bool fragment_process(const fragment_t* fragments, uint32_t number, fragment_function_t function, void* context);
+
+#endif
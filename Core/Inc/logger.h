@@ -0,0 +1,45 @@
+/**
+ ******************************************************************************
+ * @file    logger.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   non-blocking UART output
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+#define LOGGER_BUFFER_SIZE 2048
+
+/* Exported functions --------------------------------------------------------*/
+
+void logger_init(void);
+
+/**
+ * Copy the data in the ring buffer and start the DMA transfer on LPUART1 if
+ * it is idle, only wait if the buffer is full. Not to be called from an
+ * interrupt.
+ * @param data the data to send
+ * @param length the length of the data in byte
+ */
+void logger_write(const void* data, uint32_t length);
+
+/**
+ * Wait until all the data are sent, to be called before a measurement so that
+ * the DMA transfers and the UART interrupts do not disturb it
+ */
+void logger_flush(void);
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ ******************************************************************************
+ * @file    pk_bench.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   benchmark of the public key algorithms of CMOX
+ *
+ * ECDSA and ECDH on P-256 and P-384, EdDSA and X25519 on Curve25519 and the
+ * RSA-2048 signatures PKCS#1 v1.5 and v2.2, with the LOWMEM and HIGHMEM
+ * implementations (and MIDMEM for the RSA private exponentiation) and the
+ * SMALL, FAST and SUPERFAST256 math functions. Every operation is reported
+ * with its timing and with the peak of the CMOX working buffer, the name
+ * being the same for both curves of ECDSA, the key size telling them apart.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef PK_BENCH_H
+#define PK_BENCH_H
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * Measure and report every operation, the signatures and shared secrets are
+ * checked out of the measurements
+ * The cycle counter must be enabled (bench_init()), the report initialized
+ * (report_init()). The key size of the report is changed.
+ */
+void pk_bench_run(void);
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ ******************************************************************************
+ * @file    report.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   benchmark results output
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef REPORT_H
+#define REPORT_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bench.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+// text lines with the hex dump of the output data instead of the binary
+// records, much slower on the UART
+//#define REPORT_TEXT
+
+/*
+ * Binary frames, all fields little-endian:
+ *   0xA5, type (1 byte), payload length (1 byte), payload, CRC32 of the payload
+ * REPORT_FRAME_NAME: id (2 bytes), name (not terminated, at most 31 bytes), sent once per name
+ * REPORT_FRAME_RESULT: id (2 bytes), result (1 byte), outliers (2 bytes),
+ *     key size in bits (2 bytes), length, min, median, p99, stddev, t_cpu, idle, CRC32 of the output
+ *     followed by the tag (4 bytes each), t_cpu and idle being 0 for the
+ *     blocking functions, the CRC being 0 without output
+ * REPORT_FRAME_FIT: id (2 bytes), key size in bits (2 bytes), slope in thousandths of cycle/byte (4 bytes),
+ *     intercept in cycles (4 bytes, signed)
+ * REPORT_FRAME_COUNTER: id (2 bytes), key size in bits (2 bytes), count (4 bytes)
+ * REPORT_FRAME_MEMORY: id (2 bytes), key size in bits (2 bytes), peak of the working buffer in bytes (4 bytes),
+ *     the id is the one of the result of the operation
+ * The CRC32 is the usual one (zlib, Ethernet).
+ */
+#define REPORT_FRAME_START 0xA5
+#define REPORT_FRAME_NAME 1
+#define REPORT_FRAME_RESULT 2
+#define REPORT_FRAME_FIT 3
+#define REPORT_FRAME_COUNTER 4
+#define REPORT_FRAME_MEMORY 5
+
+/* Exported functions --------------------------------------------------------*/
+
+void report_init(void);
+
+/**
+ * Set the key size sent with the next results, 128 bits after report_init()
+ * @param key_size the size of the key in byte
+ */
+void report_set_key_size(uint32_t key_size);
+
+/**
+ * Send the result of a measurement
+ * @param name the name of the algorithm
+ * @param length the length of the processed data in byte
+ * @param stats the timing statistics
+ * @param result true if the operation success
+ * @param data the output data (length bytes), can be NULL
+ * @param mic the tag (16 bytes), can be NULL
+ */
+void report_result(const char* name, uint32_t length, const bench_stats_t* stats, bool result, const uint8_t* data, const uint8_t* mic);
+
+/**
+ * Send the result of a measurement of a non-blocking function
+ * @param t_cpu the time the CPU is busy before it can do something else
+ * @param idle the loops the application can run while waiting the end
+ * @see report_result()
+ */
+void report_result_async(const char* name, uint32_t length, const bench_stats_t* stats, uint32_t t_cpu, uint32_t idle,
+        bool result, const uint8_t* data, const uint8_t* mic);
+
+/**
+ * Send the linear fit t = slope * length + intercept of an algorithm
+ * @param name the name of the algorithm
+ * @param slope_thousandths the slope in thousandths of cycle per byte
+ * @param intercept the fixed overhead in cycles
+ */
+void report_fit(const char* name, uint32_t slope_thousandths, int32_t intercept);
+
+/**
+ * Send the value of a counter, e.g. the number of times an engine was chosen
+ * @param name the name of the counter
+ * @param count the value
+ */
+void report_counter(const char* name, uint32_t count);
+
+/**
+ * Send the memory used by an operation, e.g. the peak of the working buffer
+ * of a public key algorithm
+ * @param name the name of the algorithm, as given to report_result()
+ * @param bytes the memory in byte
+ */
+void report_memory(const char* name, uint32_t bytes);
+
+/**
+ * Compute the CRC32 (zlib) with the CRC peripheral, its configuration is
+ * restored at the end as it is also used by CMOX
+ * @param data the data
+ * @param length the length of the data in byte
+ * @return the CRC32
+ */
+uint32_t report_crc32(const uint8_t* data, uint32_t length);
+
+#endif
@@ -0,0 +1,99 @@
+/**
+ ******************************************************************************
+ * @file    rng_pool.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   pool of random bytes for the nonces and the IVs
+ *
+ * The bytes come from the CTR-DRBG of CMOX (AES-256), seeded at startup by
+ * the RNG peripheral. The pool is refilled by blocks of RNG_POOL_BLOCK_SIZE
+ * bytes by rng_pool_process(), called when the application is idle, so a
+ * request is only a copy. Meanwhile the RNG interrupt collects the entropy of
+ * the next reseed, done by rng_pool_process() every RNG_POOL_RESEED_BLOCKS
+ * blocks. A request larger than the bytes ready is served by the DRBG
+ * directly. The served bytes are cleared from the pool.
+ * rng_pool_get() and rng_pool_process() must be called from the same context,
+ * not from an interrupt.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef RNG_POOL_H
+#define RNG_POOL_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+// a multiple of the block size
+#define RNG_POOL_SIZE 1024
+#define RNG_POOL_BLOCK_SIZE 256
+// 16 KB of output per seed
+#define RNG_POOL_RESEED_BLOCKS 64
+// the key of the DRBG, AES-256
+#define RNG_POOL_KEY_SIZE 32
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef struct {
+    uint32_t refills;   // blocks generated in the pool
+    uint32_t reseeds;
+    uint32_t fallbacks; // requests served by the DRBG directly
+    uint32_t errors;    // seed and clock errors of the RNG
+} rng_pool_stats_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * Start the RNG, seed the DRBG and fill the pool
+ * HAL_Init() must have been called.
+ * @return true if the RNG gave the seed and the DRBG accepted it
+ */
+bool rng_pool_init(void);
+
+/**
+ * Take random bytes from the pool, or from the DRBG if the pool is short
+ * @param output the random bytes
+ * @param length the number of bytes
+ * @return true if success
+ */
+bool rng_pool_get(uint8_t* output, uint32_t length);
+
+/**
+ * Generate random bytes with the DRBG, without the pool
+ * @see rng_pool_get()
+ */
+bool rng_pool_generate(uint8_t* output, uint32_t length);
+
+/**
+ * Do one step of the background work: reseed the DRBG if it is due and the
+ * entropy is collected, otherwise generate one block if the pool has room
+ * @return true if something was done, the pool is full when it returns false
+ */
+bool rng_pool_process(void);
+
+/**
+ * @return the number of bytes ready in the pool
+ */
+uint32_t rng_pool_available(void);
+
+/**
+ * @param stats the counters since the last rng_pool_reset_stats()
+ */
+void rng_pool_get_stats(rng_pool_stats_t* stats);
+
+void rng_pool_reset_stats(void);
+
+/**
+ * Collect the entropy, called from the RNG interrupt
+ */
+void rng_pool_irq_handler(void);
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ ******************************************************************************
+ * @file    storage_bench.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   benchmark of the storage encryption and the key provisioning
+ *
+ * AES-XTS over a stream of consecutive sectors of 256, 512 and 4096 bytes, as
+ * for an external SPI flash, the tweak of a sector being its number
+ * (IEEE 1619). A handle keyed once per stream is compared with the one-shot
+ * function, which expands the keys for every sector, and the number of sectors
+ * per second is reported as a counter of the same name. The Key Wrap of
+ * RFC 3394 wraps and unwraps a 256-bit key under a KEK of each size.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef STORAGE_BENCH_H
+#define STORAGE_BENCH_H
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * Measure and report every operation, the outputs are checked out of the
+ * measurements
+ * The cycle counter must be enabled (bench_init()), the report initialized
+ * (report_init()). The key size of the report is changed.
+ */
+void storage_bench_run(void);
+
+#endif
@@ -34,6 +34,8 @@ extern "C" {
 
 extern UART_HandleTypeDef hlpuart1;
 
+extern DMA_HandleTypeDef hdma_lpuart_tx;
+
 /* USER CODE BEGIN Private defines */
 
 /* USER CODE END Private defines */
@@ -26,47 +26,245 @@
 
 #define AES_SIZE 16 // 128 bits
 #define AUTH_HEADER_SIZE 16
+#define GCM_IV_SIZE 12 // 96 bits
+#define GCM_TAG_SIZE 16
+#define CCM_MIN_NONCE_SIZE 7
+#define CCM_MAX_NONCE_SIZE 13
+#define CCM_MAX_AAD_SIZE 0xFEFF // the 2 bytes length encoding only
+#define CMAC_RB 0x87 // constant of the subkey generation for 128 bits blocks
+#define HAL_MAX_SIZE 0xFFF0 // uint16_t sizes of the HAL, rounded down to a block
+#define ASYNC_QUEUE_SIZE 8 // per priority
+#define SUSPEND_SIZE 32 // SUSP0R..SUSP7R
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef enum {
+    ASYNC_CTR_ENCRYPT,
+    ASYNC_GCM_ENCRYPT,
+    ASYNC_GCM_DECRYPT,
+} async_type_t;
+
+typedef struct {
+    async_type_t type;
+    const uint8_t* key;
+    uint32_t key_size; // CRYP_KEYSIZE_xxx when the job was queued
+    const uint8_t* init_vector;
+    const uint8_t* input;
+    uint32_t length;
+    uint8_t* output;
+    uint8_t* mic;
+    aes_hw_callback_t callback;
+    void* context;
+    aes_hw_priority_t priority;
+} async_job_t;
+
+typedef struct {
+    async_job_t jobs[ASYNC_QUEUE_SIZE];
+    volatile uint32_t head; // the running or suspended job is not popped
+    volatile uint32_t tail;
+} async_queue_t;
+
+// registers and position of a suspended job, the key is the one of the job
+typedef struct {
+    uint32_t control; // CR without EN and the interrupts
+    uint8_t init_vector[AES_SIZE];
+    uint8_t suspend[SUSPEND_SIZE]; // GCM only
+    uint32_t phase;
+    bool phase_done; // the job continues with the phase after this one
+    uint32_t offset; // bytes of the payload already processed
+} async_context_t;
 
 /* Private variables ---------------------------------------------------------*/
 
-static CRYP_HandleTypeDef hcryp;
+CRYP_HandleTypeDef hcryp;
+DMA_HandleTypeDef hdma_aes_in;
+DMA_HandleTypeDef hdma_aes_out;
+
 static const char auth_header[] = "0123456789ABCDEF";
 
+// CRYP_KEYSIZE_xxx of the functions without session
+static uint32_t key_size = CRYP_KEYSIZE_128B;
+
+// decryption key of the last ECB/CBC decryption, derived when the key changes
+static aes_hw_session_t decryption_cache;
+static bool decryption_cache_valid;
+
+// the session whose key (or decryption key) is in the key registers, cleared
+// by every other key write
+static const aes_hw_session_t* loaded_session;
+static bool loaded_decryption_key;
+
+// state of the on-going DMA operation, updated from the DMA/AES interrupts
+static volatile bool dma_busy;
+static volatile bool dma_result;
+static uint8_t* dma_mic;
+static uint32_t dma_length;
+// chunks still to process, started from the interrupt of the previous one
+static const uint8_t* dma_input;
+static uint8_t* dma_output;
+static uint32_t dma_remaining;
+// messages of the batch still to process, started from the interrupt of the
+// previous one
+static const aead_message_t* dma_batch;
+static uint32_t dma_batch_remaining;
+
+// queues of the asynchronous jobs by priority, pushed from the caller and
+// popped from the AES interrupt
+static async_queue_t async_queues[AES_HW_PRIORITY_URGENT + 1];
+static aes_hw_priority_t priority = AES_HW_PRIORITY_BULK;
+static const async_job_t* volatile async_job; // the job in the peripheral
+static volatile bool async_running; // a job is running or suspended
+static volatile bool async_preempting; // the bulk job is being suspended
+static uint32_t async_chunk_end; // end of the CTR chunk given to the HAL
+static bool async_suspended; // the head bulk job is saved in async_context
+static async_context_t async_context;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static bool peripheral_free(void);
+static bool buffers_valid(const uint8_t* input, uint32_t length, const uint8_t* output);
+static uint32_t chunk_size(uint32_t length);
+static bool process_chunks(const uint8_t* input, uint32_t length, uint8_t* output);
+static bool dma_next_chunk(void);
+static bool ctr_payload(const uint8_t* input, uint32_t length, uint8_t* output);
+static bool stream_piece(void* context, const uint8_t* input, uint32_t length, uint8_t* output);
+static bool block_decrypt(uint32_t chaining_mode, const uint8_t* key, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data);
+static bool gcm_aad(uint32_t operating_mode, const uint8_t* key, const uint8_t* init_vector, const uint8_t* aad, uint32_t aad_length,
+        const uint8_t* input, uint32_t length, uint8_t* output, uint8_t* tag);
+static bool gcm_aad_init(uint32_t operating_mode, const uint8_t* key, const uint8_t* init_vector, bool key_loaded);
+static bool gcm_aad_header(const uint8_t* aad, uint32_t aad_length);
+static bool gcm_aad_payload(const uint8_t* input, uint32_t length, uint8_t* output);
+static bool gcm_aad_final(uint32_t aad_length, uint32_t length, uint8_t* tag);
+static bool dma_batch_next(const uint8_t* key, bool key_loaded);
+static bool ccm_check(uint32_t nonce_length, uint32_t aad_length, uint32_t length, uint32_t tag_length);
+static void ccm_block(uint8_t* block, uint8_t flags, const uint8_t* nonce, uint32_t nonce_length, uint32_t value);
+static bool ccm_mac(const uint8_t* key, const uint8_t* nonce, uint32_t nonce_length, const uint8_t* aad, uint32_t aad_length,
+        const uint8_t* data, uint32_t length, uint32_t tag_length, uint8_t* tag);
+static bool ccm_header(const uint8_t* header, uint32_t length);
+static bool ccm_ctr(const uint8_t* key, const uint8_t* nonce, uint32_t nonce_length, const uint8_t* input, uint32_t length, uint8_t* output);
+static bool cmac(const uint8_t* key, const uint8_t* data, uint32_t length, uint8_t* tag);
+static void cmac_double(uint8_t* block);
+static bool tag_equal(const uint8_t* tag1, const uint8_t* tag2, uint32_t length);
+static bool gcm_start_dma(uint32_t operating_mode, const uint8_t* key, const uint8_t* init_vector, const uint8_t* input, uint32_t length, uint8_t* output, uint8_t* mic);
+static bool async_push(const async_job_t* job);
+static bool async_start(const async_job_t* job);
+static bool async_next_phase(const async_job_t* job);
+static void async_complete(bool result);
+static void async_run_next(void);
+static void async_preempt(void);
+static bool async_ctr_chunk(const async_job_t* job, uint32_t offset);
+static void async_suspend(bool phase_done);
+static bool async_resume(const async_job_t* job);
+static void set_key(const uint8_t* key);
+static bool session_load(aes_hw_session_t* session, bool decryption_key);
+static bool session_setup(aes_hw_session_t* session, uint32_t operating_mode, uint32_t chaining_mode, const uint8_t* init_vector);
+static bool session_gcm(aes_hw_session_t* session, uint32_t operating_mode, const uint8_t* init_vector, const uint8_t* input, uint32_t length, uint8_t* output, uint8_t* mic);
+
 /* Public functions ----------------------------------------------------------*/
 
 void aes_hw_init(void)
 {
+    key_size = CRYP_KEYSIZE_128B;
+    priority = AES_HW_PRIORITY_BULK;
+    decryption_cache_valid = false;
+    loaded_session = NULL;
+
     __HAL_RCC_AES_CLK_ENABLE();
     __HAL_RCC_AES_FORCE_RESET();
     __HAL_RCC_AES_RELEASE_RESET();
 
     hcryp.Instance = AES;
+    hcryp.Init.pKey = NULL; // no key loaded after the reset
     if (HAL_CRYP_DeInit(&hcryp) != HAL_OK) {
         assert(false);
     }
 }
 
-bool aes_hw_ctr_encrypt(uint8_t* key, uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data)
+bool aes_hw_set_key_size(uint32_t size)
+{
+    if (size != 16 && size != 32) {
+        // no 192 bits keys on this peripheral
+        return false;
+    }
+    key_size = size == 32 ? CRYP_KEYSIZE_256B : CRYP_KEYSIZE_128B;
+    return true;
+}
+
+bool aes_hw_ctr_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data)
+{
+    if (!peripheral_free() || !buffers_valid(plain_data, length, cipher_data)) {
+        return false;
+    }
+
+    hcryp.Init.DataType      = CRYP_DATATYPE_8B;
+    hcryp.Init.KeySize       = key_size;
+    set_key(key);
+    hcryp.Init.OperatingMode = CRYP_ALGOMODE_ENCRYPT;
+    hcryp.Init.ChainingMode  = CRYP_CHAINMODE_AES_CTR;
+    hcryp.Init.KeyWriteFlag  = CRYP_KEY_WRITE_ENABLE;
+    hcryp.Init.pInitVect     = (uint8_t*)init_vector;
+
+    // the HAL writes whole blocks, the last partial one goes through a copy
+    return length != 0 && HAL_CRYP_Init(&hcryp) == HAL_OK
+            && ctr_payload(plain_data, length, cipher_data);
+}
+
+bool aes_hw_ecb_encrypt(const uint8_t* key, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data)
 {
+    if (!peripheral_free() || length == 0 || length % AES_SIZE != 0 || !buffers_valid(plain_data, length, cipher_data)) {
+        return false;
+    }
+
     hcryp.Init.DataType = CRYP_DATATYPE_8B;
-    hcryp.Init.KeySize  = CRYP_KEYSIZE_128B;
-    hcryp.Init.pKey = key;
-    hcryp.Init.pInitVect = init_vector;
+    hcryp.Init.KeySize  = key_size;
+    set_key(key);
 
-    return HAL_CRYP_AESCTR_Encrypt(&hcryp, plain_data, length, cipher_data, HAL_MAX_DELAY) == HAL_OK;
+    uint32_t first = chunk_size(length);
+    return HAL_CRYP_AESECB_Encrypt(&hcryp, (uint8_t*)plain_data, first, cipher_data, HAL_MAX_DELAY) == HAL_OK
+            && process_chunks(plain_data + first, length - first, cipher_data + first);
 }
 
-bool aes_hw_gcm_encrypt(uint8_t* key, uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic)
+bool aes_hw_ecb_decrypt(const uint8_t* key, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data)
 {
+    return peripheral_free() && block_decrypt(CRYP_CHAINMODE_AES_ECB, key, NULL, cipher_data, length, plain_data);
+}
+
+bool aes_hw_cbc_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data)
+{
+    if (!peripheral_free() || length == 0 || length % AES_SIZE != 0 || !buffers_valid(plain_data, length, cipher_data)) {
+        return false;
+    }
+
+    hcryp.Init.DataType  = CRYP_DATATYPE_8B;
+    hcryp.Init.KeySize   = key_size;
+    set_key(key);
+    hcryp.Init.pInitVect = (uint8_t*)init_vector;
+
+    uint32_t first = chunk_size(length);
+    return HAL_CRYP_AESCBC_Encrypt(&hcryp, (uint8_t*)plain_data, first, cipher_data, HAL_MAX_DELAY) == HAL_OK
+            && process_chunks(plain_data + first, length - first, cipher_data + first);
+}
+
+bool aes_hw_cbc_decrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data)
+{
+    return peripheral_free() && block_decrypt(CRYP_CHAINMODE_AES_CBC, key, init_vector, cipher_data, length, plain_data);
+}
+
+bool aes_hw_gcm_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic)
+{
+    if (!peripheral_free() || !buffers_valid(plain_data, length, cipher_data)) {
+        return false;
+    }
+
     hcryp.Init.DataType      = CRYP_DATATYPE_8B;
-    hcryp.Init.KeySize       = CRYP_KEYSIZE_128B;
-    hcryp.Init.pKey          = key;
+    hcryp.Init.KeySize       = key_size;
+    set_key(key);
     hcryp.Init.OperatingMode = CRYP_ALGOMODE_ENCRYPT;
     hcryp.Init.ChainingMode  = CRYP_CHAINMODE_AES_GCM_GMAC;
     hcryp.Init.GCMCMACPhase  = CRYP_GCM_INIT_PHASE;
-    hcryp.Init.KeyWriteFlag  = CRYP_KEY_WRITE_DISABLE;
-    hcryp.Init.pInitVect     = init_vector;
-    hcryp.Init.Header        = auth_header;
+    hcryp.Init.KeyWriteFlag  = CRYP_KEY_WRITE_ENABLE;
+    hcryp.Init.pInitVect     = (uint8_t*)init_vector;
+    hcryp.Init.Header        = (uint8_t*)auth_header;
     hcryp.Init.HeaderSize    = AUTH_HEADER_SIZE;
 
     if (HAL_CRYP_Init(&hcryp) != HAL_OK) {
@@ -84,7 +282,7 @@ bool aes_hw_gcm_encrypt(uint8_t* key, uint8_t* init_vector, const uint8_t* plain
     }
 
     hcryp.Init.GCMCMACPhase  = CRYP_GCM_PAYLOAD_PHASE;
-    if (HAL_CRYPEx_AES_Auth(&hcryp, plain_data, length, cipher_data, HAL_MAX_DELAY) != HAL_OK) {
+    if (HAL_CRYPEx_AES_Auth(&hcryp, (uint8_t*)plain_data, length, cipher_data, HAL_MAX_DELAY) != HAL_OK) {
         return false;
     }
 
@@ -96,17 +294,21 @@ bool aes_hw_gcm_encrypt(uint8_t* key, uint8_t* init_vector, const uint8_t* plain
     return true;
 }
 
-bool aes_hw_gcm_decrypt(uint8_t* key, uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, uint8_t* mic)
+bool aes_hw_gcm_decrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, uint8_t* mic)
 {
+    if (!peripheral_free() || !buffers_valid(cipher_data, length, plain_data)) {
+        return false;
+    }
+
     hcryp.Init.DataType      = CRYP_DATATYPE_8B;
-    hcryp.Init.KeySize       = CRYP_KEYSIZE_128B;
-    hcryp.Init.pKey          = key;
+    hcryp.Init.KeySize       = key_size;
+    set_key(key);
     hcryp.Init.OperatingMode = CRYP_ALGOMODE_DECRYPT;
     hcryp.Init.ChainingMode  = CRYP_CHAINMODE_AES_GCM_GMAC;
     hcryp.Init.GCMCMACPhase  = CRYP_GCM_INIT_PHASE;
-    hcryp.Init.KeyWriteFlag  = CRYP_KEY_WRITE_DISABLE;
-    hcryp.Init.pInitVect     = init_vector;
-    hcryp.Init.Header        = auth_header;
+    hcryp.Init.KeyWriteFlag  = CRYP_KEY_WRITE_ENABLE;
+    hcryp.Init.pInitVect     = (uint8_t*)init_vector;
+    hcryp.Init.Header        = (uint8_t*)auth_header;
     hcryp.Init.HeaderSize    = AUTH_HEADER_SIZE;
 
     if (HAL_CRYP_Init(&hcryp) != HAL_OK) {
@@ -124,7 +326,7 @@ bool aes_hw_gcm_decrypt(uint8_t* key, uint8_t* init_vector, const uint8_t* ciphe
     }
 
     hcryp.Init.GCMCMACPhase  = CRYP_GCM_PAYLOAD_PHASE;
-    if (HAL_CRYPEx_AES_Auth(&hcryp, cipher_data, length, plain_data, HAL_MAX_DELAY) != HAL_OK) {
+    if (HAL_CRYPEx_AES_Auth(&hcryp, (uint8_t*)cipher_data, length, plain_data, HAL_MAX_DELAY) != HAL_OK) {
         return false;
     }
 
@@ -134,3 +336,1297 @@ bool aes_hw_gcm_decrypt(uint8_t* key, uint8_t* init_vector, const uint8_t* ciphe
     }
     return true;
 }
+
+bool aes_hw_gcm_aad_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* aad, uint32_t aad_length,
+        const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* tag)
+{
+    return peripheral_free() && gcm_aad(CRYP_ALGOMODE_ENCRYPT, key, init_vector, aad, aad_length, plain_data, length, cipher_data, tag);
+}
+
+bool aes_hw_gcm_aad_decrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* aad, uint32_t aad_length,
+        const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, const uint8_t* tag)
+{
+    uint8_t computed_tag[GCM_TAG_SIZE] __ALIGNED(4);
+
+    if (!peripheral_free()) {
+        return false;
+    }
+    if (!gcm_aad(CRYP_ALGOMODE_DECRYPT, key, init_vector, aad, aad_length, cipher_data, length, plain_data, computed_tag)
+            || !tag_equal(computed_tag, tag, GCM_TAG_SIZE)) {
+        memset(plain_data, 0, length);
+        return false;
+    }
+    return true;
+}
+
+bool aes_hw_gcm_encrypt_batch(const uint8_t* key, const aead_message_t* messages, uint32_t number)
+{
+    if (!peripheral_free()) {
+        return false;
+    }
+    for (uint32_t i = 0; i < number; i++) {
+        const aead_message_t* message = &messages[i];
+        // the key is written by the first message only
+        if (!buffers_valid(message->input, message->length, message->output)
+                || !gcm_aad_init(CRYP_ALGOMODE_ENCRYPT, key, message->nonce, i != 0)
+                || !gcm_aad_header(message->aad, message->aad_length)
+                || !gcm_aad_payload(message->input, message->length, message->output)
+                || !gcm_aad_final(message->aad_length, message->length, message->tag)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool aes_hw_gcm_encrypt_batch_dma(const uint8_t* key, const aead_message_t* messages, uint32_t number)
+{
+    if (!peripheral_free() || number == 0) {
+        return false;
+    }
+    for (uint32_t i = 0; i < number; i++) {
+        if (messages[i].length == 0 || messages[i].length % AES_SIZE != 0
+                || !buffers_valid(messages[i].input, messages[i].length, messages[i].output)) {
+            return false;
+        }
+    }
+
+    dma_batch = messages;
+    dma_batch_remaining = number;
+    dma_result = false;
+    dma_busy = true;
+
+    if (!dma_batch_next(key, false)) {
+        dma_batch_remaining = 0;
+        dma_busy = false;
+        return false;
+    }
+    return true;
+}
+
+bool aes_hw_stream_ctr_begin(aes_hw_stream_t* stream, const uint8_t* key, const uint8_t* init_vector)
+{
+    if (!peripheral_free()) {
+        return false;
+    }
+
+    stream->gcm = false;
+    stream->aad_length = 0;
+    stream->length = 0;
+    stream->partial = false;
+
+    hcryp.Init.DataType      = CRYP_DATATYPE_8B;
+    hcryp.Init.KeySize       = key_size;
+    set_key(key);
+    hcryp.Init.OperatingMode = CRYP_ALGOMODE_ENCRYPT;
+    hcryp.Init.ChainingMode  = CRYP_CHAINMODE_AES_CTR;
+    hcryp.Init.KeyWriteFlag  = CRYP_KEY_WRITE_ENABLE;
+    hcryp.Init.pInitVect     = (uint8_t*)init_vector;
+
+    // the key and the counter are written by the first update
+    return HAL_CRYP_Init(&hcryp) == HAL_OK;
+}
+
+bool aes_hw_stream_gcm_begin(aes_hw_stream_t* stream, bool decrypt, const uint8_t* key, const uint8_t* init_vector,
+        const uint8_t* aad, uint32_t aad_length)
+{
+    if (!peripheral_free()) {
+        return false;
+    }
+
+    stream->gcm = true;
+    stream->aad_length = aad_length;
+    stream->length = 0;
+    stream->partial = false;
+
+    return gcm_aad_init(decrypt ? CRYP_ALGOMODE_DECRYPT : CRYP_ALGOMODE_ENCRYPT, key, init_vector, false)
+            && gcm_aad_header(aad, aad_length);
+}
+
+bool aes_hw_stream_update(aes_hw_stream_t* stream, const uint8_t* input, uint32_t length, uint8_t* output)
+{
+    // the counter does not go on after a partial block
+    if (stream->partial || !buffers_valid(input, length, output)) {
+        return false;
+    }
+
+    stream->length += length;
+    stream->partial = length % AES_SIZE != 0;
+    if (stream->gcm) {
+        return gcm_aad_payload(input, length, output);
+    }
+    return ctr_payload(input, length, output);
+}
+
+bool aes_hw_stream_update_fragments(aes_hw_stream_t* stream, const fragment_t* fragments, uint32_t number)
+{
+    return fragment_process(fragments, number, stream_piece, stream);
+}
+
+bool aes_hw_stream_end(aes_hw_stream_t* stream, uint8_t* tag)
+{
+    if (!stream->gcm) {
+        return true;
+    }
+
+    hcryp.Init.HeaderSize    = stream->aad_length;
+    hcryp.Init.GCMCMACPhase  = CRYP_GCMCMAC_FINAL_PHASE;
+    return HAL_CRYPEx_AES_Auth(&hcryp, NULL, stream->length, tag, HAL_MAX_DELAY) == HAL_OK;
+}
+
+bool aes_hw_ccm_encrypt(const uint8_t* key, const uint8_t* nonce, uint32_t nonce_length, const uint8_t* aad, uint32_t aad_length,
+        const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* tag, uint32_t tag_length)
+{
+    uint8_t computed_tag[AES_SIZE] __ALIGNED(4);
+
+    if (!peripheral_free() || !ccm_check(nonce_length, aad_length, length, tag_length) || !buffers_valid(plain_data, length, cipher_data)
+            || !ccm_mac(key, nonce, nonce_length, aad, aad_length, plain_data, length, tag_length, computed_tag)
+            || !ccm_ctr(key, nonce, nonce_length, plain_data, length, cipher_data)) {
+        return false;
+    }
+    memcpy(tag, computed_tag, tag_length);
+    return true;
+}
+
+bool aes_hw_ccm_decrypt(const uint8_t* key, const uint8_t* nonce, uint32_t nonce_length, const uint8_t* aad, uint32_t aad_length,
+        const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, const uint8_t* tag, uint32_t tag_length)
+{
+    uint8_t computed_tag[AES_SIZE] __ALIGNED(4);
+
+    if (!peripheral_free() || !ccm_check(nonce_length, aad_length, length, tag_length) || !buffers_valid(cipher_data, length, plain_data)) {
+        return false;
+    }
+    // the MAC is computed on the plain data
+    if (!ccm_ctr(key, nonce, nonce_length, cipher_data, length, plain_data)
+            || !ccm_mac(key, nonce, nonce_length, aad, aad_length, plain_data, length, tag_length, computed_tag)
+            || !tag_equal(computed_tag, tag, tag_length)) {
+        memset(plain_data, 0, length);
+        return false;
+    }
+    return true;
+}
+
+bool aes_hw_cmac_generate(const uint8_t* key, const uint8_t* data, uint32_t length, uint8_t* tag)
+{
+    return peripheral_free() && cmac(key, data, length, tag);
+}
+
+bool aes_hw_cmac_verify(const uint8_t* key, const uint8_t* data, uint32_t length, const uint8_t* tag)
+{
+    uint8_t computed_tag[AES_SIZE] __ALIGNED(4);
+
+    return peripheral_free() && cmac(key, data, length, computed_tag) && tag_equal(computed_tag, tag, AES_SIZE);
+}
+
+bool aes_hw_ctr_encrypt_dma(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data)
+{
+    if (!peripheral_free() || !buffers_valid(plain_data, length, cipher_data)) {
+        return false;
+    }
+
+    hcryp.Init.DataType = CRYP_DATATYPE_8B;
+    hcryp.Init.KeySize  = key_size;
+    set_key(key);
+    hcryp.Init.pInitVect = (uint8_t*)init_vector;
+
+    uint32_t first = chunk_size(length);
+    dma_mic = NULL;
+    dma_input = plain_data + first;
+    dma_output = cipher_data + first;
+    dma_remaining = length - first;
+    dma_result = false;
+    dma_busy = true;
+
+    if (HAL_CRYP_AESCTR_Encrypt_DMA(&hcryp, (uint8_t*)plain_data, first, cipher_data) != HAL_OK) {
+        dma_busy = false;
+        return false;
+    }
+    return true;
+}
+
+bool aes_hw_gcm_encrypt_dma(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic)
+{
+    return gcm_start_dma(CRYP_ALGOMODE_ENCRYPT, key, init_vector, plain_data, length, cipher_data, mic);
+}
+
+bool aes_hw_gcm_decrypt_dma(const uint8_t* key, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, uint8_t* mic)
+{
+    return gcm_start_dma(CRYP_ALGOMODE_DECRYPT, key, init_vector, cipher_data, length, plain_data, mic);
+}
+
+bool aes_hw_busy(void)
+{
+    return dma_busy;
+}
+
+bool aes_hw_wait(void)
+{
+    while (dma_busy) {
+    }
+    return dma_result;
+}
+
+bool aes_hw_session_init(aes_hw_session_t* session, const uint8_t* key)
+{
+    if (!peripheral_free()) {
+        return false;
+    }
+
+    session->key_size = key_size;
+    memcpy(session->key, key, key_size == CRYP_KEYSIZE_256B ? 32 : 16);
+
+    hcryp.Init.DataType      = CRYP_DATATYPE_8B;
+    hcryp.Init.KeySize       = session->key_size;
+    hcryp.Init.pKey          = session->key;
+    hcryp.Init.OperatingMode = CRYP_ALGOMODE_KEYDERIVATION;
+    hcryp.Init.ChainingMode  = CRYP_CHAINMODE_AES_ECB;
+    hcryp.Init.KeyWriteFlag  = CRYP_KEY_WRITE_ENABLE;
+    loaded_session = NULL;
+
+    if (HAL_CRYP_Init(&hcryp) != HAL_OK
+            || HAL_CRYPEx_AES(&hcryp, NULL, 0, session->decryption_key, HAL_MAX_DELAY) != HAL_OK) {
+        return false;
+    }
+
+    // the key registers now contain the decryption key
+    hcryp.Init.pKey = session->decryption_key;
+    loaded_session = session;
+    loaded_decryption_key = true;
+    return true;
+}
+
+bool aes_hw_session_ctr_encrypt(aes_hw_session_t* session, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data)
+{
+    if (!peripheral_free() || !buffers_valid(plain_data, length, cipher_data)
+            || !session_setup(session, CRYP_ALGOMODE_ENCRYPT, CRYP_CHAINMODE_AES_CTR, init_vector)) {
+        return false;
+    }
+    return ctr_payload(plain_data, length, cipher_data);
+}
+
+bool aes_hw_session_gcm_encrypt(aes_hw_session_t* session, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic)
+{
+    return peripheral_free() && session_gcm(session, CRYP_ALGOMODE_ENCRYPT, init_vector, plain_data, length, cipher_data, mic);
+}
+
+bool aes_hw_session_gcm_decrypt(aes_hw_session_t* session, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, uint8_t* mic)
+{
+    return peripheral_free() && session_gcm(session, CRYP_ALGOMODE_DECRYPT, init_vector, cipher_data, length, plain_data, mic);
+}
+
+bool aes_hw_ctr_encrypt_async(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data,
+        aes_hw_callback_t callback, void* context)
+{
+    async_job_t job = {
+        .type = ASYNC_CTR_ENCRYPT,
+        .key = key,
+        .key_size = key_size,
+        .init_vector = init_vector,
+        .input = plain_data,
+        .length = length,
+        .output = cipher_data,
+        .mic = NULL,
+        .callback = callback,
+        .context = context,
+        .priority = priority,
+    };
+    return async_push(&job);
+}
+
+bool aes_hw_gcm_encrypt_async(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic,
+        aes_hw_callback_t callback, void* context)
+{
+    async_job_t job = {
+        .type = ASYNC_GCM_ENCRYPT,
+        .key = key,
+        .key_size = key_size,
+        .init_vector = init_vector,
+        .input = plain_data,
+        .length = length,
+        .output = cipher_data,
+        .mic = mic,
+        .callback = callback,
+        .context = context,
+        .priority = priority,
+    };
+    return async_push(&job);
+}
+
+bool aes_hw_gcm_decrypt_async(const uint8_t* key, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, uint8_t* mic,
+        aes_hw_callback_t callback, void* context)
+{
+    async_job_t job = {
+        .type = ASYNC_GCM_DECRYPT,
+        .key = key,
+        .key_size = key_size,
+        .init_vector = init_vector,
+        .input = cipher_data,
+        .length = length,
+        .output = plain_data,
+        .mic = mic,
+        .callback = callback,
+        .context = context,
+        .priority = priority,
+    };
+    return async_push(&job);
+}
+
+void aes_hw_set_priority(aes_hw_priority_t new_priority)
+{
+    priority = new_priority;
+}
+
+uint32_t aes_hw_async_pending(void)
+{
+    uint32_t pending = 0;
+
+    for (uint32_t i = 0; i <= AES_HW_PRIORITY_URGENT; i++) {
+        pending += async_queues[i].tail - async_queues[i].head;
+    }
+    return pending;
+}
+
+void aes_hw_irq_handler(void)
+{
+    // the HAL stopped the payload at a block boundary without callback
+    if (async_preempting && hcryp.State == HAL_CRYP_STATE_SUSPENDED) {
+        async_suspend(false);
+    }
+}
+
+/* Callback functions --------------------------------------------------------*/
+
+void HAL_CRYP_OutCpltCallback(CRYP_HandleTypeDef *hcryp)
+{
+    bool result = true;
+
+    if (dma_remaining != 0) {
+        // the next chunk follows without waiting for the caller
+        if (!dma_next_chunk()) {
+            dma_batch_remaining = 0;
+            dma_result = false;
+            dma_busy = false;
+        }
+        return;
+    }
+
+    if (hcryp->Init.ChainingMode == CRYP_CHAINMODE_AES_GCM_GMAC) {
+        // the tag is a single block, read it in polling from the interrupt
+        hcryp->Init.GCMCMACPhase = CRYP_GCMCMAC_FINAL_PHASE;
+        result = HAL_CRYPEx_AES_Auth(hcryp, NULL, dma_length, dma_mic, HAL_MAX_DELAY) == HAL_OK;
+    }
+
+    if (result && dma_batch_remaining != 0) {
+        // the next message follows without waiting for the caller, the key
+        // stays in the peripheral
+        if (dma_batch_next(hcryp->Init.pKey, true)) {
+            return;
+        }
+        result = false;
+    }
+
+    dma_batch_remaining = 0;
+    dma_result = result;
+    dma_busy = false;
+}
+
+void HAL_CRYPEx_ComputationCpltCallback(CRYP_HandleTypeDef *hcryp)
+{
+    if (!async_running) {
+        return;
+    }
+
+    // a suspension requested during the last block is not taken by the HAL
+    hcryp->SuspendRequest = HAL_CRYP_SUSPEND_NONE;
+
+    const async_job_t* job = async_job;
+    if (job->type == ASYNC_CTR_ENCRYPT && async_chunk_end != job->length) {
+        if (async_preempting) {
+            async_suspend(false);
+        } else if (!async_ctr_chunk(job, async_chunk_end)) {
+            async_complete(false);
+        }
+        return;
+    }
+    if (job->type != ASYNC_CTR_ENCRYPT && hcryp->Init.GCMCMACPhase != CRYP_GCMCMAC_FINAL_PHASE) {
+        if (async_preempting && hcryp->Init.GCMCMACPhase != CRYP_GCM_INIT_PHASE) {
+            // between two phases, the next one is started when resumed
+            async_suspend(true);
+            return;
+        }
+        // GCM, each phase ends with an interrupt, start the next one
+        if (!async_next_phase(job)) {
+            async_complete(false);
+        }
+        return;
+    }
+    async_complete(true);
+}
+
+void HAL_CRYP_ErrorCallback(CRYP_HandleTypeDef *hcryp)
+{
+    (void)hcryp;
+
+    if (async_running) {
+        async_complete(false);
+        return;
+    }
+
+    dma_batch_remaining = 0;
+    dma_result = false;
+    dma_busy = false;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @return true if the peripheral is used neither by the DMA nor by an
+ * asynchronous job
+ */
+static bool peripheral_free(void)
+{
+    return !dma_busy && !async_running;
+}
+
+/**
+ * @return true if the output is the input (in place) or does not overlap it
+ * The peripheral takes a block before giving its result, so a block can be
+ * written over itself, but an output shifted from the input would overwrite
+ * input blocks not read yet.
+ */
+static bool buffers_valid(const uint8_t* input, uint32_t length, const uint8_t* output)
+{
+    uintptr_t in = (uintptr_t)input;
+    uintptr_t out = (uintptr_t)output;
+
+    return in == out || out + length <= in || in + length <= out;
+}
+
+/**
+ * @return the size of the next chunk of a buffer, the HAL takes at most
+ * HAL_MAX_SIZE bytes per call
+ */
+static uint32_t chunk_size(uint32_t length)
+{
+    return length < HAL_MAX_SIZE ? length : HAL_MAX_SIZE;
+}
+
+/**
+ * Continue the ECB, CBC or CTR operation configured in the peripheral on a
+ * buffer of any length, the chaining value (IV or counter) stays in the
+ * peripheral between the chunks
+ */
+static bool process_chunks(const uint8_t* input, uint32_t length, uint8_t* output)
+{
+    while (length != 0) {
+        uint32_t size = chunk_size(length);
+        if (HAL_CRYPEx_AES(&hcryp, (uint8_t*)input, size, output, HAL_MAX_DELAY) != HAL_OK) {
+            return false;
+        }
+        input += size;
+        output += size;
+        length -= size;
+    }
+    return true;
+}
+
+/**
+ * CTR payload, the last partial block goes through a copy as for GCM
+ */
+static bool ctr_payload(const uint8_t* input, uint32_t length, uint8_t* output)
+{
+    uint32_t aligned_length = length - length % AES_SIZE;
+    uint8_t block[AES_SIZE] __ALIGNED(4) = {0};
+
+    if (!process_chunks(input, aligned_length, output)) {
+        return false;
+    }
+
+    if (aligned_length != length) {
+        memcpy(block, input + aligned_length, length - aligned_length);
+        if (!process_chunks(block, AES_SIZE, block)) {
+            return false;
+        }
+        memcpy(output + aligned_length, block, length - aligned_length);
+    }
+    return true;
+}
+
+static bool stream_piece(void* context, const uint8_t* input, uint32_t length, uint8_t* output)
+{
+    return aes_hw_stream_update(context, input, length, output);
+}
+
+/**
+ * Start the DMA transfers of the next chunk of the on-going CTR or GCM
+ * payload, the counter and the GCM hash stay in the peripheral
+ */
+static bool dma_next_chunk(void)
+{
+    uint32_t size = chunk_size(dma_remaining);
+    const uint8_t* input = dma_input;
+    uint8_t* output = dma_output;
+
+    dma_input += size;
+    dma_output += size;
+    dma_remaining -= size;
+    if (hcryp.Init.ChainingMode == CRYP_CHAINMODE_AES_GCM_GMAC) {
+        return HAL_CRYPEx_AES_Auth_DMA(&hcryp, (uint8_t*)input, size, output) == HAL_OK;
+    }
+    return HAL_CRYPEx_AES_DMA(&hcryp, (uint8_t*)input, size, output) == HAL_OK;
+}
+
+/**
+ * ECB or CBC decryption (mode 3) with the cached decryption key, the key
+ * derivation (mode 2) only runs for a new key, instead of each call as in
+ * HAL_CRYP_AESxxx_Decrypt() (mode 4). The key registers are not written if
+ * they still contain the decryption key.
+ */
+static bool block_decrypt(uint32_t chaining_mode, const uint8_t* key, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data)
+{
+    if (length == 0 || length % AES_SIZE != 0 || !buffers_valid(cipher_data, length, plain_data)) {
+        return false;
+    }
+
+    if (!decryption_cache_valid || decryption_cache.key_size != key_size
+            || memcmp(decryption_cache.key, key, key_size == CRYP_KEYSIZE_256B ? 32 : 16) != 0) {
+        // the key registers contain the decryption key after the derivation
+        decryption_cache_valid = aes_hw_session_init(&decryption_cache, key);
+        if (!decryption_cache_valid) {
+            return false;
+        }
+    }
+
+    hcryp.Init.DataType      = CRYP_DATATYPE_8B;
+    hcryp.Init.OperatingMode = CRYP_ALGOMODE_DECRYPT;
+    hcryp.Init.ChainingMode  = chaining_mode;
+    hcryp.Init.pInitVect     = (uint8_t*)init_vector;
+
+    return session_load(&decryption_cache, true)
+            && process_chunks(cipher_data, length, plain_data);
+}
+
+static bool gcm_aad(uint32_t operating_mode, const uint8_t* key, const uint8_t* init_vector, const uint8_t* aad, uint32_t aad_length,
+        const uint8_t* input, uint32_t length, uint8_t* output, uint8_t* tag)
+{
+    return buffers_valid(input, length, output)
+            && gcm_aad_init(operating_mode, key, init_vector, false) && gcm_aad_header(aad, aad_length)
+            && gcm_aad_payload(input, length, output) && gcm_aad_final(aad_length, length, tag);
+}
+
+/**
+ * Init phase of GCM with a 96 bits IV
+ * @param key_loaded true if the key registers already contain the key
+ */
+static bool gcm_aad_init(uint32_t operating_mode, const uint8_t* key, const uint8_t* init_vector, bool key_loaded)
+{
+    // IV || 2, the counter of the first payload block
+    uint8_t counter_block[AES_SIZE] __ALIGNED(4) = {0};
+    memcpy(counter_block, init_vector, GCM_IV_SIZE);
+    counter_block[AES_SIZE - 1] = 2;
+
+    hcryp.Init.DataType      = CRYP_DATATYPE_8B;
+    hcryp.Init.KeySize       = key_size;
+    set_key(key);
+    hcryp.Init.OperatingMode = operating_mode;
+    hcryp.Init.ChainingMode  = CRYP_CHAINMODE_AES_GCM_GMAC;
+    hcryp.Init.GCMCMACPhase  = CRYP_GCM_INIT_PHASE;
+    hcryp.Init.KeyWriteFlag  = key_loaded ? CRYP_KEY_WRITE_DISABLE : CRYP_KEY_WRITE_ENABLE;
+    hcryp.Init.pInitVect     = counter_block;
+    hcryp.Init.Header        = NULL;
+    hcryp.Init.HeaderSize    = 0;
+
+    bool initialized = HAL_CRYP_Init(&hcryp) == HAL_OK;
+    // the counter block is only read by HAL_CRYP_Init(), a later init without
+    // IV fails instead of reading this stack frame
+    hcryp.Init.pInitVect = NULL;
+    if (!initialized) {
+        return false;
+    }
+
+    /* GCM init phase */
+    return HAL_CRYPEx_AES_Auth(&hcryp, NULL, 0, NULL, HAL_MAX_DELAY) == HAL_OK;
+}
+
+/**
+ * Header phase, the full blocks are read from the buffer and the last partial
+ * block from a copy (the HAL pads it by reading whole words)
+ * The phase is run even without header, it selects the byte swapping.
+ */
+static bool gcm_aad_header(const uint8_t* aad, uint32_t aad_length)
+{
+    uint32_t aligned_length = aad_length - aad_length % AES_SIZE;
+    uint8_t block[AES_SIZE] __ALIGNED(4) = {0};
+
+    hcryp.Init.GCMCMACPhase = CRYP_GCMCMAC_HEADER_PHASE;
+
+    if (aligned_length != 0 || aad_length == 0) {
+        hcryp.Init.Header     = aad_length == 0 ? NULL : (uint8_t*)aad;
+        hcryp.Init.HeaderSize = aligned_length;
+        if (HAL_CRYPEx_AES_Auth(&hcryp, NULL, 0, NULL, HAL_MAX_DELAY) != HAL_OK) {
+            return false;
+        }
+    }
+
+    if (aligned_length != aad_length) {
+        memcpy(block, aad + aligned_length, aad_length - aligned_length);
+        hcryp.Init.Header     = block;
+        hcryp.Init.HeaderSize = aad_length - aligned_length;
+        if (HAL_CRYPEx_AES_Auth(&hcryp, NULL, 0, NULL, HAL_MAX_DELAY) != HAL_OK) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Payload phase, the last partial block goes through a copy as for the header
+ */
+static bool gcm_aad_payload(const uint8_t* input, uint32_t length, uint8_t* output)
+{
+    uint32_t aligned_length = length - length % AES_SIZE;
+    uint8_t block[AES_SIZE] __ALIGNED(4) = {0};
+
+    hcryp.Init.GCMCMACPhase = CRYP_GCM_PAYLOAD_PHASE;
+
+    if (aligned_length != 0
+            && HAL_CRYPEx_AES_Auth(&hcryp, (uint8_t*)input, aligned_length, output, HAL_MAX_DELAY) != HAL_OK) {
+        return false;
+    }
+
+    if (aligned_length != length) {
+        memcpy(block, input + aligned_length, length - aligned_length);
+        if (HAL_CRYPEx_AES_Auth(&hcryp, block, length - aligned_length, block, HAL_MAX_DELAY) != HAL_OK) {
+            return false;
+        }
+        memcpy(output + aligned_length, block, length - aligned_length);
+    }
+    return true;
+}
+
+/**
+ * Final phase, the lengths block is built from the total header size
+ */
+static bool gcm_aad_final(uint32_t aad_length, uint32_t length, uint8_t* tag)
+{
+    hcryp.Init.HeaderSize    = aad_length;
+    hcryp.Init.GCMCMACPhase  = CRYP_GCMCMAC_FINAL_PHASE;
+    return HAL_CRYPEx_AES_Auth(&hcryp, NULL, length, tag, HAL_MAX_DELAY) == HAL_OK;
+}
+
+/**
+ * Start the next message of the DMA batch: the init and header phases in
+ * polling, then the payload by DMA, its end is handled by
+ * HAL_CRYP_OutCpltCallback()
+ */
+static bool dma_batch_next(const uint8_t* key, bool key_loaded)
+{
+    const aead_message_t* message = dma_batch++;
+
+    dma_batch_remaining--;
+    if (!gcm_aad_init(CRYP_ALGOMODE_ENCRYPT, key, message->nonce, key_loaded)
+            || !gcm_aad_header(message->aad, message->aad_length)) {
+        return false;
+    }
+
+    // as in gcm_start_dma(), the header is done, its size is kept for the
+    // final phase
+    hcryp.Init.Header        = NULL;
+    hcryp.Init.HeaderSize    = message->aad_length;
+    hcryp.Init.GCMCMACPhase  = CRYP_GCM_PAYLOAD_PHASE;
+
+    dma_mic = message->tag;
+    dma_length = message->length;
+    dma_input = message->input;
+    dma_output = message->output;
+    dma_remaining = message->length;
+    return dma_next_chunk();
+}
+
+static bool ccm_check(uint32_t nonce_length, uint32_t aad_length, uint32_t length, uint32_t tag_length)
+{
+    uint32_t q = AES_SIZE - 1 - nonce_length; // size of the length field
+
+    if (nonce_length < CCM_MIN_NONCE_SIZE || nonce_length > CCM_MAX_NONCE_SIZE
+            || tag_length < 4 || tag_length > AES_SIZE || tag_length % 2 != 0
+            || aad_length > CCM_MAX_AAD_SIZE) {
+        return false;
+    }
+    return q >= 4 || (length >> (8 * q)) == 0;
+}
+
+/**
+ * Build a block flags || nonce || value, value on the remaining bytes (big
+ * endian), it is B0 with the payload length or a counter block
+ */
+static void ccm_block(uint8_t* block, uint8_t flags, const uint8_t* nonce, uint32_t nonce_length, uint32_t value)
+{
+    memset(block, 0, AES_SIZE);
+    block[0] = flags | (AES_SIZE - 2 - nonce_length); // q - 1
+    memcpy(&block[1], nonce, nonce_length);
+    for (uint32_t i = AES_SIZE - 1; value != 0; i--) {
+        block[i] = value;
+        value >>= 8;
+    }
+}
+
+/**
+ * CBC-MAC of B0, the formatted header and the payload padded with zeros,
+ * encrypted with the counter block 0 by the final phase
+ */
+static bool ccm_mac(const uint8_t* key, const uint8_t* nonce, uint32_t nonce_length, const uint8_t* aad, uint32_t aad_length,
+        const uint8_t* data, uint32_t length, uint32_t tag_length, uint8_t* tag)
+{
+    uint8_t first_block[AES_SIZE] __ALIGNED(4);
+    uint8_t block[AES_SIZE] __ALIGNED(4);
+    uint32_t aligned_length = length - length % AES_SIZE;
+
+    ccm_block(first_block, (aad_length != 0 ? 0x40 : 0) | (tag_length - 2) << 2, nonce, nonce_length, length);
+
+    hcryp.Init.DataType      = CRYP_DATATYPE_8B;
+    hcryp.Init.KeySize       = key_size;
+    set_key(key);
+    hcryp.Init.OperatingMode = CRYP_ALGOMODE_TAG_GENERATION;
+    hcryp.Init.ChainingMode  = CRYP_CHAINMODE_AES_CMAC;
+    hcryp.Init.GCMCMACPhase  = CRYP_GCMCMAC_HEADER_PHASE;
+    hcryp.Init.KeyWriteFlag  = CRYP_KEY_WRITE_ENABLE;
+    hcryp.Init.Header        = NULL;
+    hcryp.Init.HeaderSize    = 0;
+
+    if (HAL_CRYP_Init(&hcryp) != HAL_OK
+            || HAL_CRYPEx_AES_Auth(&hcryp, first_block, AES_SIZE, NULL, HAL_MAX_DELAY) != HAL_OK) {
+        return false;
+    }
+
+    // the header is prefixed by its length, so it is copied block by block
+    if (aad_length != 0) {
+        uint32_t used = 2;
+
+        memset(block, 0, AES_SIZE);
+        block[0] = aad_length >> 8;
+        block[1] = aad_length;
+        for (uint32_t i = 0; i < aad_length; i++) {
+            block[used++] = aad[i];
+            if (used == AES_SIZE || i == aad_length - 1) {
+                if (!ccm_header(block, AES_SIZE)) {
+                    return false;
+                }
+                memset(block, 0, AES_SIZE);
+                used = 0;
+            }
+        }
+    }
+
+    if (aligned_length != 0 && !ccm_header(data, aligned_length)) {
+        return false;
+    }
+    if (aligned_length != length) {
+        memset(block, 0, AES_SIZE);
+        memcpy(block, data + aligned_length, length - aligned_length);
+        if (!ccm_header(block, AES_SIZE)) {
+            return false;
+        }
+    }
+
+    ccm_block(first_block, 0, nonce, nonce_length, 0);
+    hcryp.Init.GCMCMACPhase = CRYP_GCMCMAC_FINAL_PHASE;
+    return HAL_CRYPEx_AES_Auth(&hcryp, first_block, AES_SIZE, tag, HAL_MAX_DELAY) == HAL_OK;
+}
+
+/**
+ * Header phase of the CMAC chaining mode on whole blocks
+ */
+static bool ccm_header(const uint8_t* header, uint32_t length)
+{
+    hcryp.Init.Header     = (uint8_t*)header;
+    hcryp.Init.HeaderSize = length;
+    return HAL_CRYPEx_AES_Auth(&hcryp, NULL, 0, NULL, HAL_MAX_DELAY) == HAL_OK;
+}
+
+/**
+ * CTR encryption from the counter block 1, the last partial block goes
+ * through a copy
+ */
+static bool ccm_ctr(const uint8_t* key, const uint8_t* nonce, uint32_t nonce_length, const uint8_t* input, uint32_t length, uint8_t* output)
+{
+    uint8_t counter_block[AES_SIZE] __ALIGNED(4);
+    uint8_t block[AES_SIZE] __ALIGNED(4) = {0};
+    uint32_t aligned_length = length - length % AES_SIZE;
+
+    if (length == 0) {
+        return true;
+    }
+
+    ccm_block(counter_block, 0, nonce, nonce_length, 1);
+
+    hcryp.Init.DataType      = CRYP_DATATYPE_8B;
+    hcryp.Init.KeySize       = key_size;
+    set_key(key);
+    hcryp.Init.OperatingMode = CRYP_ALGOMODE_ENCRYPT;
+    hcryp.Init.ChainingMode  = CRYP_CHAINMODE_AES_CTR;
+    hcryp.Init.KeyWriteFlag  = CRYP_KEY_WRITE_ENABLE;
+    hcryp.Init.pInitVect     = counter_block;
+
+    bool initialized = HAL_CRYP_Init(&hcryp) == HAL_OK;
+    // as in gcm_aad_init(), the counter block is on the stack
+    hcryp.Init.pInitVect = NULL;
+    if (!initialized) {
+        return false;
+    }
+
+    if (!process_chunks(input, aligned_length, output)) {
+        return false;
+    }
+    if (aligned_length != length) {
+        memcpy(block, input + aligned_length, length - aligned_length);
+        if (HAL_CRYPEx_AES(&hcryp, block, AES_SIZE, block, HAL_MAX_DELAY) != HAL_OK) {
+            return false;
+        }
+        memcpy(output + aligned_length, block, length - aligned_length);
+    }
+    return true;
+}
+
+/**
+ * The subkey is derived from L = AES(key, 0). The final phase of the CMAC
+ * chaining mode encrypts a zero block, so it outputs the CBC-MAC XOR L.
+ */
+static bool cmac(const uint8_t* key, const uint8_t* data, uint32_t length, uint8_t* tag)
+{
+    uint8_t zero[AES_SIZE] __ALIGNED(4) = {0};
+    uint8_t l[AES_SIZE] __ALIGNED(4);
+    uint8_t subkey[AES_SIZE] __ALIGNED(4);
+    uint8_t block[AES_SIZE] __ALIGNED(4) = {0};
+    // the last block, complete or padded, is processed with the subkey
+    uint32_t last_length = length == 0 ? 0 : (length - 1) % AES_SIZE + 1;
+    uint32_t first_length = length - last_length;
+
+    hcryp.Init.DataType = CRYP_DATATYPE_8B;
+    hcryp.Init.KeySize  = key_size;
+    set_key(key);
+    if (HAL_CRYP_AESECB_Encrypt(&hcryp, zero, AES_SIZE, l, HAL_MAX_DELAY) != HAL_OK) {
+        return false;
+    }
+
+    memcpy(subkey, l, AES_SIZE);
+    cmac_double(subkey); // K1
+    memcpy(block, data + first_length, last_length);
+    if (last_length != AES_SIZE) {
+        block[last_length] = 0x80;
+        cmac_double(subkey); // K2
+    }
+    for (uint32_t i = 0; i < AES_SIZE; i++) {
+        block[i] ^= subkey[i];
+    }
+
+    hcryp.Init.OperatingMode = CRYP_ALGOMODE_TAG_GENERATION;
+    hcryp.Init.ChainingMode  = CRYP_CHAINMODE_AES_CMAC;
+    hcryp.Init.GCMCMACPhase  = CRYP_GCMCMAC_HEADER_PHASE;
+    hcryp.Init.KeyWriteFlag  = CRYP_KEY_WRITE_DISABLE; // loaded by the ECB encryption
+
+    if (HAL_CRYP_Init(&hcryp) != HAL_OK
+            || (first_length != 0 && !ccm_header(data, first_length))
+            || !ccm_header(block, AES_SIZE)) {
+        return false;
+    }
+
+    hcryp.Init.GCMCMACPhase = CRYP_GCMCMAC_FINAL_PHASE;
+    if (HAL_CRYPEx_AES_Auth(&hcryp, zero, AES_SIZE, tag, HAL_MAX_DELAY) != HAL_OK) {
+        return false;
+    }
+    for (uint32_t i = 0; i < AES_SIZE; i++) {
+        tag[i] ^= l[i];
+    }
+    return true;
+}
+
+/**
+ * Multiply by x in GF(2^128), the subkey generation of the CMAC
+ */
+static void cmac_double(uint8_t* block)
+{
+    uint8_t carry = block[0] & 0x80;
+
+    for (uint32_t i = 0; i < AES_SIZE - 1; i++) {
+        block[i] = block[i] << 1 | block[i + 1] >> 7;
+    }
+    block[AES_SIZE - 1] = block[AES_SIZE - 1] << 1 ^ (carry ? CMAC_RB : 0);
+}
+
+/**
+ * Compare two tags in constant time, all the bytes are always compared
+ */
+static bool tag_equal(const uint8_t* tag1, const uint8_t* tag2, uint32_t length)
+{
+    uint8_t difference = 0;
+
+    for (uint32_t i = 0; i < length; i++) {
+        difference |= tag1[i] ^ tag2[i];
+    }
+    return difference == 0;
+}
+
+static bool gcm_start_dma(uint32_t operating_mode, const uint8_t* key, const uint8_t* init_vector, const uint8_t* input, uint32_t length, uint8_t* output, uint8_t* mic)
+{
+    if (!peripheral_free() || !buffers_valid(input, length, output)) {
+        return false;
+    }
+
+    hcryp.Init.DataType      = CRYP_DATATYPE_8B;
+    hcryp.Init.KeySize       = key_size;
+    set_key(key);
+    hcryp.Init.OperatingMode = operating_mode;
+    hcryp.Init.ChainingMode  = CRYP_CHAINMODE_AES_GCM_GMAC;
+    hcryp.Init.GCMCMACPhase  = CRYP_GCM_INIT_PHASE;
+    hcryp.Init.KeyWriteFlag  = CRYP_KEY_WRITE_ENABLE;
+    hcryp.Init.pInitVect     = (uint8_t*)init_vector;
+    hcryp.Init.Header        = (uint8_t*)auth_header;
+    hcryp.Init.HeaderSize    = AUTH_HEADER_SIZE;
+
+    if (HAL_CRYP_Init(&hcryp) != HAL_OK) {
+        return false;
+    }
+
+    /* GCM init phase */
+    if (HAL_CRYPEx_AES_Auth(&hcryp, NULL, 0, NULL, HAL_MAX_DELAY) != HAL_OK) {
+        return false;
+    }
+
+    /* the header is a single block, no gain to move it by DMA */
+    hcryp.Init.GCMCMACPhase  = CRYP_GCMCMAC_HEADER_PHASE;
+    if (HAL_CRYPEx_AES_Auth(&hcryp, NULL, 0, NULL, HAL_MAX_DELAY) != HAL_OK) {
+        return false;
+    }
+
+    // the header has already been processed and its CCF cleared, so the DMA
+    // payload phase must not wait for it again (header size is still used
+    // by the final phase)
+    hcryp.Init.Header = NULL;
+
+    dma_mic = mic;
+    dma_length = length;
+    dma_input = input;
+    dma_output = output;
+    dma_remaining = length;
+    dma_result = false;
+    dma_busy = true;
+
+    hcryp.Init.GCMCMACPhase  = CRYP_GCM_PAYLOAD_PHASE;
+    if (!dma_next_chunk()) {
+        dma_busy = false;
+        return false;
+    }
+    return true;
+}
+
+static bool async_push(const async_job_t* job)
+{
+    async_queue_t* queue = &async_queues[job->priority];
+    bool start = false;
+
+    if (!buffers_valid(job->input, job->length, job->output)) {
+        return false;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (queue->tail - queue->head >= ASYNC_QUEUE_SIZE || (dma_busy && !async_running)) {
+        __set_PRIMASK(primask);
+        return false;
+    }
+    queue->jobs[queue->tail % ASYNC_QUEUE_SIZE] = *job;
+    queue->tail++;
+    if (!async_running) {
+        // the peripheral is idle, else the job will be started from the interrupt
+        async_running = true;
+        start = true;
+    } else if (job->priority == AES_HW_PRIORITY_URGENT && async_job != NULL
+            && async_job->priority == AES_HW_PRIORITY_BULK && !async_preempting) {
+        async_preempt();
+    }
+    __set_PRIMASK(primask);
+
+    if (start) {
+        async_run_next();
+    }
+    return true;
+}
+
+static bool async_start(const async_job_t* job)
+{
+    hcryp.Init.DataType      = CRYP_DATATYPE_8B;
+    hcryp.Init.KeySize       = job->key_size;
+    set_key(job->key);
+    hcryp.Init.pInitVect     = (uint8_t*)job->init_vector;
+
+    if (job->type == ASYNC_CTR_ENCRYPT) {
+        async_chunk_end = chunk_size(job->length);
+        return HAL_CRYP_AESCTR_Encrypt_IT(&hcryp, (uint8_t*)job->input, async_chunk_end, job->output) == HAL_OK;
+    }
+
+    hcryp.Init.OperatingMode = job->type == ASYNC_GCM_ENCRYPT ? CRYP_ALGOMODE_ENCRYPT : CRYP_ALGOMODE_DECRYPT;
+    hcryp.Init.ChainingMode  = CRYP_CHAINMODE_AES_GCM_GMAC;
+    hcryp.Init.GCMCMACPhase  = CRYP_GCM_INIT_PHASE;
+    // the queued jobs can use different keys, always load it
+    hcryp.Init.KeyWriteFlag  = CRYP_KEY_WRITE_ENABLE;
+    hcryp.Init.Header        = (uint8_t*)auth_header;
+    hcryp.Init.HeaderSize    = AUTH_HEADER_SIZE;
+
+    if (HAL_CRYP_Init(&hcryp) != HAL_OK) {
+        return false;
+    }
+
+    /* GCM init phase */
+    return HAL_CRYPEx_AES_Auth_IT(&hcryp, NULL, 0, NULL) == HAL_OK;
+}
+
+static bool async_next_phase(const async_job_t* job)
+{
+    switch (hcryp.Init.GCMCMACPhase) {
+    case CRYP_GCM_INIT_PHASE:
+        hcryp.Init.GCMCMACPhase = CRYP_GCMCMAC_HEADER_PHASE;
+        return HAL_CRYPEx_AES_Auth_IT(&hcryp, NULL, 0, NULL) == HAL_OK;
+
+    case CRYP_GCMCMAC_HEADER_PHASE:
+        hcryp.Init.GCMCMACPhase = CRYP_GCM_PAYLOAD_PHASE;
+        return HAL_CRYPEx_AES_Auth_IT(&hcryp, (uint8_t*)job->input, job->length, job->output) == HAL_OK;
+
+    default:
+        hcryp.Init.GCMCMACPhase = CRYP_GCMCMAC_FINAL_PHASE;
+        return HAL_CRYPEx_AES_Auth_IT(&hcryp, NULL, job->length, job->mic) == HAL_OK;
+    }
+}
+
+/**
+ * Terminate the running job and start the next queued ones, called from the
+ * AES interrupt
+ */
+static void async_complete(bool result)
+{
+    const async_job_t* job = async_job;
+    aes_hw_callback_t callback = job->callback;
+    void* context = job->context;
+
+    async_queues[job->priority].head++;
+
+    // chain the next job before notifying, so the peripheral does not wait on
+    // the callback
+    async_run_next();
+
+    if (callback != NULL) {
+        callback(result, context);
+    }
+}
+
+/**
+ * Start the next job: the urgent ones first, then the suspended bulk job or
+ * the next bulk one. The jobs which fail to start are terminated.
+ */
+static void async_run_next(void)
+{
+    while (true) {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        async_queue_t* queue = &async_queues[AES_HW_PRIORITY_URGENT];
+        if (queue->head == queue->tail) {
+            queue = &async_queues[AES_HW_PRIORITY_BULK];
+        }
+        if (queue->head == queue->tail) {
+            async_job = NULL;
+            async_running = false;
+            __set_PRIMASK(primask);
+            return;
+        }
+        const async_job_t* job = &queue->jobs[queue->head % ASYNC_QUEUE_SIZE];
+        bool resume = job->priority == AES_HW_PRIORITY_BULK && async_suspended;
+        async_job = job;
+        async_preempting = false;
+        async_suspended = false;
+        __set_PRIMASK(primask);
+
+        bool started = resume ? async_resume(job) : async_start(job);
+
+        __disable_irq();
+        if (started && job->priority == AES_HW_PRIORITY_BULK
+                && async_queues[AES_HW_PRIORITY_URGENT].head != async_queues[AES_HW_PRIORITY_URGENT].tail) {
+            // an urgent job was queued while the bulk one was started
+            async_preempt();
+        }
+        __set_PRIMASK(primask);
+        if (started) {
+            return;
+        }
+
+        queue->head++;
+        if (job->callback != NULL) {
+            job->callback(false, job->context);
+        }
+    }
+}
+
+/**
+ * Request the suspension of the running bulk job, at the next block of the
+ * CTR or GCM payload, else at the end of the GCM phase
+ */
+static void async_preempt(void)
+{
+    async_preempting = true;
+    if (hcryp.Init.ChainingMode == CRYP_CHAINMODE_AES_CTR || hcryp.Init.GCMCMACPhase == CRYP_GCM_PAYLOAD_PHASE) {
+        HAL_CRYPEx_ProcessSuspend(&hcryp);
+    }
+}
+
+/**
+ * Save the context of the bulk job stopped at a block boundary and start the
+ * urgent jobs, as the suspension procedure of the reference manual
+ * @param phase_done true if the job is stopped between two GCM phases
+ */
+static void async_suspend(bool phase_done)
+{
+    async_context_t* context = &async_context;
+
+    HAL_CRYPEx_Read_ControlRegister(&hcryp, (uint8_t*)&context->control);
+    if (hcryp.Init.ChainingMode == CRYP_CHAINMODE_AES_GCM_GMAC) {
+        HAL_CRYPEx_Read_SuspendRegisters(&hcryp, context->suspend);
+    }
+    // the IV registers are read with the peripheral disabled
+    __HAL_CRYP_DISABLE(&hcryp);
+    HAL_CRYPEx_Read_IVRegisters(&hcryp, context->init_vector);
+    context->control &= ~(AES_CR_EN | AES_CR_CCFIE | AES_CR_ERRIE);
+    context->phase = hcryp.Init.GCMCMACPhase;
+    context->phase_done = phase_done;
+    context->offset = hcryp.pCrypOutBuffPtr - async_job->output;
+
+    hcryp.State = HAL_CRYP_STATE_READY;
+    hcryp.SuspendRequest = HAL_CRYP_SUSPEND_NONE;
+    async_suspended = true;
+    async_run_next();
+}
+
+/**
+ * Restore the registers of the suspended bulk job and continue it, the key
+ * is written again as the urgent jobs can use another one
+ */
+static bool async_resume(const async_job_t* job)
+{
+    async_context_t* context = &async_context;
+
+    hcryp.Init.DataType      = CRYP_DATATYPE_8B;
+    hcryp.Init.KeySize       = job->key_size;
+    set_key(job->key);
+    hcryp.Init.pInitVect     = (uint8_t*)job->init_vector;
+    hcryp.Init.OperatingMode = job->type == ASYNC_GCM_DECRYPT ? CRYP_ALGOMODE_DECRYPT : CRYP_ALGOMODE_ENCRYPT;
+    hcryp.Init.ChainingMode  = job->type == ASYNC_CTR_ENCRYPT ? CRYP_CHAINMODE_AES_CTR : CRYP_CHAINMODE_AES_GCM_GMAC;
+    hcryp.Init.GCMCMACPhase  = context->phase;
+    hcryp.Init.Header        = (uint8_t*)auth_header;
+    hcryp.Init.HeaderSize    = AUTH_HEADER_SIZE;
+
+    HAL_CRYPEx_Write_ControlRegister(&hcryp, (uint8_t*)&context->control);
+    HAL_CRYPEx_Write_KeyRegisters(&hcryp, (uint8_t*)job->key, job->key_size);
+    HAL_CRYPEx_Write_IVRegisters(&hcryp, context->init_vector);
+    if (job->type != ASYNC_CTR_ENCRYPT) {
+        HAL_CRYPEx_Write_SuspendRegisters(&hcryp, context->suspend);
+    }
+    __HAL_CRYP_ENABLE(&hcryp);
+
+    if (context->phase_done) {
+        return async_next_phase(job);
+    }
+    if (job->type == ASYNC_CTR_ENCRYPT) {
+        return async_ctr_chunk(job, context->offset);
+    }
+    return HAL_CRYPEx_AES_Auth_IT(&hcryp, (uint8_t*)job->input + context->offset, job->length - context->offset,
+            job->output + context->offset) == HAL_OK;
+}
+
+/**
+ * Continue a CTR job under interrupt from offset, the counter is in the
+ * peripheral
+ */
+static bool async_ctr_chunk(const async_job_t* job, uint32_t offset)
+{
+    uint32_t size = chunk_size(job->length - offset);
+
+    async_chunk_end = offset + size;
+    return HAL_CRYPEx_AES_IT(&hcryp, (uint8_t*)job->input + offset, size, job->output + offset) == HAL_OK;
+}
+
+/**
+ * Set the key of an operation without session, the key registers will no
+ * longer contain the key of a session
+ */
+static void set_key(const uint8_t* key)
+{
+    hcryp.Init.pKey = (uint8_t*)key;
+    loaded_session = NULL;
+}
+
+/**
+ * Init the peripheral with a key of the session, the key registers are only
+ * written if they do not contain it
+ * @param decryption_key true for the decryption key, false for the key
+ */
+static bool session_load(aes_hw_session_t* session, bool decryption_key)
+{
+    bool loaded = loaded_session == session && loaded_decryption_key == decryption_key;
+
+    hcryp.Init.KeyWriteFlag = loaded ? CRYP_KEY_WRITE_DISABLE : CRYP_KEY_WRITE_ENABLE;
+    hcryp.Init.KeySize      = session->key_size;
+    hcryp.Init.pKey         = decryption_key ? session->decryption_key : session->key;
+    // unknown content if the init fails
+    loaded_session = NULL;
+
+    if (HAL_CRYP_Init(&hcryp) != HAL_OK) {
+        return false;
+    }
+    loaded_session = session;
+    loaded_decryption_key = decryption_key;
+    return true;
+}
+
+/**
+ * Configure the peripheral for an operation of the session, without the
+ * DeInit of the HAL_CRYP_AESxxx functions and without writing the key if it
+ * is still loaded
+ */
+static bool session_setup(aes_hw_session_t* session, uint32_t operating_mode, uint32_t chaining_mode, const uint8_t* init_vector)
+{
+    hcryp.Init.DataType      = CRYP_DATATYPE_8B;
+    hcryp.Init.OperatingMode = operating_mode;
+    hcryp.Init.ChainingMode  = chaining_mode;
+    hcryp.Init.GCMCMACPhase  = CRYP_GCM_INIT_PHASE;
+    hcryp.Init.pInitVect     = (uint8_t*)init_vector;
+
+    return session_load(session, false);
+}
+
+static bool session_gcm(aes_hw_session_t* session, uint32_t operating_mode, const uint8_t* init_vector, const uint8_t* input, uint32_t length, uint8_t* output, uint8_t* mic)
+{
+    if (!buffers_valid(input, length, output)) {
+        return false;
+    }
+
+    hcryp.Init.Header        = (uint8_t*)auth_header;
+    hcryp.Init.HeaderSize    = AUTH_HEADER_SIZE;
+
+    if (!session_setup(session, operating_mode, CRYP_CHAINMODE_AES_GCM_GMAC, init_vector)) {
+        return false;
+    }
+
+    /* GCM init phase */
+    if (HAL_CRYPEx_AES_Auth(&hcryp, NULL, 0, NULL, HAL_MAX_DELAY) != HAL_OK) {
+        return false;
+    }
+
+    hcryp.Init.GCMCMACPhase  = CRYP_GCMCMAC_HEADER_PHASE;
+    if (HAL_CRYPEx_AES_Auth(&hcryp, NULL, 0, NULL, HAL_MAX_DELAY) != HAL_OK) {
+        return false;
+    }
+
+    hcryp.Init.GCMCMACPhase  = CRYP_GCM_PAYLOAD_PHASE;
+    if (HAL_CRYPEx_AES_Auth(&hcryp, (uint8_t*)input, length, output, HAL_MAX_DELAY) != HAL_OK) {
+        return false;
+    }
+
+    hcryp.Init.GCMCMACPhase  = CRYP_GCMCMAC_FINAL_PHASE;
+    return HAL_CRYPEx_AES_Auth(&hcryp, NULL, length, mic, HAL_MAX_DELAY) == HAL_OK;
+}
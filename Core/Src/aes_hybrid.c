@@ -0,0 +1,160 @@
+/**
+ ******************************************************************************
+ * @file    aes_hybrid.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   AES CTR split between the peripheral and CMOX
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "stm32l4xx_hal.h"
+
+#include "aes_hw.h"
+#include "aes_hybrid.h"
+#include "aes_sw.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define AES_SIZE 16 // 128 bits
+#define CTR_IV_SIZE 16 // 128 bits
+// each engine keeps a part of the data, so its speed is still measured
+#define SHARE_MIN (AES_HYBRID_SHARE_ONE / 16)
+#define SHARE_MAX (AES_HYBRID_SHARE_ONE - SHARE_MIN)
+#define SHARE_STEP (AES_HYBRID_SHARE_ONE / 32) // when the peripheral ends first
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint32_t get_counter(const uint8_t* counter);
+static void set_counter(uint8_t* counter, uint32_t value);
+static bool sw_encrypt(aes_hybrid_t* hybrid, uint8_t* counter, const uint8_t* input, uint32_t length, uint8_t* output);
+static void tune(aes_hybrid_t* hybrid, uint32_t hw_length, uint32_t t_hw, uint32_t sw_length, uint32_t t_sw);
+
+/* Public functions ----------------------------------------------------------*/
+
+bool aes_hybrid_init(aes_hybrid_t* hybrid, const uint8_t* key, uint32_t key_size)
+{
+    if (key_size > sizeof(hybrid->key)) {
+        return false;
+    }
+    memcpy(hybrid->key, key, key_size);
+    hybrid->share = AES_HYBRID_SHARE_ONE / 2;
+    return aes_sw_ctr_context_init(&hybrid->sw, key);
+}
+
+bool aes_hybrid_ctr_encrypt(aes_hybrid_t* hybrid, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data)
+{
+    uint8_t counter[CTR_IV_SIZE] __ALIGNED(4);
+    // the peripheral takes whole blocks, CMOX the rest
+    uint32_t hw_length = (uint32_t)(((uint64_t)length * hybrid->share) / AES_HYBRID_SHARE_ONE) & ~(AES_SIZE - 1);
+    uint32_t sw_length = length - hw_length;
+    bool result = true;
+
+    memcpy(counter, init_vector, CTR_IV_SIZE);
+    set_counter(counter, get_counter(counter) + hw_length / AES_SIZE);
+
+    uint32_t t0 = DWT->CYCCNT;
+    if (hw_length != 0) {
+        result = aes_hw_ctr_encrypt_dma(hybrid->key, init_vector, plain_data, hw_length, cipher_data);
+    }
+    if (sw_length != 0) {
+        result = sw_encrypt(hybrid, counter, plain_data + hw_length, sw_length, cipher_data + hw_length) && result;
+    }
+    uint32_t t_sw = DWT->CYCCNT - t0;
+
+    // the time of the peripheral is only known if it ends last
+    bool hw_last = aes_hw_busy();
+    if (hw_length != 0) {
+        result = aes_hw_wait() && result;
+    }
+    uint32_t t_hw = hw_last ? DWT->CYCCNT - t0 : 0;
+
+    if (result) {
+        tune(hybrid, hw_length, t_hw, sw_length, t_sw);
+    }
+    return result;
+}
+
+void aes_hybrid_cleanup(aes_hybrid_t* hybrid)
+{
+    aes_sw_ctr_context_cleanup(&hybrid->sw);
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @return the 32 bits counter of the last bytes, big-endian
+ */
+static uint32_t get_counter(const uint8_t* counter)
+{
+    return ((uint32_t)counter[12] << 24) | ((uint32_t)counter[13] << 16) | ((uint32_t)counter[14] << 8) | counter[15];
+}
+
+static void set_counter(uint8_t* counter, uint32_t value)
+{
+    counter[12] = value >> 24;
+    counter[13] = value >> 16;
+    counter[14] = value >> 8;
+    counter[15] = value;
+}
+
+/**
+ * CMOX increments the whole 128 bits block, the part after a wrap of the 32
+ * bits counter is encrypted from a new IV, as the peripheral does
+ */
+static bool sw_encrypt(aes_hybrid_t* hybrid, uint8_t* counter, const uint8_t* input, uint32_t length, uint8_t* output)
+{
+    uint64_t wrap_length = ((uint64_t)1 << 32) - get_counter(counter);
+
+    wrap_length *= AES_SIZE;
+    if (length > wrap_length) {
+        if (!aes_sw_ctr_context_encrypt(&hybrid->sw, counter, input, wrap_length, output)) {
+            return false;
+        }
+        set_counter(counter, 0);
+        input += wrap_length;
+        output += wrap_length;
+        length -= wrap_length;
+    }
+    return aes_sw_ctr_context_encrypt(&hybrid->sw, counter, input, length, output);
+}
+
+/**
+ * Move the share to the point where both engines take the same time, from
+ * their speeds in the last call, half of the correction is applied to damp
+ * the noise of the measurements
+ * @param t_hw the time of the peripheral, 0 if it ended first (unknown), the
+ * share then grows by a step until it ends last
+ */
+static void tune(aes_hybrid_t* hybrid, uint32_t hw_length, uint32_t t_hw, uint32_t sw_length, uint32_t t_sw)
+{
+    uint32_t share;
+
+    if (hw_length == 0 || sw_length == 0 || t_sw == 0) {
+        return;
+    }
+
+    if (t_hw == 0) {
+        share = hybrid->share + SHARE_STEP;
+    } else {
+        // hw_speed / (hw_speed + sw_speed), with speed = length / time
+        uint64_t hw_weight = (uint64_t)hw_length * t_sw;
+        uint64_t sw_weight = (uint64_t)sw_length * t_hw;
+        share = (hybrid->share + (uint32_t)((hw_weight * AES_HYBRID_SHARE_ONE) / (hw_weight + sw_weight))) / 2;
+    }
+
+    if (share < SHARE_MIN) {
+        share = SHARE_MIN;
+    } else if (share > SHARE_MAX) {
+        share = SHARE_MAX;
+    }
+    hybrid->share = share;
+}
@@ -0,0 +1,331 @@
+/**
+ ******************************************************************************
+ * @file    aes_select.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   AES engine selected at every call from a calibration table
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "stm32l4xx_hal.h"
+
+#include "aes_hw.h"
+#include "aes_select.h"
+#include "aes_sw.h"
+#include "bench.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define AES_SIZE 16 // 128 bits
+#define CTR_IV_SIZE 16 // 128 bits
+#define AUTH_HEADER_SIZE 16
+#define SW_ENGINE_NUMBER (AES_SELECT_ENGINE_NUMBER - AES_SELECT_SW_FAST)
+// weight of the last call in the rate of the key changes
+#define RATE_SHIFT 3
+
+/* Private typedef -----------------------------------------------------------*/
+
+/**
+ * The CMOX contexts of an implementation, initialized with the last key when
+ * the engine is first chosen
+ */
+typedef struct {
+    aes_sw_ctr_context_t ctr;
+    aes_sw_gcm_context_t gcm;
+    bool ctr_ready;
+    bool gcm_ready;
+} sw_engine_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+// same header as aes_sw, so the engines give the same tag
+static const char auth_header[] = "0123456789ABCDEF";
+static const uint8_t calibration_init_vector[CTR_IV_SIZE] __ALIGNED(4);
+
+static aes_select_table_t table;
+static uint32_t counters[AES_SELECT_MODE_NUMBER][AES_SELECT_ENGINE_NUMBER];
+static uint32_t key_size;
+static bool hw_key_size; // the peripheral takes the key size
+static uint8_t last_key[32];
+static bool last_key_valid;
+static uint32_t key_rate;
+static sw_engine_t sw_engines[SW_ENGINE_NUMBER];
+
+/* Private function prototypes -----------------------------------------------*/
+
+static bool hw_available(void);
+static int64_t estimate(const aes_select_cost_t* cost, uint32_t length);
+static void update_key(const uint8_t* key);
+static void release_contexts(void);
+static bool encrypt(aes_select_mode_t mode, aes_select_engine_t engine, const uint8_t* init_vector,
+        const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic);
+static bool prepare(aes_select_mode_t mode, aes_select_engine_t engine);
+static bool measure(aes_select_mode_t mode, aes_select_engine_t engine, const uint8_t* input, uint32_t length,
+        uint8_t* output, uint32_t* t);
+
+/* Public functions ----------------------------------------------------------*/
+
+void aes_select_init(void)
+{
+    release_contexts();
+    memset(&table, 0, sizeof(table));
+    aes_select_reset_counters();
+    last_key_valid = false;
+    key_rate = 0;
+    aes_select_set_key_size(AES_SIZE);
+}
+
+bool aes_select_set_key_size(uint32_t size)
+{
+    if (!aes_sw_set_key_size(size)) {
+        return false;
+    }
+    release_contexts();
+    last_key_valid = false;
+    key_size = size;
+    hw_key_size = aes_hw_set_key_size(size);
+    return true;
+}
+
+void aes_select_set_table(const aes_select_table_t* new_table)
+{
+    table = *new_table;
+}
+
+const aes_select_table_t* aes_select_get_table(void)
+{
+    return &table;
+}
+
+bool aes_select_calibrate(const uint8_t* key, const uint8_t* input, uint32_t length, uint8_t* output)
+{
+    bool result = true;
+
+    if (length <= AES_SIZE) {
+        return false;
+    }
+
+    for (int m = 0; m < AES_SELECT_MODE_NUMBER; m++) {
+        for (int e = 0; e < AES_SELECT_ENGINE_NUMBER; e++) {
+            aes_select_cost_t* cost = &table.costs[m][e];
+            uint32_t t_small;
+            uint32_t t_large;
+
+            if (e == AES_SELECT_HW && !hw_key_size) {
+                continue;
+            }
+
+            // the peripheral loads the key at every call, CMOX expands it
+            // in the context
+            release_contexts();
+            memcpy(last_key, key, key_size);
+            last_key_valid = true;
+            uint32_t t0 = DWT->CYCCNT;
+            result = prepare(m, e) && result;
+            cost->key_setup = e == AES_SELECT_HW ? 0 : DWT->CYCCNT - t0;
+
+            if (!measure(m, e, input, AES_SIZE, output, &t_small) || !measure(m, e, input, length, output, &t_large)) {
+                result = false;
+                continue;
+            }
+
+            uint32_t slope_thousandths = 0;
+            if (t_large > t_small) {
+                slope_thousandths = (uint32_t)(((uint64_t)(t_large - t_small) * 1000) / (length - AES_SIZE));
+            }
+            cost->slope_thousandths = slope_thousandths;
+            cost->intercept = (int32_t)t_small - (int32_t)((slope_thousandths * AES_SIZE) / 1000);
+        }
+    }
+    return result;
+}
+
+aes_select_engine_t aes_select_choose(aes_select_mode_t mode, uint32_t length)
+{
+    aes_select_engine_t best = AES_SELECT_SW_FAST;
+    int64_t best_time = INT64_MAX;
+
+    for (int e = 0; e < AES_SELECT_ENGINE_NUMBER; e++) {
+        if (e == AES_SELECT_HW && !hw_available()) {
+            continue;
+        }
+        int64_t time = estimate(&table.costs[mode][e], length);
+        if (time < best_time) {
+            best = e;
+            best_time = time;
+        }
+    }
+    return best;
+}
+
+bool aes_select_ctr_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data)
+{
+    update_key(key);
+    aes_select_engine_t engine = aes_select_choose(AES_SELECT_CTR, length);
+    counters[AES_SELECT_CTR][engine]++;
+    return encrypt(AES_SELECT_CTR, engine, init_vector, plain_data, length, cipher_data, NULL);
+}
+
+bool aes_select_gcm_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic)
+{
+    update_key(key);
+    aes_select_engine_t engine = aes_select_choose(AES_SELECT_GCM, length);
+    counters[AES_SELECT_GCM][engine]++;
+    return encrypt(AES_SELECT_GCM, engine, init_vector, plain_data, length, cipher_data, mic);
+}
+
+uint32_t aes_select_get_key_rate(void)
+{
+    return key_rate;
+}
+
+uint32_t aes_select_get_counter(aes_select_mode_t mode, aes_select_engine_t engine)
+{
+    return counters[mode][engine];
+}
+
+void aes_select_reset_counters(void)
+{
+    memset(counters, 0, sizeof(counters));
+}
+
+void aes_select_cleanup(void)
+{
+    release_contexts();
+    last_key_valid = false;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @return true if the peripheral takes the key size and is not used by a DMA
+ * operation or an asynchronous job
+ */
+static bool hw_available(void)
+{
+    return hw_key_size && !aes_hw_busy() && aes_hw_async_pending() == 0;
+}
+
+/**
+ * @return the estimated time of a message in cycles, the key setup being
+ * weighted by the rate of the key changes
+ */
+static int64_t estimate(const aes_select_cost_t* cost, uint32_t length)
+{
+    return cost->intercept
+            + ((int64_t)cost->slope_thousandths * length) / 1000
+            + ((int64_t)cost->key_setup * key_rate) / AES_SELECT_RATE_ONE;
+}
+
+/**
+ * Update the rate of the key changes with this call, the contexts of an other
+ * key are released
+ */
+static void update_key(const uint8_t* key)
+{
+    bool changed = !last_key_valid || memcmp(last_key, key, key_size) != 0;
+
+    key_rate -= key_rate >> RATE_SHIFT;
+    if (changed) {
+        key_rate += AES_SELECT_RATE_ONE >> RATE_SHIFT;
+        release_contexts();
+        memcpy(last_key, key, key_size);
+        last_key_valid = true;
+    }
+}
+
+static void release_contexts(void)
+{
+    for (int i = 0; i < SW_ENGINE_NUMBER; i++) {
+        sw_engine_t* sw = &sw_engines[i];
+        if (sw->ctr_ready) {
+            aes_sw_ctr_context_cleanup(&sw->ctr);
+            sw->ctr_ready = false;
+        }
+        if (sw->gcm_ready) {
+            aes_sw_gcm_context_cleanup(&sw->gcm);
+            sw->gcm_ready = false;
+        }
+    }
+}
+
+/**
+ * Encrypt with the last key on an engine
+ * @param mic the tag, only for GCM
+ */
+static bool encrypt(aes_select_mode_t mode, aes_select_engine_t engine, const uint8_t* init_vector,
+        const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic)
+{
+    if (!prepare(mode, engine)) {
+        return false;
+    }
+
+    if (engine == AES_SELECT_HW) {
+        if (mode == AES_SELECT_CTR) {
+            return aes_hw_ctr_encrypt(last_key, init_vector, plain_data, length, cipher_data);
+        }
+        return aes_hw_gcm_aad_encrypt(last_key, init_vector, (const uint8_t*)auth_header, AUTH_HEADER_SIZE,
+                plain_data, length, cipher_data, mic);
+    }
+
+    sw_engine_t* sw = &sw_engines[engine - AES_SELECT_SW_FAST];
+    if (mode == AES_SELECT_CTR) {
+        return aes_sw_ctr_context_encrypt(&sw->ctr, init_vector, plain_data, length, cipher_data);
+    }
+    return aes_sw_gcm_context_encrypt(&sw->gcm, init_vector, plain_data, length, cipher_data, mic);
+}
+
+/**
+ * Initialize the CMOX context of the mode and engine with the last key, if
+ * not done yet, nothing to do for the peripheral
+ */
+static bool prepare(aes_select_mode_t mode, aes_select_engine_t engine)
+{
+    if (engine == AES_SELECT_HW) {
+        return true;
+    }
+
+    sw_engine_t* sw = &sw_engines[engine - AES_SELECT_SW_FAST];
+    bool* ready = mode == AES_SELECT_CTR ? &sw->ctr_ready : &sw->gcm_ready;
+    if (*ready) {
+        return true;
+    }
+
+    aes_sw_variant_t variant = aes_sw_get_variant();
+    aes_sw_set_variant(engine == AES_SELECT_SW_FAST ? AES_SW_FAST : AES_SW_SMALL);
+    if (mode == AES_SELECT_CTR) {
+        *ready = aes_sw_ctr_context_init(&sw->ctr, last_key);
+    } else {
+        *ready = aes_sw_gcm_context_init(&sw->gcm, last_key, false);
+    }
+    aes_sw_set_variant(variant);
+    return *ready;
+}
+
+/**
+ * @param t the median time of a message in cycles
+ * @return true if the operation success
+ */
+static bool measure(aes_select_mode_t mode, aes_select_engine_t engine, const uint8_t* input, uint32_t length,
+        uint8_t* output, uint32_t* t)
+{
+    uint8_t mic[AES_SIZE];
+    bench_stats_t stats;
+    bool result = false;
+
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = encrypt(mode, engine, calibration_init_vector, input, length, output, mic);
+    }
+    *t = stats.median;
+    return result;
+}
@@ -21,25 +21,32 @@
 #include "stm32l4xx_hal.h"
 
 #include "aes_sw.h"
+#include "fragment.h"
 
 /* Private define ------------------------------------------------------------*/
 
 #define AES_SIZE 16 // 128 bits
 #define CTR_IV_SIZE 16 // 128 bits
+#define CBC_IV_SIZE 16 // 128 bits
 #define GCM_IV_SIZE 12 // 96 bits
 
 #define FAST
 
 #ifdef FAST
-#define ALGO_CTR CMOX_AESFAST_CTR_ENC_ALGO
-#define ALGO_GCM_ENC CMOX_AESFAST_GCMFAST_ENC_ALGO
-#define ALGO_GCM_DEC CMOX_AESFAST_GCMFAST_DEC_ALGO
+#define DEFAULT_VARIANT AES_SW_FAST
 #else
-#define ALGO_CTR CMOX_AESSMALL_CTR_ENC_ALGO
-#define ALGO_GCM_ENC CMOX_AESSMALL_GCMSMALL_ENC_ALGO
-#define ALGO_GCM_DEC CMOX_AESSMALL_GCMSMALL_DEC_ALGO
+#define DEFAULT_VARIANT AES_SW_SMALL
 #endif
 
+// the algorithms of the variant given to aes_sw_set_variant()
+#define FAST_OR_SMALL(fast, small) (variant == AES_SW_FAST ? (fast) : (small))
+#define ALGO_CTR FAST_OR_SMALL(CMOX_AESFAST_CTR_ENC_ALGO, CMOX_AESSMALL_CTR_ENC_ALGO)
+#define ALGO_CBC_ENC FAST_OR_SMALL(CMOX_AESFAST_CBC_ENC_ALGO, CMOX_AESSMALL_CBC_ENC_ALGO)
+#define ALGO_CBC_DEC FAST_OR_SMALL(CMOX_AESFAST_CBC_DEC_ALGO, CMOX_AESSMALL_CBC_DEC_ALGO)
+#define ALGO_GCM_ENC FAST_OR_SMALL(CMOX_AESFAST_GCMFAST_ENC_ALGO, CMOX_AESSMALL_GCMSMALL_ENC_ALGO)
+#define ALGO_GCM_DEC FAST_OR_SMALL(CMOX_AESFAST_GCMFAST_DEC_ALGO, CMOX_AESSMALL_GCMSMALL_DEC_ALGO)
+#define IMPL_CTR FAST_OR_SMALL(CMOX_AESFAST_CTR_ENC, CMOX_AESSMALL_CTR_ENC)
+
 #define MIC_SIZE 16
 #define AUTH_HEADER_SIZE 16
 
@@ -47,6 +54,16 @@
 
 static const char auth_header[] = "0123456789ABCDEF";
 
+// size of the keys in byte
+static size_t key_size = AES_SIZE;
+static aes_sw_variant_t variant = DEFAULT_VARIANT;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static bool buffers_valid(const uint8_t* input, uint32_t length, const uint8_t* output);
+static cmox_cipher_handle_t* gcm_construct(aes_sw_gcm_context_t* context, bool decrypt);
+static bool append_piece(void* context, const uint8_t* input, uint32_t length, uint8_t* output);
+
 /* Public functions ----------------------------------------------------------*/
 
 void aes_sw_init(void)
@@ -54,47 +71,253 @@ void aes_sw_init(void)
     if (cmox_initialize(NULL) != CMOX_INIT_SUCCESS) {
         assert(false);
     }
+    key_size = AES_SIZE;
+    variant = DEFAULT_VARIANT;
 }
 
-bool aes_sw_ctr_encrypt(uint8_t* key, uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data)
+bool aes_sw_set_key_size(uint32_t size)
+{
+    if (size != 16 && size != 24 && size != 32) {
+        return false;
+    }
+    key_size = size;
+    return true;
+}
+
+void aes_sw_set_variant(aes_sw_variant_t new_variant)
+{
+    variant = new_variant;
+}
+
+aes_sw_variant_t aes_sw_get_variant(void)
+{
+    return variant;
+}
+
+bool aes_sw_ctr_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data)
 {
     cmox_cipher_retval_t retval;
 
+    if (!buffers_valid(plain_data, length, cipher_data)) {
+        return false;
+    }
+
     retval = cmox_cipher_encrypt(ALGO_CTR,
             plain_data, length,
-            key, AES_SIZE,
+            key, key_size,
             init_vector, CTR_IV_SIZE,
             cipher_data, NULL);
 
     return retval == CMOX_CIPHER_SUCCESS;
 }
 
-bool aes_sw_gcm_encrypt(uint8_t* key, uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic)
+bool aes_sw_cbc_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data)
 {
     cmox_cipher_retval_t retval;
 
+    if (!buffers_valid(plain_data, length, cipher_data)) {
+        return false;
+    }
+
+    retval = cmox_cipher_encrypt(ALGO_CBC_ENC,
+            plain_data, length,
+            key, key_size,
+            init_vector, CBC_IV_SIZE,
+            cipher_data, NULL);
+
+    return retval == CMOX_CIPHER_SUCCESS;
+}
+
+bool aes_sw_cbc_decrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data)
+{
+    cmox_cipher_retval_t retval;
+
+    if (!buffers_valid(cipher_data, length, plain_data)) {
+        return false;
+    }
+
+    retval = cmox_cipher_decrypt(ALGO_CBC_DEC,
+            cipher_data, length,
+            key, key_size,
+            init_vector, CBC_IV_SIZE,
+            plain_data, NULL);
+
+    return retval == CMOX_CIPHER_SUCCESS;
+}
+
+bool aes_sw_gcm_encrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic)
+{
+    cmox_cipher_retval_t retval;
+
+    if (!buffers_valid(plain_data, length, cipher_data)) {
+        return false;
+    }
+
     retval = cmox_aead_encrypt(ALGO_GCM_ENC,
             plain_data, length,
             MIC_SIZE,
-            key, AES_SIZE,
+            key, key_size,
             init_vector, GCM_IV_SIZE,
-            auth_header, AUTH_HEADER_SIZE,
+            (const uint8_t*)auth_header, AUTH_HEADER_SIZE,
             cipher_data, NULL);
 
     return retval == CMOX_CIPHER_SUCCESS;
 }
 
-bool aes_sw_gcm_decrypt(uint8_t* key, uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, uint8_t* mic)
+bool aes_sw_gcm_decrypt(const uint8_t* key, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, uint8_t* mic)
 {
     cmox_cipher_retval_t retval;
 
+    if (!buffers_valid(cipher_data, length, plain_data)) {
+        return false;
+    }
+
     retval = cmox_aead_decrypt(ALGO_GCM_DEC,
             cipher_data, length + MIC_SIZE,
             MIC_SIZE,
-            key, AES_SIZE,
+            key, key_size,
             init_vector, GCM_IV_SIZE,
-            auth_header, AUTH_HEADER_SIZE,
+            (const uint8_t*)auth_header, AUTH_HEADER_SIZE,
             plain_data, NULL);
 
     return retval == CMOX_CIPHER_AUTH_SUCCESS;
 }
+
+bool aes_sw_ctr_context_init(aes_sw_ctr_context_t* context, const uint8_t* key)
+{
+    context->cipher = cmox_ctr_construct(&context->handle, IMPL_CTR);
+    if (context->cipher == NULL) {
+        return false;
+    }
+
+    return cmox_cipher_init(context->cipher) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_setKey(context->cipher, key, key_size) == CMOX_CIPHER_SUCCESS;
+}
+
+bool aes_sw_ctr_context_encrypt(aes_sw_ctr_context_t* context, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data)
+{
+    // only the counter is reset, the key schedule is kept
+    return buffers_valid(plain_data, length, cipher_data)
+            && cmox_cipher_setIV(context->cipher, init_vector, CTR_IV_SIZE) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_append(context->cipher, plain_data, length, cipher_data, NULL) == CMOX_CIPHER_SUCCESS;
+}
+
+bool aes_sw_ctr_context_encrypt_fragments(aes_sw_ctr_context_t* context, const uint8_t* init_vector,
+        const fragment_t* fragments, uint32_t number)
+{
+    return cmox_cipher_setIV(context->cipher, init_vector, CTR_IV_SIZE) == CMOX_CIPHER_SUCCESS
+            && fragment_process(fragments, number, append_piece, context->cipher);
+}
+
+void aes_sw_ctr_context_cleanup(aes_sw_ctr_context_t* context)
+{
+    cmox_cipher_cleanup(context->cipher);
+}
+
+bool aes_sw_gcm_context_init(aes_sw_gcm_context_t* context, const uint8_t* key, bool decrypt)
+{
+    context->cipher = gcm_construct(context, decrypt);
+    if (context->cipher == NULL) {
+        return false;
+    }
+
+    return cmox_cipher_init(context->cipher) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_setKey(context->cipher, key, key_size) == CMOX_CIPHER_SUCCESS;
+}
+
+bool aes_sw_gcm_context_encrypt(aes_sw_gcm_context_t* context, const uint8_t* init_vector, const uint8_t* plain_data, uint32_t length, uint8_t* cipher_data, uint8_t* mic)
+{
+    // the IV resets the GHASH state, the key schedule and the H tables are kept
+    return buffers_valid(plain_data, length, cipher_data)
+            && cmox_cipher_setTagLen(context->cipher, MIC_SIZE) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_setIV(context->cipher, init_vector, GCM_IV_SIZE) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_appendAD(context->cipher, (const uint8_t*)auth_header, AUTH_HEADER_SIZE) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_append(context->cipher, plain_data, length, cipher_data, NULL) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_generateTag(context->cipher, mic, NULL) == CMOX_CIPHER_SUCCESS;
+}
+
+bool aes_sw_gcm_context_decrypt(aes_sw_gcm_context_t* context, const uint8_t* init_vector, const uint8_t* cipher_data, uint32_t length, uint8_t* plain_data, const uint8_t* mic)
+{
+    return buffers_valid(cipher_data, length, plain_data)
+            && cmox_cipher_setTagLen(context->cipher, MIC_SIZE) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_setIV(context->cipher, init_vector, GCM_IV_SIZE) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_appendAD(context->cipher, (const uint8_t*)auth_header, AUTH_HEADER_SIZE) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_append(context->cipher, cipher_data, length, plain_data, NULL) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_verifyTag(context->cipher, mic, NULL) == CMOX_CIPHER_AUTH_SUCCESS;
+}
+
+bool aes_sw_gcm_context_encrypt_fragments(aes_sw_gcm_context_t* context, const uint8_t* init_vector,
+        const fragment_t* fragments, uint32_t number, uint8_t* mic)
+{
+    return cmox_cipher_setTagLen(context->cipher, MIC_SIZE) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_setIV(context->cipher, init_vector, GCM_IV_SIZE) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_appendAD(context->cipher, (const uint8_t*)auth_header, AUTH_HEADER_SIZE) == CMOX_CIPHER_SUCCESS
+            && fragment_process(fragments, number, append_piece, context->cipher)
+            && cmox_cipher_generateTag(context->cipher, mic, NULL) == CMOX_CIPHER_SUCCESS;
+}
+
+bool aes_sw_gcm_context_decrypt_fragments(aes_sw_gcm_context_t* context, const uint8_t* init_vector,
+        const fragment_t* fragments, uint32_t number, const uint8_t* mic)
+{
+    return cmox_cipher_setTagLen(context->cipher, MIC_SIZE) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_setIV(context->cipher, init_vector, GCM_IV_SIZE) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_appendAD(context->cipher, (const uint8_t*)auth_header, AUTH_HEADER_SIZE) == CMOX_CIPHER_SUCCESS
+            && fragment_process(fragments, number, append_piece, context->cipher)
+            && cmox_cipher_verifyTag(context->cipher, mic, NULL) == CMOX_CIPHER_AUTH_SUCCESS;
+}
+
+bool aes_sw_gcm_context_encrypt_batch(aes_sw_gcm_context_t* context, const aead_message_t* messages, uint32_t number)
+{
+    for (uint32_t i = 0; i < number; i++) {
+        const aead_message_t* message = &messages[i];
+        if (!buffers_valid(message->input, message->length, message->output)
+                || cmox_cipher_setTagLen(context->cipher, MIC_SIZE) != CMOX_CIPHER_SUCCESS
+                || cmox_cipher_setIV(context->cipher, message->nonce, GCM_IV_SIZE) != CMOX_CIPHER_SUCCESS
+                || cmox_cipher_appendAD(context->cipher, message->aad, message->aad_length) != CMOX_CIPHER_SUCCESS
+                || cmox_cipher_append(context->cipher, message->input, message->length, message->output, NULL) != CMOX_CIPHER_SUCCESS
+                || cmox_cipher_generateTag(context->cipher, message->tag, NULL) != CMOX_CIPHER_SUCCESS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void aes_sw_gcm_context_cleanup(aes_sw_gcm_context_t* context)
+{
+    cmox_cipher_cleanup(context->cipher);
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @return true if the output is the input (in place) or does not overlap it,
+ * CMOX processes the blocks in order and does not take shifted buffers
+ */
+static bool buffers_valid(const uint8_t* input, uint32_t length, const uint8_t* output)
+{
+    uintptr_t in = (uintptr_t)input;
+    uintptr_t out = (uintptr_t)output;
+
+    return in == out || out + length <= in || in + length <= out;
+}
+
+/**
+ * Construct the GCM handle of the variant given to aes_sw_set_variant(), the
+ * FAST and SMALL handles have different types
+ */
+static cmox_cipher_handle_t* gcm_construct(aes_sw_gcm_context_t* context, bool decrypt)
+{
+    if (variant == AES_SW_FAST) {
+        return cmox_gcmFast_construct(&context->handle.fast, decrypt ? CMOX_AESFAST_GCMFAST_DEC : CMOX_AESFAST_GCMFAST_ENC);
+    }
+    return cmox_gcmSmall_construct(&context->handle.small, decrypt ? CMOX_AESSMALL_GCMSMALL_DEC : CMOX_AESSMALL_GCMSMALL_ENC);
+}
+
+/**
+ * A piece of fragments appended to the CMOX handle given as context, whole
+ * blocks except for the last one as required by cmox_cipher_append()
+ */
+static bool append_piece(void* context, const uint8_t* input, uint32_t length, uint8_t* output)
+{
+    return cmox_cipher_append(context, input, length, output, NULL) == CMOX_CIPHER_SUCCESS;
+}
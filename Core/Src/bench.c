@@ -0,0 +1,206 @@
+/**
+ ******************************************************************************
+ * @file    bench.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   measurement engine
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "stm32l4xx_hal.h"
+
+#include "bench.h"
+#include "logger.h"
+
+/* Private define ------------------------------------------------------------*/
+
+// Tukey fences, a run out of [q1 - k * iqr, q3 + k * iqr] is an outlier,
+// k = 3 for the "far out" values
+#define OUTLIER_FACTOR 3
+
+/* Private variables ---------------------------------------------------------*/
+
+static uint32_t warmup_runs;
+static uint32_t timed_runs;
+static uint32_t overhead;
+
+static uint32_t samples[BENCH_MAX_RUNS];
+static uint32_t run; // number of finished runs, warm-up included
+static bool started;
+static uint32_t t0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void compute_stats(bench_stats_t* stats);
+static void sort(uint32_t* values, uint32_t length);
+static uint32_t square_root(uint64_t value);
+
+/* Public functions ----------------------------------------------------------*/
+
+void bench_init(uint32_t warmup, uint32_t runs)
+{
+    bench_stats_t stats;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    warmup_runs = warmup;
+    bench_set_runs(runs);
+
+    // an empty measurement gives the cost of bench_next() and of the loop
+    overhead = 0;
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+    }
+    overhead = stats.min;
+}
+
+void bench_set_runs(uint32_t runs)
+{
+    assert(runs > 0 && runs <= BENCH_MAX_RUNS);
+
+    timed_runs = runs;
+}
+
+void bench_begin(bench_stats_t* stats)
+{
+    (void)stats;
+
+    run = 0;
+    started = false;
+
+    // the results of the previous measurement are still being sent
+    logger_flush();
+
+    // SysTick is the only periodic interrupt, the AES and DMA ones are kept
+    HAL_SuspendTick();
+}
+
+bool bench_next(bench_stats_t* stats)
+{
+    uint32_t t1 = DWT->CYCCNT;
+
+    if (started) {
+        if (run >= warmup_runs) {
+            uint32_t t = t1 - t0;
+            samples[run - warmup_runs] = t > overhead ? t - overhead : 0;
+        }
+        run++;
+    }
+    started = true;
+
+    if (run < warmup_runs + timed_runs) {
+        t0 = DWT->CYCCNT;
+        return true;
+    }
+
+    HAL_ResumeTick();
+    compute_stats(stats);
+    return false;
+}
+
+void bench_set_single(bench_stats_t* stats, uint32_t t)
+{
+    stats->min = t;
+    stats->median = t;
+    stats->p99 = t;
+    stats->max = t;
+    stats->mean = t;
+    stats->stddev = 0;
+    stats->outliers = 0;
+    stats->runs = 1;
+}
+
+char* bench_format(char* text, const bench_stats_t* stats)
+{
+    snprintf(text, BENCH_TEXT_SIZE, "min = %lu, median = %lu, p99 = %lu, stddev = %lu, outliers = %lu",
+            stats->min, stats->median, stats->p99, stats->stddev, stats->outliers);
+    return text;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void compute_stats(bench_stats_t* stats)
+{
+    uint32_t n = timed_runs;
+    uint64_t sum = 0;
+    uint64_t sum_squares = 0;
+
+    sort(samples, n);
+
+    for (uint32_t i = 0; i < n; i++) {
+        sum += samples[i];
+    }
+    stats->mean = sum / n;
+
+    for (uint32_t i = 0; i < n; i++) {
+        int64_t diff = (int64_t)samples[i] - stats->mean;
+        sum_squares += diff * diff;
+    }
+    stats->stddev = square_root(sum_squares / n);
+
+    stats->runs = n;
+    stats->min = samples[0];
+    stats->max = samples[n - 1];
+    stats->median = n % 2 == 0 ? (samples[n / 2 - 1] + samples[n / 2]) / 2 : samples[n / 2];
+    stats->p99 = samples[(99 * n + 99) / 100 - 1];
+
+    uint32_t q1 = samples[n / 4];
+    uint32_t q3 = samples[(3 * n) / 4];
+    uint32_t range = OUTLIER_FACTOR * (q3 - q1);
+    uint32_t low = q1 > range ? q1 - range : 0;
+    uint32_t high = q3 + range;
+
+    stats->outliers = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (samples[i] < low || samples[i] > high) {
+            stats->outliers++;
+        }
+    }
+}
+
+/**
+ * Insertion sort, the samples are almost sorted most of the time
+ */
+static void sort(uint32_t* values, uint32_t length)
+{
+    for (uint32_t i = 1; i < length; i++) {
+        uint32_t value = values[i];
+        uint32_t j = i;
+        while (j > 0 && values[j - 1] > value) {
+            values[j] = values[j - 1];
+            j--;
+        }
+        values[j] = value;
+    }
+}
+
+static uint32_t square_root(uint64_t value)
+{
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
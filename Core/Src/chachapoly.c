@@ -0,0 +1,176 @@
+/**
+ ******************************************************************************
+ * @file    chachapoly.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   streaming ChaCha20-Poly1305, the fallback without the AES peripheral
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "chachapoly.h"
+
+/* Private function prototypes -----------------------------------------------*/
+
+static bool end_aad(chachapoly_context_t* context);
+static bool flush_block(chachapoly_context_t* context);
+static bool buffers_valid(const uint8_t* input, uint32_t length, const uint8_t* output);
+
+/* Public functions ----------------------------------------------------------*/
+
+bool chachapoly_context_init(chachapoly_context_t* context, const uint8_t* key, bool decrypt)
+{
+    context->cipher = cmox_chachapoly_construct(&context->handle, decrypt ? CMOX_CHACHAPOLY_DEC : CMOX_CHACHAPOLY_ENC);
+    if (context->cipher == NULL) {
+        return false;
+    }
+
+    return cmox_cipher_init(context->cipher) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_setKey(context->cipher, key, CHACHAPOLY_KEY_SIZE) == CMOX_CIPHER_SUCCESS;
+}
+
+bool chachapoly_context_start(chachapoly_context_t* context, const uint8_t* nonce)
+{
+    // the nonce derives the key of Poly1305 and resets the counter
+    context->payload = false;
+    context->length = 0;
+    return cmox_cipher_setIV(context->cipher, nonce, CHACHAPOLY_NONCE_SIZE) == CMOX_CIPHER_SUCCESS;
+}
+
+bool chachapoly_context_append_aad(chachapoly_context_t* context, const uint8_t* aad, uint32_t length)
+{
+    if (context->payload) {
+        return false;
+    }
+
+    // complete the block started by the previous chunks
+    while (context->length != 0 && length != 0) {
+        context->data[context->length++] = *aad++;
+        length--;
+        if (context->length == CHACHAPOLY_BLOCK_SIZE) {
+            if (cmox_cipher_appendAD(context->cipher, context->data, CHACHAPOLY_BLOCK_SIZE) != CMOX_CIPHER_SUCCESS) {
+                return false;
+            }
+            context->length = 0;
+        }
+    }
+
+    uint32_t aligned_length = length - length % CHACHAPOLY_BLOCK_SIZE;
+    if (aligned_length != 0 && cmox_cipher_appendAD(context->cipher, aad, aligned_length) != CMOX_CIPHER_SUCCESS) {
+        return false;
+    }
+
+    // the rest starts the next block, or is still in the current one
+    memcpy(&context->data[context->length], &aad[aligned_length], length - aligned_length);
+    context->length += length - aligned_length;
+    return true;
+}
+
+bool chachapoly_context_append(chachapoly_context_t* context, const uint8_t* input, uint32_t length, uint8_t* output)
+{
+    if (!buffers_valid(input, length, output) || !end_aad(context)) {
+        return false;
+    }
+
+    while (context->length != 0 && length != 0) {
+        context->data[context->length] = *input++;
+        context->output[context->length] = output++;
+        context->length++;
+        length--;
+        if (context->length == CHACHAPOLY_BLOCK_SIZE && !flush_block(context)) {
+            return false;
+        }
+    }
+
+    uint32_t aligned_length = length - length % CHACHAPOLY_BLOCK_SIZE;
+    if (aligned_length != 0
+            && cmox_cipher_append(context->cipher, input, aligned_length, output, NULL) != CMOX_CIPHER_SUCCESS) {
+        return false;
+    }
+
+    for (uint32_t i = aligned_length; i < length; i++) {
+        context->data[context->length] = input[i];
+        context->output[context->length] = &output[i];
+        context->length++;
+    }
+    return true;
+}
+
+bool chachapoly_context_generate_tag(chachapoly_context_t* context, uint8_t* mic)
+{
+    return end_aad(context)
+            && flush_block(context)
+            && cmox_cipher_generateTag(context->cipher, mic, NULL) == CMOX_CIPHER_SUCCESS;
+}
+
+bool chachapoly_context_verify_tag(chachapoly_context_t* context, const uint8_t* mic)
+{
+    return end_aad(context)
+            && flush_block(context)
+            && cmox_cipher_verifyTag(context->cipher, mic, NULL) == CMOX_CIPHER_AUTH_SUCCESS;
+}
+
+void chachapoly_context_cleanup(chachapoly_context_t* context)
+{
+    cmox_cipher_cleanup(context->cipher);
+    memset(context->data, 0, sizeof(context->data));
+    context->length = 0;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * Append the last partial block of the additional data before the payload
+ */
+static bool end_aad(chachapoly_context_t* context)
+{
+    if (context->payload) {
+        return true;
+    }
+    context->payload = true;
+    if (context->length != 0
+            && cmox_cipher_appendAD(context->cipher, context->data, context->length) != CMOX_CIPHER_SUCCESS) {
+        return false;
+    }
+    context->length = 0;
+    return true;
+}
+
+/**
+ * Process the gathered bytes of the payload and scatter their output, a
+ * partial block is the last one of the message
+ */
+static bool flush_block(chachapoly_context_t* context)
+{
+    if (context->length == 0) {
+        return true;
+    }
+    if (cmox_cipher_append(context->cipher, context->data, context->length, context->data, NULL) != CMOX_CIPHER_SUCCESS) {
+        return false;
+    }
+    for (uint32_t i = 0; i < context->length; i++) {
+        *context->output[i] = context->data[i];
+    }
+    context->length = 0;
+    return true;
+}
+
+/**
+ * @return true if the output is the input (in place) or does not overlap it,
+ * CMOX processes the blocks in order and does not take shifted buffers
+ */
+static bool buffers_valid(const uint8_t* input, uint32_t length, const uint8_t* output)
+{
+    uintptr_t in = (uintptr_t)input;
+    uintptr_t out = (uintptr_t)output;
+
+    return in == out || out + length <= in || in + length <= out;
+}
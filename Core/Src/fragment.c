@@ -0,0 +1,93 @@
+/**
+ ******************************************************************************
+ * @file    fragment.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   scatter-gather lists of the packet buffers
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "stm32l4xx_hal.h"
+
+#include "fragment.h"
+
+/* Private typedef -----------------------------------------------------------*/
+
+/**
+ * Block across fragments, with the destination of every byte
+ */
+typedef struct {
+    uint8_t data[FRAGMENT_BLOCK_SIZE] __ALIGNED(4);
+    uint8_t* output[FRAGMENT_BLOCK_SIZE];
+    uint32_t length;
+} gathered_block_t;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static bool flush_block(gathered_block_t* block, fragment_function_t function, void* context);
+
+/* Public functions ----------------------------------------------------------*/
+
+bool fragment_process(const fragment_t* fragments, uint32_t number, fragment_function_t function, void* context)
+{
+    gathered_block_t block;
+
+    block.length = 0;
+    for (uint32_t i = 0; i < number; i++) {
+        const uint8_t* input = fragments[i].input;
+        uint8_t* output = fragments[i].output;
+        uint32_t length = fragments[i].length;
+
+        // complete the block started by the previous fragments
+        while (block.length != 0 && length != 0) {
+            block.data[block.length] = *input++;
+            block.output[block.length] = output++;
+            block.length++;
+            length--;
+            if (block.length == FRAGMENT_BLOCK_SIZE && !flush_block(&block, function, context)) {
+                return false;
+            }
+        }
+
+        uint32_t aligned_length = length - length % FRAGMENT_BLOCK_SIZE;
+        if (aligned_length != 0 && !function(context, input, aligned_length, output)) {
+            return false;
+        }
+
+        // the rest starts the next block
+        for (uint32_t j = aligned_length; j < length; j++) {
+            block.data[block.length] = input[j];
+            block.output[block.length] = &output[j];
+            block.length++;
+        }
+    }
+
+    if (block.length != 0) {
+        memset(&block.data[block.length], 0, FRAGMENT_BLOCK_SIZE - block.length);
+        return flush_block(&block, function, context);
+    }
+    return true;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static bool flush_block(gathered_block_t* block, fragment_function_t function, void* context)
+{
+    if (!function(context, block->data, block->length, block->data)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < block->length; i++) {
+        *block->output[i] = block->data[i];
+    }
+    block->length = 0;
+    return true;
+}
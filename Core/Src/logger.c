@@ -0,0 +1,135 @@
+/**
+ ******************************************************************************
+ * @file    logger.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   non-blocking UART output
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "stm32l4xx_hal.h"
+#include "usart.h"
+
+#include "logger.h"
+
+/* Private variables ---------------------------------------------------------*/
+
+// the DMA sends [tail, tail + sending[ while [tail + sending, head[ is filled,
+// the indexes are free-running
+static uint8_t buffer[LOGGER_BUFFER_SIZE];
+static volatile uint32_t head;
+static volatile uint32_t tail;
+static volatile uint32_t sending; // 0 when the UART is idle
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void start_transfer(void);
+
+/* Public functions ----------------------------------------------------------*/
+
+void logger_init(void)
+{
+    head = 0;
+    tail = 0;
+    sending = 0;
+}
+
+void logger_write(const void* data, uint32_t length)
+{
+    const uint8_t* bytes = data;
+
+    while (length > 0) {
+        uint32_t free = LOGGER_BUFFER_SIZE - (head - tail);
+        if (free == 0) {
+            // the buffer is emptied by the transfer complete interrupt
+            continue;
+        }
+
+        uint32_t index = head % LOGGER_BUFFER_SIZE;
+        uint32_t chunk = LOGGER_BUFFER_SIZE - index;
+        if (chunk > free) {
+            chunk = free;
+        }
+        if (chunk > length) {
+            chunk = length;
+        }
+        memcpy(&buffer[index], bytes, chunk);
+        bytes += chunk;
+        length -= chunk;
+
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        head += chunk;
+        if (sending == 0) {
+            start_transfer();
+        }
+        __set_PRIMASK(primask);
+    }
+}
+
+void logger_flush(void)
+{
+    // sending is cleared once the last byte has left the UART (TC)
+    while (sending != 0) {
+    }
+}
+
+/* Callback functions --------------------------------------------------------*/
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart)
+{
+    if (huart != &hlpuart1) {
+        return;
+    }
+
+    tail += sending;
+    sending = 0;
+    start_transfer();
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart)
+{
+    if (huart != &hlpuart1) {
+        return;
+    }
+
+    // the data of the failed transfer are dropped
+    tail += sending;
+    sending = 0;
+    start_transfer();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * Send the next contiguous part of the buffer, with the interrupts disabled or
+ * from the UART interrupt
+ */
+static void start_transfer(void)
+{
+    uint32_t length = head - tail;
+    if (length == 0) {
+        return;
+    }
+
+    uint32_t index = tail % LOGGER_BUFFER_SIZE;
+    if (length > LOGGER_BUFFER_SIZE - index) {
+        length = LOGGER_BUFFER_SIZE - index;
+    }
+
+    sending = length;
+    if (HAL_UART_Transmit_DMA(&hlpuart1, &buffer[index], length) != HAL_OK) {
+        // the data are dropped rather than blocking the benchmark
+        tail += length;
+        sending = 0;
+    }
+}
@@ -27,11 +27,42 @@
 #include <string.h>
 
 #include "aes_hw.h"
+#include "aes_hybrid.h"
+#include "aes_select.h"
 #include "aes_sw.h"
+#include "bench.h"
+#include "chachapoly.h"
+#include "logger.h"
+#include "pk_bench.h"
+#include "report.h"
+#include "rng_pool.h"
+#include "storage_bench.h"
 #include "cmox_crypto.h"
 
 /* Private typedef -----------------------------------------------------------*/
 
+typedef bool (*sweep_function_t)(const void* algo, uint32_t length);
+
+// the constructors of a family differ only by the type of their handle, all
+// are members of digest_handle
+typedef cmox_hash_handle_t* (*hash_construct_t)(void* handle);
+typedef cmox_mac_handle_t* (*mac_construct_t)(void* handle, const void* impl);
+
+typedef struct {
+    const char* name;
+    cmox_hash_algo_t algo;
+    hash_construct_t construct;
+    size_t size; // digest size
+} hash_bench_t;
+
+typedef struct {
+    const char* name;
+    cmox_mac_algo_t algo;
+    mac_construct_t construct;
+    const void* impl;
+    size_t size; // tag size
+} mac_bench_t;
+
 /* Private define ------------------------------------------------------------*/
 
 #define AES_SIZE 16 // 128 bits
@@ -43,8 +74,82 @@
 
 #define CIPHER_NUMBER 10
 #define AEAD_NUMBER 7
+#define MAC_NUMBER 2
+#define HASH_NUMBER 14
+#define HMAC_NUMBER 10 // HMAC then KMAC
+
+// OTA blocks are appended as they are received, the MACs of the hashes take a
+// key of 256 bits
+#define DIGEST_CHUNK_SIZE 256
+#define DIGEST_MAX_SIZE 64
+#define HMAC_KEY_SIZE 32
+
+#define ASYNC_JOBS 4
+#define ASYNC_LENGTH (LENGTH / ASYNC_JOBS)
+// urgent job of the pre-emption runs, a control frame of a single block
+#define URGENT_LENGTH 16
+#define URGENT_DELAY_STEP 16 // delay loops added before the urgent job at every run
+
+// key sizes in byte, 192 bits only with CMOX
+#define KEY_SIZE_NUMBER 3
+
+#define SMALL_LENGTH_NUMBER 2
+
+// flash-resident input larger than a HAL call (64 KB), streamed through the
+// RAM buffer, with fewer runs
+#define LARGE_LENGTH 131072
+#define LARGE_RUNS 4
+
+// Ethernet frame held in 5 buffers of the network stack
+#define FRAME_LENGTH 1500
+#define FRAME_FRAGMENTS 5
+#define FRAME_GAP 4 // between the buffers, so they are not contiguous
+
+// CTR split between the peripheral and CMOX, on the whole buffer, after calls
+// to tune the share
+#define HYBRID_LENGTH BUFFER_LENGTH
+#define HYBRID_TUNE_RUNS 16
+#define CONTEXT_LENGTH_NUMBER 3
+
+// burst of messages sealed under one key, each with its nonce
+#define BATCH_MESSAGES 32
+#define BATCH_SIZE_NUMBER 3
+
+// runs of the measurement engine, fewer for the sweep to keep it short
+#define BENCH_WARMUP_RUNS 2
+#define BENCH_RUNS 32
+#define SWEEP_RUNS 8
+#define PK_RUNS 4
+#define STORAGE_RUNS 8
+#define SWEEP
+
+// ChaCha20-Poly1305 message streamed by the packets of a small MTU, a chunk
+// of a whole ChaCha20 block or not
+#ifdef SWEEP
+#define CHACHAPOLY_LENGTH 4096
+#else
+#define CHACHAPOLY_LENGTH LENGTH
+#endif
+#define CHACHAPOLY_MTU 64
+#define CHACHAPOLY_ODD_MTU 60
+
+// payload-size sweep, the buffers are sized to the largest length
+// (2 x 16 KB of the 64 KB RAM)
+#define SWEEP_MAX_LENGTH 16384
+#define SWEEP_LENGTH_NUMBER 17
+#define SWEEP_HW_NUMBER 10
+
+// iterations of the benchmark loop, 0 to run forever (the host build runs it
+// once and returns)
+#ifndef BENCH_LOOPS
+#define BENCH_LOOPS 0
+#endif
 
-#define SEND_DATA
+#ifdef SWEEP
+#define BUFFER_LENGTH SWEEP_MAX_LENGTH
+#else
+#define BUFFER_LENGTH LENGTH
+#endif
 
 /* Private macro -------------------------------------------------------------*/
 
@@ -57,13 +162,70 @@ static const uint8_t key[] = {
     0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
     0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
 };
+static const uint32_t key_sizes[KEY_SIZE_NUMBER] = {16, 24, 32};
+static uint32_t key_size;
+
 static const uint8_t auth_header[] = {
     0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
 };
 
-static uint8_t plain_data[LENGTH + MIC_SIZE];
-static uint8_t cipher_data[LENGTH + MIC_SIZE];
-static uint8_t mic[MIC_SIZE];
+// 32-bit aligned for the DMA transfers of the hardware AES
+static uint8_t plain_data[BUFFER_LENGTH + MIC_SIZE] __ALIGNED(4);
+static uint8_t cipher_data[BUFFER_LENGTH + MIC_SIZE] __ALIGNED(4);
+static uint8_t mic[MIC_SIZE] __ALIGNED(4);
+static uint8_t nonce[AEAD_IV_SIZE];
+
+// counter block of each asynchronous job, so the jobs give the same result as
+// a single CTR encryption of the whole buffer
+static uint8_t async_init_vectors[ASYNC_JOBS][CIPHER_IV_SIZE];
+static volatile uint32_t async_done;
+static volatile bool async_result;
+static uint8_t urgent_data[URGENT_LENGTH] __ALIGNED(4);
+static volatile uint32_t urgent_time; // cycle counter at the urgent callback
+
+static const uint32_t small_lengths[SMALL_LENGTH_NUMBER] = {32, 64};
+static const uint8_t large_data[LARGE_LENGTH] = {0}; // const, so in flash
+
+// Ethernet, IPv4 and UDP headers, then the payload in 2 buffers
+static const uint32_t frame_lengths[FRAME_FRAGMENTS] = {14, 20, 8, 1200, 258};
+static uint8_t frame_buffers[FRAME_LENGTH + FRAME_FRAGMENTS * FRAME_GAP] __ALIGNED(4);
+static uint8_t frame_staging[FRAME_LENGTH] __ALIGNED(4);
+static fragment_t frame[FRAME_FRAGMENTS]; // encrypted in place
+static const fragment_t frame_linear = {frame_staging, frame_staging, FRAME_LENGTH};
+static aes_hw_session_t session;
+
+static const uint32_t context_lengths[CONTEXT_LENGTH_NUMBER] = {32, 64, LENGTH};
+static aes_sw_ctr_context_t ctr_context;
+static aes_sw_gcm_context_t gcm_enc_context;
+static aes_sw_gcm_context_t gcm_dec_context;
+static aes_hybrid_t hybrid;
+static chachapoly_context_t chachapoly_enc_context;
+static chachapoly_context_t chachapoly_dec_context;
+
+// the messages of a batch read and write the same buffers
+static const uint32_t batch_sizes[BATCH_SIZE_NUMBER] = {16, 64, LENGTH};
+static uint8_t batch_nonces[BATCH_MESSAGES][AEAD_IV_SIZE];
+static uint8_t batch_tags[BATCH_MESSAGES][MIC_SIZE];
+static aead_message_t batch[BATCH_MESSAGES];
+
+// powers of two, then lengths not aligned on the AES block
+static const uint32_t sweep_lengths[SWEEP_LENGTH_NUMBER] = {
+        16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384,
+        1, 13, 100, 1000, 1500, 4097,
+};
+
+static char* sweep_hw_names[SWEEP_HW_NUMBER] = {
+        "aes_hw_ctr_enc",
+        "aes_hw_gcm_enc",
+        "aes_hw_gcm_dec",
+        "aes_hw_ctr_enc_dma",
+        "aes_hw_gcm_enc_dma",
+        "aes_hw_gcm_aad_enc",
+        "aes_hw_ccm_enc",
+        "aes_hw_cmac_gen",
+        "aes_hw_cbc_enc",
+        "aes_hw_cbc_dec",
+};
 
 static char* cipher_names[CIPHER_NUMBER] = {
         "CMOX_AESFAST_ECB",
@@ -88,13 +250,54 @@ static char* aead_names[AEAD_NUMBER] = {
         "CMOX_CHACHAPOLY",
 };
 
+static union {
+    cmox_sha256_handle_t md_small;
+    cmox_sha512_handle_t md_large;
+    cmox_sha3_handle_t sha3;
+    cmox_cmac_handle_t cmac;
+    cmox_hmac_handle_t hmac;
+    cmox_kmac_handle_t kmac;
+} digest_handle;
+static uint8_t digest[DIGEST_MAX_SIZE];
+static uint8_t stream_digest[DIGEST_MAX_SIZE];
+
+static char* select_names[AES_SELECT_MODE_NUMBER][AES_SELECT_ENGINE_NUMBER] = {
+        {"aes_select_ctr_hw", "aes_select_ctr_fast", "aes_select_ctr_small"},
+        {"aes_select_gcm_hw", "aes_select_gcm_fast", "aes_select_gcm_small"},
+};
+
 /* Private function prototypes -----------------------------------------------*/
 
+static bool sweep_cipher_encrypt(const void* algo, uint32_t length);
+static bool sweep_aead_encrypt(const void* algo, uint32_t length);
+static bool sweep_mac_compute(const void* algo, uint32_t length);
+static bool sweep_mac_stream(const void* algo, uint32_t length);
+static bool sweep_hash_compute(const void* algo, uint32_t length);
+static bool sweep_hash_stream(const void* algo, uint32_t length);
+static bool sweep_hw_ctr_encrypt(const void* algo, uint32_t length);
+static bool sweep_hw_gcm_encrypt(const void* algo, uint32_t length);
+static bool sweep_hw_gcm_decrypt(const void* algo, uint32_t length);
+static bool sweep_hw_ctr_encrypt_dma(const void* algo, uint32_t length);
+static bool sweep_hw_gcm_encrypt_dma(const void* algo, uint32_t length);
+static bool sweep_hw_gcm_aad_encrypt(const void* algo, uint32_t length);
+static bool sweep_hw_ccm_encrypt(const void* algo, uint32_t length);
+static bool sweep_hw_cmac_generate(const void* algo, uint32_t length);
+static bool sweep_hw_cbc_encrypt(const void* algo, uint32_t length);
+static bool sweep_hw_cbc_decrypt(const void* algo, uint32_t length);
+
 void SystemClock_Config(void);
-static char hex_to_str(uint8_t hex);
-static void send_hex_data(const uint8_t* data, size_t length);
-static void send_text(const char* text);
-static void send_result(const char* text, const uint8_t* data, const uint8_t* mic);
+static void async_callback(bool result, void* context);
+static void urgent_callback(bool result, void* context);
+static void sweep(const char* name, sweep_function_t function, const void* algo);
+static bool large_encrypt(bool gcm);
+static void frame_copy(void);
+static bool frame_hw_encrypt(const fragment_t* fragments, uint32_t number);
+static void batch_report(const char* name, uint32_t size, const bench_stats_t* stats, bool result);
+static void chachapoly_bench(void);
+static bool chachapoly_stream(chachapoly_context_t* context, bool decrypt, const uint8_t* input, uint8_t* output,
+        uint32_t chunk_size);
+static void digest_sweep(const char* name, sweep_function_t compute, sweep_function_t stream, const void* algo,
+        size_t size);
 
 /* Private user code ---------------------------------------------------------*/
 
@@ -150,6 +353,54 @@ int main(void)
             CMOX_CHACHAPOLY_DEC_ALGO,
     };
 
+    mac_bench_t macs[MAC_NUMBER] = {
+            {"CMOX_CMAC_AESFAST", CMOX_CMAC_AESFAST_ALGO, (mac_construct_t)cmox_cmac_construct, CMOX_CMAC_AESFAST, MIC_SIZE},
+            {"CMOX_CMAC_AESSMALL", CMOX_CMAC_AESSMALL_ALGO, (mac_construct_t)cmox_cmac_construct, CMOX_CMAC_AESSMALL, MIC_SIZE},
+    };
+
+    hash_bench_t hashes[HASH_NUMBER] = {
+            {"CMOX_SHA1", CMOX_SHA1_ALGO, (hash_construct_t)cmox_sha1_construct, CMOX_SHA1_SIZE},
+            {"CMOX_SHA224", CMOX_SHA224_ALGO, (hash_construct_t)cmox_sha224_construct, CMOX_SHA224_SIZE},
+            {"CMOX_SHA256", CMOX_SHA256_ALGO, (hash_construct_t)cmox_sha256_construct, CMOX_SHA256_SIZE},
+            {"CMOX_SHA384", CMOX_SHA384_ALGO, (hash_construct_t)cmox_sha384_construct, CMOX_SHA384_SIZE},
+            {"CMOX_SHA512", CMOX_SHA512_ALGO, (hash_construct_t)cmox_sha512_construct, CMOX_SHA512_SIZE},
+            {"CMOX_SHA512_224", CMOX_SHA512_224_ALGO, (hash_construct_t)cmox_sha512_224_construct, CMOX_SHA512_224_SIZE},
+            {"CMOX_SHA512_256", CMOX_SHA512_256_ALGO, (hash_construct_t)cmox_sha512_256_construct, CMOX_SHA512_256_SIZE},
+            {"CMOX_SHA3_224", CMOX_SHA3_224_ALGO, (hash_construct_t)cmox_sha3_224_construct, CMOX_SHA3_224_SIZE},
+            {"CMOX_SHA3_256", CMOX_SHA3_256_ALGO, (hash_construct_t)cmox_sha3_256_construct, CMOX_SHA3_256_SIZE},
+            {"CMOX_SHA3_384", CMOX_SHA3_384_ALGO, (hash_construct_t)cmox_sha3_384_construct, CMOX_SHA3_384_SIZE},
+            {"CMOX_SHA3_512", CMOX_SHA3_512_ALGO, (hash_construct_t)cmox_sha3_512_construct, CMOX_SHA3_512_SIZE},
+            {"CMOX_SHAKE128", CMOX_SHAKE128_ALGO, (hash_construct_t)cmox_shake128_construct, 32},
+            {"CMOX_SHAKE256", CMOX_SHAKE256_ALGO, (hash_construct_t)cmox_shake256_construct, 64},
+            {"CMOX_SM3", CMOX_SM3_ALGO, (hash_construct_t)cmox_sm3_construct, CMOX_SM3_SIZE},
+    };
+
+    mac_bench_t hmacs[HMAC_NUMBER] = {
+            {"CMOX_HMAC_SHA1", CMOX_HMAC_SHA1_ALGO, (mac_construct_t)cmox_hmac_construct, CMOX_HMAC_SHA1, CMOX_SHA1_SIZE},
+            {"CMOX_HMAC_SHA224", CMOX_HMAC_SHA224_ALGO, (mac_construct_t)cmox_hmac_construct, CMOX_HMAC_SHA224, CMOX_SHA224_SIZE},
+            {"CMOX_HMAC_SHA256", CMOX_HMAC_SHA256_ALGO, (mac_construct_t)cmox_hmac_construct, CMOX_HMAC_SHA256, CMOX_SHA256_SIZE},
+            {"CMOX_HMAC_SHA384", CMOX_HMAC_SHA384_ALGO, (mac_construct_t)cmox_hmac_construct, CMOX_HMAC_SHA384, CMOX_SHA384_SIZE},
+            {"CMOX_HMAC_SHA512", CMOX_HMAC_SHA512_ALGO, (mac_construct_t)cmox_hmac_construct, CMOX_HMAC_SHA512, CMOX_SHA512_SIZE},
+            {"CMOX_HMAC_SHA512_224", CMOX_HMAC_SHA512_224_ALGO, (mac_construct_t)cmox_hmac_construct, CMOX_HMAC_SHA512_224, CMOX_SHA512_224_SIZE},
+            {"CMOX_HMAC_SHA512_256", CMOX_HMAC_SHA512_256_ALGO, (mac_construct_t)cmox_hmac_construct, CMOX_HMAC_SHA512_256, CMOX_SHA512_256_SIZE},
+            {"CMOX_HMAC_SM3", CMOX_HMAC_SM3_ALGO, (mac_construct_t)cmox_hmac_construct, CMOX_HMAC_SM3, CMOX_SM3_SIZE},
+            {"CMOX_KMAC_128", CMOX_KMAC_128_ALGO, (mac_construct_t)cmox_kmac_construct, CMOX_KMAC_128, 32},
+            {"CMOX_KMAC_256", CMOX_KMAC_256_ALGO, (mac_construct_t)cmox_kmac_construct, CMOX_KMAC_256, 64},
+    };
+
+    sweep_function_t sweep_hw_functions[SWEEP_HW_NUMBER] = {
+            sweep_hw_ctr_encrypt,
+            sweep_hw_gcm_encrypt,
+            sweep_hw_gcm_decrypt,
+            sweep_hw_ctr_encrypt_dma,
+            sweep_hw_gcm_encrypt_dma,
+            sweep_hw_gcm_aad_encrypt,
+            sweep_hw_ccm_encrypt,
+            sweep_hw_cmac_generate,
+            sweep_hw_cbc_encrypt,
+            sweep_hw_cbc_decrypt,
+    };
+
     /* MCU Configuration--------------------------------------------------------*/
 
     /* Reset of all peripherals, Initializes the Flash interface and the Systick. */
@@ -167,124 +418,1045 @@ int main(void)
     DWT->CYCCNT = 0;
     DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 
+    logger_init();
+
     uint32_t t0;
     uint32_t t1;
     uint32_t measure_delay;
     uint32_t t;
-    char text[256];
+    uint32_t t_cpu;
+    uint32_t idle = 0;
+    bench_stats_t stats;
+    char name[32];
 
     t0 = DWT->CYCCNT;
     t1 = DWT->CYCCNT;
     measure_delay = t1 - t0;
 
+    bench_init(BENCH_WARMUP_RUNS, BENCH_RUNS);
+
     memset(plain_data, 0, LENGTH);
 
-    for (int i = 0; i < LENGTH; i++) {
+    for (int i = 0; i < BUFFER_LENGTH; i++) {
         plain_data[i] = i;
     }
 
+    for (uint32_t i = 0, offset = 0; i < FRAME_FRAGMENTS; i++) {
+        frame[i].input = &frame_buffers[offset];
+        frame[i].output = &frame_buffers[offset];
+        frame[i].length = frame_lengths[i];
+        offset += frame_lengths[i] + FRAME_GAP;
+    }
+
+    for (int i = 0; i < BATCH_MESSAGES; i++) {
+        memcpy(batch_nonces[i], init_vector, AEAD_IV_SIZE);
+        batch_nonces[i][AEAD_IV_SIZE - 1] = i;
+        batch[i].nonce = batch_nonces[i];
+        batch[i].aad = auth_header;
+        batch[i].aad_length = AUTH_HEADER_SIZE;
+        batch[i].input = plain_data;
+        batch[i].output = cipher_data;
+        batch[i].tag = batch_tags[i];
+    }
+
+    for (int i = 0; i < ASYNC_JOBS; i++) {
+        memcpy(async_init_vectors[i], init_vector, CIPHER_IV_SIZE);
+        async_init_vectors[i][CIPHER_IV_SIZE - 1] = i * ASYNC_LENGTH / AES_SIZE;
+    }
+
     aes_hw_init();
     aes_sw_init();
+    aes_select_init();
+    report_init();
+    bool rng_ready = rng_pool_init();
 
     bool result;
-    while (1) {
+    for (uint32_t loop = 0; BENCH_LOOPS == 0 || loop < BENCH_LOOPS; loop++) {
         HAL_Delay(1000);
 
+        for (int k = 0; k < KEY_SIZE_NUMBER; k++) {
+            key_size = key_sizes[k];
+            report_set_key_size(key_size);
+            aes_sw_set_key_size(key_size);
+            // the peripheral has no 192 bits keys, only CMOX is measured
+            bool hw = aes_hw_set_key_size(key_size);
 
-        t0 = DWT->CYCCNT;
-        result = aes_hw_ctr_encrypt(key, init_vector, plain_data, LENGTH, cipher_data);
-        t1 = DWT->CYCCNT;
-        t = t1 - t0 - measure_delay;
+            if (hw) {
+                if (!aes_hw_session_init(&session, key)) {
+                    Error_Handler();
+                }
 
-        sprintf(text, "aes_hw_ctr_enc: t = %lu, result = %i\n", t, result);
-        send_result(text, cipher_data, NULL);
 
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_ctr_encrypt(key, init_vector, plain_data, LENGTH, cipher_data);
+                }
 
-        t0 = DWT->CYCCNT;
-        result = aes_hw_gcm_encrypt(key, init_vector, plain_data, LENGTH, cipher_data, mic);
-        t1 = DWT->CYCCNT;
-        t = t1 - t0 - measure_delay;
+                report_result("aes_hw_ctr_enc", LENGTH, &stats, result, cipher_data, NULL);
 
-        sprintf(text, "aes_hw_gcm_enc: t = %lu, result = %i\n", t, result);
-        send_result(text, cipher_data, mic);
 
+                // ECB and CBC with the IV of the CMOX runs, the decryption key
+                // is derived by the first decryption (warm-up run) only
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_ecb_encrypt(key, plain_data, LENGTH, cipher_data);
+                }
 
-        t0 = DWT->CYCCNT;
-        result = aes_hw_gcm_decrypt(key, init_vector, cipher_data, LENGTH, plain_data, mic);
-        t1 = DWT->CYCCNT;
-        t = t1 - t0 - measure_delay;
+                report_result("aes_hw_ecb_enc", LENGTH, &stats, result, cipher_data, NULL);
 
-        sprintf(text, "aes_hw_gcm_dec: t = %lu, result = %i\n", t, result);
-        send_result(text, plain_data, mic);
 
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_ecb_decrypt(key, cipher_data, LENGTH, plain_data);
+                }
 
+                report_result("aes_hw_ecb_dec", LENGTH, &stats, result, plain_data, NULL);
 
-        for (int i = 0; i < CIPHER_NUMBER; i++) {
-            cmox_cipher_retval_t retval;
-            size_t key_size = 16;
 
-            t0 = DWT->CYCCNT;
-            retval = cmox_cipher_encrypt(cipher_encs[i],
-                    plain_data, LENGTH,
-                    key, key_size,
-                    init_vector, CIPHER_IV_SIZE,
-                    cipher_data, NULL);
-            t1 = DWT->CYCCNT;
-            t = t1 - t0 - measure_delay;
-            result = retval == CMOX_CIPHER_SUCCESS;
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_cbc_encrypt(key, init_vector, plain_data, LENGTH, cipher_data);
+                }
 
-            sprintf(text, "%s_enc: t = %lu, result = %i\n", cipher_names[i], t, result);
-            send_result(text, cipher_data, NULL);
+                report_result("aes_hw_cbc_enc", LENGTH, &stats, result, cipher_data, NULL);
 
-            t0 = DWT->CYCCNT;
-            retval = cmox_cipher_decrypt(cipher_decs[i],
-                    cipher_data, LENGTH,
-                    key, key_size,
-                    init_vector, CIPHER_IV_SIZE,
-                    plain_data, NULL);
-            t1 = DWT->CYCCNT;
-            t = t1 - t0 - measure_delay;
-            result = retval == CMOX_CIPHER_SUCCESS;
 
-            sprintf(text, "%s_dec: t = %lu, result = %i\n", cipher_names[i], t, result);
-            send_result(text, plain_data, NULL);
-        }
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_cbc_decrypt(key, init_vector, cipher_data, LENGTH, plain_data);
+                }
+
+                report_result("aes_hw_cbc_dec", LENGTH, &stats, result, plain_data, NULL);
+
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_gcm_encrypt(key, init_vector, plain_data, LENGTH, cipher_data, mic);
+                }
+
+                report_result("aes_hw_gcm_enc", LENGTH, &stats, result, cipher_data, mic);
+
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_gcm_decrypt(key, init_vector, cipher_data, LENGTH, plain_data, mic);
+                }
+
+                report_result("aes_hw_gcm_dec", LENGTH, &stats, result, plain_data, mic);
+
+
+                // GCM with the header and IV of the CMOX AEAD runs, the tag is the same
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_gcm_aad_encrypt(key, init_vector, auth_header, AUTH_HEADER_SIZE, plain_data, LENGTH, cipher_data, mic);
+                }
+
+                report_result("aes_hw_gcm_aad_enc", LENGTH, &stats, result, cipher_data, mic);
+
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_gcm_aad_decrypt(key, init_vector, auth_header, AUTH_HEADER_SIZE, cipher_data, LENGTH, plain_data, mic);
+                }
+
+                report_result("aes_hw_gcm_aad_dec", LENGTH, &stats, result, plain_data, mic);
+
+
+                // CCM with the nonce, header and tag size of the CMOX AEAD runs
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_ccm_encrypt(key, init_vector, AEAD_IV_SIZE, auth_header, AUTH_HEADER_SIZE,
+                            plain_data, LENGTH, cipher_data, mic, MIC_SIZE);
+                }
+
+                report_result("aes_hw_ccm_enc", LENGTH, &stats, result, cipher_data, mic);
 
-        for (int i = 0; i < AEAD_NUMBER; i++) {
-            cmox_cipher_retval_t retval;
-            size_t key_size = aead_encs[i] == CMOX_CHACHAPOLY_ENC_ALGO ? 32 : 16;
 
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_ccm_decrypt(key, init_vector, AEAD_IV_SIZE, auth_header, AUTH_HEADER_SIZE,
+                            cipher_data, LENGTH, plain_data, mic, MIC_SIZE);
+                }
+
+                report_result("aes_hw_ccm_dec", LENGTH, &stats, result, plain_data, mic);
+
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_cmac_generate(key, plain_data, LENGTH, mic);
+                }
+
+                report_result("aes_hw_cmac_gen", LENGTH, &stats, result, NULL, mic);
+
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_cmac_verify(key, plain_data, LENGTH, mic);
+                }
+
+                report_result("aes_hw_cmac_ver", LENGTH, &stats, result, NULL, mic);
+
+
+                // DMA: the runs measure the time until the data are available, t_cpu
+                // is the time the CPU is busy before it can do something else (last run)
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    t0 = DWT->CYCCNT;
+                    result = aes_hw_ctr_encrypt_dma(key, init_vector, plain_data, LENGTH, cipher_data);
+                    t1 = DWT->CYCCNT;
+                    result = result && aes_hw_wait();
+                }
+                t_cpu = t1 - t0 - measure_delay;
+
+                report_result_async("aes_hw_ctr_enc_dma", LENGTH, &stats, t_cpu, 0, result, cipher_data, NULL);
+
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    t0 = DWT->CYCCNT;
+                    result = aes_hw_gcm_encrypt_dma(key, init_vector, plain_data, LENGTH, cipher_data, mic);
+                    t1 = DWT->CYCCNT;
+                    result = result && aes_hw_wait();
+                }
+                t_cpu = t1 - t0 - measure_delay;
+
+                report_result_async("aes_hw_gcm_enc_dma", LENGTH, &stats, t_cpu, 0, result, cipher_data, mic);
+
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    t0 = DWT->CYCCNT;
+                    result = aes_hw_gcm_decrypt_dma(key, init_vector, cipher_data, LENGTH, plain_data, mic);
+                    t1 = DWT->CYCCNT;
+                    result = result && aes_hw_wait();
+                }
+                t_cpu = t1 - t0 - measure_delay;
+
+                report_result_async("aes_hw_gcm_dec_dma", LENGTH, &stats, t_cpu, 0, result, plain_data, mic);
+
+
+                // in place: the output is the input, a frame needs one buffer.
+                // The runs encrypt cipher_data again and again, the data sent
+                // are the ones of a last run from the plain data (the same as
+                // with two buffers), a decryption must give them back.
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_ctr_encrypt(key, init_vector, cipher_data, LENGTH, cipher_data);
+                }
+                memcpy(cipher_data, plain_data, LENGTH);
+                result = result && aes_hw_ctr_encrypt(key, init_vector, cipher_data, LENGTH, cipher_data);
+
+                report_result("aes_hw_ctr_enc_in_place", LENGTH, &stats, result, cipher_data, NULL);
+
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_cbc_encrypt(key, init_vector, cipher_data, LENGTH, cipher_data);
+                }
+                memcpy(cipher_data, plain_data, LENGTH);
+                result = result && aes_hw_cbc_encrypt(key, init_vector, cipher_data, LENGTH, cipher_data);
+
+                report_result("aes_hw_cbc_enc_in_place", LENGTH, &stats, result, cipher_data, NULL);
+
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_cbc_decrypt(key, init_vector, cipher_data, LENGTH, cipher_data);
+                }
+                memcpy(cipher_data, plain_data, LENGTH);
+                result = result && aes_hw_cbc_encrypt(key, init_vector, cipher_data, LENGTH, cipher_data)
+                        && aes_hw_cbc_decrypt(key, init_vector, cipher_data, LENGTH, cipher_data)
+                        && memcmp(cipher_data, plain_data, LENGTH) == 0;
+
+                report_result("aes_hw_cbc_dec_in_place", LENGTH, &stats, result, cipher_data, NULL);
+
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_gcm_encrypt(key, init_vector, cipher_data, LENGTH, cipher_data, mic);
+                }
+                memcpy(cipher_data, plain_data, LENGTH);
+                result = result && aes_hw_gcm_encrypt(key, init_vector, cipher_data, LENGTH, cipher_data, mic);
+
+                report_result("aes_hw_gcm_enc_in_place", LENGTH, &stats, result, cipher_data, mic);
+
+
+                // the decryption gives the tag to compare, it is not verified
+                // on the data of the runs
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_gcm_decrypt(key, init_vector, cipher_data, LENGTH, cipher_data, mic);
+                }
+                memcpy(cipher_data, plain_data, LENGTH);
+                result = result && aes_hw_gcm_encrypt(key, init_vector, cipher_data, LENGTH, cipher_data, mic)
+                        && aes_hw_gcm_decrypt(key, init_vector, cipher_data, LENGTH, cipher_data, mic)
+                        && memcmp(cipher_data, plain_data, LENGTH) == 0;
+
+                report_result("aes_hw_gcm_dec_in_place", LENGTH, &stats, result, cipher_data, mic);
+
+
+                // the DMA writes each block over the input block it has read
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    t0 = DWT->CYCCNT;
+                    result = aes_hw_ctr_encrypt_dma(key, init_vector, cipher_data, LENGTH, cipher_data);
+                    t1 = DWT->CYCCNT;
+                    result = result && aes_hw_wait();
+                }
+                t_cpu = t1 - t0 - measure_delay;
+                memcpy(cipher_data, plain_data, LENGTH);
+                result = result && aes_hw_ctr_encrypt_dma(key, init_vector, cipher_data, LENGTH, cipher_data) && aes_hw_wait();
+
+                report_result_async("aes_hw_ctr_enc_dma_in_place", LENGTH, &stats, t_cpu, 0, result, cipher_data, NULL);
+
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    t0 = DWT->CYCCNT;
+                    result = aes_hw_gcm_encrypt_dma(key, init_vector, cipher_data, LENGTH, cipher_data, mic);
+                    t1 = DWT->CYCCNT;
+                    result = result && aes_hw_wait();
+                }
+                t_cpu = t1 - t0 - measure_delay;
+                memcpy(cipher_data, plain_data, LENGTH);
+                result = result && aes_hw_gcm_encrypt_dma(key, init_vector, cipher_data, LENGTH, cipher_data, mic) && aes_hw_wait();
+
+                report_result_async("aes_hw_gcm_enc_dma_in_place", LENGTH, &stats, t_cpu, 0, result, cipher_data, mic);
+
+
+                // asynchronous: the jobs are chained from the AES interrupt, idle counts
+                // the loops the application can run while waiting the end of the jobs
+                // (last run)
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    async_done = 0;
+                    async_result = true;
+                    result = true;
+                    t0 = DWT->CYCCNT;
+                    for (int i = 0; i < ASYNC_JOBS; i++) {
+                        result = result && aes_hw_ctr_encrypt_async(key, async_init_vectors[i],
+                                plain_data + i * ASYNC_LENGTH, ASYNC_LENGTH, cipher_data + i * ASYNC_LENGTH,
+                                async_callback, NULL);
+                    }
+                    t1 = DWT->CYCCNT;
+                    idle = 0;
+                    while (aes_hw_async_pending() != 0) {
+                        idle++;
+                    }
+                    result = result && async_result && async_done == ASYNC_JOBS;
+                }
+                t_cpu = t1 - t0 - measure_delay;
+
+                report_result_async("aes_hw_ctr_enc_async", LENGTH, &stats, t_cpu, idle, result, cipher_data, NULL);
+
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    async_done = 0;
+                    async_result = true;
+                    t0 = DWT->CYCCNT;
+                    result = aes_hw_gcm_encrypt_async(key, init_vector, plain_data, LENGTH, cipher_data, mic, async_callback, NULL);
+                    t1 = DWT->CYCCNT;
+                    idle = 0;
+                    while (aes_hw_async_pending() != 0) {
+                        idle++;
+                    }
+                    result = result && async_result && async_done == 1;
+                }
+                t_cpu = t1 - t0 - measure_delay;
+
+                report_result_async("aes_hw_gcm_enc_async", LENGTH, &stats, t_cpu, idle, result, cipher_data, mic);
+
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    async_done = 0;
+                    async_result = true;
+                    t0 = DWT->CYCCNT;
+                    result = aes_hw_gcm_decrypt_async(key, init_vector, cipher_data, LENGTH, plain_data, mic, async_callback, NULL);
+                    t1 = DWT->CYCCNT;
+                    idle = 0;
+                    while (aes_hw_async_pending() != 0) {
+                        idle++;
+                    }
+                    result = result && async_result && async_done == 1;
+                }
+                t_cpu = t1 - t0 - measure_delay;
+
+                report_result_async("aes_hw_gcm_dec_async", LENGTH, &stats, t_cpu, idle, result, plain_data, mic);
+
+
+                // pre-emption: an urgent GCM job is queued later in a bulk CTR job at
+                // every run, the latency until its callback is the worst of the runs,
+                // run-to-completion (both jobs bulk) then suspend/resume of the bulk job
+                for (int p = 0; p < 2; p++) {
+                    aes_hw_priority_t priority = p == 0 ? AES_HW_PRIORITY_BULK : AES_HW_PRIORITY_URGENT;
+                    uint32_t worst = 0;
+
+                    result = true;
+                    for (uint32_t run = 0; run < BENCH_RUNS; run++) {
+                        async_done = 0;
+                        async_result = true;
+                        result = result && aes_hw_ctr_encrypt_async(key, init_vector, plain_data, LENGTH, cipher_data, async_callback, NULL);
+                        for (volatile uint32_t i = 0; i < run * URGENT_DELAY_STEP; i++) {
+                        }
+                        aes_hw_set_priority(priority);
+                        t0 = DWT->CYCCNT;
+                        result = result && aes_hw_gcm_encrypt_async(key, init_vector, plain_data, URGENT_LENGTH, urgent_data, mic,
+                                urgent_callback, NULL);
+                        aes_hw_set_priority(AES_HW_PRIORITY_BULK);
+                        while (aes_hw_async_pending() != 0) {
+                        }
+                        result = result && async_result && async_done == 2;
+                        t = urgent_time - t0 - measure_delay;
+                        if (t > worst) {
+                            worst = t;
+                        }
+                    }
+
+                    bench_set_single(&stats, worst);
+                    report_result(p == 0 ? "aes_hw_urgent_rtc" : "aes_hw_urgent_preempt", URGENT_LENGTH, &stats, result, urgent_data, mic);
+                }
+
+
+                // small packets: without session, the peripheral is re-initialized and
+                // the key written at every call
+                for (int i = 0; i < SMALL_LENGTH_NUMBER; i++) {
+                    uint32_t length = small_lengths[i];
+
+                    result = false;
+                    bench_begin(&stats);
+                    while (bench_next(&stats)) {
+                        result = aes_hw_ctr_encrypt(key, init_vector, plain_data, length, cipher_data);
+                    }
+
+                    report_result("aes_hw_ctr_enc", length, &stats, result, cipher_data, NULL);
+
+                    result = false;
+                    bench_begin(&stats);
+                    while (bench_next(&stats)) {
+                        result = aes_hw_gcm_encrypt(key, init_vector, plain_data, length, cipher_data, mic);
+                    }
+
+                    report_result("aes_hw_gcm_enc", length, &stats, result, cipher_data, mic);
+
+                    result = false;
+                    bench_begin(&stats);
+                    while (bench_next(&stats)) {
+                        result = aes_hw_gcm_decrypt(key, init_vector, cipher_data, length, plain_data, mic);
+                    }
+
+                    report_result("aes_hw_gcm_dec", length, &stats, result, plain_data, mic);
+                }
+
+                // with session: the warm-up runs load the key, the timed ones reuse it
+
+                for (int i = 0; i < SMALL_LENGTH_NUMBER; i++) {
+                    uint32_t length = small_lengths[i];
+
+                    result = false;
+                    bench_begin(&stats);
+                    while (bench_next(&stats)) {
+                        result = aes_hw_session_ctr_encrypt(&session, init_vector, plain_data, length, cipher_data);
+                    }
+
+                    report_result("aes_hw_session_ctr_enc", length, &stats, result, cipher_data, NULL);
+
+                    result = false;
+                    bench_begin(&stats);
+                    while (bench_next(&stats)) {
+                        result = aes_hw_session_gcm_encrypt(&session, init_vector, plain_data, length, cipher_data, mic);
+                    }
+
+                    report_result("aes_hw_session_gcm_enc", length, &stats, result, cipher_data, mic);
+
+                    result = false;
+                    bench_begin(&stats);
+                    while (bench_next(&stats)) {
+                        result = aes_hw_session_gcm_decrypt(&session, init_vector, cipher_data, length, plain_data, mic);
+                    }
+
+                    report_result("aes_hw_session_gcm_dec", length, &stats, result, plain_data, mic);
+                }
+
+                // large buffer: the output does not fit in RAM, every piece overwrites
+                // the previous one, the counter and the GCM hash stay in the peripheral.
+                // The driver splits a single call in HAL calls of at most 65520 bytes,
+                // no buffer of 64 KB of RAM is that large: the split is not measured,
+                // it is checked by the host tests, a piece here costs the same HAL call.
+                bench_set_runs(LARGE_RUNS);
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = large_encrypt(false);
+                }
+
+                report_result("aes_hw_ctr_enc_stream", LARGE_LENGTH, &stats, result, NULL, NULL);
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = large_encrypt(true);
+                }
+
+                report_result("aes_hw_gcm_enc_stream", LARGE_LENGTH, &stats, result, NULL, mic);
+
+                bench_set_runs(BENCH_RUNS);
+            }
+
+
+            // CMOX one-shot functions expand the key (and compute the GHASH tables)
+            // at every message, the contexts do it once at init
+            logger_flush();
             t0 = DWT->CYCCNT;
-            retval = cmox_aead_encrypt(aead_encs[i],
-                    plain_data, LENGTH,
-                    MIC_SIZE,
-                    key, key_size,
-                    init_vector, AEAD_IV_SIZE,
-                    auth_header, AUTH_HEADER_SIZE,
-                    cipher_data, NULL);
+            result = aes_sw_ctr_context_init(&ctr_context, key);
             t1 = DWT->CYCCNT;
             t = t1 - t0 - measure_delay;
-            result = retval == CMOX_CIPHER_SUCCESS;
 
-            sprintf(text, "%s_enc: t = %lu, result = %i\n", aead_names[i], t, result);
-            send_result(text, cipher_data, mic);
+            bench_set_single(&stats, t);
+            report_result("aes_sw_ctr_context_init", 0, &stats, result, NULL, NULL);
 
+            logger_flush();
             t0 = DWT->CYCCNT;
-            retval = cmox_aead_decrypt(aead_decs[i],
-                    cipher_data, LENGTH + MIC_SIZE,
-                    MIC_SIZE,
-                    key, key_size,
-                    init_vector, AEAD_IV_SIZE,
-                    auth_header, AUTH_HEADER_SIZE,
-                    plain_data, NULL);
+            result = aes_sw_gcm_context_init(&gcm_enc_context, key, false);
             t1 = DWT->CYCCNT;
             t = t1 - t0 - measure_delay;
-            result = retval == CMOX_CIPHER_AUTH_SUCCESS;
+            result = result && aes_sw_gcm_context_init(&gcm_dec_context, key, true);
+
+            bench_set_single(&stats, t);
+            report_result("aes_sw_gcm_context_init", 0, &stats, result, NULL, NULL);
+
+            for (int i = 0; i < CONTEXT_LENGTH_NUMBER; i++) {
+                uint32_t length = context_lengths[i];
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_sw_ctr_encrypt(key, init_vector, plain_data, length, cipher_data);
+                }
+
+                report_result("aes_sw_ctr_enc", length, &stats, result, cipher_data, NULL);
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_sw_ctr_context_encrypt(&ctr_context, init_vector, plain_data, length, cipher_data);
+                }
+
+                report_result("aes_sw_ctr_context_enc", length, &stats, result, cipher_data, NULL);
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_sw_gcm_encrypt(key, init_vector, plain_data, length, cipher_data, mic);
+                }
+
+                report_result("aes_sw_gcm_enc", length, &stats, result, cipher_data, cipher_data + length);
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_sw_gcm_decrypt(key, init_vector, cipher_data, length, plain_data, mic);
+                }
+
+                report_result("aes_sw_gcm_dec", length, &stats, result, plain_data, NULL);
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_sw_gcm_context_encrypt(&gcm_enc_context, init_vector, plain_data, length, cipher_data, mic);
+                }
+
+                report_result("aes_sw_gcm_context_enc", length, &stats, result, cipher_data, mic);
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_sw_gcm_context_decrypt(&gcm_dec_context, init_vector, cipher_data, length, plain_data, mic);
+                }
+
+                report_result("aes_sw_gcm_context_dec", length, &stats, result, plain_data, mic);
+            }
+
+            // CBC, with two buffers then in place as for the peripheral
+            result = false;
+            bench_begin(&stats);
+            while (bench_next(&stats)) {
+                result = aes_sw_cbc_encrypt(key, init_vector, plain_data, LENGTH, cipher_data);
+            }
+
+            report_result("aes_sw_cbc_enc", LENGTH, &stats, result, cipher_data, NULL);
+
+            result = false;
+            bench_begin(&stats);
+            while (bench_next(&stats)) {
+                result = aes_sw_cbc_decrypt(key, init_vector, cipher_data, LENGTH, plain_data);
+            }
+
+            report_result("aes_sw_cbc_dec", LENGTH, &stats, result, plain_data, NULL);
+
+            result = false;
+            bench_begin(&stats);
+            while (bench_next(&stats)) {
+                result = aes_sw_ctr_encrypt(key, init_vector, cipher_data, LENGTH, cipher_data);
+            }
+            memcpy(cipher_data, plain_data, LENGTH);
+            result = result && aes_sw_ctr_encrypt(key, init_vector, cipher_data, LENGTH, cipher_data);
+
+            report_result("aes_sw_ctr_enc_in_place", LENGTH, &stats, result, cipher_data, NULL);
+
+            result = false;
+            bench_begin(&stats);
+            while (bench_next(&stats)) {
+                result = aes_sw_cbc_encrypt(key, init_vector, cipher_data, LENGTH, cipher_data);
+            }
+            memcpy(cipher_data, plain_data, LENGTH);
+            result = result && aes_sw_cbc_encrypt(key, init_vector, cipher_data, LENGTH, cipher_data);
+
+            report_result("aes_sw_cbc_enc_in_place", LENGTH, &stats, result, cipher_data, NULL);
+
+            result = false;
+            bench_begin(&stats);
+            while (bench_next(&stats)) {
+                result = aes_sw_cbc_decrypt(key, init_vector, cipher_data, LENGTH, cipher_data);
+            }
+            memcpy(cipher_data, plain_data, LENGTH);
+            result = result && aes_sw_cbc_encrypt(key, init_vector, cipher_data, LENGTH, cipher_data)
+                    && aes_sw_cbc_decrypt(key, init_vector, cipher_data, LENGTH, cipher_data)
+                    && memcmp(cipher_data, plain_data, LENGTH) == 0;
+
+            report_result("aes_sw_cbc_dec_in_place", LENGTH, &stats, result, cipher_data, NULL);
+
+            // the tag is verified at the end of the decryption, only the data
+            // decrypted in place from the encryption pass it
+            result = false;
+            bench_begin(&stats);
+            while (bench_next(&stats)) {
+                result = aes_sw_gcm_context_encrypt(&gcm_enc_context, init_vector, cipher_data, LENGTH, cipher_data, mic);
+            }
+            memcpy(cipher_data, plain_data, LENGTH);
+            result = result && aes_sw_gcm_context_encrypt(&gcm_enc_context, init_vector, cipher_data, LENGTH, cipher_data, mic);
+
+            report_result("aes_sw_gcm_context_enc_in_place", LENGTH, &stats, result, cipher_data, mic);
+
+            result = aes_sw_gcm_context_decrypt(&gcm_dec_context, init_vector, cipher_data, LENGTH, cipher_data, mic)
+                    && memcmp(cipher_data, plain_data, LENGTH) == 0;
+            if (!result) {
+                Error_Handler();
+            }
+
+            // fragmented frame: copied to a staging buffer and encrypted there, or
+            // encrypted in place from the fragments (only the blocks across two
+            // buffers are gathered), the difference is the cost of the copy
+            bench_begin(&stats);
+            while (bench_next(&stats)) {
+                frame_copy();
+            }
+
+            report_result("frame_copy", FRAME_LENGTH, &stats, true, NULL, NULL);
+
+            result = false;
+            bench_begin(&stats);
+            while (bench_next(&stats)) {
+                frame_copy();
+                result = aes_sw_gcm_context_encrypt_fragments(&gcm_enc_context, init_vector, &frame_linear, 1, mic);
+            }
+
+            report_result("aes_sw_gcm_context_enc_copy", FRAME_LENGTH, &stats, result, NULL, NULL);
+
+            result = false;
+            bench_begin(&stats);
+            while (bench_next(&stats)) {
+                result = aes_sw_gcm_context_encrypt_fragments(&gcm_enc_context, init_vector, frame, FRAME_FRAGMENTS, mic);
+            }
+
+            report_result("aes_sw_gcm_context_enc_frag", FRAME_LENGTH, &stats, result, NULL, NULL);
+
+            if (hw) {
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    frame_copy();
+                    result = frame_hw_encrypt(&frame_linear, 1);
+                }
+
+                report_result("aes_hw_gcm_enc_copy", FRAME_LENGTH, &stats, result, NULL, NULL);
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = frame_hw_encrypt(frame, FRAME_FRAGMENTS);
+                }
+
+                report_result("aes_hw_gcm_enc_frag", FRAME_LENGTH, &stats, result, NULL, NULL);
+
+                // each engine alone, then both on their share of the buffer
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_hw_ctr_encrypt_dma(key, init_vector, plain_data, HYBRID_LENGTH, cipher_data);
+                    result = result && aes_hw_wait();
+                }
+
+                report_result("aes_hw_ctr_enc_dma", HYBRID_LENGTH, &stats, result, cipher_data, NULL);
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_sw_ctr_context_encrypt(&ctr_context, init_vector, plain_data, HYBRID_LENGTH, cipher_data);
+                }
+
+                report_result("aes_sw_ctr_context_enc", HYBRID_LENGTH, &stats, result, cipher_data, NULL);
+
+                result = aes_hybrid_init(&hybrid, key, key_size);
+                for (int i = 0; i < HYBRID_TUNE_RUNS; i++) {
+                    result = result && aes_hybrid_ctr_encrypt(&hybrid, init_vector, plain_data, HYBRID_LENGTH, cipher_data);
+                }
+
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = result && aes_hybrid_ctr_encrypt(&hybrid, init_vector, plain_data, HYBRID_LENGTH, cipher_data);
+                }
+
+                report_result("aes_hybrid_ctr_enc", HYBRID_LENGTH, &stats, result, cipher_data, NULL);
+                aes_hybrid_cleanup(&hybrid);
+            }
+
+            // engine chosen at every call from the fits measured at this key
+            // size, then the number of times each engine was chosen
+            aes_select_set_key_size(key_size);
+            if (!aes_select_calibrate(key, plain_data, BUFFER_LENGTH, cipher_data)) {
+                Error_Handler();
+            }
+            for (int m = 0; m < AES_SELECT_MODE_NUMBER; m++) {
+                for (int e = hw ? 0 : AES_SELECT_SW_FAST; e < AES_SELECT_ENGINE_NUMBER; e++) {
+                    const aes_select_cost_t* cost = &aes_select_get_table()->costs[m][e];
+                    report_fit(select_names[m][e], cost->slope_thousandths, cost->intercept);
+                }
+            }
+
+            aes_select_reset_counters();
+            for (int i = 0; i < CONTEXT_LENGTH_NUMBER; i++) {
+                uint32_t length = context_lengths[i];
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_select_ctr_encrypt(key, init_vector, plain_data, length, cipher_data);
+                }
+
+                report_result("aes_select_ctr_enc", length, &stats, result, cipher_data, NULL);
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_select_gcm_encrypt(key, init_vector, plain_data, length, cipher_data, mic);
+                }
+
+                report_result("aes_select_gcm_enc", length, &stats, result, cipher_data, mic);
+            }
+            for (int m = 0; m < AES_SELECT_MODE_NUMBER; m++) {
+                for (int e = 0; e < AES_SELECT_ENGINE_NUMBER; e++) {
+                    report_counter(select_names[m][e], aes_select_get_counter(m, e));
+                }
+            }
+            aes_select_cleanup();
+
+            // a message per call, then the whole burst at once (the key is
+            // expanded or loaded once, the DMA batch chains the messages from
+            // the interrupt), the rate is sent in messages/s
+            for (int i = 0; i < BATCH_SIZE_NUMBER; i++) {
+                uint32_t size = batch_sizes[i];
+
+                for (int j = 0; j < BATCH_MESSAGES; j++) {
+                    batch[j].length = size;
+                }
+
+                if (hw) {
+                    bench_begin(&stats);
+                    while (bench_next(&stats)) {
+                        result = true;
+                        for (int j = 0; j < BATCH_MESSAGES; j++) {
+                            result = aes_hw_gcm_aad_encrypt(key, batch_nonces[j], auth_header, AUTH_HEADER_SIZE,
+                                    plain_data, size, cipher_data, batch_tags[j]) && result;
+                        }
+                    }
+
+                    batch_report("aes_hw_gcm_enc_loop", size, &stats, result);
+
+                    result = false;
+                    bench_begin(&stats);
+                    while (bench_next(&stats)) {
+                        result = aes_hw_gcm_encrypt_batch(key, batch, BATCH_MESSAGES);
+                    }
+
+                    batch_report("aes_hw_gcm_enc_batch", size, &stats, result);
+
+                    result = false;
+                    bench_begin(&stats);
+                    while (bench_next(&stats)) {
+                        result = aes_hw_gcm_encrypt_batch_dma(key, batch, BATCH_MESSAGES);
+                        result = result && aes_hw_wait();
+                    }
+
+                    batch_report("aes_hw_gcm_enc_batch_dma", size, &stats, result);
+                }
+
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = true;
+                    for (int j = 0; j < BATCH_MESSAGES; j++) {
+                        result = aes_sw_gcm_encrypt(key, batch_nonces[j], plain_data, size, cipher_data, NULL) && result;
+                    }
+                }
+
+                batch_report("aes_sw_gcm_enc_loop", size, &stats, result);
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    result = aes_sw_gcm_context_encrypt_batch(&gcm_enc_context, batch, BATCH_MESSAGES);
+                }
+
+                batch_report("aes_sw_gcm_context_enc_batch", size, &stats, result);
+            }
+
+            aes_sw_ctr_context_cleanup(&ctr_context);
+            aes_sw_gcm_context_cleanup(&gcm_enc_context);
+            aes_sw_gcm_context_cleanup(&gcm_dec_context);
+
+
+
+            for (int i = 0; i < CIPHER_NUMBER; i++) {
+                cmox_cipher_retval_t retval;
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    retval = cmox_cipher_encrypt(cipher_encs[i],
+                            plain_data, LENGTH,
+                            key, key_size,
+                            init_vector, CIPHER_IV_SIZE,
+                            cipher_data, NULL);
+                    result = retval == CMOX_CIPHER_SUCCESS;
+                }
+
+                sprintf(name, "%s_enc", cipher_names[i]);
+                report_result(name, LENGTH, &stats, result, cipher_data, NULL);
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    retval = cmox_cipher_decrypt(cipher_decs[i],
+                            cipher_data, LENGTH,
+                            key, key_size,
+                            init_vector, CIPHER_IV_SIZE,
+                            plain_data, NULL);
+                    result = retval == CMOX_CIPHER_SUCCESS;
+                }
+
+                sprintf(name, "%s_dec", cipher_names[i]);
+                report_result(name, LENGTH, &stats, result, plain_data, NULL);
+            }
+
+            for (int i = 0; i < AEAD_NUMBER; i++) {
+                cmox_cipher_retval_t retval;
+
+                // the ChaCha20 key is always 256 bits
+                if (aead_encs[i] == CMOX_CHACHAPOLY_ENC_ALGO && key_size != 32) {
+                    continue;
+                }
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    retval = cmox_aead_encrypt(aead_encs[i],
+                            plain_data, LENGTH,
+                            MIC_SIZE,
+                            key, key_size,
+                            init_vector, AEAD_IV_SIZE,
+                            auth_header, AUTH_HEADER_SIZE,
+                            cipher_data, NULL);
+                    result = retval == CMOX_CIPHER_SUCCESS;
+                }
+
+                sprintf(name, "%s_enc", aead_names[i]);
+                report_result(name, LENGTH, &stats, result, cipher_data, mic);
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    retval = cmox_aead_decrypt(aead_decs[i],
+                            cipher_data, LENGTH + MIC_SIZE,
+                            MIC_SIZE,
+                            key, key_size,
+                            init_vector, AEAD_IV_SIZE,
+                            auth_header, AUTH_HEADER_SIZE,
+                            plain_data, NULL);
+                    result = retval == CMOX_CIPHER_AUTH_SUCCESS;
+                }
+
+                sprintf(name, "%s_dec", aead_names[i]);
+                report_result(name, LENGTH, &stats, result, plain_data, mic);
+            }
+
+            // the ChaCha20 key is always 256 bits
+            if (key_size == CHACHAPOLY_KEY_SIZE) {
+                chachapoly_bench();
+            }
+
+            for (int i = 0; i < MAC_NUMBER; i++) {
+                cmox_mac_retval_t retval;
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    retval = cmox_mac_compute(macs[i].algo,
+                            plain_data, LENGTH,
+                            key, key_size,
+                            NULL, 0,
+                            mic, MIC_SIZE, NULL);
+                    result = retval == CMOX_MAC_SUCCESS;
+                }
+
+                sprintf(name, "%s_gen", macs[i].name);
+                report_result(name, LENGTH, &stats, result, NULL, mic);
+
+                result = false;
+                bench_begin(&stats);
+                while (bench_next(&stats)) {
+                    retval = cmox_mac_verify(macs[i].algo,
+                            plain_data, LENGTH,
+                            key, key_size,
+                            NULL, 0,
+                            mic, MIC_SIZE);
+                    result = retval == CMOX_MAC_AUTH_SUCCESS;
+                }
+
+                sprintf(name, "%s_ver", macs[i].name);
+                report_result(name, LENGTH, &stats, result, NULL, mic);
+            }
+
+#ifdef SWEEP
+            bench_set_runs(SWEEP_RUNS);
+
+            for (int i = 0; hw && i < SWEEP_HW_NUMBER; i++) {
+                sweep(sweep_hw_names[i], sweep_hw_functions[i], NULL);
+            }
+
+            for (int i = 0; i < CIPHER_NUMBER; i++) {
+                sweep(cipher_names[i], sweep_cipher_encrypt, cipher_encs[i]);
+            }
+
+            for (int i = 0; i < AEAD_NUMBER; i++) {
+                if (aead_encs[i] != CMOX_CHACHAPOLY_ENC_ALGO || key_size == 32) {
+                    sweep(aead_names[i], sweep_aead_encrypt, aead_encs[i]);
+                }
+            }
+
+            for (int i = 0; i < MAC_NUMBER; i++) {
+                digest_sweep(macs[i].name, sweep_mac_compute, sweep_mac_stream, &macs[i], macs[i].size);
+            }
+
+            bench_set_runs(BENCH_RUNS);
+#endif
+        }
+
+#ifdef SWEEP
+        // the hashes and the MACs of the hashes, on a single key size
+        bench_set_runs(SWEEP_RUNS);
+
+        report_set_key_size(0);
+        for (int i = 0; i < HASH_NUMBER; i++) {
+            digest_sweep(hashes[i].name, sweep_hash_compute, sweep_hash_stream, &hashes[i], hashes[i].size);
+        }
+
+        key_size = HMAC_KEY_SIZE;
+        report_set_key_size(key_size);
+        for (int i = 0; i < HMAC_NUMBER; i++) {
+            digest_sweep(hmacs[i].name, sweep_mac_compute, sweep_mac_stream, &hmacs[i], hmacs[i].size);
+        }
+
+        bench_set_runs(BENCH_RUNS);
+#endif
 
-            sprintf(text, "%s_dec: t = %lu, result = %i\n", aead_names[i], t, result);
-            send_result(text, plain_data, mic);
+        // the random bytes: a nonce from the DRBG and from the pool, whose
+        // refill is a block of the DRBG, done out of the measurement
+        if (rng_ready) {
+            rng_pool_stats_t rng_stats;
+
+            report_set_key_size(RNG_POOL_KEY_SIZE);
+            rng_pool_reset_stats();
+            result = false;
+            bench_begin(&stats);
+            while (bench_next(&stats)) {
+                result = rng_pool_generate(nonce, AEAD_IV_SIZE);
+            }
+            report_result("drbg_generate_nonce", AEAD_IV_SIZE, &stats, result, NULL, NULL);
+
+            result = false;
+            bench_begin(&stats);
+            while (bench_next(&stats)) {
+                result = rng_pool_generate(cipher_data, RNG_POOL_BLOCK_SIZE);
+            }
+            report_result("drbg_generate_block", RNG_POOL_BLOCK_SIZE, &stats, result, NULL, NULL);
+
+            while (rng_pool_process()) {
+            }
+            result = false;
+            bench_begin(&stats);
+            while (bench_next(&stats)) {
+                result = rng_pool_get(nonce, AEAD_IV_SIZE);
+            }
+            report_result("rng_pool_nonce", AEAD_IV_SIZE, &stats, result, NULL, NULL);
+
+            while (rng_pool_process()) {
+            }
+            rng_pool_get_stats(&rng_stats);
+            report_counter("rng_pool_refills", rng_stats.refills);
+            report_counter("rng_pool_reseeds", rng_stats.reseeds);
+            report_counter("rng_pool_fallbacks", rng_stats.fallbacks);
+            report_counter("rng_pool_errors", rng_stats.errors);
         }
+
+        // the public key algorithms, much slower, with few runs
+        bench_set_runs(PK_RUNS);
+        pk_bench_run();
+
+        // the sector streams of the storage encryption and the key wrap
+        bench_set_runs(STORAGE_RUNS);
+        storage_bench_run();
+        bench_set_runs(BENCH_RUNS);
     }
+
+    logger_flush();
+    return 0;
 }
 
 /**
@@ -330,41 +1502,363 @@ void SystemClock_Config(void)
     }
 }
 
-static char hex_to_str(uint8_t hex)
+static void async_callback(bool result, void* context)
 {
-	if (hex < 10) {
-		return '0' + hex;
-	} else {
-		return 'A' + hex - 10;
-	}
+    (void)context;
+
+    async_result = async_result && result;
+    async_done++;
 }
 
-static void send_hex_data(const uint8_t* data, size_t length)
+static void urgent_callback(bool result, void* context)
 {
-	uint8_t hex[2 * (LENGTH + MIC_SIZE)];
-	for (int i = 0; i < length; i++) {
-		hex[2*i] = hex_to_str((data[i] & 0xF0) >> 4);
-		hex[2*i + 1] = hex_to_str(data[i] & 0x0F);
-	}
-	HAL_UART_Transmit(&hlpuart1, hex, 2*length, HAL_MAX_DELAY);
+    urgent_time = DWT->CYCCNT;
+    async_callback(result, context);
 }
 
-static void send_text(const char* text)
+/**
+ * Encrypt large_data in pieces of the RAM buffer
+ * @param gcm true for GCM with the authentication header, false for CTR
+ */
+static bool large_encrypt(bool gcm)
 {
-    HAL_UART_Transmit(&hlpuart1, (const uint8_t*)text, strlen(text), HAL_MAX_DELAY);
+    aes_hw_stream_t stream;
+    bool result;
+
+    if (gcm) {
+        result = aes_hw_stream_gcm_begin(&stream, false, key, init_vector, auth_header, AUTH_HEADER_SIZE);
+    } else {
+        result = aes_hw_stream_ctr_begin(&stream, key, init_vector);
+    }
+    for (uint32_t i = 0; result && i < LARGE_LENGTH; i += BUFFER_LENGTH) {
+        result = aes_hw_stream_update(&stream, &large_data[i], BUFFER_LENGTH, cipher_data);
+    }
+    return aes_hw_stream_end(&stream, mic) && result;
 }
 
-static void send_result(const char* text, const uint8_t* data, const uint8_t* mic)
+/**
+ * Linearize the fragmented frame in the staging buffer
+ */
+static void frame_copy(void)
 {
-    send_text(text);
-#ifdef SEND_DATA
-    send_hex_data(data, LENGTH);
-    if (mic != NULL) {
-        send_text("\nMIC = ");
-        send_hex_data(mic, 16);
+    uint32_t offset = 0;
+
+    for (int i = 0; i < FRAME_FRAGMENTS; i++) {
+        memcpy(&frame_staging[offset], frame[i].input, frame[i].length);
+        offset += frame[i].length;
     }
-    send_text("\n\n");
-#endif
+}
+
+/**
+ * Encrypt a frame using AES in GCM Mode with the authentication header
+ */
+static bool frame_hw_encrypt(const fragment_t* fragments, uint32_t number)
+{
+    aes_hw_stream_t stream;
+
+    return aes_hw_stream_gcm_begin(&stream, false, key, init_vector, auth_header, AUTH_HEADER_SIZE)
+            && aes_hw_stream_update_fragments(&stream, fragments, number)
+            && aes_hw_stream_end(&stream, mic);
+}
+
+/**
+ * Send the result of a batch of BATCH_MESSAGES messages, then its rate in
+ * messages per second (0 if the time is not measured)
+ * @param size the length of a message in byte
+ */
+static void batch_report(const char* name, uint32_t size, const bench_stats_t* stats, bool result)
+{
+    uint32_t rate = 0;
+
+    report_result(name, size * BATCH_MESSAGES, stats, result, NULL, NULL);
+    if (stats->median != 0) {
+        rate = ((uint64_t)SystemCoreClock * BATCH_MESSAGES) / stats->median;
+    }
+    report_counter(name, rate);
+}
+
+/**
+ * ChaCha20-Poly1305 through a context keyed once: the message in a single
+ * chunk, then in the chunks of a small MTU. The decryption of the chunks
+ * verifies the tag of the encryption and gives back the bytes 0, 1, 2...
+ */
+static void chachapoly_bench(void)
+{
+    bench_stats_t stats;
+    bool result = chachapoly_context_init(&chachapoly_enc_context, key, false)
+            && chachapoly_context_init(&chachapoly_dec_context, key, true);
+
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = result && chachapoly_stream(&chachapoly_enc_context, false, plain_data, cipher_data, CHACHAPOLY_LENGTH);
+    }
+    report_result("chachapoly_context_enc", CHACHAPOLY_LENGTH, &stats, result, cipher_data, mic);
+
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = result && chachapoly_stream(&chachapoly_enc_context, false, plain_data, cipher_data, CHACHAPOLY_ODD_MTU);
+    }
+    report_result("chachapoly_mtu60_enc", CHACHAPOLY_LENGTH, &stats, result, cipher_data, mic);
+
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = result && chachapoly_stream(&chachapoly_enc_context, false, plain_data, cipher_data, CHACHAPOLY_MTU);
+    }
+    report_result("chachapoly_mtu64_enc", CHACHAPOLY_LENGTH, &stats, result, cipher_data, mic);
+
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = result && chachapoly_stream(&chachapoly_dec_context, true, cipher_data, plain_data, CHACHAPOLY_MTU);
+    }
+    for (uint32_t i = 0; i < CHACHAPOLY_LENGTH; i++) {
+        result = result && plain_data[i] == (uint8_t)i;
+    }
+    report_result("chachapoly_mtu64_dec", CHACHAPOLY_LENGTH, &stats, result, plain_data, mic);
+
+    chachapoly_context_cleanup(&chachapoly_enc_context);
+    chachapoly_context_cleanup(&chachapoly_dec_context);
+}
+
+/**
+ * A message of CHACHAPOLY_LENGTH bytes appended by chunks, the tag is mic
+ * @param chunk_size the length of the chunks, the last one can be shorter
+ */
+static bool chachapoly_stream(chachapoly_context_t* context, bool decrypt, const uint8_t* input, uint8_t* output,
+        uint32_t chunk_size)
+{
+    bool result = chachapoly_context_start(context, init_vector)
+            && chachapoly_context_append_aad(context, auth_header, AUTH_HEADER_SIZE);
+
+    for (uint32_t offset = 0; offset < CHACHAPOLY_LENGTH && result; offset += chunk_size) {
+        uint32_t chunk = CHACHAPOLY_LENGTH - offset < chunk_size ? CHACHAPOLY_LENGTH - offset : chunk_size;
+        result = chachapoly_context_append(context, &input[offset], chunk, &output[offset]);
+    }
+    if (decrypt) {
+        return result && chachapoly_context_verify_tag(context, mic);
+    }
+    return result && chachapoly_context_generate_tag(context, mic);
+}
+
+/**
+ * Time an algorithm for every length of sweep_lengths and fit
+ * t = slope * length + intercept on the median of the successful points, the
+ * intercept being the fixed overhead of a call
+ */
+static void sweep(const char* name, sweep_function_t function, const void* algo)
+{
+    bench_stats_t stats;
+    double n = 0;
+    double sum_x = 0;
+    double sum_y = 0;
+    double sum_xy = 0;
+    double sum_xx = 0;
+
+    for (int i = 0; i < SWEEP_LENGTH_NUMBER; i++) {
+        uint32_t length = sweep_lengths[i];
+
+        bool result = false;
+        bench_begin(&stats);
+        while (bench_next(&stats)) {
+            result = function(algo, length);
+        }
+        uint32_t t = stats.median;
+
+        report_result(name, length, &stats, result, NULL, NULL);
+
+        if (result) {
+            n++;
+            sum_x += length;
+            sum_y += t;
+            sum_xy += (double)length * t;
+            sum_xx += (double)length * length;
+        }
+    }
+
+    if (n < 2) {
+        return;
+    }
+
+    double slope = (n * sum_xy - sum_x * sum_y) / (n * sum_xx - sum_x * sum_x);
+    double intercept = (sum_y - slope * sum_x) / n;
+    uint32_t slope_thousandths = slope * 1000 + 0.5;
+
+    report_fit(name, slope_thousandths, (int32_t)intercept);
+}
+
+/**
+ * Sweep a hash or a MAC one-shot then through its handle, the two digests of
+ * LENGTH bytes are compared first
+ */
+static void digest_sweep(const char* name, sweep_function_t compute, sweep_function_t stream, const void* algo,
+        size_t size)
+{
+    char stream_name[32];
+
+    if (!compute(algo, LENGTH) || !stream(algo, LENGTH) || memcmp(digest, stream_digest, size) != 0) {
+        Error_Handler();
+    }
+
+    sweep(name, compute, algo);
+    sprintf(stream_name, "%s_stream", name);
+    sweep(stream_name, stream, algo);
+}
+
+static bool sweep_cipher_encrypt(const void* algo, uint32_t length)
+{
+    return cmox_cipher_encrypt((cmox_cipher_algo_t)algo,
+            plain_data, length,
+            key, key_size,
+            init_vector, CIPHER_IV_SIZE,
+            cipher_data, NULL) == CMOX_CIPHER_SUCCESS;
+}
+
+static bool sweep_aead_encrypt(const void* algo, uint32_t length)
+{
+    return cmox_aead_encrypt((cmox_aead_algo_t)algo,
+            plain_data, length,
+            MIC_SIZE,
+            key, key_size,
+            init_vector, AEAD_IV_SIZE,
+            auth_header, AUTH_HEADER_SIZE,
+            cipher_data, NULL) == CMOX_CIPHER_SUCCESS;
+}
+
+static bool sweep_mac_compute(const void* algo, uint32_t length)
+{
+    const mac_bench_t* mac = algo;
+
+    return cmox_mac_compute(mac->algo,
+            plain_data, length,
+            key, key_size,
+            NULL, 0,
+            digest, mac->size, NULL) == CMOX_MAC_SUCCESS;
+}
+
+/**
+ * init/append/generateTag, the data appended by DIGEST_CHUNK_SIZE bytes
+ */
+static bool sweep_mac_stream(const void* algo, uint32_t length)
+{
+    const mac_bench_t* mac = algo;
+
+    cmox_mac_handle_t* handle = mac->construct(&digest_handle, mac->impl);
+    bool result = cmox_mac_init(handle) == CMOX_MAC_SUCCESS;
+    result &= cmox_mac_setTagLen(handle, mac->size) == CMOX_MAC_SUCCESS;
+    result &= cmox_mac_setKey(handle, key, key_size) == CMOX_MAC_SUCCESS;
+    for (uint32_t offset = 0; offset < length; offset += DIGEST_CHUNK_SIZE) {
+        uint32_t chunk = length - offset < DIGEST_CHUNK_SIZE ? length - offset : DIGEST_CHUNK_SIZE;
+        result &= cmox_mac_append(handle, &plain_data[offset], chunk) == CMOX_MAC_SUCCESS;
+    }
+    result &= cmox_mac_generateTag(handle, stream_digest, NULL) == CMOX_MAC_SUCCESS;
+    cmox_mac_cleanup(handle);
+    return result;
+}
+
+static bool sweep_hash_compute(const void* algo, uint32_t length)
+{
+    const hash_bench_t* hash = algo;
+
+    return cmox_hash_compute(hash->algo,
+            plain_data, length,
+            digest, hash->size, NULL) == CMOX_HASH_SUCCESS;
+}
+
+/**
+ * init/append/generateTag, the data appended by DIGEST_CHUNK_SIZE bytes
+ */
+static bool sweep_hash_stream(const void* algo, uint32_t length)
+{
+    const hash_bench_t* hash = algo;
+
+    cmox_hash_handle_t* handle = hash->construct(&digest_handle);
+    bool result = cmox_hash_init(handle) == CMOX_HASH_SUCCESS;
+    result &= cmox_hash_setTagLen(handle, hash->size) == CMOX_HASH_SUCCESS;
+    for (uint32_t offset = 0; offset < length; offset += DIGEST_CHUNK_SIZE) {
+        uint32_t chunk = length - offset < DIGEST_CHUNK_SIZE ? length - offset : DIGEST_CHUNK_SIZE;
+        result &= cmox_hash_append(handle, &plain_data[offset], chunk) == CMOX_HASH_SUCCESS;
+    }
+    result &= cmox_hash_generateTag(handle, stream_digest, NULL) == CMOX_HASH_SUCCESS;
+    cmox_hash_cleanup(handle);
+    return result;
+}
+
+static bool sweep_hw_ctr_encrypt(const void* algo, uint32_t length)
+{
+    (void)algo;
+
+    return aes_hw_ctr_encrypt(key, init_vector, plain_data, length, cipher_data);
+}
+
+static bool sweep_hw_gcm_encrypt(const void* algo, uint32_t length)
+{
+    (void)algo;
+
+    return aes_hw_gcm_encrypt(key, init_vector, plain_data, length, cipher_data, mic);
+}
+
+static bool sweep_hw_gcm_decrypt(const void* algo, uint32_t length)
+{
+    (void)algo;
+
+    return aes_hw_gcm_decrypt(key, init_vector, cipher_data, length, plain_data, mic);
+}
+
+static bool sweep_hw_ctr_encrypt_dma(const void* algo, uint32_t length)
+{
+    (void)algo;
+
+    // the DMA only moves complete blocks
+    if (length % AES_SIZE != 0) {
+        return false;
+    }
+    return aes_hw_ctr_encrypt_dma(key, init_vector, plain_data, length, cipher_data) && aes_hw_wait();
+}
+
+static bool sweep_hw_gcm_encrypt_dma(const void* algo, uint32_t length)
+{
+    (void)algo;
+
+    if (length % AES_SIZE != 0) {
+        return false;
+    }
+    return aes_hw_gcm_encrypt_dma(key, init_vector, plain_data, length, cipher_data, mic) && aes_hw_wait();
+}
+
+static bool sweep_hw_gcm_aad_encrypt(const void* algo, uint32_t length)
+{
+    (void)algo;
+
+    return aes_hw_gcm_aad_encrypt(key, init_vector, auth_header, AUTH_HEADER_SIZE, plain_data, length, cipher_data, mic);
+}
+
+static bool sweep_hw_ccm_encrypt(const void* algo, uint32_t length)
+{
+    (void)algo;
+
+    return aes_hw_ccm_encrypt(key, init_vector, AEAD_IV_SIZE, auth_header, AUTH_HEADER_SIZE,
+            plain_data, length, cipher_data, mic, MIC_SIZE);
+}
+
+static bool sweep_hw_cmac_generate(const void* algo, uint32_t length)
+{
+    (void)algo;
+
+    return aes_hw_cmac_generate(key, plain_data, length, mic);
+}
+
+static bool sweep_hw_cbc_encrypt(const void* algo, uint32_t length)
+{
+    (void)algo;
+
+    // as the CMOX ECB/CBC, only complete blocks
+    return aes_hw_cbc_encrypt(key, init_vector, plain_data, length, cipher_data);
+}
+
+static bool sweep_hw_cbc_decrypt(const void* algo, uint32_t length)
+{
+    (void)algo;
+
+    return aes_hw_cbc_decrypt(key, init_vector, cipher_data, length, plain_data);
 }
 
 
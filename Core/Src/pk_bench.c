@@ -0,0 +1,489 @@
+/**
+ ******************************************************************************
+ * @file    pk_bench.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   benchmark of the public key algorithms of CMOX
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "cmox_crypto.h"
+#include "pk_bench.h"
+#include "report.h"
+
+/* Private define ------------------------------------------------------------*/
+
+// the peak of RSA-2048 with the HIGHMEM exponentiation fits
+#define PK_BUFFER_SIZE 12288
+#define NAME_SIZE 32
+#define DIGEST_SIZE 32 // SHA-256
+#define MESSAGE_SIZE 64
+#define SALT_SIZE 32
+#define ECC_MAX_SIZE 48 // P-384
+#define RSA_SIZE 256 // 2048 bits
+
+#define ECC_IMPL_NUMBER 2
+#define MATH_NUMBER 3
+#define MODEXP_NUMBER 3
+// SUPERFAST256 is the last math functions, only for the curves up to 256 bits
+#define MATH_NUMBER_384 (MATH_NUMBER - 1)
+#define MATH_NUMBER_RSA (MATH_NUMBER - 1)
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct {
+    const char* name;
+    cmox_math_funcs_t math;
+} math_bench_t;
+
+typedef struct {
+    const char* name;
+    cmox_ecc_impl_t impl;
+} ecc_bench_t;
+
+typedef struct {
+    const char* name;
+    cmox_modexp_func_t modexp;
+} modexp_bench_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+// the working buffer of CMOX, in SRAM2 as SRAM1 is taken by the buffers of main
+static uint8_t pk_buffer[PK_BUFFER_SIZE] __attribute__((section(".ram2")));
+
+// the private keys and the nonce, lower than the order of both curves
+static const uint8_t ecc_random[] = {
+    0x1d, 0x47, 0x7c, 0x0c, 0xe4, 0x5e, 0x3d, 0xb0, 0x28, 0x76, 0x89, 0x19, 0xa3, 0x5b, 0xdc, 0x18,
+    0x0a, 0x87, 0x9f, 0xd7, 0x61, 0x5c, 0x39, 0x1f, 0xa7, 0xab, 0x84, 0x5e, 0xc9, 0x9f, 0x48, 0x8f,
+    0x8a, 0x5e, 0xdd, 0x19, 0xaf, 0x10, 0xd6, 0x80, 0x91, 0xd1, 0xcb, 0x5e, 0x9d, 0xbf, 0xcb, 0x0c,
+};
+static const uint8_t ecc_peer_random[] = {
+    0x2b, 0x98, 0xdd, 0xda, 0x2d, 0x2e, 0xe3, 0xb6, 0x32, 0xdd, 0xce, 0x1d, 0x64, 0x7a, 0xcd, 0x03,
+    0x31, 0xea, 0x63, 0x57, 0x0f, 0xc0, 0xb2, 0x5b, 0xa8, 0xb6, 0x61, 0xe3, 0x12, 0x20, 0x44, 0x67,
+    0x33, 0x1a, 0x63, 0xd2, 0x3e, 0x4b, 0xeb, 0x16, 0x3d, 0xff, 0x45, 0x91, 0xf2, 0xf3, 0x21, 0xb5,
+};
+static const uint8_t ecc_nonce[] = {
+    0x37, 0x38, 0x84, 0x3d, 0x09, 0x5f, 0xb3, 0x20, 0xae, 0x31, 0x57, 0xde, 0x89, 0x5a, 0x15, 0x27,
+    0x61, 0xb4, 0x3c, 0x6e, 0x82, 0xf9, 0x22, 0x5c, 0x0b, 0x8d, 0x31, 0xf0, 0x6a, 0xce, 0xb0, 0x3c,
+    0x5c, 0x13, 0x79, 0xc1, 0x10, 0x69, 0x68, 0xfa, 0xc3, 0x19, 0xd6, 0xed, 0x81, 0x7f, 0x76, 0x39,
+};
+// SHA-256 of the message
+static const uint8_t digest[] = {
+    0xfd, 0xea, 0xb9, 0xac, 0xf3, 0x71, 0x03, 0x62, 0xbd, 0x26, 0x58, 0xcd, 0xc9, 0xa2, 0x9e, 0x8f,
+    0x9c, 0x75, 0x7f, 0xcf, 0x98, 0x11, 0x60, 0x3a, 0x8c, 0x44, 0x7c, 0xd1, 0xd9, 0x15, 0x11, 0x08,
+};
+// the bytes 0, 1, 2...
+static uint8_t message[MESSAGE_SIZE];
+
+// RSA-2048, e = 65537, the private key in the CRT form
+static const uint8_t rsa_e[] = {0x01, 0x00, 0x01};
+static const uint8_t rsa_n[] = {
+    0xa1, 0x5c, 0xff, 0x8e, 0x25, 0x74, 0x2c, 0x54, 0xc7, 0x57, 0x80, 0x59, 0x87, 0xa1, 0x2d, 0x9c,
+    0xb1, 0x1e, 0x23, 0x57, 0x40, 0x9a, 0xeb, 0x48, 0x03, 0xc0, 0x1a, 0x7e, 0x1b, 0x78, 0xf8, 0x4b,
+    0xdd, 0x73, 0x31, 0x1a, 0x5b, 0x43, 0x25, 0x46, 0x46, 0xb3, 0x48, 0xde, 0x6d, 0x50, 0x7d, 0xe1,
+    0xb6, 0xff, 0x79, 0x99, 0x0a, 0xc5, 0x95, 0x3d, 0x46, 0xdf, 0x29, 0x16, 0x68, 0x6e, 0x3f, 0xaf,
+    0x5e, 0xb9, 0xaf, 0x67, 0x4e, 0x74, 0x15, 0xad, 0xf4, 0x7e, 0xa2, 0x18, 0xd1, 0xe8, 0x66, 0x89,
+    0x8f, 0x9c, 0x4e, 0xa3, 0xba, 0xd1, 0xa4, 0x50, 0xc2, 0xcd, 0x1b, 0x73, 0x41, 0xc6, 0x35, 0xdf,
+    0x61, 0xf2, 0xe9, 0x69, 0x78, 0xcd, 0xcf, 0xb8, 0x24, 0xa7, 0xa7, 0x9d, 0xa8, 0xd6, 0xac, 0xfb,
+    0xef, 0x7a, 0x74, 0xca, 0xc8, 0x82, 0x6f, 0x02, 0xc4, 0x13, 0x82, 0x3b, 0x15, 0x01, 0x94, 0x25,
+    0xc5, 0xc2, 0xdb, 0x85, 0x2e, 0x9d, 0x42, 0xea, 0xd3, 0xf5, 0x66, 0x19, 0x95, 0xb3, 0x65, 0xa9,
+    0x89, 0x4b, 0xb2, 0x6d, 0x2e, 0xda, 0x20, 0x3f, 0x4a, 0xab, 0x30, 0x35, 0x1a, 0x8e, 0xc2, 0xb7,
+    0x03, 0x11, 0x2e, 0x11, 0x70, 0xc4, 0xc2, 0x37, 0xcd, 0x51, 0x8f, 0x72, 0x80, 0xe9, 0x6c, 0xb7,
+    0x44, 0x55, 0xf1, 0xb1, 0x63, 0x89, 0xcd, 0x77, 0xe8, 0x49, 0x61, 0xb0, 0x0a, 0x2d, 0xbc, 0x10,
+    0x20, 0xe6, 0x3d, 0x6d, 0x02, 0xe7, 0xd1, 0xf2, 0x83, 0xe7, 0x40, 0xff, 0x87, 0x2b, 0x0b, 0x1d,
+    0xf6, 0xf8, 0xb8, 0xaf, 0x60, 0x4d, 0xed, 0xf7, 0x7e, 0x50, 0x80, 0xab, 0xc5, 0xdd, 0x59, 0x6b,
+    0x56, 0x3a, 0xb7, 0xd8, 0xb7, 0x29, 0xc1, 0x4a, 0xa0, 0xe3, 0x73, 0xb2, 0x53, 0x18, 0x16, 0x01,
+    0xf4, 0x8d, 0xa1, 0x89, 0xa8, 0xc6, 0x1b, 0x06, 0x79, 0x38, 0x7e, 0x4d, 0x88, 0x50, 0x24, 0x89,
+};
+static const uint8_t rsa_p[] = {
+    0xcb, 0x71, 0xd2, 0x58, 0x6b, 0x37, 0xd1, 0x35, 0xdf, 0x94, 0x28, 0xb3, 0xe1, 0x31, 0xab, 0x86,
+    0x2d, 0xc0, 0x08, 0x10, 0x8f, 0xa3, 0xb1, 0x52, 0x51, 0x55, 0x9e, 0x3c, 0x24, 0xd4, 0xd8, 0x3f,
+    0x99, 0x50, 0x65, 0x06, 0xdb, 0x03, 0xba, 0x65, 0x21, 0x43, 0xc6, 0x37, 0xf2, 0xbc, 0xb1, 0x05,
+    0x92, 0x1b, 0xa0, 0x20, 0x51, 0x38, 0x51, 0xca, 0xef, 0x3f, 0x32, 0x1d, 0xf1, 0xe5, 0xe4, 0x30,
+    0x11, 0x93, 0xd1, 0x75, 0x7b, 0x69, 0xa1, 0x8f, 0x20, 0x15, 0xbe, 0x3c, 0x86, 0x93, 0x12, 0x31,
+    0xbb, 0x67, 0x74, 0x88, 0x75, 0x03, 0x03, 0x94, 0x93, 0xfb, 0x43, 0xd8, 0xce, 0x7d, 0xe4, 0xd3,
+    0x48, 0xb4, 0xdd, 0x07, 0xa0, 0x88, 0x51, 0x07, 0x9b, 0x9b, 0xf7, 0x9a, 0xec, 0xf2, 0xf5, 0xf6,
+    0x07, 0x64, 0x2f, 0x84, 0x4f, 0xe8, 0x90, 0xbc, 0x4c, 0x86, 0x4f, 0x84, 0xc2, 0xc9, 0x63, 0xdd,
+};
+static const uint8_t rsa_q[] = {
+    0xcb, 0x0c, 0x41, 0xf6, 0xf9, 0xc8, 0xd3, 0x8a, 0x4b, 0x18, 0x19, 0x5f, 0xcc, 0x4d, 0xa0, 0xf7,
+    0x10, 0xb2, 0xc2, 0x50, 0x86, 0x93, 0xa1, 0x34, 0x35, 0x64, 0x5a, 0xe5, 0xc1, 0xa3, 0xd0, 0x94,
+    0xcc, 0x84, 0x04, 0x8e, 0x8a, 0x12, 0x33, 0xd1, 0xc4, 0xe2, 0x7f, 0x95, 0xbb, 0x55, 0xf4, 0xf5,
+    0x29, 0x08, 0x1e, 0x55, 0x6a, 0x03, 0x31, 0x6d, 0x05, 0x62, 0xf5, 0x5e, 0xf6, 0xa7, 0x5a, 0x29,
+    0xe8, 0x29, 0x52, 0xfe, 0x95, 0xb9, 0xdd, 0x89, 0xf0, 0x93, 0x20, 0x84, 0x14, 0xf2, 0x15, 0x86,
+    0x42, 0xb8, 0x45, 0x98, 0xf1, 0x76, 0x07, 0xd7, 0x16, 0x7b, 0xb5, 0x8f, 0xeb, 0x34, 0x3f, 0xc1,
+    0x50, 0x1e, 0x0d, 0x63, 0xb4, 0x44, 0x21, 0x0e, 0x80, 0x7c, 0x69, 0x4c, 0x78, 0xe0, 0x4d, 0xb7,
+    0xda, 0xd3, 0x50, 0xf9, 0x16, 0x0b, 0x8f, 0x12, 0x71, 0xfb, 0x7b, 0xf8, 0x90, 0xe2, 0x1e, 0x9d,
+};
+static const uint8_t rsa_dp[] = {
+    0x9f, 0x4e, 0xde, 0xee, 0xfb, 0xee, 0x76, 0x75, 0xe0, 0x40, 0xcd, 0x6a, 0xa6, 0x21, 0xd5, 0xf5,
+    0xb9, 0x27, 0x91, 0x69, 0x1e, 0x81, 0x89, 0x1e, 0x33, 0xb0, 0x7e, 0xbb, 0x0c, 0x00, 0x5b, 0xe1,
+    0xd9, 0x75, 0x39, 0xd7, 0x17, 0x73, 0xa0, 0xe7, 0x06, 0x18, 0x63, 0x44, 0x76, 0x60, 0xc9, 0xa1,
+    0xda, 0x1a, 0xa5, 0xd6, 0x08, 0xa3, 0xb8, 0x70, 0xd7, 0xcd, 0xbd, 0xb9, 0xf3, 0x2d, 0x18, 0xf5,
+    0x87, 0x1e, 0x20, 0x3c, 0x05, 0xca, 0xde, 0x87, 0x0c, 0x11, 0xda, 0xa8, 0xdc, 0x9c, 0x97, 0xf7,
+    0xb7, 0x8f, 0x38, 0x92, 0x8e, 0x46, 0x30, 0xec, 0x8c, 0xc0, 0x8a, 0x0d, 0x61, 0x0c, 0xf6, 0x3d,
+    0x78, 0xc6, 0x9f, 0xfa, 0x13, 0xfc, 0x0a, 0xaf, 0x91, 0x6b, 0x9d, 0x85, 0x84, 0x9c, 0x70, 0x7c,
+    0x1a, 0xa7, 0x9a, 0x09, 0xda, 0xe4, 0xfb, 0x49, 0x68, 0x07, 0x18, 0x87, 0x96, 0x5c, 0x4b, 0x45,
+};
+static const uint8_t rsa_dq[] = {
+    0x03, 0xc0, 0x7f, 0x3b, 0x8c, 0x14, 0x0c, 0xec, 0xa2, 0x44, 0x98, 0xbb, 0x6f, 0x70, 0x03, 0xc8,
+    0x6c, 0xf3, 0x90, 0xa9, 0xa2, 0x42, 0xfa, 0x18, 0x97, 0xdf, 0xf9, 0xda, 0x03, 0x00, 0xfe, 0xea,
+    0xb0, 0xf8, 0xc3, 0x88, 0xca, 0xbe, 0x59, 0x5c, 0xc7, 0xf1, 0x93, 0x7f, 0xf5, 0xcd, 0x39, 0xd0,
+    0x89, 0xe8, 0x8f, 0x7e, 0xee, 0x8d, 0x8e, 0x8d, 0x40, 0x2b, 0x3a, 0xf3, 0x7d, 0x45, 0x4c, 0x62,
+    0x37, 0xdb, 0x03, 0xa0, 0x96, 0xad, 0xaf, 0x8d, 0x4b, 0xf7, 0xbc, 0x03, 0x14, 0xcc, 0x00, 0x5f,
+    0xd1, 0xbd, 0xcb, 0xf3, 0x6e, 0x8a, 0xca, 0xcc, 0x4b, 0xab, 0x0f, 0x88, 0xd0, 0x44, 0xcf, 0xe4,
+    0xc7, 0x91, 0x36, 0x98, 0x20, 0x0d, 0x9e, 0x3a, 0xc1, 0x5f, 0x0b, 0x27, 0x11, 0x98, 0xbb, 0x76,
+    0xe9, 0x41, 0x3c, 0x5e, 0xcd, 0xec, 0x7a, 0xc1, 0x51, 0x7f, 0xdf, 0x23, 0x91, 0xb1, 0xcb, 0xf5,
+};
+static const uint8_t rsa_iq[] = {
+    0x41, 0x25, 0x56, 0x5f, 0x78, 0x39, 0x21, 0xb1, 0xe8, 0xfc, 0x1e, 0x75, 0xae, 0xee, 0xf8, 0x8e,
+    0x64, 0x4d, 0x5b, 0xb2, 0x6c, 0xfa, 0x44, 0x7f, 0x09, 0xff, 0x87, 0xa9, 0x11, 0x3e, 0x67, 0x9d,
+    0x32, 0x75, 0xe1, 0x17, 0x61, 0xf3, 0x3b, 0xd6, 0x0c, 0xb2, 0x6d, 0x33, 0x24, 0xe8, 0x54, 0x4a,
+    0x96, 0x8c, 0x1b, 0xd6, 0x80, 0x8a, 0x4d, 0x1e, 0xc8, 0x38, 0x6f, 0x74, 0x03, 0xd4, 0x0a, 0x41,
+    0x76, 0xb5, 0x05, 0x98, 0xcc, 0xba, 0xc5, 0x3d, 0x3f, 0x64, 0x48, 0x49, 0x9c, 0x59, 0x12, 0x74,
+    0x3d, 0xe6, 0x25, 0x6e, 0xf5, 0xc1, 0xf3, 0xaa, 0x37, 0x5a, 0xd0, 0xc1, 0x4a, 0xc9, 0xbd, 0x1f,
+    0xc6, 0x07, 0x09, 0x95, 0x5d, 0x1a, 0x88, 0x6c, 0x51, 0x11, 0x85, 0x01, 0x89, 0x3b, 0x25, 0x41,
+    0xb8, 0xb8, 0x2a, 0x37, 0xb2, 0x95, 0x50, 0x24, 0x4b, 0xcf, 0xdc, 0x92, 0x5d, 0x2b, 0xfa, 0x7d,
+};
+static uint8_t rsa_v15_signature[RSA_SIZE];
+static uint8_t rsa_v22_signature[RSA_SIZE];
+static uint32_t rsa_memory; // of the last verification
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void bench_ecdsa(const ecc_bench_t* impl, const math_bench_t* math, uint32_t size);
+static void bench_eddsa(const ecc_bench_t* impl, const math_bench_t* math);
+static void bench_x25519(const math_bench_t* math);
+static void bench_rsa_sign(const modexp_bench_t* modexp, const math_bench_t* math, const cmox_rsa_key_t* private_key,
+        const cmox_rsa_key_t* public_key);
+static void bench_rsa_verify(const math_bench_t* math, const cmox_rsa_key_t* public_key);
+static bool rsa_verify(const math_bench_t* math, const cmox_rsa_key_t* public_key, bool pss);
+static void report(const char* operation, const char* variant, const char* math, uint32_t length,
+        const bench_stats_t* stats, bool result, uint32_t memory);
+
+/* Public functions ----------------------------------------------------------*/
+
+void pk_bench_run(void)
+{
+    math_bench_t maths[MATH_NUMBER] = {
+        {"small", CMOX_MATH_FUNCS_SMALL},
+        {"fast", CMOX_MATH_FUNCS_FAST},
+        {"super", CMOX_MATH_FUNCS_SUPERFAST256},
+    };
+    ecc_bench_t p256_impls[ECC_IMPL_NUMBER] = {
+        {"low", CMOX_ECC_SECP256R1_LOWMEM},
+        {"high", CMOX_ECC_SECP256R1_HIGHMEM},
+    };
+    ecc_bench_t p384_impls[ECC_IMPL_NUMBER] = {
+        {"low", CMOX_ECC_SECP384R1_LOWMEM},
+        {"high", CMOX_ECC_SECP384R1_HIGHMEM},
+    };
+    ecc_bench_t ed25519_impls[ECC_IMPL_NUMBER] = {
+        {"low", CMOX_ECC_ED25519_OPT_LOWMEM},
+        {"high", CMOX_ECC_ED25519_OPT_HIGHMEM},
+    };
+    modexp_bench_t modexps[MODEXP_NUMBER] = {
+        {"low", CMOX_MODEXP_PRIVATE_LOWMEM},
+        {"mid", CMOX_MODEXP_PRIVATE_MIDMEM},
+        {"high", CMOX_MODEXP_PRIVATE_HIGHMEM},
+    };
+    cmox_rsa_key_t rsa_private_key;
+    cmox_rsa_key_t rsa_public_key;
+
+    for (int i = 0; i < MESSAGE_SIZE; i++) {
+        message[i] = i;
+    }
+
+    report_set_key_size(CMOX_ECC_SECP256R1_PRIVKEY_LEN);
+    for (int i = 0; i < ECC_IMPL_NUMBER; i++) {
+        for (int j = 0; j < MATH_NUMBER; j++) {
+            bench_ecdsa(&p256_impls[i], &maths[j], CMOX_ECC_SECP256R1_PRIVKEY_LEN);
+        }
+    }
+
+    report_set_key_size(CMOX_ECC_SECP384R1_PRIVKEY_LEN);
+    for (int i = 0; i < ECC_IMPL_NUMBER; i++) {
+        for (int j = 0; j < MATH_NUMBER_384; j++) {
+            bench_ecdsa(&p384_impls[i], &maths[j], CMOX_ECC_SECP384R1_PRIVKEY_LEN);
+        }
+    }
+
+    report_set_key_size(CMOX_ECC_CURVE25519_PRIVKEY_LEN);
+    for (int i = 0; i < ECC_IMPL_NUMBER; i++) {
+        for (int j = 0; j < MATH_NUMBER; j++) {
+            bench_eddsa(&ed25519_impls[i], &maths[j]);
+        }
+    }
+    for (int j = 0; j < MATH_NUMBER; j++) {
+        bench_x25519(&maths[j]);
+    }
+
+    report_set_key_size(RSA_SIZE);
+    cmox_rsa_setKeyCRT(&rsa_private_key, 8 * RSA_SIZE, rsa_dp, sizeof(rsa_dp), rsa_dq, sizeof(rsa_dq), rsa_p,
+            sizeof(rsa_p), rsa_q, sizeof(rsa_q), rsa_iq, sizeof(rsa_iq));
+    cmox_rsa_setKey(&rsa_public_key, rsa_n, sizeof(rsa_n), rsa_e, sizeof(rsa_e));
+    for (int i = 0; i < MODEXP_NUMBER; i++) {
+        for (int j = 0; j < MATH_NUMBER_RSA; j++) {
+            bench_rsa_sign(&modexps[i], &maths[j], &rsa_private_key, &rsa_public_key);
+        }
+    }
+    for (int j = 0; j < MATH_NUMBER_RSA; j++) {
+        bench_rsa_verify(&maths[j], &rsa_public_key);
+    }
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * Key generation, signature, verification and shared secret with a peer key,
+ * a new context for each so its peak is the one of the operation
+ */
+static void bench_ecdsa(const ecc_bench_t* impl, const math_bench_t* math, uint32_t size)
+{
+    cmox_ecc_handle_t ctx;
+    bench_stats_t stats;
+    uint8_t private_key[ECC_MAX_SIZE];
+    uint8_t public_key[2 * ECC_MAX_SIZE];
+    uint8_t peer_private_key[ECC_MAX_SIZE];
+    uint8_t peer_public_key[2 * ECC_MAX_SIZE];
+    uint8_t signature[2 * ECC_MAX_SIZE];
+    uint8_t secret[2 * ECC_MAX_SIZE];
+    uint8_t peer_secret[2 * ECC_MAX_SIZE];
+    size_t private_size = 0;
+    size_t public_size = 0;
+    size_t signature_size = 0;
+    size_t secret_size = 0;
+    uint32_t fault_check = 0;
+    bool result = false;
+
+    cmox_ecc_construct(&ctx, math->math, pk_buffer, sizeof(pk_buffer));
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = cmox_ecdsa_keyGen(&ctx, impl->impl, ecc_random, size, private_key, &private_size, public_key,
+                &public_size) == CMOX_ECC_SUCCESS;
+    }
+    report("ecdsa_keygen", impl->name, math->name, size, &stats, result, ctx.membuf_str.MaxMemUsed);
+    bool peer = cmox_ecdsa_keyGen(&ctx, impl->impl, ecc_peer_random, size, peer_private_key, &private_size,
+            peer_public_key, &public_size) == CMOX_ECC_SUCCESS;
+    cmox_ecc_cleanup(&ctx);
+
+    cmox_ecc_construct(&ctx, math->math, pk_buffer, sizeof(pk_buffer));
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = cmox_ecdsa_sign(&ctx, impl->impl, ecc_nonce, size, private_key, private_size, digest, DIGEST_SIZE,
+                signature, &signature_size) == CMOX_ECC_SUCCESS;
+    }
+    report("ecdsa_sign", impl->name, math->name, DIGEST_SIZE, &stats, result, ctx.membuf_str.MaxMemUsed);
+    cmox_ecc_cleanup(&ctx);
+
+    cmox_ecc_construct(&ctx, math->math, pk_buffer, sizeof(pk_buffer));
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = cmox_ecdsa_verify(&ctx, impl->impl, public_key, public_size, digest, DIGEST_SIZE, signature,
+                signature_size, &fault_check) == CMOX_ECC_AUTH_SUCCESS;
+    }
+    report("ecdsa_verify", impl->name, math->name, DIGEST_SIZE, &stats, result, ctx.membuf_str.MaxMemUsed);
+    cmox_ecc_cleanup(&ctx);
+
+    cmox_ecc_construct(&ctx, math->math, pk_buffer, sizeof(pk_buffer));
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = cmox_ecdh(&ctx, impl->impl, private_key, private_size, peer_public_key, public_size, secret,
+                &secret_size) == CMOX_ECC_SUCCESS;
+    }
+    uint32_t memory = ctx.membuf_str.MaxMemUsed;
+    // both sides must agree
+    result = result && peer && cmox_ecdh(&ctx, impl->impl, peer_private_key, private_size, public_key, public_size,
+            peer_secret, &secret_size) == CMOX_ECC_SUCCESS;
+    result = result && memcmp(secret, peer_secret, secret_size) == 0;
+    report("ecdh", impl->name, math->name, size, &stats, result, memory);
+    cmox_ecc_cleanup(&ctx);
+}
+
+static void bench_eddsa(const ecc_bench_t* impl, const math_bench_t* math)
+{
+    cmox_ecc_handle_t ctx;
+    bench_stats_t stats;
+    uint8_t private_key[CMOX_ECC_ED25519_PRIVKEY_LEN];
+    uint8_t public_key[CMOX_ECC_ED25519_PUBKEY_LEN];
+    uint8_t signature[CMOX_ECC_ED25519_SIG_LEN];
+    size_t private_size = 0;
+    size_t public_size = 0;
+    size_t signature_size = 0;
+    uint32_t fault_check = 0;
+    bool result = false;
+
+    cmox_ecc_construct(&ctx, math->math, pk_buffer, sizeof(pk_buffer));
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = cmox_eddsa_keyGen(&ctx, impl->impl, ecc_random, CMOX_ECC_CURVE25519_PRIVKEY_LEN, private_key,
+                &private_size, public_key, &public_size) == CMOX_ECC_SUCCESS;
+    }
+    report("eddsa_keygen", impl->name, math->name, CMOX_ECC_CURVE25519_PRIVKEY_LEN, &stats, result,
+            ctx.membuf_str.MaxMemUsed);
+    cmox_ecc_cleanup(&ctx);
+
+    cmox_ecc_construct(&ctx, math->math, pk_buffer, sizeof(pk_buffer));
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = cmox_eddsa_sign(&ctx, impl->impl, private_key, private_size, message, MESSAGE_SIZE, signature,
+                &signature_size) == CMOX_ECC_SUCCESS;
+    }
+    report("eddsa_sign", impl->name, math->name, MESSAGE_SIZE, &stats, result, ctx.membuf_str.MaxMemUsed);
+    cmox_ecc_cleanup(&ctx);
+
+    cmox_ecc_construct(&ctx, math->math, pk_buffer, sizeof(pk_buffer));
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = cmox_eddsa_verify(&ctx, impl->impl, public_key, public_size, message, MESSAGE_SIZE, signature,
+                signature_size, &fault_check) == CMOX_ECC_AUTH_SUCCESS;
+    }
+    report("eddsa_verify", impl->name, math->name, MESSAGE_SIZE, &stats, result, ctx.membuf_str.MaxMemUsed);
+    cmox_ecc_cleanup(&ctx);
+}
+
+/**
+ * The public keys are X25519(private key, 9), only the shared secret is
+ * measured
+ */
+static void bench_x25519(const math_bench_t* math)
+{
+    static const uint8_t base_point[CMOX_ECC_CURVE25519_PUBKEY_LEN] = {9};
+    cmox_ecc_handle_t ctx;
+    bench_stats_t stats;
+    uint8_t public_key[CMOX_ECC_CURVE25519_PUBKEY_LEN];
+    uint8_t peer_public_key[CMOX_ECC_CURVE25519_PUBKEY_LEN];
+    uint8_t secret[CMOX_ECC_CURVE25519_SECRET_LEN];
+    uint8_t peer_secret[CMOX_ECC_CURVE25519_SECRET_LEN];
+    size_t size = 0;
+    bool keys;
+    bool result = false;
+
+    cmox_ecc_construct(&ctx, math->math, pk_buffer, sizeof(pk_buffer));
+    keys = cmox_ecdh(&ctx, CMOX_ECC_CURVE25519, ecc_random, CMOX_ECC_CURVE25519_PRIVKEY_LEN, base_point,
+            sizeof(base_point), public_key, &size) == CMOX_ECC_SUCCESS;
+    keys = keys && cmox_ecdh(&ctx, CMOX_ECC_CURVE25519, ecc_peer_random, CMOX_ECC_CURVE25519_PRIVKEY_LEN,
+            base_point, sizeof(base_point), peer_public_key, &size) == CMOX_ECC_SUCCESS;
+    cmox_ecc_cleanup(&ctx);
+
+    cmox_ecc_construct(&ctx, math->math, pk_buffer, sizeof(pk_buffer));
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = cmox_ecdh(&ctx, CMOX_ECC_CURVE25519, ecc_random, CMOX_ECC_CURVE25519_PRIVKEY_LEN,
+                peer_public_key, sizeof(peer_public_key), secret, &size) == CMOX_ECC_SUCCESS;
+    }
+    uint32_t memory = ctx.membuf_str.MaxMemUsed;
+    result = result && keys && cmox_ecdh(&ctx, CMOX_ECC_CURVE25519, ecc_peer_random, CMOX_ECC_CURVE25519_PRIVKEY_LEN,
+            public_key, sizeof(public_key), peer_secret, &size) == CMOX_ECC_SUCCESS;
+    result = result && memcmp(secret, peer_secret, sizeof(secret)) == 0;
+    report("x25519", NULL, math->name, CMOX_ECC_CURVE25519_PRIVKEY_LEN, &stats, result, memory);
+    cmox_ecc_cleanup(&ctx);
+}
+
+/**
+ * PKCS#1 v1.5 and v2.2 signatures with the CRT key, checked with the public
+ * key, the signatures are kept for bench_rsa_verify()
+ */
+static void bench_rsa_sign(const modexp_bench_t* modexp, const math_bench_t* math, const cmox_rsa_key_t* private_key,
+        const cmox_rsa_key_t* public_key)
+{
+    cmox_rsa_handle_t ctx;
+    bench_stats_t stats;
+    size_t size = 0;
+    uint32_t memory;
+    bool result = false;
+
+    cmox_rsa_construct(&ctx, math->math, modexp->modexp, pk_buffer, sizeof(pk_buffer));
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = cmox_rsa_pkcs1v15_sign(&ctx, private_key, digest, CMOX_RSA_PKCS1V15_HASH_SHA256, rsa_v15_signature,
+                &size) == CMOX_RSA_SUCCESS;
+    }
+    memory = ctx.membuf_str.MaxMemUsed;
+    cmox_rsa_cleanup(&ctx);
+    result = result && rsa_verify(math, public_key, false);
+    report("rsa_v15_sign", modexp->name, math->name, DIGEST_SIZE, &stats, result, memory);
+
+    cmox_rsa_construct(&ctx, math->math, modexp->modexp, pk_buffer, sizeof(pk_buffer));
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = cmox_rsa_pkcs1v22_sign(&ctx, private_key, digest, CMOX_RSA_PKCS1V22_HASH_SHA256, ecc_nonce,
+                SALT_SIZE, rsa_v22_signature, &size) == CMOX_RSA_SUCCESS;
+    }
+    memory = ctx.membuf_str.MaxMemUsed;
+    cmox_rsa_cleanup(&ctx);
+    result = result && rsa_verify(math, public_key, true);
+    report("rsa_v22_sign", modexp->name, math->name, DIGEST_SIZE, &stats, result, memory);
+}
+
+static void bench_rsa_verify(const math_bench_t* math, const cmox_rsa_key_t* public_key)
+{
+    bench_stats_t stats;
+    bool result = false;
+
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = rsa_verify(math, public_key, false);
+    }
+    report("rsa_v15_verify", NULL, math->name, DIGEST_SIZE, &stats, result, rsa_memory);
+
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = rsa_verify(math, public_key, true);
+    }
+    report("rsa_v22_verify", NULL, math->name, DIGEST_SIZE, &stats, result, rsa_memory);
+}
+
+/**
+ * Verify the last signature with a new context, its peak is kept in
+ * rsa_memory
+ * @param pss true for the v2.2 signature, false for the v1.5 one
+ * @return true if the signature is authentic
+ */
+static bool rsa_verify(const math_bench_t* math, const cmox_rsa_key_t* public_key, bool pss)
+{
+    cmox_rsa_handle_t ctx;
+    uint32_t fault_check = 0;
+    cmox_rsa_retval_t retval;
+
+    cmox_rsa_construct(&ctx, math->math, CMOX_MODEXP_PUBLIC, pk_buffer, sizeof(pk_buffer));
+    if (pss) {
+        retval = cmox_rsa_pkcs1v22_verify(&ctx, public_key, digest, CMOX_RSA_PKCS1V22_HASH_SHA256, SALT_SIZE,
+                rsa_v22_signature, RSA_SIZE, &fault_check);
+    } else {
+        retval = cmox_rsa_pkcs1v15_verify(&ctx, public_key, digest, CMOX_RSA_PKCS1V15_HASH_SHA256,
+                rsa_v15_signature, RSA_SIZE, &fault_check);
+    }
+    rsa_memory = ctx.membuf_str.MaxMemUsed;
+    cmox_rsa_cleanup(&ctx);
+    return retval == CMOX_RSA_AUTH_SUCCESS;
+}
+
+/**
+ * Send the result and the peak of the working buffer under the name
+ * operation_variant_math, the variant can be NULL
+ */
+static void report(const char* operation, const char* variant, const char* math, uint32_t length,
+        const bench_stats_t* stats, bool result, uint32_t memory)
+{
+    char name[NAME_SIZE];
+
+    if (variant != NULL) {
+        snprintf(name, sizeof(name), "%s_%s_%s", operation, variant, math);
+    } else {
+        snprintf(name, sizeof(name), "%s_%s", operation, math);
+    }
+    report_result(name, length, stats, result, NULL, NULL);
+    report_memory(name, memory);
+}
@@ -0,0 +1,363 @@
+/**
+ ******************************************************************************
+ * @file    report.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   benchmark results output
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "stm32l4xx_hal.h"
+#include "logger.h"
+#include "main.h"
+#include "report.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define MIC_SIZE 16
+
+#define NAME_SIZE 32 // with the terminator, longer names are truncated
+#define NAMES_SIZE 8192
+
+#define CRC32_POLYNOMIAL 0x04C11DB7
+#define CRC32_INIT 0xFFFFFFFF
+
+// bytes hex encoded at once
+#define HEX_CHUNK_SIZE 64
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct __PACKED {
+    uint16_t id;
+    uint8_t result;
+    uint16_t outliers;
+    uint16_t key_bits;
+    uint32_t length;
+    uint32_t min;
+    uint32_t median;
+    uint32_t p99;
+    uint32_t stddev;
+    uint32_t t_cpu;
+    uint32_t idle;
+    uint32_t crc;
+} result_record_t;
+
+typedef struct __PACKED {
+    uint16_t id;
+    uint16_t key_bits;
+    uint32_t slope_thousandths;
+    int32_t intercept;
+} fit_record_t;
+
+typedef struct __PACKED {
+    uint16_t id;
+    uint16_t key_bits;
+    uint32_t count;
+} counter_record_t;
+
+typedef struct __PACKED {
+    uint16_t id;
+    uint16_t key_bits;
+    uint32_t bytes;
+} memory_record_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+// configuration of the CRC peripheral saved by crc_start()
+static uint32_t crc_cr;
+static uint32_t crc_init;
+static uint32_t crc_polynomial;
+
+// the names already sent one after the other with their terminator, in the
+// order of their id
+#ifndef REPORT_TEXT
+static char names[NAMES_SIZE];
+static uint32_t names_length;
+#endif
+static uint32_t name_number;
+
+static uint32_t key_bits;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void send_result(const char* name, uint32_t length, const bench_stats_t* stats, bool async, uint32_t t_cpu, uint32_t idle,
+        bool result, const uint8_t* data, const uint8_t* mic);
+#ifndef REPORT_TEXT
+static uint16_t get_id(const char* name);
+static void send_frame(uint8_t type, const void* payload, uint8_t length);
+#endif
+static void crc_start(void);
+static void crc_update(const uint8_t* data, uint32_t length);
+static uint32_t crc_end(void);
+static void send_bytes(const void* data, uint32_t length);
+#ifdef REPORT_TEXT
+static char hex_to_str(uint8_t hex);
+static void send_hex_data(const uint8_t* data, uint32_t length);
+#endif
+
+/* Public functions ----------------------------------------------------------*/
+
+void report_init(void)
+{
+    // already done by cmox_ll_init(), the CRC is also needed without CMOX
+    __HAL_RCC_CRC_CLK_ENABLE();
+
+#ifndef REPORT_TEXT
+    names_length = 0;
+#endif
+    name_number = 0;
+    key_bits = 128;
+}
+
+void report_set_key_size(uint32_t key_size)
+{
+    key_bits = 8 * key_size;
+}
+
+void report_result(const char* name, uint32_t length, const bench_stats_t* stats, bool result, const uint8_t* data, const uint8_t* mic)
+{
+    send_result(name, length, stats, false, 0, 0, result, data, mic);
+}
+
+void report_result_async(const char* name, uint32_t length, const bench_stats_t* stats, uint32_t t_cpu, uint32_t idle,
+        bool result, const uint8_t* data, const uint8_t* mic)
+{
+    send_result(name, length, stats, true, t_cpu, idle, result, data, mic);
+}
+
+void report_fit(const char* name, uint32_t slope_thousandths, int32_t intercept)
+{
+#ifdef REPORT_TEXT
+    char text[128];
+
+    sprintf(text, "%s: key = %lu, slope = %lu.%03lu cycles/byte, intercept = %ld cycles\n\n",
+            name, key_bits, slope_thousandths / 1000, slope_thousandths % 1000, intercept);
+    send_bytes(text, strlen(text));
+#else
+    fit_record_t record = {
+        .id = get_id(name),
+        .key_bits = key_bits,
+        .slope_thousandths = slope_thousandths,
+        .intercept = intercept,
+    };
+    send_frame(REPORT_FRAME_FIT, &record, sizeof(record));
+#endif
+}
+
+void report_counter(const char* name, uint32_t count)
+{
+#ifdef REPORT_TEXT
+    char text[96];
+
+    sprintf(text, "%s: key = %lu, count = %lu\n\n", name, key_bits, count);
+    send_bytes(text, strlen(text));
+#else
+    counter_record_t record = {
+        .id = get_id(name),
+        .key_bits = key_bits,
+        .count = count,
+    };
+    send_frame(REPORT_FRAME_COUNTER, &record, sizeof(record));
+#endif
+}
+
+void report_memory(const char* name, uint32_t bytes)
+{
+#ifdef REPORT_TEXT
+    char text[96];
+
+    sprintf(text, "%s: key = %lu, memory = %lu bytes\n\n", name, key_bits, bytes);
+    send_bytes(text, strlen(text));
+#else
+    memory_record_t record = {
+        .id = get_id(name),
+        .key_bits = key_bits,
+        .bytes = bytes,
+    };
+    send_frame(REPORT_FRAME_MEMORY, &record, sizeof(record));
+#endif
+}
+
+uint32_t report_crc32(const uint8_t* data, uint32_t length)
+{
+    crc_start();
+    crc_update(data, length);
+    return crc_end();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void send_result(const char* name, uint32_t length, const bench_stats_t* stats, bool async, uint32_t t_cpu, uint32_t idle,
+        bool result, const uint8_t* data, const uint8_t* mic)
+{
+#ifdef REPORT_TEXT
+    char stats_text[BENCH_TEXT_SIZE];
+    char text[256];
+
+    if (async) {
+        sprintf(text, "%s: length = %lu, key = %lu, %s, t_cpu = %lu, idle = %lu, result = %i\n",
+                name, length, key_bits, bench_format(stats_text, stats), t_cpu, idle, result);
+    } else {
+        sprintf(text, "%s: length = %lu, key = %lu, %s, result = %i\n",
+                name, length, key_bits, bench_format(stats_text, stats), result);
+    }
+    send_bytes(text, strlen(text));
+
+    if (data != NULL) {
+        send_hex_data(data, length);
+        if (mic != NULL) {
+            send_bytes("\nMIC = ", 7);
+            send_hex_data(mic, MIC_SIZE);
+        }
+        send_bytes("\n\n", 2);
+    }
+#else
+    (void)async;
+
+    uint32_t crc = 0;
+    if (data != NULL) {
+        // CRC of the output data followed by the tag
+        crc_start();
+        crc_update(data, length);
+        if (mic != NULL) {
+            crc_update(mic, MIC_SIZE);
+        }
+        crc = crc_end();
+    }
+
+    result_record_t record = {
+        .id = get_id(name),
+        .result = result,
+        .outliers = stats->outliers,
+        .key_bits = key_bits,
+        .length = length,
+        .min = stats->min,
+        .median = stats->median,
+        .p99 = stats->p99,
+        .stddev = stats->stddev,
+        .t_cpu = t_cpu,
+        .idle = idle,
+        .crc = crc,
+    };
+    send_frame(REPORT_FRAME_RESULT, &record, sizeof(record));
+#endif
+}
+
+#ifndef REPORT_TEXT
+/**
+ * @return the id of the name, the name frame is sent the first time
+ */
+static uint16_t get_id(const char* name)
+{
+    const char* known = names;
+
+    for (uint32_t i = 0; i < name_number; i++) {
+        if (strncmp(known, name, NAME_SIZE - 1) == 0) {
+            return i;
+        }
+        known += strlen(known) + 1;
+    }
+
+    uint32_t length = strnlen(name, NAME_SIZE - 1);
+    if (names_length + length + 1 > NAMES_SIZE) {
+        // an id shared by two names would merge their results
+        Error_Handler();
+    }
+
+    uint16_t id = name_number++;
+    char* copy = &names[names_length];
+    memcpy(copy, name, length);
+    copy[length] = '\0';
+    names_length += length + 1;
+
+    uint8_t payload[sizeof(id) + NAME_SIZE];
+    memcpy(payload, &id, sizeof(id));
+    memcpy(&payload[sizeof(id)], copy, length);
+    send_frame(REPORT_FRAME_NAME, payload, sizeof(id) + length);
+
+    return id;
+}
+
+static void send_frame(uint8_t type, const void* payload, uint8_t length)
+{
+    uint8_t header[3] = {REPORT_FRAME_START, type, length};
+    uint32_t crc = report_crc32(payload, length);
+
+    send_bytes(header, sizeof(header));
+    send_bytes(payload, length);
+    send_bytes(&crc, sizeof(crc));
+}
+#endif
+
+static void crc_start(void)
+{
+    crc_cr = CRC->CR;
+    crc_init = CRC->INIT;
+    crc_polynomial = CRC->POL;
+
+    // 32-bit polynomial, input bit-reversed by byte and output bit-reversed
+    // (reflected CRC), the data are written byte by byte
+    CRC->POL = CRC32_POLYNOMIAL;
+    CRC->INIT = CRC32_INIT;
+    CRC->CR = CRC_CR_REV_IN_0 | CRC_CR_REV_OUT | CRC_CR_RESET;
+}
+
+static void crc_update(const uint8_t* data, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; i++) {
+        *(__IO uint8_t*)&CRC->DR = data[i];
+    }
+}
+
+static uint32_t crc_end(void)
+{
+    uint32_t crc = CRC->DR ^ 0xFFFFFFFF;
+
+    CRC->POL = crc_polynomial;
+    CRC->INIT = crc_init;
+    CRC->CR = crc_cr | CRC_CR_RESET;
+
+    return crc;
+}
+
+static void send_bytes(const void* data, uint32_t length)
+{
+    logger_write(data, length);
+}
+
+#ifdef REPORT_TEXT
+static char hex_to_str(uint8_t hex)
+{
+    if (hex < 10) {
+        return '0' + hex;
+    } else {
+        return 'A' + hex - 10;
+    }
+}
+
+static void send_hex_data(const uint8_t* data, uint32_t length)
+{
+    uint8_t hex[2 * HEX_CHUNK_SIZE];
+
+    while (length > 0) {
+        uint32_t chunk = length < HEX_CHUNK_SIZE ? length : HEX_CHUNK_SIZE;
+        for (uint32_t i = 0; i < chunk; i++) {
+            hex[2*i] = hex_to_str((data[i] & 0xF0) >> 4);
+            hex[2*i + 1] = hex_to_str(data[i] & 0x0F);
+        }
+        send_bytes(hex, 2 * chunk);
+        data += chunk;
+        length -= chunk;
+    }
+}
+#endif
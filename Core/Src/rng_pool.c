@@ -0,0 +1,269 @@
+/**
+ ******************************************************************************
+ * @file    rng_pool.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   pool of random bytes for the nonces and the IVs
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "stm32l4xx_hal.h"
+
+#include "cmox_crypto.h"
+#include "rng_pool.h"
+
+/* Private define ------------------------------------------------------------*/
+
+// the minimum of CMOX, the key size, and a nonce of half of it
+#define ENTROPY_WORDS (RNG_POOL_KEY_SIZE / 4)
+#define NONCE_WORDS (RNG_POOL_KEY_SIZE / 8)
+#define RNG_TIMEOUT 10 // ms, the startup of the RNG is much shorter
+// the collection of the entropy is not urgent
+#define RNG_IRQ_PRIORITY 15
+
+/* Private variables ---------------------------------------------------------*/
+
+static const char personalization[] = "rng_pool";
+
+static cmox_ctr_drbg_handle_t drbg_handle;
+static cmox_drbg_handle_t* drbg;
+static bool ready;
+
+// the bytes ready start at pool_read, the next block is generated after them
+static uint8_t pool[RNG_POOL_SIZE];
+static uint32_t pool_read;
+static uint32_t pool_count;
+static uint32_t blocks; // since the last reseed
+
+// the entropy of the next reseed, collected by the interrupt
+static volatile uint32_t entropy[ENTROPY_WORDS];
+static volatile uint32_t entropy_count;
+
+// the errors are counted by the interrupt, apart from the other counters so
+// that a copy or a reset of the stats is not torn by it
+static rng_pool_stats_t stats;
+static volatile uint32_t errors;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static bool start_rng(void);
+static bool collect(uint32_t* words, uint32_t number);
+static void recover(uint32_t status);
+static bool reseed(void);
+
+/* Public functions ----------------------------------------------------------*/
+
+bool rng_pool_init(void)
+{
+    uint32_t seed[ENTROPY_WORDS + NONCE_WORDS];
+
+    ready = false;
+    pool_read = 0;
+    pool_count = 0;
+    blocks = 0;
+    entropy_count = 0;
+    rng_pool_reset_stats();
+
+    if (!start_rng() || !collect(seed, ENTROPY_WORDS + NONCE_WORDS)) {
+        return false;
+    }
+    drbg = cmox_ctr_drbg_construct(&drbg_handle, CMOX_CTR_DRBG_AES256_FAST);
+    ready = drbg != NULL && cmox_drbg_init(drbg, (const uint8_t*)seed, 4 * ENTROPY_WORDS,
+            (const uint8_t*)personalization, sizeof(personalization) - 1, (const uint8_t*)&seed[ENTROPY_WORDS],
+            4 * NONCE_WORDS) == CMOX_DRBG_SUCCESS;
+    memset(seed, 0, sizeof(seed));
+    if (!ready) {
+        return false;
+    }
+
+    // the entropy of the first reseed
+    SET_BIT(RNG->CR, RNG_CR_IE);
+    while (rng_pool_process()) {
+    }
+    return true;
+}
+
+bool rng_pool_get(uint8_t* output, uint32_t length)
+{
+    if (length > pool_count) {
+        stats.fallbacks++;
+        return rng_pool_generate(output, length);
+    }
+
+    uint32_t first = RNG_POOL_SIZE - pool_read;
+    if (first > length) {
+        first = length;
+    }
+    memcpy(output, &pool[pool_read], first);
+    memset(&pool[pool_read], 0, first);
+    memcpy(&output[first], pool, length - first);
+    memset(pool, 0, length - first);
+    pool_read = (pool_read + length) % RNG_POOL_SIZE;
+    pool_count -= length;
+    return true;
+}
+
+bool rng_pool_generate(uint8_t* output, uint32_t length)
+{
+    return ready && cmox_drbg_generate(drbg, NULL, 0, output, length) == CMOX_DRBG_SUCCESS;
+}
+
+bool rng_pool_process(void)
+{
+    if (!ready) {
+        return false;
+    }
+    if (blocks >= RNG_POOL_RESEED_BLOCKS && entropy_count == ENTROPY_WORDS) {
+        return reseed();
+    }
+    if (RNG_POOL_SIZE - pool_count < RNG_POOL_BLOCK_SIZE) {
+        return false;
+    }
+
+    // the free bytes start on a block boundary, the pool being a multiple of
+    // the block, so the block does not wrap
+    uint32_t write = (pool_read + pool_count) % RNG_POOL_SIZE;
+    if (!rng_pool_generate(&pool[write], RNG_POOL_BLOCK_SIZE)) {
+        return false;
+    }
+    pool_count += RNG_POOL_BLOCK_SIZE;
+    blocks++;
+    stats.refills++;
+    return true;
+}
+
+uint32_t rng_pool_available(void)
+{
+    return pool_count;
+}
+
+void rng_pool_get_stats(rng_pool_stats_t* result)
+{
+    *result = stats;
+    result->errors = errors;
+}
+
+void rng_pool_reset_stats(void)
+{
+    memset(&stats, 0, sizeof(stats));
+    errors = 0;
+}
+
+void rng_pool_irq_handler(void)
+{
+    uint32_t status = RNG->SR;
+
+    if (status & (RNG_SR_SEIS | RNG_SR_CEIS)) {
+        recover(status);
+        if (status & RNG_SR_SEIS) {
+            // the words collected before the error are not trusted
+            entropy_count = 0;
+        }
+        return;
+    }
+    while ((RNG->SR & RNG_SR_DRDY) && entropy_count < ENTROPY_WORDS) {
+        entropy[entropy_count++] = RNG->DR;
+    }
+    if (entropy_count == ENTROPY_WORDS) {
+        CLEAR_BIT(RNG->CR, RNG_CR_IE);
+    }
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * Clock the RNG from the HSI48 and enable it, without its interrupt
+ */
+static bool start_rng(void)
+{
+    RCC_OscInitTypeDef oscillator = {0};
+    RCC_PeriphCLKInitTypeDef clock = {0};
+
+    oscillator.OscillatorType = RCC_OSCILLATORTYPE_HSI48;
+    oscillator.HSI48State = RCC_HSI48_ON;
+    oscillator.PLL.PLLState = RCC_PLL_NONE;
+    if (HAL_RCC_OscConfig(&oscillator) != HAL_OK) {
+        return false;
+    }
+    clock.PeriphClockSelection = RCC_PERIPHCLK_RNG;
+    clock.RngClockSelection = RCC_RNGCLKSOURCE_HSI48;
+    if (HAL_RCCEx_PeriphCLKConfig(&clock) != HAL_OK) {
+        return false;
+    }
+    __HAL_RCC_RNG_CLK_ENABLE();
+
+    HAL_NVIC_SetPriority(RNG_IRQn, RNG_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(RNG_IRQn);
+    RNG->CR = RNG_CR_RNGEN;
+    return true;
+}
+
+/**
+ * Read words from the RNG by polling, a seed error restarts the collection
+ */
+static bool collect(uint32_t* words, uint32_t number)
+{
+    uint32_t start = HAL_GetTick();
+    uint32_t count = 0;
+
+    while (count < number) {
+        uint32_t status = RNG->SR;
+        if (status & (RNG_SR_SEIS | RNG_SR_CEIS)) {
+            recover(status);
+            if (status & RNG_SR_SEIS) {
+                count = 0;
+            }
+        } else if (status & RNG_SR_DRDY) {
+            words[count++] = RNG->DR;
+        } else if (HAL_GetTick() - start > RNG_TIMEOUT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Clear the error flags, a seed error also restarts the RNG (RM0394)
+ */
+static void recover(uint32_t status)
+{
+    errors++;
+    if (status & RNG_SR_SEIS) {
+        CLEAR_BIT(RNG->SR, RNG_SR_SEIS);
+        CLEAR_BIT(RNG->CR, RNG_CR_RNGEN);
+        SET_BIT(RNG->CR, RNG_CR_RNGEN);
+    }
+    if (status & RNG_SR_CEIS) {
+        CLEAR_BIT(RNG->SR, RNG_SR_CEIS);
+    }
+}
+
+/**
+ * Reseed with the entropy collected and start the next collection
+ */
+static bool reseed(void)
+{
+    uint32_t seed[ENTROPY_WORDS];
+
+    for (int i = 0; i < ENTROPY_WORDS; i++) {
+        seed[i] = entropy[i];
+        entropy[i] = 0;
+    }
+    bool result = cmox_drbg_reseed(drbg, (const uint8_t*)seed, sizeof(seed), NULL, 0) == CMOX_DRBG_SUCCESS;
+    memset(seed, 0, sizeof(seed));
+
+    blocks = 0;
+    stats.reseeds++;
+    entropy_count = 0;
+    SET_BIT(RNG->CR, RNG_CR_IE);
+    return result;
+}
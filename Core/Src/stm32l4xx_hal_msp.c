@@ -24,6 +24,9 @@
 /* USER CODE BEGIN Includes */
 
 /* USER CODE END Includes */
+extern DMA_HandleTypeDef hdma_aes_in;
+
+extern DMA_HandleTypeDef hdma_aes_out;
 
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN TD */
@@ -77,6 +80,80 @@ void HAL_MspInit(void)
   /* USER CODE END MspInit 1 */
 }
 
+/**
+* @brief CRYP MSP Initialization
+* This function configures the hardware resources used in this example
+* @param hcryp: CRYP handle pointer
+* @retval None
+*/
+void HAL_CRYP_MspInit(CRYP_HandleTypeDef* hcryp)
+{
+  if(hcryp->Instance==AES)
+  {
+  /* USER CODE BEGIN AES_MspInit 0 */
+
+  /* USER CODE END AES_MspInit 0 */
+    /* Peripheral clock enable */
+    __HAL_RCC_AES_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    /* AES DMA Init */
+    /* The HAL_CRYP_AESxxx functions de-initialize the handle on every call,
+       so only configure the DMA channels the first time */
+    if (hdma_aes_in.State == HAL_DMA_STATE_RESET)
+    {
+      /* AES_IN Init */
+      hdma_aes_in.Instance = DMA2_Channel1;
+      hdma_aes_in.Init.Request = DMA_REQUEST_6;
+      hdma_aes_in.Init.Direction = DMA_MEMORY_TO_PERIPH;
+      hdma_aes_in.Init.PeriphInc = DMA_PINC_DISABLE;
+      hdma_aes_in.Init.MemInc = DMA_MINC_ENABLE;
+      hdma_aes_in.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+      hdma_aes_in.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+      hdma_aes_in.Init.Mode = DMA_NORMAL;
+      hdma_aes_in.Init.Priority = DMA_PRIORITY_HIGH;
+      if (HAL_DMA_Init(&hdma_aes_in) != HAL_OK)
+      {
+        Error_Handler();
+      }
+
+      /* AES_OUT Init */
+      hdma_aes_out.Instance = DMA2_Channel2;
+      hdma_aes_out.Init.Request = DMA_REQUEST_6;
+      hdma_aes_out.Init.Direction = DMA_PERIPH_TO_MEMORY;
+      hdma_aes_out.Init.PeriphInc = DMA_PINC_DISABLE;
+      hdma_aes_out.Init.MemInc = DMA_MINC_ENABLE;
+      hdma_aes_out.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+      hdma_aes_out.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+      hdma_aes_out.Init.Mode = DMA_NORMAL;
+      hdma_aes_out.Init.Priority = DMA_PRIORITY_HIGH;
+      if (HAL_DMA_Init(&hdma_aes_out) != HAL_OK)
+      {
+        Error_Handler();
+      }
+
+      /* DMA interrupt init */
+      HAL_NVIC_SetPriority(DMA2_Channel1_IRQn, 0, 0);
+      HAL_NVIC_EnableIRQ(DMA2_Channel1_IRQn);
+      HAL_NVIC_SetPriority(DMA2_Channel2_IRQn, 0, 0);
+      HAL_NVIC_EnableIRQ(DMA2_Channel2_IRQn);
+
+      /* AES interrupt Init */
+      HAL_NVIC_SetPriority(AES_IRQn, 0, 0);
+      HAL_NVIC_EnableIRQ(AES_IRQn);
+    }
+
+    __HAL_LINKDMA(hcryp,hdmain,hdma_aes_in);
+
+    __HAL_LINKDMA(hcryp,hdmaout,hdma_aes_out);
+
+  /* USER CODE BEGIN AES_MspInit 1 */
+
+  /* USER CODE END AES_MspInit 1 */
+  }
+
+}
+
 /* USER CODE BEGIN 1 */
 
 /* USER CODE END 1 */
@@ -0,0 +1,275 @@
+/**
+ ******************************************************************************
+ * @file    storage_bench.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   benchmark of the storage encryption and the key provisioning
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "stm32l4xx_hal.h"
+
+#include "bench.h"
+#include "cmox_crypto.h"
+#include "report.h"
+#include "storage_bench.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define MAX_SECTOR_SIZE 4096
+#define SECTOR_SIZE_NUMBER 3
+#define STREAM_SECTORS 16 // consecutive sectors of a measurement
+#define FIRST_SECTOR 0x1000
+#define TWEAK_SIZE 16
+#define CHECK_SIZE 16 // the first block, compared with the one-shot output
+
+#define AES_KEY_SIZE_NUMBER 2 // XTS-AES-128 and XTS-AES-256
+#define KEK_SIZE_NUMBER 3
+#define WRAPPED_KEY_SIZE 32
+#define KEYWRAP_IV_SIZE 8
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct {
+    const char* name;
+    cmox_xts_impl_t impl;
+} xts_bench_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+// one sector processed in place, in SRAM2 with the working buffer of pk_bench
+static uint8_t sector[MAX_SECTOR_SIZE] __attribute__((section(".ram2")));
+
+static const uint32_t sector_sizes[SECTOR_SIZE_NUMBER] = {256, 512, MAX_SECTOR_SIZE};
+static const uint32_t aes_key_sizes[AES_KEY_SIZE_NUMBER] = {16, 32};
+static const uint32_t kek_sizes[KEK_SIZE_NUMBER] = {16, 24, 32};
+
+// the default IV of RFC 3394
+static const uint8_t keywrap_iv[KEYWRAP_IV_SIZE] = {0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6};
+
+// the data key and the tweak key of XTS, the KEK, the key wrapped
+static uint8_t key[2 * 32];
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void bench_xts_oneshot(uint32_t key_size, uint32_t size);
+static void bench_xts(const xts_bench_t* encrypt, const xts_bench_t* decrypt, uint32_t key_size, uint32_t size);
+static bool stream(cmox_cipher_handle_t* cipher, uint32_t size);
+static void bench_keywrap(uint32_t kek_size);
+static void set_tweak(uint8_t* tweak, uint32_t number);
+static void fill_sector(uint32_t size);
+static bool check_sector(uint32_t size);
+static void sector_report(const char* name, uint32_t size, const bench_stats_t* stats, bool result);
+
+/* Public functions ----------------------------------------------------------*/
+
+void storage_bench_run(void)
+{
+    xts_bench_t encrypts[] = {
+        {"xts_enc_fast", CMOX_AESFAST_XTS_ENC},
+        {"xts_enc_small", CMOX_AESSMALL_XTS_ENC},
+    };
+    xts_bench_t decrypts[] = {
+        {"xts_dec_fast", CMOX_AESFAST_XTS_DEC},
+        {"xts_dec_small", CMOX_AESSMALL_XTS_DEC},
+    };
+
+    for (uint32_t i = 0; i < sizeof(key); i++) {
+        key[i] = i;
+    }
+
+    for (int i = 0; i < AES_KEY_SIZE_NUMBER; i++) {
+        report_set_key_size(aes_key_sizes[i]);
+        for (int j = 0; j < SECTOR_SIZE_NUMBER; j++) {
+            bench_xts_oneshot(aes_key_sizes[i], sector_sizes[j]);
+            for (uint32_t k = 0; k < sizeof(encrypts) / sizeof(encrypts[0]); k++) {
+                bench_xts(&encrypts[k], &decrypts[k], aes_key_sizes[i], sector_sizes[j]);
+            }
+        }
+    }
+
+    for (int i = 0; i < KEK_SIZE_NUMBER; i++) {
+        report_set_key_size(kek_sizes[i]);
+        bench_keywrap(kek_sizes[i]);
+    }
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * The one-shot function for every sector, the keys are expanded each time
+ */
+static void bench_xts_oneshot(uint32_t key_size, uint32_t size)
+{
+    bench_stats_t stats;
+    uint8_t tweak[TWEAK_SIZE];
+    bool result = false;
+
+    fill_sector(size);
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = true;
+        for (uint32_t i = 0; i < STREAM_SECTORS; i++) {
+            set_tweak(tweak, FIRST_SECTOR + i);
+            result &= cmox_cipher_encrypt(CMOX_AESFAST_XTS_ENC_ALGO, sector, size, key, 2 * key_size, tweak,
+                    TWEAK_SIZE, sector, NULL) == CMOX_CIPHER_SUCCESS;
+        }
+    }
+    sector_report("xts_enc_oneshot", size, &stats, result);
+}
+
+/**
+ * A handle keyed once for the stream, only the tweak is set per sector. The
+ * first sector encrypted by the handle must be the one of the one-shot
+ * function and decrypt back to the data.
+ */
+static void bench_xts(const xts_bench_t* encrypt, const xts_bench_t* decrypt, uint32_t key_size, uint32_t size)
+{
+    cmox_xts_handle_t encrypt_handle;
+    cmox_xts_handle_t decrypt_handle;
+    bench_stats_t stats;
+    uint8_t tweak[TWEAK_SIZE];
+    uint8_t expected[CHECK_SIZE];
+    bool result = false;
+
+    cmox_cipher_handle_t* encrypt_cipher = cmox_xts_construct(&encrypt_handle, encrypt->impl);
+    cmox_cipher_handle_t* decrypt_cipher = cmox_xts_construct(&decrypt_handle, decrypt->impl);
+    bool ready = encrypt_cipher != NULL && decrypt_cipher != NULL
+            && cmox_cipher_init(encrypt_cipher) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_init(decrypt_cipher) == CMOX_CIPHER_SUCCESS;
+
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = ready && cmox_cipher_setKey(encrypt_cipher, key, 2 * key_size) == CMOX_CIPHER_SUCCESS
+                && stream(encrypt_cipher, size);
+    }
+    sector_report(encrypt->name, size, &stats, result);
+
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = ready && cmox_cipher_setKey(decrypt_cipher, key, 2 * key_size) == CMOX_CIPHER_SUCCESS
+                && stream(decrypt_cipher, size);
+    }
+
+    // the check, out of the measurements
+    set_tweak(tweak, FIRST_SECTOR);
+    fill_sector(size);
+    result &= cmox_cipher_encrypt(CMOX_AESFAST_XTS_ENC_ALGO, sector, size, key, 2 * key_size, tweak,
+            TWEAK_SIZE, sector, NULL) == CMOX_CIPHER_SUCCESS;
+    memcpy(expected, sector, CHECK_SIZE);
+    fill_sector(size);
+    result &= ready && cmox_cipher_setIV(encrypt_cipher, tweak, TWEAK_SIZE) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_append(encrypt_cipher, sector, size, sector, NULL) == CMOX_CIPHER_SUCCESS
+            && memcmp(sector, expected, CHECK_SIZE) == 0
+            && cmox_cipher_setIV(decrypt_cipher, tweak, TWEAK_SIZE) == CMOX_CIPHER_SUCCESS
+            && cmox_cipher_append(decrypt_cipher, sector, size, sector, NULL) == CMOX_CIPHER_SUCCESS
+            && check_sector(size);
+    sector_report(decrypt->name, size, &stats, result);
+
+    cmox_cipher_cleanup(encrypt_cipher);
+    cmox_cipher_cleanup(decrypt_cipher);
+}
+
+/**
+ * Process STREAM_SECTORS consecutive sectors in place, the buffer standing
+ * for each of them
+ */
+static bool stream(cmox_cipher_handle_t* cipher, uint32_t size)
+{
+    uint8_t tweak[TWEAK_SIZE];
+    bool result = true;
+
+    for (uint32_t i = 0; i < STREAM_SECTORS; i++) {
+        set_tweak(tweak, FIRST_SECTOR + i);
+        result &= cmox_cipher_setIV(cipher, tweak, TWEAK_SIZE) == CMOX_CIPHER_SUCCESS
+                && cmox_cipher_append(cipher, sector, size, sector, NULL) == CMOX_CIPHER_SUCCESS;
+    }
+    return result;
+}
+
+/**
+ * Wrap a 256-bit key under the KEK, unwrap it and check the integrity
+ */
+static void bench_keywrap(uint32_t kek_size)
+{
+    bench_stats_t stats;
+    uint8_t wrapped[WRAPPED_KEY_SIZE + KEYWRAP_IV_SIZE];
+    uint8_t unwrapped[WRAPPED_KEY_SIZE];
+    const uint8_t* wrapped_key = &key[sizeof(key) - WRAPPED_KEY_SIZE];
+    size_t length = 0;
+    bool result = false;
+
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = cmox_cipher_encrypt(CMOX_AESFAST_KEYWRAP_ENC_ALGO, wrapped_key, WRAPPED_KEY_SIZE, key, kek_size,
+                keywrap_iv, KEYWRAP_IV_SIZE, wrapped, &length) == CMOX_CIPHER_SUCCESS;
+    }
+    result &= length == sizeof(wrapped);
+    report_result("keywrap_wrap", WRAPPED_KEY_SIZE, &stats, result, wrapped, NULL);
+
+    bench_begin(&stats);
+    while (bench_next(&stats)) {
+        result = cmox_cipher_decrypt(CMOX_AESFAST_KEYWRAP_DEC_ALGO, wrapped, sizeof(wrapped), key, kek_size,
+                keywrap_iv, KEYWRAP_IV_SIZE, unwrapped, &length) == CMOX_CIPHER_AUTH_SUCCESS;
+    }
+    result &= length == WRAPPED_KEY_SIZE && memcmp(unwrapped, wrapped_key, WRAPPED_KEY_SIZE) == 0;
+
+    // a corrupted wrapped key must be rejected
+    wrapped[sizeof(wrapped) - 1] ^= 1;
+    result &= cmox_cipher_decrypt(CMOX_AESFAST_KEYWRAP_DEC_ALGO, wrapped, sizeof(wrapped), key, kek_size,
+            keywrap_iv, KEYWRAP_IV_SIZE, unwrapped, &length) != CMOX_CIPHER_AUTH_SUCCESS;
+    report_result("keywrap_unwrap", WRAPPED_KEY_SIZE, &stats, result, NULL, NULL);
+}
+
+/**
+ * The tweak is the sector number, a 128-bit little-endian value (IEEE 1619)
+ */
+static void set_tweak(uint8_t* tweak, uint32_t number)
+{
+    memset(tweak, 0, TWEAK_SIZE);
+    for (int i = 0; i < 4; i++) {
+        tweak[i] = number >> (8 * i);
+    }
+}
+
+static void fill_sector(uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        sector[i] = i;
+    }
+}
+
+static bool check_sector(uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        if (sector[i] != (uint8_t)i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Report the stream and its rate as a counter of the same name, in sectors
+ * per second (0 if the time is not measured)
+ * @param size the size of a sector in byte
+ */
+static void sector_report(const char* name, uint32_t size, const bench_stats_t* stats, bool result)
+{
+    uint32_t rate = 0;
+
+    report_result(name, size * STREAM_SECTORS, stats, result, NULL, NULL);
+    if (stats->median != 0) {
+        rate = ((uint64_t)SystemCoreClock * STREAM_SECTORS) / stats->median;
+    }
+    report_counter(name, rate);
+}
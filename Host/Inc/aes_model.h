@@ -0,0 +1,60 @@
+/**
+ ******************************************************************************
+ * @file    aes_model.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   register-level model of the AES peripheral of the STM32L443
+ *
+ * Model of CR, SR, DINR, DOUTR, KEYRx, IVRx and SUSPxR: a block is processed
+ * when its fourth word is written in DINR, then CCF is set and the output is
+ * read from DOUTR. ECB, CBC, CTR, the key derivation, the four GCM phases and
+ * the header and final phases of the CMAC chaining mode (CBC-MAC of the CCM)
+ * are modelled, with the data swapping, the DMA requests and the interrupt.
+ * Assumptions where the reference manual is not explicit:
+ * - the GCM init phase clears EN, the payload starts at the counter written
+ *   in IVR0 (2 for the standard GCM), the final phase takes J0 as IVR3..IVR1
+ *   followed by 1
+ * - SUSP0R..SUSP3R hold the GHASH value and SUSP4R..SUSP7R the hash key
+ * - the CBC-MAC is kept in the IV registers, the CMAC final phase outputs it
+ *   XORed with the encryption of the block written (the counter block 0)
+ * - a write to DINR while the output is not read sets WRERR, a read of DOUTR
+ *   without output sets RDERR
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef AES_MODEL_H
+#define AES_MODEL_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef struct {
+    uint32_t reads;
+    uint32_t writes;
+    uint32_t blocks;
+} aes_model_stats_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * Reset the model and install it in the host runtime, called by host_init()
+ */
+void aes_model_init(void);
+
+/**
+ * @param stats the register accesses and the blocks processed since the last
+ * aes_model_reset_stats()
+ */
+void aes_model_get_stats(aes_model_stats_t* stats);
+
+void aes_model_reset_stats(void);
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ ******************************************************************************
+ * @file    aes_ref.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   portable reference AES for the host build
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef AES_REF_H
+#define AES_REF_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+#define AES_REF_BLOCK_SIZE 16
+
+// words of the expanded key of AES-256
+#define AES_REF_ROUND_KEYS_SIZE 60
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * Expand a key, the round keys are big-endian words (FIPS-197 w[i])
+ * @param key the key
+ * @param key_size the size of the key in byte (16, 24 or 32)
+ * @param round_keys the expanded key, AES_REF_ROUND_KEYS_SIZE words
+ */
+void aes_ref_expand_key(const uint8_t* key, uint32_t key_size, uint32_t* round_keys);
+
+/**
+ * Expand a key from its last round keys (the decryption key of the hardware
+ * AES, mode 2 "key derivation")
+ * @param derived_key the last key_size bytes of the expanded key
+ * @see aes_ref_expand_key()
+ */
+void aes_ref_expand_derived_key(const uint8_t* derived_key, uint32_t key_size, uint32_t* round_keys);
+
+/**
+ * Get the last round keys of an expanded key (the key derivation)
+ * @param derived_key the last key_size bytes of the expanded key
+ */
+void aes_ref_derive_key(const uint32_t* round_keys, uint32_t key_size, uint8_t* derived_key);
+
+void aes_ref_encrypt(const uint32_t* round_keys, uint32_t key_size, const uint8_t* input, uint8_t* output);
+
+void aes_ref_decrypt(const uint32_t* round_keys, uint32_t key_size, const uint8_t* input, uint8_t* output);
+
+/**
+ * Multiply in GF(2^128) with the bit order of GCM, result = x * y
+ */
+void aes_ref_gf_multiply(const uint8_t* x, const uint8_t* y, uint8_t* result);
+
+/**
+ * Update a GHASH value, the data are padded with zeros to a block
+ * @param hash the GHASH value, updated
+ * @param hash_key the hash key H
+ */
+void aes_ref_ghash(uint8_t* hash, const uint8_t* hash_key, const uint8_t* data, uint32_t length);
+
+#endif
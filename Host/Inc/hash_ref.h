@@ -0,0 +1,78 @@
+/**
+ ******************************************************************************
+ * @file    hash_ref.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   portable reference hash functions for the host build
+ *
+ * Only the compression functions and the Keccak permutation, the padding and
+ * the streaming are done by the CMOX shim in the handles of the library.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef HASH_REF_H
+#define HASH_REF_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+// blocks of the hashes on 32-bit words (SHA-1, SHA-224, SHA-256, SM3)
+#define HASH_REF_SMALL_BLOCK_SIZE 64
+// blocks of the hashes on 64-bit words (SHA-384, SHA-512 and its truncations)
+#define HASH_REF_LARGE_BLOCK_SIZE 128
+// state of Keccak-f[1600] in bytes
+#define HASH_REF_KECCAK_SIZE 200
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef enum {
+    HASH_REF_SHA1,
+    HASH_REF_SHA224,
+    HASH_REF_SHA256,
+    HASH_REF_SM3,
+    HASH_REF_SHA384,
+    HASH_REF_SHA512,
+    HASH_REF_SHA512_224,
+    HASH_REF_SHA512_256,
+} hash_ref_md_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * Set the initial value of a hash on 32-bit words
+ * @param state 5 words for SHA-1, 8 for the others
+ */
+void hash_ref_small_init(hash_ref_md_t md, uint32_t* state);
+
+/**
+ * Process a block of HASH_REF_SMALL_BLOCK_SIZE bytes, the words are big-endian
+ */
+void hash_ref_small_compress(hash_ref_md_t md, uint32_t* state, const uint8_t* block);
+
+/**
+ * Set the initial value of a hash on 64-bit words
+ * @param state 8 words
+ */
+void hash_ref_large_init(hash_ref_md_t md, uint64_t* state);
+
+/**
+ * Process a block of HASH_REF_LARGE_BLOCK_SIZE bytes with the SHA-512
+ * compression function
+ */
+void hash_ref_large_compress(uint64_t* state, const uint8_t* block);
+
+/**
+ * Keccak-f[1600] (FIPS 202), the lanes are stored little-endian
+ * @param state HASH_REF_KECCAK_SIZE bytes
+ */
+void hash_ref_keccak(uint8_t* state);
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ ******************************************************************************
+ * @file    host.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   runtime of the host build: memory map, peripheral models and
+ *          interrupts
+ *
+ * The peripheral addresses of the STM32L443 are mapped in the process. The
+ * registers of the modelled peripherals (AES, RNG, CRC, NVIC, DWT) are on pages
+ * without access rights: each access faults, the model provides the value
+ * read, the instruction is single-stepped and the model gets the value
+ * written. The firmware, the HAL and CMSIS are compiled unchanged.
+ *
+ * The interrupts are delivered synchronously: at the end of a register
+ * access, when PRIMASK is cleared and at the end of the HAL stubs which raise
+ * them. They do not preempt each other.
+ *
+ * DWT->CYCCNT counts the accesses to the registers of the timed peripherals
+ * (the AES), so the benchmark reports the number of register accesses
+ * instead of cycles.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef HOST_H
+#define HOST_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "stm32l4xx_hal.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/**
+ * Registers of a modelled peripheral, the offsets are relative to base
+ */
+typedef struct {
+    uint32_t base;
+    uint32_t size;
+    // value read by the CPU, with the side effects of the read
+    uint32_t (*read)(uint32_t offset);
+    // value before a write (read-modify-write instructions), without side effects
+    uint32_t (*peek)(uint32_t offset);
+    // size is 1, 2 or 4 bytes, the value is aligned on the access
+    void (*write)(uint32_t offset, uint32_t value, uint32_t size);
+    // called when a DMA channel is started, can be NULL
+    void (*dma_request)(void);
+    // accesses counted by DWT->CYCCNT
+    bool timed;
+} host_peripheral_t;
+
+typedef void (*host_output_t)(const uint8_t* data, uint32_t length);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * Map the memory of the peripherals and install the models, to call once
+ * before any access
+ */
+void host_init(void);
+
+/**
+ * Install the model of a peripheral, its registers must be in a page of the
+ * memory map, the page can hold the registers of other models (AES and RNG)
+ */
+void host_add_peripheral(const host_peripheral_t* peripheral);
+
+/**
+ * Run a function on a stack below 4 GB, the HAL stores the addresses of the
+ * buffers in 32-bit registers
+ */
+void host_run(void (*function)(void));
+
+/**
+ * @return the number of accesses to the registers of the timed peripherals
+ */
+uint32_t host_get_accesses(void);
+
+/**
+ * Mark an interrupt pending, it is delivered at the next interrupt point if
+ * it is enabled in the NVIC
+ */
+void host_set_pending(IRQn_Type irq);
+
+/**
+ * Mark an interrupt pending after a short delay, as the end of a transfer
+ * running in the background: the caller returns first and the interrupt is
+ * delivered from a timer signal, also while the CPU polls a variable
+ */
+void host_set_pending_later(IRQn_Type irq);
+
+/**
+ * Set where the bytes sent on the UARTs go, stdout by default
+ * @param output the function receiving the bytes, NULL to discard them
+ */
+void host_set_output(host_output_t output);
+
+/**
+ * Send bytes to the output set by host_set_output()
+ */
+void host_output(const uint8_t* data, uint32_t length);
+
+/**
+ * Move a word from the memory to a peripheral register through the DMA
+ * channel started on this register (memory to peripheral)
+ * @param address the address of the register
+ * @param value the word read in the memory
+ * @return false if no channel has data for this register
+ */
+bool host_dma_read(uint32_t address, uint32_t* value);
+
+/**
+ * Move a word from a peripheral register to the memory through the DMA
+ * channel started on this register (peripheral to memory)
+ * @return false if no channel waits data from this register
+ */
+bool host_dma_write(uint32_t address, uint32_t value);
+
+/**
+ * Tell the peripheral models that a DMA channel has been started
+ */
+void host_dma_request(void);
+
+#endif
@@ -0,0 +1,160 @@
+/**
+ ******************************************************************************
+ * @file    host_cmsis.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   CMSIS compiler layer of the host build
+ *
+ * Included before every source (-include), it replaces cmsis_compiler.h and
+ * cmsis_gcc.h: the ARM intrinsics are written in C and PRIMASK is a variable
+ * of the host runtime, so the interrupts are delivered when it is cleared.
+ * uint32_t is unsigned long on the Cortex-M and the firmware formats it with
+ * %lu: sprintf() and snprintf() drop the l of the conversions.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef HOST_CMSIS_H
+#define HOST_CMSIS_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+// the CMSIS headers are then skipped
+#define __CMSIS_COMPILER_H
+#define __CMSIS_GCC_H
+
+#define __ASM                   __asm
+#define __INLINE                inline
+#define __STATIC_INLINE         static inline
+#define __STATIC_FORCEINLINE    static inline __attribute__((always_inline))
+#define __NO_RETURN             __attribute__((__noreturn__))
+#define __USED                  __attribute__((used))
+#define __WEAK                  __attribute__((weak))
+#define __PACKED                __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT         struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION          union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)            __attribute__((aligned(x)))
+#define __RESTRICT              __restrict
+#define __COMPILER_BARRIER()    __ASM volatile("" ::: "memory")
+
+#define __UNALIGNED_UINT16_READ(addr)           (*(const uint16_t __attribute__((aligned(1)))*)(addr))
+#define __UNALIGNED_UINT16_WRITE(addr, val)     (void)(*(uint16_t __attribute__((aligned(1)))*)(addr) = (val))
+#define __UNALIGNED_UINT32_READ(addr)           (*(const uint32_t __attribute__((aligned(1)))*)(addr))
+#define __UNALIGNED_UINT32_WRITE(addr, val)     (void)(*(uint32_t __attribute__((aligned(1)))*)(addr) = (val))
+#define __UNALIGNED_UINT32(x)                   __UNALIGNED_UINT32_READ(x)
+
+#define __NOP()     __COMPILER_BARRIER()
+#define __WFI()     __COMPILER_BARRIER()
+#define __WFE()     __COMPILER_BARRIER()
+#define __SEV()     __COMPILER_BARRIER()
+#define __BKPT(x)   __builtin_trap()
+#define __ISB()     __COMPILER_BARRIER()
+#define __DSB()     __COMPILER_BARRIER()
+#define __DMB()     __COMPILER_BARRIER()
+
+#define sprintf host_sprintf
+#define snprintf host_snprintf
+
+/* Exported variables --------------------------------------------------------*/
+
+extern volatile uint32_t host_primask;
+
+/* Exported functions --------------------------------------------------------*/
+
+void host_deliver_irqs(void);
+
+int host_sprintf(char* buffer, const char* format, ...);
+
+int host_snprintf(char* buffer, size_t size, const char* format, ...);
+
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void)
+{
+    return host_primask;
+}
+
+__STATIC_FORCEINLINE void __set_PRIMASK(uint32_t primask)
+{
+    host_primask = primask & 1;
+    if (host_primask == 0) {
+        host_deliver_irqs();
+    }
+}
+
+__STATIC_FORCEINLINE void __disable_irq(void)
+{
+    host_primask = 1;
+}
+
+__STATIC_FORCEINLINE void __enable_irq(void)
+{
+    __set_PRIMASK(0);
+}
+
+__STATIC_FORCEINLINE uint32_t __get_BASEPRI(void)
+{
+    return 0;
+}
+
+__STATIC_FORCEINLINE void __set_BASEPRI(uint32_t base_priority)
+{
+    (void)base_priority;
+}
+
+__STATIC_FORCEINLINE uint32_t __get_FPSCR(void)
+{
+    return 0;
+}
+
+__STATIC_FORCEINLINE void __set_FPSCR(uint32_t fpscr)
+{
+    (void)fpscr;
+}
+
+__STATIC_FORCEINLINE uint32_t __REV(uint32_t value)
+{
+    return __builtin_bswap32(value);
+}
+
+__STATIC_FORCEINLINE uint32_t __REV16(uint32_t value)
+{
+    return (value & 0xFF00FF00) >> 8 | (value & 0x00FF00FF) << 8;
+}
+
+__STATIC_FORCEINLINE int16_t __REVSH(int16_t value)
+{
+    return (int16_t)__builtin_bswap16((uint16_t)value);
+}
+
+__STATIC_FORCEINLINE uint32_t __ROR(uint32_t value, uint32_t shift)
+{
+    shift %= 32;
+    return shift == 0 ? value : value >> shift | value << (32 - shift);
+}
+
+__STATIC_FORCEINLINE uint32_t __RBIT(uint32_t value)
+{
+    uint32_t result = 0;
+
+    for (uint32_t i = 0; i < 32; i++) {
+        result = result << 1 | (value & 1);
+        value >>= 1;
+    }
+    return result;
+}
+
+__STATIC_FORCEINLINE uint8_t __CLZ(uint32_t value)
+{
+    return value == 0 ? 32 : __builtin_clz(value);
+}
+
+#endif
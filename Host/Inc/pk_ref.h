@@ -0,0 +1,218 @@
+/**
+ ******************************************************************************
+ * @file    pk_ref.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   portable reference arithmetic of RSA and ECC for the host build
+ *
+ * Numbers are arrays of 32-bit words, least significant first. The modular
+ * arithmetic is in the Montgomery domain, the points of the Weierstrass curves
+ * (a = -3) are in Jacobian coordinates (X, Y, Z) and the points of Ed25519 in
+ * extended coordinates (X, Y, Z, T). Every buffer is given by the caller, the
+ * CMOX shim takes them from the working buffer of the context.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef PK_REF_H
+#define PK_REF_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+// 2048 bits
+#define PK_REF_MAX_WORDS 64
+
+// words of the workspace of pk_ref_mod_init()
+#define PK_REF_MOD_WORDS(words) (3 * (words) + 2)
+
+// temporaries of the point operations
+#define PK_REF_TEMPS 14
+
+// words of the workspace of pk_ref_ec_init()
+#define PK_REF_EC_WORDS(words) (PK_REF_MOD_WORDS(words) + (1 + PK_REF_TEMPS) * (words))
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef enum {
+    PK_REF_WEIERSTRASS,
+    PK_REF_EDWARDS,
+} pk_ref_curve_type_t;
+
+/**
+ * Parameters of a curve, plain numbers of words words
+ */
+typedef struct {
+    pk_ref_curve_type_t type;
+    uint32_t words;
+    uint32_t bits;                  // of the field
+    const uint32_t* p;
+    const uint32_t* p_minus_2;      // inversion exponent
+    const uint32_t* n;              // order of the base point
+    const uint32_t* n_minus_2;
+    const uint32_t* b;              // b of Weierstrass, d of Edwards
+    const uint32_t* gx;
+    const uint32_t* gy;
+    const uint32_t* sqrt_m1;        // Edwards only, the square root of -1
+    const uint32_t* sqrt_exponent;  // Edwards only, (p - 5) / 8
+} pk_ref_curve_t;
+
+typedef struct {
+    const uint32_t* modulus;
+    uint32_t words;
+    uint32_t inverse;   // -modulus^-1 mod 2^32
+    uint32_t* one;      // R mod modulus, R = 2^(32 words)
+    uint32_t* r2;       // R^2 mod modulus
+    uint32_t* product;  // words + 2
+} pk_ref_mod_t;
+
+typedef struct {
+    const pk_ref_curve_t* curve;
+    pk_ref_mod_t field;
+    uint32_t* b;        // b or d in the Montgomery domain
+    uint32_t* t;        // PK_REF_TEMPS numbers
+} pk_ref_ec_t;
+
+/* Exported variables --------------------------------------------------------*/
+
+extern const pk_ref_curve_t pk_ref_p256;
+extern const pk_ref_curve_t pk_ref_p384;
+// the field of Ed25519 is the one of Curve25519
+extern const pk_ref_curve_t pk_ref_ed25519;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * Read a big-endian number, the bytes beyond the words are ignored
+ */
+void pk_ref_from_bytes(uint32_t* x, uint32_t words, const uint8_t* bytes, uint32_t length);
+
+/**
+ * Write a big-endian number of length bytes, padded with zeros
+ */
+void pk_ref_to_bytes(uint8_t* bytes, uint32_t length, const uint32_t* x, uint32_t words);
+
+/**
+ * @return -1, 0 or 1 as x is lower, equal or greater than y
+ */
+int pk_ref_compare(const uint32_t* x, const uint32_t* y, uint32_t words);
+
+bool pk_ref_is_zero(const uint32_t* x, uint32_t words);
+
+/**
+ * r = a + b
+ * @return the carry
+ */
+uint32_t pk_ref_add(uint32_t* r, const uint32_t* a, const uint32_t* b, uint32_t words);
+
+/**
+ * r = a * b, r of a_words + b_words, not one of the operands
+ */
+void pk_ref_multiply(uint32_t* r, const uint32_t* a, uint32_t a_words, const uint32_t* b, uint32_t b_words);
+
+/**
+ * Prepare the Montgomery arithmetic of an odd modulus
+ * @param workspace PK_REF_MOD_WORDS(words) words
+ */
+void pk_ref_mod_init(pk_ref_mod_t* mod, const uint32_t* modulus, uint32_t words, uint32_t* workspace);
+
+/**
+ * r = x mod modulus, out of the Montgomery domain
+ */
+void pk_ref_mod_reduce(const pk_ref_mod_t* mod, uint32_t* r, const uint32_t* x, uint32_t x_words);
+
+void pk_ref_mod_add(const pk_ref_mod_t* mod, uint32_t* r, const uint32_t* a, const uint32_t* b);
+
+void pk_ref_mod_sub(const pk_ref_mod_t* mod, uint32_t* r, const uint32_t* a, const uint32_t* b);
+
+/**
+ * Montgomery product r = a * b / R, r can be one of the operands
+ */
+void pk_ref_mod_mul(const pk_ref_mod_t* mod, uint32_t* r, const uint32_t* a, const uint32_t* b);
+
+/**
+ * r = a * R, a lower than the modulus
+ */
+void pk_ref_mod_to_mont(const pk_ref_mod_t* mod, uint32_t* r, const uint32_t* a);
+
+void pk_ref_mod_from_mont(const pk_ref_mod_t* mod, uint32_t* r, const uint32_t* a);
+
+/**
+ * r = a^exponent in the Montgomery domain, fixed window, the same products
+ * whatever the exponent
+ * @param r not a
+ * @param exponent_words the words of the exponent
+ * @param window the bits of the window, 1 to 6
+ * @param table 2^window numbers
+ */
+void pk_ref_mod_exp(const pk_ref_mod_t* mod, uint32_t* r, const uint32_t* a, const uint32_t* exponent,
+        uint32_t exponent_words, uint32_t window, uint32_t* table);
+
+/**
+ * Prepare the arithmetic of a curve
+ * @param workspace PK_REF_EC_WORDS(curve->words) words
+ */
+void pk_ref_ec_init(pk_ref_ec_t* ec, const pk_ref_curve_t* curve, uint32_t* workspace);
+
+/**
+ * @return the words of a point
+ */
+uint32_t pk_ref_ec_point_words(const pk_ref_ec_t* ec);
+
+/**
+ * @return true if the plain affine point is on the curve
+ */
+bool pk_ref_ec_on_curve(const pk_ref_ec_t* ec, const uint32_t* x, const uint32_t* y);
+
+void pk_ref_ec_from_affine(const pk_ref_ec_t* ec, uint32_t* point, const uint32_t* x, const uint32_t* y);
+
+/**
+ * @return false for the point at infinity of a Weierstrass curve
+ */
+bool pk_ref_ec_to_affine(const pk_ref_ec_t* ec, uint32_t* x, uint32_t* y, const uint32_t* point);
+
+void pk_ref_ec_infinity(const pk_ref_ec_t* ec, uint32_t* point);
+
+/**
+ * r = p + q, r can be one of the operands
+ */
+void pk_ref_ec_add(const pk_ref_ec_t* ec, uint32_t* r, const uint32_t* p, const uint32_t* q);
+
+void pk_ref_ec_negate(const pk_ref_ec_t* ec, uint32_t* r, const uint32_t* p);
+
+/**
+ * r = scalar * p, fixed window
+ * @param scalar curve->words words
+ * @param window the bits of the window, 1 to 6
+ * @param table 2^window points
+ */
+void pk_ref_ec_mul(const pk_ref_ec_t* ec, uint32_t* r, const uint32_t* p, const uint32_t* scalar, uint32_t window,
+        uint32_t* table);
+
+/**
+ * Encode an Edwards point (RFC 8032), y little-endian with the sign of x
+ */
+void pk_ref_ec_encode(const pk_ref_ec_t* ec, uint8_t* encoding, const uint32_t* point);
+
+/**
+ * @return false if the encoding is not a point of the curve
+ */
+bool pk_ref_ec_decode(const pk_ref_ec_t* ec, uint32_t* point, const uint8_t* encoding);
+
+/**
+ * X25519 (RFC 7748) on the field of ec, with the clamping of the scalar
+ * @param output 32 bytes
+ * @param scalar 32 bytes
+ * @param u 32 bytes
+ */
+void pk_ref_x25519(const pk_ref_ec_t* ec, uint8_t* output, const uint8_t* scalar, const uint8_t* u);
+
+#endif
@@ -0,0 +1,47 @@
+/**
+ ******************************************************************************
+ * @file    rng_model.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   register-level model of the RNG peripheral of the STM32L443
+ *
+ * Model of CR, SR and DR: while RNGEN is set and no seed error is pending, a
+ * new word is ready at once (DRDY), the words are a fixed pseudo-random
+ * sequence so the runs are reproducible. The interrupt is raised on the
+ * rising edge of DRDY, CEIS or SEIS when IE is set. Errors are injected by the
+ * tests: a seed error clears DRDY until RNGEN is cleared and set again, a
+ * clock error is only flagged. CEIS and SEIS are cleared by writing 0.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef RNG_MODEL_H
+#define RNG_MODEL_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * Reset the model and install it in the host runtime, called by host_init()
+ */
+void rng_model_init(void);
+
+/**
+ * Raise an error of the entropy source
+ * @param flags RNG_SR_SEIS for a seed error, RNG_SR_CEIS for a clock error
+ */
+void rng_model_inject_error(uint32_t flags);
+
+/**
+ * @return the number of words read from DR since rng_model_init()
+ */
+uint32_t rng_model_get_words(void);
+
+#endif
@@ -0,0 +1,580 @@
+/**
+ ******************************************************************************
+ * @file    aes_model.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   register-level model of the AES peripheral of the STM32L443
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "stm32l4xx_hal.h"
+
+#include "aes_model.h"
+#include "aes_ref.h"
+#include "host.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define REGISTERS_SIZE 0x400
+
+#define CR_OFFSET offsetof(AES_TypeDef, CR)
+#define SR_OFFSET offsetof(AES_TypeDef, SR)
+#define DINR_OFFSET offsetof(AES_TypeDef, DINR)
+#define DOUTR_OFFSET offsetof(AES_TypeDef, DOUTR)
+#define KEYR0_OFFSET offsetof(AES_TypeDef, KEYR0)
+#define IVR0_OFFSET offsetof(AES_TypeDef, IVR0)
+#define KEYR4_OFFSET offsetof(AES_TypeDef, KEYR4)
+#define SUSP0R_OFFSET offsetof(AES_TypeDef, SUSP0R)
+
+#define BLOCK_WORDS 4
+#define KEY_WORDS 8
+
+#define MODE_ENCRYPT 0
+#define MODE_KEY_DERIVATION AES_CR_MODE_0
+#define MODE_DECRYPT AES_CR_MODE_1
+#define MODE_KEY_DERIVATION_DECRYPT AES_CR_MODE
+
+#define CHAINING_ECB 0
+#define CHAINING_CBC AES_CR_CHMOD_0
+#define CHAINING_CTR AES_CR_CHMOD_1
+#define CHAINING_GCM (AES_CR_CHMOD_0 | AES_CR_CHMOD_1)
+#define CHAINING_CMAC AES_CR_CHMOD_2
+
+#define PHASE_INIT 0
+#define PHASE_HEADER AES_CR_GCMPH_0
+#define PHASE_PAYLOAD AES_CR_GCMPH_1
+#define PHASE_FINAL AES_CR_GCMPH
+
+#define DATATYPE_16B AES_CR_DATATYPE_0
+#define DATATYPE_8B AES_CR_DATATYPE_1
+#define DATATYPE_1B AES_CR_DATATYPE
+
+/* Private variables ---------------------------------------------------------*/
+
+static uint32_t cr;
+static uint32_t sr;
+static uint32_t key_registers[KEY_WORDS]; // KEYR0..KEYR7
+static uint32_t iv_registers[BLOCK_WORDS]; // IVR0..IVR3
+
+// the words of the block being written and of the block to read, internal
+// order (after the data swapping), the first word is the most significant
+static uint32_t input[BLOCK_WORDS];
+static uint32_t input_count;
+static uint32_t output[BLOCK_WORDS];
+static uint32_t output_count; // words not read yet
+
+static uint32_t round_keys[AES_REF_ROUND_KEYS_SIZE];
+static bool round_keys_valid;
+static bool round_keys_derived;
+
+// GCM context
+static uint8_t hash_key[AES_REF_BLOCK_SIZE];
+static uint8_t hash[AES_REF_BLOCK_SIZE];
+
+static bool irq_line;
+static aes_model_stats_t stats;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint32_t aes_read(uint32_t offset);
+static uint32_t aes_peek(uint32_t offset);
+static void aes_write(uint32_t offset, uint32_t value, uint32_t size);
+static void aes_dma_request(void);
+static void write_control(uint32_t value);
+static void write_input(uint32_t value);
+static void start(void);
+static void process_block(void);
+static void complete(const uint8_t* result);
+static void dma_process(void);
+static void update_irq(void);
+static uint32_t key_size(void);
+static void load_round_keys(bool derived);
+static void get_key(uint8_t* key);
+static void set_key(const uint8_t* key);
+static void get_counter(uint8_t* counter);
+static void increment_counter(void);
+static uint32_t swap(uint32_t value);
+static void words_to_bytes(const uint32_t* words, uint8_t* bytes, uint32_t number);
+static void bytes_to_words(const uint8_t* bytes, uint32_t* words, uint32_t number);
+static void xor_block(uint8_t* result, const uint8_t* x, const uint8_t* y);
+
+static const host_peripheral_t aes_peripheral = {
+    .base = AES_BASE,
+    .size = REGISTERS_SIZE,
+    .read = aes_read,
+    .peek = aes_peek,
+    .write = aes_write,
+    .dma_request = aes_dma_request,
+    .timed = true,
+};
+
+/* Public functions ----------------------------------------------------------*/
+
+void aes_model_init(void)
+{
+    cr = 0;
+    sr = 0;
+    memset(key_registers, 0, sizeof(key_registers));
+    memset(iv_registers, 0, sizeof(iv_registers));
+    input_count = 0;
+    output_count = 0;
+    round_keys_valid = false;
+    memset(hash_key, 0, sizeof(hash_key));
+    memset(hash, 0, sizeof(hash));
+    irq_line = false;
+    aes_model_reset_stats();
+
+    host_add_peripheral(&aes_peripheral);
+}
+
+void aes_model_get_stats(aes_model_stats_t* result)
+{
+    *result = stats;
+}
+
+void aes_model_reset_stats(void)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t aes_read(uint32_t offset)
+{
+    uint32_t value = aes_peek(offset);
+
+    stats.reads++;
+
+    if (offset == DOUTR_OFFSET) {
+        if (output_count == 0) {
+            sr |= AES_SR_RDERR;
+        } else {
+            output_count--;
+        }
+        dma_process();
+        update_irq();
+    }
+    return value;
+}
+
+static uint32_t aes_peek(uint32_t offset)
+{
+    switch (offset) {
+    case CR_OFFSET:
+        return cr;
+    case SR_OFFSET:
+        return sr;
+    case DOUTR_OFFSET:
+        return output_count > 0 ? swap(output[BLOCK_WORDS - output_count]) : 0;
+    }
+
+    if (offset >= KEYR0_OFFSET && offset < IVR0_OFFSET) {
+        return key_registers[(offset - KEYR0_OFFSET) / 4];
+    }
+    if (offset >= IVR0_OFFSET && offset < KEYR4_OFFSET) {
+        return iv_registers[(offset - IVR0_OFFSET) / 4];
+    }
+    if (offset >= KEYR4_OFFSET && offset < SUSP0R_OFFSET) {
+        return key_registers[4 + (offset - KEYR4_OFFSET) / 4];
+    }
+    if (offset >= SUSP0R_OFFSET && offset < SUSP0R_OFFSET + 4 * BLOCK_WORDS) {
+        uint32_t word;
+        bytes_to_words(&hash[offset - SUSP0R_OFFSET], &word, 1);
+        return word;
+    }
+    if (offset >= SUSP0R_OFFSET + 4 * BLOCK_WORDS && offset < SUSP0R_OFFSET + 8 * BLOCK_WORDS) {
+        uint32_t word;
+        bytes_to_words(&hash_key[offset - SUSP0R_OFFSET - 4 * BLOCK_WORDS], &word, 1);
+        return word;
+    }
+    return 0;
+}
+
+static void aes_write(uint32_t offset, uint32_t value, uint32_t size)
+{
+    (void)size;
+
+    stats.writes++;
+    offset &= ~3U;
+
+    if (offset == CR_OFFSET) {
+        write_control(value);
+    } else if (offset == DINR_OFFSET) {
+        write_input(swap(value));
+    } else if (offset >= KEYR0_OFFSET && offset < IVR0_OFFSET) {
+        key_registers[(offset - KEYR0_OFFSET) / 4] = value;
+        round_keys_valid = false;
+    } else if (offset >= IVR0_OFFSET && offset < KEYR4_OFFSET) {
+        iv_registers[(offset - IVR0_OFFSET) / 4] = value;
+    } else if (offset >= KEYR4_OFFSET && offset < SUSP0R_OFFSET) {
+        key_registers[4 + (offset - KEYR4_OFFSET) / 4] = value;
+        round_keys_valid = false;
+    } else if (offset >= SUSP0R_OFFSET && offset < SUSP0R_OFFSET + 4 * BLOCK_WORDS) {
+        words_to_bytes(&value, &hash[offset - SUSP0R_OFFSET], 1);
+    } else if (offset >= SUSP0R_OFFSET + 4 * BLOCK_WORDS && offset < SUSP0R_OFFSET + 8 * BLOCK_WORDS) {
+        words_to_bytes(&value, &hash_key[offset - SUSP0R_OFFSET - 4 * BLOCK_WORDS], 1);
+    }
+    // SR and DOUTR are read-only
+
+    dma_process();
+    update_irq();
+}
+
+static void aes_dma_request(void)
+{
+    dma_process();
+    update_irq();
+}
+
+static void write_control(uint32_t value)
+{
+    uint32_t previous = cr;
+
+    if (value & AES_CR_CCFC) {
+        sr &= ~AES_SR_CCF;
+    }
+    if (value & AES_CR_ERRC) {
+        sr &= ~(AES_SR_RDERR | AES_SR_WRERR);
+    }
+
+    cr = value & ~(AES_CR_CCFC | AES_CR_ERRC);
+    if ((previous ^ cr) & AES_CR_KEYSIZE) {
+        round_keys_valid = false;
+    }
+
+    if ((cr & AES_CR_EN) == 0) {
+        // disabling the peripheral flushes the data
+        input_count = 0;
+        output_count = 0;
+    } else if ((previous & AES_CR_EN) == 0) {
+        start();
+    }
+}
+
+static void write_input(uint32_t value)
+{
+    if ((cr & AES_CR_EN) == 0) {
+        return;
+    }
+    if (output_count > 0) {
+        // the output of the previous block must be read first
+        sr |= AES_SR_WRERR;
+        return;
+    }
+
+    input[input_count++] = value;
+    if (input_count == BLOCK_WORDS) {
+        input_count = 0;
+        process_block();
+    }
+}
+
+/**
+ * The operations started by EN: the key derivation and the GCM init phase
+ */
+static void start(void)
+{
+    uint32_t mode = cr & AES_CR_MODE;
+    uint32_t chaining = cr & AES_CR_CHMOD;
+    uint32_t phase = cr & AES_CR_GCMPH;
+
+    if (mode == MODE_KEY_DERIVATION) {
+        uint8_t derived_key[2 * AES_REF_BLOCK_SIZE];
+
+        load_round_keys(false);
+        aes_ref_derive_key(round_keys, key_size(), derived_key);
+        set_key(derived_key);
+        complete(NULL);
+        return;
+    }
+
+    if (chaining == CHAINING_GCM && phase == PHASE_INIT) {
+        uint8_t zero[AES_REF_BLOCK_SIZE] = {0};
+
+        load_round_keys(false);
+        aes_ref_encrypt(round_keys, key_size(), zero, hash_key);
+        memset(hash, 0, sizeof(hash));
+
+        cr &= ~AES_CR_EN;
+        complete(NULL);
+    }
+}
+
+static void process_block(void)
+{
+    uint32_t mode = cr & AES_CR_MODE;
+    uint32_t chaining = cr & AES_CR_CHMOD;
+    uint32_t phase = cr & AES_CR_GCMPH;
+    bool decrypt = mode == MODE_DECRYPT || mode == MODE_KEY_DERIVATION_DECRYPT;
+    uint8_t in[AES_REF_BLOCK_SIZE];
+    uint8_t out[AES_REF_BLOCK_SIZE];
+    uint8_t block[AES_REF_BLOCK_SIZE];
+
+    words_to_bytes(input, in, BLOCK_WORDS);
+    memset(out, 0, sizeof(out));
+    stats.blocks++;
+
+    switch (chaining) {
+    case CHAINING_ECB:
+        // mode 3 expects the decryption key, mode 4 derives it
+        load_round_keys(mode == MODE_DECRYPT);
+        if (decrypt) {
+            aes_ref_decrypt(round_keys, key_size(), in, out);
+        } else {
+            aes_ref_encrypt(round_keys, key_size(), in, out);
+        }
+        break;
+
+    case CHAINING_CBC:
+        load_round_keys(mode == MODE_DECRYPT);
+        get_counter(block);
+        if (decrypt) {
+            aes_ref_decrypt(round_keys, key_size(), in, out);
+            xor_block(out, out, block);
+            bytes_to_words(in, input, BLOCK_WORDS);
+        } else {
+            xor_block(block, block, in);
+            aes_ref_encrypt(round_keys, key_size(), block, out);
+            bytes_to_words(out, input, BLOCK_WORDS);
+        }
+        // the chaining value is kept in the IV registers
+        for (uint32_t i = 0; i < BLOCK_WORDS; i++) {
+            iv_registers[i] = input[BLOCK_WORDS - 1 - i];
+        }
+        break;
+
+    case CHAINING_CTR:
+        load_round_keys(false);
+        get_counter(block);
+        aes_ref_encrypt(round_keys, key_size(), block, block);
+        xor_block(out, in, block);
+        increment_counter();
+        break;
+
+    case CHAINING_GCM:
+        load_round_keys(false);
+        if (phase == PHASE_HEADER) {
+            aes_ref_ghash(hash, hash_key, in, AES_REF_BLOCK_SIZE);
+            complete(NULL);
+            return;
+        }
+        if (phase == PHASE_PAYLOAD) {
+            get_counter(block);
+            aes_ref_encrypt(round_keys, key_size(), block, block);
+            xor_block(out, in, block);
+            increment_counter();
+            aes_ref_ghash(hash, hash_key, decrypt ? in : out, AES_REF_BLOCK_SIZE);
+        } else if (phase == PHASE_FINAL) {
+            // the lengths block, or the last partial block of the GCM
+            // encryption of the HAL workaround
+            aes_ref_ghash(hash, hash_key, in, AES_REF_BLOCK_SIZE);
+            // J0, from the IV registers so a restored context gives the tag
+            get_counter(block);
+            block[AES_REF_BLOCK_SIZE - 4] = 0;
+            block[AES_REF_BLOCK_SIZE - 3] = 0;
+            block[AES_REF_BLOCK_SIZE - 2] = 0;
+            block[AES_REF_BLOCK_SIZE - 1] = 1;
+            aes_ref_encrypt(round_keys, key_size(), block, block);
+            xor_block(out, hash, block);
+        } else {
+            complete(NULL);
+            return;
+        }
+        break;
+
+    case CHAINING_CMAC:
+        // CBC-MAC of the CCM, the MAC is the chaining value in the IV registers
+        load_round_keys(false);
+        get_counter(block);
+        if (phase == PHASE_HEADER) {
+            xor_block(block, block, in);
+            aes_ref_encrypt(round_keys, key_size(), block, block);
+            bytes_to_words(block, input, BLOCK_WORDS);
+            for (uint32_t i = 0; i < BLOCK_WORDS; i++) {
+                iv_registers[i] = input[BLOCK_WORDS - 1 - i];
+            }
+            complete(NULL);
+            return;
+        }
+        if (phase == PHASE_FINAL) {
+            // the block written is the counter block 0, it encrypts the MAC
+            aes_ref_encrypt(round_keys, key_size(), in, out);
+            xor_block(out, out, block);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    complete(out);
+}
+
+/**
+ * End of a computation, the output is available and CCF set
+ * @param result the output block, NULL if the computation has no output
+ */
+static void complete(const uint8_t* result)
+{
+    if (result != NULL) {
+        bytes_to_words(result, output, BLOCK_WORDS);
+        output_count = BLOCK_WORDS;
+    }
+    sr |= AES_SR_CCF;
+}
+
+/**
+ * Move the data requested by the peripheral through the DMA channels started
+ * on DINR and DOUTR
+ */
+static void dma_process(void)
+{
+    bool progress = true;
+
+    while (progress) {
+        progress = false;
+
+        if ((cr & AES_CR_DMAOUTEN) && output_count > 0
+                && host_dma_write(AES_BASE + DOUTR_OFFSET, swap(output[BLOCK_WORDS - output_count]))) {
+            output_count--;
+            progress = true;
+        }
+
+        uint32_t value;
+        if ((cr & AES_CR_EN) && (cr & AES_CR_DMAINEN) && output_count == 0
+                && host_dma_read(AES_BASE + DINR_OFFSET, &value)) {
+            write_input(swap(value));
+            progress = true;
+        }
+    }
+}
+
+/**
+ * The AES interrupt is raised on the rising edge of its sources
+ */
+static void update_irq(void)
+{
+    bool line = ((sr & AES_SR_CCF) && (cr & AES_CR_CCFIE))
+            || ((sr & (AES_SR_RDERR | AES_SR_WRERR)) && (cr & AES_CR_ERRIE));
+
+    if (line && !irq_line) {
+        host_set_pending(AES_IRQn);
+    }
+    irq_line = line;
+}
+
+static uint32_t key_size(void)
+{
+    return (cr & AES_CR_KEYSIZE) ? 32 : 16;
+}
+
+/**
+ * Expand the key of the key registers
+ * @param derived true if the key registers contain the decryption key (the
+ * last round keys)
+ */
+static void load_round_keys(bool derived)
+{
+    uint8_t key[2 * AES_REF_BLOCK_SIZE];
+
+    if (round_keys_valid && round_keys_derived == derived) {
+        return;
+    }
+
+    get_key(key);
+    if (derived) {
+        aes_ref_expand_derived_key(key, key_size(), round_keys);
+    } else {
+        aes_ref_expand_key(key, key_size(), round_keys);
+    }
+    round_keys_valid = true;
+    round_keys_derived = derived;
+}
+
+/**
+ * The key in memory order: KEYR3 (or KEYR7 for 256 bits) is the first word
+ */
+static void get_key(uint8_t* key)
+{
+    uint32_t words = key_size() / 4;
+
+    for (uint32_t i = 0; i < words; i++) {
+        uint32_t index = i < 4 && words == 8 ? 7 - i : (words - 1 - i) % 4;
+        words_to_bytes(&key_registers[index], &key[4 * i], 1);
+    }
+}
+
+static void set_key(const uint8_t* key)
+{
+    uint32_t words = key_size() / 4;
+
+    for (uint32_t i = 0; i < words; i++) {
+        uint32_t index = i < 4 && words == 8 ? 7 - i : (words - 1 - i) % 4;
+        bytes_to_words(&key[4 * i], &key_registers[index], 1);
+    }
+    round_keys_valid = false;
+}
+
+/**
+ * The IV in memory order: IVR3 is the first word
+ */
+static void get_counter(uint8_t* counter)
+{
+    for (uint32_t i = 0; i < BLOCK_WORDS; i++) {
+        words_to_bytes(&iv_registers[BLOCK_WORDS - 1 - i], &counter[4 * i], 1);
+    }
+}
+
+static void increment_counter(void)
+{
+    // 32-bit counter
+    iv_registers[0]++;
+}
+
+static uint32_t swap(uint32_t value)
+{
+    switch (cr & AES_CR_DATATYPE) {
+    case DATATYPE_16B:
+        return value << 16 | value >> 16;
+    case DATATYPE_8B:
+        return __REV(value);
+    case DATATYPE_1B:
+        return __RBIT(value);
+    default:
+        return value;
+    }
+}
+
+static void words_to_bytes(const uint32_t* words, uint8_t* bytes, uint32_t number)
+{
+    for (uint32_t i = 0; i < number; i++) {
+        bytes[4*i] = words[i] >> 24;
+        bytes[4*i + 1] = words[i] >> 16;
+        bytes[4*i + 2] = words[i] >> 8;
+        bytes[4*i + 3] = words[i];
+    }
+}
+
+static void bytes_to_words(const uint8_t* bytes, uint32_t* words, uint32_t number)
+{
+    for (uint32_t i = 0; i < number; i++) {
+        words[i] = (uint32_t)bytes[4*i] << 24 | (uint32_t)bytes[4*i + 1] << 16 | (uint32_t)bytes[4*i + 2] << 8 | bytes[4*i + 3];
+    }
+}
+
+static void xor_block(uint8_t* result, const uint8_t* x, const uint8_t* y)
+{
+    for (uint32_t i = 0; i < AES_REF_BLOCK_SIZE; i++) {
+        result[i] = x[i] ^ y[i];
+    }
+}
@@ -0,0 +1,277 @@
+/**
+ ******************************************************************************
+ * @file    aes_ref.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   portable reference AES for the host build
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "aes_ref.h"
+
+/* Private define ------------------------------------------------------------*/
+
+// GCM reduction polynomial x^128 + x^7 + x^2 + x + 1, bit-reflected
+#define GF_REDUCTION 0xE1
+
+/* Private variables ---------------------------------------------------------*/
+
+static const uint8_t sbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+
+static uint8_t inverse_sbox[256];
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void init_inverse_sbox(void);
+static uint32_t rounds_of(uint32_t key_size);
+static uint32_t key_schedule_core(uint32_t index, uint32_t words, uint32_t previous);
+static uint32_t sub_word(uint32_t word);
+static uint8_t multiply(uint8_t x, uint8_t y);
+static void add_round_key(uint8_t* state, const uint32_t* round_key);
+
+/* Public functions ----------------------------------------------------------*/
+
+void aes_ref_expand_key(const uint8_t* key, uint32_t key_size, uint32_t* round_keys)
+{
+    uint32_t words = key_size / 4;
+    uint32_t total = 4 * (rounds_of(key_size) + 1);
+
+    for (uint32_t i = 0; i < words; i++) {
+        round_keys[i] = (uint32_t)key[4*i] << 24 | (uint32_t)key[4*i + 1] << 16 | (uint32_t)key[4*i + 2] << 8 | key[4*i + 3];
+    }
+    for (uint32_t i = words; i < total; i++) {
+        round_keys[i] = round_keys[i - words] ^ key_schedule_core(i, words, round_keys[i - 1]);
+    }
+}
+
+void aes_ref_expand_derived_key(const uint8_t* derived_key, uint32_t key_size, uint32_t* round_keys)
+{
+    uint32_t words = key_size / 4;
+    uint32_t total = 4 * (rounds_of(key_size) + 1);
+
+    for (uint32_t i = 0; i < words; i++) {
+        const uint8_t* bytes = &derived_key[4 * i];
+        round_keys[total - words + i] = (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 8 | bytes[3];
+    }
+    // w[i - Nk] = w[i] ^ f(w[i - 1]), from the end
+    for (uint32_t i = total - 1; i >= words; i--) {
+        round_keys[i - words] = round_keys[i] ^ key_schedule_core(i, words, round_keys[i - 1]);
+    }
+}
+
+void aes_ref_derive_key(const uint32_t* round_keys, uint32_t key_size, uint8_t* derived_key)
+{
+    uint32_t words = key_size / 4;
+    uint32_t total = 4 * (rounds_of(key_size) + 1);
+
+    for (uint32_t i = 0; i < words; i++) {
+        uint32_t word = round_keys[total - words + i];
+        derived_key[4*i] = word >> 24;
+        derived_key[4*i + 1] = word >> 16;
+        derived_key[4*i + 2] = word >> 8;
+        derived_key[4*i + 3] = word;
+    }
+}
+
+void aes_ref_encrypt(const uint32_t* round_keys, uint32_t key_size, const uint8_t* input, uint8_t* output)
+{
+    uint32_t rounds = rounds_of(key_size);
+    uint8_t state[AES_REF_BLOCK_SIZE];
+    uint8_t temp[AES_REF_BLOCK_SIZE];
+
+    memcpy(state, input, AES_REF_BLOCK_SIZE);
+    add_round_key(state, round_keys);
+
+    for (uint32_t round = 1; round <= rounds; round++) {
+        // SubBytes and ShiftRows, the state is column-major
+        for (uint32_t i = 0; i < AES_REF_BLOCK_SIZE; i++) {
+            uint32_t row = i % 4;
+            uint32_t column = i / 4;
+            temp[i] = sbox[state[((column + row) % 4) * 4 + row]];
+        }
+
+        if (round != rounds) {
+            // MixColumns
+            for (uint32_t column = 0; column < 4; column++) {
+                uint8_t* c = &temp[4 * column];
+                uint8_t a0 = c[0], a1 = c[1], a2 = c[2], a3 = c[3];
+                state[4*column] = multiply(a0, 2) ^ multiply(a1, 3) ^ a2 ^ a3;
+                state[4*column + 1] = a0 ^ multiply(a1, 2) ^ multiply(a2, 3) ^ a3;
+                state[4*column + 2] = a0 ^ a1 ^ multiply(a2, 2) ^ multiply(a3, 3);
+                state[4*column + 3] = multiply(a0, 3) ^ a1 ^ a2 ^ multiply(a3, 2);
+            }
+        } else {
+            memcpy(state, temp, AES_REF_BLOCK_SIZE);
+        }
+        add_round_key(state, &round_keys[4 * round]);
+    }
+
+    memcpy(output, state, AES_REF_BLOCK_SIZE);
+}
+
+void aes_ref_decrypt(const uint32_t* round_keys, uint32_t key_size, const uint8_t* input, uint8_t* output)
+{
+    uint32_t rounds = rounds_of(key_size);
+    uint8_t state[AES_REF_BLOCK_SIZE];
+    uint8_t temp[AES_REF_BLOCK_SIZE];
+
+    init_inverse_sbox();
+
+    memcpy(state, input, AES_REF_BLOCK_SIZE);
+    add_round_key(state, &round_keys[4 * rounds]);
+
+    for (uint32_t round = rounds; round > 0; round--) {
+        // InvShiftRows and InvSubBytes
+        for (uint32_t i = 0; i < AES_REF_BLOCK_SIZE; i++) {
+            uint32_t row = i % 4;
+            uint32_t column = i / 4;
+            temp[((column + row) % 4) * 4 + row] = inverse_sbox[state[i]];
+        }
+        memcpy(state, temp, AES_REF_BLOCK_SIZE);
+        add_round_key(state, &round_keys[4 * (round - 1)]);
+
+        if (round != 1) {
+            // InvMixColumns
+            for (uint32_t column = 0; column < 4; column++) {
+                uint8_t* c = &state[4 * column];
+                uint8_t a0 = c[0], a1 = c[1], a2 = c[2], a3 = c[3];
+                c[0] = multiply(a0, 14) ^ multiply(a1, 11) ^ multiply(a2, 13) ^ multiply(a3, 9);
+                c[1] = multiply(a0, 9) ^ multiply(a1, 14) ^ multiply(a2, 11) ^ multiply(a3, 13);
+                c[2] = multiply(a0, 13) ^ multiply(a1, 9) ^ multiply(a2, 14) ^ multiply(a3, 11);
+                c[3] = multiply(a0, 11) ^ multiply(a1, 13) ^ multiply(a2, 9) ^ multiply(a3, 14);
+            }
+        }
+    }
+
+    memcpy(output, state, AES_REF_BLOCK_SIZE);
+}
+
+void aes_ref_gf_multiply(const uint8_t* x, const uint8_t* y, uint8_t* result)
+{
+    uint8_t z[AES_REF_BLOCK_SIZE] = {0};
+    uint8_t v[AES_REF_BLOCK_SIZE];
+
+    memcpy(v, y, AES_REF_BLOCK_SIZE);
+
+    for (uint32_t i = 0; i < 128; i++) {
+        if (x[i / 8] & (0x80 >> (i % 8))) {
+            for (uint32_t j = 0; j < AES_REF_BLOCK_SIZE; j++) {
+                z[j] ^= v[j];
+            }
+        }
+        // v = v * x, the bits are reflected
+        uint8_t carry = v[AES_REF_BLOCK_SIZE - 1] & 1;
+        for (uint32_t j = AES_REF_BLOCK_SIZE - 1; j > 0; j--) {
+            v[j] = (v[j] >> 1) | (v[j - 1] << 7);
+        }
+        v[0] >>= 1;
+        if (carry) {
+            v[0] ^= GF_REDUCTION;
+        }
+    }
+
+    memcpy(result, z, AES_REF_BLOCK_SIZE);
+}
+
+void aes_ref_ghash(uint8_t* hash, const uint8_t* hash_key, const uint8_t* data, uint32_t length)
+{
+    while (length > 0) {
+        uint32_t chunk = length < AES_REF_BLOCK_SIZE ? length : AES_REF_BLOCK_SIZE;
+        for (uint32_t i = 0; i < chunk; i++) {
+            hash[i] ^= data[i];
+        }
+        aes_ref_gf_multiply(hash, hash_key, hash);
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void init_inverse_sbox(void)
+{
+    if (inverse_sbox[0x63] != 0) {
+        return;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        inverse_sbox[sbox[i]] = i;
+    }
+}
+
+static uint32_t rounds_of(uint32_t key_size)
+{
+    return key_size / 4 + 6;
+}
+
+/**
+ * @return the word xored to w[index - words] to get w[index]
+ */
+static uint32_t key_schedule_core(uint32_t index, uint32_t words, uint32_t previous)
+{
+    static const uint8_t rcon[] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36};
+
+    if (index % words == 0) {
+        uint32_t rotated = previous << 8 | previous >> 24;
+        return sub_word(rotated) ^ (uint32_t)rcon[index / words - 1] << 24;
+    }
+    if (words > 6 && index % words == 4) {
+        return sub_word(previous);
+    }
+    return previous;
+}
+
+static uint32_t sub_word(uint32_t word)
+{
+    return (uint32_t)sbox[word >> 24] << 24 | (uint32_t)sbox[(word >> 16) & 0xFF] << 16
+            | (uint32_t)sbox[(word >> 8) & 0xFF] << 8 | sbox[word & 0xFF];
+}
+
+static uint8_t multiply(uint8_t x, uint8_t y)
+{
+    uint8_t result = 0;
+
+    while (y != 0) {
+        if (y & 1) {
+            result ^= x;
+        }
+        x = (x << 1) ^ (x & 0x80 ? 0x1b : 0);
+        y >>= 1;
+    }
+    return result;
+}
+
+static void add_round_key(uint8_t* state, const uint32_t* round_key)
+{
+    for (uint32_t i = 0; i < 4; i++) {
+        state[4*i] ^= round_key[i] >> 24;
+        state[4*i + 1] ^= round_key[i] >> 16;
+        state[4*i + 2] ^= round_key[i] >> 8;
+        state[4*i + 3] ^= round_key[i];
+    }
+}
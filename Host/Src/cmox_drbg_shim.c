@@ -0,0 +1,330 @@
+/**
+ ******************************************************************************
+ * @file    cmox_drbg_shim.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   DRBG part of the CMOX API for the host build
+ *
+ * The CTR-DRBG of NIST SP 800-90A with the derivation function, on top of the
+ * reference AES. The FAST and SMALL variants are the same code. The entropy
+ * must be of the key size at least and the nonce of half of it, a request is
+ * limited to 64 KB and the reseed is needed after 2^48 requests.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "cmox_crypto.h"
+
+#include "aes_ref.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define BLOCK_SIZE AES_REF_BLOCK_SIZE
+#define MAX_KEY_SIZE 32
+#define MAX_SEED_SIZE (MAX_KEY_SIZE + BLOCK_SIZE)
+#define MAX_REQUEST_SIZE 65536 // 2^19 bits
+#define RESEED_INTERVAL ((uint64_t)1 << 48)
+#define DF_INPUTS 3
+#define DF_LENGTH_SIZE 4
+#define DF_END 0x80
+#define FLAG_INSTANTIATED 1
+
+#define CTR_DRBG_IMPL(name, key_size) \
+    static const struct cmox_ctr_drbg_implStruct_st name##_struct = {{key_size}}; \
+    const cmox_ctr_drbg_impl_t name = &name##_struct
+
+/* Private typedef -----------------------------------------------------------*/
+
+struct cmox_drbg_vtableStruct_st {
+    uint32_t key_size;
+};
+
+struct cmox_ctr_drbg_implStruct_st {
+    struct cmox_drbg_vtableStruct_st vtable;
+};
+
+/**
+ * CBC-MAC of the derivation function, the data are given in pieces
+ */
+typedef struct {
+    const uint32_t* round_keys;
+    uint32_t key_size;
+    uint8_t chaining[BLOCK_SIZE];
+    uint32_t used; // bytes of the current block
+} bcc_t;
+
+/* Exported variables --------------------------------------------------------*/
+
+CTR_DRBG_IMPL(CMOX_CTR_DRBG_AES128_SMALL, 16);
+CTR_DRBG_IMPL(CMOX_CTR_DRBG_AES128_FAST, 16);
+CTR_DRBG_IMPL(CMOX_CTR_DRBG_AES256_SMALL, 32);
+CTR_DRBG_IMPL(CMOX_CTR_DRBG_AES256_FAST, 32);
+
+/* Private function prototypes -----------------------------------------------*/
+
+static cmox_ctr_drbg_handle_t* get_handle(cmox_drbg_handle_t* drbg);
+static void derive(const cmox_ctr_drbg_handle_t* handle, const uint8_t* const* inputs, const size_t* lengths,
+        uint8_t* seed);
+static void bcc_append(bcc_t* bcc, const uint8_t* data, size_t length);
+static void update(cmox_ctr_drbg_handle_t* handle, const uint8_t* provided);
+static void next_block(cmox_ctr_drbg_handle_t* handle, const uint32_t* round_keys, uint8_t* block);
+static void increment(uint8_t* counter);
+
+/* Public functions ----------------------------------------------------------*/
+
+cmox_drbg_handle_t *cmox_ctr_drbg_construct(cmox_ctr_drbg_handle_t *P_pThis, cmox_ctr_drbg_impl_t P_impl)
+{
+    if (P_pThis == NULL || P_impl == NULL) {
+        return NULL;
+    }
+    memset(P_pThis, 0, sizeof(*P_pThis));
+    P_pThis->super.table = &P_impl->vtable;
+    P_pThis->keyLen = P_impl->vtable.key_size;
+    P_pThis->minEntropyLen = P_impl->vtable.key_size;
+    P_pThis->maxBytesPerRequest = MAX_REQUEST_SIZE;
+    return &P_pThis->super;
+}
+
+cmox_drbg_retval_t cmox_drbg_cleanup(cmox_drbg_handle_t *P_pThis)
+{
+    cmox_ctr_drbg_handle_t* handle = get_handle(P_pThis);
+
+    if (handle == NULL) {
+        return CMOX_DRBG_ERR_BAD_PARAMETER;
+    }
+    memset(handle, 0, sizeof(*handle));
+    return CMOX_DRBG_SUCCESS;
+}
+
+cmox_drbg_retval_t cmox_drbg_init(cmox_drbg_handle_t *P_pThis, const uint8_t *P_pEntropy, size_t P_entropyLen,
+        const uint8_t *P_pPersonalString, size_t P_personalStringLen, const uint8_t *P_pNonce, size_t P_nonceLen)
+{
+    cmox_ctr_drbg_handle_t* handle = get_handle(P_pThis);
+    uint8_t seed[MAX_SEED_SIZE];
+
+    if (handle == NULL) {
+        return CMOX_DRBG_ERR_BAD_PARAMETER;
+    }
+    if (P_pEntropy == NULL || P_entropyLen < handle->minEntropyLen) {
+        return CMOX_DRBG_ERR_BAD_ENTROPY_SIZE;
+    }
+    if (P_pNonce == NULL || P_nonceLen < handle->keyLen / 2) {
+        return CMOX_DRBG_ERR_BAD_NONCE_SIZE;
+    }
+    if (P_pPersonalString == NULL && P_personalStringLen > 0) {
+        return CMOX_DRBG_ERR_BAD_PERS_STR_LEN;
+    }
+
+    // seed material = entropy || nonce || personalization string
+    const uint8_t* inputs[DF_INPUTS] = {P_pEntropy, P_pNonce, P_pPersonalString};
+    const size_t lengths[DF_INPUTS] = {P_entropyLen, P_nonceLen, P_personalStringLen};
+    derive(handle, inputs, lengths, seed);
+    memset(&handle->state, 0, sizeof(handle->state));
+    update(handle, seed);
+    handle->state.reseed_counter = 1;
+    handle->flag = FLAG_INSTANTIATED;
+    return CMOX_DRBG_SUCCESS;
+}
+
+cmox_drbg_retval_t cmox_drbg_reseed(cmox_drbg_handle_t *P_pThis, const uint8_t *P_pEntropy, size_t P_entropyLen,
+        const uint8_t *P_pAdditionalInput, size_t P_additionalInputLen)
+{
+    cmox_ctr_drbg_handle_t* handle = get_handle(P_pThis);
+    uint8_t seed[MAX_SEED_SIZE];
+
+    if (handle == NULL) {
+        return CMOX_DRBG_ERR_BAD_PARAMETER;
+    }
+    if (handle->flag != FLAG_INSTANTIATED) {
+        return CMOX_DRBG_ERR_UNINIT_STATE;
+    }
+    if (P_pEntropy == NULL || P_entropyLen < handle->minEntropyLen) {
+        return CMOX_DRBG_ERR_BAD_ENTROPY_SIZE;
+    }
+    if (P_pAdditionalInput == NULL && P_additionalInputLen > 0) {
+        return CMOX_DRBG_ERR_BAD_ADD_INPUT_LEN;
+    }
+
+    const uint8_t* inputs[DF_INPUTS] = {P_pEntropy, P_pAdditionalInput, NULL};
+    const size_t lengths[DF_INPUTS] = {P_entropyLen, P_additionalInputLen, 0};
+    derive(handle, inputs, lengths, seed);
+    update(handle, seed);
+    handle->state.reseed_counter = 1;
+    return CMOX_DRBG_SUCCESS;
+}
+
+cmox_drbg_retval_t cmox_drbg_generate(cmox_drbg_handle_t *P_pThis, const uint8_t *P_pAdditionalInput,
+        size_t P_additionalInputLen, uint8_t *P_pOutput, size_t P_desiredOutputLen)
+{
+    cmox_ctr_drbg_handle_t* handle = get_handle(P_pThis);
+    uint8_t additional[MAX_SEED_SIZE] = {0};
+    uint32_t round_keys[AES_REF_ROUND_KEYS_SIZE];
+    uint8_t block[BLOCK_SIZE];
+
+    if (handle == NULL || P_pOutput == NULL) {
+        return CMOX_DRBG_ERR_BAD_PARAMETER;
+    }
+    if (handle->flag != FLAG_INSTANTIATED) {
+        return CMOX_DRBG_ERR_UNINIT_STATE;
+    }
+    if (P_pAdditionalInput == NULL && P_additionalInputLen > 0) {
+        return CMOX_DRBG_ERR_BAD_ADD_INPUT_LEN;
+    }
+    if (P_desiredOutputLen > handle->maxBytesPerRequest) {
+        return CMOX_DRBG_ERR_BAD_REQUEST;
+    }
+    if (handle->state.reseed_counter > RESEED_INTERVAL) {
+        return CMOX_DRBG_ERR_RESEED_NEEDED;
+    }
+
+    if (P_additionalInputLen > 0) {
+        const uint8_t* inputs[DF_INPUTS] = {P_pAdditionalInput, NULL, NULL};
+        const size_t lengths[DF_INPUTS] = {P_additionalInputLen, 0, 0};
+        derive(handle, inputs, lengths, additional);
+        update(handle, additional);
+    }
+
+    aes_ref_expand_key((const uint8_t*)handle->state.key, handle->keyLen, round_keys);
+    for (size_t done = 0; done < P_desiredOutputLen; done += BLOCK_SIZE) {
+        size_t size = P_desiredOutputLen - done < BLOCK_SIZE ? P_desiredOutputLen - done : BLOCK_SIZE;
+        next_block(handle, round_keys, block);
+        memcpy(&P_pOutput[done], block, size);
+    }
+    update(handle, additional);
+    handle->state.reseed_counter++;
+    return CMOX_DRBG_SUCCESS;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static cmox_ctr_drbg_handle_t* get_handle(cmox_drbg_handle_t* drbg)
+{
+    // the generic handle is the first member
+    if (drbg == NULL || drbg->table == NULL) {
+        return NULL;
+    }
+    return (cmox_ctr_drbg_handle_t*)drbg;
+}
+
+/**
+ * Block_Cipher_df of SP 800-90A: the seed (key size + block) of the
+ * concatenation of the inputs, a NULL input is empty
+ */
+static void derive(const cmox_ctr_drbg_handle_t* handle, const uint8_t* const* inputs, const size_t* lengths,
+        uint8_t* seed)
+{
+    static const uint8_t end = DF_END;
+    static const uint8_t zeros[BLOCK_SIZE];
+    uint32_t key_size = handle->keyLen;
+    uint32_t seed_size = key_size + BLOCK_SIZE;
+    uint32_t round_keys[AES_REF_ROUND_KEYS_SIZE];
+    uint8_t key[MAX_KEY_SIZE];
+    uint8_t temp[MAX_SEED_SIZE];
+    uint8_t header[DF_LENGTH_SIZE * 2];
+    size_t input_length = 0;
+
+    for (int i = 0; i < DF_INPUTS; i++) {
+        input_length += inputs[i] != NULL ? lengths[i] : 0;
+    }
+    // S = L || N || input || 0x80, padded with zeros
+    header[0] = input_length >> 24;
+    header[1] = input_length >> 16;
+    header[2] = input_length >> 8;
+    header[3] = input_length;
+    header[4] = seed_size >> 24;
+    header[5] = seed_size >> 16;
+    header[6] = seed_size >> 8;
+    header[7] = seed_size;
+
+    // K = 0x00010203..., the whole buffer so that every byte read is set
+    for (uint32_t i = 0; i < sizeof(key); i++) {
+        key[i] = i;
+    }
+    aes_ref_expand_key(key, key_size, round_keys);
+    for (uint32_t i = 0; i < seed_size / BLOCK_SIZE; i++) {
+        // the block of the counter i followed by S
+        bcc_t bcc = {round_keys, key_size, {0}, 0};
+        uint8_t counter[BLOCK_SIZE] = {i >> 24, i >> 16, i >> 8, i};
+        bcc_append(&bcc, counter, BLOCK_SIZE);
+        bcc_append(&bcc, header, sizeof(header));
+        for (int j = 0; j < DF_INPUTS; j++) {
+            if (inputs[j] != NULL) {
+                bcc_append(&bcc, inputs[j], lengths[j]);
+            }
+        }
+        bcc_append(&bcc, &end, 1);
+        if (bcc.used > 0) {
+            bcc_append(&bcc, zeros, BLOCK_SIZE - bcc.used);
+        }
+        memcpy(&temp[i * BLOCK_SIZE], bcc.chaining, BLOCK_SIZE);
+    }
+
+    // K is the start of temp, X the block following it
+    aes_ref_expand_key(temp, key_size, round_keys);
+    const uint8_t* x = &temp[key_size];
+    for (uint32_t i = 0; i < seed_size; i += BLOCK_SIZE) {
+        aes_ref_encrypt(round_keys, key_size, x, &seed[i]);
+        x = &seed[i];
+    }
+}
+
+static void bcc_append(bcc_t* bcc, const uint8_t* data, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        bcc->chaining[bcc->used++] ^= data[i];
+        if (bcc->used == BLOCK_SIZE) {
+            aes_ref_encrypt(bcc->round_keys, bcc->key_size, bcc->chaining, bcc->chaining);
+            bcc->used = 0;
+        }
+    }
+}
+
+/**
+ * CTR_DRBG_Update of SP 800-90A
+ * @param provided the data of the seed size
+ */
+static void update(cmox_ctr_drbg_handle_t* handle, const uint8_t* provided)
+{
+    uint32_t key_size = handle->keyLen;
+    uint32_t round_keys[AES_REF_ROUND_KEYS_SIZE];
+    uint8_t temp[MAX_SEED_SIZE];
+
+    aes_ref_expand_key((const uint8_t*)handle->state.key, key_size, round_keys);
+    for (uint32_t i = 0; i < key_size + BLOCK_SIZE; i += BLOCK_SIZE) {
+        next_block(handle, round_keys, &temp[i]);
+    }
+    for (uint32_t i = 0; i < key_size + BLOCK_SIZE; i++) {
+        temp[i] ^= provided[i];
+    }
+    memcpy(handle->state.key, temp, key_size);
+    memcpy(handle->state.value, &temp[key_size], BLOCK_SIZE);
+}
+
+/**
+ * Increment V and encrypt it
+ */
+static void next_block(cmox_ctr_drbg_handle_t* handle, const uint32_t* round_keys, uint8_t* block)
+{
+    uint8_t* value = (uint8_t*)handle->state.value;
+
+    increment(value);
+    aes_ref_encrypt(round_keys, handle->keyLen, value, block);
+}
+
+static void increment(uint8_t* counter)
+{
+    for (int i = BLOCK_SIZE - 1; i >= 0; i--) {
+        if (++counter[i] != 0) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,1258 @@
+/**
+ ******************************************************************************
+ * @file    cmox_pk_shim.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   public key part of the CMOX API for the host build
+ *
+ * ECDSA and ECDH on P-256 and P-384, Ed25519, X25519 and the RSA signatures
+ * (PKCS#1 v1.5 and PSS) on top of the reference arithmetic, the hashes are
+ * the ones of the CMOX shim. Every number and table is taken from the working
+ * buffer of the context as the library does: MaxMemUsed gives the peak of the
+ * operation. The LOWMEM and HIGHMEM curves and the modexp variants only
+ * change the window of the scalar multiplication and of the exponentiation,
+ * the math variants are the same code, SUPERFAST256 only takes the curves of
+ * 225 to 256 bits.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "cmox_crypto.h"
+
+#include "pk_ref.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define MAGIC_NUMBER 0x504B5348 // "PKSH"
+#define WORD_SIZE 4
+// scratch points and numbers of the ECC operations, a number of two words
+// counts for the products
+#define ECC_POINTS 3
+#define ECC_NUMBERS 8
+#define EDDSA_KEY_SIZE 32
+#define EDDSA_HASH_SIZE 64
+#define RSA_MAX_HASH_SIZE 64
+#define RSA_MGF1_COUNTER_SIZE 4
+#define PKCS1V15_MIN_PADDING 11
+#define PSS_ZEROS 8
+#define PSS_TRAILER 0xBC
+
+#define MATH_FUNCS(name, min_bits, max_bits) \
+    static const struct cmox_math_funcsStruct_st name##_struct = {min_bits, max_bits}; \
+    const cmox_math_funcs_t name = &name##_struct
+
+#define MODEXP_FUNC(name, window, private_key) \
+    static const struct cmox_modexp_funcStruct_st name##_struct = {window, private_key}; \
+    const cmox_modexp_func_t name = &name##_struct
+
+#define ECC_IMPL(name, curve, window, kind) \
+    static const struct cmox_ecc_implStruct_st name##_struct = {&curve, window, kind}; \
+    const cmox_ecc_impl_t name = &name##_struct
+
+#define PKCS1V15_HASH(name, algo, size, prefix) \
+    static const struct cmox_rsa_pkcs1v15_hash_st name##_struct = {{&algo, size, prefix, sizeof(prefix)}}; \
+    const cmox_rsa_pkcs1v15_hash_t name = &name##_struct
+
+#define PKCS1V22_HASH(name, algo, size) \
+    static const struct cmox_rsa_pkcs1v22_hash_st name##_struct = {{&algo, size, NULL, 0}}; \
+    const cmox_rsa_pkcs1v22_hash_t name = &name##_struct
+
+#define N(i) (&work->numbers[(i) * work->words])
+#define P(i) (&work->points[(i) * work->point_words])
+
+/* Private typedef -----------------------------------------------------------*/
+
+struct cmox_math_funcsStruct_st {
+    uint32_t min_bits;
+    uint32_t max_bits; // 0 without limit
+};
+
+struct cmox_modexp_funcStruct_st {
+    uint32_t window;
+    bool private_key;
+};
+
+typedef enum {
+    ECC_WEIERSTRASS,    // ECDSA and ECDH
+    ECC_EDWARDS,        // EdDSA
+    ECC_MONTGOMERY,     // X25519
+} ecc_kind_t;
+
+struct cmox_ecc_implStruct_st {
+    const pk_ref_curve_t* curve;
+    uint32_t window;
+    ecc_kind_t kind;
+};
+
+struct cmox_rsa_intfuncStruct_t {
+    bool crt;
+};
+
+typedef struct {
+    const cmox_hash_algo_t* algo;
+    size_t size;
+    const uint8_t* prefix;  // DigestInfo of PKCS#1 v1.5
+    size_t prefix_size;
+} rsa_hash_t;
+
+struct cmox_rsa_pkcs1v15_hash_st {
+    rsa_hash_t hash;
+};
+
+struct cmox_rsa_pkcs1v22_hash_st {
+    rsa_hash_t hash;
+};
+
+typedef struct {
+    cmox_membuf_handle_st* membuf;
+    size_t mark;            // used part of the buffer before the operation
+    const pk_ref_curve_t* curve;
+    uint32_t words;
+    uint32_t size;          // bytes of the scalars and of the coordinates
+    uint32_t window;
+    uint32_t point_words;
+    pk_ref_ec_t ec;
+    pk_ref_mod_t order;
+    uint32_t* table;
+    uint32_t* points;
+    uint32_t* numbers;
+} ecc_work_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+MATH_FUNCS(CMOX_MATH_FUNCS_SMALL, 0, 0);
+MATH_FUNCS(CMOX_MATH_FUNCS_FAST, 0, 0);
+MATH_FUNCS(CMOX_MATH_FUNCS_SUPERFAST256, 225, 256);
+
+MODEXP_FUNC(CMOX_MODEXP_PUBLIC, 1, false);
+MODEXP_FUNC(CMOX_MODEXP_PRIVATE_LOWMEM, 1, true);
+MODEXP_FUNC(CMOX_MODEXP_PRIVATE_MIDMEM, 3, true);
+MODEXP_FUNC(CMOX_MODEXP_PRIVATE_HIGHMEM, 4, true);
+
+ECC_IMPL(CMOX_ECC_CURVE25519, pk_ref_ed25519, 1, ECC_MONTGOMERY);
+ECC_IMPL(CMOX_ECC_ED25519_HIGHMEM, pk_ref_ed25519, 4, ECC_EDWARDS);
+ECC_IMPL(CMOX_ECC_ED25519_OPT_LOWMEM, pk_ref_ed25519, 1, ECC_EDWARDS);
+ECC_IMPL(CMOX_ECC_ED25519_OPT_HIGHMEM, pk_ref_ed25519, 4, ECC_EDWARDS);
+ECC_IMPL(CMOX_ECC_SECP256R1_LOWMEM, pk_ref_p256, 1, ECC_WEIERSTRASS);
+ECC_IMPL(CMOX_ECC_SECP256R1_HIGHMEM, pk_ref_p256, 4, ECC_WEIERSTRASS);
+ECC_IMPL(CMOX_ECC_SECP384R1_LOWMEM, pk_ref_p384, 1, ECC_WEIERSTRASS);
+ECC_IMPL(CMOX_ECC_SECP384R1_HIGHMEM, pk_ref_p384, 4, ECC_WEIERSTRASS);
+
+// DigestInfo of the hashes (RFC 8017, section 9.2)
+static const uint8_t sha1_prefix[] = {
+    0x30, 0x21, 0x30, 0x09, 0x06, 0x05, 0x2B, 0x0E, 0x03, 0x02, 0x1A, 0x05, 0x00, 0x04, 0x14
+};
+static const uint8_t sha224_prefix[] = {
+    0x30, 0x2D, 0x30, 0x0D, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x04, 0x05, 0x00, 0x04, 0x1C
+};
+static const uint8_t sha256_prefix[] = {
+    0x30, 0x31, 0x30, 0x0D, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20
+};
+static const uint8_t sha384_prefix[] = {
+    0x30, 0x41, 0x30, 0x0D, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x02, 0x05, 0x00, 0x04, 0x30
+};
+static const uint8_t sha512_prefix[] = {
+    0x30, 0x51, 0x30, 0x0D, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x03, 0x05, 0x00, 0x04, 0x40
+};
+static const uint8_t sha512_224_prefix[] = {
+    0x30, 0x2D, 0x30, 0x0D, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x05, 0x05, 0x00, 0x04, 0x1C
+};
+static const uint8_t sha512_256_prefix[] = {
+    0x30, 0x31, 0x30, 0x0D, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x06, 0x05, 0x00, 0x04, 0x20
+};
+
+PKCS1V15_HASH(CMOX_RSA_PKCS1V15_HASH_SHA1, CMOX_SHA1_ALGO, 20, sha1_prefix);
+PKCS1V15_HASH(CMOX_RSA_PKCS1V15_HASH_SHA224, CMOX_SHA224_ALGO, 28, sha224_prefix);
+PKCS1V15_HASH(CMOX_RSA_PKCS1V15_HASH_SHA256, CMOX_SHA256_ALGO, 32, sha256_prefix);
+PKCS1V15_HASH(CMOX_RSA_PKCS1V15_HASH_SHA384, CMOX_SHA384_ALGO, 48, sha384_prefix);
+PKCS1V15_HASH(CMOX_RSA_PKCS1V15_HASH_SHA512, CMOX_SHA512_ALGO, 64, sha512_prefix);
+PKCS1V15_HASH(CMOX_RSA_PKCS1V15_HASH_SHA512_224, CMOX_SHA512_224_ALGO, 28, sha512_224_prefix);
+PKCS1V15_HASH(CMOX_RSA_PKCS1V15_HASH_SHA512_256, CMOX_SHA512_256_ALGO, 32, sha512_256_prefix);
+
+PKCS1V22_HASH(CMOX_RSA_PKCS1V22_HASH_SHA1, CMOX_SHA1_ALGO, 20);
+PKCS1V22_HASH(CMOX_RSA_PKCS1V22_HASH_SHA224, CMOX_SHA224_ALGO, 28);
+PKCS1V22_HASH(CMOX_RSA_PKCS1V22_HASH_SHA256, CMOX_SHA256_ALGO, 32);
+PKCS1V22_HASH(CMOX_RSA_PKCS1V22_HASH_SHA384, CMOX_SHA384_ALGO, 48);
+PKCS1V22_HASH(CMOX_RSA_PKCS1V22_HASH_SHA512, CMOX_SHA512_ALGO, 64);
+PKCS1V22_HASH(CMOX_RSA_PKCS1V22_HASH_SHA512_224, CMOX_SHA512_224_ALGO, 28);
+PKCS1V22_HASH(CMOX_RSA_PKCS1V22_HASH_SHA512_256, CMOX_SHA512_256_ALGO, 32);
+
+static struct cmox_rsa_intfuncStruct_t rsa_standard = {false};
+static struct cmox_rsa_intfuncStruct_t rsa_crt = {true};
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint32_t* allocate(cmox_membuf_handle_st* membuf, size_t words);
+static bool math_fits(cmox_math_funcs_t math, uint32_t bits);
+static cmox_ecc_retval_t ecc_begin(cmox_ecc_handle_t* ctx, cmox_ecc_impl_t impl, ecc_work_t* work);
+static void ecc_end(ecc_work_t* work);
+static bool in_order(const ecc_work_t* work, const uint32_t* x);
+static void base_point(ecc_work_t* work, uint32_t* point);
+static void inverse_order(ecc_work_t* work, uint32_t* r, const uint32_t* a);
+static bool read_public_key(ecc_work_t* work, uint32_t* point, const uint8_t* key, size_t length);
+static void write_affine(ecc_work_t* work, uint8_t* output, const uint32_t* point);
+static cmox_ecc_retval_t x25519(ecc_work_t* work, const uint8_t* private_key, size_t private_length,
+        const uint8_t* public_key, size_t public_length, uint8_t* secret, size_t* secret_length);
+static void eddsa_expand(ecc_work_t* work, uint8_t* hash, uint32_t* scalar, const uint8_t* seed);
+static void eddsa_challenge(ecc_work_t* work, uint32_t* r, const uint8_t* prefix, const uint8_t* middle,
+        const uint8_t* message, size_t length);
+static void sha512(uint8_t* digest, const uint8_t* first, size_t first_length, const uint8_t* second,
+        size_t second_length, const uint8_t* third, size_t third_length);
+static void from_little_endian(uint32_t* x, uint32_t words, const uint8_t* bytes, uint32_t length);
+static void to_little_endian(uint8_t* bytes, uint32_t length, const uint32_t* x);
+static uint32_t words_of(size_t bytes);
+static size_t bit_length(const uint8_t* bytes, size_t length);
+static cmox_rsa_retval_t rsa_check(cmox_rsa_handle_t* ctx, const cmox_rsa_key_t* key, bool private_key);
+static cmox_rsa_retval_t rsa_private(cmox_rsa_handle_t* ctx, const cmox_rsa_key_t* key, uint8_t* block);
+static cmox_rsa_retval_t rsa_public(cmox_rsa_handle_t* ctx, const cmox_rsa_key_t* key, const uint8_t* input,
+        uint8_t* output);
+static void rsa_exp(const pk_ref_mod_t* mod, uint32_t* r, uint32_t* x, const uint8_t* exponent, size_t exponent_length,
+        uint32_t* exponent_words, uint32_t window, uint32_t* table);
+static bool pkcs1v15_encode(const rsa_hash_t* hash, const uint8_t* digest, uint8_t* block, size_t length);
+static bool pss_encode(const rsa_hash_t* hash, const uint8_t* digest, const uint8_t* salt, size_t salt_length,
+        uint8_t* block, size_t bits);
+static bool pss_verify(const rsa_hash_t* hash, const uint8_t* digest, size_t salt_length, uint8_t* block, size_t bits);
+static void pss_hash(const rsa_hash_t* hash, uint8_t* output, const uint8_t* digest, const uint8_t* salt,
+        size_t salt_length);
+static void mgf1_mask(const rsa_hash_t* hash, uint8_t* data, size_t length, const uint8_t* seed);
+static void add_words(uint32_t* r, uint32_t r_words, const uint32_t* a, uint32_t a_words);
+static bool equal_bytes(const uint8_t* x, const uint8_t* y, size_t length);
+
+/* Public functions ----------------------------------------------------------*/
+
+void cmox_ecc_construct(cmox_ecc_handle_t *P_pEccCtx, const cmox_math_funcs_t P_Math, uint8_t *P_pBuf, size_t P_BufLen)
+{
+    if (P_pEccCtx == NULL) {
+        return;
+    }
+    P_pEccCtx->membuf_str.MemBuf = P_pBuf;
+    P_pEccCtx->membuf_str.MemBufSize = P_BufLen;
+    P_pEccCtx->membuf_str.MemBufUsed = 0;
+    P_pEccCtx->membuf_str.MaxMemUsed = 0;
+    P_pEccCtx->math_ptr = P_Math;
+    P_pEccCtx->magic_num_check = MAGIC_NUMBER;
+}
+
+void cmox_ecc_cleanup(cmox_ecc_handle_t *P_pEccCtx)
+{
+    if (P_pEccCtx != NULL) {
+        memset(P_pEccCtx, 0, sizeof(*P_pEccCtx));
+    }
+}
+
+cmox_ecc_retval_t cmox_ecdsa_keyGen(cmox_ecc_handle_t *P_pEccCtx, const cmox_ecc_impl_t P_CurveParams,
+        const uint8_t *P_pRandom, size_t P_RandomLen, uint8_t *P_pPrivKey, size_t *P_pPrivKeyLen,
+        uint8_t *P_pPubKey, size_t *P_pPubKeyLen)
+{
+    ecc_work_t work_struct;
+    ecc_work_t* work = &work_struct;
+
+    if (P_CurveParams != NULL && P_CurveParams->kind != ECC_WEIERSTRASS) {
+        return CMOX_ECC_ERR_ALGOCURVE_MISMATCH;
+    }
+    if (P_pRandom == NULL || P_pPrivKey == NULL || P_pPubKey == NULL) {
+        return CMOX_ECC_ERR_BAD_PARAMETERS;
+    }
+    cmox_ecc_retval_t retval = ecc_begin(P_pEccCtx, P_CurveParams, work);
+    if (retval != CMOX_ECC_SUCCESS) {
+        return retval;
+    }
+
+    // the private key is the random itself, if it is in [1, n - 1]
+    pk_ref_from_bytes(N(0), work->words, P_pRandom, P_RandomLen < work->size ? P_RandomLen : work->size);
+    if (P_RandomLen < work->size || !in_order(work, N(0))) {
+        retval = CMOX_ECC_ERR_WRONG_RANDOM;
+    } else {
+        base_point(work, P(1));
+        pk_ref_ec_mul(&work->ec, P(0), P(1), N(0), work->window, work->table);
+        pk_ref_to_bytes(P_pPrivKey, work->size, N(0), work->words);
+        write_affine(work, P_pPubKey, P(0));
+        if (P_pPrivKeyLen != NULL) {
+            *P_pPrivKeyLen = work->size;
+        }
+        if (P_pPubKeyLen != NULL) {
+            *P_pPubKeyLen = 2 * work->size;
+        }
+    }
+    ecc_end(work);
+    return retval;
+}
+
+cmox_ecc_retval_t cmox_ecdsa_sign(cmox_ecc_handle_t *P_pEccCtx, const cmox_ecc_impl_t P_CurveParams,
+        const uint8_t *P_pRandom, size_t P_RandomLen, const uint8_t *P_pPrivKey, size_t P_PrivKeyLen,
+        const uint8_t *P_pDigest, size_t P_DigestLen, uint8_t *P_pSignature, size_t *P_pSignatureLen)
+{
+    ecc_work_t work_struct;
+    ecc_work_t* work = &work_struct;
+
+    if (P_CurveParams != NULL && P_CurveParams->kind != ECC_WEIERSTRASS) {
+        return CMOX_ECC_ERR_ALGOCURVE_MISMATCH;
+    }
+    if (P_pRandom == NULL || P_pPrivKey == NULL || P_pDigest == NULL || P_pSignature == NULL) {
+        return CMOX_ECC_ERR_BAD_PARAMETERS;
+    }
+    cmox_ecc_retval_t retval = ecc_begin(P_pEccCtx, P_CurveParams, work);
+    if (retval != CMOX_ECC_SUCCESS) {
+        return retval;
+    }
+
+    // d, k and the leftmost bits of the digest (the orders are whole bytes)
+    pk_ref_from_bytes(N(0), work->words, P_pPrivKey, P_PrivKeyLen);
+    pk_ref_from_bytes(N(1), work->words, P_pRandom, P_RandomLen < work->size ? P_RandomLen : work->size);
+    pk_ref_from_bytes(N(3), work->words, P_pDigest, P_DigestLen < work->size ? P_DigestLen : work->size);
+    pk_ref_mod_reduce(&work->order, N(2), N(3), work->words);
+    if (P_PrivKeyLen != work->size || !in_order(work, N(0))) {
+        retval = CMOX_ECC_ERR_BAD_PARAMETERS;
+    } else if (P_RandomLen < work->size || !in_order(work, N(1))) {
+        retval = CMOX_ECC_ERR_WRONG_RANDOM;
+    } else {
+        // r = x(k G) mod n
+        base_point(work, P(1));
+        pk_ref_ec_mul(&work->ec, P(0), P(1), N(1), work->window, work->table);
+        pk_ref_ec_to_affine(&work->ec, N(3), N(4), P(0));
+        pk_ref_mod_reduce(&work->order, N(5), N(3), work->words);
+
+        // s = k^-1 (e + r d) mod n
+        inverse_order(work, N(4), N(1));
+        pk_ref_mod_to_mont(&work->order, N(3), N(5));
+        pk_ref_mod_mul(&work->order, N(3), N(3), N(0));
+        pk_ref_mod_add(&work->order, N(3), N(3), N(2));
+        pk_ref_mod_mul(&work->order, N(6), N(4), N(3));
+
+        if (pk_ref_is_zero(N(5), work->words) || pk_ref_is_zero(N(6), work->words)) {
+            retval = CMOX_ECC_ERR_WRONG_RANDOM;
+        } else {
+            pk_ref_to_bytes(P_pSignature, work->size, N(5), work->words);
+            pk_ref_to_bytes(P_pSignature + work->size, work->size, N(6), work->words);
+            if (P_pSignatureLen != NULL) {
+                *P_pSignatureLen = 2 * work->size;
+            }
+        }
+    }
+    ecc_end(work);
+    return retval;
+}
+
+cmox_ecc_retval_t cmox_ecdsa_verify(cmox_ecc_handle_t *P_pEccCtx, const cmox_ecc_impl_t P_CurveParams,
+        const uint8_t *P_pPubKey, size_t P_PubKeyLen, const uint8_t *P_pDigest, size_t P_DigestLen,
+        const uint8_t *P_pSignature, size_t P_SignatureLen, uint32_t *P_pFaultCheck)
+{
+    ecc_work_t work_struct;
+    ecc_work_t* work = &work_struct;
+
+    if (P_CurveParams != NULL && P_CurveParams->kind != ECC_WEIERSTRASS) {
+        return CMOX_ECC_ERR_ALGOCURVE_MISMATCH;
+    }
+    if (P_pPubKey == NULL || P_pDigest == NULL || P_pSignature == NULL) {
+        return CMOX_ECC_ERR_BAD_PARAMETERS;
+    }
+    cmox_ecc_retval_t retval = ecc_begin(P_pEccCtx, P_CurveParams, work);
+    if (retval != CMOX_ECC_SUCCESS) {
+        return retval;
+    }
+
+    if (!read_public_key(work, P(2), P_pPubKey, P_PubKeyLen)) {
+        retval = CMOX_ECC_ERR_INVALID_PUBKEY;
+    } else if (P_SignatureLen != 2 * work->size) {
+        retval = CMOX_ECC_ERR_INVALID_SIGNATURE;
+    } else {
+        pk_ref_from_bytes(N(0), work->words, P_pSignature, work->size);
+        pk_ref_from_bytes(N(1), work->words, P_pSignature + work->size, work->size);
+        pk_ref_from_bytes(N(3), work->words, P_pDigest, P_DigestLen < work->size ? P_DigestLen : work->size);
+        pk_ref_mod_reduce(&work->order, N(2), N(3), work->words);
+        retval = CMOX_ECC_AUTH_FAIL;
+        if (in_order(work, N(0)) && in_order(work, N(1))) {
+            // u1 = e / s, u2 = r / s, x(u1 G + u2 Q) mod n = r
+            inverse_order(work, N(4), N(1));
+            pk_ref_mod_mul(&work->order, N(5), N(4), N(2));
+            pk_ref_mod_mul(&work->order, N(6), N(4), N(0));
+            base_point(work, P(1));
+            pk_ref_ec_mul(&work->ec, P(0), P(1), N(5), work->window, work->table);
+            memcpy(P(1), P(2), work->point_words * sizeof(uint32_t));
+            pk_ref_ec_mul(&work->ec, P(2), P(1), N(6), work->window, work->table);
+            pk_ref_ec_add(&work->ec, P(0), P(0), P(2));
+            if (pk_ref_ec_to_affine(&work->ec, N(3), N(4), P(0))) {
+                pk_ref_mod_reduce(&work->order, N(7), N(3), work->words);
+                if (pk_ref_compare(N(7), N(0), work->words) == 0) {
+                    retval = CMOX_ECC_AUTH_SUCCESS;
+                }
+            }
+        }
+    }
+    if (P_pFaultCheck != NULL) {
+        *P_pFaultCheck = retval;
+    }
+    ecc_end(work);
+    return retval;
+}
+
+cmox_ecc_retval_t cmox_ecdh(cmox_ecc_handle_t *P_pEccCtx, const cmox_ecc_impl_t P_CurveParams,
+        const uint8_t *P_pPrivKey, size_t P_PrivKeyLen, const uint8_t *P_pPubKey, size_t P_PubKeyLen,
+        uint8_t *P_pSharedSecret, size_t *P_pSharedSecretLen)
+{
+    ecc_work_t work_struct;
+    ecc_work_t* work = &work_struct;
+
+    if (P_CurveParams != NULL && P_CurveParams->kind == ECC_EDWARDS) {
+        return CMOX_ECC_ERR_ALGOCURVE_MISMATCH;
+    }
+    if (P_pPrivKey == NULL || P_pPubKey == NULL || P_pSharedSecret == NULL) {
+        return CMOX_ECC_ERR_BAD_PARAMETERS;
+    }
+    cmox_ecc_retval_t retval = ecc_begin(P_pEccCtx, P_CurveParams, work);
+    if (retval != CMOX_ECC_SUCCESS) {
+        return retval;
+    }
+
+    if (P_CurveParams->kind == ECC_MONTGOMERY) {
+        retval = x25519(work, P_pPrivKey, P_PrivKeyLen, P_pPubKey, P_PubKeyLen, P_pSharedSecret, P_pSharedSecretLen);
+    } else {
+        pk_ref_from_bytes(N(0), work->words, P_pPrivKey, P_PrivKeyLen);
+        if (P_PrivKeyLen != work->size || !in_order(work, N(0))) {
+            retval = CMOX_ECC_ERR_BAD_PARAMETERS;
+        } else if (!read_public_key(work, P(1), P_pPubKey, P_PubKeyLen)) {
+            retval = CMOX_ECC_ERR_INVALID_PUBKEY;
+        } else {
+            // x and y of d Q, as the library gives them
+            pk_ref_ec_mul(&work->ec, P(0), P(1), N(0), work->window, work->table);
+            write_affine(work, P_pSharedSecret, P(0));
+            if (P_pSharedSecretLen != NULL) {
+                *P_pSharedSecretLen = 2 * work->size;
+            }
+        }
+    }
+    ecc_end(work);
+    return retval;
+}
+
+/**
+ * The private key is the seed followed by the public key
+ */
+cmox_ecc_retval_t cmox_eddsa_keyGen(cmox_ecc_handle_t *P_pEccCtx, const cmox_ecc_impl_t P_CurveParams,
+        const uint8_t *P_pRandom, size_t P_RandomLen, uint8_t *P_pPrivKey, size_t *P_pPrivKeyLen,
+        uint8_t *P_pPubKey, size_t *P_pPubKeyLen)
+{
+    ecc_work_t work_struct;
+    ecc_work_t* work = &work_struct;
+    uint8_t hash[EDDSA_HASH_SIZE];
+
+    if (P_CurveParams != NULL && P_CurveParams->kind != ECC_EDWARDS) {
+        return CMOX_ECC_ERR_ALGOCURVE_MISMATCH;
+    }
+    if (P_pRandom == NULL || P_pPrivKey == NULL || P_pPubKey == NULL) {
+        return CMOX_ECC_ERR_BAD_PARAMETERS;
+    }
+    if (P_RandomLen < EDDSA_KEY_SIZE) {
+        return CMOX_ECC_ERR_WRONG_RANDOM;
+    }
+    cmox_ecc_retval_t retval = ecc_begin(P_pEccCtx, P_CurveParams, work);
+    if (retval != CMOX_ECC_SUCCESS) {
+        return retval;
+    }
+
+    eddsa_expand(work, hash, N(0), P_pRandom);
+    base_point(work, P(1));
+    pk_ref_ec_mul(&work->ec, P(0), P(1), N(0), work->window, work->table);
+    pk_ref_ec_encode(&work->ec, P_pPubKey, P(0));
+    memcpy(P_pPrivKey, P_pRandom, EDDSA_KEY_SIZE);
+    memcpy(P_pPrivKey + EDDSA_KEY_SIZE, P_pPubKey, EDDSA_KEY_SIZE);
+    if (P_pPrivKeyLen != NULL) {
+        *P_pPrivKeyLen = 2 * EDDSA_KEY_SIZE;
+    }
+    if (P_pPubKeyLen != NULL) {
+        *P_pPubKeyLen = EDDSA_KEY_SIZE;
+    }
+    ecc_end(work);
+    return retval;
+}
+
+cmox_ecc_retval_t cmox_eddsa_sign(cmox_ecc_handle_t *P_pEccCtx, const cmox_ecc_impl_t P_CurveParams,
+        const uint8_t *P_pPrivKey, size_t P_PrivKeyLen, const uint8_t *P_pMessage, size_t P_MessageLen,
+        uint8_t *P_pSignature, size_t *P_pSignatureLen)
+{
+    ecc_work_t work_struct;
+    ecc_work_t* work = &work_struct;
+    uint8_t hash[EDDSA_HASH_SIZE];
+
+    if (P_CurveParams != NULL && P_CurveParams->kind != ECC_EDWARDS) {
+        return CMOX_ECC_ERR_ALGOCURVE_MISMATCH;
+    }
+    if (P_pPrivKey == NULL || P_PrivKeyLen != 2 * EDDSA_KEY_SIZE || (P_pMessage == NULL && P_MessageLen > 0)
+            || P_pSignature == NULL) {
+        return CMOX_ECC_ERR_BAD_PARAMETERS;
+    }
+    cmox_ecc_retval_t retval = ecc_begin(P_pEccCtx, P_CurveParams, work);
+    if (retval != CMOX_ECC_SUCCESS) {
+        return retval;
+    }
+
+    // r = H(prefix || M), R = r B, k = H(R || A || M), S = r + k a (RFC 8032)
+    eddsa_expand(work, hash, N(0), P_pPrivKey);
+    eddsa_challenge(work, N(1), hash + EDDSA_KEY_SIZE, NULL, P_pMessage, P_MessageLen);
+    base_point(work, P(1));
+    pk_ref_ec_mul(&work->ec, P(0), P(1), N(1), work->window, work->table);
+    pk_ref_ec_encode(&work->ec, P_pSignature, P(0));
+    eddsa_challenge(work, N(4), P_pSignature, P_pPrivKey + EDDSA_KEY_SIZE, P_pMessage, P_MessageLen);
+    pk_ref_multiply(N(2), N(4), work->words, N(0), work->words);
+    pk_ref_mod_reduce(&work->order, N(5), N(2), 2 * work->words);
+    pk_ref_mod_add(&work->order, N(5), N(5), N(1));
+    to_little_endian(P_pSignature + EDDSA_KEY_SIZE, EDDSA_KEY_SIZE, N(5));
+    if (P_pSignatureLen != NULL) {
+        *P_pSignatureLen = 2 * EDDSA_KEY_SIZE;
+    }
+    ecc_end(work);
+    return retval;
+}
+
+cmox_ecc_retval_t cmox_eddsa_verify(cmox_ecc_handle_t *P_pEccCtx, const cmox_ecc_impl_t P_CurveParams,
+        const uint8_t *P_pPubKey, size_t P_PubKeyLen, const uint8_t *P_pMessage, size_t P_MessageLen,
+        const uint8_t *P_pSignature, size_t P_SignatureLen, uint32_t *P_pFaultCheck)
+{
+    ecc_work_t work_struct;
+    ecc_work_t* work = &work_struct;
+    uint8_t left[EDDSA_KEY_SIZE];
+    uint8_t right[EDDSA_KEY_SIZE];
+
+    if (P_CurveParams != NULL && P_CurveParams->kind != ECC_EDWARDS) {
+        return CMOX_ECC_ERR_ALGOCURVE_MISMATCH;
+    }
+    if (P_pPubKey == NULL || (P_pMessage == NULL && P_MessageLen > 0) || P_pSignature == NULL) {
+        return CMOX_ECC_ERR_BAD_PARAMETERS;
+    }
+    cmox_ecc_retval_t retval = ecc_begin(P_pEccCtx, P_CurveParams, work);
+    if (retval != CMOX_ECC_SUCCESS) {
+        return retval;
+    }
+
+    if (P_PubKeyLen != EDDSA_KEY_SIZE || !pk_ref_ec_decode(&work->ec, P(1), P_pPubKey)) {
+        retval = CMOX_ECC_ERR_INVALID_PUBKEY;
+    } else if (P_SignatureLen != 2 * EDDSA_KEY_SIZE) {
+        retval = CMOX_ECC_ERR_INVALID_SIGNATURE;
+    } else {
+        // S B = R + k A, compared encoded
+        retval = CMOX_ECC_AUTH_FAIL;
+        from_little_endian(N(0), work->words, P_pSignature + EDDSA_KEY_SIZE, EDDSA_KEY_SIZE);
+        if (pk_ref_ec_decode(&work->ec, P(2), P_pSignature)
+                && pk_ref_compare(N(0), work->curve->n, work->words) < 0) {
+            eddsa_challenge(work, N(1), P_pSignature, P_pPubKey, P_pMessage, P_MessageLen);
+            pk_ref_ec_mul(&work->ec, P(0), P(1), N(1), work->window, work->table);
+            pk_ref_ec_add(&work->ec, P(0), P(0), P(2));
+            pk_ref_ec_encode(&work->ec, left, P(0));
+            base_point(work, P(1));
+            pk_ref_ec_mul(&work->ec, P(2), P(1), N(0), work->window, work->table);
+            pk_ref_ec_encode(&work->ec, right, P(2));
+            if (equal_bytes(left, right, EDDSA_KEY_SIZE)) {
+                retval = CMOX_ECC_AUTH_SUCCESS;
+            }
+        }
+    }
+    if (P_pFaultCheck != NULL) {
+        *P_pFaultCheck = retval;
+    }
+    ecc_end(work);
+    return retval;
+}
+
+void cmox_rsa_construct(cmox_rsa_handle_t *P_pRsaCtx, const cmox_math_funcs_t P_Math,
+        const cmox_modexp_func_t P_Modexp, uint8_t *P_pBuf, size_t P_BufLen)
+{
+    if (P_pRsaCtx == NULL) {
+        return;
+    }
+    P_pRsaCtx->membuf_str.MemBuf = P_pBuf;
+    P_pRsaCtx->membuf_str.MemBufSize = P_BufLen;
+    P_pRsaCtx->membuf_str.MemBufUsed = 0;
+    P_pRsaCtx->membuf_str.MaxMemUsed = 0;
+    P_pRsaCtx->modexp_ptr = P_Modexp;
+    P_pRsaCtx->math_ptr = P_Math;
+    P_pRsaCtx->magic_num_check = MAGIC_NUMBER;
+}
+
+void cmox_rsa_cleanup(cmox_rsa_handle_t *P_pRsaCtx)
+{
+    if (P_pRsaCtx != NULL) {
+        memset(P_pRsaCtx, 0, sizeof(*P_pRsaCtx));
+    }
+}
+
+cmox_rsa_retval_t cmox_rsa_setKey(cmox_rsa_key_t *P_pKey, const uint8_t *P_pModulus, size_t P_ModulusLen,
+        const uint8_t *P_pExp, size_t P_ExpLen)
+{
+    if (P_pKey == NULL || P_pModulus == NULL || P_pExp == NULL || P_ModulusLen > WORD_SIZE * PK_REF_MAX_WORDS
+            || P_ExpLen > P_ModulusLen) {
+        return CMOX_RSA_ERR_BAD_PARAMETER;
+    }
+    P_pKey->f = &rsa_standard;
+    P_pKey->mod_bitlen = bit_length(P_pModulus, P_ModulusLen);
+    P_pKey->fields.std.mod = P_pModulus;
+    P_pKey->fields.std.exp = P_pExp;
+    P_pKey->fields.std.exp_len = P_ExpLen;
+    return CMOX_RSA_SUCCESS;
+}
+
+cmox_rsa_retval_t cmox_rsa_setKeyCRT(cmox_rsa_key_t *P_pPrivKey, size_t P_ModulusBitLen, const uint8_t *P_pExpP,
+        size_t P_ExpPLen, const uint8_t *P_pExpQ, size_t P_ExpQLen, const uint8_t *P_pP, size_t P_PLen,
+        const uint8_t *P_pQ, size_t P_QLen, const uint8_t *P_pIq, size_t P_IqLen)
+{
+    size_t half = WORD_SIZE * PK_REF_MAX_WORDS / 2;
+
+    if (P_pPrivKey == NULL || P_pExpP == NULL || P_pExpQ == NULL || P_pP == NULL || P_pQ == NULL || P_pIq == NULL
+            || P_ModulusBitLen > 8 * WORD_SIZE * PK_REF_MAX_WORDS || P_ExpPLen > half || P_ExpQLen > half
+            || P_PLen > half || P_QLen > half || P_IqLen > half) {
+        return CMOX_RSA_ERR_BAD_PARAMETER;
+    }
+    P_pPrivKey->f = &rsa_crt;
+    P_pPrivKey->mod_bitlen = P_ModulusBitLen;
+    P_pPrivKey->fields.crt.p = P_pP;
+    P_pPrivKey->fields.crt.p_len = P_PLen;
+    P_pPrivKey->fields.crt.q = P_pQ;
+    P_pPrivKey->fields.crt.q_len = P_QLen;
+    P_pPrivKey->fields.crt.dp = P_pExpP;
+    P_pPrivKey->fields.crt.dp_len = P_ExpPLen;
+    P_pPrivKey->fields.crt.dq = P_pExpQ;
+    P_pPrivKey->fields.crt.dq_len = P_ExpQLen;
+    P_pPrivKey->fields.crt.iq = P_pIq;
+    P_pPrivKey->fields.crt.iq_len = P_IqLen;
+    P_pPrivKey->fields.crt.pub_exp = NULL;
+    P_pPrivKey->fields.crt.pub_exp_len = 0;
+    P_pPrivKey->fields.crt.facm_flag = NULL;
+    return CMOX_RSA_SUCCESS;
+}
+
+cmox_rsa_retval_t cmox_rsa_pkcs1v15_sign(cmox_rsa_handle_t *P_pRsaCtx, const cmox_rsa_key_t *P_pPrivKey,
+        const uint8_t *P_pDigest, const cmox_rsa_pkcs1v15_hash_t P_HashId, uint8_t *P_pSignature,
+        size_t *P_pSignatureLen)
+{
+    if (P_pDigest == NULL || P_HashId == NULL || P_pSignature == NULL) {
+        return CMOX_RSA_ERR_BAD_PARAMETER;
+    }
+    cmox_rsa_retval_t retval = rsa_check(P_pRsaCtx, P_pPrivKey, true);
+    if (retval != CMOX_RSA_SUCCESS) {
+        return retval;
+    }
+
+    size_t length = (P_pPrivKey->mod_bitlen + 7) / 8;
+    if (!pkcs1v15_encode(&P_HashId->hash, P_pDigest, P_pSignature, length)) {
+        return CMOX_RSA_ERR_MODULUS_TOO_SHORT;
+    }
+    retval = rsa_private(P_pRsaCtx, P_pPrivKey, P_pSignature);
+    if (retval == CMOX_RSA_SUCCESS && P_pSignatureLen != NULL) {
+        *P_pSignatureLen = length;
+    }
+    return retval;
+}
+
+cmox_rsa_retval_t cmox_rsa_pkcs1v15_verify(cmox_rsa_handle_t *P_pRsaCtx, const cmox_rsa_key_t *P_pPubKey,
+        const uint8_t *P_pDigest, const cmox_rsa_pkcs1v15_hash_t P_HashId, const uint8_t *P_pSignature,
+        size_t P_SignatureLen, uint32_t *P_pFaultCheck)
+{
+    if (P_pDigest == NULL || P_HashId == NULL || P_pSignature == NULL) {
+        return CMOX_RSA_ERR_BAD_PARAMETER;
+    }
+    cmox_rsa_retval_t retval = rsa_check(P_pRsaCtx, P_pPubKey, false);
+    if (retval != CMOX_RSA_SUCCESS) {
+        return retval;
+    }
+
+    size_t length = (P_pPubKey->mod_bitlen + 7) / 8;
+    cmox_membuf_handle_st* membuf = &P_pRsaCtx->membuf_str;
+    size_t mark = membuf->MemBufUsed;
+    uint8_t* decoded = (uint8_t*)allocate(membuf, words_of(length));
+    uint8_t* expected = (uint8_t*)allocate(membuf, words_of(length));
+
+    if (decoded == NULL || expected == NULL) {
+        retval = CMOX_RSA_ERR_MEMORY_FAIL;
+    } else if (P_SignatureLen != length) {
+        retval = CMOX_RSA_ERR_INVALID_SIGNATURE;
+    } else if (!pkcs1v15_encode(&P_HashId->hash, P_pDigest, expected, length)) {
+        retval = CMOX_RSA_ERR_MODULUS_TOO_SHORT;
+    } else {
+        retval = rsa_public(P_pRsaCtx, P_pPubKey, P_pSignature, decoded);
+        if (retval == CMOX_RSA_SUCCESS) {
+            retval = equal_bytes(decoded, expected, length) ? CMOX_RSA_AUTH_SUCCESS : CMOX_RSA_AUTH_FAIL;
+        }
+    }
+    membuf->MemBufUsed = mark;
+    if (P_pFaultCheck != NULL) {
+        *P_pFaultCheck = retval;
+    }
+    return retval;
+}
+
+cmox_rsa_retval_t cmox_rsa_pkcs1v22_sign(cmox_rsa_handle_t *P_pRsaCtx, const cmox_rsa_key_t *P_pPrivKey,
+        const uint8_t *P_pDigest, const cmox_rsa_pkcs1v22_hash_t P_HashId, const uint8_t *P_pRandom,
+        size_t P_RandomLen, uint8_t *P_pSignature, size_t *P_pSignatureLen)
+{
+    if (P_pDigest == NULL || P_HashId == NULL || (P_pRandom == NULL && P_RandomLen > 0) || P_pSignature == NULL
+            || P_RandomLen > RSA_MAX_HASH_SIZE) {
+        return CMOX_RSA_ERR_BAD_PARAMETER;
+    }
+    cmox_rsa_retval_t retval = rsa_check(P_pRsaCtx, P_pPrivKey, true);
+    if (retval != CMOX_RSA_SUCCESS) {
+        return retval;
+    }
+
+    if (!pss_encode(&P_HashId->hash, P_pDigest, P_pRandom, P_RandomLen, P_pSignature, P_pPrivKey->mod_bitlen)) {
+        return CMOX_RSA_ERR_MODULUS_TOO_SHORT;
+    }
+    retval = rsa_private(P_pRsaCtx, P_pPrivKey, P_pSignature);
+    if (retval == CMOX_RSA_SUCCESS && P_pSignatureLen != NULL) {
+        *P_pSignatureLen = (P_pPrivKey->mod_bitlen + 7) / 8;
+    }
+    return retval;
+}
+
+cmox_rsa_retval_t cmox_rsa_pkcs1v22_verify(cmox_rsa_handle_t *P_pRsaCtx, const cmox_rsa_key_t *P_pPubKey,
+        const uint8_t *P_pDigest, const cmox_rsa_pkcs1v22_hash_t P_HashId, size_t P_RandomLen,
+        const uint8_t *P_pSignature, size_t P_SignatureLen, uint32_t *P_pFaultCheck)
+{
+    if (P_pDigest == NULL || P_HashId == NULL || P_pSignature == NULL || P_RandomLen > RSA_MAX_HASH_SIZE) {
+        return CMOX_RSA_ERR_BAD_PARAMETER;
+    }
+    cmox_rsa_retval_t retval = rsa_check(P_pRsaCtx, P_pPubKey, false);
+    if (retval != CMOX_RSA_SUCCESS) {
+        return retval;
+    }
+
+    size_t length = (P_pPubKey->mod_bitlen + 7) / 8;
+    cmox_membuf_handle_st* membuf = &P_pRsaCtx->membuf_str;
+    size_t mark = membuf->MemBufUsed;
+    uint8_t* decoded = (uint8_t*)allocate(membuf, words_of(length));
+
+    if (decoded == NULL) {
+        retval = CMOX_RSA_ERR_MEMORY_FAIL;
+    } else if (P_SignatureLen != length) {
+        retval = CMOX_RSA_ERR_INVALID_SIGNATURE;
+    } else {
+        retval = rsa_public(P_pRsaCtx, P_pPubKey, P_pSignature, decoded);
+        if (retval == CMOX_RSA_SUCCESS) {
+            retval = pss_verify(&P_HashId->hash, P_pDigest, P_RandomLen, decoded, P_pPubKey->mod_bitlen)
+                    ? CMOX_RSA_AUTH_SUCCESS : CMOX_RSA_AUTH_FAIL;
+        }
+    }
+    membuf->MemBufUsed = mark;
+    if (P_pFaultCheck != NULL) {
+        *P_pFaultCheck = retval;
+    }
+    return retval;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * Take words from the working buffer, aligned on a word
+ * @return NULL if the buffer is full
+ */
+static uint32_t* allocate(cmox_membuf_handle_st* membuf, size_t words)
+{
+    size_t padding = -((uintptr_t)membuf->MemBuf + membuf->MemBufUsed) & (WORD_SIZE - 1);
+    size_t size = padding + words * WORD_SIZE;
+
+    if (membuf->MemBuf == NULL || membuf->MemBufUsed + size > membuf->MemBufSize) {
+        return NULL;
+    }
+    uint32_t* block = (uint32_t*)(membuf->MemBuf + membuf->MemBufUsed + padding);
+    membuf->MemBufUsed += size;
+    if (membuf->MemBufUsed > membuf->MaxMemUsed) {
+        membuf->MaxMemUsed = membuf->MemBufUsed;
+    }
+    return block;
+}
+
+static bool math_fits(cmox_math_funcs_t math, uint32_t bits)
+{
+    return math != NULL && bits >= math->min_bits && (math->max_bits == 0 || bits <= math->max_bits);
+}
+
+/**
+ * Check the context and the curve and take the workspace of an operation:
+ * the field, the order, the table of the window and the scratch points and
+ * numbers
+ */
+static cmox_ecc_retval_t ecc_begin(cmox_ecc_handle_t* ctx, cmox_ecc_impl_t impl, ecc_work_t* work)
+{
+    if (ctx == NULL || impl == NULL || ctx->magic_num_check != MAGIC_NUMBER) {
+        return CMOX_ECC_ERR_BAD_PARAMETERS;
+    }
+    if (!math_fits(ctx->math_ptr, impl->curve->bits)) {
+        return CMOX_ECC_ERR_MATHCURVE_MISMATCH;
+    }
+
+    work->membuf = &ctx->membuf_str;
+    work->mark = ctx->membuf_str.MemBufUsed;
+    work->curve = impl->curve;
+    work->words = impl->curve->words;
+    work->size = WORD_SIZE * work->words;
+    work->window = impl->window;
+    work->point_words = (impl->kind == ECC_WEIERSTRASS ? 3 : 4) * work->words;
+
+    uint32_t* ec = allocate(work->membuf, PK_REF_EC_WORDS(work->words));
+    uint32_t* order = allocate(work->membuf, PK_REF_MOD_WORDS(work->words));
+    work->table = allocate(work->membuf, (1 << work->window) * work->point_words);
+    work->points = allocate(work->membuf, ECC_POINTS * work->point_words);
+    work->numbers = allocate(work->membuf, ECC_NUMBERS * work->words);
+    if (ec == NULL || order == NULL || work->table == NULL || work->points == NULL || work->numbers == NULL) {
+        ctx->membuf_str.MemBufUsed = work->mark;
+        return CMOX_ECC_ERR_MEMORY_FAIL;
+    }
+
+    pk_ref_ec_init(&work->ec, work->curve, ec);
+    pk_ref_mod_init(&work->order, work->curve->n, work->words, order);
+    return CMOX_ECC_SUCCESS;
+}
+
+static void ecc_end(ecc_work_t* work)
+{
+    work->membuf->MemBufUsed = work->mark;
+}
+
+/**
+ * @return true if x is in [1, n - 1]
+ */
+static bool in_order(const ecc_work_t* work, const uint32_t* x)
+{
+    return !pk_ref_is_zero(x, work->words) && pk_ref_compare(x, work->curve->n, work->words) < 0;
+}
+
+static void base_point(ecc_work_t* work, uint32_t* point)
+{
+    pk_ref_ec_from_affine(&work->ec, point, work->curve->gx, work->curve->gy);
+}
+
+/**
+ * r = a^-1 mod n in the Montgomery domain, the table as workspace
+ */
+static void inverse_order(ecc_work_t* work, uint32_t* r, const uint32_t* a)
+{
+    pk_ref_mod_to_mont(&work->order, work->table, a);
+    pk_ref_mod_exp(&work->order, r, work->table, work->curve->n_minus_2, work->words, 1,
+            &work->table[work->words]);
+}
+
+/**
+ * @return false if the uncompressed key x || y is not a point of the curve
+ */
+static bool read_public_key(ecc_work_t* work, uint32_t* point, const uint8_t* key, size_t length)
+{
+    uint32_t* x = N(6);
+    uint32_t* y = N(7);
+
+    if (length != 2 * work->size) {
+        return false;
+    }
+    pk_ref_from_bytes(x, work->words, key, work->size);
+    pk_ref_from_bytes(y, work->words, key + work->size, work->size);
+    if (!pk_ref_ec_on_curve(&work->ec, x, y)) {
+        return false;
+    }
+    pk_ref_ec_from_affine(&work->ec, point, x, y);
+    return true;
+}
+
+static void write_affine(ecc_work_t* work, uint8_t* output, const uint32_t* point)
+{
+    uint32_t* x = N(6);
+    uint32_t* y = N(7);
+
+    pk_ref_ec_to_affine(&work->ec, x, y, point);
+    pk_ref_to_bytes(output, work->size, x, work->words);
+    pk_ref_to_bytes(output + work->size, work->size, y, work->words);
+}
+
+static cmox_ecc_retval_t x25519(ecc_work_t* work, const uint8_t* private_key, size_t private_length,
+        const uint8_t* public_key, size_t public_length, uint8_t* secret, size_t* secret_length)
+{
+    if (private_length != CMOX_ECC_CURVE25519_PRIVKEY_LEN) {
+        return CMOX_ECC_ERR_BAD_PARAMETERS;
+    }
+    if (public_length != CMOX_ECC_CURVE25519_PUBKEY_LEN) {
+        return CMOX_ECC_ERR_INVALID_PUBKEY;
+    }
+    pk_ref_x25519(&work->ec, secret, private_key, public_key);
+    if (secret_length != NULL) {
+        *secret_length = CMOX_ECC_CURVE25519_SECRET_LEN;
+    }
+    return CMOX_ECC_SUCCESS;
+}
+
+/**
+ * H(seed), the clamped scalar a from its first half
+ */
+static void eddsa_expand(ecc_work_t* work, uint8_t* hash, uint32_t* scalar, const uint8_t* seed)
+{
+    sha512(hash, seed, EDDSA_KEY_SIZE, NULL, 0, NULL, 0);
+    hash[0] &= 0xF8;
+    hash[EDDSA_KEY_SIZE - 1] = (hash[EDDSA_KEY_SIZE - 1] & 0x7F) | 0x40;
+    from_little_endian(scalar, work->words, hash, EDDSA_KEY_SIZE);
+}
+
+/**
+ * r = H(prefix || middle || message) mod n, middle is optional
+ */
+static void eddsa_challenge(ecc_work_t* work, uint32_t* r, const uint8_t* prefix, const uint8_t* middle,
+        const uint8_t* message, size_t length)
+{
+    uint8_t hash[EDDSA_HASH_SIZE];
+    uint32_t* wide = N(2); // and N(3)
+
+    sha512(hash, prefix, EDDSA_KEY_SIZE, middle, middle != NULL ? EDDSA_KEY_SIZE : 0, message, length);
+    from_little_endian(wide, 2 * work->words, hash, EDDSA_HASH_SIZE);
+    pk_ref_mod_reduce(&work->order, r, wide, 2 * work->words);
+}
+
+static void sha512(uint8_t* digest, const uint8_t* first, size_t first_length, const uint8_t* second,
+        size_t second_length, const uint8_t* third, size_t third_length)
+{
+    cmox_sha512_handle_t handle;
+    cmox_hash_handle_t* hash = cmox_sha512_construct(&handle);
+
+    cmox_hash_init(hash);
+    cmox_hash_append(hash, first, first_length);
+    if (second_length > 0) {
+        cmox_hash_append(hash, second, second_length);
+    }
+    if (third_length > 0) {
+        cmox_hash_append(hash, third, third_length);
+    }
+    cmox_hash_generateTag(hash, digest, NULL);
+    cmox_hash_cleanup(hash);
+}
+
+static void from_little_endian(uint32_t* x, uint32_t words, const uint8_t* bytes, uint32_t length)
+{
+    memset(x, 0, words * sizeof(uint32_t));
+    for (uint32_t i = 0; i < length; i++) {
+        x[i / WORD_SIZE] |= (uint32_t)bytes[i] << (8 * (i % WORD_SIZE));
+    }
+}
+
+static void to_little_endian(uint8_t* bytes, uint32_t length, const uint32_t* x)
+{
+    for (uint32_t i = 0; i < length; i++) {
+        bytes[i] = x[i / WORD_SIZE] >> (8 * (i % WORD_SIZE));
+    }
+}
+
+static uint32_t words_of(size_t bytes)
+{
+    return (bytes + WORD_SIZE - 1) / WORD_SIZE;
+}
+
+static size_t bit_length(const uint8_t* bytes, size_t length)
+{
+    size_t i = 0;
+    while (i < length && bytes[i] == 0) {
+        i++;
+    }
+    if (i == length) {
+        return 0;
+    }
+
+    size_t bits = 8 * (length - i);
+    for (uint8_t top = bytes[i]; (top & 0x80) == 0; top <<= 1) {
+        bits--;
+    }
+    return bits;
+}
+
+static cmox_rsa_retval_t rsa_check(cmox_rsa_handle_t* ctx, const cmox_rsa_key_t* key, bool private_key)
+{
+    if (ctx == NULL || key == NULL || key->f == NULL || ctx->modexp_ptr == NULL
+            || ctx->magic_num_check != MAGIC_NUMBER) {
+        return CMOX_RSA_ERR_BAD_PARAMETER;
+    }
+    if (!math_fits(ctx->math_ptr, key->mod_bitlen)) {
+        return CMOX_RSA_ERR_MATH_ALGO_MISMATCH;
+    }
+    if (private_key && !ctx->modexp_ptr->private_key) {
+        return CMOX_RSA_ERR_MEXP_ALGO_MISMATCH;
+    }
+    if (!private_key && key->f->crt) {
+        return CMOX_RSA_ERR_BAD_PARAMETER;
+    }
+    return CMOX_RSA_SUCCESS;
+}
+
+/**
+ * block = block^d mod n in place, with the CRT when the key has it:
+ * m1 = m^dp mod p, m2 = m^dq mod q, s = m2 + q (iq (m1 - m2) mod p)
+ */
+static cmox_rsa_retval_t rsa_private(cmox_rsa_handle_t* ctx, const cmox_rsa_key_t* key, uint8_t* block)
+{
+    cmox_membuf_handle_st* membuf = &ctx->membuf_str;
+    size_t mark = membuf->MemBufUsed;
+    size_t length = (key->mod_bitlen + 7) / 8;
+    uint32_t words = words_of(length);
+    uint32_t window = ctx->modexp_ptr->window;
+
+    if (!key->f->crt) {
+        uint32_t* workspace = allocate(membuf, PK_REF_MOD_WORDS(words));
+        uint32_t* table = allocate(membuf, (1 << window) * words);
+        uint32_t* modulus = allocate(membuf, words);
+        uint32_t* x = allocate(membuf, 3 * words);
+        if (workspace == NULL || table == NULL || modulus == NULL || x == NULL) {
+            membuf->MemBufUsed = mark;
+            return CMOX_RSA_ERR_MEMORY_FAIL;
+        }
+
+        pk_ref_from_bytes(modulus, words, key->fields.std.mod, length);
+        pk_ref_from_bytes(x, words, block, length);
+        if (pk_ref_compare(x, modulus, words) >= 0) {
+            membuf->MemBufUsed = mark;
+            return CMOX_RSA_ERR_BAD_PARAMETER;
+        }
+
+        pk_ref_mod_t mod;
+        pk_ref_mod_init(&mod, modulus, words, workspace);
+        rsa_exp(&mod, &x[words], x, key->fields.std.exp, key->fields.std.exp_len, &x[2 * words], window, table);
+        pk_ref_to_bytes(block, length, &x[words], words);
+        membuf->MemBufUsed = mark;
+        return CMOX_RSA_SUCCESS;
+    }
+
+    uint32_t half = words_of(key->fields.crt.p_len > key->fields.crt.q_len ? key->fields.crt.p_len
+            : key->fields.crt.q_len);
+    uint32_t wide = 2 * half > words ? 2 * half : words;
+    uint32_t* workspace = allocate(membuf, PK_REF_MOD_WORDS(half));
+    uint32_t* table = allocate(membuf, (1 << window) * half);
+    uint32_t* m = allocate(membuf, wide);
+    uint32_t* prime = allocate(membuf, half);
+    uint32_t* exponent = allocate(membuf, half);
+    uint32_t* m1 = allocate(membuf, half);
+    uint32_t* m2 = allocate(membuf, half);
+    uint32_t* x = allocate(membuf, half);
+    if (workspace == NULL || table == NULL || m == NULL || prime == NULL || exponent == NULL || m1 == NULL
+            || m2 == NULL || x == NULL) {
+        membuf->MemBufUsed = mark;
+        return CMOX_RSA_ERR_MEMORY_FAIL;
+    }
+
+    pk_ref_mod_t mod;
+    pk_ref_from_bytes(m, wide, block, length);
+
+    pk_ref_from_bytes(prime, half, key->fields.crt.q, key->fields.crt.q_len);
+    pk_ref_mod_init(&mod, prime, half, workspace);
+    pk_ref_mod_reduce(&mod, x, m, wide);
+    rsa_exp(&mod, m2, x, key->fields.crt.dq, key->fields.crt.dq_len, exponent, window, table);
+
+    pk_ref_from_bytes(prime, half, key->fields.crt.p, key->fields.crt.p_len);
+    pk_ref_mod_init(&mod, prime, half, workspace);
+    pk_ref_mod_reduce(&mod, x, m, wide);
+    rsa_exp(&mod, m1, x, key->fields.crt.dp, key->fields.crt.dp_len, exponent, window, table);
+
+    // h = iq (m1 - m2) mod p
+    pk_ref_mod_reduce(&mod, x, m2, half);
+    pk_ref_mod_sub(&mod, m1, m1, x);
+    pk_ref_mod_to_mont(&mod, m1, m1);
+    pk_ref_from_bytes(exponent, half, key->fields.crt.iq, key->fields.crt.iq_len);
+    pk_ref_mod_reduce(&mod, x, exponent, half);
+    pk_ref_mod_mul(&mod, x, m1, x);
+
+    pk_ref_from_bytes(prime, half, key->fields.crt.q, key->fields.crt.q_len);
+    pk_ref_multiply(m, prime, half, x, half);
+    memset(&m[2 * half], 0, (wide - 2 * half) * sizeof(uint32_t));
+    add_words(m, wide, m2, half);
+    pk_ref_to_bytes(block, length, m, wide);
+    membuf->MemBufUsed = mark;
+    return CMOX_RSA_SUCCESS;
+}
+
+/**
+ * output = input^e mod n
+ */
+static cmox_rsa_retval_t rsa_public(cmox_rsa_handle_t* ctx, const cmox_rsa_key_t* key, const uint8_t* input,
+        uint8_t* output)
+{
+    cmox_membuf_handle_st* membuf = &ctx->membuf_str;
+    size_t mark = membuf->MemBufUsed;
+    size_t length = (key->mod_bitlen + 7) / 8;
+    uint32_t words = words_of(length);
+    uint32_t window = ctx->modexp_ptr->window;
+    uint32_t* workspace = allocate(membuf, PK_REF_MOD_WORDS(words));
+    uint32_t* table = allocate(membuf, (1 << window) * words);
+    uint32_t* modulus = allocate(membuf, words);
+    uint32_t* x = allocate(membuf, 2 * words);
+    uint32_t* exponent = allocate(membuf, words_of(key->fields.std.exp_len));
+
+    if (workspace == NULL || table == NULL || modulus == NULL || x == NULL || exponent == NULL) {
+        membuf->MemBufUsed = mark;
+        return CMOX_RSA_ERR_MEMORY_FAIL;
+    }
+
+    pk_ref_from_bytes(modulus, words, key->fields.std.mod, length);
+    pk_ref_from_bytes(x, words, input, length);
+    if (pk_ref_compare(x, modulus, words) >= 0) {
+        membuf->MemBufUsed = mark;
+        return CMOX_RSA_ERR_INVALID_SIGNATURE;
+    }
+
+    pk_ref_mod_t mod;
+    pk_ref_mod_init(&mod, modulus, words, workspace);
+    rsa_exp(&mod, &x[words], x, key->fields.std.exp, key->fields.std.exp_len, exponent, window, table);
+    pk_ref_to_bytes(output, length, &x[words], words);
+    membuf->MemBufUsed = mark;
+    return CMOX_RSA_SUCCESS;
+}
+
+/**
+ * r = x^exponent, plain numbers lower than the modulus, x is overwritten
+ * @param exponent_words workspace of the exponent as words
+ */
+static void rsa_exp(const pk_ref_mod_t* mod, uint32_t* r, uint32_t* x, const uint8_t* exponent, size_t exponent_length,
+        uint32_t* exponent_words, uint32_t window, uint32_t* table)
+{
+    uint32_t words = words_of(exponent_length);
+
+    pk_ref_from_bytes(exponent_words, words, exponent, exponent_length);
+    pk_ref_mod_to_mont(mod, x, x);
+    pk_ref_mod_exp(mod, r, x, exponent_words, words, window, table);
+    pk_ref_mod_from_mont(mod, r, r);
+}
+
+/**
+ * EMSA-PKCS1-v1_5 (RFC 8017, section 9.2)
+ * @return false if the modulus is too short
+ */
+static bool pkcs1v15_encode(const rsa_hash_t* hash, const uint8_t* digest, uint8_t* block, size_t length)
+{
+    size_t info = hash->prefix_size + hash->size;
+
+    if (length < info + PKCS1V15_MIN_PADDING) {
+        return false;
+    }
+    block[0] = 0x00;
+    block[1] = 0x01;
+    memset(&block[2], 0xFF, length - info - 3);
+    block[length - info - 1] = 0x00;
+    memcpy(&block[length - info], hash->prefix, hash->prefix_size);
+    memcpy(&block[length - hash->size], digest, hash->size);
+    return true;
+}
+
+/**
+ * EMSA-PSS encoding (RFC 8017, section 9.1.1) with MGF1 of the same hash,
+ * the encoded message of bits - 1 bits is right-aligned in the block
+ * @return false if the modulus is too short
+ */
+static bool pss_encode(const rsa_hash_t* hash, const uint8_t* digest, const uint8_t* salt, size_t salt_length,
+        uint8_t* block, size_t bits)
+{
+    size_t length = (bits + 7) / 8;
+    size_t em_length = (bits - 1 + 7) / 8;
+    uint8_t* em = block + length - em_length;
+    size_t db_length = em_length - hash->size - 1;
+
+    if (em_length < hash->size + salt_length + 2) {
+        return false;
+    }
+    block[0] = 0x00;
+    pss_hash(hash, em + db_length, digest, salt, salt_length);
+    memset(em, 0, db_length - salt_length - 1);
+    em[db_length - salt_length - 1] = 0x01;
+    memcpy(em + db_length - salt_length, salt, salt_length);
+    mgf1_mask(hash, em, db_length, em + db_length);
+    em[0] &= 0xFF >> (8 * em_length - (bits - 1));
+    em[em_length - 1] = PSS_TRAILER;
+    return true;
+}
+
+/**
+ * EMSA-PSS verification (RFC 8017, section 9.1.2), the block is unmasked
+ */
+static bool pss_verify(const rsa_hash_t* hash, const uint8_t* digest, size_t salt_length, uint8_t* block, size_t bits)
+{
+    size_t length = (bits + 7) / 8;
+    size_t em_length = (bits - 1 + 7) / 8;
+    uint8_t* em = block + length - em_length;
+    uint8_t mask = 0xFF >> (8 * em_length - (bits - 1));
+    uint8_t expected[RSA_MAX_HASH_SIZE];
+
+    if (em_length < hash->size + salt_length + 2 || (length > em_length && block[0] != 0)
+            || em[em_length - 1] != PSS_TRAILER || (em[0] & ~mask) != 0) {
+        return false;
+    }
+
+    size_t db_length = em_length - hash->size - 1;
+    mgf1_mask(hash, em, db_length, em + db_length);
+    em[0] &= mask;
+    for (size_t i = 0; i < db_length - salt_length - 1; i++) {
+        if (em[i] != 0) {
+            return false;
+        }
+    }
+    if (em[db_length - salt_length - 1] != 0x01) {
+        return false;
+    }
+    pss_hash(hash, expected, digest, em + db_length - salt_length, salt_length);
+    return equal_bytes(expected, em + db_length, hash->size);
+}
+
+/**
+ * H(0x00 * 8 || digest || salt)
+ */
+static void pss_hash(const rsa_hash_t* hash, uint8_t* output, const uint8_t* digest, const uint8_t* salt,
+        size_t salt_length)
+{
+    uint8_t message[PSS_ZEROS + 2 * RSA_MAX_HASH_SIZE];
+
+    memset(message, 0, PSS_ZEROS);
+    memcpy(&message[PSS_ZEROS], digest, hash->size);
+    memcpy(&message[PSS_ZEROS + hash->size], salt, salt_length);
+    cmox_hash_compute(*hash->algo, message, PSS_ZEROS + hash->size + salt_length, output, hash->size, NULL);
+}
+
+/**
+ * data ^= MGF1(seed), the seed is a digest
+ */
+static void mgf1_mask(const rsa_hash_t* hash, uint8_t* data, size_t length, const uint8_t* seed)
+{
+    uint8_t input[RSA_MAX_HASH_SIZE + RSA_MGF1_COUNTER_SIZE];
+    uint8_t mask[RSA_MAX_HASH_SIZE];
+
+    memcpy(input, seed, hash->size);
+    for (uint32_t counter = 0; length > 0; counter++) {
+        input[hash->size] = counter >> 24;
+        input[hash->size + 1] = counter >> 16;
+        input[hash->size + 2] = counter >> 8;
+        input[hash->size + 3] = counter;
+        cmox_hash_compute(*hash->algo, input, hash->size + RSA_MGF1_COUNTER_SIZE, mask, hash->size, NULL);
+
+        size_t size = length < hash->size ? length : hash->size;
+        for (size_t i = 0; i < size; i++) {
+            data[i] ^= mask[i];
+        }
+        data += size;
+        length -= size;
+    }
+}
+
+/**
+ * r += a, the carry is dropped beyond r_words
+ */
+static void add_words(uint32_t* r, uint32_t r_words, const uint32_t* a, uint32_t a_words)
+{
+    uint64_t carry = 0;
+    for (uint32_t i = 0; i < r_words; i++) {
+        carry += (uint64_t)r[i] + (i < a_words ? a[i] : 0);
+        r[i] = carry;
+        carry >>= 32;
+    }
+}
+
+static bool equal_bytes(const uint8_t* x, const uint8_t* y, size_t length)
+{
+    uint8_t difference = 0;
+    for (size_t i = 0; i < length; i++) {
+        difference |= x[i] ^ y[i];
+    }
+    return difference == 0;
+}
@@ -0,0 +1,2637 @@
+/**
+ ******************************************************************************
+ * @file    cmox_shim.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   subset of the CMOX API for the host build
+ *
+ * The cryptographic library is only delivered for the Cortex-M, this file
+ * implements the functions used by the firmware on top of the reference AES:
+ * ECB, CBC, CTR, CFB and OFB, GCM and CCM (one-shot and handles),
+ * XTS and the Key Wrap of RFC 3394 (one-shot and handles), then
+ * ChaCha20-Poly1305 of RFC 8439 (one-shot and handles), and on top of the
+ * reference hashes: SHA-1, SHA-2, SHA-3, SHAKE and SM3,
+ * HMAC, KMAC and the AES-CMAC (one-shot and handles). The FAST and SMALL
+ * variants are the same code.
+ * The other algorithms return CMOX_CIPHER_ERR_NOT_IMPLEMENTED.
+ * The cipher handle functions process the data by whole blocks (64 bytes for
+ * ChaCha20): only the last append of a message can have a partial block.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "cmox_crypto.h"
+#include "cmox_low_level.h"
+
+#include "aes_ref.h"
+#include "hash_ref.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define GCM_IV_SIZE 12
+#define CCM_MAX_AD_SIZE 0xFEFF // the 2-byte length encoding only
+#define CMAC_RB 0x87
+#define XTS_RB 0x87 // of the little-endian tweak
+#define XTS_STOLEN 1 // internal state, the last partial block is processed
+#define KEYWRAP_SEMIBLOCK_SIZE 8
+#define KEYWRAP_ROUNDS 6
+#define CHACHA_BLOCK_SIZE 64
+#define CHACHA_KEY_SIZE 32
+#define CHACHA_NONCE_SIZE 12
+#define CHACHA_ROUNDS 20
+#define POLY_BLOCK_SIZE 16
+#define POLY_TAG_SIZE 16
+#define POLY_LIMB_MASK 0x3ffffff // 26 bits
+#define ROTATE(x, n) ((x) << (n) | (x) >> (32 - (n)))
+#define QUARTER_ROUND(a, b, c, d) \
+    a += b; d ^= a; d = ROTATE(d, 16); \
+    c += d; b ^= c; b = ROTATE(b, 12); \
+    a += b; d ^= a; d = ROTATE(d, 8); \
+    c += d; b ^= c; b = ROTATE(b, 7)
+#define HMAC_IPAD 0x36
+#define HMAC_OPAD 0x5C
+#define MAC_MAX_SIZE 64 // the tags of HMAC-SHA512 and of the KMAC
+// first padding bits of the sponges after the domain separation bits
+#define SHA3_SUFFIX 0x06
+#define SHAKE_SUFFIX 0x1F
+#define CSHAKE_SUFFIX 0x04
+#define SPONGE_LAST_BIT 0x80
+#define SHAKE128_RATE 168
+#define SHAKE256_RATE 136
+
+#define CIPHER_ALGO(name, mode, decrypt) \
+    static const struct cmox_cipher_algoStruct_st name##_struct = {{mode, decrypt, false}}; \
+    const cmox_cipher_algo_t name = &name##_struct
+
+#define AEAD_ALGO(name, mode, decrypt) \
+    static const struct cmox_aead_algoStruct_st name##_struct = {{mode, decrypt, false}}; \
+    const cmox_aead_algo_t name = &name##_struct
+
+#define HASH_ALGO(name, family, md, size, rate, suffix) \
+    static const struct cmox_hash_algoStruct_st name##_struct = {{family, md, size, rate, suffix}}; \
+    const cmox_hash_algo_t name = &name##_struct
+
+// the implementation for the handles and the algorithm of the one-shot
+// functions, with the same description
+#define MAC_ALGO(impl_type, impl, name, type, hash, size, rate) \
+    static const struct impl_type##_implStruct_st impl##_struct = {{type, hash, size, rate}}; \
+    const impl_type##_impl_t impl = &impl##_struct; \
+    static const struct cmox_mac_algoStruct_st name##_struct = {{type, hash, size, rate}}; \
+    const cmox_mac_algo_t name = &name##_struct
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef enum {
+    MODE_ECB,
+    MODE_CBC,
+    MODE_CTR,
+    MODE_CFB,
+    MODE_OFB,
+    MODE_GCM,
+    MODE_CCM,
+    MODE_XTS,
+    MODE_KEYWRAP,
+    MODE_CHACHAPOLY,
+    MODE_UNSUPPORTED,
+} cipher_mode_t;
+
+struct cmox_cipher_vtableStruct_st {
+    cipher_mode_t mode;
+    bool decrypt;
+    bool table8x16; // the GCM handle is a cmox_gcmFast_handle_t
+};
+
+struct cmox_cipher_algoStruct_st {
+    struct cmox_cipher_vtableStruct_st vtable;
+};
+
+struct cmox_aead_algoStruct_st {
+    struct cmox_cipher_vtableStruct_st vtable;
+};
+
+typedef enum {
+    HASH_SMALL, // Merkle-Damgard on 32-bit words
+    HASH_LARGE, // Merkle-Damgard on 64-bit words
+    HASH_SPONGE,
+} hash_family_t;
+
+struct cmox_hash_vtableStruct_st {
+    hash_family_t family;
+    hash_ref_md_t md;
+    size_t size;    // of the digest, the default one of SHAKE
+    size_t rate;    // bytes of input per block or per permutation
+    uint8_t suffix; // of the sponges, SHAKE has an extendable output
+};
+
+struct cmox_hash_algoStruct_st {
+    struct cmox_hash_vtableStruct_st vtable;
+};
+
+typedef enum {
+    MAC_CMAC,
+    MAC_HMAC,
+    MAC_KMAC,
+} mac_type_t;
+
+struct cmox_mac_vtableStruct_st {
+    mac_type_t type;
+    const struct cmox_hash_vtableStruct_st* hash; // of the HMAC
+    size_t size;                                  // default size of the tag
+    size_t rate;                                  // of the KMAC
+};
+
+struct cmox_mac_algoStruct_st {
+    struct cmox_mac_vtableStruct_st vtable;
+};
+
+struct cmox_cmac_implStruct_st {
+    struct cmox_mac_vtableStruct_st vtable;
+};
+
+struct cmox_hmac_implStruct_st {
+    struct cmox_mac_vtableStruct_st vtable;
+};
+
+struct cmox_kmac_implStruct_st {
+    struct cmox_mac_vtableStruct_st vtable;
+};
+
+// handles of the one-shot functions
+typedef union {
+    cmox_hash_handle_t super;
+    cmox_mdSmall_handle_t md_small;
+    cmox_mdLarge_handle_t md_large;
+    cmox_sha3_handle_t sha3;
+} hash_handle_t;
+
+typedef union {
+    cmox_mac_handle_t super;
+    cmox_cmac_handle_t cmac;
+    cmox_hmac_handle_t hmac;
+    cmox_kmac_handle_t kmac;
+} mac_handle_t;
+
+// handles of the one-shot functions built on the handle functions, the GCM
+// one is constructed small but is as large as a fast one, gcm_common() and
+// gcm_hash_key() reading it through either type
+typedef union {
+    cmox_cipher_handle_t super;
+    cmox_xts_handle_t xts;
+    cmox_keywrap_handle_t keywrap;
+    cmox_gcmSmall_handle_t gcm;
+    cmox_gcmFast_handle_t gcm_fast;
+    cmox_chachapoly_handle_t chachapoly;
+} cipher_handle_t;
+
+struct cmox_ecb_implStruct_st {
+    struct cmox_cipher_vtableStruct_st vtable;
+};
+
+struct cmox_cbc_implStruct_st {
+    struct cmox_cipher_vtableStruct_st vtable;
+};
+
+struct cmox_ctr_implStruct_st {
+    struct cmox_cipher_vtableStruct_st vtable;
+};
+
+struct cmox_cfb_implStruct_st {
+    struct cmox_cipher_vtableStruct_st vtable;
+};
+
+struct cmox_ofb_implStruct_st {
+    struct cmox_cipher_vtableStruct_st vtable;
+};
+
+struct cmox_ccm_implStruct_st {
+    struct cmox_cipher_vtableStruct_st vtable;
+};
+
+struct cmox_xts_implStruct_st {
+    struct cmox_cipher_vtableStruct_st vtable;
+};
+
+struct cmox_keywrap_implStruct_st {
+    struct cmox_cipher_vtableStruct_st vtable;
+};
+
+struct cmox_chachapoly_implStruct_st {
+    struct cmox_cipher_vtableStruct_st vtable;
+};
+
+struct cmox_gcmFast_implStruct_st {
+    struct cmox_cipher_vtableStruct_st vtable;
+};
+
+struct cmox_gcmSmall_implStruct_st {
+    struct cmox_cipher_vtableStruct_st vtable;
+};
+
+/* Private variables ---------------------------------------------------------*/
+
+CIPHER_ALGO(CMOX_AESFAST_ECB_ENC_ALGO, MODE_ECB, false);
+CIPHER_ALGO(CMOX_AESFAST_ECB_DEC_ALGO, MODE_ECB, true);
+CIPHER_ALGO(CMOX_AESFAST_CBC_ENC_ALGO, MODE_CBC, false);
+CIPHER_ALGO(CMOX_AESFAST_CBC_DEC_ALGO, MODE_CBC, true);
+CIPHER_ALGO(CMOX_AESFAST_CTR_ENC_ALGO, MODE_CTR, false);
+CIPHER_ALGO(CMOX_AESFAST_CTR_DEC_ALGO, MODE_CTR, true);
+CIPHER_ALGO(CMOX_AESFAST_CFB_ENC_ALGO, MODE_CFB, false);
+CIPHER_ALGO(CMOX_AESFAST_CFB_DEC_ALG, MODE_CFB, true);
+CIPHER_ALGO(CMOX_AESFAST_OFB_ENC_ALGO, MODE_OFB, false);
+CIPHER_ALGO(CMOX_AESFAST_OFB_DEC_ALGO, MODE_OFB, true);
+CIPHER_ALGO(CMOX_AESSMALL_ECB_ENC_ALGO, MODE_ECB, false);
+CIPHER_ALGO(CMOX_AESSMALL_ECB_DEC_ALGO, MODE_ECB, true);
+CIPHER_ALGO(CMOX_AESSMALL_CBC_ENC_ALGO, MODE_CBC, false);
+CIPHER_ALGO(CMOX_AESSMALL_CBC_DEC_ALGO, MODE_CBC, true);
+CIPHER_ALGO(CMOX_AESSMALL_CTR_ENC_ALGO, MODE_CTR, false);
+CIPHER_ALGO(CMOX_AESSMALL_CTR_DEC_ALGO, MODE_CTR, true);
+CIPHER_ALGO(CMOX_AESSMALL_CFB_ENC_ALGO, MODE_CFB, false);
+CIPHER_ALGO(CMOX_AESSMALL_CFB_DEC_ALGO, MODE_CFB, true);
+CIPHER_ALGO(CMOX_AESSMALL_OFB_ENC_ALGO, MODE_OFB, false);
+CIPHER_ALGO(CMOX_AESSMALL_OFB_DEC_ALGO, MODE_OFB, true);
+CIPHER_ALGO(CMOX_AESFAST_XTS_ENC_ALGO, MODE_XTS, false);
+CIPHER_ALGO(CMOX_AESFAST_XTS_DEC_ALGO, MODE_XTS, true);
+CIPHER_ALGO(CMOX_AESSMALL_XTS_ENC_ALGO, MODE_XTS, false);
+CIPHER_ALGO(CMOX_AESSMALL_XTS_DEC_ALGO, MODE_XTS, true);
+CIPHER_ALGO(CMOX_AESFAST_KEYWRAP_ENC_ALGO, MODE_KEYWRAP, false);
+CIPHER_ALGO(CMOX_AESFAST_KEYWRAP_DEC_ALGO, MODE_KEYWRAP, true);
+CIPHER_ALGO(CMOX_AESSMALL_KEYWRAP_ENC_ALGO, MODE_KEYWRAP, false);
+CIPHER_ALGO(CMOX_AESSMALL_KEYWRAP_DEC_ALGO, MODE_KEYWRAP, true);
+
+AEAD_ALGO(CMOX_AESFAST_GCMFAST_ENC_ALGO, MODE_GCM, false);
+AEAD_ALGO(CMOX_AESFAST_GCMFAST_DEC_ALGO, MODE_GCM, true);
+AEAD_ALGO(CMOX_AESFAST_GCMSMALL_ENC_ALGO, MODE_GCM, false);
+AEAD_ALGO(CMOX_AESFAST_GCMSMALL_DEC_ALGO, MODE_GCM, true);
+AEAD_ALGO(CMOX_AESSMALL_GCMFAST_ENC_ALGO, MODE_GCM, false);
+AEAD_ALGO(CMOX_AESSMALL_GCMFAST_DEC_ALGO, MODE_GCM, true);
+AEAD_ALGO(CMOX_AESSMALL_GCMSMALL_ENC_ALGO, MODE_GCM, false);
+AEAD_ALGO(CMOX_AESSMALL_GCMSMALL_DEC_ALGO, MODE_GCM, true);
+AEAD_ALGO(CMOX_AESFAST_CCM_ENC_ALGO, MODE_CCM, false);
+AEAD_ALGO(CMOX_AESFAST_CCM_DEC_ALGO, MODE_CCM, true);
+AEAD_ALGO(CMOX_AESSMALL_CCM_ENC_ALGO, MODE_CCM, false);
+AEAD_ALGO(CMOX_AESSMALL_CCM_DEC_ALGO, MODE_CCM, true);
+AEAD_ALGO(CMOX_CHACHAPOLY_ENC_ALGO, MODE_CHACHAPOLY, false);
+AEAD_ALGO(CMOX_CHACHAPOLY_DEC_ALGO, MODE_CHACHAPOLY, true);
+
+HASH_ALGO(CMOX_SHA1_ALGO, HASH_SMALL, HASH_REF_SHA1, 20, HASH_REF_SMALL_BLOCK_SIZE, 0);
+HASH_ALGO(CMOX_SHA224_ALGO, HASH_SMALL, HASH_REF_SHA224, 28, HASH_REF_SMALL_BLOCK_SIZE, 0);
+HASH_ALGO(CMOX_SHA256_ALGO, HASH_SMALL, HASH_REF_SHA256, 32, HASH_REF_SMALL_BLOCK_SIZE, 0);
+HASH_ALGO(CMOX_SM3_ALGO, HASH_SMALL, HASH_REF_SM3, 32, HASH_REF_SMALL_BLOCK_SIZE, 0);
+HASH_ALGO(CMOX_SHA384_ALGO, HASH_LARGE, HASH_REF_SHA384, 48, HASH_REF_LARGE_BLOCK_SIZE, 0);
+HASH_ALGO(CMOX_SHA512_ALGO, HASH_LARGE, HASH_REF_SHA512, 64, HASH_REF_LARGE_BLOCK_SIZE, 0);
+HASH_ALGO(CMOX_SHA512_224_ALGO, HASH_LARGE, HASH_REF_SHA512_224, 28, HASH_REF_LARGE_BLOCK_SIZE, 0);
+HASH_ALGO(CMOX_SHA512_256_ALGO, HASH_LARGE, HASH_REF_SHA512_256, 32, HASH_REF_LARGE_BLOCK_SIZE, 0);
+HASH_ALGO(CMOX_SHA3_224_ALGO, HASH_SPONGE, 0, 28, 144, SHA3_SUFFIX);
+HASH_ALGO(CMOX_SHA3_256_ALGO, HASH_SPONGE, 0, 32, 136, SHA3_SUFFIX);
+HASH_ALGO(CMOX_SHA3_384_ALGO, HASH_SPONGE, 0, 48, 104, SHA3_SUFFIX);
+HASH_ALGO(CMOX_SHA3_512_ALGO, HASH_SPONGE, 0, 64, 72, SHA3_SUFFIX);
+HASH_ALGO(CMOX_SHAKE128_ALGO, HASH_SPONGE, 0, 32, SHAKE128_RATE, SHAKE_SUFFIX);
+HASH_ALGO(CMOX_SHAKE256_ALGO, HASH_SPONGE, 0, 64, SHAKE256_RATE, SHAKE_SUFFIX);
+
+MAC_ALGO(cmox_cmac, CMOX_CMAC_AESFAST, CMOX_CMAC_AESFAST_ALGO, MAC_CMAC, NULL, AES_REF_BLOCK_SIZE, 0);
+MAC_ALGO(cmox_cmac, CMOX_CMAC_AESSMALL, CMOX_CMAC_AESSMALL_ALGO, MAC_CMAC, NULL, AES_REF_BLOCK_SIZE, 0);
+MAC_ALGO(cmox_hmac, CMOX_HMAC_SHA1, CMOX_HMAC_SHA1_ALGO, MAC_HMAC, &CMOX_SHA1_ALGO_struct.vtable, 20, 0);
+MAC_ALGO(cmox_hmac, CMOX_HMAC_SHA224, CMOX_HMAC_SHA224_ALGO, MAC_HMAC, &CMOX_SHA224_ALGO_struct.vtable, 28, 0);
+MAC_ALGO(cmox_hmac, CMOX_HMAC_SHA256, CMOX_HMAC_SHA256_ALGO, MAC_HMAC, &CMOX_SHA256_ALGO_struct.vtable, 32, 0);
+MAC_ALGO(cmox_hmac, CMOX_HMAC_SHA384, CMOX_HMAC_SHA384_ALGO, MAC_HMAC, &CMOX_SHA384_ALGO_struct.vtable, 48, 0);
+MAC_ALGO(cmox_hmac, CMOX_HMAC_SHA512, CMOX_HMAC_SHA512_ALGO, MAC_HMAC, &CMOX_SHA512_ALGO_struct.vtable, 64, 0);
+MAC_ALGO(cmox_hmac, CMOX_HMAC_SHA512_224, CMOX_HMAC_SHA512_224_ALGO, MAC_HMAC, &CMOX_SHA512_224_ALGO_struct.vtable, 28, 0);
+MAC_ALGO(cmox_hmac, CMOX_HMAC_SHA512_256, CMOX_HMAC_SHA512_256_ALGO, MAC_HMAC, &CMOX_SHA512_256_ALGO_struct.vtable, 32, 0);
+MAC_ALGO(cmox_hmac, CMOX_HMAC_SM3, CMOX_HMAC_SM3_ALGO, MAC_HMAC, &CMOX_SM3_ALGO_struct.vtable, 32, 0);
+MAC_ALGO(cmox_kmac, CMOX_KMAC_128, CMOX_KMAC_128_ALGO, MAC_KMAC, NULL, 32, SHAKE128_RATE);
+MAC_ALGO(cmox_kmac, CMOX_KMAC_256, CMOX_KMAC_256_ALGO, MAC_KMAC, NULL, 64, SHAKE256_RATE);
+
+static const struct cmox_ecb_implStruct_st ecb_enc = {{MODE_ECB, false, false}};
+static const struct cmox_ecb_implStruct_st ecb_dec = {{MODE_ECB, true, false}};
+static const struct cmox_cbc_implStruct_st cbc_enc = {{MODE_CBC, false, false}};
+static const struct cmox_cbc_implStruct_st cbc_dec = {{MODE_CBC, true, false}};
+static const struct cmox_ctr_implStruct_st ctr_enc = {{MODE_CTR, false, false}};
+static const struct cmox_ctr_implStruct_st ctr_dec = {{MODE_CTR, true, false}};
+static const struct cmox_cfb_implStruct_st cfb_enc = {{MODE_CFB, false, false}};
+static const struct cmox_cfb_implStruct_st cfb_dec = {{MODE_CFB, true, false}};
+static const struct cmox_ofb_implStruct_st ofb_enc = {{MODE_OFB, false, false}};
+static const struct cmox_ofb_implStruct_st ofb_dec = {{MODE_OFB, true, false}};
+static const struct cmox_ccm_implStruct_st ccm_enc = {{MODE_CCM, false, false}};
+static const struct cmox_ccm_implStruct_st ccm_dec = {{MODE_CCM, true, false}};
+static const struct cmox_xts_implStruct_st xts_enc = {{MODE_XTS, false, false}};
+static const struct cmox_xts_implStruct_st xts_dec = {{MODE_XTS, true, false}};
+static const struct cmox_keywrap_implStruct_st keywrap_enc = {{MODE_KEYWRAP, false, false}};
+static const struct cmox_keywrap_implStruct_st keywrap_dec = {{MODE_KEYWRAP, true, false}};
+static const struct cmox_chachapoly_implStruct_st chachapoly_enc = {{MODE_CHACHAPOLY, false, false}};
+static const struct cmox_chachapoly_implStruct_st chachapoly_dec = {{MODE_CHACHAPOLY, true, false}};
+static const struct cmox_gcmFast_implStruct_st gcm_fast_enc = {{MODE_GCM, false, true}};
+static const struct cmox_gcmFast_implStruct_st gcm_fast_dec = {{MODE_GCM, true, true}};
+static const struct cmox_gcmSmall_implStruct_st gcm_small_enc = {{MODE_GCM, false, false}};
+static const struct cmox_gcmSmall_implStruct_st gcm_small_dec = {{MODE_GCM, true, false}};
+
+const cmox_ecb_impl_t CMOX_AESFAST_ECB_ENC = &ecb_enc;
+const cmox_ecb_impl_t CMOX_AESFAST_ECB_DEC = &ecb_dec;
+const cmox_ecb_impl_t CMOX_AESSMALL_ECB_ENC = &ecb_enc;
+const cmox_ecb_impl_t CMOX_AESSMALL_ECB_DEC = &ecb_dec;
+const cmox_cbc_impl_t CMOX_AESFAST_CBC_ENC = &cbc_enc;
+const cmox_cbc_impl_t CMOX_AESFAST_CBC_DEC = &cbc_dec;
+const cmox_cbc_impl_t CMOX_AESSMALL_CBC_ENC = &cbc_enc;
+const cmox_cbc_impl_t CMOX_AESSMALL_CBC_DEC = &cbc_dec;
+const cmox_ctr_impl_t CMOX_AESFAST_CTR_ENC = &ctr_enc;
+const cmox_ctr_impl_t CMOX_AESFAST_CTR_DEC = &ctr_dec;
+const cmox_ctr_impl_t CMOX_AESSMALL_CTR_ENC = &ctr_enc;
+const cmox_ctr_impl_t CMOX_AESSMALL_CTR_DEC = &ctr_dec;
+const cmox_cfb_impl_t CMOX_AESFAST_CFB_ENC = &cfb_enc;
+const cmox_cfb_impl_t CMOX_AESFAST_CFB_DEC = &cfb_dec;
+const cmox_cfb_impl_t CMOX_AESSMALL_CFB_ENC = &cfb_enc;
+const cmox_cfb_impl_t CMOX_AESSMALL_CFB_DEC = &cfb_dec;
+const cmox_ofb_impl_t CMOX_AESFAST_OFB_ENC = &ofb_enc;
+const cmox_ofb_impl_t CMOX_AESFAST_OFB_DEC = &ofb_dec;
+const cmox_ofb_impl_t CMOX_AESSMALL_OFB_ENC = &ofb_enc;
+const cmox_ofb_impl_t CMOX_AESSMALL_OFB_DEC = &ofb_dec;
+const cmox_ccm_impl_t CMOX_AESFAST_CCM_ENC = &ccm_enc;
+const cmox_ccm_impl_t CMOX_AESFAST_CCM_DEC = &ccm_dec;
+const cmox_ccm_impl_t CMOX_AESSMALL_CCM_ENC = &ccm_enc;
+const cmox_ccm_impl_t CMOX_AESSMALL_CCM_DEC = &ccm_dec;
+const cmox_xts_impl_t CMOX_AESFAST_XTS_ENC = &xts_enc;
+const cmox_xts_impl_t CMOX_AESFAST_XTS_DEC = &xts_dec;
+const cmox_xts_impl_t CMOX_AESSMALL_XTS_ENC = &xts_enc;
+const cmox_xts_impl_t CMOX_AESSMALL_XTS_DEC = &xts_dec;
+const cmox_keywrap_impl_t CMOX_AESFAST_KEYWRAP_ENC = &keywrap_enc;
+const cmox_keywrap_impl_t CMOX_AESFAST_KEYWRAP_DEC = &keywrap_dec;
+const cmox_keywrap_impl_t CMOX_AESSMALL_KEYWRAP_ENC = &keywrap_enc;
+const cmox_keywrap_impl_t CMOX_AESSMALL_KEYWRAP_DEC = &keywrap_dec;
+const cmox_chachapoly_impl_t CMOX_CHACHAPOLY_ENC = &chachapoly_enc;
+const cmox_chachapoly_impl_t CMOX_CHACHAPOLY_DEC = &chachapoly_dec;
+const cmox_gcmFast_impl_t CMOX_AESFAST_GCMFAST_ENC = &gcm_fast_enc;
+const cmox_gcmFast_impl_t CMOX_AESFAST_GCMFAST_DEC = &gcm_fast_dec;
+const cmox_gcmFast_impl_t CMOX_AESSMALL_GCMFAST_ENC = &gcm_fast_enc;
+const cmox_gcmFast_impl_t CMOX_AESSMALL_GCMFAST_DEC = &gcm_fast_dec;
+const cmox_gcmSmall_impl_t CMOX_AESFAST_GCMSMALL_ENC = &gcm_small_enc;
+const cmox_gcmSmall_impl_t CMOX_AESFAST_GCMSMALL_DEC = &gcm_small_dec;
+const cmox_gcmSmall_impl_t CMOX_AESSMALL_GCMSMALL_ENC = &gcm_small_enc;
+const cmox_gcmSmall_impl_t CMOX_AESSMALL_GCMSMALL_DEC = &gcm_small_dec;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static cmox_cipher_retval_t block_modes(const struct cmox_cipher_vtableStruct_st* vtable, const uint8_t* input, size_t length,
+        const uint8_t* key, size_t key_size, const uint8_t* iv, size_t iv_size, uint8_t* output, size_t* output_length);
+static cmox_cipher_retval_t chain_blocks(const struct cmox_cipher_vtableStruct_st* vtable, const uint32_t* round_keys,
+        size_t key_size, uint8_t* chaining, const uint8_t* input, size_t length, uint8_t* output);
+static cmox_cipher_retval_t handle_modes(const struct cmox_cipher_vtableStruct_st* vtable, const uint8_t* input, size_t length,
+        const uint8_t* key, size_t key_size, const uint8_t* iv, size_t iv_size, uint8_t* output, size_t* output_length);
+static cmox_cipher_retval_t ccm(bool decrypt, const uint8_t* input, size_t length, size_t tag_size,
+        const uint8_t* key, size_t key_size, const uint8_t* nonce, size_t nonce_size,
+        const uint8_t* ad, size_t ad_size, uint8_t* output, size_t* output_length);
+static cmox_hash_handle_t* hash_construct(cmox_hash_handle_t* hash, size_t size, const struct cmox_hash_vtableStruct_st* vtable);
+static cmox_hash_retval_t hash_compute(const struct cmox_hash_vtableStruct_st* vtable, const uint8_t* input, size_t length,
+        uint8_t* digest, size_t digest_size);
+static size_t hash_handle_size(const struct cmox_hash_vtableStruct_st* vtable);
+static void md_append(cmox_hash_handle_t* hash, const uint8_t* input, size_t length);
+static void md_final(cmox_hash_handle_t* hash, uint8_t* digest);
+static void sponge_absorb(cmox_sponge_handle_t* sponge, const uint8_t* input, size_t length);
+static void sponge_pad(cmox_sponge_handle_t* sponge);
+static void sponge_final(cmox_sponge_handle_t* sponge, uint8_t suffix, uint8_t* output, size_t length);
+static size_t encode_length(uint64_t value, bool right, uint8_t* encoding);
+static void absorb_string(cmox_sponge_handle_t* sponge, const uint8_t* string, size_t length);
+static cmox_mac_handle_t* mac_construct(cmox_mac_handle_t* mac, size_t size, const struct cmox_mac_vtableStruct_st* vtable);
+static size_t mac_handle_size(const struct cmox_mac_vtableStruct_st* vtable);
+static cmox_mac_retval_t hmac_set_key(cmox_hmac_handle_t* handle, const uint8_t* key, size_t key_size);
+static void hmac_start(cmox_hmac_handle_t* handle, uint8_t pad);
+static void kmac_set_key(cmox_kmac_handle_t* handle, const uint8_t* key, size_t key_size);
+static void cmac_append(cmox_cmac_handle_t* handle, const uint8_t* input, size_t length);
+static void cmac_final(cmox_cmac_handle_t* handle, uint8_t* tag);
+static void cmac_double(uint8_t* block);
+static void ctr_process(const uint32_t* round_keys, uint32_t key_size, uint8_t* counter, const uint8_t* input, size_t length, uint8_t* output);
+static cmox_cipher_retval_t ccm_start(cmox_ccm_handle_t* handle, const uint8_t* nonce, size_t nonce_size);
+static cmox_cipher_retval_t ccm_append_ad(cmox_ccm_handle_t* handle, const uint8_t* input, size_t length);
+static cmox_cipher_retval_t ccm_append(cmox_ccm_handle_t* handle, const uint8_t* input, size_t length, uint8_t* output);
+static void ccm_mac_block(cmox_ccm_handle_t* handle, const uint8_t* block);
+static bool ccm_tag(cmox_ccm_handle_t* handle, uint8_t* tag);
+static cmox_cipher_retval_t xts_append(cmox_xts_handle_t* handle, const uint8_t* input, size_t length, uint8_t* output);
+static void xts_block(cmox_xts_handle_t* handle, const uint8_t* tweak, const uint8_t* input, uint8_t* output);
+static void xts_double(uint8_t* tweak);
+static cmox_cipher_retval_t keywrap_append(cmox_keywrap_handle_t* handle, const uint8_t* input, size_t length,
+        uint8_t* output, size_t* output_length);
+static void keywrap_xor_step(uint8_t* block, uint64_t step);
+static cmox_cipher_handle_t* aead_construct(cipher_handle_t* handle, cipher_mode_t mode, bool decrypt);
+static void chacha_block(uint32_t* state, uint8_t* keystream);
+static void chacha_process(uint32_t* state, const uint8_t* input, size_t length, uint8_t* output);
+static void poly_set_key(cmox_chachapoly_handle_t* handle, const uint8_t* key);
+static void poly_append(cmox_chachapoly_handle_t* handle, const uint8_t* input, size_t length);
+static void poly_blocks(cmox_chachapoly_handle_t* handle, const uint8_t* input, size_t blocks);
+static void poly_final(cmox_chachapoly_handle_t* handle, uint8_t* tag);
+static uint32_t load32_le(const uint8_t* bytes);
+static void store32_le(uint8_t* bytes, uint32_t value);
+static size_t cipher_handle_size(const struct cmox_cipher_vtableStruct_st* vtable);
+static cmox_blockcipher_handle_t* block_cipher(cmox_cipher_handle_t* cipher);
+static uint8_t* chaining_block(cmox_cipher_handle_t* cipher);
+static cmox_gcm_common_t* gcm_common(cmox_cipher_handle_t* cipher);
+static uint8_t* gcm_hash_key(cmox_cipher_handle_t* cipher);
+static bool valid_key_size(size_t key_size);
+static void increment_counter(uint8_t* counter, uint32_t size);
+static void xor_bytes(uint8_t* result, const uint8_t* x, const uint8_t* y, size_t length);
+static bool equal(const uint8_t* x, const uint8_t* y, size_t length);
+static void store_length(uint8_t* block, uint64_t bits);
+
+/* Public functions ----------------------------------------------------------*/
+
+cmox_init_retval_t cmox_initialize(cmox_init_arg_t *pInitArg)
+{
+    return cmox_ll_init(pInitArg != NULL ? pInitArg->pArg : NULL);
+}
+
+cmox_init_retval_t cmox_finalize(void *pArg)
+{
+    return cmox_ll_deInit(pArg);
+}
+
+cmox_cipher_retval_t cmox_cipher_encrypt(cmox_cipher_algo_t P_algo, const uint8_t *P_pInput, size_t P_inputLen,
+        const uint8_t *P_pKey, cmox_cipher_keyLen_t P_keyLen, const uint8_t *P_pIv, size_t P_ivLen,
+        uint8_t *P_pOutput, size_t *P_pOutputLen)
+{
+    if (P_algo == NULL || P_algo->vtable.decrypt) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    if (P_algo->vtable.mode == MODE_XTS || P_algo->vtable.mode == MODE_KEYWRAP) {
+        return handle_modes(&P_algo->vtable, P_pInput, P_inputLen, P_pKey, P_keyLen, P_pIv, P_ivLen, P_pOutput, P_pOutputLen);
+    }
+    return block_modes(&P_algo->vtable, P_pInput, P_inputLen, P_pKey, P_keyLen, P_pIv, P_ivLen, P_pOutput, P_pOutputLen);
+}
+
+cmox_cipher_retval_t cmox_cipher_decrypt(cmox_cipher_algo_t P_algo, const uint8_t *P_pInput, size_t P_inputLen,
+        const uint8_t *P_pKey, cmox_cipher_keyLen_t P_keyLen, const uint8_t *P_pIv, size_t P_ivLen,
+        uint8_t *P_pOutput, size_t *P_pOutputLen)
+{
+    if (P_algo == NULL || !P_algo->vtable.decrypt) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    if (P_algo->vtable.mode == MODE_XTS || P_algo->vtable.mode == MODE_KEYWRAP) {
+        return handle_modes(&P_algo->vtable, P_pInput, P_inputLen, P_pKey, P_keyLen, P_pIv, P_ivLen, P_pOutput, P_pOutputLen);
+    }
+    return block_modes(&P_algo->vtable, P_pInput, P_inputLen, P_pKey, P_keyLen, P_pIv, P_ivLen, P_pOutput, P_pOutputLen);
+}
+
+cmox_cipher_retval_t cmox_aead_encrypt(cmox_aead_algo_t P_algo, const uint8_t *P_pInput, size_t P_inputLen, size_t P_tagLen,
+        const uint8_t *P_pKey, cmox_cipher_keyLen_t P_keyLen, const uint8_t *P_pIv, size_t P_ivLen,
+        const uint8_t *P_pAddData, size_t P_addDataLen, uint8_t *P_pOutput, size_t *P_pOutputLen)
+{
+    if (P_algo == NULL || P_algo->vtable.decrypt) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+
+    if (P_algo->vtable.mode == MODE_CCM) {
+        return ccm(false, P_pInput, P_inputLen, P_tagLen, P_pKey, P_keyLen, P_pIv, P_ivLen,
+                P_pAddData, P_addDataLen, P_pOutput, P_pOutputLen);
+    }
+    if (P_algo->vtable.mode != MODE_GCM && P_algo->vtable.mode != MODE_CHACHAPOLY) {
+        return CMOX_CIPHER_ERR_NOT_IMPLEMENTED;
+    }
+
+    cipher_handle_t handle;
+    cmox_cipher_handle_t* cipher = aead_construct(&handle, P_algo->vtable.mode, false);
+    cmox_cipher_retval_t retval;
+    size_t tag_length;
+
+    if ((retval = cmox_cipher_init(cipher)) != CMOX_CIPHER_SUCCESS
+            || (retval = cmox_cipher_setTagLen(cipher, P_tagLen)) != CMOX_CIPHER_SUCCESS
+            || (retval = cmox_cipher_setKey(cipher, P_pKey, P_keyLen)) != CMOX_CIPHER_SUCCESS
+            || (retval = cmox_cipher_setIV(cipher, P_pIv, P_ivLen)) != CMOX_CIPHER_SUCCESS
+            || (retval = cmox_cipher_appendAD(cipher, P_pAddData, P_addDataLen)) != CMOX_CIPHER_SUCCESS
+            || (retval = cmox_cipher_append(cipher, P_pInput, P_inputLen, P_pOutput, NULL)) != CMOX_CIPHER_SUCCESS
+            || (retval = cmox_cipher_generateTag(cipher, P_pOutput + P_inputLen, &tag_length)) != CMOX_CIPHER_SUCCESS) {
+        cmox_cipher_cleanup(cipher);
+        return retval;
+    }
+    cmox_cipher_cleanup(cipher);
+
+    if (P_pOutputLen != NULL) {
+        *P_pOutputLen = P_inputLen + tag_length;
+    }
+    return CMOX_CIPHER_SUCCESS;
+}
+
+cmox_cipher_retval_t cmox_aead_decrypt(cmox_aead_algo_t P_algo, const uint8_t *P_pInput, size_t P_inputLen, size_t P_tagLen,
+        const uint8_t *P_pKey, cmox_cipher_keyLen_t P_keyLen, const uint8_t *P_pIv, size_t P_ivLen,
+        const uint8_t *P_pAddData, size_t P_addDataLen, uint8_t *P_pOutput, size_t *P_pOutputLen)
+{
+    if (P_algo == NULL || !P_algo->vtable.decrypt) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    if (P_inputLen < P_tagLen) {
+        return CMOX_CIPHER_ERR_BAD_INPUT_SIZE;
+    }
+
+    if (P_algo->vtable.mode == MODE_CCM) {
+        return ccm(true, P_pInput, P_inputLen, P_tagLen, P_pKey, P_keyLen, P_pIv, P_ivLen,
+                P_pAddData, P_addDataLen, P_pOutput, P_pOutputLen);
+    }
+    if (P_algo->vtable.mode != MODE_GCM && P_algo->vtable.mode != MODE_CHACHAPOLY) {
+        return CMOX_CIPHER_ERR_NOT_IMPLEMENTED;
+    }
+
+    size_t length = P_inputLen - P_tagLen;
+    cipher_handle_t handle;
+    cmox_cipher_handle_t* cipher = aead_construct(&handle, P_algo->vtable.mode, true);
+    cmox_cipher_retval_t retval;
+
+    if ((retval = cmox_cipher_init(cipher)) != CMOX_CIPHER_SUCCESS
+            || (retval = cmox_cipher_setTagLen(cipher, P_tagLen)) != CMOX_CIPHER_SUCCESS
+            || (retval = cmox_cipher_setKey(cipher, P_pKey, P_keyLen)) != CMOX_CIPHER_SUCCESS
+            || (retval = cmox_cipher_setIV(cipher, P_pIv, P_ivLen)) != CMOX_CIPHER_SUCCESS
+            || (retval = cmox_cipher_appendAD(cipher, P_pAddData, P_addDataLen)) != CMOX_CIPHER_SUCCESS
+            || (retval = cmox_cipher_append(cipher, P_pInput, length, P_pOutput, NULL)) != CMOX_CIPHER_SUCCESS) {
+        cmox_cipher_cleanup(cipher);
+        return retval;
+    }
+    retval = cmox_cipher_verifyTag(cipher, P_pInput + length, NULL);
+    cmox_cipher_cleanup(cipher);
+
+    if (retval != CMOX_CIPHER_AUTH_SUCCESS) {
+        memset(P_pOutput, 0, length);
+        return retval;
+    }
+    if (P_pOutputLen != NULL) {
+        *P_pOutputLen = length;
+    }
+    return CMOX_CIPHER_AUTH_SUCCESS;
+}
+
+cmox_hash_handle_t *cmox_sha1_construct(cmox_sha1_handle_t *P_pThis)
+{
+    return hash_construct((cmox_hash_handle_t*)P_pThis, sizeof(*P_pThis), &CMOX_SHA1_ALGO_struct.vtable);
+}
+
+cmox_hash_handle_t *cmox_sha224_construct(cmox_sha224_handle_t *P_pThis)
+{
+    return hash_construct((cmox_hash_handle_t*)P_pThis, sizeof(*P_pThis), &CMOX_SHA224_ALGO_struct.vtable);
+}
+
+cmox_hash_handle_t *cmox_sha256_construct(cmox_sha256_handle_t *P_pThis)
+{
+    return hash_construct((cmox_hash_handle_t*)P_pThis, sizeof(*P_pThis), &CMOX_SHA256_ALGO_struct.vtable);
+}
+
+cmox_hash_handle_t *cmox_sm3_construct(cmox_sm3_handle_t *P_pThis)
+{
+    return hash_construct((cmox_hash_handle_t*)P_pThis, sizeof(*P_pThis), &CMOX_SM3_ALGO_struct.vtable);
+}
+
+cmox_hash_handle_t *cmox_sha384_construct(cmox_sha384_handle_t *P_pThis)
+{
+    return hash_construct((cmox_hash_handle_t*)P_pThis, sizeof(*P_pThis), &CMOX_SHA384_ALGO_struct.vtable);
+}
+
+cmox_hash_handle_t *cmox_sha512_construct(cmox_sha512_handle_t *P_pThis)
+{
+    return hash_construct((cmox_hash_handle_t*)P_pThis, sizeof(*P_pThis), &CMOX_SHA512_ALGO_struct.vtable);
+}
+
+cmox_hash_handle_t *cmox_sha512_224_construct(cmox_sha512_handle_t *P_pThis)
+{
+    return hash_construct((cmox_hash_handle_t*)P_pThis, sizeof(*P_pThis), &CMOX_SHA512_224_ALGO_struct.vtable);
+}
+
+cmox_hash_handle_t *cmox_sha512_256_construct(cmox_sha512_handle_t *P_pThis)
+{
+    return hash_construct((cmox_hash_handle_t*)P_pThis, sizeof(*P_pThis), &CMOX_SHA512_256_ALGO_struct.vtable);
+}
+
+cmox_hash_handle_t *cmox_sha3_224_construct(cmox_sha3_handle_t *P_pThis)
+{
+    return hash_construct((cmox_hash_handle_t*)P_pThis, sizeof(*P_pThis), &CMOX_SHA3_224_ALGO_struct.vtable);
+}
+
+cmox_hash_handle_t *cmox_sha3_256_construct(cmox_sha3_handle_t *P_pThis)
+{
+    return hash_construct((cmox_hash_handle_t*)P_pThis, sizeof(*P_pThis), &CMOX_SHA3_256_ALGO_struct.vtable);
+}
+
+cmox_hash_handle_t *cmox_sha3_384_construct(cmox_sha3_handle_t *P_pThis)
+{
+    return hash_construct((cmox_hash_handle_t*)P_pThis, sizeof(*P_pThis), &CMOX_SHA3_384_ALGO_struct.vtable);
+}
+
+cmox_hash_handle_t *cmox_sha3_512_construct(cmox_sha3_handle_t *P_pThis)
+{
+    return hash_construct((cmox_hash_handle_t*)P_pThis, sizeof(*P_pThis), &CMOX_SHA3_512_ALGO_struct.vtable);
+}
+
+cmox_hash_handle_t *cmox_shake128_construct(cmox_sha3_handle_t *P_pThis)
+{
+    return hash_construct((cmox_hash_handle_t*)P_pThis, sizeof(*P_pThis), &CMOX_SHAKE128_ALGO_struct.vtable);
+}
+
+cmox_hash_handle_t *cmox_shake256_construct(cmox_sha3_handle_t *P_pThis)
+{
+    return hash_construct((cmox_hash_handle_t*)P_pThis, sizeof(*P_pThis), &CMOX_SHAKE256_ALGO_struct.vtable);
+}
+
+cmox_hash_retval_t cmox_hash_init(cmox_hash_handle_t *P_pThis)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL) {
+        return CMOX_HASH_ERR_BAD_PARAMETER;
+    }
+
+    const struct cmox_hash_vtableStruct_st* vtable = P_pThis->table;
+    P_pThis->tagLen = vtable->size;
+    if (vtable->family == HASH_SMALL) {
+        cmox_mdSmall_handle_t* handle = (cmox_mdSmall_handle_t*)P_pThis;
+        hash_ref_small_init(vtable->md, handle->md.internalState);
+        memset(handle->md.engine.bitCount, 0, sizeof(handle->md.engine.bitCount));
+    } else if (vtable->family == HASH_LARGE) {
+        cmox_mdLarge_handle_t* handle = (cmox_mdLarge_handle_t*)P_pThis;
+        hash_ref_large_init(vtable->md, handle->md.internalState);
+        memset(handle->md.engine.bitCount, 0, sizeof(handle->md.engine.bitCount));
+    } else {
+        cmox_sponge_handle_t* sponge = &((cmox_sha3_handle_t*)P_pThis)->keccak;
+        memset(sponge, 0, sizeof(*sponge));
+        sponge->rate = vtable->rate;
+    }
+    return CMOX_HASH_SUCCESS;
+}
+
+cmox_hash_retval_t cmox_hash_cleanup(cmox_hash_handle_t *P_pThis)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL) {
+        return CMOX_HASH_ERR_BAD_PARAMETER;
+    }
+    memset(P_pThis, 0, hash_handle_size(P_pThis->table));
+    return CMOX_HASH_SUCCESS;
+}
+
+cmox_hash_retval_t cmox_hash_setTagLen(cmox_hash_handle_t *P_pThis, size_t P_tagLen)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL) {
+        return CMOX_HASH_ERR_BAD_PARAMETER;
+    }
+
+    const struct cmox_hash_vtableStruct_st* vtable = P_pThis->table;
+    bool extendable = vtable->suffix == SHAKE_SUFFIX;
+    if (P_tagLen == 0 || (!extendable && P_tagLen > vtable->size)) {
+        return CMOX_HASH_ERR_BAD_TAG_SIZE;
+    }
+    P_pThis->tagLen = P_tagLen;
+    return CMOX_HASH_SUCCESS;
+}
+
+cmox_hash_retval_t cmox_hash_append(cmox_hash_handle_t *P_pThis, const uint8_t *P_pInput, size_t P_inputLen)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL || (P_pInput == NULL && P_inputLen != 0)) {
+        return CMOX_HASH_ERR_BAD_PARAMETER;
+    }
+
+    if (P_pThis->table->family == HASH_SPONGE) {
+        sponge_absorb(&((cmox_sha3_handle_t*)P_pThis)->keccak, P_pInput, P_inputLen);
+    } else {
+        md_append(P_pThis, P_pInput, P_inputLen);
+    }
+    return CMOX_HASH_SUCCESS;
+}
+
+cmox_hash_retval_t cmox_hash_generateTag(cmox_hash_handle_t *P_pThis, uint8_t *P_pDigest, size_t *P_pDigestLen)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL || P_pDigest == NULL) {
+        return CMOX_HASH_ERR_BAD_PARAMETER;
+    }
+
+    const struct cmox_hash_vtableStruct_st* vtable = P_pThis->table;
+    if (vtable->family == HASH_SPONGE) {
+        sponge_final(&((cmox_sha3_handle_t*)P_pThis)->keccak, vtable->suffix, P_pDigest, P_pThis->tagLen);
+    } else {
+        uint8_t digest[HASH_REF_LARGE_BLOCK_SIZE / 2];
+        md_final(P_pThis, digest);
+        memcpy(P_pDigest, digest, P_pThis->tagLen);
+    }
+    if (P_pDigestLen != NULL) {
+        *P_pDigestLen = P_pThis->tagLen;
+    }
+    return CMOX_HASH_SUCCESS;
+}
+
+cmox_hash_retval_t cmox_hash_compute(cmox_hash_algo_t P_algo, const uint8_t *P_pPlaintext, size_t P_plaintextLen,
+        uint8_t *P_pDigest, const size_t P_expectedDigestLen, size_t *P_pComputedDigestLen)
+{
+    if (P_algo == NULL) {
+        return CMOX_HASH_ERR_BAD_PARAMETER;
+    }
+
+    cmox_hash_retval_t retval = hash_compute(&P_algo->vtable, P_pPlaintext, P_plaintextLen, P_pDigest, P_expectedDigestLen);
+    if (retval == CMOX_HASH_SUCCESS && P_pComputedDigestLen != NULL) {
+        *P_pComputedDigestLen = P_expectedDigestLen;
+    }
+    return retval;
+}
+
+cmox_mac_handle_t *cmox_cmac_construct(cmox_cmac_handle_t *P_pThis, cmox_cmac_impl_t P_impl)
+{
+    if (P_pThis == NULL || P_impl == NULL) {
+        return NULL;
+    }
+    return mac_construct(&P_pThis->super, sizeof(*P_pThis), &P_impl->vtable);
+}
+
+cmox_mac_handle_t *cmox_hmac_construct(cmox_hmac_handle_t *P_pThis, cmox_hmac_impl_t P_impl)
+{
+    if (P_pThis == NULL || P_impl == NULL) {
+        return NULL;
+    }
+    return mac_construct(&P_pThis->super, sizeof(*P_pThis), &P_impl->vtable);
+}
+
+cmox_mac_handle_t *cmox_kmac_construct(cmox_kmac_handle_t *P_pThis, cmox_kmac_impl_t P_impl)
+{
+    if (P_pThis == NULL || P_impl == NULL) {
+        return NULL;
+    }
+    return mac_construct(&P_pThis->super, sizeof(*P_pThis), &P_impl->vtable);
+}
+
+/**
+ * The internal state is 1 once the key is set
+ */
+cmox_mac_retval_t cmox_mac_init(cmox_mac_handle_t *P_pThis)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL) {
+        return CMOX_MAC_ERR_BAD_PARAMETER;
+    }
+
+    const struct cmox_mac_vtableStruct_st* vtable = P_pThis->table;
+    memset((uint8_t*)P_pThis + sizeof(*P_pThis), 0, mac_handle_size(vtable) - sizeof(*P_pThis));
+    P_pThis->tagLen = vtable->size;
+    P_pThis->internalState = 0;
+    return CMOX_MAC_SUCCESS;
+}
+
+cmox_mac_retval_t cmox_mac_cleanup(cmox_mac_handle_t *P_pThis)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL) {
+        return CMOX_MAC_ERR_BAD_PARAMETER;
+    }
+    memset(P_pThis, 0, mac_handle_size(P_pThis->table));
+    return CMOX_MAC_SUCCESS;
+}
+
+cmox_mac_retval_t cmox_mac_setTagLen(cmox_mac_handle_t *P_pThis, size_t P_tagLen)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL) {
+        return CMOX_MAC_ERR_BAD_PARAMETER;
+    }
+
+    const struct cmox_mac_vtableStruct_st* vtable = P_pThis->table;
+    size_t max_size = vtable->type == MAC_KMAC ? MAC_MAX_SIZE : vtable->size;
+    if (P_tagLen == 0 || P_tagLen > max_size) {
+        return CMOX_MAC_ERR_BAD_PARAMETER;
+    }
+    P_pThis->tagLen = P_tagLen;
+    return CMOX_MAC_SUCCESS;
+}
+
+/**
+ * Only for the KMAC, ignored by the other MACs
+ */
+cmox_mac_retval_t cmox_mac_setCustomData(cmox_mac_handle_t *P_pThis, const uint8_t *P_pCustomData, size_t P_customDataLen)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL || (P_pCustomData == NULL && P_customDataLen != 0)) {
+        return CMOX_MAC_ERR_BAD_PARAMETER;
+    }
+
+    if (P_pThis->table->type == MAC_KMAC) {
+        cmox_kmac_handle_t* handle = (cmox_kmac_handle_t*)P_pThis;
+        handle->custom_data = P_pCustomData;
+        handle->customDataLen = P_customDataLen;
+    }
+    return CMOX_MAC_SUCCESS;
+}
+
+cmox_mac_retval_t cmox_mac_setKey(cmox_mac_handle_t *P_pThis, const uint8_t *P_pKey, size_t P_keyLen)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL || (P_pKey == NULL && P_keyLen != 0)) {
+        return CMOX_MAC_ERR_BAD_PARAMETER;
+    }
+
+    switch (P_pThis->table->type) {
+    case MAC_CMAC: {
+        cmox_cmac_handle_t* handle = (cmox_cmac_handle_t*)P_pThis;
+        if (!valid_key_size(P_keyLen)) {
+            return CMOX_MAC_ERR_BAD_PARAMETER;
+        }
+        aes_ref_expand_key(P_pKey, P_keyLen, handle->blockCipher.expandedKey);
+        handle->blockCipher.keyLen = P_keyLen;
+        break;
+    }
+    case MAC_HMAC: {
+        cmox_mac_retval_t retval = hmac_set_key((cmox_hmac_handle_t*)P_pThis, P_pKey, P_keyLen);
+        if (retval != CMOX_MAC_SUCCESS) {
+            return retval;
+        }
+        break;
+    }
+    default:
+        kmac_set_key((cmox_kmac_handle_t*)P_pThis, P_pKey, P_keyLen);
+        break;
+    }
+    P_pThis->internalState = 1;
+    return CMOX_MAC_SUCCESS;
+}
+
+cmox_mac_retval_t cmox_mac_append(cmox_mac_handle_t *P_pThis, const uint8_t *P_pInput, size_t P_inputLen)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL || (P_pInput == NULL && P_inputLen != 0)) {
+        return CMOX_MAC_ERR_BAD_PARAMETER;
+    }
+    if (P_pThis->internalState == 0) {
+        return CMOX_MAC_ERR_BAD_OPERATION;
+    }
+
+    switch (P_pThis->table->type) {
+    case MAC_CMAC:
+        cmac_append((cmox_cmac_handle_t*)P_pThis, P_pInput, P_inputLen);
+        break;
+    case MAC_HMAC:
+        cmox_hash_append(((cmox_hmac_handle_t*)P_pThis)->hash, P_pInput, P_inputLen);
+        break;
+    default:
+        sponge_absorb(&((cmox_kmac_handle_t*)P_pThis)->internal_ctx.csi.sponge, P_pInput, P_inputLen);
+        break;
+    }
+    return CMOX_MAC_SUCCESS;
+}
+
+cmox_mac_retval_t cmox_mac_generateTag(cmox_mac_handle_t *P_pThis, uint8_t *P_pTag, size_t *P_pTagLen)
+{
+    uint8_t tag[MAC_MAX_SIZE];
+
+    if (P_pThis == NULL || P_pThis->table == NULL || P_pTag == NULL) {
+        return CMOX_MAC_ERR_BAD_PARAMETER;
+    }
+    if (P_pThis->internalState == 0) {
+        return CMOX_MAC_ERR_BAD_OPERATION;
+    }
+
+    switch (P_pThis->table->type) {
+    case MAC_CMAC:
+        cmac_final((cmox_cmac_handle_t*)P_pThis, tag);
+        break;
+    case MAC_HMAC: {
+        // H(K0 ^ opad || H(K0 ^ ipad || message))
+        cmox_hmac_handle_t* handle = (cmox_hmac_handle_t*)P_pThis;
+        size_t size = P_pThis->table->hash->size;
+        cmox_hash_generateTag(handle->hash, tag, NULL);
+        hmac_start(handle, HMAC_OPAD);
+        cmox_hash_append(handle->hash, tag, size);
+        cmox_hash_generateTag(handle->hash, tag, NULL);
+        break;
+    }
+    default: {
+        // the output length in bits ends the input of the KMAC
+        cmox_sponge_handle_t* sponge = &((cmox_kmac_handle_t*)P_pThis)->internal_ctx.csi.sponge;
+        uint8_t encoding[9];
+        sponge_absorb(sponge, encoding, encode_length(8 * (uint64_t)P_pThis->tagLen, true, encoding));
+        sponge_final(sponge, CSHAKE_SUFFIX, tag, P_pThis->tagLen);
+        break;
+    }
+    }
+
+    memcpy(P_pTag, tag, P_pThis->tagLen);
+    if (P_pTagLen != NULL) {
+        *P_pTagLen = P_pThis->tagLen;
+    }
+    return CMOX_MAC_SUCCESS;
+}
+
+cmox_mac_retval_t cmox_mac_verifyTag(cmox_mac_handle_t *P_pThis, const uint8_t *P_pTag, uint32_t *P_pFaultCheck)
+{
+    uint8_t tag[MAC_MAX_SIZE];
+
+    if (P_pTag == NULL) {
+        return CMOX_MAC_ERR_BAD_PARAMETER;
+    }
+
+    cmox_mac_retval_t retval = cmox_mac_generateTag(P_pThis, tag, NULL);
+    if (retval != CMOX_MAC_SUCCESS) {
+        return retval;
+    }
+    retval = equal(tag, P_pTag, P_pThis->tagLen) ? CMOX_MAC_AUTH_SUCCESS : CMOX_MAC_AUTH_FAIL;
+    if (P_pFaultCheck != NULL) {
+        *P_pFaultCheck = retval;
+    }
+    return retval;
+}
+
+cmox_mac_retval_t cmox_mac_compute(cmox_mac_algo_t P_algo, const uint8_t *P_pInput, size_t P_inputLen,
+        const uint8_t *P_pKey, size_t P_keyLen, const uint8_t *P_pCustomData, size_t P_customDataLen,
+        uint8_t *P_pTag, size_t P_expectedTagLen, size_t *P_pComputedTagLen)
+{
+    mac_handle_t handle;
+    cmox_mac_retval_t retval;
+
+    if (P_algo == NULL) {
+        return CMOX_MAC_ERR_BAD_OPERATION;
+    }
+
+    cmox_mac_handle_t* mac = mac_construct(&handle.super, sizeof(handle), &P_algo->vtable);
+    if ((retval = cmox_mac_init(mac)) == CMOX_MAC_SUCCESS
+            && (retval = cmox_mac_setTagLen(mac, P_expectedTagLen)) == CMOX_MAC_SUCCESS
+            && (retval = cmox_mac_setCustomData(mac, P_pCustomData, P_customDataLen)) == CMOX_MAC_SUCCESS
+            && (retval = cmox_mac_setKey(mac, P_pKey, P_keyLen)) == CMOX_MAC_SUCCESS
+            && (retval = cmox_mac_append(mac, P_pInput, P_inputLen)) == CMOX_MAC_SUCCESS) {
+        retval = cmox_mac_generateTag(mac, P_pTag, P_pComputedTagLen);
+    }
+    cmox_mac_cleanup(mac);
+    return retval;
+}
+
+cmox_mac_retval_t cmox_mac_verify(cmox_mac_algo_t P_algo, const uint8_t *P_pInput, size_t P_inputLen,
+        const uint8_t *P_pKey, size_t P_keyLen, const uint8_t *P_pCustomData, size_t P_customDataLen,
+        const uint8_t *P_pReceivedTag, size_t P_receivedTagLen)
+{
+    uint8_t tag[MAC_MAX_SIZE];
+
+    if (P_pReceivedTag == NULL || P_receivedTagLen > MAC_MAX_SIZE) {
+        return CMOX_MAC_ERR_BAD_PARAMETER;
+    }
+
+    cmox_mac_retval_t retval = cmox_mac_compute(P_algo, P_pInput, P_inputLen, P_pKey, P_keyLen,
+            P_pCustomData, P_customDataLen, tag, P_receivedTagLen, NULL);
+    if (retval != CMOX_MAC_SUCCESS) {
+        return retval;
+    }
+    return equal(tag, P_pReceivedTag, P_receivedTagLen) ? CMOX_MAC_AUTH_SUCCESS : CMOX_MAC_AUTH_FAIL;
+}
+
+cmox_cipher_handle_t *cmox_ecb_construct(cmox_ecb_handle_t *P_pThis, cmox_ecb_impl_t P_impl)
+{
+    if (P_pThis == NULL || P_impl == NULL) {
+        return NULL;
+    }
+    memset(P_pThis, 0, sizeof(*P_pThis));
+    P_pThis->super.table = &P_impl->vtable;
+    return &P_pThis->super;
+}
+
+cmox_cipher_handle_t *cmox_cbc_construct(cmox_cbc_handle_t *P_pThis, cmox_cbc_impl_t P_impl)
+{
+    if (P_pThis == NULL || P_impl == NULL) {
+        return NULL;
+    }
+    memset(P_pThis, 0, sizeof(*P_pThis));
+    P_pThis->super.table = &P_impl->vtable;
+    return &P_pThis->super;
+}
+
+cmox_cipher_handle_t *cmox_ctr_construct(cmox_ctr_handle_t *P_pThis, cmox_ctr_impl_t P_impl)
+{
+    if (P_pThis == NULL || P_impl == NULL) {
+        return NULL;
+    }
+    memset(P_pThis, 0, sizeof(*P_pThis));
+    P_pThis->super.table = &P_impl->vtable;
+    return &P_pThis->super;
+}
+
+// only the 16-byte CFB
+cmox_cipher_handle_t *cmox_cfb_construct(cmox_cfb_handle_t *P_pThis, cmox_cfb_impl_t P_impl)
+{
+    if (P_pThis == NULL || P_impl == NULL) {
+        return NULL;
+    }
+    memset(P_pThis, 0, sizeof(*P_pThis));
+    P_pThis->super.table = &P_impl->vtable;
+    P_pThis->cfb_blockLen = AES_REF_BLOCK_SIZE;
+    return &P_pThis->super;
+}
+
+cmox_cipher_handle_t *cmox_ofb_construct(cmox_ofb_handle_t *P_pThis, cmox_ofb_impl_t P_impl)
+{
+    if (P_pThis == NULL || P_impl == NULL) {
+        return NULL;
+    }
+    memset(P_pThis, 0, sizeof(*P_pThis));
+    P_pThis->super.table = &P_impl->vtable;
+    return &P_pThis->super;
+}
+
+cmox_cipher_handle_t *cmox_ccm_construct(cmox_ccm_handle_t *P_pThis, cmox_ccm_impl_t P_impl)
+{
+    if (P_pThis == NULL || P_impl == NULL) {
+        return NULL;
+    }
+    memset(P_pThis, 0, sizeof(*P_pThis));
+    P_pThis->super.table = &P_impl->vtable;
+    return &P_pThis->super;
+}
+
+cmox_cipher_handle_t *cmox_xts_construct(cmox_xts_handle_t *P_pThis, cmox_xts_impl_t P_impl)
+{
+    if (P_pThis == NULL || P_impl == NULL) {
+        return NULL;
+    }
+    memset(P_pThis, 0, sizeof(*P_pThis));
+    P_pThis->super.table = &P_impl->vtable;
+    return &P_pThis->super;
+}
+
+cmox_cipher_handle_t *cmox_keywrap_construct(cmox_keywrap_handle_t *P_pThis, cmox_keywrap_impl_t P_impl)
+{
+    if (P_pThis == NULL || P_impl == NULL) {
+        return NULL;
+    }
+    memset(P_pThis, 0, sizeof(*P_pThis));
+    P_pThis->super.table = &P_impl->vtable;
+    return &P_pThis->super;
+}
+
+cmox_cipher_handle_t *cmox_chachapoly_construct(cmox_chachapoly_handle_t *P_pThis, cmox_chachapoly_impl_t P_impl)
+{
+    if (P_pThis == NULL || P_impl == NULL) {
+        return NULL;
+    }
+    memset(P_pThis, 0, sizeof(*P_pThis));
+    P_pThis->super.table = &P_impl->vtable;
+    return &P_pThis->super;
+}
+
+cmox_cipher_handle_t *cmox_gcmFast_construct(cmox_gcmFast_handle_t *P_pThis, cmox_gcmFast_impl_t P_impl)
+{
+    if (P_pThis == NULL || P_impl == NULL) {
+        return NULL;
+    }
+    memset(P_pThis, 0, sizeof(*P_pThis));
+    P_pThis->super.table = &P_impl->vtable;
+    return &P_pThis->super;
+}
+
+cmox_cipher_handle_t *cmox_gcmSmall_construct(cmox_gcmSmall_handle_t *P_pThis, cmox_gcmSmall_impl_t P_impl)
+{
+    if (P_pThis == NULL || P_impl == NULL) {
+        return NULL;
+    }
+    memset(P_pThis, 0, sizeof(*P_pThis));
+    P_pThis->super.table = &P_impl->vtable;
+    return &P_pThis->super;
+}
+
+cmox_cipher_retval_t cmox_cipher_init(cmox_cipher_handle_t *P_pThis)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    P_pThis->internalState = 0;
+    if (P_pThis->table->mode == MODE_GCM) {
+        gcm_common(P_pThis)->tagLen = AES_REF_BLOCK_SIZE;
+    } else if (P_pThis->table->mode == MODE_CCM) {
+        ((cmox_ccm_handle_t*)P_pThis)->tagLen = AES_REF_BLOCK_SIZE;
+    }
+    return CMOX_CIPHER_SUCCESS;
+}
+
+cmox_cipher_retval_t cmox_cipher_cleanup(cmox_cipher_handle_t *P_pThis)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+
+    // the key material is erased, the handle must be constructed again
+    memset(P_pThis, 0, cipher_handle_size(P_pThis->table));
+    return CMOX_CIPHER_SUCCESS;
+}
+
+cmox_cipher_retval_t cmox_cipher_setKey(cmox_cipher_handle_t *P_pThis, const uint8_t *P_pKey, cmox_cipher_keyLen_t P_keyLen)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL || P_pKey == NULL) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+
+    // the constants then the key, the counter and the nonce are set by the IV
+    if (P_pThis->table->mode == MODE_CHACHAPOLY) {
+        cmox_chachapoly_handle_t* handle = (cmox_chachapoly_handle_t*)P_pThis;
+        static const uint8_t constants[] = "expand 32-byte k";
+
+        if (P_keyLen != CHACHA_KEY_SIZE) {
+            return CMOX_CIPHER_ERR_BAD_PARAMETER;
+        }
+        for (int i = 0; i < 4; i++) {
+            handle->internalState[i] = load32_le(&constants[4 * i]);
+        }
+        for (int i = 0; i < CHACHA_KEY_SIZE / 4; i++) {
+            handle->internalState[4 + i] = load32_le(&P_pKey[4 * i]);
+        }
+        return CMOX_CIPHER_SUCCESS;
+    }
+
+    // the key of the data then the one of the tweak
+    if (P_pThis->table->mode == MODE_XTS) {
+        cmox_xts_handle_t* handle = (cmox_xts_handle_t*)P_pThis;
+        size_t key_size = P_keyLen / 2;
+
+        if (P_keyLen % 2 != 0 || !valid_key_size(key_size)) {
+            return CMOX_CIPHER_ERR_BAD_PARAMETER;
+        }
+        aes_ref_expand_key(P_pKey, key_size, handle->blockCipher1.expandedKey);
+        handle->blockCipher1.keyLen = key_size;
+        aes_ref_expand_key(P_pKey + key_size, key_size, handle->blockCipher2.expandedKey);
+        handle->blockCipher2.keyLen = key_size;
+        return CMOX_CIPHER_SUCCESS;
+    }
+    if (!valid_key_size(P_keyLen)) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+
+    cmox_blockcipher_handle_t* cipher = block_cipher(P_pThis);
+    if (cipher != NULL) {
+        aes_ref_expand_key(P_pKey, P_keyLen, cipher->expandedKey);
+        cipher->keyLen = P_keyLen;
+        return CMOX_CIPHER_SUCCESS;
+    }
+    if (P_pThis->table->mode == MODE_GCM) {
+        cmox_gcm_common_t* common = gcm_common(P_pThis);
+        uint8_t zero[AES_REF_BLOCK_SIZE] = {0};
+
+        aes_ref_expand_key(P_pKey, P_keyLen, common->blockCipher.expandedKey);
+        common->blockCipher.keyLen = P_keyLen;
+        aes_ref_encrypt(common->blockCipher.expandedKey, P_keyLen, zero, gcm_hash_key(P_pThis));
+        return CMOX_CIPHER_SUCCESS;
+    }
+    return CMOX_CIPHER_ERR_NOT_IMPLEMENTED;
+}
+
+cmox_cipher_retval_t cmox_cipher_setIV(cmox_cipher_handle_t *P_pThis, const uint8_t *P_pIv, size_t P_ivLen)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL || P_pIv == NULL) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+
+    uint8_t* chaining = chaining_block(P_pThis);
+    if (chaining != NULL) {
+        if (P_ivLen != AES_REF_BLOCK_SIZE) {
+            return CMOX_CIPHER_ERR_BAD_PARAMETER;
+        }
+        memcpy(chaining, P_pIv, AES_REF_BLOCK_SIZE);
+        return CMOX_CIPHER_SUCCESS;
+    }
+    if (P_pThis->table->mode == MODE_CCM) {
+        return ccm_start((cmox_ccm_handle_t*)P_pThis, P_pIv, P_ivLen);
+    }
+    // the tweak of the data unit, encrypted with the second key
+    if (P_pThis->table->mode == MODE_XTS) {
+        cmox_xts_handle_t* handle = (cmox_xts_handle_t*)P_pThis;
+        if (P_ivLen != AES_REF_BLOCK_SIZE) {
+            return CMOX_CIPHER_ERR_BAD_PARAMETER;
+        }
+        aes_ref_encrypt(handle->blockCipher2.expandedKey, handle->blockCipher2.keyLen, P_pIv, (uint8_t*)handle->tweak);
+        P_pThis->internalState = 0;
+        return CMOX_CIPHER_SUCCESS;
+    }
+    // the first block of the key stream is the key of Poly1305
+    if (P_pThis->table->mode == MODE_CHACHAPOLY) {
+        cmox_chachapoly_handle_t* handle = (cmox_chachapoly_handle_t*)P_pThis;
+        uint8_t keystream[CHACHA_BLOCK_SIZE];
+
+        if (P_ivLen != CHACHA_NONCE_SIZE) {
+            return CMOX_CIPHER_ERR_BAD_PARAMETER;
+        }
+        handle->internalState[12] = 0;
+        for (int i = 0; i < CHACHA_NONCE_SIZE / 4; i++) {
+            handle->internalState[13 + i] = load32_le(&P_pIv[4 * i]);
+        }
+        chacha_block(handle->internalState, keystream);
+        poly_set_key(handle, keystream);
+        memset(keystream, 0, sizeof(keystream));
+        handle->mAadLen = 0;
+        handle->mCipherLen = 0;
+        return CMOX_CIPHER_SUCCESS;
+    }
+    if (P_pThis->table->mode == MODE_KEYWRAP) {
+        cmox_keywrap_handle_t* handle = (cmox_keywrap_handle_t*)P_pThis;
+        if (P_ivLen != KEYWRAP_SEMIBLOCK_SIZE) {
+            return CMOX_CIPHER_ERR_BAD_PARAMETER;
+        }
+        memcpy(handle->iv, P_pIv, KEYWRAP_SEMIBLOCK_SIZE);
+        return CMOX_CIPHER_SUCCESS;
+    }
+    if (P_pThis->table->mode == MODE_GCM) {
+        cmox_gcm_common_t* common = gcm_common(P_pThis);
+        uint8_t* counter = (uint8_t*)common->iv;
+
+        if (P_ivLen == 0) {
+            return CMOX_CIPHER_ERR_BAD_PARAMETER;
+        }
+        if (P_ivLen == GCM_IV_SIZE) {
+            memcpy(counter, P_pIv, GCM_IV_SIZE);
+            memset(counter + GCM_IV_SIZE, 0, AES_REF_BLOCK_SIZE - GCM_IV_SIZE);
+            counter[AES_REF_BLOCK_SIZE - 1] = 1;
+        } else {
+            uint8_t lengths[AES_REF_BLOCK_SIZE] = {0};
+            memset(counter, 0, AES_REF_BLOCK_SIZE);
+            aes_ref_ghash(counter, gcm_hash_key(P_pThis), P_pIv, P_ivLen);
+            store_length(lengths + 8, 8 * (uint64_t)P_ivLen);
+            aes_ref_ghash(counter, gcm_hash_key(P_pThis), lengths, AES_REF_BLOCK_SIZE);
+        }
+        memset(common->partialAuth, 0, sizeof(common->partialAuth));
+        common->AdLen = 0;
+        common->payloadLen = 0;
+        return CMOX_CIPHER_SUCCESS;
+    }
+    return CMOX_CIPHER_ERR_NOT_IMPLEMENTED;
+}
+
+cmox_cipher_retval_t cmox_cipher_setTagLen(cmox_cipher_handle_t *P_pThis, size_t P_tagLen)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    // the tag of ChaCha20-Poly1305 is not truncated
+    if (P_pThis->table->mode == MODE_CHACHAPOLY) {
+        return P_tagLen == POLY_TAG_SIZE ? CMOX_CIPHER_SUCCESS : CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    if (P_pThis->table->mode == MODE_CCM) {
+        if (P_tagLen < 4 || P_tagLen > AES_REF_BLOCK_SIZE || P_tagLen % 2 != 0) {
+            return CMOX_CIPHER_ERR_BAD_PARAMETER;
+        }
+        ((cmox_ccm_handle_t*)P_pThis)->tagLen = P_tagLen;
+        return CMOX_CIPHER_SUCCESS;
+    }
+    if (P_pThis->table->mode != MODE_GCM) {
+        return CMOX_CIPHER_ERR_BAD_OPERATION;
+    }
+    if (P_tagLen == 0 || P_tagLen > AES_REF_BLOCK_SIZE) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    gcm_common(P_pThis)->tagLen = P_tagLen;
+    return CMOX_CIPHER_SUCCESS;
+}
+
+// the lengths of CCM are in the first block, they are set before the nonce
+cmox_cipher_retval_t cmox_cipher_setPayloadLen(cmox_cipher_handle_t *P_pThis, size_t P_totalPayloadLen)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    if (P_pThis->table->mode != MODE_CCM) {
+        return CMOX_CIPHER_ERR_BAD_OPERATION;
+    }
+    ((cmox_ccm_handle_t*)P_pThis)->payloadLen = P_totalPayloadLen;
+    return CMOX_CIPHER_SUCCESS;
+}
+
+cmox_cipher_retval_t cmox_cipher_setADLen(cmox_cipher_handle_t *P_pThis, size_t P_totalADLen)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL || P_totalADLen > CCM_MAX_AD_SIZE) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    if (P_pThis->table->mode != MODE_CCM) {
+        return CMOX_CIPHER_ERR_BAD_OPERATION;
+    }
+    ((cmox_ccm_handle_t*)P_pThis)->AdLen = P_totalADLen;
+    return CMOX_CIPHER_SUCCESS;
+}
+
+cmox_cipher_retval_t cmox_cipher_appendAD(cmox_cipher_handle_t *P_pThis, const uint8_t *P_pInput, size_t P_inputLen)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL || (P_pInput == NULL && P_inputLen != 0)) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    if (P_pThis->table->mode == MODE_CHACHAPOLY) {
+        cmox_chachapoly_handle_t* handle = (cmox_chachapoly_handle_t*)P_pThis;
+        if (handle->mCipherLen != 0 || handle->mAadLen % POLY_BLOCK_SIZE != 0) {
+            return CMOX_CIPHER_ERR_BAD_OPERATION;
+        }
+        poly_append(handle, P_pInput, P_inputLen);
+        handle->mAadLen += P_inputLen;
+        return CMOX_CIPHER_SUCCESS;
+    }
+    if (P_pThis->table->mode == MODE_CCM) {
+        return ccm_append_ad((cmox_ccm_handle_t*)P_pThis, P_pInput, P_inputLen);
+    }
+    if (P_pThis->table->mode != MODE_GCM) {
+        return CMOX_CIPHER_ERR_BAD_OPERATION;
+    }
+
+    cmox_gcm_common_t* common = gcm_common(P_pThis);
+    if (common->payloadLen != 0 || common->AdLen % AES_REF_BLOCK_SIZE != 0) {
+        // the additional data are before the payload, by whole blocks
+        return CMOX_CIPHER_ERR_BAD_OPERATION;
+    }
+    aes_ref_ghash((uint8_t*)common->partialAuth, gcm_hash_key(P_pThis), P_pInput, P_inputLen);
+    common->AdLen += P_inputLen;
+    return CMOX_CIPHER_SUCCESS;
+}
+
+cmox_cipher_retval_t cmox_cipher_append(cmox_cipher_handle_t *P_pThis, const uint8_t *P_pInput, size_t P_inputLen,
+        uint8_t *P_pOutput, size_t *P_pOutputLen)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL || ((P_pInput == NULL || P_pOutput == NULL) && P_inputLen != 0)) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+
+    if (P_pThis->table->mode == MODE_CTR) {
+        cmox_ctr_handle_t* handle = (cmox_ctr_handle_t*)P_pThis;
+        ctr_process(handle->blockCipher.expandedKey, handle->blockCipher.keyLen, (uint8_t*)handle->iv,
+                P_pInput, P_inputLen, P_pOutput);
+    } else if (P_pThis->table->mode <= MODE_OFB) { // ECB, CBC, CFB and OFB
+        const cmox_blockcipher_handle_t* cipher = block_cipher(P_pThis);
+        uint8_t* chaining = chaining_block(P_pThis);
+
+        if ((P_pThis->table->mode == MODE_ECB || P_pThis->table->mode == MODE_CBC) && P_inputLen % AES_REF_BLOCK_SIZE != 0) {
+            return CMOX_CIPHER_ERR_BAD_INPUT_SIZE;
+        }
+        chain_blocks(P_pThis->table, cipher->expandedKey, cipher->keyLen, chaining, P_pInput, P_inputLen, P_pOutput);
+    } else if (P_pThis->table->mode == MODE_CCM) {
+        cmox_cipher_retval_t retval = ccm_append((cmox_ccm_handle_t*)P_pThis, P_pInput, P_inputLen, P_pOutput);
+        if (retval != CMOX_CIPHER_SUCCESS) {
+            return retval;
+        }
+    } else if (P_pThis->table->mode == MODE_GCM) {
+        cmox_gcm_common_t* common = gcm_common(P_pThis);
+        uint8_t counter[AES_REF_BLOCK_SIZE];
+
+        if (common->payloadLen % AES_REF_BLOCK_SIZE != 0) {
+            return CMOX_CIPHER_ERR_BAD_OPERATION;
+        }
+        memcpy(counter, common->iv, AES_REF_BLOCK_SIZE);
+        for (size_t i = 0; i <= common->payloadLen / AES_REF_BLOCK_SIZE; i++) {
+            increment_counter(counter, 4);
+        }
+
+        // GHASH over the cipher text
+        if (P_pThis->table->decrypt) {
+            aes_ref_ghash((uint8_t*)common->partialAuth, gcm_hash_key(P_pThis), P_pInput, P_inputLen);
+        }
+        ctr_process(common->blockCipher.expandedKey, common->blockCipher.keyLen, counter, P_pInput, P_inputLen, P_pOutput);
+        if (!P_pThis->table->decrypt) {
+            aes_ref_ghash((uint8_t*)common->partialAuth, gcm_hash_key(P_pThis), P_pOutput, P_inputLen);
+        }
+        common->payloadLen += P_inputLen;
+    } else if (P_pThis->table->mode == MODE_XTS) {
+        cmox_cipher_retval_t retval = xts_append((cmox_xts_handle_t*)P_pThis, P_pInput, P_inputLen, P_pOutput);
+        if (retval != CMOX_CIPHER_SUCCESS) {
+            return retval;
+        }
+    } else if (P_pThis->table->mode == MODE_CHACHAPOLY) {
+        cmox_chachapoly_handle_t* handle = (cmox_chachapoly_handle_t*)P_pThis;
+
+        if (handle->mCipherLen % CHACHA_BLOCK_SIZE != 0) {
+            return CMOX_CIPHER_ERR_BAD_OPERATION;
+        }
+        // Poly1305 over the cipher text
+        if (P_pThis->table->decrypt) {
+            poly_append(handle, P_pInput, P_inputLen);
+        }
+        chacha_process(handle->internalState, P_pInput, P_inputLen, P_pOutput);
+        if (!P_pThis->table->decrypt) {
+            poly_append(handle, P_pOutput, P_inputLen);
+        }
+        handle->mCipherLen += P_inputLen;
+    } else if (P_pThis->table->mode == MODE_KEYWRAP) {
+        return keywrap_append((cmox_keywrap_handle_t*)P_pThis, P_pInput, P_inputLen, P_pOutput, P_pOutputLen);
+    } else {
+        return CMOX_CIPHER_ERR_NOT_IMPLEMENTED;
+    }
+
+    if (P_pOutputLen != NULL) {
+        *P_pOutputLen = P_inputLen;
+    }
+    return CMOX_CIPHER_SUCCESS;
+}
+
+cmox_cipher_retval_t cmox_cipher_generateTag(cmox_cipher_handle_t *P_pThis, uint8_t *P_pTag, size_t *P_pTagLen)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL || P_pTag == NULL) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    if (P_pThis->table->mode == MODE_CHACHAPOLY && !P_pThis->table->decrypt) {
+        poly_final((cmox_chachapoly_handle_t*)P_pThis, P_pTag);
+        if (P_pTagLen != NULL) {
+            *P_pTagLen = POLY_TAG_SIZE;
+        }
+        return CMOX_CIPHER_SUCCESS;
+    }
+    if (P_pThis->table->mode == MODE_CCM && !P_pThis->table->decrypt) {
+        cmox_ccm_handle_t* handle = (cmox_ccm_handle_t*)P_pThis;
+        uint8_t tag[AES_REF_BLOCK_SIZE];
+
+        if (!ccm_tag(handle, tag)) {
+            return CMOX_CIPHER_ERR_BAD_OPERATION;
+        }
+        memcpy(P_pTag, tag, handle->tagLen);
+        if (P_pTagLen != NULL) {
+            *P_pTagLen = handle->tagLen;
+        }
+        return CMOX_CIPHER_SUCCESS;
+    }
+    if (P_pThis->table->mode != MODE_GCM || P_pThis->table->decrypt) {
+        return CMOX_CIPHER_ERR_BAD_OPERATION;
+    }
+
+    cmox_gcm_common_t* common = gcm_common(P_pThis);
+    uint8_t lengths[AES_REF_BLOCK_SIZE];
+    uint8_t tag[AES_REF_BLOCK_SIZE];
+
+    store_length(lengths, 8 * (uint64_t)common->AdLen);
+    store_length(lengths + 8, 8 * (uint64_t)common->payloadLen);
+    aes_ref_ghash((uint8_t*)common->partialAuth, gcm_hash_key(P_pThis), lengths, AES_REF_BLOCK_SIZE);
+    aes_ref_encrypt(common->blockCipher.expandedKey, common->blockCipher.keyLen, (const uint8_t*)common->iv, tag);
+    xor_bytes(tag, tag, (const uint8_t*)common->partialAuth, AES_REF_BLOCK_SIZE);
+
+    memcpy(P_pTag, tag, common->tagLen);
+    if (P_pTagLen != NULL) {
+        *P_pTagLen = common->tagLen;
+    }
+    return CMOX_CIPHER_SUCCESS;
+}
+
+cmox_cipher_retval_t cmox_cipher_verifyTag(cmox_cipher_handle_t *P_pThis, const uint8_t *P_pTag, uint32_t *P_pFaultCheck)
+{
+    if (P_pThis == NULL || P_pThis->table == NULL || P_pTag == NULL) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    if (P_pThis->table->mode == MODE_CHACHAPOLY && P_pThis->table->decrypt) {
+        uint8_t tag[POLY_TAG_SIZE];
+
+        poly_final((cmox_chachapoly_handle_t*)P_pThis, tag);
+        cmox_cipher_retval_t retval = equal(tag, P_pTag, POLY_TAG_SIZE) ? CMOX_CIPHER_AUTH_SUCCESS : CMOX_CIPHER_AUTH_FAIL;
+        if (P_pFaultCheck != NULL) {
+            *P_pFaultCheck = retval;
+        }
+        return retval;
+    }
+    if (P_pThis->table->mode == MODE_CCM && P_pThis->table->decrypt) {
+        cmox_ccm_handle_t* handle = (cmox_ccm_handle_t*)P_pThis;
+        uint8_t tag[AES_REF_BLOCK_SIZE];
+
+        if (!ccm_tag(handle, tag)) {
+            return CMOX_CIPHER_ERR_BAD_OPERATION;
+        }
+        cmox_cipher_retval_t retval = equal(tag, P_pTag, handle->tagLen) ? CMOX_CIPHER_AUTH_SUCCESS : CMOX_CIPHER_AUTH_FAIL;
+        if (P_pFaultCheck != NULL) {
+            *P_pFaultCheck = retval;
+        }
+        return retval;
+    }
+    if (P_pThis->table->mode != MODE_GCM || !P_pThis->table->decrypt) {
+        return CMOX_CIPHER_ERR_BAD_OPERATION;
+    }
+
+    cmox_gcm_common_t* common = gcm_common(P_pThis);
+    uint8_t lengths[AES_REF_BLOCK_SIZE];
+    uint8_t tag[AES_REF_BLOCK_SIZE];
+
+    store_length(lengths, 8 * (uint64_t)common->AdLen);
+    store_length(lengths + 8, 8 * (uint64_t)common->payloadLen);
+    aes_ref_ghash((uint8_t*)common->partialAuth, gcm_hash_key(P_pThis), lengths, AES_REF_BLOCK_SIZE);
+    aes_ref_encrypt(common->blockCipher.expandedKey, common->blockCipher.keyLen, (const uint8_t*)common->iv, tag);
+    xor_bytes(tag, tag, (const uint8_t*)common->partialAuth, AES_REF_BLOCK_SIZE);
+
+    cmox_cipher_retval_t retval = equal(tag, P_pTag, common->tagLen) ? CMOX_CIPHER_AUTH_SUCCESS : CMOX_CIPHER_AUTH_FAIL;
+    if (P_pFaultCheck != NULL) {
+        *P_pFaultCheck = retval;
+    }
+    return retval;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static cmox_cipher_retval_t block_modes(const struct cmox_cipher_vtableStruct_st* vtable, const uint8_t* input, size_t length,
+        const uint8_t* key, size_t key_size, const uint8_t* iv, size_t iv_size, uint8_t* output, size_t* output_length)
+{
+    uint32_t round_keys[AES_REF_ROUND_KEYS_SIZE];
+    uint8_t chaining[AES_REF_BLOCK_SIZE];
+
+    if (input == NULL || output == NULL || key == NULL || !valid_key_size(key_size)) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    if (vtable->mode != MODE_ECB && (iv == NULL || iv_size != AES_REF_BLOCK_SIZE)) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    if ((vtable->mode == MODE_ECB || vtable->mode == MODE_CBC) && length % AES_REF_BLOCK_SIZE != 0) {
+        return CMOX_CIPHER_ERR_BAD_INPUT_SIZE;
+    }
+
+    aes_ref_expand_key(key, key_size, round_keys);
+    if (iv != NULL) {
+        memcpy(chaining, iv, AES_REF_BLOCK_SIZE);
+    }
+
+    cmox_cipher_retval_t retval = chain_blocks(vtable, round_keys, key_size, chaining, input, length, output);
+    if (retval == CMOX_CIPHER_SUCCESS && output_length != NULL) {
+        *output_length = length;
+    }
+    return retval;
+}
+
+/**
+ * ECB, CBC, CTR, CFB and OFB from the chaining block, which is updated, a
+ * partial last block only in the stream modes
+ */
+static cmox_cipher_retval_t chain_blocks(const struct cmox_cipher_vtableStruct_st* vtable, const uint32_t* round_keys,
+        size_t key_size, uint8_t* chaining, const uint8_t* input, size_t length, uint8_t* output)
+{
+    uint8_t block[AES_REF_BLOCK_SIZE];
+
+    for (size_t offset = 0; offset < length; offset += AES_REF_BLOCK_SIZE) {
+        size_t size = length - offset < AES_REF_BLOCK_SIZE ? length - offset : AES_REF_BLOCK_SIZE;
+
+        switch (vtable->mode) {
+        case MODE_ECB:
+            if (vtable->decrypt) {
+                aes_ref_decrypt(round_keys, key_size, input + offset, output + offset);
+            } else {
+                aes_ref_encrypt(round_keys, key_size, input + offset, output + offset);
+            }
+            break;
+
+        case MODE_CBC:
+            if (vtable->decrypt) {
+                memcpy(block, input + offset, AES_REF_BLOCK_SIZE);
+                aes_ref_decrypt(round_keys, key_size, block, output + offset);
+                xor_bytes(output + offset, output + offset, chaining, AES_REF_BLOCK_SIZE);
+                memcpy(chaining, block, AES_REF_BLOCK_SIZE);
+            } else {
+                xor_bytes(block, input + offset, chaining, AES_REF_BLOCK_SIZE);
+                aes_ref_encrypt(round_keys, key_size, block, output + offset);
+                memcpy(chaining, output + offset, AES_REF_BLOCK_SIZE);
+            }
+            break;
+
+        case MODE_CTR:
+            aes_ref_encrypt(round_keys, key_size, chaining, block);
+            xor_bytes(output + offset, input + offset, block, size);
+            increment_counter(chaining, AES_REF_BLOCK_SIZE);
+            break;
+
+        case MODE_CFB:
+            aes_ref_encrypt(round_keys, key_size, chaining, block);
+            if (vtable->decrypt) {
+                memcpy(chaining, input + offset, size);
+                xor_bytes(output + offset, input + offset, block, size);
+            } else {
+                xor_bytes(output + offset, input + offset, block, size);
+                memcpy(chaining, output + offset, size);
+            }
+            break;
+
+        case MODE_OFB:
+            aes_ref_encrypt(round_keys, key_size, chaining, chaining);
+            xor_bytes(output + offset, input + offset, chaining, size);
+            break;
+
+        default:
+            return CMOX_CIPHER_ERR_NOT_IMPLEMENTED;
+        }
+    }
+    return CMOX_CIPHER_SUCCESS;
+}
+
+/**
+ * The one-shot XTS and Key Wrap, through a handle
+ */
+static cmox_cipher_retval_t handle_modes(const struct cmox_cipher_vtableStruct_st* vtable, const uint8_t* input, size_t length,
+        const uint8_t* key, size_t key_size, const uint8_t* iv, size_t iv_size, uint8_t* output, size_t* output_length)
+{
+    cipher_handle_t handle;
+    cmox_cipher_retval_t retval;
+
+    memset(&handle, 0, sizeof(handle));
+    handle.super.table = vtable;
+    if ((retval = cmox_cipher_init(&handle.super)) != CMOX_CIPHER_SUCCESS
+            || (retval = cmox_cipher_setKey(&handle.super, key, key_size)) != CMOX_CIPHER_SUCCESS
+            || (retval = cmox_cipher_setIV(&handle.super, iv, iv_size)) != CMOX_CIPHER_SUCCESS) {
+        cmox_cipher_cleanup(&handle.super);
+        return retval;
+    }
+    retval = cmox_cipher_append(&handle.super, input, length, output, output_length);
+    cmox_cipher_cleanup(&handle.super);
+    return retval;
+}
+
+/**
+ * CCM of NIST SP 800-38C, the additional data are shorter than 65280 bytes
+ */
+static cmox_cipher_retval_t ccm(bool decrypt, const uint8_t* input, size_t length, size_t tag_size,
+        const uint8_t* key, size_t key_size, const uint8_t* nonce, size_t nonce_size,
+        const uint8_t* ad, size_t ad_size, uint8_t* output, size_t* output_length)
+{
+    uint32_t round_keys[AES_REF_ROUND_KEYS_SIZE];
+    uint8_t counter[AES_REF_BLOCK_SIZE];
+    uint8_t mac[AES_REF_BLOCK_SIZE];
+    uint8_t block[AES_REF_BLOCK_SIZE];
+    size_t q = AES_REF_BLOCK_SIZE - 1 - nonce_size;
+
+    if (input == NULL || output == NULL || key == NULL || nonce == NULL || !valid_key_size(key_size)) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    if (nonce_size < 7 || nonce_size > 13 || tag_size < 4 || tag_size > 16 || tag_size % 2 != 0
+            || ad_size > CCM_MAX_AD_SIZE || (ad == NULL && ad_size != 0)) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    if (decrypt) {
+        length -= tag_size;
+    }
+
+    aes_ref_expand_key(key, key_size, round_keys);
+
+    // B0 then the formatted additional data, CBC-MAC
+    memset(block, 0, sizeof(block));
+    block[0] = (ad_size > 0 ? 0x40 : 0) | ((tag_size - 2) / 2) << 3 | (q - 1);
+    memcpy(block + 1, nonce, nonce_size);
+    for (size_t i = 0; i < q && i < sizeof(size_t); i++) {
+        block[AES_REF_BLOCK_SIZE - 1 - i] = length >> (8 * i);
+    }
+    aes_ref_encrypt(round_keys, key_size, block, mac);
+
+    if (ad_size > 0) {
+        size_t used = 2;
+        memset(block, 0, sizeof(block));
+        block[0] = ad_size >> 8;
+        block[1] = ad_size;
+        for (size_t i = 0; i < ad_size; i++) {
+            block[used++] = ad[i];
+            if (used == AES_REF_BLOCK_SIZE || i == ad_size - 1) {
+                xor_bytes(mac, mac, block, AES_REF_BLOCK_SIZE);
+                aes_ref_encrypt(round_keys, key_size, mac, mac);
+                memset(block, 0, sizeof(block));
+                used = 0;
+            }
+        }
+    }
+
+    // counter blocks: flags, nonce, index
+    memset(counter, 0, sizeof(counter));
+    counter[0] = q - 1;
+    memcpy(counter + 1, nonce, nonce_size);
+
+    uint8_t first_stream[AES_REF_BLOCK_SIZE];
+    aes_ref_encrypt(round_keys, key_size, counter, first_stream);
+
+    for (size_t offset = 0; offset < length; offset += AES_REF_BLOCK_SIZE) {
+        size_t size = length - offset < AES_REF_BLOCK_SIZE ? length - offset : AES_REF_BLOCK_SIZE;
+        uint8_t stream[AES_REF_BLOCK_SIZE];
+
+        memset(block, 0, sizeof(block));
+        if (decrypt) {
+            increment_counter(counter, q);
+            aes_ref_encrypt(round_keys, key_size, counter, stream);
+            xor_bytes(output + offset, input + offset, stream, size);
+            memcpy(block, output + offset, size);
+        } else {
+            memcpy(block, input + offset, size);
+            increment_counter(counter, q);
+            aes_ref_encrypt(round_keys, key_size, counter, stream);
+            xor_bytes(output + offset, input + offset, stream, size);
+        }
+        xor_bytes(mac, mac, block, AES_REF_BLOCK_SIZE);
+        aes_ref_encrypt(round_keys, key_size, mac, mac);
+    }
+    xor_bytes(mac, mac, first_stream, tag_size);
+
+    if (decrypt) {
+        if (!equal(mac, input + length, tag_size)) {
+            memset(output, 0, length);
+            return CMOX_CIPHER_AUTH_FAIL;
+        }
+        if (output_length != NULL) {
+            *output_length = length;
+        }
+        return CMOX_CIPHER_AUTH_SUCCESS;
+    }
+
+    memcpy(output + length, mac, tag_size);
+    if (output_length != NULL) {
+        *output_length = length + tag_size;
+    }
+    return CMOX_CIPHER_SUCCESS;
+}
+
+/**
+ * CTR with a 128-bit counter, the counter is incremented for each full block
+ */
+static cmox_hash_handle_t* hash_construct(cmox_hash_handle_t* hash, size_t size, const struct cmox_hash_vtableStruct_st* vtable)
+{
+    if (hash == NULL) {
+        return NULL;
+    }
+    memset(hash, 0, size);
+    hash->table = vtable;
+    return hash;
+}
+
+static cmox_hash_retval_t hash_compute(const struct cmox_hash_vtableStruct_st* vtable, const uint8_t* input, size_t length,
+        uint8_t* digest, size_t digest_size)
+{
+    hash_handle_t handle;
+    cmox_hash_handle_t* hash = hash_construct(&handle.super, sizeof(handle), vtable);
+    cmox_hash_retval_t retval;
+
+    if ((retval = cmox_hash_init(hash)) == CMOX_HASH_SUCCESS
+            && (retval = cmox_hash_setTagLen(hash, digest_size)) == CMOX_HASH_SUCCESS
+            && (retval = cmox_hash_append(hash, input, length)) == CMOX_HASH_SUCCESS) {
+        retval = cmox_hash_generateTag(hash, digest, NULL);
+    }
+    cmox_hash_cleanup(hash);
+    return retval;
+}
+
+static size_t hash_handle_size(const struct cmox_hash_vtableStruct_st* vtable)
+{
+    if (vtable->family == HASH_SMALL) {
+        return sizeof(cmox_mdSmall_handle_t);
+    }
+    if (vtable->family == HASH_LARGE) {
+        return sizeof(cmox_mdLarge_handle_t);
+    }
+    return sizeof(cmox_sha3_handle_t);
+}
+
+/**
+ * Merkle-Damgard hashes, the bit count of the engine is the length of the
+ * message and gives the bytes waiting in the buffer
+ */
+static void md_append(cmox_hash_handle_t* hash, const uint8_t* input, size_t length)
+{
+    const struct cmox_hash_vtableStruct_st* vtable = hash->table;
+    cmox_mdSmall_handle_t* small = (cmox_mdSmall_handle_t*)hash;
+    cmox_mdLarge_handle_t* large = (cmox_mdLarge_handle_t*)hash;
+    cmox_md_engineCommon_t* engine = vtable->family == HASH_SMALL ? &small->md.engine : &large->md.engine;
+    uint8_t* buffer = vtable->family == HASH_SMALL ? small->md.internalBuffer : large->md.internalBuffer;
+    uint64_t bits = (uint64_t)engine->bitCount[1] << 32 | engine->bitCount[0];
+    size_t used = (bits / 8) % vtable->rate;
+
+    bits += 8 * (uint64_t)length;
+    engine->bitCount[0] = (uint32_t)bits;
+    engine->bitCount[1] = bits >> 32;
+
+    while (length > 0) {
+        size_t size = length < vtable->rate - used ? length : vtable->rate - used;
+
+        memcpy(buffer + used, input, size);
+        used += size;
+        input += size;
+        length -= size;
+        if (used == vtable->rate) {
+            if (vtable->family == HASH_SMALL) {
+                hash_ref_small_compress(vtable->md, small->md.internalState, buffer);
+            } else {
+                hash_ref_large_compress(large->md.internalState, buffer);
+            }
+            used = 0;
+        }
+    }
+}
+
+/**
+ * Pad with a bit 1, zeros and the length in bits (64 bits for the blocks of
+ * 64 bytes, 128 bits for the blocks of 128 bytes), the digest is the whole
+ * state in big-endian
+ */
+static void md_final(cmox_hash_handle_t* hash, uint8_t* digest)
+{
+    const struct cmox_hash_vtableStruct_st* vtable = hash->table;
+    cmox_mdSmall_handle_t* small = (cmox_mdSmall_handle_t*)hash;
+    cmox_mdLarge_handle_t* large = (cmox_mdLarge_handle_t*)hash;
+    cmox_md_engineCommon_t* engine = vtable->family == HASH_SMALL ? &small->md.engine : &large->md.engine;
+    uint64_t bits = (uint64_t)engine->bitCount[1] << 32 | engine->bitCount[0];
+    size_t used = (bits / 8) % vtable->rate;
+    size_t length_size = vtable->rate / 8;
+    uint8_t padding[2 * HASH_REF_LARGE_BLOCK_SIZE] = {0x80};
+    size_t padding_size = (used < vtable->rate - length_size ? vtable->rate : 2 * vtable->rate) - used;
+
+    store_length(padding + padding_size - 8, bits);
+    md_append(hash, padding, padding_size);
+
+    if (vtable->family == HASH_SMALL) {
+        for (size_t i = 0; i < vtable->size; i++) {
+            digest[i] = small->md.internalState[i / 4] >> (24 - 8 * (i % 4));
+        }
+    } else {
+        for (size_t i = 0; i < vtable->size; i++) {
+            digest[i] = large->md.internalState[i / 8] >> (56 - 8 * (i % 8));
+        }
+    }
+}
+
+static void sponge_absorb(cmox_sponge_handle_t* sponge, const uint8_t* input, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        sponge->state[sponge->byteIOIndex++] ^= input[i];
+        if (sponge->byteIOIndex == sponge->rate) {
+            hash_ref_keccak(sponge->state);
+            sponge->byteIOIndex = 0;
+        }
+    }
+}
+
+/**
+ * Absorb zeros up to the end of the block, the bytepad() of SP 800-185
+ */
+static void sponge_pad(cmox_sponge_handle_t* sponge)
+{
+    if (sponge->byteIOIndex != 0) {
+        sponge->byteIOIndex = 0;
+        hash_ref_keccak(sponge->state);
+    }
+}
+
+/**
+ * @param suffix the domain separation bits followed by the first bit of the
+ * padding
+ */
+static void sponge_final(cmox_sponge_handle_t* sponge, uint8_t suffix, uint8_t* output, size_t length)
+{
+    sponge->state[sponge->byteIOIndex] ^= suffix;
+    sponge->state[sponge->rate - 1] ^= SPONGE_LAST_BIT;
+    hash_ref_keccak(sponge->state);
+    sponge->squeezing = 1;
+
+    for (size_t i = 0, index = 0; i < length; i++, index++) {
+        if (index == sponge->rate) {
+            hash_ref_keccak(sponge->state);
+            index = 0;
+        }
+        output[i] = sponge->state[index];
+    }
+}
+
+/**
+ * left_encode() or right_encode() of SP 800-185
+ * @param encoding at least 9 bytes
+ * @return the size of the encoding
+ */
+static size_t encode_length(uint64_t value, bool right, uint8_t* encoding)
+{
+    size_t n = 1;
+    size_t size = 0;
+
+    while (n < 8 && value >> (8 * n) != 0) {
+        n++;
+    }
+    if (!right) {
+        encoding[size++] = n;
+    }
+    for (size_t i = 0; i < n; i++) {
+        encoding[size++] = value >> (8 * (n - 1 - i));
+    }
+    if (right) {
+        encoding[size++] = n;
+    }
+    return size;
+}
+
+/**
+ * encode_string() of SP 800-185, the length in bits then the string
+ */
+static void absorb_string(cmox_sponge_handle_t* sponge, const uint8_t* string, size_t length)
+{
+    uint8_t encoding[9];
+
+    sponge_absorb(sponge, encoding, encode_length(8 * (uint64_t)length, false, encoding));
+    sponge_absorb(sponge, string, length);
+}
+
+static cmox_mac_handle_t* mac_construct(cmox_mac_handle_t* mac, size_t size, const struct cmox_mac_vtableStruct_st* vtable)
+{
+    memset(mac, 0, size);
+    mac->table = vtable;
+    return mac;
+}
+
+static size_t mac_handle_size(const struct cmox_mac_vtableStruct_st* vtable)
+{
+    if (vtable->type == MAC_CMAC) {
+        return sizeof(cmox_cmac_handle_t);
+    }
+    if (vtable->type == MAC_HMAC) {
+        return sizeof(cmox_hmac_handle_t);
+    }
+    return sizeof(cmox_kmac_handle_t);
+}
+
+/**
+ * The key K0 of a block is kept in the handle, hashed first if it is longer
+ * than a block, the inner hash is started
+ */
+static cmox_mac_retval_t hmac_set_key(cmox_hmac_handle_t* handle, const uint8_t* key, size_t key_size)
+{
+    const struct cmox_hash_vtableStruct_st* hash = handle->super.table->hash;
+
+    memset(handle->key, 0, sizeof(handle->key));
+    if (key_size > hash->rate) {
+        if (hash_compute(hash, key, key_size, handle->key, hash->size) != CMOX_HASH_SUCCESS) {
+            return CMOX_MAC_ERR_INTERNAL;
+        }
+    } else if (key_size > 0) {
+        memcpy(handle->key, key, key_size);
+    }
+    hmac_start(handle, HMAC_IPAD);
+    return CMOX_MAC_SUCCESS;
+}
+
+/**
+ * Start the inner or the outer hash with the padded key K0 ^ pad
+ */
+static void hmac_start(cmox_hmac_handle_t* handle, uint8_t pad)
+{
+    const struct cmox_hash_vtableStruct_st* hash = handle->super.table->hash;
+    uint8_t block[HASH_REF_LARGE_BLOCK_SIZE];
+
+    for (size_t i = 0; i < hash->rate; i++) {
+        block[i] = handle->key[i] ^ pad;
+    }
+    handle->hash = hash_construct((cmox_hash_handle_t*)&handle->hash_context, sizeof(handle->hash_context), hash);
+    cmox_hash_init(handle->hash);
+    cmox_hash_append(handle->hash, block, hash->rate);
+}
+
+/**
+ * cSHAKE with the name "KMAC" and the custom data, then the key padded to a
+ * block (SP 800-185)
+ */
+static void kmac_set_key(cmox_kmac_handle_t* handle, const uint8_t* key, size_t key_size)
+{
+    static const uint8_t name[] = {'K', 'M', 'A', 'C'};
+    cmox_sponge_handle_t* sponge = &handle->internal_ctx.csi.sponge;
+    uint32_t rate = handle->super.table->rate;
+    uint8_t encoding[9];
+
+    memset(sponge, 0, sizeof(*sponge));
+    sponge->rate = rate;
+
+    sponge_absorb(sponge, encoding, encode_length(rate, false, encoding));
+    absorb_string(sponge, name, sizeof(name));
+    absorb_string(sponge, handle->custom_data, handle->customDataLen);
+    sponge_pad(sponge);
+
+    sponge_absorb(sponge, encoding, encode_length(rate, false, encoding));
+    absorb_string(sponge, key, key_size);
+    sponge_pad(sponge);
+    handle->internal_ctx.outputBitLen = 8 * handle->super.tagLen;
+}
+
+/**
+ * AES-CMAC (SP 800-38B), the last block is kept in the buffer until the next
+ * append, the MAC state is the IV
+ */
+static void cmac_append(cmox_cmac_handle_t* handle, const uint8_t* input, size_t length)
+{
+    uint8_t* state = (uint8_t*)handle->iv;
+
+    while (length > 0) {
+        if (handle->unprocessed_bytes == AES_REF_BLOCK_SIZE) {
+            xor_bytes(state, state, handle->temp_buffer, AES_REF_BLOCK_SIZE);
+            aes_ref_encrypt(handle->blockCipher.expandedKey, handle->blockCipher.keyLen, state, state);
+            handle->unprocessed_bytes = 0;
+        }
+
+        size_t size = AES_REF_BLOCK_SIZE - handle->unprocessed_bytes;
+        size = length < size ? length : size;
+        memcpy(handle->temp_buffer + handle->unprocessed_bytes, input, size);
+        handle->unprocessed_bytes += size;
+        input += size;
+        length -= size;
+    }
+}
+
+/**
+ * The last block is XORed with the subkey K1 when it is complete, K2 when it
+ * is padded
+ */
+static void cmac_final(cmox_cmac_handle_t* handle, uint8_t* tag)
+{
+    const uint32_t* round_keys = handle->blockCipher.expandedKey;
+    uint32_t key_size = handle->blockCipher.keyLen;
+    uint8_t subkey[AES_REF_BLOCK_SIZE] = {0};
+    uint8_t block[AES_REF_BLOCK_SIZE] = {0};
+    uint32_t last_length = handle->unprocessed_bytes;
+
+    aes_ref_encrypt(round_keys, key_size, subkey, subkey);
+    cmac_double(subkey);
+    if (last_length != AES_REF_BLOCK_SIZE) {
+        cmac_double(subkey);
+    }
+
+    memcpy(block, handle->temp_buffer, last_length);
+    if (last_length != AES_REF_BLOCK_SIZE) {
+        block[last_length] = 0x80;
+    }
+    xor_bytes(block, block, subkey, AES_REF_BLOCK_SIZE);
+    xor_bytes(tag, (uint8_t*)handle->iv, block, AES_REF_BLOCK_SIZE);
+    aes_ref_encrypt(round_keys, key_size, tag, tag);
+}
+
+/**
+ * Multiply by x in GF(2^128), the subkey generation of the CMAC
+ */
+static void cmac_double(uint8_t* block)
+{
+    uint8_t carry = block[0] & 0x80;
+
+    for (int i = 0; i < AES_REF_BLOCK_SIZE - 1; i++) {
+        block[i] = block[i] << 1 | block[i + 1] >> 7;
+    }
+    block[AES_REF_BLOCK_SIZE - 1] = block[AES_REF_BLOCK_SIZE - 1] << 1 ^ (carry ? CMAC_RB : 0);
+}
+
+static void ctr_process(const uint32_t* round_keys, uint32_t key_size, uint8_t* counter, const uint8_t* input, size_t length, uint8_t* output)
+{
+    uint8_t stream[AES_REF_BLOCK_SIZE];
+
+    for (size_t offset = 0; offset < length; offset += AES_REF_BLOCK_SIZE) {
+        size_t size = length - offset < AES_REF_BLOCK_SIZE ? length - offset : AES_REF_BLOCK_SIZE;
+
+        aes_ref_encrypt(round_keys, key_size, counter, stream);
+        xor_bytes(output + offset, input + offset, stream, size);
+        if (size == AES_REF_BLOCK_SIZE) {
+            increment_counter(counter, AES_REF_BLOCK_SIZE);
+        }
+    }
+}
+
+/**
+ * CCM of SP 800-38C through a handle: the CBC-MAC of B0 and the counter block
+ * A0, then the 2-byte length of the additional data waits in the buffer.
+ * AdLen and payloadLen count down what is still to be appended
+ */
+static cmox_cipher_retval_t ccm_start(cmox_ccm_handle_t* handle, const uint8_t* nonce, size_t nonce_size)
+{
+    uint8_t* counter = (uint8_t*)handle->ivCtr;
+    uint8_t* buffer = (uint8_t*)handle->tmpBuf;
+    uint8_t block[AES_REF_BLOCK_SIZE] = {0};
+    size_t q = AES_REF_BLOCK_SIZE - 1 - nonce_size;
+
+    if (nonce_size < 7 || nonce_size > 13 || (q < sizeof(size_t) && handle->payloadLen >> (8 * q) != 0)) {
+        return CMOX_CIPHER_ERR_BAD_PARAMETER;
+    }
+    handle->nonceLen = nonce_size;
+
+    block[0] = (handle->AdLen > 0 ? 0x40 : 0) | ((handle->tagLen - 2) / 2) << 3 | (q - 1);
+    memcpy(block + 1, nonce, nonce_size);
+    for (size_t i = 0; i < q && i < sizeof(size_t); i++) {
+        block[AES_REF_BLOCK_SIZE - 1 - i] = handle->payloadLen >> (8 * i);
+    }
+    aes_ref_encrypt(handle->blockCipher.expandedKey, handle->blockCipher.keyLen, block, (uint8_t*)handle->ivCbc);
+
+    memset(counter, 0, AES_REF_BLOCK_SIZE);
+    counter[0] = q - 1;
+    memcpy(counter + 1, nonce, nonce_size);
+
+    memset(buffer, 0, AES_REF_BLOCK_SIZE);
+    handle->tmpBufUse = 0;
+    if (handle->AdLen > 0) {
+        buffer[0] = handle->AdLen >> 8;
+        buffer[1] = handle->AdLen;
+        handle->tmpBufUse = 2;
+    }
+    return CMOX_CIPHER_SUCCESS;
+}
+
+/**
+ * The additional data go through the buffer, the last block is padded with
+ * zeros once all of them are appended
+ */
+static cmox_cipher_retval_t ccm_append_ad(cmox_ccm_handle_t* handle, const uint8_t* input, size_t length)
+{
+    uint8_t* buffer = (uint8_t*)handle->tmpBuf;
+
+    if (length > handle->AdLen) {
+        return CMOX_CIPHER_ERR_BAD_OPERATION;
+    }
+    for (size_t i = 0; i < length; i++) {
+        buffer[handle->tmpBufUse++] = input[i];
+        if (handle->tmpBufUse == AES_REF_BLOCK_SIZE) {
+            ccm_mac_block(handle, buffer);
+            handle->tmpBufUse = 0;
+        }
+    }
+    handle->AdLen -= length;
+    if (handle->AdLen == 0 && handle->tmpBufUse > 0) {
+        memset(buffer + handle->tmpBufUse, 0, AES_REF_BLOCK_SIZE - handle->tmpBufUse);
+        ccm_mac_block(handle, buffer);
+        handle->tmpBufUse = 0;
+    }
+    return CMOX_CIPHER_SUCCESS;
+}
+
+/**
+ * The payload after all the additional data, the CBC-MAC is over the plain
+ * text
+ */
+static cmox_cipher_retval_t ccm_append(cmox_ccm_handle_t* handle, const uint8_t* input, size_t length, uint8_t* output)
+{
+    uint8_t* counter = (uint8_t*)handle->ivCtr;
+    size_t q = AES_REF_BLOCK_SIZE - 1 - handle->nonceLen;
+
+    if (handle->AdLen != 0 || length > handle->payloadLen
+            || (length % AES_REF_BLOCK_SIZE != 0 && length != handle->payloadLen)) {
+        return CMOX_CIPHER_ERR_BAD_OPERATION;
+    }
+    for (size_t offset = 0; offset < length; offset += AES_REF_BLOCK_SIZE) {
+        size_t size = length - offset < AES_REF_BLOCK_SIZE ? length - offset : AES_REF_BLOCK_SIZE;
+        uint8_t stream[AES_REF_BLOCK_SIZE];
+        uint8_t block[AES_REF_BLOCK_SIZE] = {0};
+
+        increment_counter(counter, q);
+        aes_ref_encrypt(handle->blockCipher.expandedKey, handle->blockCipher.keyLen, counter, stream);
+        memcpy(block, input + offset, size);
+        xor_bytes(output + offset, input + offset, stream, size);
+        if (handle->super.table->decrypt) {
+            memcpy(block, output + offset, size);
+        }
+        ccm_mac_block(handle, block);
+    }
+    handle->payloadLen -= length;
+    return CMOX_CIPHER_SUCCESS;
+}
+
+static void ccm_mac_block(cmox_ccm_handle_t* handle, const uint8_t* block)
+{
+    uint8_t* mac = (uint8_t*)handle->ivCbc;
+
+    xor_bytes(mac, mac, block, AES_REF_BLOCK_SIZE);
+    aes_ref_encrypt(handle->blockCipher.expandedKey, handle->blockCipher.keyLen, mac, mac);
+}
+
+/**
+ * The CBC-MAC encrypted with A0, the counter block back to index 0
+ * @return false if data are still to be appended
+ */
+static bool ccm_tag(cmox_ccm_handle_t* handle, uint8_t* tag)
+{
+    uint8_t counter[AES_REF_BLOCK_SIZE];
+    size_t nonce_end = 1 + handle->nonceLen;
+
+    if (handle->AdLen != 0 || handle->payloadLen != 0) {
+        return false;
+    }
+    memcpy(counter, handle->ivCtr, AES_REF_BLOCK_SIZE);
+    memset(counter + nonce_end, 0, AES_REF_BLOCK_SIZE - nonce_end);
+    aes_ref_encrypt(handle->blockCipher.expandedKey, handle->blockCipher.keyLen, counter, tag);
+    xor_bytes(tag, tag, (const uint8_t*)handle->ivCbc, AES_REF_BLOCK_SIZE);
+    return true;
+}
+
+/**
+ * XTS of IEEE 1619, the tweak goes on from an append of whole blocks to the
+ * next one; a partial last block is processed by ciphertext stealing and ends
+ * the data unit
+ */
+static cmox_cipher_retval_t xts_append(cmox_xts_handle_t* handle, const uint8_t* input, size_t length, uint8_t* output)
+{
+    uint8_t* tweak = (uint8_t*)handle->tweak;
+    size_t partial = length % AES_REF_BLOCK_SIZE;
+    size_t blocks = length / AES_REF_BLOCK_SIZE;
+
+    if (handle->super.internalState == XTS_STOLEN) {
+        return CMOX_CIPHER_ERR_BAD_OPERATION;
+    }
+    if (length < AES_REF_BLOCK_SIZE) {
+        return CMOX_CIPHER_ERR_BAD_INPUT_SIZE;
+    }
+
+    // the last whole block is kept for the stealing
+    if (partial != 0) {
+        blocks--;
+    }
+    for (size_t i = 0; i < blocks; i++) {
+        xts_block(handle, tweak, input + i * AES_REF_BLOCK_SIZE, output + i * AES_REF_BLOCK_SIZE);
+        xts_double(tweak);
+    }
+
+    if (partial != 0) {
+        const uint8_t* last_input = input + blocks * AES_REF_BLOCK_SIZE;
+        uint8_t* last_output = output + blocks * AES_REF_BLOCK_SIZE;
+        uint8_t next[AES_REF_BLOCK_SIZE];
+        uint8_t tail[AES_REF_BLOCK_SIZE];
+        uint8_t block[AES_REF_BLOCK_SIZE];
+
+        memcpy(next, tweak, AES_REF_BLOCK_SIZE);
+        xts_double(next);
+        // the encryption uses the tweak of the last whole block first, the
+        // decryption the next one; the input may be the output
+        memcpy(tail, last_input + AES_REF_BLOCK_SIZE, partial);
+        xts_block(handle, handle->super.table->decrypt ? next : tweak, last_input, block);
+        memcpy(last_output + AES_REF_BLOCK_SIZE, block, partial);
+        memcpy(block, tail, partial);
+        xts_block(handle, handle->super.table->decrypt ? tweak : next, block, last_output);
+        handle->super.internalState = XTS_STOLEN;
+    }
+    return CMOX_CIPHER_SUCCESS;
+}
+
+static void xts_block(cmox_xts_handle_t* handle, const uint8_t* tweak, const uint8_t* input, uint8_t* output)
+{
+    uint8_t block[AES_REF_BLOCK_SIZE];
+
+    xor_bytes(block, input, tweak, AES_REF_BLOCK_SIZE);
+    if (handle->super.table->decrypt) {
+        aes_ref_decrypt(handle->blockCipher1.expandedKey, handle->blockCipher1.keyLen, block, block);
+    } else {
+        aes_ref_encrypt(handle->blockCipher1.expandedKey, handle->blockCipher1.keyLen, block, block);
+    }
+    xor_bytes(output, block, tweak, AES_REF_BLOCK_SIZE);
+}
+
+/**
+ * Multiply the tweak by x in GF(2^128), little-endian unlike the CMAC
+ */
+static void xts_double(uint8_t* tweak)
+{
+    uint8_t carry = tweak[AES_REF_BLOCK_SIZE - 1] & 0x80;
+
+    for (int i = AES_REF_BLOCK_SIZE - 1; i > 0; i--) {
+        tweak[i] = tweak[i] << 1 | tweak[i - 1] >> 7;
+    }
+    tweak[0] = tweak[0] << 1 ^ (carry ? XTS_RB : 0);
+}
+
+/**
+ * Key Wrap of RFC 3394, the wrapped key is the integrity block followed by the
+ * semiblocks, the input may be the output
+ */
+static cmox_cipher_retval_t keywrap_append(cmox_keywrap_handle_t* handle, const uint8_t* input, size_t length,
+        uint8_t* output, size_t* output_length)
+{
+    const uint32_t* round_keys = handle->blockCipher.expandedKey;
+    uint32_t key_size = handle->blockCipher.keyLen;
+    const uint8_t* iv = (const uint8_t*)handle->iv;
+    bool decrypt = handle->super.table->decrypt;
+    size_t n = length / KEYWRAP_SEMIBLOCK_SIZE - (decrypt ? 1 : 0);
+    uint8_t block[AES_REF_BLOCK_SIZE]; // the integrity block A, then a semiblock R[i]
+
+    if (length % KEYWRAP_SEMIBLOCK_SIZE != 0 || n < 2) {
+        return CMOX_CIPHER_ERR_BAD_INPUT_SIZE;
+    }
+
+    if (!decrypt) {
+        memmove(output + KEYWRAP_SEMIBLOCK_SIZE, input, length);
+        memcpy(block, iv, KEYWRAP_SEMIBLOCK_SIZE);
+        for (size_t j = 0; j < KEYWRAP_ROUNDS; j++) {
+            for (size_t i = 1; i <= n; i++) {
+                uint8_t* r = output + i * KEYWRAP_SEMIBLOCK_SIZE;
+                memcpy(block + KEYWRAP_SEMIBLOCK_SIZE, r, KEYWRAP_SEMIBLOCK_SIZE);
+                aes_ref_encrypt(round_keys, key_size, block, block);
+                keywrap_xor_step(block, n * j + i);
+                memcpy(r, block + KEYWRAP_SEMIBLOCK_SIZE, KEYWRAP_SEMIBLOCK_SIZE);
+            }
+        }
+        memcpy(output, block, KEYWRAP_SEMIBLOCK_SIZE);
+        if (output_length != NULL) {
+            *output_length = length + KEYWRAP_SEMIBLOCK_SIZE;
+        }
+        return CMOX_CIPHER_SUCCESS;
+    }
+
+    memcpy(block, input, KEYWRAP_SEMIBLOCK_SIZE);
+    memmove(output, input + KEYWRAP_SEMIBLOCK_SIZE, n * KEYWRAP_SEMIBLOCK_SIZE);
+    for (size_t j = KEYWRAP_ROUNDS; j-- > 0;) {
+        for (size_t i = n; i >= 1; i--) {
+            uint8_t* r = output + (i - 1) * KEYWRAP_SEMIBLOCK_SIZE;
+            keywrap_xor_step(block, n * j + i);
+            memcpy(block + KEYWRAP_SEMIBLOCK_SIZE, r, KEYWRAP_SEMIBLOCK_SIZE);
+            aes_ref_decrypt(round_keys, key_size, block, block);
+            memcpy(r, block + KEYWRAP_SEMIBLOCK_SIZE, KEYWRAP_SEMIBLOCK_SIZE);
+        }
+    }
+    if (!equal(block, iv, KEYWRAP_SEMIBLOCK_SIZE)) {
+        memset(output, 0, n * KEYWRAP_SEMIBLOCK_SIZE);
+        return CMOX_CIPHER_AUTH_FAIL;
+    }
+    if (output_length != NULL) {
+        *output_length = n * KEYWRAP_SEMIBLOCK_SIZE;
+    }
+    return CMOX_CIPHER_AUTH_SUCCESS;
+}
+
+/**
+ * XOR the step counter t into the integrity block, big-endian
+ */
+static void keywrap_xor_step(uint8_t* block, uint64_t step)
+{
+    for (int i = 0; i < KEYWRAP_SEMIBLOCK_SIZE; i++) {
+        block[i] ^= step >> (56 - 8 * i);
+    }
+}
+
+/**
+ * The handle of the one-shot AEAD, a GCM handle without tables or a
+ * ChaCha20-Poly1305 handle
+ */
+static cmox_cipher_handle_t* aead_construct(cipher_handle_t* handle, cipher_mode_t mode, bool decrypt)
+{
+    if (mode == MODE_CHACHAPOLY) {
+        return cmox_chachapoly_construct(&handle->chachapoly, decrypt ? &chachapoly_dec : &chachapoly_enc);
+    }
+    return cmox_gcmSmall_construct(&handle->gcm, decrypt ? &gcm_small_dec : &gcm_small_enc);
+}
+
+/**
+ * One block of the ChaCha20 key stream (RFC 8439), the counter is incremented
+ */
+static void chacha_block(uint32_t* state, uint8_t* keystream)
+{
+    uint32_t x[16];
+
+    memcpy(x, state, sizeof(x));
+    for (int i = 0; i < CHACHA_ROUNDS; i += 2) {
+        QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+        QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+        QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+        QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+    }
+    for (int i = 0; i < 16; i++) {
+        store32_le(&keystream[4 * i], x[i] + state[i]);
+    }
+    state[12]++;
+}
+
+static void chacha_process(uint32_t* state, const uint8_t* input, size_t length, uint8_t* output)
+{
+    uint8_t keystream[CHACHA_BLOCK_SIZE];
+
+    for (size_t i = 0; i < length; i += CHACHA_BLOCK_SIZE) {
+        size_t size = length - i < CHACHA_BLOCK_SIZE ? length - i : CHACHA_BLOCK_SIZE;
+        chacha_block(state, keystream);
+        xor_bytes(output + i, input + i, keystream, size);
+    }
+    memset(keystream, 0, sizeof(keystream));
+}
+
+/**
+ * r (clamped) and s of Poly1305, r in limbs of 26 bits
+ */
+static void poly_set_key(cmox_chachapoly_handle_t* handle, const uint8_t* key)
+{
+    handle->rValue[0] = load32_le(key) & 0x3ffffff;
+    handle->rValue[1] = (load32_le(key + 3) >> 2) & 0x3ffff03;
+    handle->rValue[2] = (load32_le(key + 6) >> 4) & 0x3ffc0ff;
+    handle->rValue[3] = (load32_le(key + 9) >> 6) & 0x3f03fff;
+    handle->rValue[4] = (load32_le(key + 12) >> 8) & 0x00fffff;
+    for (int i = 0; i < 4; i++) {
+        handle->pad[i] = load32_le(key + 16 + 4 * i);
+    }
+    memset(handle->hValue, 0, sizeof(handle->hValue));
+}
+
+/**
+ * Poly1305 of the AEAD, a partial last block is padded with zeros
+ */
+static void poly_append(cmox_chachapoly_handle_t* handle, const uint8_t* input, size_t length)
+{
+    size_t blocks = length / POLY_BLOCK_SIZE;
+    size_t partial = length % POLY_BLOCK_SIZE;
+
+    poly_blocks(handle, input, blocks);
+    if (partial != 0) {
+        uint8_t block[POLY_BLOCK_SIZE] = {0};
+        memcpy(block, input + blocks * POLY_BLOCK_SIZE, partial);
+        poly_blocks(handle, block, 1);
+    }
+}
+
+/**
+ * h = (h + block + 2^128) * r mod 2^130 - 5 for every block
+ */
+static void poly_blocks(cmox_chachapoly_handle_t* handle, const uint8_t* input, size_t blocks)
+{
+    const uint32_t* r = handle->rValue;
+    uint32_t* h = handle->hValue;
+    uint32_t s1 = r[1] * 5;
+    uint32_t s2 = r[2] * 5;
+    uint32_t s3 = r[3] * 5;
+    uint32_t s4 = r[4] * 5;
+
+    for (size_t i = 0; i < blocks; i++, input += POLY_BLOCK_SIZE) {
+        uint64_t d[5];
+        uint32_t carry;
+
+        h[0] += load32_le(input) & POLY_LIMB_MASK;
+        h[1] += (load32_le(input + 3) >> 2) & POLY_LIMB_MASK;
+        h[2] += (load32_le(input + 6) >> 4) & POLY_LIMB_MASK;
+        h[3] += (load32_le(input + 9) >> 6) & POLY_LIMB_MASK;
+        h[4] += (load32_le(input + 12) >> 8) | 1 << 24;
+
+        d[0] = (uint64_t)h[0] * r[0] + (uint64_t)h[1] * s4 + (uint64_t)h[2] * s3 + (uint64_t)h[3] * s2 + (uint64_t)h[4] * s1;
+        d[1] = (uint64_t)h[0] * r[1] + (uint64_t)h[1] * r[0] + (uint64_t)h[2] * s4 + (uint64_t)h[3] * s3 + (uint64_t)h[4] * s2;
+        d[2] = (uint64_t)h[0] * r[2] + (uint64_t)h[1] * r[1] + (uint64_t)h[2] * r[0] + (uint64_t)h[3] * s4 + (uint64_t)h[4] * s3;
+        d[3] = (uint64_t)h[0] * r[3] + (uint64_t)h[1] * r[2] + (uint64_t)h[2] * r[1] + (uint64_t)h[3] * r[0] + (uint64_t)h[4] * s4;
+        d[4] = (uint64_t)h[0] * r[4] + (uint64_t)h[1] * r[3] + (uint64_t)h[2] * r[2] + (uint64_t)h[3] * r[1] + (uint64_t)h[4] * r[0];
+
+        // partial reduction, 2^130 = 5
+        for (int j = 0; j < 4; j++) {
+            d[j + 1] += d[j] >> 26;
+            h[j] = d[j] & POLY_LIMB_MASK;
+        }
+        h[4] = d[4] & POLY_LIMB_MASK;
+        h[0] += (uint32_t)(d[4] >> 26) * 5;
+        carry = h[0] >> 26;
+        h[0] &= POLY_LIMB_MASK;
+        h[1] += carry;
+    }
+}
+
+/**
+ * Append the lengths, reduce h and add s
+ */
+static void poly_final(cmox_chachapoly_handle_t* handle, uint8_t* tag)
+{
+    uint8_t lengths[POLY_BLOCK_SIZE];
+    uint32_t* h = handle->hValue;
+    uint32_t g[5];
+    uint32_t carry;
+    uint64_t sum;
+
+    for (int i = 0; i < 8; i++) {
+        lengths[i] = (uint64_t)handle->mAadLen >> (8 * i);
+        lengths[8 + i] = (uint64_t)handle->mCipherLen >> (8 * i);
+    }
+    poly_blocks(handle, lengths, 1);
+
+    // full carry, then h - p if h >= p = 2^130 - 5
+    for (int i = 1; i < 5; i++) {
+        h[i] += h[i - 1] >> 26;
+        h[i - 1] &= POLY_LIMB_MASK;
+    }
+    h[0] += (h[4] >> 26) * 5;
+    h[4] &= POLY_LIMB_MASK;
+    h[1] += h[0] >> 26;
+    h[0] &= POLY_LIMB_MASK;
+
+    carry = 5;
+    for (int i = 0; i < 5; i++) {
+        g[i] = h[i] + carry;
+        carry = g[i] >> 26;
+        g[i] &= POLY_LIMB_MASK;
+    }
+    uint32_t mask = 0 - (carry & 1); // all ones if h + 5 >= 2^130
+    for (int i = 0; i < 5; i++) {
+        h[i] = (h[i] & ~mask) | (g[i] & mask);
+    }
+
+    uint32_t words[4] = {
+        h[0] | h[1] << 26,
+        h[1] >> 6 | h[2] << 20,
+        h[2] >> 12 | h[3] << 14,
+        h[3] >> 18 | h[4] << 8,
+    };
+    sum = 0;
+    for (int i = 0; i < 4; i++) {
+        sum += (uint64_t)words[i] + handle->pad[i];
+        store32_le(&tag[4 * i], (uint32_t)sum);
+        sum >>= 32;
+    }
+}
+
+static uint32_t load32_le(const uint8_t* bytes)
+{
+    return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}
+
+static void store32_le(uint8_t* bytes, uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        bytes[i] = value >> (8 * i);
+    }
+}
+
+static size_t cipher_handle_size(const struct cmox_cipher_vtableStruct_st* vtable)
+{
+    switch (vtable->mode) {
+    case MODE_ECB:
+        return sizeof(cmox_ecb_handle_t);
+    case MODE_CBC:
+        return sizeof(cmox_cbc_handle_t);
+    case MODE_CFB:
+        return sizeof(cmox_cfb_handle_t);
+    case MODE_OFB:
+        return sizeof(cmox_ofb_handle_t);
+    case MODE_GCM:
+        return vtable->table8x16 ? sizeof(cmox_gcmFast_handle_t) : sizeof(cmox_gcmSmall_handle_t);
+    case MODE_CCM:
+        return sizeof(cmox_ccm_handle_t);
+    case MODE_XTS:
+        return sizeof(cmox_xts_handle_t);
+    case MODE_KEYWRAP:
+        return sizeof(cmox_keywrap_handle_t);
+    case MODE_CHACHAPOLY:
+        return sizeof(cmox_chachapoly_handle_t);
+    default:
+        return sizeof(cmox_ctr_handle_t);
+    }
+}
+
+/**
+ * @return the block cipher of the handles with a single key, NULL for the
+ * others
+ */
+static cmox_blockcipher_handle_t* block_cipher(cmox_cipher_handle_t* cipher)
+{
+    switch (cipher->table->mode) {
+    case MODE_ECB:
+        return &((cmox_ecb_handle_t*)cipher)->blockCipher;
+    case MODE_CBC:
+        return &((cmox_cbc_handle_t*)cipher)->blockCipher;
+    case MODE_CTR:
+        return &((cmox_ctr_handle_t*)cipher)->blockCipher;
+    case MODE_CFB:
+        return &((cmox_cfb_handle_t*)cipher)->blockCipher;
+    case MODE_OFB:
+        return &((cmox_ofb_handle_t*)cipher)->blockCipher;
+    case MODE_CCM:
+        return &((cmox_ccm_handle_t*)cipher)->blockCipher;
+    case MODE_KEYWRAP:
+        return &((cmox_keywrap_handle_t*)cipher)->blockCipher;
+    default:
+        return NULL;
+    }
+}
+
+/**
+ * @return the IV of CBC, CTR, CFB and OFB, updated by each append, NULL for
+ * the other modes
+ */
+static uint8_t* chaining_block(cmox_cipher_handle_t* cipher)
+{
+    switch (cipher->table->mode) {
+    case MODE_CBC:
+        return (uint8_t*)((cmox_cbc_handle_t*)cipher)->iv;
+    case MODE_CTR:
+        return (uint8_t*)((cmox_ctr_handle_t*)cipher)->iv;
+    case MODE_CFB:
+        return (uint8_t*)((cmox_cfb_handle_t*)cipher)->iv;
+    case MODE_OFB:
+        return (uint8_t*)((cmox_ofb_handle_t*)cipher)->iv;
+    default:
+        return NULL;
+    }
+}
+
+static cmox_gcm_common_t* gcm_common(cmox_cipher_handle_t* cipher)
+{
+    if (cipher->table->table8x16) {
+        return &((cmox_gcmFast_handle_t*)cipher)->common;
+    }
+    return &((cmox_gcmSmall_handle_t*)cipher)->common;
+}
+
+/**
+ * The hash key H is kept in the first entry of the precomputed table
+ */
+static uint8_t* gcm_hash_key(cmox_cipher_handle_t* cipher)
+{
+    if (cipher->table->table8x16) {
+        return (uint8_t*)((cmox_gcmFast_handle_t*)cipher)->precomputedValues[0][0];
+    }
+    return (uint8_t*)((cmox_gcmSmall_handle_t*)cipher)->precomputedValues[0];
+}
+
+static bool valid_key_size(size_t key_size)
+{
+    return key_size == 16 || key_size == 24 || key_size == 32;
+}
+
+/**
+ * Increment the last bytes of a counter block, big-endian
+ * @param size the number of bytes of the counter, from the end of the block
+ */
+static void increment_counter(uint8_t* counter, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        if (++counter[AES_REF_BLOCK_SIZE - 1 - i] != 0) {
+            break;
+        }
+    }
+}
+
+static void xor_bytes(uint8_t* result, const uint8_t* x, const uint8_t* y, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        result[i] = x[i] ^ y[i];
+    }
+}
+
+/**
+ * Constant-time comparison
+ */
+static bool equal(const uint8_t* x, const uint8_t* y, size_t length)
+{
+    uint8_t difference = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        difference |= x[i] ^ y[i];
+    }
+    return difference == 0;
+}
+
+static void store_length(uint8_t* block, uint64_t bits)
+{
+    for (int i = 0; i < 8; i++) {
+        block[i] = bits >> (56 - 8 * i);
+    }
+}
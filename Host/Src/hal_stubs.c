@@ -0,0 +1,363 @@
+/**
+ ******************************************************************************
+ * @file    hal_stubs.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   HAL functions replaced in the host build
+ *
+ * The clock, power and GPIO configurations have no effect, the tick is
+ * virtual (HAL_Delay() advances it). The DMA channels move the data between
+ * the memory and the peripheral models, the end of a transfer is signaled
+ * after host_set_pending_later(). The UART sends to host_output().
+ * The CRYP and Cortex drivers are compiled unchanged.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "stm32l4xx_hal.h"
+
+#include "host.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define DMA_CHANNEL_NUMBER 14
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct {
+    DMA_HandleTypeDef* handle;
+    uint32_t memory;
+    uint32_t peripheral;
+    uint32_t remaining;
+    bool complete;
+} dma_channel_t;
+
+typedef struct {
+    const void* instance;
+    IRQn_Type irq;
+} irq_map_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+__IO uint32_t uwTick;
+uint32_t uwTickPrio = (1UL << __NVIC_PRIO_BITS);
+HAL_TickFreqTypeDef uwTickFreq = HAL_TICK_FREQ_DEFAULT;
+
+static dma_channel_t dma_channels[DMA_CHANNEL_NUMBER];
+
+static const irq_map_t dma_irqs[DMA_CHANNEL_NUMBER] = {
+    {DMA1_Channel1, DMA1_Channel1_IRQn},
+    {DMA1_Channel2, DMA1_Channel2_IRQn},
+    {DMA1_Channel3, DMA1_Channel3_IRQn},
+    {DMA1_Channel4, DMA1_Channel4_IRQn},
+    {DMA1_Channel5, DMA1_Channel5_IRQn},
+    {DMA1_Channel6, DMA1_Channel6_IRQn},
+    {DMA1_Channel7, DMA1_Channel7_IRQn},
+    {DMA2_Channel1, DMA2_Channel1_IRQn},
+    {DMA2_Channel2, DMA2_Channel2_IRQn},
+    {DMA2_Channel3, DMA2_Channel3_IRQn},
+    {DMA2_Channel4, DMA2_Channel4_IRQn},
+    {DMA2_Channel5, DMA2_Channel5_IRQn},
+    {DMA2_Channel6, DMA2_Channel6_IRQn},
+    {DMA2_Channel7, DMA2_Channel7_IRQn},
+};
+
+static const irq_map_t uart_irqs[] = {
+    {USART1, USART1_IRQn},
+    {USART2, USART2_IRQn},
+    {USART3, USART3_IRQn},
+    {LPUART1, LPUART1_IRQn},
+};
+
+/* Private function prototypes -----------------------------------------------*/
+
+static dma_channel_t* find_channel(const DMA_HandleTypeDef* handle);
+static void transfer_done(dma_channel_t* channel);
+static uint32_t data_size(uint32_t alignment);
+static IRQn_Type find_irq(const irq_map_t* map, uint32_t number, const void* instance);
+
+/* Public functions ----------------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_Init(void)
+{
+    HAL_NVIC_SetPriorityGrouping(NVIC_PRIORITYGROUP_4);
+    HAL_MspInit();
+    return HAL_OK;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return uwTick;
+}
+
+void HAL_IncTick(void)
+{
+    uwTick += uwTickFreq;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    uwTick += Delay;
+}
+
+void HAL_SuspendTick(void)
+{
+}
+
+void HAL_ResumeTick(void)
+{
+}
+
+HAL_StatusTypeDef HAL_PWREx_ControlVoltageScaling(uint32_t VoltageScaling)
+{
+    (void)VoltageScaling;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct)
+{
+    (void)RCC_OscInitStruct;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency)
+{
+    (void)RCC_ClkInitStruct;
+    (void)FLatency;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit)
+{
+    (void)PeriphClkInit;
+    return HAL_OK;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    (void)GPIOx;
+    (void)GPIO_Init;
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin)
+{
+    (void)GPIOx;
+    (void)GPIO_Pin;
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
+{
+    if (hdma == NULL) {
+        return HAL_ERROR;
+    }
+    hdma->ErrorCode = HAL_DMA_ERROR_NONE;
+    hdma->State = HAL_DMA_STATE_READY;
+    hdma->Lock = HAL_UNLOCKED;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma)
+{
+    if (hdma == NULL) {
+        return HAL_ERROR;
+    }
+    dma_channel_t* channel = find_channel(hdma);
+    if (channel != NULL) {
+        memset(channel, 0, sizeof(*channel));
+    }
+    hdma->State = HAL_DMA_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength)
+{
+    if (hdma->State != HAL_DMA_STATE_READY) {
+        return HAL_BUSY;
+    }
+
+    dma_channel_t* channel = find_channel(hdma);
+    if (channel == NULL) {
+        return HAL_ERROR;
+    }
+
+    hdma->State = HAL_DMA_STATE_BUSY;
+    hdma->ErrorCode = HAL_DMA_ERROR_NONE;
+    channel->handle = hdma;
+    channel->complete = false;
+    channel->remaining = DataLength;
+    if (hdma->Init.Direction == DMA_PERIPH_TO_MEMORY) {
+        channel->peripheral = SrcAddress;
+        channel->memory = DstAddress;
+    } else {
+        channel->memory = SrcAddress;
+        channel->peripheral = DstAddress;
+    }
+
+    if (DataLength == 0) {
+        transfer_done(channel);
+    }
+    host_dma_request();
+    return HAL_OK;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
+{
+    dma_channel_t* channel = find_channel(hdma);
+
+    if (channel == NULL || !channel->complete) {
+        return;
+    }
+
+    channel->complete = false;
+    hdma->State = HAL_DMA_STATE_READY;
+    __HAL_UNLOCK(hdma);
+    if (hdma->XferCpltCallback != NULL) {
+        hdma->XferCpltCallback(hdma);
+    }
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart)
+{
+    if (huart == NULL) {
+        return HAL_ERROR;
+    }
+    if (huart->gState == HAL_UART_STATE_RESET) {
+        huart->Lock = HAL_UNLOCKED;
+        HAL_UART_MspInit(huart);
+    }
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+/**
+ * The bytes are sent at once, the end of the transfer is signaled by the
+ * UART interrupt (TC), as with the DMA of the HAL
+ */
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+    if (huart->gState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+    if (pData == NULL || Size == 0) {
+        return HAL_ERROR;
+    }
+
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    huart->pTxBuffPtr = pData;
+    huart->TxXferSize = Size;
+    huart->TxXferCount = 0;
+
+    host_output(pData, Size);
+    host_set_pending(find_irq(uart_irqs, sizeof(uart_irqs) / sizeof(uart_irqs[0]), huart->Instance));
+    host_deliver_irqs();
+    return HAL_OK;
+}
+
+void HAL_UART_IRQHandler(UART_HandleTypeDef *huart)
+{
+    if (huart->gState == HAL_UART_STATE_BUSY_TX) {
+        huart->gState = HAL_UART_STATE_READY;
+        HAL_UART_TxCpltCallback(huart);
+    }
+}
+
+bool host_dma_read(uint32_t address, uint32_t* value)
+{
+    for (uint32_t i = 0; i < DMA_CHANNEL_NUMBER; i++) {
+        dma_channel_t* channel = &dma_channels[i];
+        if (channel->remaining == 0 || channel->peripheral != address
+                || channel->handle->Init.Direction != DMA_MEMORY_TO_PERIPH) {
+            continue;
+        }
+
+        uint32_t size = data_size(channel->handle->Init.MemDataAlignment);
+        const void* memory = (const void*)(uintptr_t)channel->memory;
+        *value = size == 4 ? *(const uint32_t*)memory : size == 2 ? *(const uint16_t*)memory : *(const uint8_t*)memory;
+        if (channel->handle->Init.MemInc == DMA_MINC_ENABLE) {
+            channel->memory += size;
+        }
+        if (--channel->remaining == 0) {
+            transfer_done(channel);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool host_dma_write(uint32_t address, uint32_t value)
+{
+    for (uint32_t i = 0; i < DMA_CHANNEL_NUMBER; i++) {
+        dma_channel_t* channel = &dma_channels[i];
+        if (channel->remaining == 0 || channel->peripheral != address
+                || channel->handle->Init.Direction != DMA_PERIPH_TO_MEMORY) {
+            continue;
+        }
+
+        uint32_t size = data_size(channel->handle->Init.MemDataAlignment);
+        void* memory = (void*)(uintptr_t)channel->memory;
+        if (size == 4) {
+            *(uint32_t*)memory = value;
+        } else if (size == 2) {
+            *(uint16_t*)memory = value;
+        } else {
+            *(uint8_t*)memory = value;
+        }
+        if (channel->handle->Init.MemInc == DMA_MINC_ENABLE) {
+            channel->memory += size;
+        }
+        if (--channel->remaining == 0) {
+            transfer_done(channel);
+        }
+        return true;
+    }
+    return false;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * @return the state of the channel of a handle, by its instance
+ */
+static dma_channel_t* find_channel(const DMA_HandleTypeDef* handle)
+{
+    for (uint32_t i = 0; i < DMA_CHANNEL_NUMBER; i++) {
+        if (dma_irqs[i].instance == handle->Instance) {
+            return &dma_channels[i];
+        }
+    }
+    return NULL;
+}
+
+static void transfer_done(dma_channel_t* channel)
+{
+    channel->complete = true;
+    host_set_pending_later(dma_irqs[channel - dma_channels].irq);
+}
+
+static uint32_t data_size(uint32_t alignment)
+{
+    if (alignment == DMA_MDATAALIGN_WORD) {
+        return 4;
+    }
+    return alignment == DMA_MDATAALIGN_HALFWORD ? 2 : 1;
+}
+
+static IRQn_Type find_irq(const irq_map_t* map, uint32_t number, const void* instance)
+{
+    for (uint32_t i = 0; i < number; i++) {
+        if (map[i].instance == instance) {
+            return map[i].irq;
+        }
+    }
+    return NonMaskableInt_IRQn;
+}
@@ -0,0 +1,412 @@
+/**
+ ******************************************************************************
+ * @file    hash_ref.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   portable reference hash functions for the host build
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "hash_ref.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define SHA1_ROUNDS 80
+#define SHA256_ROUNDS 64
+#define SHA512_ROUNDS 80
+#define SM3_ROUNDS 64
+#define KECCAK_ROUNDS 24
+#define KECCAK_LANES 25
+
+/* Private variables ---------------------------------------------------------*/
+
+static const uint32_t sha1_init[5] = {
+    0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0,
+};
+
+static const uint32_t sha224_init[8] = {
+    0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, 0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4,
+};
+
+static const uint32_t sha256_init[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+static const uint32_t sm3_init[8] = {
+    0x7380166f, 0x4914b2b9, 0x172442d7, 0xda8a0600, 0xa96f30bc, 0x163138aa, 0xe38dee4d, 0xb0fb0e4e,
+};
+
+static const uint64_t sha384_init[8] = {
+    0xcbbb9d5dc1059ed8, 0x629a292a367cd507, 0x9159015a3070dd17, 0x152fecd8f70e5939,
+    0x67332667ffc00b31, 0x8eb44a8768581511, 0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4,
+};
+
+static const uint64_t sha512_init[8] = {
+    0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+    0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179,
+};
+
+static const uint64_t sha512_224_init[8] = {
+    0x8c3d37c819544da2, 0x73e1996689dcd4d6, 0x1dfab7ae32ff9c82, 0x679dd514582f9fcf,
+    0x0f6d2b697bd44da8, 0x77e36f7304c48942, 0x3f9d85a86a1d36c8, 0x1112e6ad91d692a1,
+};
+
+static const uint64_t sha512_256_init[8] = {
+    0x22312194fc2bf72c, 0x9f555fa3c84c64c2, 0x2393b86b6f53b151, 0x963877195940eabd,
+    0x96283ee2a88effe3, 0xbe5e1e2553863992, 0x2b0199fc2c85b8aa, 0x0eb72ddc81c52ca2,
+};
+
+static const uint32_t sha256_k[SHA256_ROUNDS] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint64_t sha512_k[SHA512_ROUNDS] = {
+    0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
+    0x3956c25bf348b538, 0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118,
+    0xd807aa98a3030242, 0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+    0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235, 0xc19bf174cf692694,
+    0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
+    0x2de92c6f592b0275, 0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+    0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f, 0xbf597fc7beef0ee4,
+    0xc6e00bf33da88fc2, 0xd5a79147930aa725, 0x06ca6351e003826f, 0x142929670a0e6e70,
+    0x27b70a8546d22ffc, 0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+    0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6, 0x92722c851482353b,
+    0xa2bfe8a14cf10364, 0xa81a664bbc423001, 0xc24b8b70d0f89791, 0xc76c51a30654be30,
+    0xd192e819d6ef5218, 0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+    0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8,
+    0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb, 0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3,
+    0x748f82ee5defb2fc, 0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+    0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915, 0xc67178f2e372532b,
+    0xca273eceea26619c, 0xd186b8c721c0c207, 0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178,
+    0x06f067aa72176fba, 0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+    0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc, 0x431d67c49c100d4c,
+    0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817,
+};
+
+static const uint64_t keccak_round_constants[KECCAK_ROUNDS] = {
+    0x0000000000000001, 0x0000000000008082, 0x800000000000808a, 0x8000000080008000,
+    0x000000000000808b, 0x0000000080000001, 0x8000000080008081, 0x8000000000008009,
+    0x000000000000008a, 0x0000000000000088, 0x0000000080008009, 0x000000008000000a,
+    0x000000008000808b, 0x800000000000008b, 0x8000000000008089, 0x8000000000008003,
+    0x8000000000008002, 0x8000000000000080, 0x000000000000800a, 0x800000008000000a,
+    0x8000000080008081, 0x8000000000008080, 0x0000000080000001, 0x8000000080008008,
+};
+
+// rotation offsets and destination lanes of rho and pi, in the order of the walk
+static const uint8_t keccak_rotations[KECCAK_LANES - 1] = {
+    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44,
+};
+
+static const uint8_t keccak_lanes[KECCAK_LANES - 1] = {
+    10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1,
+};
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void sha1_compress(uint32_t* state, const uint32_t* words);
+static void sha256_compress(uint32_t* state, const uint32_t* words);
+static void sm3_compress(uint32_t* state, const uint32_t* words);
+static uint32_t rotate_left(uint32_t x, uint32_t n);
+static uint32_t rotate_right(uint32_t x, uint32_t n);
+static uint64_t rotate_right_64(uint64_t x, uint32_t n);
+static uint64_t rotate_left_64(uint64_t x, uint32_t n);
+
+/* Public functions ----------------------------------------------------------*/
+
+void hash_ref_small_init(hash_ref_md_t md, uint32_t* state)
+{
+    switch (md) {
+    case HASH_REF_SHA1:
+        memcpy(state, sha1_init, sizeof(sha1_init));
+        break;
+    case HASH_REF_SHA224:
+        memcpy(state, sha224_init, sizeof(sha224_init));
+        break;
+    case HASH_REF_SM3:
+        memcpy(state, sm3_init, sizeof(sm3_init));
+        break;
+    default:
+        memcpy(state, sha256_init, sizeof(sha256_init));
+        break;
+    }
+}
+
+void hash_ref_small_compress(hash_ref_md_t md, uint32_t* state, const uint8_t* block)
+{
+    uint32_t words[HASH_REF_SMALL_BLOCK_SIZE / 4];
+
+    for (int i = 0; i < HASH_REF_SMALL_BLOCK_SIZE / 4; i++) {
+        const uint8_t* bytes = &block[4 * i];
+        words[i] = (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 8 | bytes[3];
+    }
+
+    if (md == HASH_REF_SHA1) {
+        sha1_compress(state, words);
+    } else if (md == HASH_REF_SM3) {
+        sm3_compress(state, words);
+    } else {
+        sha256_compress(state, words);
+    }
+}
+
+void hash_ref_large_init(hash_ref_md_t md, uint64_t* state)
+{
+    switch (md) {
+    case HASH_REF_SHA384:
+        memcpy(state, sha384_init, sizeof(sha384_init));
+        break;
+    case HASH_REF_SHA512_224:
+        memcpy(state, sha512_224_init, sizeof(sha512_224_init));
+        break;
+    case HASH_REF_SHA512_256:
+        memcpy(state, sha512_256_init, sizeof(sha512_256_init));
+        break;
+    default:
+        memcpy(state, sha512_init, sizeof(sha512_init));
+        break;
+    }
+}
+
+void hash_ref_large_compress(uint64_t* state, const uint8_t* block)
+{
+    uint64_t w[SHA512_ROUNDS];
+    uint64_t v[8];
+
+    for (int i = 0; i < 16; i++) {
+        w[i] = 0;
+        for (int j = 0; j < 8; j++) {
+            w[i] = w[i] << 8 | block[8 * i + j];
+        }
+    }
+    for (int i = 16; i < SHA512_ROUNDS; i++) {
+        uint64_t s0 = rotate_right_64(w[i - 15], 1) ^ rotate_right_64(w[i - 15], 8) ^ w[i - 15] >> 7;
+        uint64_t s1 = rotate_right_64(w[i - 2], 19) ^ rotate_right_64(w[i - 2], 61) ^ w[i - 2] >> 6;
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    memcpy(v, state, sizeof(v));
+    for (int i = 0; i < SHA512_ROUNDS; i++) {
+        uint64_t s1 = rotate_right_64(v[4], 14) ^ rotate_right_64(v[4], 18) ^ rotate_right_64(v[4], 41);
+        uint64_t choice = (v[4] & v[5]) ^ (~v[4] & v[6]);
+        uint64_t t1 = v[7] + s1 + choice + sha512_k[i] + w[i];
+        uint64_t s0 = rotate_right_64(v[0], 28) ^ rotate_right_64(v[0], 34) ^ rotate_right_64(v[0], 39);
+        uint64_t majority = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+
+        memmove(&v[1], &v[0], 7 * sizeof(v[0]));
+        v[4] += t1;
+        v[0] = t1 + s0 + majority;
+    }
+    for (int i = 0; i < 8; i++) {
+        state[i] += v[i];
+    }
+}
+
+void hash_ref_keccak(uint8_t* state)
+{
+    uint64_t lanes[KECCAK_LANES];
+
+    for (int i = 0; i < KECCAK_LANES; i++) {
+        lanes[i] = 0;
+        for (int j = 7; j >= 0; j--) {
+            lanes[i] = lanes[i] << 8 | state[8 * i + j];
+        }
+    }
+
+    for (int round = 0; round < KECCAK_ROUNDS; round++) {
+        uint64_t columns[5];
+
+        // theta
+        for (int x = 0; x < 5; x++) {
+            columns[x] = lanes[x] ^ lanes[x + 5] ^ lanes[x + 10] ^ lanes[x + 15] ^ lanes[x + 20];
+        }
+        for (int x = 0; x < 5; x++) {
+            uint64_t d = columns[(x + 4) % 5] ^ rotate_left_64(columns[(x + 1) % 5], 1);
+            for (int y = 0; y < KECCAK_LANES; y += 5) {
+                lanes[y + x] ^= d;
+            }
+        }
+
+        // rho and pi
+        uint64_t current = lanes[1];
+        for (int i = 0; i < KECCAK_LANES - 1; i++) {
+            uint64_t next = lanes[keccak_lanes[i]];
+            lanes[keccak_lanes[i]] = rotate_left_64(current, keccak_rotations[i]);
+            current = next;
+        }
+
+        // chi
+        for (int y = 0; y < KECCAK_LANES; y += 5) {
+            memcpy(columns, &lanes[y], sizeof(columns));
+            for (int x = 0; x < 5; x++) {
+                lanes[y + x] = columns[x] ^ (~columns[(x + 1) % 5] & columns[(x + 2) % 5]);
+            }
+        }
+
+        // iota
+        lanes[0] ^= keccak_round_constants[round];
+    }
+
+    for (int i = 0; i < KECCAK_LANES; i++) {
+        for (int j = 0; j < 8; j++) {
+            state[8 * i + j] = lanes[i] >> (8 * j);
+        }
+    }
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void sha1_compress(uint32_t* state, const uint32_t* words)
+{
+    uint32_t w[SHA1_ROUNDS];
+    uint32_t v[5];
+
+    memcpy(w, words, 16 * sizeof(w[0]));
+    for (int i = 16; i < SHA1_ROUNDS; i++) {
+        w[i] = rotate_left(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    memcpy(v, state, sizeof(v));
+    for (int i = 0; i < SHA1_ROUNDS; i++) {
+        uint32_t f;
+        uint32_t k;
+
+        if (i < 20) {
+            f = (v[1] & v[2]) | (~v[1] & v[3]);
+            k = 0x5a827999;
+        } else if (i < 40) {
+            f = v[1] ^ v[2] ^ v[3];
+            k = 0x6ed9eba1;
+        } else if (i < 60) {
+            f = (v[1] & v[2]) | (v[1] & v[3]) | (v[2] & v[3]);
+            k = 0x8f1bbcdc;
+        } else {
+            f = v[1] ^ v[2] ^ v[3];
+            k = 0xca62c1d6;
+        }
+
+        uint32_t t = rotate_left(v[0], 5) + f + v[4] + k + w[i];
+        v[4] = v[3];
+        v[3] = v[2];
+        v[2] = rotate_left(v[1], 30);
+        v[1] = v[0];
+        v[0] = t;
+    }
+    for (int i = 0; i < 5; i++) {
+        state[i] += v[i];
+    }
+}
+
+static void sha256_compress(uint32_t* state, const uint32_t* words)
+{
+    uint32_t w[SHA256_ROUNDS];
+    uint32_t v[8];
+
+    memcpy(w, words, 16 * sizeof(w[0]));
+    for (int i = 16; i < SHA256_ROUNDS; i++) {
+        uint32_t s0 = rotate_right(w[i - 15], 7) ^ rotate_right(w[i - 15], 18) ^ w[i - 15] >> 3;
+        uint32_t s1 = rotate_right(w[i - 2], 17) ^ rotate_right(w[i - 2], 19) ^ w[i - 2] >> 10;
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    memcpy(v, state, sizeof(v));
+    for (int i = 0; i < SHA256_ROUNDS; i++) {
+        uint32_t s1 = rotate_right(v[4], 6) ^ rotate_right(v[4], 11) ^ rotate_right(v[4], 25);
+        uint32_t choice = (v[4] & v[5]) ^ (~v[4] & v[6]);
+        uint32_t t1 = v[7] + s1 + choice + sha256_k[i] + w[i];
+        uint32_t s0 = rotate_right(v[0], 2) ^ rotate_right(v[0], 13) ^ rotate_right(v[0], 22);
+        uint32_t majority = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+
+        memmove(&v[1], &v[0], 7 * sizeof(v[0]));
+        v[4] += t1;
+        v[0] = t1 + s0 + majority;
+    }
+    for (int i = 0; i < 8; i++) {
+        state[i] += v[i];
+    }
+}
+
+/**
+ * SM3 (GB/T 32905-2016), the state is A to H
+ */
+static void sm3_compress(uint32_t* state, const uint32_t* words)
+{
+    uint32_t w[SM3_ROUNDS + 4];
+    uint32_t v[8];
+
+    memcpy(w, words, 16 * sizeof(w[0]));
+    for (int i = 16; i < SM3_ROUNDS + 4; i++) {
+        uint32_t x = w[i - 16] ^ w[i - 9] ^ rotate_left(w[i - 3], 15);
+        // P1
+        x ^= rotate_left(x, 15) ^ rotate_left(x, 23);
+        w[i] = x ^ rotate_left(w[i - 13], 7) ^ w[i - 6];
+    }
+
+    memcpy(v, state, sizeof(v));
+    for (int i = 0; i < SM3_ROUNDS; i++) {
+        uint32_t t = i < 16 ? 0x79cc4519 : 0x7a879d8a;
+        uint32_t a12 = rotate_left(v[0], 12);
+        uint32_t ss1 = rotate_left(a12 + v[4] + rotate_left(t, i % 32), 7);
+        uint32_t ss2 = ss1 ^ a12;
+        uint32_t ff;
+        uint32_t gg;
+
+        if (i < 16) {
+            ff = v[0] ^ v[1] ^ v[2];
+            gg = v[4] ^ v[5] ^ v[6];
+        } else {
+            ff = (v[0] & v[1]) | (v[0] & v[2]) | (v[1] & v[2]);
+            gg = (v[4] & v[5]) | (~v[4] & v[6]);
+        }
+
+        uint32_t tt1 = ff + v[3] + ss2 + (w[i] ^ w[i + 4]);
+        uint32_t tt2 = gg + v[7] + ss1 + w[i];
+        v[3] = v[2];
+        v[2] = rotate_left(v[1], 9);
+        v[1] = v[0];
+        v[0] = tt1;
+        v[7] = v[6];
+        v[6] = rotate_left(v[5], 19);
+        v[5] = v[4];
+        // P0
+        v[4] = tt2 ^ rotate_left(tt2, 9) ^ rotate_left(tt2, 17);
+    }
+    for (int i = 0; i < 8; i++) {
+        state[i] ^= v[i];
+    }
+}
+
+static uint32_t rotate_left(uint32_t x, uint32_t n)
+{
+    return x << n | x >> ((32 - n) & 31);
+}
+
+static uint32_t rotate_right(uint32_t x, uint32_t n)
+{
+    return x >> n | x << (32 - n);
+}
+
+static uint64_t rotate_right_64(uint64_t x, uint32_t n)
+{
+    return x >> n | x << (64 - n);
+}
+
+static uint64_t rotate_left_64(uint64_t x, uint32_t n)
+{
+    return x << n | x >> (64 - n);
+}
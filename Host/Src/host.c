@@ -0,0 +1,668 @@
+/**
+ ******************************************************************************
+ * @file    host.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   runtime of the host build: memory map, peripheral models and
+ *          interrupts
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <signal.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "stm32l4xx_hal.h"
+#include "stm32l4xx_it.h"
+
+#include "aes_model.h"
+#include "host.h"
+#include "rng_model.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define PAGE_SIZE 0x1000
+
+#define MAX_PERIPHERALS 8
+
+#define STACK_SIZE (8 * 1024 * 1024)
+
+// x86-64
+#define TRAP_FLAG 0x100
+#define PAGE_FAULT_WRITE 0x2
+
+// exceptions (SysTick is -1) and interrupts of the STM32L443
+#define IRQ_OFFSET 16
+#define IRQ_NUMBER (IRQ_OFFSET + 96)
+
+#define NVIC_ISER_OFFSET 0x100
+#define NVIC_ICER_OFFSET 0x180
+#define NVIC_ISPR_OFFSET 0x200
+#define NVIC_ICPR_OFFSET 0x280
+#define NVIC_IABR_OFFSET 0x300
+#define NVIC_REGISTER_NUMBER 8
+
+#define DWT_CYCCNT_OFFSET 0x004
+
+// delay of the interrupts of the transfers running in the background
+#define BACKGROUND_DELAY_US 1000
+
+#define FORMAT_SIZE 256
+
+// reset values of the CRC unit
+#define CRC_DEFAULT_INIT 0xFFFFFFFF
+#define CRC_DEFAULT_POLYNOMIAL 0x04C11DB7
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct {
+    uint32_t base;
+    uint32_t size;
+} region_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+volatile uint32_t host_primask;
+
+// the memory of the peripherals, the pages of the models are then protected
+static const region_t regions[] = {
+    {PERIPH_BASE, 0x00030000},          // APB1, APB2, AHB1 (DMA, RCC, FLASH, CRC)
+    {AHB2PERIPH_BASE, 0x00002000},      // GPIO
+    {AES_BASE & ~(PAGE_SIZE - 1), PAGE_SIZE}, // AES, RNG
+    {SCS_BASE & 0xFFF00000, 0x00100000},  // ITM, DWT, SCS
+};
+
+static const host_peripheral_t* peripherals[MAX_PERIPHERALS];
+static uint32_t peripheral_number;
+
+// the access between the page fault and the single-step trap
+static volatile bool access_pending;
+static const host_peripheral_t* access_peripheral;
+static uintptr_t access_address;
+static uint32_t access_size;
+static bool access_write;
+
+static volatile uint32_t accesses;
+
+// the handlers are indexed by IRQn + IRQ_OFFSET
+static void (*const vectors[IRQ_NUMBER])(void) = {
+    [SysTick_IRQn + IRQ_OFFSET] = SysTick_Handler,
+    [DMA2_Channel1_IRQn + IRQ_OFFSET] = DMA2_Channel1_IRQHandler,
+    [DMA2_Channel2_IRQn + IRQ_OFFSET] = DMA2_Channel2_IRQHandler,
+    [DMA2_Channel6_IRQn + IRQ_OFFSET] = DMA2_Channel6_IRQHandler,
+    [LPUART1_IRQn + IRQ_OFFSET] = LPUART1_IRQHandler,
+    [AES_IRQn + IRQ_OFFSET] = AES_IRQHandler,
+    [RNG_IRQn + IRQ_OFFSET] = RNG_IRQHandler,
+};
+static volatile bool pending[IRQ_NUMBER];
+static volatile bool pending_later[IRQ_NUMBER];
+static bool in_handler;
+
+// NVIC and SCB, the registers without model are kept as written
+static uint32_t nvic_enabled[NVIC_REGISTER_NUMBER];
+static uint32_t scs_registers[PAGE_SIZE / 4];
+
+static uint32_t dwt_registers[PAGE_SIZE / 4];
+static uint32_t dwt_cycles_offset;
+
+static uint32_t crc_registers[PAGE_SIZE / 4];
+static uint32_t crc_value;
+
+static host_output_t output = NULL;
+static bool output_set;
+
+static ucontext_t caller_context;
+static ucontext_t run_context;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void map_regions(void);
+static void segv_handler(int signal, siginfo_t* info, void* context);
+static void trap_handler(int signal, siginfo_t* info, void* context);
+static void alarm_handler(int signal);
+static const host_peripheral_t* find_peripheral(uintptr_t address);
+static void protect(const host_peripheral_t* peripheral, int protection);
+static uint32_t decode_access_size(const uint8_t* instruction);
+static void crash(const char* message);
+static bool irq_enabled(int32_t index);
+static void store(uint32_t* registers, uint32_t offset, uint32_t value, uint32_t size);
+static uint32_t nvic_read(uint32_t offset);
+static void nvic_write(uint32_t offset, uint32_t value, uint32_t size);
+static uint32_t dwt_read(uint32_t offset);
+static void dwt_write(uint32_t offset, uint32_t value, uint32_t size);
+static uint32_t crc_read(uint32_t offset);
+static void crc_write(uint32_t offset, uint32_t value, uint32_t size);
+static void stdout_output(const uint8_t* data, uint32_t length);
+static const char* convert_format(const char* format, char* converted);
+
+static const host_peripheral_t nvic_peripheral = {
+    .base = SCS_BASE,
+    .size = PAGE_SIZE,
+    .read = nvic_read,
+    .peek = nvic_read,
+    .write = nvic_write,
+};
+
+static const host_peripheral_t dwt_peripheral = {
+    .base = DWT_BASE,
+    .size = PAGE_SIZE,
+    .read = dwt_read,
+    .peek = dwt_read,
+    .write = dwt_write,
+};
+
+static const host_peripheral_t crc_peripheral = {
+    .base = CRC_BASE & ~(PAGE_SIZE - 1),
+    .size = PAGE_SIZE,
+    .read = crc_read,
+    .peek = crc_read,
+    .write = crc_write,
+};
+
+/* Public functions ----------------------------------------------------------*/
+
+void host_init(void)
+{
+    struct sigaction action;
+
+    map_regions();
+
+    memset(&action, 0, sizeof(action));
+    // the handlers are re-entered by the accesses of the interrupt handlers,
+    // the timer is held off during an access
+    action.sa_flags = SA_SIGINFO | SA_NODEFER;
+    sigemptyset(&action.sa_mask);
+    sigaddset(&action.sa_mask, SIGALRM);
+    action.sa_sigaction = segv_handler;
+    sigaction(SIGSEGV, &action, NULL);
+    action.sa_sigaction = trap_handler;
+    sigaction(SIGTRAP, &action, NULL);
+
+    memset(&action, 0, sizeof(action));
+    action.sa_flags = SA_RESTART;
+    action.sa_handler = alarm_handler;
+    sigaction(SIGALRM, &action, NULL);
+
+    host_primask = 0;
+    crc_registers[(CRC_BASE - crc_peripheral.base + offsetof(CRC_TypeDef, INIT)) / 4] = CRC_DEFAULT_INIT;
+    crc_registers[(CRC_BASE - crc_peripheral.base + offsetof(CRC_TypeDef, POL)) / 4] = CRC_DEFAULT_POLYNOMIAL;
+    crc_value = CRC_DEFAULT_INIT;
+
+    host_add_peripheral(&nvic_peripheral);
+    host_add_peripheral(&dwt_peripheral);
+    host_add_peripheral(&crc_peripheral);
+    aes_model_init();
+    rng_model_init();
+}
+
+void host_add_peripheral(const host_peripheral_t* peripheral)
+{
+    if (peripheral_number == MAX_PERIPHERALS) {
+        crash("too many peripheral models\n");
+    }
+    peripherals[peripheral_number++] = peripheral;
+    protect(peripheral, PROT_NONE);
+}
+
+void host_run(void (*function)(void))
+{
+    void* stack = mmap(NULL, STACK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+    if (stack == MAP_FAILED) {
+        crash("no stack below 4 GB\n");
+    }
+
+    getcontext(&run_context);
+    run_context.uc_stack.ss_sp = stack;
+    run_context.uc_stack.ss_size = STACK_SIZE;
+    run_context.uc_link = &caller_context;
+    makecontext(&run_context, function, 0);
+    swapcontext(&caller_context, &run_context);
+
+    munmap(stack, STACK_SIZE);
+}
+
+uint32_t host_get_accesses(void)
+{
+    return accesses;
+}
+
+void host_set_pending(IRQn_Type irq)
+{
+    pending[irq + IRQ_OFFSET] = true;
+}
+
+void host_set_pending_later(IRQn_Type irq)
+{
+    const struct itimerval timer = {.it_value = {.tv_usec = BACKGROUND_DELAY_US}};
+
+    pending_later[irq + IRQ_OFFSET] = true;
+    setitimer(ITIMER_REAL, &timer, NULL);
+}
+
+void host_deliver_irqs(void)
+{
+    if (host_primask != 0 || access_pending) {
+        return;
+    }
+
+    // the handlers run to completion, the lowest IRQn first; in_handler is
+    // exchanged atomically as the timer signal also delivers
+    if (__atomic_exchange_n(&in_handler, true, __ATOMIC_SEQ_CST)) {
+        return;
+    }
+    int32_t index = 0;
+    while (index < IRQ_NUMBER && host_primask == 0) {
+        if (pending[index] && irq_enabled(index)) {
+            pending[index] = false;
+            if (vectors[index] != NULL) {
+                vectors[index]();
+            }
+            index = 0;
+        } else {
+            index++;
+        }
+    }
+    in_handler = false;
+}
+
+void host_set_output(host_output_t function)
+{
+    output = function;
+    output_set = true;
+}
+
+void host_output(const uint8_t* data, uint32_t length)
+{
+    if (!output_set) {
+        stdout_output(data, length);
+    } else if (output != NULL) {
+        output(data, length);
+    }
+}
+
+void host_dma_request(void)
+{
+    for (uint32_t i = 0; i < peripheral_number; i++) {
+        if (peripherals[i]->dma_request != NULL) {
+            peripherals[i]->dma_request();
+        }
+    }
+}
+
+int host_sprintf(char* buffer, const char* format, ...)
+{
+    char converted[FORMAT_SIZE];
+    va_list arguments;
+
+    va_start(arguments, format);
+    int result = vsprintf(buffer, convert_format(format, converted), arguments);
+    va_end(arguments);
+    return result;
+}
+
+int host_snprintf(char* buffer, size_t size, const char* format, ...)
+{
+    char converted[FORMAT_SIZE];
+    va_list arguments;
+
+    va_start(arguments, format);
+    int result = vsnprintf(buffer, size, convert_format(format, converted), arguments);
+    va_end(arguments);
+    return result;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void map_regions(void)
+{
+    for (uint32_t i = 0; i < sizeof(regions) / sizeof(regions[0]); i++) {
+        void* address = (void*)(uintptr_t)regions[i].base;
+        void* memory = mmap(address, regions[i].size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+        if (memory != address) {
+            crash("cannot map the peripherals\n");
+        }
+    }
+}
+
+/**
+ * First step of an access to a model: the page is opened, the value read is
+ * put in the register and the instruction is single-stepped
+ */
+static void segv_handler(int signal, siginfo_t* info, void* context)
+{
+    (void)signal;
+
+    ucontext_t* uc = context;
+    uintptr_t address = (uintptr_t)info->si_addr;
+    const host_peripheral_t* peripheral = find_peripheral(address);
+
+    if (peripheral == NULL || access_pending) {
+        crash("segmentation fault\n");
+    }
+
+    access_pending = true;
+    access_peripheral = peripheral;
+    access_address = address;
+    access_write = (uc->uc_mcontext.gregs[REG_ERR] & PAGE_FAULT_WRITE) != 0;
+    access_size = decode_access_size((const uint8_t*)uc->uc_mcontext.gregs[REG_RIP]);
+
+    protect(peripheral, PROT_READ | PROT_WRITE);
+
+    uint32_t offset = (address - peripheral->base) & ~3U;
+    volatile uint32_t* word = (volatile uint32_t*)(address & ~(uintptr_t)3);
+    *word = access_write ? peripheral->peek(offset) : peripheral->read(offset);
+
+    uc->uc_mcontext.gregs[REG_EFL] |= TRAP_FLAG;
+}
+
+/**
+ * Second step of an access: the value written is given to the model, the
+ * page is closed and the pending interrupts are delivered
+ */
+static void trap_handler(int signal, siginfo_t* info, void* context)
+{
+    (void)signal;
+    (void)info;
+
+    ucontext_t* uc = context;
+    uc->uc_mcontext.gregs[REG_EFL] &= ~TRAP_FLAG;
+
+    if (!access_pending) {
+        return;
+    }
+
+    const host_peripheral_t* peripheral = access_peripheral;
+    if (access_write) {
+        uint32_t value;
+        switch (access_size) {
+        case 1:
+            value = *(volatile uint8_t*)access_address;
+            break;
+        case 2:
+            value = *(volatile uint16_t*)access_address;
+            break;
+        default:
+            value = *(volatile uint32_t*)access_address;
+            break;
+        }
+        peripheral->write(access_address - peripheral->base, value, access_size);
+    }
+    protect(peripheral, PROT_NONE);
+    if (peripheral->timed) {
+        accesses++;
+    }
+    access_pending = false;
+
+    host_deliver_irqs();
+}
+
+/**
+ * End of the transfers running in the background, the interrupts are
+ * delivered now if the CPU is not in a handler or an access
+ */
+static void alarm_handler(int signal)
+{
+    (void)signal;
+
+    for (int32_t i = 0; i < IRQ_NUMBER; i++) {
+        if (pending_later[i]) {
+            pending_later[i] = false;
+            pending[i] = true;
+        }
+    }
+    host_deliver_irqs();
+}
+
+static const host_peripheral_t* find_peripheral(uintptr_t address)
+{
+    for (uint32_t i = 0; i < peripheral_number; i++) {
+        const host_peripheral_t* peripheral = peripherals[i];
+        if (address >= peripheral->base && address < peripheral->base + peripheral->size) {
+            return peripheral;
+        }
+    }
+    return NULL;
+}
+
+static void protect(const host_peripheral_t* peripheral, int protection)
+{
+    uintptr_t start = peripheral->base & ~(uintptr_t)(PAGE_SIZE - 1);
+    uintptr_t end = (peripheral->base + peripheral->size + PAGE_SIZE - 1) & ~(uintptr_t)(PAGE_SIZE - 1);
+
+    if (mprotect((void*)start, end - start, protection) != 0) {
+        crash("cannot protect the registers\n");
+    }
+}
+
+/**
+ * Size of the memory operand of an x86-64 instruction, only the cases of the
+ * compiled C code are handled: byte and 16-bit moves and operations
+ */
+static uint32_t decode_access_size(const uint8_t* instruction)
+{
+    uint32_t size = 4;
+
+    // legacy prefixes then REX
+    while (true) {
+        uint8_t prefix = *instruction;
+        if (prefix == 0x66) {
+            size = 2;
+        } else if (prefix != 0xF0 && prefix != 0xF2 && prefix != 0xF3 && prefix != 0x2E && prefix != 0x36
+                && prefix != 0x3E && prefix != 0x26 && prefix != 0x64 && prefix != 0x65 && prefix != 0x67) {
+            break;
+        }
+        instruction++;
+    }
+    if ((*instruction & 0xF0) == 0x40) {
+        instruction++;
+    }
+
+    uint8_t opcode = instruction[0];
+    if (opcode == 0x0F) {
+        if (instruction[1] == 0xB6 || instruction[1] == 0xBE) {
+            return 1;
+        }
+        if (instruction[1] == 0xB7 || instruction[1] == 0xBF) {
+            return 2;
+        }
+        return size;
+    }
+    // the byte forms of mov, test, xchg and of the ALU operations
+    if (opcode == 0x88 || opcode == 0x8A || opcode == 0xC6 || opcode == 0x80 || opcode == 0x84 || opcode == 0x86
+            || opcode == 0xF6 || opcode == 0xFE || (opcode < 0x40 && (opcode & 0x07) <= 0x02 && (opcode & 0x01) == 0)) {
+        return 1;
+    }
+    return size;
+}
+
+static void crash(const char* message)
+{
+    (void)write(STDERR_FILENO, message, strlen(message));
+    abort();
+}
+
+static bool irq_enabled(int32_t index)
+{
+    int32_t irq = index - IRQ_OFFSET;
+
+    if (irq < 0) {
+        // SysTick is not generated, the other exceptions are always enabled
+        return true;
+    }
+    return (nvic_enabled[irq / 32] & (1U << (irq % 32))) != 0;
+}
+
+/**
+ * Write a register kept as written
+ */
+static void store(uint32_t* registers, uint32_t offset, uint32_t value, uint32_t size)
+{
+    uint8_t* bytes = (uint8_t*)registers + offset;
+
+    for (uint32_t i = 0; i < size; i++) {
+        bytes[i] = value >> (8 * i);
+    }
+}
+
+static uint32_t nvic_read(uint32_t offset)
+{
+    uint32_t index = (offset % 0x80) / 4;
+
+    if (offset >= NVIC_ISER_OFFSET && offset < NVIC_ISPR_OFFSET && index < NVIC_REGISTER_NUMBER) {
+        return nvic_enabled[index];
+    }
+    if (offset >= NVIC_ISPR_OFFSET && offset < NVIC_IABR_OFFSET && index < NVIC_REGISTER_NUMBER) {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < 32 && IRQ_OFFSET + 32 * index + i < IRQ_NUMBER; i++) {
+            if (pending[IRQ_OFFSET + 32 * index + i]) {
+                value |= 1U << i;
+            }
+        }
+        return value;
+    }
+    return scs_registers[offset / 4];
+}
+
+static void nvic_write(uint32_t offset, uint32_t value, uint32_t size)
+{
+    uint32_t index = (offset % 0x80) / 4;
+
+    if (offset >= NVIC_ISER_OFFSET && offset < NVIC_IABR_OFFSET && index < NVIC_REGISTER_NUMBER) {
+        // set and clear registers
+        for (uint32_t i = 0; i < 32; i++) {
+            if ((value & (1U << i)) == 0) {
+                continue;
+            }
+            uint32_t irq = 32 * index + i;
+            if (offset < NVIC_ICER_OFFSET) {
+                nvic_enabled[index] |= 1U << i;
+            } else if (offset < NVIC_ISPR_OFFSET) {
+                nvic_enabled[index] &= ~(1U << i);
+            } else if (IRQ_OFFSET + irq < IRQ_NUMBER) {
+                pending[IRQ_OFFSET + irq] = offset < NVIC_ICPR_OFFSET;
+            }
+        }
+        return;
+    }
+    store(scs_registers, offset, value, size);
+}
+
+static uint32_t dwt_read(uint32_t offset)
+{
+    if (offset == DWT_CYCCNT_OFFSET) {
+        return accesses - dwt_cycles_offset;
+    }
+    return dwt_registers[offset / 4];
+}
+
+static void dwt_write(uint32_t offset, uint32_t value, uint32_t size)
+{
+    if (offset == DWT_CYCCNT_OFFSET) {
+        dwt_cycles_offset = accesses - value;
+        return;
+    }
+    store(dwt_registers, offset, value, size);
+}
+
+/**
+ * The CRC unit with 32-bit polynomials, the input reversal by byte or by
+ * word and the output reversal (the configuration used by report.c)
+ */
+static uint32_t crc_read(uint32_t offset)
+{
+    uint32_t base_offset = CRC_BASE - crc_peripheral.base;
+
+    if (offset == base_offset + offsetof(CRC_TypeDef, DR)) {
+        uint32_t cr = crc_registers[(base_offset + offsetof(CRC_TypeDef, CR)) / 4];
+        return (cr & CRC_CR_REV_OUT) ? __RBIT(crc_value) : crc_value;
+    }
+    return crc_registers[offset / 4];
+}
+
+static void crc_write(uint32_t offset, uint32_t value, uint32_t size)
+{
+    uint32_t base_offset = CRC_BASE - crc_peripheral.base;
+    uint32_t* cr = &crc_registers[(base_offset + offsetof(CRC_TypeDef, CR)) / 4];
+    uint32_t polynomial = crc_registers[(base_offset + offsetof(CRC_TypeDef, POL)) / 4];
+
+    if (offset == base_offset + offsetof(CRC_TypeDef, CR)) {
+        store(crc_registers, offset, value, size);
+        if (*cr & CRC_CR_RESET) {
+            crc_value = crc_registers[(base_offset + offsetof(CRC_TypeDef, INIT)) / 4];
+            *cr &= ~CRC_CR_RESET;
+        }
+        return;
+    }
+    if (offset != base_offset + offsetof(CRC_TypeDef, DR)) {
+        store(crc_registers, offset, value, size);
+        return;
+    }
+
+    // the bytes are processed from the most significant one of the access
+    uint32_t bits = 8 * size;
+    uint32_t reversal = *cr & CRC_CR_REV_IN;
+    if (reversal == CRC_CR_REV_IN_0) {
+        // by byte
+        uint32_t reversed = 0;
+        for (uint32_t i = 0; i < size; i++) {
+            reversed |= (__RBIT((value >> (8 * i)) & 0xFF) >> 24) << (8 * i);
+        }
+        value = reversed;
+    } else if (reversal != 0) {
+        // by half-word or word, handled as a word
+        value = __RBIT(value) >> (32 - bits);
+    }
+
+    crc_value ^= bits == 32 ? value : value << (32 - bits);
+    for (uint32_t i = 0; i < bits; i++) {
+        crc_value = (crc_value & 0x80000000) ? (crc_value << 1) ^ polynomial : crc_value << 1;
+    }
+}
+
+static void stdout_output(const uint8_t* data, uint32_t length)
+{
+    fwrite(data, 1, length, stdout);
+}
+
+/**
+ * Remove the l of the %lu, %ld, %li and %lx conversions (32-bit arguments)
+ * @return the converted format, or the format if it is too long
+ */
+static const char* convert_format(const char* format, char* converted)
+{
+    uint32_t index = 0;
+
+    for (const char* c = format; *c != '\0'; c++) {
+        if (index == FORMAT_SIZE - 1) {
+            return format;
+        }
+        if (*c == 'l' && c != format && c[1] != 'l' && c[-1] != 'l' && strchr("udix", c[1]) != NULL) {
+            // only in a conversion: after % and its flags, width and precision
+            const char* start = c - 1;
+            while (start > format && strchr("0123456789.-+ #", *start) != NULL) {
+                start--;
+            }
+            if (*start == '%') {
+                continue;
+            }
+        }
+        converted[index++] = *c;
+    }
+    converted[index] = '\0';
+    return converted;
+}
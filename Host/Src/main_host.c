@@ -0,0 +1,42 @@
+/**
+ ******************************************************************************
+ * @file    main_host.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   entry point of the benchmark in the host build
+ *
+ * main.c is compiled with main renamed firmware_main and BENCH_LOOPS set to
+ * 1: the benchmark runs once on the models and the results are printed.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "host.h"
+
+/* Private function prototypes -----------------------------------------------*/
+
+int firmware_main(void);
+
+static void run(void);
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    host_init();
+    host_run(run);
+    return 0;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void run(void)
+{
+    firmware_main();
+}
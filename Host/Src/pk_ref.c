@@ -0,0 +1,869 @@
+/**
+ ******************************************************************************
+ * @file    pk_ref.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   portable reference arithmetic of RSA and ECC for the host build
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "pk_ref.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define WORD_BITS 32
+#define X25519_A24 121665
+#define X25519_BITS 255
+
+/* Private macro -------------------------------------------------------------*/
+
+// temporary i of a curve
+#define T(i) (&ec->t[(i) * words])
+
+/* Private variables ---------------------------------------------------------*/
+
+static const uint32_t p256_p[8] = {
+    0xffffffff, 0xffffffff, 0xffffffff, 0x00000000,
+    0x00000000, 0x00000000, 0x00000001, 0xffffffff,
+};
+static const uint32_t p256_b[8] = {
+    0x27d2604b, 0x3bce3c3e, 0xcc53b0f6, 0x651d06b0,
+    0x769886bc, 0xb3ebbd55, 0xaa3a93e7, 0x5ac635d8,
+};
+static const uint32_t p256_n[8] = {
+    0xfc632551, 0xf3b9cac2, 0xa7179e84, 0xbce6faad,
+    0xffffffff, 0xffffffff, 0x00000000, 0xffffffff,
+};
+static const uint32_t p256_gx[8] = {
+    0xd898c296, 0xf4a13945, 0x2deb33a0, 0x77037d81,
+    0x63a440f2, 0xf8bce6e5, 0xe12c4247, 0x6b17d1f2,
+};
+static const uint32_t p256_gy[8] = {
+    0x37bf51f5, 0xcbb64068, 0x6b315ece, 0x2bce3357,
+    0x7c0f9e16, 0x8ee7eb4a, 0xfe1a7f9b, 0x4fe342e2,
+};
+static const uint32_t p256_p_minus_2[8] = {
+    0xfffffffd, 0xffffffff, 0xffffffff, 0x00000000,
+    0x00000000, 0x00000000, 0x00000001, 0xffffffff,
+};
+static const uint32_t p256_n_minus_2[8] = {
+    0xfc63254f, 0xf3b9cac2, 0xa7179e84, 0xbce6faad,
+    0xffffffff, 0xffffffff, 0x00000000, 0xffffffff,
+};
+static const uint32_t p384_p[12] = {
+    0xffffffff, 0x00000000, 0x00000000, 0xffffffff,
+    0xfffffffe, 0xffffffff, 0xffffffff, 0xffffffff,
+    0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+};
+static const uint32_t p384_b[12] = {
+    0xd3ec2aef, 0x2a85c8ed, 0x8a2ed19d, 0xc656398d,
+    0x5013875a, 0x0314088f, 0xfe814112, 0x181d9c6e,
+    0xe3f82d19, 0x988e056b, 0xe23ee7e4, 0xb3312fa7,
+};
+static const uint32_t p384_n[12] = {
+    0xccc52973, 0xecec196a, 0x48b0a77a, 0x581a0db2,
+    0xf4372ddf, 0xc7634d81, 0xffffffff, 0xffffffff,
+    0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+};
+static const uint32_t p384_gx[12] = {
+    0x72760ab7, 0x3a545e38, 0xbf55296c, 0x5502f25d,
+    0x82542a38, 0x59f741e0, 0x8ba79b98, 0x6e1d3b62,
+    0xf320ad74, 0x8eb1c71e, 0xbe8b0537, 0xaa87ca22,
+};
+static const uint32_t p384_gy[12] = {
+    0x90ea0e5f, 0x7a431d7c, 0x1d7e819d, 0x0a60b1ce,
+    0xb5f0b8c0, 0xe9da3113, 0x289a147c, 0xf8f41dbd,
+    0x9292dc29, 0x5d9e98bf, 0x96262c6f, 0x3617de4a,
+};
+static const uint32_t p384_p_minus_2[12] = {
+    0xfffffffd, 0x00000000, 0x00000000, 0xffffffff,
+    0xfffffffe, 0xffffffff, 0xffffffff, 0xffffffff,
+    0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+};
+static const uint32_t p384_n_minus_2[12] = {
+    0xccc52971, 0xecec196a, 0x48b0a77a, 0x581a0db2,
+    0xf4372ddf, 0xc7634d81, 0xffffffff, 0xffffffff,
+    0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+};
+static const uint32_t ed25519_p[8] = {
+    0xffffffed, 0xffffffff, 0xffffffff, 0xffffffff,
+    0xffffffff, 0xffffffff, 0xffffffff, 0x7fffffff,
+};
+static const uint32_t ed25519_b[8] = {
+    0x135978a3, 0x75eb4dca, 0x4141d8ab, 0x00700a4d,
+    0x7779e898, 0x8cc74079, 0x2b6ffe73, 0x52036cee,
+};
+static const uint32_t ed25519_n[8] = {
+    0x5cf5d3ed, 0x5812631a, 0xa2f79cd6, 0x14def9de,
+    0x00000000, 0x00000000, 0x00000000, 0x10000000,
+};
+static const uint32_t ed25519_gx[8] = {
+    0x8f25d51a, 0xc9562d60, 0x9525a7b2, 0x692cc760,
+    0xfdd6dc5c, 0xc0a4e231, 0xcd6e53fe, 0x216936d3,
+};
+static const uint32_t ed25519_gy[8] = {
+    0x66666658, 0x66666666, 0x66666666, 0x66666666,
+    0x66666666, 0x66666666, 0x66666666, 0x66666666,
+};
+static const uint32_t ed25519_p_minus_2[8] = {
+    0xffffffeb, 0xffffffff, 0xffffffff, 0xffffffff,
+    0xffffffff, 0xffffffff, 0xffffffff, 0x7fffffff,
+};
+static const uint32_t ed25519_n_minus_2[8] = {
+    0x5cf5d3eb, 0x5812631a, 0xa2f79cd6, 0x14def9de,
+    0x00000000, 0x00000000, 0x00000000, 0x10000000,
+};
+static const uint32_t ed25519_sqrt_m1[8] = {
+    0x4a0ea0b0, 0xc4ee1b27, 0xad2fe478, 0x2f431806,
+    0x3dfbd7a7, 0x2b4d0099, 0x4fc1df0b, 0x2b832480,
+};
+static const uint32_t ed25519_sqrt_exponent[8] = {
+    0xfffffffd, 0xffffffff, 0xffffffff, 0xffffffff,
+    0xffffffff, 0xffffffff, 0xffffffff, 0x0fffffff,
+};
+
+/* Public variables ----------------------------------------------------------*/
+
+const pk_ref_curve_t pk_ref_p256 = {
+    .type = PK_REF_WEIERSTRASS,
+    .words = 8,
+    .bits = 256,
+    .p = p256_p,
+    .p_minus_2 = p256_p_minus_2,
+    .n = p256_n,
+    .n_minus_2 = p256_n_minus_2,
+    .b = p256_b,
+    .gx = p256_gx,
+    .gy = p256_gy,
+};
+
+const pk_ref_curve_t pk_ref_p384 = {
+    .type = PK_REF_WEIERSTRASS,
+    .words = 12,
+    .bits = 384,
+    .p = p384_p,
+    .p_minus_2 = p384_p_minus_2,
+    .n = p384_n,
+    .n_minus_2 = p384_n_minus_2,
+    .b = p384_b,
+    .gx = p384_gx,
+    .gy = p384_gy,
+};
+
+const pk_ref_curve_t pk_ref_ed25519 = {
+    .type = PK_REF_EDWARDS,
+    .words = 8,
+    .bits = 255,
+    .p = ed25519_p,
+    .p_minus_2 = ed25519_p_minus_2,
+    .n = ed25519_n,
+    .n_minus_2 = ed25519_n_minus_2,
+    .b = ed25519_b,
+    .gx = ed25519_gx,
+    .gy = ed25519_gy,
+    .sqrt_m1 = ed25519_sqrt_m1,
+    .sqrt_exponent = ed25519_sqrt_exponent,
+};
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint32_t subtract(uint32_t* r, const uint32_t* a, const uint32_t* b, uint32_t words);
+static uint32_t get_bits(const uint32_t* x, uint32_t words, uint32_t start, uint32_t count);
+static void set_word(uint32_t* x, uint32_t words, uint32_t value);
+static void weierstrass_add(const pk_ref_ec_t* ec, uint32_t* r, const uint32_t* p, const uint32_t* q);
+static void weierstrass_double(const pk_ref_ec_t* ec, uint32_t* r, const uint32_t* p);
+static void edwards_add(const pk_ref_ec_t* ec, uint32_t* r, const uint32_t* p, const uint32_t* q);
+static void inverse(const pk_ref_ec_t* ec, uint32_t* r, const uint32_t* a);
+static void conditional_swap(uint32_t* x, uint32_t* y, uint32_t words, uint32_t swap);
+
+/* Public functions ----------------------------------------------------------*/
+
+void pk_ref_from_bytes(uint32_t* x, uint32_t words, const uint8_t* bytes, uint32_t length)
+{
+    memset(x, 0, words * sizeof(uint32_t));
+    for (uint32_t i = 0; i < length && i < 4 * words; i++) {
+        x[i / 4] |= (uint32_t)bytes[length - 1 - i] << (8 * (i % 4));
+    }
+}
+
+void pk_ref_to_bytes(uint8_t* bytes, uint32_t length, const uint32_t* x, uint32_t words)
+{
+    for (uint32_t i = 0; i < length; i++) {
+        bytes[length - 1 - i] = i < 4 * words ? x[i / 4] >> (8 * (i % 4)) : 0;
+    }
+}
+
+int pk_ref_compare(const uint32_t* x, const uint32_t* y, uint32_t words)
+{
+    for (uint32_t i = words; i-- > 0;) {
+        if (x[i] != y[i]) {
+            return x[i] > y[i] ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+bool pk_ref_is_zero(const uint32_t* x, uint32_t words)
+{
+    uint32_t bits = 0;
+    for (uint32_t i = 0; i < words; i++) {
+        bits |= x[i];
+    }
+    return bits == 0;
+}
+
+uint32_t pk_ref_add(uint32_t* r, const uint32_t* a, const uint32_t* b, uint32_t words)
+{
+    uint64_t carry = 0;
+    for (uint32_t i = 0; i < words; i++) {
+        carry += (uint64_t)a[i] + b[i];
+        r[i] = carry;
+        carry >>= WORD_BITS;
+    }
+    return carry;
+}
+
+void pk_ref_multiply(uint32_t* r, const uint32_t* a, uint32_t a_words, const uint32_t* b, uint32_t b_words)
+{
+    memset(r, 0, (a_words + b_words) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < b_words; i++) {
+        uint64_t carry = 0;
+        for (uint32_t j = 0; j < a_words; j++) {
+            carry += (uint64_t)a[j] * b[i] + r[i + j];
+            r[i + j] = carry;
+            carry >>= WORD_BITS;
+        }
+        r[i + a_words] = carry;
+    }
+}
+
+void pk_ref_mod_init(pk_ref_mod_t* mod, const uint32_t* modulus, uint32_t words, uint32_t* workspace)
+{
+    mod->modulus = modulus;
+    mod->words = words;
+    mod->one = workspace;
+    mod->r2 = workspace + words;
+    mod->product = workspace + 2 * words;
+
+    // Newton iterations, each doubles the correct low bits of the inverse
+    uint32_t inverse = 1;
+    for (int i = 0; i < 5; i++) {
+        inverse *= 2 - modulus[0] * inverse;
+    }
+    mod->inverse = -inverse;
+
+    // R and R^2 by doublings of 1
+    set_word(mod->one, words, 1);
+    for (uint32_t i = 0; i < WORD_BITS * words; i++) {
+        pk_ref_mod_add(mod, mod->one, mod->one, mod->one);
+    }
+    memcpy(mod->r2, mod->one, words * sizeof(uint32_t));
+    for (uint32_t i = 0; i < WORD_BITS * words; i++) {
+        pk_ref_mod_add(mod, mod->r2, mod->r2, mod->r2);
+    }
+}
+
+void pk_ref_mod_reduce(const pk_ref_mod_t* mod, uint32_t* r, const uint32_t* x, uint32_t x_words)
+{
+    uint32_t words = mod->words;
+
+    // bit by bit from the most significant one, r < modulus at every step
+    memset(r, 0, words * sizeof(uint32_t));
+    for (uint32_t i = WORD_BITS * x_words; i-- > 0;) {
+        uint32_t carry = (x[i / WORD_BITS] >> (i % WORD_BITS)) & 1;
+        for (uint32_t j = 0; j < words; j++) {
+            uint32_t next = r[j] >> (WORD_BITS - 1);
+            r[j] = (r[j] << 1) | carry;
+            carry = next;
+        }
+        if (carry || pk_ref_compare(r, mod->modulus, words) >= 0) {
+            subtract(r, r, mod->modulus, words);
+        }
+    }
+}
+
+void pk_ref_mod_add(const pk_ref_mod_t* mod, uint32_t* r, const uint32_t* a, const uint32_t* b)
+{
+    uint32_t carry = pk_ref_add(r, a, b, mod->words);
+    if (carry || pk_ref_compare(r, mod->modulus, mod->words) >= 0) {
+        subtract(r, r, mod->modulus, mod->words);
+    }
+}
+
+void pk_ref_mod_sub(const pk_ref_mod_t* mod, uint32_t* r, const uint32_t* a, const uint32_t* b)
+{
+    if (subtract(r, a, b, mod->words)) {
+        pk_ref_add(r, r, mod->modulus, mod->words);
+    }
+}
+
+void pk_ref_mod_mul(const pk_ref_mod_t* mod, uint32_t* r, const uint32_t* a, const uint32_t* b)
+{
+    uint32_t words = mod->words;
+    const uint32_t* m = mod->modulus;
+    uint32_t* t = mod->product;
+
+    // CIOS, a word of b then a word of reduction at a time
+    memset(t, 0, (words + 2) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < words; i++) {
+        uint64_t carry = 0;
+        for (uint32_t j = 0; j < words; j++) {
+            carry += (uint64_t)a[j] * b[i] + t[j];
+            t[j] = carry;
+            carry >>= WORD_BITS;
+        }
+        carry += t[words];
+        t[words] = carry;
+        t[words + 1] = carry >> WORD_BITS;
+
+        uint32_t q = t[0] * mod->inverse;
+        carry = ((uint64_t)q * m[0] + t[0]) >> WORD_BITS;
+        for (uint32_t j = 1; j < words; j++) {
+            carry += (uint64_t)q * m[j] + t[j];
+            t[j - 1] = carry;
+            carry >>= WORD_BITS;
+        }
+        carry += t[words];
+        t[words - 1] = carry;
+        t[words] = t[words + 1] + (carry >> WORD_BITS);
+    }
+
+    if (t[words] || pk_ref_compare(t, m, words) >= 0) {
+        subtract(t, t, m, words);
+    }
+    memcpy(r, t, words * sizeof(uint32_t));
+}
+
+void pk_ref_mod_to_mont(const pk_ref_mod_t* mod, uint32_t* r, const uint32_t* a)
+{
+    pk_ref_mod_mul(mod, r, a, mod->r2);
+}
+
+void pk_ref_mod_from_mont(const pk_ref_mod_t* mod, uint32_t* r, const uint32_t* a)
+{
+    // the Montgomery product by 1
+    uint32_t words = mod->words;
+    uint32_t one[PK_REF_MAX_WORDS];
+
+    set_word(one, words, 1);
+    pk_ref_mod_mul(mod, r, a, one);
+}
+
+void pk_ref_mod_exp(const pk_ref_mod_t* mod, uint32_t* r, const uint32_t* a, const uint32_t* exponent,
+        uint32_t exponent_words, uint32_t window, uint32_t* table)
+{
+    uint32_t words = mod->words;
+    uint32_t entries = 1 << window;
+
+    memcpy(table, mod->one, words * sizeof(uint32_t));
+    for (uint32_t i = 1; i < entries; i++) {
+        pk_ref_mod_mul(mod, &table[i * words], &table[(i - 1) * words], a);
+    }
+
+    memcpy(r, mod->one, words * sizeof(uint32_t));
+    uint32_t digits = (WORD_BITS * exponent_words + window - 1) / window;
+    for (uint32_t i = digits; i-- > 0;) {
+        for (uint32_t j = 0; j < window; j++) {
+            pk_ref_mod_mul(mod, r, r, r);
+        }
+        uint32_t digit = get_bits(exponent, exponent_words, i * window, window);
+        pk_ref_mod_mul(mod, r, r, &table[digit * words]);
+    }
+}
+
+void pk_ref_ec_init(pk_ref_ec_t* ec, const pk_ref_curve_t* curve, uint32_t* workspace)
+{
+    uint32_t words = curve->words;
+
+    ec->curve = curve;
+    pk_ref_mod_init(&ec->field, curve->p, words, workspace);
+    ec->b = workspace + PK_REF_MOD_WORDS(words);
+    ec->t = ec->b + words;
+    pk_ref_mod_to_mont(&ec->field, ec->b, curve->b);
+}
+
+uint32_t pk_ref_ec_point_words(const pk_ref_ec_t* ec)
+{
+    return (ec->curve->type == PK_REF_EDWARDS ? 4 : 3) * ec->curve->words;
+}
+
+bool pk_ref_ec_on_curve(const pk_ref_ec_t* ec, const uint32_t* x, const uint32_t* y)
+{
+    const pk_ref_mod_t* f = &ec->field;
+    uint32_t words = ec->curve->words;
+
+    if (pk_ref_compare(x, f->modulus, words) >= 0 || pk_ref_compare(y, f->modulus, words) >= 0) {
+        return false;
+    }
+
+    pk_ref_mod_to_mont(f, T(0), x);
+    pk_ref_mod_to_mont(f, T(1), y);
+    pk_ref_mod_mul(f, T(2), T(0), T(0));
+    pk_ref_mod_mul(f, T(3), T(1), T(1));
+    if (ec->curve->type == PK_REF_EDWARDS) {
+        // -x^2 + y^2 = 1 + d x^2 y^2
+        pk_ref_mod_sub(f, T(4), T(3), T(2));
+        pk_ref_mod_mul(f, T(5), T(2), T(3));
+        pk_ref_mod_mul(f, T(5), T(5), ec->b);
+        pk_ref_mod_add(f, T(5), T(5), f->one);
+        return pk_ref_compare(T(4), T(5), words) == 0;
+    }
+    // y^2 = x^3 - 3 x + b
+    pk_ref_mod_mul(f, T(2), T(2), T(0));
+    pk_ref_mod_add(f, T(4), T(0), T(0));
+    pk_ref_mod_add(f, T(4), T(4), T(0));
+    pk_ref_mod_sub(f, T(2), T(2), T(4));
+    pk_ref_mod_add(f, T(2), T(2), ec->b);
+    return pk_ref_compare(T(2), T(3), words) == 0;
+}
+
+void pk_ref_ec_from_affine(const pk_ref_ec_t* ec, uint32_t* point, const uint32_t* x, const uint32_t* y)
+{
+    const pk_ref_mod_t* f = &ec->field;
+    uint32_t words = ec->curve->words;
+
+    pk_ref_mod_to_mont(f, &point[0], x);
+    pk_ref_mod_to_mont(f, &point[words], y);
+    memcpy(&point[2 * words], f->one, words * sizeof(uint32_t));
+    if (ec->curve->type == PK_REF_EDWARDS) {
+        pk_ref_mod_mul(f, &point[3 * words], &point[0], &point[words]);
+    }
+}
+
+bool pk_ref_ec_to_affine(const pk_ref_ec_t* ec, uint32_t* x, uint32_t* y, const uint32_t* point)
+{
+    const pk_ref_mod_t* f = &ec->field;
+    uint32_t words = ec->curve->words;
+
+    if (pk_ref_is_zero(&point[2 * words], words)) {
+        return false;
+    }
+
+    inverse(ec, T(0), &point[2 * words]);
+    if (ec->curve->type == PK_REF_EDWARDS) {
+        pk_ref_mod_mul(f, T(1), &point[0], T(0));
+        pk_ref_mod_mul(f, T(2), &point[words], T(0));
+    } else {
+        pk_ref_mod_mul(f, T(3), T(0), T(0));
+        pk_ref_mod_mul(f, T(1), &point[0], T(3));
+        pk_ref_mod_mul(f, T(3), T(3), T(0));
+        pk_ref_mod_mul(f, T(2), &point[words], T(3));
+    }
+    pk_ref_mod_from_mont(f, x, T(1));
+    pk_ref_mod_from_mont(f, y, T(2));
+    return true;
+}
+
+void pk_ref_ec_infinity(const pk_ref_ec_t* ec, uint32_t* point)
+{
+    uint32_t words = ec->curve->words;
+
+    // (1, 1, 0) for Weierstrass, (0, 1, 1, 0) for Edwards
+    memset(point, 0, pk_ref_ec_point_words(ec) * sizeof(uint32_t));
+    memcpy(&point[words], ec->field.one, words * sizeof(uint32_t));
+    if (ec->curve->type == PK_REF_EDWARDS) {
+        memcpy(&point[2 * words], ec->field.one, words * sizeof(uint32_t));
+    } else {
+        memcpy(&point[0], ec->field.one, words * sizeof(uint32_t));
+    }
+}
+
+void pk_ref_ec_add(const pk_ref_ec_t* ec, uint32_t* r, const uint32_t* p, const uint32_t* q)
+{
+    if (ec->curve->type == PK_REF_EDWARDS) {
+        edwards_add(ec, r, p, q);
+    } else {
+        weierstrass_add(ec, r, p, q);
+    }
+}
+
+void pk_ref_ec_negate(const pk_ref_ec_t* ec, uint32_t* r, const uint32_t* p)
+{
+    const pk_ref_mod_t* f = &ec->field;
+    uint32_t words = ec->curve->words;
+
+    memcpy(r, p, pk_ref_ec_point_words(ec) * sizeof(uint32_t));
+    memset(T(0), 0, words * sizeof(uint32_t));
+    if (ec->curve->type == PK_REF_EDWARDS) {
+        pk_ref_mod_sub(f, &r[0], T(0), &p[0]);
+        pk_ref_mod_sub(f, &r[3 * words], T(0), &p[3 * words]);
+    } else {
+        pk_ref_mod_sub(f, &r[words], T(0), &p[words]);
+    }
+}
+
+void pk_ref_ec_mul(const pk_ref_ec_t* ec, uint32_t* r, const uint32_t* p, const uint32_t* scalar, uint32_t window,
+        uint32_t* table)
+{
+    uint32_t words = ec->curve->words;
+    uint32_t point_words = pk_ref_ec_point_words(ec);
+    uint32_t entries = 1 << window;
+
+    // the table first, r can be p
+    pk_ref_ec_infinity(ec, table);
+    memcpy(&table[point_words], p, point_words * sizeof(uint32_t));
+    for (uint32_t i = 2; i < entries; i++) {
+        pk_ref_ec_add(ec, &table[i * point_words], &table[(i - 1) * point_words], p);
+    }
+
+    pk_ref_ec_infinity(ec, r);
+    uint32_t digits = (WORD_BITS * words + window - 1) / window;
+    for (uint32_t i = digits; i-- > 0;) {
+        for (uint32_t j = 0; j < window; j++) {
+            pk_ref_ec_add(ec, r, r, r);
+        }
+        uint32_t digit = get_bits(scalar, words, i * window, window);
+        pk_ref_ec_add(ec, r, r, &table[digit * point_words]);
+    }
+}
+
+void pk_ref_ec_encode(const pk_ref_ec_t* ec, uint8_t* encoding, const uint32_t* point)
+{
+    uint32_t words = ec->curve->words;
+    uint32_t x[PK_REF_MAX_WORDS];
+    uint32_t y[PK_REF_MAX_WORDS];
+
+    pk_ref_ec_to_affine(ec, x, y, point);
+    for (uint32_t i = 0; i < 4 * words; i++) {
+        encoding[i] = y[i / 4] >> (8 * (i % 4));
+    }
+    encoding[4 * words - 1] |= (x[0] & 1) << 7;
+}
+
+bool pk_ref_ec_decode(const pk_ref_ec_t* ec, uint32_t* point, const uint8_t* encoding)
+{
+    const pk_ref_mod_t* f = &ec->field;
+    uint32_t words = ec->curve->words;
+    uint32_t size = 4 * words;
+    uint32_t sign = encoding[size - 1] >> 7;
+
+    // y, little-endian, without the sign of x
+    memset(T(0), 0, words * sizeof(uint32_t));
+    for (uint32_t i = 0; i < size; i++) {
+        T(0)[i / 4] |= (uint32_t)encoding[i] << (8 * (i % 4));
+    }
+    T(0)[words - 1] &= 0x7FFFFFFF;
+    if (pk_ref_compare(T(0), f->modulus, words) >= 0) {
+        return false;
+    }
+
+    // x = u v^3 (u v^7)^((p - 5) / 8) with u = y^2 - 1, v = d y^2 + 1
+    pk_ref_mod_to_mont(f, T(1), T(0));
+    pk_ref_mod_mul(f, T(1), T(1), T(1));
+    pk_ref_mod_sub(f, T(2), T(1), f->one);
+    pk_ref_mod_mul(f, T(3), T(1), ec->b);
+    pk_ref_mod_add(f, T(3), T(3), f->one);
+    pk_ref_mod_mul(f, T(4), T(3), T(3));
+    pk_ref_mod_mul(f, T(4), T(4), T(3));
+    pk_ref_mod_mul(f, T(5), T(4), T(4));
+    pk_ref_mod_mul(f, T(5), T(5), T(3));
+    pk_ref_mod_mul(f, T(5), T(5), T(2));
+    pk_ref_mod_exp(f, T(6), T(5), ec->curve->sqrt_exponent, words, 1, T(12));
+    pk_ref_mod_mul(f, T(7), T(2), T(4));
+    pk_ref_mod_mul(f, T(7), T(7), T(6));
+
+    // v x^2 is u or -u, then x is multiplied by the square root of -1
+    pk_ref_mod_mul(f, T(8), T(7), T(7));
+    pk_ref_mod_mul(f, T(8), T(8), T(3));
+    if (pk_ref_compare(T(8), T(2), words) != 0) {
+        memset(T(9), 0, words * sizeof(uint32_t));
+        pk_ref_mod_sub(f, T(9), T(9), T(2));
+        if (pk_ref_compare(T(8), T(9), words) != 0) {
+            return false;
+        }
+        pk_ref_mod_to_mont(f, T(9), ec->curve->sqrt_m1);
+        pk_ref_mod_mul(f, T(7), T(7), T(9));
+    }
+
+    pk_ref_mod_from_mont(f, T(1), T(7));
+    if (pk_ref_is_zero(T(1), words) && sign) {
+        return false;
+    }
+    if ((T(1)[0] & 1) != sign) {
+        subtract(T(1), f->modulus, T(1), words);
+    }
+    memcpy(T(2), T(0), words * sizeof(uint32_t));
+    pk_ref_ec_from_affine(ec, point, T(1), T(2));
+    return true;
+}
+
+void pk_ref_x25519(const pk_ref_ec_t* ec, uint8_t* output, const uint8_t* scalar, const uint8_t* u)
+{
+    const pk_ref_mod_t* f = &ec->field;
+    uint32_t words = ec->curve->words;
+    uint32_t k[PK_REF_MAX_WORDS];
+    uint32_t* x1 = T(0);
+    uint32_t* x2 = T(1);
+    uint32_t* z2 = T(2);
+    uint32_t* x3 = T(3);
+    uint32_t* z3 = T(4);
+
+    // clamped scalar and u without its top bit, little-endian
+    memset(k, 0, words * sizeof(uint32_t));
+    memset(T(5), 0, words * sizeof(uint32_t));
+    for (uint32_t i = 0; i < 4 * words; i++) {
+        k[i / 4] |= (uint32_t)scalar[i] << (8 * (i % 4));
+        T(5)[i / 4] |= (uint32_t)u[i] << (8 * (i % 4));
+    }
+    k[0] &= ~7u;
+    k[words - 1] = (k[words - 1] & 0x7FFFFFFF) | 0x40000000;
+    T(5)[words - 1] &= 0x7FFFFFFF;
+    if (pk_ref_compare(T(5), f->modulus, words) >= 0) {
+        subtract(T(5), T(5), f->modulus, words);
+    }
+
+    pk_ref_mod_to_mont(f, x1, T(5));
+    memcpy(x2, f->one, words * sizeof(uint32_t));
+    memset(z2, 0, words * sizeof(uint32_t));
+    memcpy(x3, x1, words * sizeof(uint32_t));
+    memcpy(z3, f->one, words * sizeof(uint32_t));
+    set_word(T(11), words, X25519_A24);
+    pk_ref_mod_to_mont(f, T(11), T(11));
+
+    // Montgomery ladder, the points swapped as the bits of the scalar change
+    uint32_t swap = 0;
+    for (uint32_t i = X25519_BITS; i-- > 0;) {
+        uint32_t bit = get_bits(k, words, i, 1);
+        swap ^= bit;
+        conditional_swap(x2, x3, words, swap);
+        conditional_swap(z2, z3, words, swap);
+        swap = bit;
+
+        pk_ref_mod_add(f, T(5), x2, z2);
+        pk_ref_mod_sub(f, T(6), x2, z2);
+        pk_ref_mod_add(f, T(7), x3, z3);
+        pk_ref_mod_sub(f, T(8), x3, z3);
+        pk_ref_mod_mul(f, T(9), T(8), T(5));
+        pk_ref_mod_mul(f, T(10), T(7), T(6));
+        pk_ref_mod_mul(f, T(5), T(5), T(5));
+        pk_ref_mod_mul(f, T(6), T(6), T(6));
+        pk_ref_mod_sub(f, T(7), T(5), T(6));
+        pk_ref_mod_add(f, T(8), T(9), T(10));
+        pk_ref_mod_mul(f, x3, T(8), T(8));
+        pk_ref_mod_sub(f, T(8), T(9), T(10));
+        pk_ref_mod_mul(f, T(8), T(8), T(8));
+        pk_ref_mod_mul(f, z3, x1, T(8));
+        pk_ref_mod_mul(f, x2, T(5), T(6));
+        pk_ref_mod_mul(f, T(8), T(11), T(7));
+        pk_ref_mod_add(f, T(8), T(8), T(5));
+        pk_ref_mod_mul(f, z2, T(7), T(8));
+    }
+    conditional_swap(x2, x3, words, swap);
+    conditional_swap(z2, z3, words, swap);
+
+    inverse(ec, T(5), z2);
+    pk_ref_mod_mul(f, T(5), T(5), x2);
+    pk_ref_mod_from_mont(f, T(5), T(5));
+    for (uint32_t i = 0; i < 4 * words; i++) {
+        output[i] = T(5)[i / 4] >> (8 * (i % 4));
+    }
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * r = a - b
+ * @return the borrow
+ */
+static uint32_t subtract(uint32_t* r, const uint32_t* a, const uint32_t* b, uint32_t words)
+{
+    int64_t borrow = 0;
+    for (uint32_t i = 0; i < words; i++) {
+        borrow += (int64_t)a[i] - b[i];
+        r[i] = borrow;
+        borrow >>= WORD_BITS;
+    }
+    return borrow != 0;
+}
+
+/**
+ * @return the count bits of x from the bit start, 0 beyond the words
+ */
+static uint32_t get_bits(const uint32_t* x, uint32_t words, uint32_t start, uint32_t count)
+{
+    uint32_t bits = 0;
+    for (uint32_t i = count; i-- > 0;) {
+        uint32_t bit = start + i;
+        bits <<= 1;
+        if (bit < WORD_BITS * words) {
+            bits |= (x[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1;
+        }
+    }
+    return bits;
+}
+
+static void set_word(uint32_t* x, uint32_t words, uint32_t value)
+{
+    memset(x, 0, words * sizeof(uint32_t));
+    x[0] = value;
+}
+
+/**
+ * Jacobian coordinates, a = -3, "add-2007-bl" (Explicit-Formulas Database)
+ */
+static void weierstrass_add(const pk_ref_ec_t* ec, uint32_t* r, const uint32_t* p, const uint32_t* q)
+{
+    const pk_ref_mod_t* f = &ec->field;
+    uint32_t words = ec->curve->words;
+    const uint32_t* x1 = &p[0];
+    const uint32_t* y1 = &p[words];
+    const uint32_t* z1 = &p[2 * words];
+    const uint32_t* x2 = &q[0];
+    const uint32_t* y2 = &q[words];
+    const uint32_t* z2 = &q[2 * words];
+
+    if (p == q) {
+        weierstrass_double(ec, r, p);
+        return;
+    }
+    if (pk_ref_is_zero(z1, words)) {
+        memmove(r, q, 3 * words * sizeof(uint32_t));
+        return;
+    }
+    if (pk_ref_is_zero(z2, words)) {
+        memmove(r, p, 3 * words * sizeof(uint32_t));
+        return;
+    }
+
+    pk_ref_mod_mul(f, T(0), z1, z1);            // Z1Z1
+    pk_ref_mod_mul(f, T(1), z2, z2);            // Z2Z2
+    pk_ref_mod_mul(f, T(2), x1, T(1));          // U1
+    pk_ref_mod_mul(f, T(3), x2, T(0));          // U2
+    pk_ref_mod_mul(f, T(4), y1, z2);
+    pk_ref_mod_mul(f, T(4), T(4), T(1));        // S1
+    pk_ref_mod_mul(f, T(5), y2, z1);
+    pk_ref_mod_mul(f, T(5), T(5), T(0));        // S2
+    pk_ref_mod_sub(f, T(6), T(3), T(2));        // H
+    pk_ref_mod_sub(f, T(7), T(5), T(4));
+    pk_ref_mod_add(f, T(7), T(7), T(7));        // r
+
+    // same x: the same point is doubled, opposite points give the infinity
+    if (pk_ref_is_zero(T(6), words)) {
+        if (pk_ref_is_zero(T(7), words)) {
+            weierstrass_double(ec, r, p);
+        } else {
+            pk_ref_ec_infinity(ec, r);
+        }
+        return;
+    }
+
+    pk_ref_mod_add(f, T(8), T(6), T(6));
+    pk_ref_mod_mul(f, T(8), T(8), T(8));        // I
+    pk_ref_mod_mul(f, T(9), T(6), T(8));        // J
+    pk_ref_mod_mul(f, T(10), T(2), T(8));       // V
+    pk_ref_mod_mul(f, T(11), T(7), T(7));
+    pk_ref_mod_sub(f, T(11), T(11), T(9));
+    pk_ref_mod_sub(f, T(11), T(11), T(10));
+    pk_ref_mod_sub(f, T(11), T(11), T(10));     // X3
+    pk_ref_mod_sub(f, T(12), T(10), T(11));
+    pk_ref_mod_mul(f, T(12), T(7), T(12));
+    pk_ref_mod_mul(f, T(13), T(4), T(9));
+    pk_ref_mod_add(f, T(13), T(13), T(13));
+    pk_ref_mod_sub(f, T(12), T(12), T(13));     // Y3
+    pk_ref_mod_add(f, T(13), z1, z2);
+    pk_ref_mod_mul(f, T(13), T(13), T(13));
+    pk_ref_mod_sub(f, T(13), T(13), T(0));
+    pk_ref_mod_sub(f, T(13), T(13), T(1));
+    pk_ref_mod_mul(f, T(13), T(13), T(6));      // Z3
+
+    memcpy(r, T(11), 3 * words * sizeof(uint32_t));
+}
+
+/**
+ * Jacobian coordinates, a = -3, "dbl-2001-b" (Explicit-Formulas Database)
+ */
+static void weierstrass_double(const pk_ref_ec_t* ec, uint32_t* r, const uint32_t* p)
+{
+    const pk_ref_mod_t* f = &ec->field;
+    uint32_t words = ec->curve->words;
+    const uint32_t* x1 = &p[0];
+    const uint32_t* y1 = &p[words];
+    const uint32_t* z1 = &p[2 * words];
+
+    pk_ref_mod_mul(f, T(0), z1, z1);            // delta
+    pk_ref_mod_mul(f, T(1), y1, y1);            // gamma
+    pk_ref_mod_mul(f, T(2), x1, T(1));          // beta
+    pk_ref_mod_sub(f, T(3), x1, T(0));
+    pk_ref_mod_add(f, T(4), x1, T(0));
+    pk_ref_mod_mul(f, T(3), T(3), T(4));
+    pk_ref_mod_add(f, T(4), T(3), T(3));
+    pk_ref_mod_add(f, T(3), T(4), T(3));        // alpha
+    pk_ref_mod_add(f, T(5), T(2), T(2));
+    pk_ref_mod_add(f, T(5), T(5), T(5));        // 4 beta
+    pk_ref_mod_mul(f, T(8), T(3), T(3));
+    pk_ref_mod_sub(f, T(8), T(8), T(5));
+    pk_ref_mod_sub(f, T(8), T(8), T(5));        // X3
+    pk_ref_mod_add(f, T(10), y1, z1);
+    pk_ref_mod_mul(f, T(10), T(10), T(10));
+    pk_ref_mod_sub(f, T(10), T(10), T(1));
+    pk_ref_mod_sub(f, T(10), T(10), T(0));      // Z3
+    pk_ref_mod_sub(f, T(9), T(5), T(8));
+    pk_ref_mod_mul(f, T(9), T(3), T(9));
+    pk_ref_mod_mul(f, T(6), T(1), T(1));
+    pk_ref_mod_add(f, T(6), T(6), T(6));
+    pk_ref_mod_add(f, T(6), T(6), T(6));
+    pk_ref_mod_add(f, T(6), T(6), T(6));
+    pk_ref_mod_sub(f, T(9), T(9), T(6));        // Y3
+
+    memcpy(r, T(8), 3 * words * sizeof(uint32_t));
+}
+
+/**
+ * Extended coordinates, a = -1, "add-2008-hwcd-3" (Explicit-Formulas
+ * Database), complete: also the doubling and the neutral point
+ */
+static void edwards_add(const pk_ref_ec_t* ec, uint32_t* r, const uint32_t* p, const uint32_t* q)
+{
+    const pk_ref_mod_t* f = &ec->field;
+    uint32_t words = ec->curve->words;
+
+    pk_ref_mod_sub(f, T(0), &p[words], &p[0]);
+    pk_ref_mod_sub(f, T(1), &q[words], &q[0]);
+    pk_ref_mod_mul(f, T(0), T(0), T(1));                    // A
+    pk_ref_mod_add(f, T(1), &p[words], &p[0]);
+    pk_ref_mod_add(f, T(2), &q[words], &q[0]);
+    pk_ref_mod_mul(f, T(1), T(1), T(2));                    // B
+    pk_ref_mod_mul(f, T(2), &p[3 * words], &q[3 * words]);
+    pk_ref_mod_mul(f, T(2), T(2), ec->b);
+    pk_ref_mod_add(f, T(2), T(2), T(2));                    // C
+    pk_ref_mod_mul(f, T(3), &p[2 * words], &q[2 * words]);
+    pk_ref_mod_add(f, T(3), T(3), T(3));                    // D
+    pk_ref_mod_sub(f, T(4), T(1), T(0));                    // E
+    pk_ref_mod_sub(f, T(5), T(3), T(2));                    // F
+    pk_ref_mod_add(f, T(6), T(3), T(2));                    // G
+    pk_ref_mod_add(f, T(7), T(1), T(0));                    // H
+
+    pk_ref_mod_mul(f, &r[0], T(4), T(5));
+    pk_ref_mod_mul(f, &r[words], T(6), T(7));
+    pk_ref_mod_mul(f, &r[2 * words], T(5), T(6));
+    pk_ref_mod_mul(f, &r[3 * words], T(4), T(7));
+}
+
+/**
+ * r = a^(p - 2) in the Montgomery domain, the last two temporaries as table
+ */
+static void inverse(const pk_ref_ec_t* ec, uint32_t* r, const uint32_t* a)
+{
+    uint32_t words = ec->curve->words;
+
+    pk_ref_mod_exp(&ec->field, r, a, ec->curve->p_minus_2, words, 1, T(PK_REF_TEMPS - 2));
+}
+
+static void conditional_swap(uint32_t* x, uint32_t* y, uint32_t words, uint32_t swap)
+{
+    uint32_t mask = -swap;
+    for (uint32_t i = 0; i < words; i++) {
+        uint32_t t = mask & (x[i] ^ y[i]);
+        x[i] ^= t;
+        y[i] ^= t;
+    }
+}
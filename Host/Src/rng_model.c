@@ -0,0 +1,172 @@
+/**
+ ******************************************************************************
+ * @file    rng_model.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   register-level model of the RNG peripheral of the STM32L443
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "stm32l4xx_hal.h"
+
+#include "host.h"
+#include "rng_model.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define REGISTERS_SIZE 0x400
+
+#define CR_OFFSET offsetof(RNG_TypeDef, CR)
+#define SR_OFFSET offsetof(RNG_TypeDef, SR)
+#define DR_OFFSET offsetof(RNG_TypeDef, DR)
+
+#define SEED 0x9E3779B9 // of the sequence, not zero
+
+/* Private variables ---------------------------------------------------------*/
+
+static uint32_t cr;
+static uint32_t sr;
+static uint32_t state;
+static uint32_t words;
+static bool irq_line;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint32_t rng_read(uint32_t offset);
+static uint32_t rng_peek(uint32_t offset);
+static void rng_write(uint32_t offset, uint32_t value, uint32_t size);
+static void update_status(void);
+static void update_irq(void);
+static uint32_t next_word(void);
+
+static const host_peripheral_t rng_peripheral = {
+    .base = RNG_BASE,
+    .size = REGISTERS_SIZE,
+    .read = rng_read,
+    .peek = rng_peek,
+    .write = rng_write,
+};
+
+/* Public functions ----------------------------------------------------------*/
+
+void rng_model_init(void)
+{
+    cr = 0;
+    sr = 0;
+    state = SEED;
+    words = 0;
+    irq_line = false;
+
+    host_add_peripheral(&rng_peripheral);
+}
+
+void rng_model_inject_error(uint32_t flags)
+{
+    if (flags & RNG_SR_SEIS) {
+        sr |= RNG_SR_SECS | RNG_SR_SEIS;
+    }
+    if (flags & RNG_SR_CEIS) {
+        sr |= RNG_SR_CECS | RNG_SR_CEIS;
+    }
+    update_status();
+    update_irq();
+}
+
+uint32_t rng_model_get_words(void)
+{
+    return words;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t rng_read(uint32_t offset)
+{
+    uint32_t value = rng_peek(offset);
+
+    if (offset == DR_OFFSET && (sr & RNG_SR_DRDY)) {
+        words++;
+        state = next_word();
+    }
+    return value;
+}
+
+static uint32_t rng_peek(uint32_t offset)
+{
+    switch (offset) {
+    case CR_OFFSET:
+        return cr;
+    case SR_OFFSET:
+        return sr;
+    case DR_OFFSET:
+        return (sr & RNG_SR_DRDY) ? state : 0;
+    default:
+        return 0;
+    }
+}
+
+static void rng_write(uint32_t offset, uint32_t value, uint32_t size)
+{
+    (void)size;
+
+    offset &= ~3U;
+
+    if (offset == CR_OFFSET) {
+        // the seed error is recovered by restarting the generator
+        if ((cr & RNG_CR_RNGEN) && !(value & RNG_CR_RNGEN)) {
+            sr &= ~RNG_SR_SECS;
+        }
+        cr = value & (RNG_CR_RNGEN | RNG_CR_IE);
+    } else if (offset == SR_OFFSET) {
+        // CEIS and SEIS are cleared by writing 0, the clock is back at once
+        sr &= value | ~(RNG_SR_CEIS | RNG_SR_SEIS);
+        if (!(sr & RNG_SR_CEIS)) {
+            sr &= ~RNG_SR_CECS;
+        }
+    }
+    // DR is read-only
+
+    update_status();
+    update_irq();
+}
+
+static void update_status(void)
+{
+    if ((cr & RNG_CR_RNGEN) && !(sr & RNG_SR_SECS)) {
+        sr |= RNG_SR_DRDY;
+    } else {
+        sr &= ~RNG_SR_DRDY;
+    }
+}
+
+static void update_irq(void)
+{
+    bool line = (cr & RNG_CR_IE) && (sr & (RNG_SR_DRDY | RNG_SR_CEIS | RNG_SR_SEIS));
+
+    if (line && !irq_line) {
+        host_set_pending(RNG_IRQn);
+    }
+    irq_line = line;
+}
+
+/**
+ * xorshift32
+ */
+static uint32_t next_word(void)
+{
+    uint32_t x = state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
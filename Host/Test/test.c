@@ -0,0 +1,64 @@
+/**
+ ******************************************************************************
+ * @file    test.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   checks of the host tests
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test.h"
+
+/* Private variables ---------------------------------------------------------*/
+
+static uint32_t failures;
+
+/* Public functions ----------------------------------------------------------*/
+
+void test_check(bool condition, const char* text, const char* file, int line)
+{
+    if (!condition) {
+        failures++;
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, text);
+    }
+}
+
+uint32_t test_hex(const char* text, uint8_t* data)
+{
+    uint32_t length = 0;
+
+    while (text[0] != '\0' && text[1] != '\0') {
+        char byte[3] = {text[0], text[1], '\0'};
+        data[length++] = strtoul(byte, NULL, 16);
+        text += 2;
+    }
+    return length;
+}
+
+int test_result(void)
+{
+    if (failures != 0) {
+        fprintf(stderr, "%u check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Called by the firmware on a fatal error (main.c is not linked in the tests)
+ */
+void Error_Handler(void)
+{
+    fprintf(stderr, "Error_Handler()\n");
+    abort();
+}
@@ -0,0 +1,45 @@
+/**
+ ******************************************************************************
+ * @file    test.h
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   checks of the host tests
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+#ifndef TEST_H
+#define TEST_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported macro ------------------------------------------------------------*/
+
+#define CHECK(condition) test_check((condition), #condition, __FILE__, __LINE__)
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * Count and print a failed check, the test continues
+ */
+void test_check(bool condition, const char* text, const char* file, int line);
+
+/**
+ * Decode a hexadecimal string
+ * @return the number of bytes decoded
+ */
+uint32_t test_hex(const char* text, uint8_t* data);
+
+/**
+ * @return the exit code of the test, non zero if a check failed
+ */
+int test_result(void);
+
+#endif
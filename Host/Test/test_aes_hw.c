@@ -0,0 +1,965 @@
+/**
+ ******************************************************************************
+ * @file    test_aes_hw.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   tests of the hardware AES driver on the peripheral model
+ *
+ * The polling, session, DMA and asynchronous variants are compared to the
+ * reference AES, with 128 and 256 bits keys, also when an urgent job
+ * suspends a bulk one. The buffers larger than a HAL call are processed in
+ * chunks, at once or as a stream, also from a list of fragments. The GCM
+ * with a header, the CCM and the CMAC are checked with the vectors of their
+ * specifications. The messages of a GCM batch give the output of separate
+ * calls, in polling, by DMA and with CMOX. The operations done in place
+ * give the output of separate buffers, the shifted buffers are rejected.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "stm32l4xx_hal.h"
+
+#include "aes_hw.h"
+#include "aes_ref.h"
+#include "aes_sw.h"
+#include "host.h"
+#include "stm32l4xx_it.h"
+#include "test.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define LENGTH 256
+#define ASYNC_JOBS 4
+#define ASYNC_LENGTH (LENGTH / ASYNC_JOBS)
+#define URGENT_LENGTH 16
+#define LARGE_LENGTH (128 * 1024 + 48) // 3 chunks of the driver
+#define LARGE_PIECE 1024 // of a stream
+#define LARGE_STEPS 4100 // AES interrupts of a large job, in its second chunk
+#define KEY_SIZE_NUMBER 2
+#define FRAGMENT_NUMBER 8
+#define BATCH_NUMBER 4
+#define CTR_PARTIAL_NUMBER 3
+#define UNTOUCHED 0xA5 // content of the output past the length
+#define IN_PLACE_LENGTH 71 // a partial last block
+#define IN_PLACE_AAD_LENGTH 5
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct {
+    bool bulk_gcm;
+    uint32_t steps; // AES interrupts of the bulk job before the urgent one is queued
+    bool urgent_gcm;
+} preempt_case_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+// the header of the GCM operations of aes_hw.c
+static const char auth_header[] = "0123456789ABCDEF";
+
+static const uint32_t key_sizes[KEY_SIZE_NUMBER] = {16, 32};
+static uint32_t key_size;
+static uint8_t key[32] __ALIGNED(4);
+static uint8_t init_vector[16] __ALIGNED(4);
+// IV || 2: the peripheral starts the payload at the counter written
+static uint8_t gcm_init_vector[16] __ALIGNED(4);
+static uint8_t plain_data[LENGTH] __ALIGNED(4);
+static uint8_t cipher_data[LENGTH] __ALIGNED(4);
+static uint8_t output[LENGTH] __ALIGNED(4);
+static uint8_t expected[LENGTH] __ALIGNED(4);
+static uint8_t mic[16] __ALIGNED(4);
+static uint8_t expected_mic[16] __ALIGNED(4);
+
+static uint8_t async_init_vectors[ASYNC_JOBS][16];
+static volatile uint32_t async_done;
+static volatile bool async_result;
+static void* async_order[2];
+
+// in the CTR payload, in the GCM init phase (suspended after the header) and
+// in the GCM payload
+static const preempt_case_t preempt_cases[] = {
+    {false, 2, true},
+    {true, 0, true},
+    {true, 3, true},
+    {true, 3, false},
+};
+static uint8_t urgent_data[URGENT_LENGTH] __ALIGNED(4);
+static uint8_t urgent_expected[URGENT_LENGTH] __ALIGNED(4);
+static uint8_t urgent_mic[16] __ALIGNED(4);
+static uint8_t urgent_expected_mic[16] __ALIGNED(4);
+
+static uint8_t large_plain[LARGE_LENGTH] __ALIGNED(4);
+static uint8_t large_cipher[LARGE_LENGTH] __ALIGNED(4);
+static uint8_t large_expected[LARGE_LENGTH] __ALIGNED(4);
+
+// a message of 250 bytes, most blocks across two fragments or more
+static const uint32_t fragment_lengths[FRAGMENT_NUMBER] = {14, 20, 8, 1, 3, 120, 37, 47};
+static fragment_t fragments[FRAGMENT_NUMBER];
+
+// any lengths in polling, whole blocks by DMA
+// partial last blocks, as in the sweep
+static const uint32_t ctr_partial_lengths[CTR_PARTIAL_NUMBER] = {1, 13, 100};
+static const uint32_t batch_aad_lengths[BATCH_NUMBER] = {0, 5, 16, 20};
+static const uint32_t batch_lengths[BATCH_NUMBER] = {16, 33, 0, 71};
+static const uint32_t batch_dma_lengths[BATCH_NUMBER] = {16, 64, 32, 48};
+static uint8_t batch_nonces[BATCH_NUMBER][12];
+static uint8_t batch_tags[BATCH_NUMBER][16];
+static uint8_t batch_expected_tags[BATCH_NUMBER][16];
+static aead_message_t batch[BATCH_NUMBER];
+
+static aes_hw_session_t session;
+static aes_hw_stream_t stream;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void run(void);
+static void reference_ctr(const uint8_t* counter, const uint8_t* input, uint32_t length, uint8_t* output);
+static void reference_gcm(const uint8_t* input, uint32_t length, uint8_t* output, uint8_t* tag);
+static void reference_cbc(const uint8_t* iv, const uint8_t* input, uint32_t length, uint8_t* output);
+static void async_callback(bool result, void* context);
+static void order_callback(bool result, void* context);
+static void test_ctr(void);
+static void test_gcm(void);
+static void test_ecb_cbc(void);
+static void test_in_place(void);
+static void test_async(void);
+static void test_preempt(void);
+static void test_large(void);
+static void test_large_async(void);
+static void test_stream(void);
+static void test_fragments(void);
+static void test_batch(const uint32_t* lengths, bool dma);
+static void test_gcm_aad(void);
+static void test_gcm_aad_256(void);
+static void test_ccm(void);
+static void test_cmac(void);
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    host_init();
+    host_run(run);
+    return test_result();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void run(void)
+{
+    HAL_Init();
+    aes_hw_init();
+    aes_sw_init();
+
+    for (uint32_t i = 0; i < LENGTH; i++) {
+        plain_data[i] = i;
+    }
+    for (uint32_t i = 0; i < sizeof(key); i++) {
+        key[i] = 0x40 + i;
+    }
+    for (uint32_t i = 0; i < sizeof(init_vector); i++) {
+        init_vector[i] = i < 12 ? 0x80 + i : 0;
+    }
+    memcpy(gcm_init_vector, init_vector, sizeof(gcm_init_vector));
+    gcm_init_vector[15] = 2;
+
+    CHECK(!aes_hw_set_key_size(24));
+    for (uint32_t i = 0; i < KEY_SIZE_NUMBER; i++) {
+        key_size = key_sizes[i];
+        CHECK(aes_hw_set_key_size(key_size));
+        test_ctr();
+        test_gcm();
+        test_ecb_cbc();
+        test_in_place();
+        test_async();
+        test_preempt();
+    }
+
+    // the large buffers once, with the 128 bits key
+    CHECK(aes_hw_set_key_size(16));
+    key_size = 16;
+    test_large();
+    test_large_async();
+    test_stream();
+    test_fragments();
+    test_batch(batch_lengths, false);
+    test_batch(batch_dma_lengths, true);
+
+    CHECK(aes_hw_set_key_size(16));
+    test_gcm_aad();
+    CHECK(aes_hw_set_key_size(32));
+    test_gcm_aad_256();
+    CHECK(aes_hw_set_key_size(16));
+    test_ccm();
+    test_cmac();
+}
+
+static void reference_ctr(const uint8_t* counter, const uint8_t* input, uint32_t length, uint8_t* output)
+{
+    uint32_t round_keys[AES_REF_ROUND_KEYS_SIZE];
+    uint8_t block[AES_REF_BLOCK_SIZE];
+    uint8_t stream[AES_REF_BLOCK_SIZE];
+
+    aes_ref_expand_key(key, key_size, round_keys);
+    memcpy(block, counter, sizeof(block));
+    for (uint32_t i = 0; i < length; i += AES_REF_BLOCK_SIZE) {
+        aes_ref_encrypt(round_keys, key_size, block, stream);
+        for (uint32_t j = 0; j < AES_REF_BLOCK_SIZE && i + j < length; j++) {
+            output[i + j] = input[i + j] ^ stream[j];
+        }
+        // 32-bit counter, as the peripheral
+        for (int32_t j = AES_REF_BLOCK_SIZE - 1; j >= 12 && ++block[j] == 0; j--) {
+        }
+    }
+}
+
+static void reference_gcm(const uint8_t* input, uint32_t length, uint8_t* output, uint8_t* tag)
+{
+    uint32_t round_keys[AES_REF_ROUND_KEYS_SIZE];
+    uint8_t hash_key[AES_REF_BLOCK_SIZE] = {0};
+    uint8_t hash[AES_REF_BLOCK_SIZE] = {0};
+    uint8_t counter[AES_REF_BLOCK_SIZE];
+    uint8_t lengths[AES_REF_BLOCK_SIZE] = {0};
+    uint32_t header_size = strlen(auth_header);
+
+    memcpy(counter, gcm_init_vector, sizeof(counter));
+    reference_ctr(counter, input, length, output);
+
+    aes_ref_expand_key(key, key_size, round_keys);
+    aes_ref_encrypt(round_keys, key_size, hash_key, hash_key);
+    aes_ref_ghash(hash, hash_key, (const uint8_t*)auth_header, header_size);
+    aes_ref_ghash(hash, hash_key, output, length);
+    lengths[7] = header_size * 8;
+    for (uint32_t i = 0; i < 4; i++) {
+        lengths[15 - i] = (length * 8) >> (8 * i);
+    }
+    aes_ref_ghash(hash, hash_key, lengths, sizeof(lengths));
+
+    counter[15] = 1;
+    aes_ref_encrypt(round_keys, key_size, counter, tag);
+    for (uint32_t i = 0; i < AES_REF_BLOCK_SIZE; i++) {
+        tag[i] ^= hash[i];
+    }
+}
+
+/**
+ * CBC encryption, ECB if the IV is NULL
+ */
+static void reference_cbc(const uint8_t* iv, const uint8_t* input, uint32_t length, uint8_t* output)
+{
+    uint32_t round_keys[AES_REF_ROUND_KEYS_SIZE];
+    uint8_t block[AES_REF_BLOCK_SIZE] = {0};
+
+    aes_ref_expand_key(key, key_size, round_keys);
+    if (iv != NULL) {
+        memcpy(block, iv, sizeof(block));
+    }
+    for (uint32_t i = 0; i < length; i += AES_REF_BLOCK_SIZE) {
+        for (uint32_t j = 0; j < AES_REF_BLOCK_SIZE; j++) {
+            block[j] = iv != NULL ? block[j] ^ input[i + j] : input[i + j];
+        }
+        aes_ref_encrypt(round_keys, key_size, block, &output[i]);
+        memcpy(block, &output[i], sizeof(block));
+    }
+}
+
+static void async_callback(bool result, void* context)
+{
+    (void)context;
+
+    async_result = async_result && result;
+    async_done++;
+}
+
+/**
+ * The context is the output buffer of the job
+ */
+static void order_callback(bool result, void* context)
+{
+    if (async_done < sizeof(async_order) / sizeof(async_order[0])) {
+        async_order[async_done] = context;
+    }
+    async_callback(result, context);
+}
+
+static void test_ctr(void)
+{
+    reference_ctr(init_vector, plain_data, LENGTH, expected);
+
+    memset(cipher_data, 0, LENGTH);
+    CHECK(aes_hw_ctr_encrypt(key, init_vector, plain_data, LENGTH, cipher_data));
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+
+    memset(cipher_data, 0, LENGTH);
+    CHECK(aes_hw_ctr_encrypt_dma(key, init_vector, plain_data, LENGTH, cipher_data));
+    CHECK(aes_hw_wait());
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+
+    memset(cipher_data, 0, LENGTH);
+    CHECK(aes_hw_session_init(&session, key));
+    CHECK(aes_hw_session_ctr_encrypt(&session, init_vector, plain_data, LENGTH, cipher_data));
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+
+    // another key written through the buffer of the session key is not taken
+    // for the key of the session
+    uint8_t session_key[sizeof(session.key)];
+    memcpy(session_key, session.key, sizeof(session_key));
+    memset(session.key, 0, sizeof(session.key));
+    CHECK(aes_hw_ctr_encrypt(session.key, init_vector, plain_data, LENGTH, output));
+    memcpy(session.key, session_key, sizeof(session_key));
+    memset(cipher_data, 0, LENGTH);
+    CHECK(aes_hw_session_ctr_encrypt(&session, init_vector, plain_data, LENGTH, cipher_data));
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+
+    // a partial last block, nothing is written past the length
+    for (uint32_t i = 0; i < CTR_PARTIAL_NUMBER; i++) {
+        uint32_t length = ctr_partial_lengths[i];
+        bool untouched = true;
+
+        memset(cipher_data, UNTOUCHED, LENGTH);
+        CHECK(aes_hw_ctr_encrypt(key, init_vector, plain_data, length, cipher_data));
+        CHECK(memcmp(cipher_data, expected, length) == 0);
+        for (uint32_t j = length; j < LENGTH; j++) {
+            untouched &= cipher_data[j] == UNTOUCHED;
+        }
+
+        memset(cipher_data, UNTOUCHED, LENGTH);
+        CHECK(aes_hw_session_ctr_encrypt(&session, init_vector, plain_data, length, cipher_data));
+        CHECK(memcmp(cipher_data, expected, length) == 0);
+        for (uint32_t j = length; j < LENGTH; j++) {
+            untouched &= cipher_data[j] == UNTOUCHED;
+        }
+        CHECK(untouched);
+    }
+}
+
+static void test_gcm(void)
+{
+    reference_gcm(plain_data, LENGTH, expected, expected_mic);
+
+    memset(cipher_data, 0, LENGTH);
+    CHECK(aes_hw_gcm_encrypt(key, gcm_init_vector, plain_data, LENGTH, cipher_data, mic));
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+    CHECK(memcmp(mic, expected_mic, sizeof(mic)) == 0);
+
+    memset(output, 0, LENGTH);
+    memset(mic, 0, sizeof(mic));
+    CHECK(aes_hw_gcm_decrypt(key, gcm_init_vector, cipher_data, LENGTH, output, mic));
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+    CHECK(memcmp(mic, expected_mic, sizeof(mic)) == 0);
+
+    memset(cipher_data, 0, LENGTH);
+    memset(mic, 0, sizeof(mic));
+    CHECK(aes_hw_gcm_encrypt_dma(key, gcm_init_vector, plain_data, LENGTH, cipher_data, mic));
+    CHECK(aes_hw_wait());
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+    CHECK(memcmp(mic, expected_mic, sizeof(mic)) == 0);
+
+    memset(cipher_data, 0, LENGTH);
+    memset(mic, 0, sizeof(mic));
+    CHECK(aes_hw_session_gcm_encrypt(&session, gcm_init_vector, plain_data, LENGTH, cipher_data, mic));
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+    CHECK(memcmp(mic, expected_mic, sizeof(mic)) == 0);
+}
+
+static void test_ecb_cbc(void)
+{
+    reference_cbc(NULL, plain_data, LENGTH, expected);
+    CHECK(aes_hw_ecb_encrypt(key, plain_data, LENGTH, cipher_data));
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+    CHECK(aes_hw_ecb_decrypt(key, cipher_data, LENGTH, output));
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+
+    reference_cbc(init_vector, plain_data, LENGTH, expected);
+    CHECK(aes_hw_cbc_encrypt(key, init_vector, plain_data, LENGTH, cipher_data));
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+    // the cached decryption key is reused, then the key registers are
+    // written again after an encryption
+    for (uint32_t i = 0; i < 2; i++) {
+        memset(output, 0, LENGTH);
+        CHECK(aes_hw_cbc_decrypt(key, init_vector, cipher_data, LENGTH, output));
+        CHECK(memcmp(output, plain_data, LENGTH) == 0);
+    }
+    CHECK(aes_hw_ctr_encrypt(key, init_vector, plain_data, LENGTH, output));
+    CHECK(aes_hw_cbc_decrypt(key, init_vector, cipher_data, LENGTH, output));
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+
+    // a new key is derived again
+    key[0] ^= 1;
+    reference_cbc(init_vector, plain_data, LENGTH, expected);
+    CHECK(aes_hw_cbc_decrypt(key, init_vector, expected, LENGTH, output));
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+    key[0] ^= 1;
+
+    CHECK(!aes_hw_cbc_encrypt(key, init_vector, plain_data, LENGTH - 1, cipher_data));
+    CHECK(!aes_hw_ecb_decrypt(key, cipher_data, 0, output));
+}
+
+/**
+ * Every operation is done with the input as output, by polling, DMA and
+ * under interrupt, then undone in place
+ */
+static void test_in_place(void)
+{
+    const uint8_t* aad = (const uint8_t*)auth_header;
+    uint8_t tag[16] __ALIGNED(4);
+
+    reference_ctr(init_vector, plain_data, LENGTH, expected);
+    memcpy(output, plain_data, LENGTH);
+    CHECK(aes_hw_ctr_encrypt(key, init_vector, output, LENGTH, output));
+    CHECK(memcmp(output, expected, LENGTH) == 0);
+    CHECK(aes_hw_ctr_encrypt_dma(key, init_vector, output, LENGTH, output));
+    CHECK(aes_hw_wait());
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+    CHECK(aes_hw_session_init(&session, key));
+    CHECK(aes_hw_session_ctr_encrypt(&session, init_vector, output, LENGTH, output));
+    CHECK(memcmp(output, expected, LENGTH) == 0);
+    async_done = 0;
+    async_result = true;
+    CHECK(aes_hw_ctr_encrypt_async(key, init_vector, output, LENGTH, output, async_callback, NULL));
+    while (aes_hw_async_pending() != 0) {
+    }
+    CHECK(async_done == 1);
+    CHECK(async_result);
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+
+    reference_cbc(init_vector, plain_data, LENGTH, expected);
+    CHECK(aes_hw_cbc_encrypt(key, init_vector, output, LENGTH, output));
+    CHECK(memcmp(output, expected, LENGTH) == 0);
+    CHECK(aes_hw_cbc_decrypt(key, init_vector, output, LENGTH, output));
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+
+    reference_gcm(plain_data, LENGTH, expected, expected_mic);
+    memset(mic, 0, sizeof(mic));
+    CHECK(aes_hw_gcm_encrypt(key, gcm_init_vector, output, LENGTH, output, mic));
+    CHECK(memcmp(output, expected, LENGTH) == 0);
+    CHECK(memcmp(mic, expected_mic, sizeof(mic)) == 0);
+    memset(mic, 0, sizeof(mic));
+    CHECK(aes_hw_gcm_decrypt_dma(key, gcm_init_vector, output, LENGTH, output, mic));
+    CHECK(aes_hw_wait());
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+    CHECK(memcmp(mic, expected_mic, sizeof(mic)) == 0);
+    memset(mic, 0, sizeof(mic));
+    CHECK(aes_hw_gcm_encrypt_dma(key, gcm_init_vector, output, LENGTH, output, mic));
+    CHECK(aes_hw_wait());
+    CHECK(memcmp(output, expected, LENGTH) == 0);
+    CHECK(memcmp(mic, expected_mic, sizeof(mic)) == 0);
+    CHECK(aes_hw_session_gcm_decrypt(&session, gcm_init_vector, output, LENGTH, output, mic));
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+
+    // a partial last block, which goes through a copy, and a verified tag
+    CHECK(aes_hw_gcm_aad_encrypt(key, init_vector, aad, IN_PLACE_AAD_LENGTH, plain_data, IN_PLACE_LENGTH, expected, expected_mic));
+    CHECK(aes_hw_gcm_aad_encrypt(key, init_vector, aad, IN_PLACE_AAD_LENGTH, output, IN_PLACE_LENGTH, output, tag));
+    CHECK(memcmp(output, expected, IN_PLACE_LENGTH) == 0);
+    CHECK(memcmp(tag, expected_mic, sizeof(tag)) == 0);
+    CHECK(aes_hw_gcm_aad_decrypt(key, init_vector, aad, IN_PLACE_AAD_LENGTH, output, IN_PLACE_LENGTH, output, tag));
+    CHECK(memcmp(output, plain_data, IN_PLACE_LENGTH) == 0);
+
+    // the CBC-MAC of the plain data is computed before they are overwritten,
+    // and after they are restored
+    CHECK(aes_hw_ccm_encrypt(key, init_vector, 13, aad, IN_PLACE_AAD_LENGTH, plain_data, IN_PLACE_LENGTH, expected,
+            expected_mic, sizeof(expected_mic)));
+    CHECK(aes_hw_ccm_encrypt(key, init_vector, 13, aad, IN_PLACE_AAD_LENGTH, output, IN_PLACE_LENGTH, output,
+            tag, sizeof(tag)));
+    CHECK(memcmp(output, expected, IN_PLACE_LENGTH) == 0);
+    CHECK(memcmp(tag, expected_mic, sizeof(tag)) == 0);
+    CHECK(aes_hw_ccm_decrypt(key, init_vector, 13, aad, IN_PLACE_AAD_LENGTH, output, IN_PLACE_LENGTH, output,
+            tag, sizeof(tag)));
+    CHECK(memcmp(output, plain_data, IN_PLACE_LENGTH) == 0);
+
+    // an output shifted from the input, either way, is rejected and not written
+    memcpy(output, plain_data, LENGTH);
+    CHECK(!aes_hw_ctr_encrypt(key, init_vector, output, LENGTH - 16, output + 4));
+    CHECK(!aes_hw_cbc_decrypt(key, init_vector, output + 16, LENGTH - 16, output));
+    CHECK(!aes_hw_gcm_encrypt_dma(key, gcm_init_vector, output, LENGTH - 16, output + 16, mic));
+    CHECK(!aes_hw_busy());
+    CHECK(!aes_hw_ctr_encrypt_async(key, init_vector, output + 16, LENGTH - 16, output, async_callback, NULL));
+    CHECK(aes_hw_async_pending() == 0);
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+}
+
+/**
+ * The CTR jobs continue the counter of each other, the result is the one of
+ * a single encryption
+ */
+static void test_async(void)
+{
+    reference_ctr(init_vector, plain_data, LENGTH, expected);
+
+    memset(cipher_data, 0, LENGTH);
+    async_done = 0;
+    async_result = true;
+    for (uint32_t i = 0; i < ASYNC_JOBS; i++) {
+        memcpy(async_init_vectors[i], init_vector, 16);
+        async_init_vectors[i][15] += i * ASYNC_LENGTH / 16;
+        CHECK(aes_hw_ctr_encrypt_async(key, async_init_vectors[i], &plain_data[i * ASYNC_LENGTH], ASYNC_LENGTH,
+                &cipher_data[i * ASYNC_LENGTH], async_callback, NULL));
+    }
+    while (aes_hw_async_pending() != 0) {
+    }
+    CHECK(async_done == ASYNC_JOBS);
+    CHECK(async_result);
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+
+    reference_gcm(plain_data, LENGTH, expected, expected_mic);
+    memset(cipher_data, 0, LENGTH);
+    memset(mic, 0, sizeof(mic));
+    async_done = 0;
+    CHECK(aes_hw_gcm_encrypt_async(key, gcm_init_vector, plain_data, LENGTH, cipher_data, mic, async_callback, NULL));
+    while (aes_hw_async_pending() != 0) {
+    }
+    CHECK(async_done == 1);
+    CHECK(async_result);
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+    CHECK(memcmp(mic, expected_mic, sizeof(mic)) == 0);
+}
+
+/**
+ * The interrupts are masked and the AES interrupt handler is called to queue
+ * the urgent job at a given step of the bulk job
+ */
+static void test_preempt(void)
+{
+    for (uint32_t i = 0; i < sizeof(preempt_cases) / sizeof(preempt_cases[0]); i++) {
+        const preempt_case_t* test = &preempt_cases[i];
+
+        if (test->bulk_gcm) {
+            reference_gcm(plain_data, LENGTH, expected, expected_mic);
+        } else {
+            reference_ctr(init_vector, plain_data, LENGTH, expected);
+        }
+        if (test->urgent_gcm) {
+            reference_gcm(plain_data, URGENT_LENGTH, urgent_expected, urgent_expected_mic);
+        } else {
+            reference_ctr(init_vector, plain_data, URGENT_LENGTH, urgent_expected);
+        }
+        memset(cipher_data, 0, LENGTH);
+        memset(urgent_data, 0, URGENT_LENGTH);
+        memset(mic, 0, sizeof(mic));
+        memset(urgent_mic, 0, sizeof(urgent_mic));
+        memset(async_order, 0, sizeof(async_order));
+        async_done = 0;
+        async_result = true;
+
+        __disable_irq();
+        if (test->bulk_gcm) {
+            CHECK(aes_hw_gcm_encrypt_async(key, gcm_init_vector, plain_data, LENGTH, cipher_data, mic, order_callback, cipher_data));
+        } else {
+            CHECK(aes_hw_ctr_encrypt_async(key, init_vector, plain_data, LENGTH, cipher_data, order_callback, cipher_data));
+        }
+        for (uint32_t j = 0; j < test->steps; j++) {
+            AES_IRQHandler();
+        }
+        aes_hw_set_priority(AES_HW_PRIORITY_URGENT);
+        if (test->urgent_gcm) {
+            CHECK(aes_hw_gcm_encrypt_async(key, gcm_init_vector, plain_data, URGENT_LENGTH, urgent_data, urgent_mic,
+                    order_callback, urgent_data));
+        } else {
+            CHECK(aes_hw_ctr_encrypt_async(key, init_vector, plain_data, URGENT_LENGTH, urgent_data, order_callback, urgent_data));
+        }
+        aes_hw_set_priority(AES_HW_PRIORITY_BULK);
+        __enable_irq();
+
+        while (aes_hw_async_pending() != 0) {
+        }
+        CHECK(async_done == 2);
+        CHECK(async_result);
+        CHECK(async_order[0] == urgent_data && async_order[1] == cipher_data);
+        CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+        CHECK(memcmp(urgent_data, urgent_expected, URGENT_LENGTH) == 0);
+        if (test->bulk_gcm) {
+            CHECK(memcmp(mic, expected_mic, sizeof(mic)) == 0);
+        }
+        if (test->urgent_gcm) {
+            CHECK(memcmp(urgent_mic, urgent_expected_mic, sizeof(urgent_mic)) == 0);
+        }
+    }
+}
+
+/**
+ * Buffers larger than the 64 KB of a HAL call, the driver continues the
+ * counter (or the chaining) in the peripheral
+ */
+static void test_large(void)
+{
+    for (uint32_t i = 0; i < LARGE_LENGTH; i++) {
+        large_plain[i] = i * 7;
+    }
+
+    reference_ctr(init_vector, large_plain, LARGE_LENGTH, large_expected);
+    memset(large_cipher, 0, LARGE_LENGTH);
+    CHECK(aes_hw_ctr_encrypt(key, init_vector, large_plain, LARGE_LENGTH, large_cipher));
+    CHECK(memcmp(large_cipher, large_expected, LARGE_LENGTH) == 0);
+
+    memset(large_cipher, 0, LARGE_LENGTH);
+    CHECK(aes_hw_ctr_encrypt_dma(key, init_vector, large_plain, LARGE_LENGTH, large_cipher));
+    CHECK(aes_hw_wait());
+    CHECK(memcmp(large_cipher, large_expected, LARGE_LENGTH) == 0);
+
+    reference_gcm(large_plain, LARGE_LENGTH, large_expected, expected_mic);
+    memset(large_cipher, 0, LARGE_LENGTH);
+    memset(mic, 0, sizeof(mic));
+    CHECK(aes_hw_gcm_encrypt_dma(key, gcm_init_vector, large_plain, LARGE_LENGTH, large_cipher, mic));
+    CHECK(aes_hw_wait());
+    CHECK(memcmp(large_cipher, large_expected, LARGE_LENGTH) == 0);
+    CHECK(memcmp(mic, expected_mic, sizeof(mic)) == 0);
+
+    reference_cbc(init_vector, large_plain, LARGE_LENGTH, large_expected);
+    memset(large_cipher, 0, LARGE_LENGTH);
+    CHECK(aes_hw_cbc_encrypt(key, init_vector, large_plain, LARGE_LENGTH, large_cipher));
+    CHECK(memcmp(large_cipher, large_expected, LARGE_LENGTH) == 0);
+    memset(large_expected, 0, LARGE_LENGTH);
+    CHECK(aes_hw_cbc_decrypt(key, init_vector, large_cipher, LARGE_LENGTH, large_expected));
+    CHECK(memcmp(large_expected, large_plain, LARGE_LENGTH) == 0);
+}
+
+/**
+ * A large CTR job continues from the AES interrupt at the end of each chunk,
+ * also when it is suspended by an urgent job in its second chunk
+ */
+static void test_large_async(void)
+{
+    reference_ctr(init_vector, large_plain, LARGE_LENGTH, large_expected);
+    reference_ctr(init_vector, plain_data, URGENT_LENGTH, urgent_expected);
+
+    for (uint32_t steps = 0; steps <= LARGE_STEPS; steps += LARGE_STEPS) {
+        memset(large_cipher, 0, LARGE_LENGTH);
+        memset(urgent_data, 0, URGENT_LENGTH);
+        memset(async_order, 0, sizeof(async_order));
+        async_done = 0;
+        async_result = true;
+
+        __disable_irq();
+        CHECK(aes_hw_ctr_encrypt_async(key, init_vector, large_plain, LARGE_LENGTH, large_cipher, order_callback, large_cipher));
+        for (uint32_t i = 0; i < steps; i++) {
+            AES_IRQHandler();
+        }
+        if (steps != 0) {
+            aes_hw_set_priority(AES_HW_PRIORITY_URGENT);
+            CHECK(aes_hw_ctr_encrypt_async(key, init_vector, plain_data, URGENT_LENGTH, urgent_data, order_callback, urgent_data));
+            aes_hw_set_priority(AES_HW_PRIORITY_BULK);
+        }
+        __enable_irq();
+
+        while (aes_hw_async_pending() != 0) {
+        }
+        CHECK(async_result);
+        CHECK(memcmp(large_cipher, large_expected, LARGE_LENGTH) == 0);
+        if (steps != 0) {
+            CHECK(async_done == 2);
+            CHECK(async_order[0] == urgent_data && async_order[1] == large_cipher);
+            CHECK(memcmp(urgent_data, urgent_expected, URGENT_LENGTH) == 0);
+        } else {
+            CHECK(async_done == 1);
+        }
+    }
+}
+
+/**
+ * The pieces of a stream give the result of a single operation
+ */
+static void test_stream(void)
+{
+    uint32_t piece;
+
+    reference_ctr(init_vector, large_plain, LARGE_LENGTH, large_expected);
+    memset(large_cipher, 0, LARGE_LENGTH);
+    CHECK(aes_hw_stream_ctr_begin(&stream, key, init_vector));
+    for (uint32_t i = 0; i < LARGE_LENGTH; i += piece) {
+        piece = LARGE_LENGTH - i < LARGE_PIECE ? LARGE_LENGTH - i : LARGE_PIECE;
+        CHECK(aes_hw_stream_update(&stream, &large_plain[i], piece, &large_cipher[i]));
+    }
+    CHECK(aes_hw_stream_end(&stream, NULL));
+    CHECK(memcmp(large_cipher, large_expected, LARGE_LENGTH) == 0);
+
+    // a last partial block and a header
+    uint32_t length = LARGE_LENGTH - 5;
+    CHECK(aes_hw_gcm_aad_encrypt(key, init_vector, (const uint8_t*)auth_header, 10, large_plain, length, large_expected,
+            expected_mic));
+    memset(large_cipher, 0, LARGE_LENGTH);
+    memset(mic, 0, sizeof(mic));
+    CHECK(aes_hw_stream_gcm_begin(&stream, false, key, init_vector, (const uint8_t*)auth_header, 10));
+    for (uint32_t i = 0; i < length; i += piece) {
+        piece = length - i < LARGE_PIECE ? length - i : LARGE_PIECE;
+        CHECK(aes_hw_stream_update(&stream, &large_plain[i], piece, &large_cipher[i]));
+    }
+    CHECK(aes_hw_stream_end(&stream, mic));
+    CHECK(memcmp(large_cipher, large_expected, length) == 0);
+    CHECK(memcmp(mic, expected_mic, sizeof(mic)) == 0);
+
+    memset(large_expected, 0, LARGE_LENGTH);
+    memset(mic, 0, sizeof(mic));
+    CHECK(aes_hw_stream_gcm_begin(&stream, true, key, init_vector, (const uint8_t*)auth_header, 10));
+    CHECK(aes_hw_stream_update(&stream, large_cipher, length, large_expected));
+    CHECK(aes_hw_stream_end(&stream, mic));
+    CHECK(memcmp(large_expected, large_plain, length) == 0);
+    CHECK(memcmp(mic, expected_mic, sizeof(mic)) == 0);
+
+    // nothing after a partial piece, the stream can still be ended
+    CHECK(aes_hw_stream_ctr_begin(&stream, key, init_vector));
+    CHECK(aes_hw_stream_update(&stream, large_plain, 13, large_cipher));
+    CHECK(!aes_hw_stream_update(&stream, large_plain + 13, AES_REF_BLOCK_SIZE, large_cipher + 13));
+    CHECK(aes_hw_stream_end(&stream, NULL));
+
+    // the peripheral is not given to a stream or a polling operation during
+    // a DMA operation
+    CHECK(aes_hw_ctr_encrypt_dma(key, init_vector, plain_data, LENGTH, cipher_data));
+    CHECK(!aes_hw_stream_ctr_begin(&stream, key, init_vector));
+    CHECK(!aes_hw_ctr_encrypt(key, init_vector, plain_data, LENGTH, output));
+    CHECK(!aes_hw_gcm_encrypt(key, gcm_init_vector, plain_data, LENGTH, output, mic));
+    CHECK(aes_hw_wait());
+}
+
+/**
+ * The fragments give the result of the contiguous message, out of place and
+ * in place
+ */
+static void test_fragments(void)
+{
+    uint32_t length = 0;
+
+    for (uint32_t i = 0; i < FRAGMENT_NUMBER; i++) {
+        fragments[i].input = &plain_data[length];
+        fragments[i].output = &cipher_data[length];
+        fragments[i].length = fragment_lengths[i];
+        length += fragment_lengths[i];
+    }
+
+    reference_ctr(init_vector, plain_data, length, expected);
+    memset(cipher_data, 0, LENGTH);
+    CHECK(aes_hw_stream_ctr_begin(&stream, key, init_vector));
+    CHECK(aes_hw_stream_update_fragments(&stream, fragments, FRAGMENT_NUMBER));
+    CHECK(aes_hw_stream_end(&stream, NULL));
+    CHECK(memcmp(cipher_data, expected, length) == 0);
+
+    CHECK(aes_hw_gcm_aad_encrypt(key, init_vector, (const uint8_t*)auth_header, 10, plain_data, length, expected,
+            expected_mic));
+    memset(cipher_data, 0, LENGTH);
+    memset(mic, 0, sizeof(mic));
+    CHECK(aes_hw_stream_gcm_begin(&stream, false, key, init_vector, (const uint8_t*)auth_header, 10));
+    CHECK(aes_hw_stream_update_fragments(&stream, fragments, FRAGMENT_NUMBER));
+    CHECK(aes_hw_stream_end(&stream, mic));
+    CHECK(memcmp(cipher_data, expected, length) == 0);
+    CHECK(memcmp(mic, expected_mic, sizeof(mic)) == 0);
+
+    for (uint32_t i = 0; i < FRAGMENT_NUMBER; i++) {
+        fragments[i].input = fragments[i].output;
+    }
+    memset(mic, 0, sizeof(mic));
+    CHECK(aes_hw_stream_gcm_begin(&stream, true, key, init_vector, (const uint8_t*)auth_header, 10));
+    CHECK(aes_hw_stream_update_fragments(&stream, fragments, FRAGMENT_NUMBER));
+    CHECK(aes_hw_stream_end(&stream, mic));
+    CHECK(memcmp(cipher_data, plain_data, length) == 0);
+    CHECK(memcmp(mic, expected_mic, sizeof(mic)) == 0);
+}
+
+/**
+ * Every message of a batch, with its own nonce and header, gives the output of
+ * a separate call
+ * @param dma true to also run the batch by DMA
+ */
+static void test_batch(const uint32_t* lengths, bool dma)
+{
+    aes_sw_gcm_context_t context;
+    uint32_t offset = 0;
+
+    for (uint32_t i = 0; i < BATCH_NUMBER; i++) {
+        for (uint32_t j = 0; j < sizeof(batch_nonces[i]); j++) {
+            batch_nonces[i][j] = 0x10 * i + j;
+        }
+        batch[i].nonce = batch_nonces[i];
+        batch[i].aad = &plain_data[LENGTH - batch_aad_lengths[i]];
+        batch[i].aad_length = batch_aad_lengths[i];
+        batch[i].input = &plain_data[offset];
+        batch[i].output = &cipher_data[offset];
+        batch[i].length = lengths[i];
+        batch[i].tag = batch_tags[i];
+
+        CHECK(aes_hw_gcm_aad_encrypt(key, batch_nonces[i], batch[i].aad, batch[i].aad_length,
+                batch[i].input, lengths[i], &expected[offset], batch_expected_tags[i]));
+        offset += lengths[i];
+    }
+
+    memset(cipher_data, 0, LENGTH);
+    memset(batch_tags, 0, sizeof(batch_tags));
+    CHECK(aes_hw_gcm_encrypt_batch(key, batch, BATCH_NUMBER));
+    CHECK(memcmp(cipher_data, expected, offset) == 0);
+    CHECK(memcmp(batch_tags, batch_expected_tags, sizeof(batch_tags)) == 0);
+
+    memset(cipher_data, 0, LENGTH);
+    memset(batch_tags, 0, sizeof(batch_tags));
+    CHECK(aes_sw_set_key_size(key_size));
+    CHECK(aes_sw_gcm_context_init(&context, key, false));
+    CHECK(aes_sw_gcm_context_encrypt_batch(&context, batch, BATCH_NUMBER));
+    aes_sw_gcm_context_cleanup(&context);
+    CHECK(memcmp(cipher_data, expected, offset) == 0);
+    CHECK(memcmp(batch_tags, batch_expected_tags, sizeof(batch_tags)) == 0);
+
+    if (!dma) {
+        CHECK(!aes_hw_gcm_encrypt_batch_dma(key, batch, BATCH_NUMBER));
+        return;
+    }
+    memset(cipher_data, 0, LENGTH);
+    memset(batch_tags, 0, sizeof(batch_tags));
+    CHECK(aes_hw_gcm_encrypt_batch_dma(key, batch, BATCH_NUMBER));
+    CHECK(aes_hw_busy());
+    // the peripheral is not shared with a batch in polling
+    CHECK(!aes_hw_gcm_encrypt_batch(key, batch, BATCH_NUMBER));
+    CHECK(aes_hw_wait());
+    CHECK(memcmp(cipher_data, expected, offset) == 0);
+    CHECK(memcmp(batch_tags, batch_expected_tags, sizeof(batch_tags)) == 0);
+}
+
+/**
+ * GCM specification test cases 1 (no data) and 4 (20-byte header and 60-byte
+ * payload, both not aligned on a block)
+ */
+static void test_gcm_aad(void)
+{
+    uint8_t aad[20];
+    uint8_t tag[16];
+
+    memset(key, 0, sizeof(key));
+    memset(init_vector, 0, sizeof(init_vector));
+    test_hex("58e2fccefa7e3061367f1d57a4e7455a", expected_mic);
+    CHECK(aes_hw_gcm_aad_encrypt(key, init_vector, NULL, 0, NULL, 0, NULL, tag));
+    CHECK(memcmp(tag, expected_mic, sizeof(tag)) == 0);
+
+    test_hex("feffe9928665731c6d6a8f9467308308", key);
+    test_hex("cafebabefacedbaddecaf888", init_vector);
+    uint32_t aad_length = test_hex("feedfacedeadbeeffeedfacedeadbeefabaddad2", aad);
+    uint32_t length = test_hex("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+            "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39", plain_data);
+    test_hex("42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+            "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091", expected);
+    test_hex("5bc94fbc3221a5db94fae95ae7121a47", expected_mic);
+
+    // the bytes after the data must not be written
+    memset(cipher_data, 0xA5, LENGTH);
+    CHECK(aes_hw_gcm_aad_encrypt(key, init_vector, aad, aad_length, plain_data, length, cipher_data, tag));
+    CHECK(memcmp(cipher_data, expected, length) == 0);
+    CHECK(cipher_data[length] == 0xA5 && cipher_data[length + 3] == 0xA5);
+    CHECK(memcmp(tag, expected_mic, sizeof(tag)) == 0);
+
+    memset(output, 0xA5, LENGTH);
+    CHECK(aes_hw_gcm_aad_decrypt(key, init_vector, aad, aad_length, cipher_data, length, output, tag));
+    CHECK(memcmp(output, plain_data, length) == 0);
+    CHECK(output[length] == 0xA5);
+
+    // a wrong tag or header is rejected and the plain data cleared
+    tag[15] ^= 1;
+    CHECK(!aes_hw_gcm_aad_decrypt(key, init_vector, aad, aad_length, cipher_data, length, output, tag));
+    CHECK(output[0] == 0 && output[length - 1] == 0);
+    tag[15] ^= 1;
+    aad[0] ^= 1;
+    CHECK(!aes_hw_gcm_aad_decrypt(key, init_vector, aad, aad_length, cipher_data, length, output, tag));
+}
+
+/**
+ * GCM specification test case 16, test case 4 with a 256 bits key
+ */
+static void test_gcm_aad_256(void)
+{
+    uint8_t aad[20];
+    uint8_t tag[16];
+
+    test_hex("feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308", key);
+    test_hex("cafebabefacedbaddecaf888", init_vector);
+    uint32_t aad_length = test_hex("feedfacedeadbeeffeedfacedeadbeefabaddad2", aad);
+    uint32_t length = test_hex("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+            "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39", plain_data);
+    test_hex("522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa"
+            "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662", expected);
+    test_hex("76fc6ece0f4e1768cddf8853bb2d551b", expected_mic);
+
+    CHECK(aes_hw_gcm_aad_encrypt(key, init_vector, aad, aad_length, plain_data, length, cipher_data, tag));
+    CHECK(memcmp(cipher_data, expected, length) == 0);
+    CHECK(memcmp(tag, expected_mic, sizeof(tag)) == 0);
+
+    CHECK(aes_hw_gcm_aad_decrypt(key, init_vector, aad, aad_length, cipher_data, length, output, tag));
+    CHECK(memcmp(output, plain_data, length) == 0);
+}
+
+/**
+ * SP 800-38C examples 1 to 3: the nonce, header, payload and tag sizes vary
+ */
+static void test_ccm(void)
+{
+    static const char* nonces[] = {"10111213141516", "1011121314151617", "101112131415161718191a1b"};
+    static const uint32_t aad_lengths[] = {8, 16, 20};
+    static const uint32_t lengths[] = {4, 16, 24};
+    static const char* results[] = {
+            "7162015b4dac255d",
+            "d2a1f0e051ea5f62081a7792073d593d1fc64fbfaccd",
+            "e3b201a9f5b71a7a9b1ceaeccd97e70b6176aad9a4428aa5484392fbc1b09951",
+    };
+    uint8_t nonce[13];
+    uint8_t aad[20];
+    uint8_t tag[16];
+
+    test_hex("404142434445464748494a4b4c4d4e4f", key);
+    for (uint32_t i = 0; i < sizeof(aad); i++) {
+        aad[i] = i;
+    }
+    for (uint32_t i = 0; i < LENGTH; i++) {
+        plain_data[i] = 0x20 + i;
+    }
+
+    for (uint32_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        uint32_t nonce_length = test_hex(nonces[i], nonce);
+        uint32_t length = lengths[i];
+        uint32_t tag_length = test_hex(results[i], expected) - length;
+
+        memset(cipher_data, 0xA5, LENGTH);
+        CHECK(aes_hw_ccm_encrypt(key, nonce, nonce_length, aad, aad_lengths[i], plain_data, length, cipher_data, tag, tag_length));
+        CHECK(memcmp(cipher_data, expected, length) == 0);
+        CHECK(cipher_data[length] == 0xA5);
+        CHECK(memcmp(tag, expected + length, tag_length) == 0);
+
+        CHECK(aes_hw_ccm_decrypt(key, nonce, nonce_length, aad, aad_lengths[i], cipher_data, length, output, tag, tag_length));
+        CHECK(memcmp(output, plain_data, length) == 0);
+
+        // a wrong tag is rejected and the plain data cleared
+        tag[0] ^= 1;
+        CHECK(!aes_hw_ccm_decrypt(key, nonce, nonce_length, aad, aad_lengths[i], cipher_data, length, output, tag, tag_length));
+        CHECK(output[0] == 0 && output[length - 1] == 0);
+    }
+
+    CHECK(!aes_hw_ccm_encrypt(key, nonce, 6, aad, 8, plain_data, 4, cipher_data, tag, 4));
+    CHECK(!aes_hw_ccm_encrypt(key, nonce, 7, aad, 8, plain_data, 4, cipher_data, tag, 5));
+}
+
+/**
+ * RFC 4493 examples: empty, one block, padded last block, four blocks
+ */
+static void test_cmac(void)
+{
+    static const uint32_t lengths[] = {0, 16, 40, 64};
+    static const char* tags[] = {
+            "bb1d6929e95937287fa37d129b756746",
+            "070a16b46b4d4144f79bdd9dd04a287c",
+            "dfa66747de9ae63030ca32611497c827",
+            "51f0bebf7e3b9d92fc49741779363cfe",
+    };
+    uint8_t tag[16];
+
+    test_hex("2b7e151628aed2a6abf7158809cf4f3c", key);
+    test_hex("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+            "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710", plain_data);
+
+    for (uint32_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        test_hex(tags[i], expected_mic);
+        CHECK(aes_hw_cmac_generate(key, plain_data, lengths[i], tag));
+        CHECK(memcmp(tag, expected_mic, sizeof(tag)) == 0);
+        CHECK(aes_hw_cmac_verify(key, plain_data, lengths[i], expected_mic));
+        expected_mic[15] ^= 1;
+        CHECK(!aes_hw_cmac_verify(key, plain_data, lengths[i], expected_mic));
+    }
+}
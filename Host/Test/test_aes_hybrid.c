@@ -0,0 +1,163 @@
+/**
+ ******************************************************************************
+ * @file    test_aes_hybrid.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   tests of the CTR split between the peripheral and CMOX
+ *
+ * The output is compared to the reference AES whatever the share, also when
+ * the 32 bits counter wraps in the part of CMOX.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "stm32l4xx_hal.h"
+
+#include "aes_hw.h"
+#include "aes_hybrid.h"
+#include "aes_ref.h"
+#include "aes_sw.h"
+#include "host.h"
+#include "test.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define LENGTH 4101 // a partial last block
+#define LENGTH_NUMBER 4
+#define SHARE_NUMBER 4
+#define TUNE_RUNS 8
+#define KEY_SIZE_NUMBER 2
+
+/* Private variables ---------------------------------------------------------*/
+
+static const uint32_t lengths[LENGTH_NUMBER] = {LENGTH, 4096, 250, 16};
+// the peripheral or CMOX alone, then split
+static const uint32_t shares[SHARE_NUMBER] = {0, AES_HYBRID_SHARE_ONE, AES_HYBRID_SHARE_ONE / 2, AES_HYBRID_SHARE_ONE / 3};
+static const uint32_t key_sizes[KEY_SIZE_NUMBER] = {16, 32};
+static uint32_t key_size;
+static uint8_t key[32];
+static uint8_t init_vector[16] __ALIGNED(4);
+static uint8_t plain_data[LENGTH] __ALIGNED(4);
+static uint8_t cipher_data[LENGTH] __ALIGNED(4);
+static uint8_t expected[LENGTH] __ALIGNED(4);
+
+static aes_hybrid_t hybrid;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void run(void);
+static void reference_ctr(const uint8_t* counter, const uint8_t* input, uint32_t length, uint8_t* output);
+static void test_shares(void);
+static void test_tune(void);
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    host_init();
+    host_run(run);
+    return test_result();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void run(void)
+{
+    HAL_Init();
+    aes_hw_init();
+    aes_sw_init();
+
+    for (uint32_t i = 0; i < LENGTH; i++) {
+        plain_data[i] = i;
+    }
+    for (uint32_t i = 0; i < sizeof(key); i++) {
+        key[i] = 0x40 + i;
+    }
+
+    for (uint32_t i = 0; i < KEY_SIZE_NUMBER; i++) {
+        key_size = key_sizes[i];
+        CHECK(aes_hw_set_key_size(key_size));
+        CHECK(aes_sw_set_key_size(key_size));
+        CHECK(aes_hybrid_init(&hybrid, key, key_size));
+        CHECK(hybrid.share == AES_HYBRID_SHARE_ONE / 2);
+        test_shares();
+        test_tune();
+        aes_hybrid_cleanup(&hybrid);
+    }
+    CHECK(!aes_hybrid_init(&hybrid, key, sizeof(hybrid.key) + 1));
+}
+
+static void reference_ctr(const uint8_t* counter, const uint8_t* input, uint32_t length, uint8_t* output)
+{
+    uint32_t round_keys[AES_REF_ROUND_KEYS_SIZE];
+    uint8_t block[AES_REF_BLOCK_SIZE];
+    uint8_t stream[AES_REF_BLOCK_SIZE];
+
+    aes_ref_expand_key(key, key_size, round_keys);
+    memcpy(block, counter, sizeof(block));
+    for (uint32_t i = 0; i < length; i += AES_REF_BLOCK_SIZE) {
+        aes_ref_encrypt(round_keys, key_size, block, stream);
+        for (uint32_t j = 0; j < AES_REF_BLOCK_SIZE && i + j < length; j++) {
+            output[i + j] = input[i + j] ^ stream[j];
+        }
+        // 32-bit counter, as the peripheral
+        for (int32_t j = AES_REF_BLOCK_SIZE - 1; j >= 12 && ++block[j] == 0; j--) {
+        }
+    }
+}
+
+/**
+ * Every share gives the output of a single engine, the counter of the second
+ * pass wraps after 16 blocks (in the part of the peripheral or of CMOX)
+ */
+static void test_shares(void)
+{
+    for (uint32_t wrap = 0; wrap < 2; wrap++) {
+        for (uint32_t i = 0; i < sizeof(init_vector); i++) {
+            init_vector[i] = i < 12 ? 0x80 + i : wrap ? 0xFF : 0;
+        }
+        init_vector[15] = wrap ? 0xF0 : 0;
+
+        for (uint32_t i = 0; i < LENGTH_NUMBER; i++) {
+            uint32_t length = lengths[i];
+
+            reference_ctr(init_vector, plain_data, length, expected);
+            for (uint32_t j = 0; j < SHARE_NUMBER; j++) {
+                hybrid.share = shares[j];
+                memset(cipher_data, 0, LENGTH);
+                CHECK(aes_hybrid_ctr_encrypt(&hybrid, init_vector, plain_data, length, cipher_data));
+                CHECK(memcmp(cipher_data, expected, length) == 0);
+                CHECK(!aes_hw_busy());
+            }
+        }
+    }
+}
+
+/**
+ * The share moves after every call and stays in the range where both
+ * engines are measured
+ */
+static void test_tune(void)
+{
+    reference_ctr(init_vector, plain_data, LENGTH, expected);
+    hybrid.share = AES_HYBRID_SHARE_ONE / 2;
+    for (uint32_t i = 0; i < TUNE_RUNS; i++) {
+        uint32_t share = hybrid.share;
+
+        memset(cipher_data, 0, LENGTH);
+        CHECK(aes_hybrid_ctr_encrypt(&hybrid, init_vector, plain_data, LENGTH, cipher_data));
+        CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+        CHECK(hybrid.share >= AES_HYBRID_SHARE_ONE / 16 && hybrid.share <= AES_HYBRID_SHARE_ONE - AES_HYBRID_SHARE_ONE / 16);
+        if (i == 0) {
+            CHECK(hybrid.share != share);
+        }
+    }
+}
@@ -0,0 +1,227 @@
+/**
+ ******************************************************************************
+ * @file    test_aes_model.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   tests of the AES peripheral model through the HAL CRYP driver
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "stm32l4xx_hal.h"
+
+#include "aes_model.h"
+#include "aes_ref.h"
+#include "host.h"
+#include "test.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define LENGTH 64
+
+/* Private variables ---------------------------------------------------------*/
+
+static CRYP_HandleTypeDef cryp;
+
+static uint8_t key[16] __ALIGNED(4);
+static uint8_t init_vector[16] __ALIGNED(4);
+static uint8_t header[32] __ALIGNED(4);
+static uint8_t input[LENGTH] __ALIGNED(4);
+static uint8_t output[LENGTH] __ALIGNED(4);
+static uint8_t expected[LENGTH] __ALIGNED(4);
+static uint8_t tag[16] __ALIGNED(4);
+static uint8_t expected_tag[16] __ALIGNED(4);
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void run(void);
+static bool setup(uint32_t operating_mode, uint32_t chaining_mode);
+static void test_ecb(void);
+static void test_cbc(void);
+static void test_ctr(void);
+static void test_gcm(void);
+static void test_accesses(void);
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    host_init();
+    host_run(run);
+    return test_result();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void run(void)
+{
+    HAL_Init();
+    __HAL_RCC_AES_CLK_ENABLE();
+    cryp.Instance = AES;
+
+    test_ecb();
+    test_cbc();
+    test_ctr();
+    test_gcm();
+    test_accesses();
+}
+
+static bool setup(uint32_t operating_mode, uint32_t chaining_mode)
+{
+    HAL_CRYP_DeInit(&cryp);
+    cryp.Init.DataType      = CRYP_DATATYPE_8B;
+    cryp.Init.KeySize       = CRYP_KEYSIZE_128B;
+    cryp.Init.OperatingMode = operating_mode;
+    cryp.Init.ChainingMode  = chaining_mode;
+    cryp.Init.KeyWriteFlag  = CRYP_KEY_WRITE_ENABLE;
+    cryp.Init.pKey          = key;
+    cryp.Init.pInitVect     = init_vector;
+    cryp.Init.Header        = NULL;
+    cryp.Init.HeaderSize    = 0;
+    cryp.Init.GCMCMACPhase  = CRYP_GCM_INIT_PHASE;
+    return HAL_CRYP_Init(&cryp) == HAL_OK;
+}
+
+/**
+ * FIPS-197 C.1, the decryption uses the key derivation of the peripheral
+ */
+static void test_ecb(void)
+{
+    test_hex("000102030405060708090a0b0c0d0e0f", key);
+    test_hex("00112233445566778899aabbccddeeff", input);
+    test_hex("69c4e0d86a7b0430d8cdb78070b4c55a", expected);
+
+    CHECK(setup(CRYP_ALGOMODE_ENCRYPT, CRYP_CHAINMODE_AES_ECB));
+    CHECK(HAL_CRYPEx_AES(&cryp, input, 16, output, HAL_MAX_DELAY) == HAL_OK);
+    CHECK(memcmp(output, expected, 16) == 0);
+
+    CHECK(setup(CRYP_ALGOMODE_KEYDERIVATION_DECRYPT, CRYP_CHAINMODE_AES_ECB));
+    CHECK(HAL_CRYPEx_AES(&cryp, expected, 16, output, HAL_MAX_DELAY) == HAL_OK);
+    CHECK(memcmp(output, input, 16) == 0);
+}
+
+/**
+ * SP 800-38A F.2.1 and F.2.2
+ */
+static void test_cbc(void)
+{
+    test_hex("2b7e151628aed2a6abf7158809cf4f3c", key);
+    test_hex("000102030405060708090a0b0c0d0e0f", init_vector);
+    test_hex("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+            "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710", input);
+    test_hex("7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2"
+            "73bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7", expected);
+
+    CHECK(setup(CRYP_ALGOMODE_ENCRYPT, CRYP_CHAINMODE_AES_CBC));
+    CHECK(HAL_CRYPEx_AES(&cryp, input, LENGTH, output, HAL_MAX_DELAY) == HAL_OK);
+    CHECK(memcmp(output, expected, LENGTH) == 0);
+
+    CHECK(setup(CRYP_ALGOMODE_KEYDERIVATION_DECRYPT, CRYP_CHAINMODE_AES_CBC));
+    CHECK(HAL_CRYPEx_AES(&cryp, expected, LENGTH, output, HAL_MAX_DELAY) == HAL_OK);
+    CHECK(memcmp(output, input, LENGTH) == 0);
+}
+
+/**
+ * SP 800-38A F.5.1
+ */
+static void test_ctr(void)
+{
+    test_hex("2b7e151628aed2a6abf7158809cf4f3c", key);
+    test_hex("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff", init_vector);
+    test_hex("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+            "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710", input);
+    test_hex("874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+            "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee", expected);
+
+    CHECK(setup(CRYP_ALGOMODE_ENCRYPT, CRYP_CHAINMODE_AES_CTR));
+    CHECK(HAL_CRYPEx_AES(&cryp, input, LENGTH, output, HAL_MAX_DELAY) == HAL_OK);
+    CHECK(memcmp(output, expected, LENGTH) == 0);
+}
+
+/**
+ * GCM specification test case 4 with the last payload block full: the
+ * 64-byte plaintext of test case 3 and the 20-byte header of test case 4
+ * (checked against the reference AES)
+ */
+static void test_gcm(void)
+{
+    uint32_t round_keys[AES_REF_ROUND_KEYS_SIZE];
+    uint8_t hash_key[16] = {0};
+    uint8_t hash[16] = {0};
+    uint8_t counter[16];
+    uint8_t lengths[16] = {0};
+
+    test_hex("feffe9928665731c6d6a8f9467308308", key);
+    test_hex("cafebabefacedbaddecaf88800000002", init_vector);
+    uint32_t header_size = test_hex("feedfacedeadbeeffeedfacedeadbeefabaddad2", header);
+    test_hex("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+            "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255", input);
+    test_hex("42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+            "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985", expected);
+
+    // tag = E(J0) xor GHASH(A || C || lengths)
+    aes_ref_expand_key(key, sizeof(key), round_keys);
+    aes_ref_encrypt(round_keys, sizeof(key), hash_key, hash_key);
+    aes_ref_ghash(hash, hash_key, header, header_size);
+    aes_ref_ghash(hash, hash_key, expected, LENGTH);
+    lengths[7] = header_size * 8;
+    lengths[14] = (LENGTH * 8) >> 8;
+    lengths[15] = (LENGTH * 8) & 0xFF;
+    aes_ref_ghash(hash, hash_key, lengths, sizeof(lengths));
+    memcpy(counter, init_vector, 12);
+    counter[12] = counter[13] = counter[14] = 0;
+    counter[15] = 1;
+    aes_ref_encrypt(round_keys, sizeof(key), counter, expected_tag);
+    for (uint32_t i = 0; i < sizeof(expected_tag); i++) {
+        expected_tag[i] ^= hash[i];
+    }
+
+    for (uint32_t operating_mode = CRYP_ALGOMODE_ENCRYPT; ; operating_mode = CRYP_ALGOMODE_DECRYPT) {
+        bool encrypt = operating_mode == CRYP_ALGOMODE_ENCRYPT;
+        CHECK(setup(operating_mode, CRYP_CHAINMODE_AES_GCM_GMAC));
+        cryp.Init.Header = header;
+        cryp.Init.HeaderSize = header_size;
+        CHECK(HAL_CRYPEx_AES_Auth(&cryp, NULL, 0, NULL, HAL_MAX_DELAY) == HAL_OK);
+        cryp.Init.GCMCMACPhase = CRYP_GCMCMAC_HEADER_PHASE;
+        CHECK(HAL_CRYPEx_AES_Auth(&cryp, NULL, 0, NULL, HAL_MAX_DELAY) == HAL_OK);
+        cryp.Init.GCMCMACPhase = CRYP_GCM_PAYLOAD_PHASE;
+        CHECK(HAL_CRYPEx_AES_Auth(&cryp, encrypt ? input : expected, LENGTH, output, HAL_MAX_DELAY) == HAL_OK);
+        cryp.Init.GCMCMACPhase = CRYP_GCMCMAC_FINAL_PHASE;
+        CHECK(HAL_CRYPEx_AES_Auth(&cryp, NULL, LENGTH, tag, HAL_MAX_DELAY) == HAL_OK);
+
+        CHECK(memcmp(output, encrypt ? expected : input, LENGTH) == 0);
+        CHECK(memcmp(tag, expected_tag, sizeof(tag)) == 0);
+        if (!encrypt) {
+            break;
+        }
+    }
+}
+
+/**
+ * DWT->CYCCNT counts the register accesses: each block of the polling ECB
+ * takes at least the 4 writes of DINR and the 4 reads of DOUTR
+ */
+static void test_accesses(void)
+{
+    aes_model_stats_t stats;
+
+    CHECK(setup(CRYP_ALGOMODE_ENCRYPT, CRYP_CHAINMODE_AES_ECB));
+    aes_model_reset_stats();
+    uint32_t start = host_get_accesses();
+    CHECK(HAL_CRYPEx_AES(&cryp, input, LENGTH, output, HAL_MAX_DELAY) == HAL_OK);
+    uint32_t accesses = host_get_accesses() - start;
+    aes_model_get_stats(&stats);
+
+    CHECK(stats.blocks == LENGTH / 16);
+    CHECK(stats.writes >= LENGTH / 4);
+    CHECK(stats.reads >= LENGTH / 4);
+    CHECK(accesses == stats.reads + stats.writes);
+}
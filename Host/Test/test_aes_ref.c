@@ -0,0 +1,136 @@
+/**
+ ******************************************************************************
+ * @file    test_aes_ref.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   known-answer tests of the reference AES (FIPS-197, GCM spec)
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "aes_ref.h"
+#include "test.h"
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct {
+    const char* key;
+    const char* cipher;
+} vector_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+// FIPS-197 appendix C, the plaintext is 00112233445566778899aabbccddeeff
+static const vector_t vectors[] = {
+    {"000102030405060708090a0b0c0d0e0f", "69c4e0d86a7b0430d8cdb78070b4c55a"},
+    {"000102030405060708090a0b0c0d0e0f1011121314151617", "dda97ca4864cdfe06eaf70a0ec0d7191"},
+    {"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", "8ea2b7ca516745bfeafc49904b496089"},
+};
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void test_vectors(void);
+static void test_derived_key(void);
+static void test_ghash(void);
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    test_vectors();
+    test_derived_key();
+    test_ghash();
+    return test_result();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void test_vectors(void)
+{
+    uint8_t plain[AES_REF_BLOCK_SIZE];
+    test_hex("00112233445566778899aabbccddeeff", plain);
+
+    for (uint32_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        uint8_t key[32];
+        uint8_t expected[AES_REF_BLOCK_SIZE];
+        uint8_t block[AES_REF_BLOCK_SIZE];
+        uint32_t round_keys[AES_REF_ROUND_KEYS_SIZE];
+
+        uint32_t key_size = test_hex(vectors[i].key, key);
+        test_hex(vectors[i].cipher, expected);
+        aes_ref_expand_key(key, key_size, round_keys);
+
+        aes_ref_encrypt(round_keys, key_size, plain, block);
+        CHECK(memcmp(block, expected, sizeof(block)) == 0);
+        aes_ref_decrypt(round_keys, key_size, block, block);
+        CHECK(memcmp(block, plain, sizeof(block)) == 0);
+    }
+}
+
+/**
+ * The expansion from the derived key gives the same schedule
+ */
+static void test_derived_key(void)
+{
+    for (uint32_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        uint8_t key[32];
+        uint8_t derived_key[32];
+        uint32_t round_keys[AES_REF_ROUND_KEYS_SIZE];
+        uint32_t derived_round_keys[AES_REF_ROUND_KEYS_SIZE];
+
+        uint32_t key_size = test_hex(vectors[i].key, key);
+        uint32_t words = 4 * (key_size / 4 + 7);
+        aes_ref_expand_key(key, key_size, round_keys);
+        aes_ref_derive_key(round_keys, key_size, derived_key);
+        aes_ref_expand_derived_key(derived_key, key_size, derived_round_keys);
+        CHECK(memcmp(round_keys, derived_round_keys, words * sizeof(uint32_t)) == 0);
+    }
+}
+
+/**
+ * GCM specification test case 2: zero key, IV and plaintext
+ */
+static void test_ghash(void)
+{
+    uint8_t key[16] = {0};
+    uint8_t zero[AES_REF_BLOCK_SIZE] = {0};
+    uint8_t hash_key[AES_REF_BLOCK_SIZE];
+    uint8_t hash[AES_REF_BLOCK_SIZE] = {0};
+    uint8_t cipher[AES_REF_BLOCK_SIZE];
+    uint8_t expected[AES_REF_BLOCK_SIZE];
+    uint32_t round_keys[AES_REF_ROUND_KEYS_SIZE];
+
+    aes_ref_expand_key(key, sizeof(key), round_keys);
+    aes_ref_encrypt(round_keys, sizeof(key), zero, hash_key);
+    test_hex("66e94bd4ef8a2c3b884cfa59ca342b2e", expected);
+    CHECK(memcmp(hash_key, expected, sizeof(expected)) == 0);
+
+    // C = E(K, inc32(J0)) xor 0
+    uint8_t counter[AES_REF_BLOCK_SIZE] = {0};
+    counter[15] = 2;
+    aes_ref_encrypt(round_keys, sizeof(key), counter, cipher);
+    test_hex("0388dace60b6a392f328c2b971b2fe78", expected);
+    CHECK(memcmp(cipher, expected, sizeof(expected)) == 0);
+
+    uint8_t lengths[AES_REF_BLOCK_SIZE] = {0};
+    lengths[15] = 128;
+    aes_ref_ghash(hash, hash_key, cipher, sizeof(cipher));
+    aes_ref_ghash(hash, hash_key, lengths, sizeof(lengths));
+
+    uint8_t tag[AES_REF_BLOCK_SIZE];
+    counter[15] = 1;
+    aes_ref_encrypt(round_keys, sizeof(key), counter, tag);
+    for (uint32_t i = 0; i < AES_REF_BLOCK_SIZE; i++) {
+        tag[i] ^= hash[i];
+    }
+    test_hex("ab6e47d42cec13bdf53a67b21257bddf", expected);
+    CHECK(memcmp(tag, expected, sizeof(expected)) == 0);
+}
@@ -0,0 +1,250 @@
+/**
+ ******************************************************************************
+ * @file    test_aes_select.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   tests of the engine selection
+ *
+ * Every engine gives the output of the one-shot CMOX functions, the choice
+ * follows the table, the length and the rate of the key changes.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "stm32l4xx_hal.h"
+
+#include "aes_hw.h"
+#include "aes_select.h"
+#include "aes_sw.h"
+#include "bench.h"
+#include "host.h"
+#include "test.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define LENGTH 1027 // a partial last block
+#define KEY_SIZE_NUMBER 3
+#define SLOW 1000000 // cycles of a call on an engine which must not be chosen
+#define KEY_RUNS 32
+
+/* Private variables ---------------------------------------------------------*/
+
+static const uint32_t key_sizes[KEY_SIZE_NUMBER] = {16, 24, 32};
+static uint8_t key[32];
+static uint8_t other_key[32];
+static uint8_t init_vector[16] __ALIGNED(4);
+static uint8_t plain_data[LENGTH] __ALIGNED(4);
+static uint8_t cipher_data[LENGTH] __ALIGNED(4);
+static uint8_t expected[LENGTH + 16] __ALIGNED(4); // the one-shot GCM adds the tag
+static uint8_t mic[16];
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void run(void);
+static void force(aes_select_engine_t engine);
+static void test_engines(uint32_t key_size);
+static void test_crossover(void);
+static void test_key_rate(void);
+static void test_calibrate(void);
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    host_init();
+    host_run(run);
+    return test_result();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void run(void)
+{
+    HAL_Init();
+    bench_init(0, 4);
+    aes_hw_init();
+    aes_sw_init();
+    aes_select_init();
+
+    for (uint32_t i = 0; i < LENGTH; i++) {
+        plain_data[i] = i;
+    }
+    for (uint32_t i = 0; i < sizeof(key); i++) {
+        key[i] = 0x40 + i;
+        other_key[i] = 0x80 + i;
+    }
+    for (uint32_t i = 0; i < sizeof(init_vector); i++) {
+        init_vector[i] = i < 12 ? 0xC0 + i : 0;
+    }
+
+    // the peripheral is chosen as long as the table is not set
+    CHECK(aes_select_choose(AES_SELECT_CTR, LENGTH) == AES_SELECT_HW);
+    CHECK(aes_select_choose(AES_SELECT_GCM, 0) == AES_SELECT_HW);
+
+    for (uint32_t i = 0; i < KEY_SIZE_NUMBER; i++) {
+        test_engines(key_sizes[i]);
+    }
+    CHECK(aes_select_set_key_size(16));
+    CHECK(!aes_select_set_key_size(20));
+
+    test_crossover();
+    test_key_rate();
+    test_calibrate();
+    aes_select_cleanup();
+}
+
+/**
+ * Set a table where only the engine is fast, for both modes
+ */
+static void force(aes_select_engine_t engine)
+{
+    aes_select_table_t table;
+
+    for (int m = 0; m < AES_SELECT_MODE_NUMBER; m++) {
+        for (int e = 0; e < AES_SELECT_ENGINE_NUMBER; e++) {
+            aes_select_cost_t* cost = &table.costs[m][e];
+            cost->slope_thousandths = 1000;
+            cost->intercept = e == engine ? 0 : SLOW;
+            cost->key_setup = 0;
+        }
+    }
+    aes_select_set_table(&table);
+}
+
+/**
+ * Every engine gives the same output, the 192 bits keys are only taken by
+ * CMOX, the FAST variant of aes_sw is kept
+ */
+static void test_engines(uint32_t key_size)
+{
+    CHECK(aes_select_set_key_size(key_size));
+    CHECK(aes_sw_ctr_encrypt(key, init_vector, plain_data, LENGTH, expected));
+
+    for (int e = 0; e < AES_SELECT_ENGINE_NUMBER; e++) {
+        force(e);
+        aes_select_reset_counters();
+        aes_select_engine_t engine = key_size == 24 && e == AES_SELECT_HW ? AES_SELECT_SW_FAST : e;
+
+        memset(cipher_data, 0, LENGTH);
+        CHECK(aes_select_ctr_encrypt(key, init_vector, plain_data, LENGTH, cipher_data));
+        CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+        CHECK(aes_select_get_counter(AES_SELECT_CTR, engine) == 1);
+        CHECK(aes_sw_get_variant() == AES_SW_FAST);
+    }
+
+    CHECK(aes_sw_gcm_encrypt(key, init_vector, plain_data, LENGTH, expected, NULL));
+
+    for (int e = 0; e < AES_SELECT_ENGINE_NUMBER; e++) {
+        force(e);
+        aes_select_reset_counters();
+        aes_select_engine_t engine = key_size == 24 && e == AES_SELECT_HW ? AES_SELECT_SW_FAST : e;
+
+        memset(cipher_data, 0, LENGTH);
+        memset(mic, 0, sizeof(mic));
+        CHECK(aes_select_gcm_encrypt(key, init_vector, plain_data, LENGTH, cipher_data, mic));
+        CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+        CHECK(memcmp(mic, expected + LENGTH, sizeof(mic)) == 0);
+        CHECK(aes_select_get_counter(AES_SELECT_GCM, engine) == 1);
+        CHECK(aes_select_get_counter(AES_SELECT_CTR, engine) == 0);
+    }
+}
+
+/**
+ * CMOX for the short messages, the peripheral above the crossover of the fits
+ */
+static void test_crossover(void)
+{
+    aes_select_table_t table;
+
+    memset(&table, 0, sizeof(table));
+    // crossover at 200 bytes: 2000 + 10 * 200 = 20 * 200
+    table.costs[AES_SELECT_CTR][AES_SELECT_HW].slope_thousandths = 10000;
+    table.costs[AES_SELECT_CTR][AES_SELECT_HW].intercept = 2000;
+    table.costs[AES_SELECT_CTR][AES_SELECT_SW_FAST].slope_thousandths = 20000;
+    table.costs[AES_SELECT_CTR][AES_SELECT_SW_SMALL].slope_thousandths = 30000;
+    // SMALL is faster only on the empty messages
+    table.costs[AES_SELECT_GCM][AES_SELECT_HW].intercept = SLOW;
+    table.costs[AES_SELECT_GCM][AES_SELECT_SW_FAST].slope_thousandths = 1000;
+    table.costs[AES_SELECT_GCM][AES_SELECT_SW_FAST].intercept = 100;
+    table.costs[AES_SELECT_GCM][AES_SELECT_SW_SMALL].slope_thousandths = 2000;
+    aes_select_set_table(&table);
+
+    CHECK(aes_select_choose(AES_SELECT_CTR, 16) == AES_SELECT_SW_FAST);
+    CHECK(aes_select_choose(AES_SELECT_CTR, 192) == AES_SELECT_SW_FAST);
+    CHECK(aes_select_choose(AES_SELECT_CTR, 208) == AES_SELECT_HW);
+    CHECK(aes_select_choose(AES_SELECT_CTR, LENGTH) == AES_SELECT_HW);
+    CHECK(aes_select_choose(AES_SELECT_GCM, 0) == AES_SELECT_SW_SMALL);
+    CHECK(aes_select_choose(AES_SELECT_GCM, LENGTH) == AES_SELECT_SW_FAST);
+
+    // CMOX while the peripheral is used by a DMA operation
+    CHECK(aes_hw_ctr_encrypt_dma(key, init_vector, plain_data, LENGTH, expected));
+    CHECK(aes_select_choose(AES_SELECT_CTR, LENGTH) == AES_SELECT_SW_FAST);
+    CHECK(aes_hw_wait());
+    CHECK(aes_select_choose(AES_SELECT_CTR, LENGTH) == AES_SELECT_HW);
+}
+
+/**
+ * The key setup of CMOX moves the choice to the peripheral when the key
+ * changes at every call, and back when the key is kept
+ */
+static void test_key_rate(void)
+{
+    aes_select_table_t table;
+
+    memset(&table, 0, sizeof(table));
+    table.costs[AES_SELECT_CTR][AES_SELECT_HW].intercept = 1000;
+    table.costs[AES_SELECT_CTR][AES_SELECT_SW_FAST].key_setup = 4000;
+    table.costs[AES_SELECT_CTR][AES_SELECT_SW_SMALL].intercept = SLOW;
+    aes_select_set_table(&table);
+    aes_select_cleanup();
+    aes_select_reset_counters();
+
+    CHECK(aes_sw_ctr_encrypt(key, init_vector, plain_data, LENGTH, expected));
+    for (uint32_t i = 0; i < KEY_RUNS; i++) {
+        CHECK(aes_select_ctr_encrypt(i % 2 ? key : other_key, init_vector, plain_data, LENGTH, cipher_data));
+    }
+    CHECK(aes_select_get_key_rate() > AES_SELECT_RATE_ONE / 2);
+    CHECK(aes_select_choose(AES_SELECT_CTR, LENGTH) == AES_SELECT_HW);
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+
+    for (uint32_t i = 0; i < KEY_RUNS; i++) {
+        CHECK(aes_select_ctr_encrypt(key, init_vector, plain_data, LENGTH, cipher_data));
+    }
+    CHECK(aes_select_get_key_rate() < AES_SELECT_RATE_ONE / 8);
+    CHECK(aes_select_choose(AES_SELECT_CTR, LENGTH) == AES_SELECT_SW_FAST);
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+
+    CHECK(aes_select_get_counter(AES_SELECT_CTR, AES_SELECT_HW) != 0);
+    CHECK(aes_select_get_counter(AES_SELECT_CTR, AES_SELECT_SW_FAST) != 0);
+    CHECK(aes_select_get_counter(AES_SELECT_CTR, AES_SELECT_SW_SMALL) == 0);
+    CHECK(aes_select_get_counter(AES_SELECT_CTR, AES_SELECT_HW)
+            + aes_select_get_counter(AES_SELECT_CTR, AES_SELECT_SW_FAST) == 2 * KEY_RUNS);
+}
+
+/**
+ * The measured table keeps the selected engines working, the peripheral
+ * takes time for every byte
+ */
+static void test_calibrate(void)
+{
+    CHECK(!aes_select_calibrate(key, plain_data, 16, cipher_data));
+    CHECK(aes_select_calibrate(key, plain_data, LENGTH, cipher_data));
+
+    const aes_select_table_t* table = aes_select_get_table();
+    CHECK(table->costs[AES_SELECT_CTR][AES_SELECT_HW].slope_thousandths > 0);
+    CHECK(table->costs[AES_SELECT_GCM][AES_SELECT_HW].slope_thousandths > 0);
+    CHECK(table->costs[AES_SELECT_CTR][AES_SELECT_HW].key_setup == 0);
+
+    CHECK(aes_sw_ctr_encrypt(key, init_vector, plain_data, LENGTH, expected));
+    memset(cipher_data, 0, LENGTH);
+    CHECK(aes_select_ctr_encrypt(key, init_vector, plain_data, LENGTH, cipher_data));
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+}
@@ -0,0 +1,224 @@
+/**
+ ******************************************************************************
+ * @file    test_aes_sw.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   tests of the software AES on the CMOX model
+ *
+ * The CBC is compared to the reference AES. Every operation done in place
+ * gives the output of separate buffers, with 128, 192 and 256 bits keys, the
+ * shifted buffers are rejected.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "stm32l4xx_hal.h"
+
+#include "aes_ref.h"
+#include "aes_sw.h"
+#include "host.h"
+#include "test.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define LENGTH 256
+#define PARTIAL_LENGTH 71 // a partial last block
+#define MIC_SIZE 16
+#define KEY_SIZE_NUMBER 3
+
+/* Private variables ---------------------------------------------------------*/
+
+static const uint32_t key_sizes[KEY_SIZE_NUMBER] = {16, 24, 32};
+static uint32_t key_size;
+static uint8_t key[32];
+static uint8_t init_vector[16];
+static uint8_t plain_data[LENGTH];
+// the one-shot GCM writes the tag after the data
+static uint8_t cipher_data[LENGTH + MIC_SIZE];
+static uint8_t output[LENGTH + MIC_SIZE];
+static uint8_t mic[MIC_SIZE];
+static uint8_t expected_mic[MIC_SIZE];
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void run(void);
+static void reference_cbc(const uint8_t* input, uint32_t length, uint8_t* output);
+static void test_cbc(void);
+static void test_in_place(void);
+static void test_in_place_contexts(void);
+static void test_shifted(void);
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    host_init();
+    host_run(run);
+    return test_result();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * CMOX enables the CRC clock, the registers are the ones of the host model
+ */
+static void run(void)
+{
+    HAL_Init();
+    aes_sw_init();
+
+    for (uint32_t i = 0; i < LENGTH; i++) {
+        plain_data[i] = i;
+    }
+    for (uint32_t i = 0; i < sizeof(key); i++) {
+        key[i] = 0x40 + i;
+    }
+    for (uint32_t i = 0; i < sizeof(init_vector); i++) {
+        init_vector[i] = i < 12 ? 0x80 + i : 0;
+    }
+
+    for (uint32_t i = 0; i < KEY_SIZE_NUMBER; i++) {
+        key_size = key_sizes[i];
+        CHECK(aes_sw_set_key_size(key_size));
+        test_cbc();
+        test_in_place();
+        test_in_place_contexts();
+    }
+    test_shifted();
+}
+
+static void reference_cbc(const uint8_t* input, uint32_t length, uint8_t* output)
+{
+    uint32_t round_keys[AES_REF_ROUND_KEYS_SIZE];
+    uint8_t block[AES_REF_BLOCK_SIZE];
+
+    aes_ref_expand_key(key, key_size, round_keys);
+    memcpy(block, init_vector, sizeof(block));
+    for (uint32_t i = 0; i < length; i += AES_REF_BLOCK_SIZE) {
+        for (uint32_t j = 0; j < AES_REF_BLOCK_SIZE; j++) {
+            block[j] ^= input[i + j];
+        }
+        aes_ref_encrypt(round_keys, key_size, block, &output[i]);
+        memcpy(block, &output[i], sizeof(block));
+    }
+}
+
+static void test_cbc(void)
+{
+    uint8_t expected[LENGTH];
+
+    reference_cbc(plain_data, LENGTH, expected);
+    memset(cipher_data, 0, LENGTH);
+    CHECK(aes_sw_cbc_encrypt(key, init_vector, plain_data, LENGTH, cipher_data));
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+
+    memset(output, 0, LENGTH);
+    CHECK(aes_sw_cbc_decrypt(key, init_vector, cipher_data, LENGTH, output));
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+
+    CHECK(!aes_sw_cbc_encrypt(key, init_vector, plain_data, LENGTH - 1, cipher_data));
+}
+
+/**
+ * The one-shot functions with the input as output, then undone in place
+ */
+static void test_in_place(void)
+{
+    CHECK(aes_sw_ctr_encrypt(key, init_vector, plain_data, PARTIAL_LENGTH, cipher_data));
+    memcpy(output, plain_data, LENGTH);
+    CHECK(aes_sw_ctr_encrypt(key, init_vector, output, PARTIAL_LENGTH, output));
+    CHECK(memcmp(output, cipher_data, PARTIAL_LENGTH) == 0);
+    CHECK(aes_sw_ctr_decrypt(key, init_vector, output, PARTIAL_LENGTH, output));
+    CHECK(memcmp(output, plain_data, PARTIAL_LENGTH) == 0);
+
+    CHECK(aes_sw_cbc_encrypt(key, init_vector, plain_data, LENGTH, cipher_data));
+    CHECK(aes_sw_cbc_encrypt(key, init_vector, output, LENGTH, output));
+    CHECK(memcmp(output, cipher_data, LENGTH) == 0);
+    CHECK(aes_sw_cbc_decrypt(key, init_vector, output, LENGTH, output));
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+
+    // the tag follows the data in both buffers
+    CHECK(aes_sw_gcm_encrypt(key, init_vector, plain_data, PARTIAL_LENGTH, cipher_data, NULL));
+    CHECK(aes_sw_gcm_encrypt(key, init_vector, output, PARTIAL_LENGTH, output, NULL));
+    CHECK(memcmp(output, cipher_data, PARTIAL_LENGTH + MIC_SIZE) == 0);
+    CHECK(aes_sw_gcm_decrypt(key, init_vector, output, PARTIAL_LENGTH, output, NULL));
+    CHECK(memcmp(output, plain_data, PARTIAL_LENGTH) == 0);
+}
+
+/**
+ * The contexts and the batch with the input as output, the GCM tag is
+ * verified on the data decrypted in place
+ */
+static void test_in_place_contexts(void)
+{
+    aes_sw_ctr_context_t ctr;
+    aes_sw_gcm_context_t gcm_enc;
+    aes_sw_gcm_context_t gcm_dec;
+    aead_message_t message = {
+        .nonce = init_vector,
+        .aad = plain_data,
+        .aad_length = 20,
+        .input = plain_data,
+        .output = cipher_data,
+        .length = PARTIAL_LENGTH,
+        .tag = expected_mic,
+    };
+
+    CHECK(aes_sw_ctr_context_init(&ctr, key));
+    CHECK(aes_sw_ctr_context_encrypt(&ctr, init_vector, plain_data, LENGTH, cipher_data));
+    memcpy(output, plain_data, LENGTH);
+    CHECK(aes_sw_ctr_context_encrypt(&ctr, init_vector, output, LENGTH, output));
+    CHECK(memcmp(output, cipher_data, LENGTH) == 0);
+    aes_sw_ctr_context_cleanup(&ctr);
+
+    CHECK(aes_sw_gcm_context_init(&gcm_enc, key, false));
+    CHECK(aes_sw_gcm_context_init(&gcm_dec, key, true));
+    CHECK(aes_sw_gcm_context_encrypt(&gcm_enc, init_vector, plain_data, LENGTH, cipher_data, expected_mic));
+    memcpy(output, plain_data, LENGTH);
+    CHECK(aes_sw_gcm_context_encrypt(&gcm_enc, init_vector, output, LENGTH, output, mic));
+    CHECK(memcmp(output, cipher_data, LENGTH) == 0);
+    CHECK(memcmp(mic, expected_mic, MIC_SIZE) == 0);
+    CHECK(aes_sw_gcm_context_decrypt(&gcm_dec, init_vector, output, LENGTH, output, mic));
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+
+    CHECK(aes_sw_gcm_context_encrypt_batch(&gcm_enc, &message, 1));
+    message.input = output;
+    message.output = output;
+    message.tag = mic;
+    CHECK(aes_sw_gcm_context_encrypt_batch(&gcm_enc, &message, 1));
+    CHECK(memcmp(output, cipher_data, PARTIAL_LENGTH) == 0);
+    CHECK(memcmp(mic, expected_mic, MIC_SIZE) == 0);
+    aes_sw_gcm_context_cleanup(&gcm_enc);
+    aes_sw_gcm_context_cleanup(&gcm_dec);
+}
+
+/**
+ * An output shifted from the input, either way, is rejected and not written
+ */
+static void test_shifted(void)
+{
+    aes_sw_gcm_context_t gcm_enc;
+
+    CHECK(aes_sw_set_key_size(16));
+    key_size = 16;
+    memcpy(output, plain_data, LENGTH);
+
+    CHECK(!aes_sw_ctr_encrypt(key, init_vector, output, LENGTH - 16, output + 4));
+    CHECK(!aes_sw_cbc_decrypt(key, init_vector, output + 16, LENGTH - 16, output));
+    CHECK(!aes_sw_gcm_encrypt(key, init_vector, output, LENGTH - 32, output + 16, NULL));
+    CHECK(aes_sw_gcm_context_init(&gcm_enc, key, false));
+    CHECK(!aes_sw_gcm_context_encrypt(&gcm_enc, init_vector, output + 1, LENGTH - 16, output, mic));
+    aes_sw_gcm_context_cleanup(&gcm_enc);
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+
+    // adjacent buffers do not overlap
+    CHECK(aes_sw_ctr_encrypt(key, init_vector, output, LENGTH / 2, output + LENGTH / 2));
+}
@@ -0,0 +1,281 @@
+/**
+ ******************************************************************************
+ * @file    test_chachapoly.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   tests of the streaming ChaCha20-Poly1305
+ *
+ * The CMOX shim is checked against RFC 8439, then the context against the
+ * one-shot function for chunks of every kind of size.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "chachapoly.h"
+#include "cmox_crypto.h"
+
+#include "test.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define LENGTH 4096
+#define AAD_SIZE 16
+#define CHUNK_SIZE_NUMBER 6
+
+/* Private variables ---------------------------------------------------------*/
+
+// RFC 8439, 2.8.2
+static const char rfc_plain_data[] = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip "
+        "for the future, sunscreen would be it.";
+static const char rfc_key[] = "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f";
+static const char rfc_nonce[] = "070000004041424344454647";
+static const char rfc_aad[] = "50515253c0c1c2c3c4c5c6c7";
+static const char rfc_cipher_data[] = "d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d6"
+        "3dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b3692ddbd7f2d778b8c9803aee328091b58"
+        "fab324e4fad675945585808b4831d7bc3ff4def08e4b7a9de576d26586cec64b6116";
+static const char rfc_tag[] = "1ae10b594f09e26a7e902ecbd0600691";
+
+// key 0, 1, 2..., nonce a0, a1, a2..., data 0, 1, 2..., "0123456789ABCDEF"
+static const char last_cipher_data[] = "0284116c9ca7aec0602c24b715f2af8684c823f0e6639730bb9a9ef17292aa2f";
+static const char tag[] = "2a23eb6c94c68526ea67333e5fcf1e60";
+static const char empty_tag[] = "03b413aef83b384887a4d68052fd59aa"; // no data, no payload
+
+// whole ChaCha20 blocks or not, smaller and larger than a block
+static const uint32_t chunk_sizes[CHUNK_SIZE_NUMBER] = {1, 17, 60, 64, 100, 1024};
+
+static const uint8_t aad[AAD_SIZE + 1] = "0123456789ABCDEF";
+static uint8_t key[CHACHAPOLY_KEY_SIZE];
+static uint8_t nonce[CHACHAPOLY_NONCE_SIZE];
+static uint8_t plain_data[LENGTH];
+static uint8_t cipher_data[LENGTH + CHACHAPOLY_TAG_SIZE];
+static uint8_t output[LENGTH];
+static uint8_t expected[LENGTH];
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void test_rfc(void);
+static void test_oneshot(void);
+static void test_chunks(void);
+static void test_aad_chunks(void);
+static void test_in_place(void);
+static void test_errors(void);
+static bool stream(chachapoly_context_t* context, const uint8_t* input, uint8_t* output, uint32_t chunk_size);
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    for (uint32_t i = 0; i < CHACHAPOLY_KEY_SIZE; i++) {
+        key[i] = i;
+    }
+    for (uint32_t i = 0; i < CHACHAPOLY_NONCE_SIZE; i++) {
+        nonce[i] = 0xa0 + i;
+    }
+    for (uint32_t i = 0; i < LENGTH; i++) {
+        plain_data[i] = i;
+    }
+
+    test_rfc();
+    test_oneshot();
+    test_chunks();
+    test_aad_chunks();
+    test_in_place();
+    test_errors();
+    return test_result();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void test_rfc(void)
+{
+    uint8_t rfc_key_bytes[CHACHAPOLY_KEY_SIZE];
+    uint8_t rfc_nonce_bytes[CHACHAPOLY_NONCE_SIZE];
+    uint8_t rfc_aad_bytes[AAD_SIZE];
+    uint8_t mic[CHACHAPOLY_TAG_SIZE];
+    uint32_t length = sizeof(rfc_plain_data) - 1;
+    size_t computed = 0;
+
+    test_hex(rfc_key, rfc_key_bytes);
+    test_hex(rfc_nonce, rfc_nonce_bytes);
+    uint32_t aad_size = test_hex(rfc_aad, rfc_aad_bytes);
+    CHECK(test_hex(rfc_cipher_data, expected) == length);
+    test_hex(rfc_tag, mic);
+
+    CHECK(cmox_aead_encrypt(CMOX_CHACHAPOLY_ENC_ALGO, (const uint8_t*)rfc_plain_data, length, CHACHAPOLY_TAG_SIZE,
+            rfc_key_bytes, CHACHAPOLY_KEY_SIZE, rfc_nonce_bytes, CHACHAPOLY_NONCE_SIZE, rfc_aad_bytes, aad_size,
+            cipher_data, &computed) == CMOX_CIPHER_SUCCESS);
+    CHECK(computed == length + CHACHAPOLY_TAG_SIZE);
+    CHECK(memcmp(cipher_data, expected, length) == 0);
+    CHECK(memcmp(cipher_data + length, mic, CHACHAPOLY_TAG_SIZE) == 0);
+
+    CHECK(cmox_aead_decrypt(CMOX_CHACHAPOLY_DEC_ALGO, cipher_data, length + CHACHAPOLY_TAG_SIZE, CHACHAPOLY_TAG_SIZE,
+            rfc_key_bytes, CHACHAPOLY_KEY_SIZE, rfc_nonce_bytes, CHACHAPOLY_NONCE_SIZE, rfc_aad_bytes, aad_size,
+            output, &computed) == CMOX_CIPHER_AUTH_SUCCESS);
+    CHECK(computed == length);
+    CHECK(memcmp(output, rfc_plain_data, length) == 0);
+
+    // a modified cipher text is not output
+    cipher_data[0] ^= 1;
+    CHECK(cmox_aead_decrypt(CMOX_CHACHAPOLY_DEC_ALGO, cipher_data, length + CHACHAPOLY_TAG_SIZE, CHACHAPOLY_TAG_SIZE,
+            rfc_key_bytes, CHACHAPOLY_KEY_SIZE, rfc_nonce_bytes, CHACHAPOLY_NONCE_SIZE, rfc_aad_bytes, aad_size,
+            output, NULL) == CMOX_CIPHER_AUTH_FAIL);
+}
+
+static void test_oneshot(void)
+{
+    uint8_t mic[CHACHAPOLY_TAG_SIZE];
+
+    test_hex(last_cipher_data, expected);
+    test_hex(tag, mic);
+    CHECK(cmox_aead_encrypt(CMOX_CHACHAPOLY_ENC_ALGO, plain_data, LENGTH, CHACHAPOLY_TAG_SIZE, key,
+            CHACHAPOLY_KEY_SIZE, nonce, CHACHAPOLY_NONCE_SIZE, aad, AAD_SIZE, cipher_data, NULL) == CMOX_CIPHER_SUCCESS);
+    CHECK(memcmp(cipher_data + LENGTH - 32, expected, 32) == 0);
+    CHECK(memcmp(cipher_data + LENGTH, mic, CHACHAPOLY_TAG_SIZE) == 0);
+
+    test_hex(empty_tag, mic);
+    CHECK(cmox_aead_encrypt(CMOX_CHACHAPOLY_ENC_ALGO, plain_data, 0, CHACHAPOLY_TAG_SIZE, key,
+            CHACHAPOLY_KEY_SIZE, nonce, CHACHAPOLY_NONCE_SIZE, NULL, 0, output, NULL) == CMOX_CIPHER_SUCCESS);
+    CHECK(memcmp(output, mic, CHACHAPOLY_TAG_SIZE) == 0);
+}
+
+/**
+ * Every chunk size gives the output and the tag of the one-shot function, the
+ * key being set once for all the messages
+ */
+static void test_chunks(void)
+{
+    chachapoly_context_t encrypt;
+    chachapoly_context_t decrypt;
+    uint8_t mic[CHACHAPOLY_TAG_SIZE];
+
+    CHECK(cmox_aead_encrypt(CMOX_CHACHAPOLY_ENC_ALGO, plain_data, LENGTH, CHACHAPOLY_TAG_SIZE, key,
+            CHACHAPOLY_KEY_SIZE, nonce, CHACHAPOLY_NONCE_SIZE, aad, AAD_SIZE, cipher_data, NULL) == CMOX_CIPHER_SUCCESS);
+    CHECK(chachapoly_context_init(&encrypt, key, false));
+    CHECK(chachapoly_context_init(&decrypt, key, true));
+
+    for (int i = 0; i < CHUNK_SIZE_NUMBER; i++) {
+        memset(output, 0, sizeof(output));
+        CHECK(chachapoly_context_start(&encrypt, nonce));
+        CHECK(chachapoly_context_append_aad(&encrypt, aad, AAD_SIZE));
+        CHECK(stream(&encrypt, plain_data, output, chunk_sizes[i]));
+        CHECK(chachapoly_context_generate_tag(&encrypt, mic));
+        CHECK(memcmp(output, cipher_data, LENGTH) == 0);
+        CHECK(memcmp(mic, cipher_data + LENGTH, CHACHAPOLY_TAG_SIZE) == 0);
+
+        CHECK(chachapoly_context_start(&decrypt, nonce));
+        CHECK(chachapoly_context_append_aad(&decrypt, aad, AAD_SIZE));
+        CHECK(stream(&decrypt, output, output, chunk_sizes[i]));
+        CHECK(chachapoly_context_verify_tag(&decrypt, mic));
+        CHECK(memcmp(output, plain_data, LENGTH) == 0);
+    }
+
+    // the tag of a modified message is rejected
+    memcpy(output, cipher_data, LENGTH);
+    output[LENGTH - 1] ^= 1;
+    CHECK(chachapoly_context_start(&decrypt, nonce));
+    CHECK(chachapoly_context_append_aad(&decrypt, aad, AAD_SIZE));
+    CHECK(stream(&decrypt, output, output, 64));
+    CHECK(!chachapoly_context_verify_tag(&decrypt, &cipher_data[LENGTH]));
+
+    // a message which ends inside a block, a new nonce
+    nonce[0]++;
+    CHECK(cmox_aead_encrypt(CMOX_CHACHAPOLY_ENC_ALGO, plain_data, 1000, CHACHAPOLY_TAG_SIZE, key,
+            CHACHAPOLY_KEY_SIZE, nonce, CHACHAPOLY_NONCE_SIZE, aad, AAD_SIZE - 3, cipher_data, NULL)
+            == CMOX_CIPHER_SUCCESS);
+    CHECK(chachapoly_context_start(&encrypt, nonce));
+    CHECK(chachapoly_context_append_aad(&encrypt, aad, AAD_SIZE - 3));
+    CHECK(chachapoly_context_append(&encrypt, plain_data, 70, output));
+    CHECK(chachapoly_context_append(&encrypt, plain_data + 70, 930, output + 70));
+    CHECK(chachapoly_context_generate_tag(&encrypt, mic));
+    CHECK(memcmp(output, cipher_data, 1000) == 0);
+    CHECK(memcmp(mic, cipher_data + 1000, CHACHAPOLY_TAG_SIZE) == 0);
+    nonce[0]--;
+
+    chachapoly_context_cleanup(&encrypt);
+    chachapoly_context_cleanup(&decrypt);
+}
+
+static void test_aad_chunks(void)
+{
+    chachapoly_context_t encrypt;
+    uint8_t long_aad[200];
+    uint8_t mic[CHACHAPOLY_TAG_SIZE];
+
+    for (uint32_t i = 0; i < sizeof(long_aad); i++) {
+        long_aad[i] = 3 * i;
+    }
+    CHECK(cmox_aead_encrypt(CMOX_CHACHAPOLY_ENC_ALGO, plain_data, 100, CHACHAPOLY_TAG_SIZE, key,
+            CHACHAPOLY_KEY_SIZE, nonce, CHACHAPOLY_NONCE_SIZE, long_aad, sizeof(long_aad), cipher_data, NULL)
+            == CMOX_CIPHER_SUCCESS);
+
+    CHECK(chachapoly_context_init(&encrypt, key, false));
+    CHECK(chachapoly_context_start(&encrypt, nonce));
+    CHECK(chachapoly_context_append_aad(&encrypt, long_aad, 5));
+    CHECK(chachapoly_context_append_aad(&encrypt, long_aad + 5, 0));
+    CHECK(chachapoly_context_append_aad(&encrypt, long_aad + 5, 130));
+    CHECK(chachapoly_context_append_aad(&encrypt, long_aad + 135, 65));
+    CHECK(chachapoly_context_append(&encrypt, plain_data, 100, output));
+    CHECK(chachapoly_context_generate_tag(&encrypt, mic));
+    CHECK(memcmp(output, cipher_data, 100) == 0);
+    CHECK(memcmp(mic, cipher_data + 100, CHACHAPOLY_TAG_SIZE) == 0);
+    chachapoly_context_cleanup(&encrypt);
+}
+
+static void test_in_place(void)
+{
+    chachapoly_context_t encrypt;
+    uint8_t mic[CHACHAPOLY_TAG_SIZE];
+
+    CHECK(cmox_aead_encrypt(CMOX_CHACHAPOLY_ENC_ALGO, plain_data, LENGTH, CHACHAPOLY_TAG_SIZE, key,
+            CHACHAPOLY_KEY_SIZE, nonce, CHACHAPOLY_NONCE_SIZE, aad, AAD_SIZE, cipher_data, NULL) == CMOX_CIPHER_SUCCESS);
+    memcpy(output, plain_data, LENGTH);
+    CHECK(chachapoly_context_init(&encrypt, key, false));
+    CHECK(chachapoly_context_start(&encrypt, nonce));
+    CHECK(chachapoly_context_append_aad(&encrypt, aad, AAD_SIZE));
+    CHECK(stream(&encrypt, output, output, 17));
+    CHECK(chachapoly_context_generate_tag(&encrypt, mic));
+    CHECK(memcmp(output, cipher_data, LENGTH) == 0);
+    chachapoly_context_cleanup(&encrypt);
+}
+
+static void test_errors(void)
+{
+    chachapoly_context_t encrypt;
+    uint8_t mic[CHACHAPOLY_TAG_SIZE];
+
+    CHECK(chachapoly_context_init(&encrypt, key, false));
+    CHECK(chachapoly_context_start(&encrypt, nonce));
+
+    // a shifted output, the additional data after the payload
+    CHECK(!chachapoly_context_append(&encrypt, output, 64, output + 1));
+    CHECK(chachapoly_context_append(&encrypt, plain_data, 10, output));
+    CHECK(!chachapoly_context_append_aad(&encrypt, aad, AAD_SIZE));
+    CHECK(chachapoly_context_generate_tag(&encrypt, mic));
+    chachapoly_context_cleanup(&encrypt);
+
+    // the key of ChaCha20 is 256 bits
+    CHECK(cmox_aead_encrypt(CMOX_CHACHAPOLY_ENC_ALGO, plain_data, 64, CHACHAPOLY_TAG_SIZE, key, 16,
+            nonce, CHACHAPOLY_NONCE_SIZE, NULL, 0, cipher_data, NULL) == CMOX_CIPHER_ERR_BAD_PARAMETER);
+}
+
+/**
+ * Append the data in chunks, the last one can be shorter
+ */
+static bool stream(chachapoly_context_t* context, const uint8_t* input, uint8_t* output, uint32_t chunk_size)
+{
+    bool result = true;
+
+    for (uint32_t offset = 0; offset < LENGTH; offset += chunk_size) {
+        uint32_t chunk = LENGTH - offset < chunk_size ? LENGTH - offset : chunk_size;
+        result &= chachapoly_context_append(context, &input[offset], chunk, &output[offset]);
+    }
+    return result;
+}
@@ -0,0 +1,341 @@
+/**
+ ******************************************************************************
+ * @file    test_hash_ref.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   known-answer tests of the hashes and MACs of the host build
+ *
+ * Through the CMOX API of the shim: the digests of a message of several
+ * blocks, HMAC with a key longer than a block, the KMAC samples of
+ * SP 800-185 and the CMAC of RFC 4493. The handles fed by pieces of every
+ * size give the one-shot result.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "cmox_crypto.h"
+
+#include "test.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define LENGTH 300 // several blocks of every hash, a partial last one
+#define HMAC_KEY_SIZE 131 // longer than the blocks of 128 bytes
+#define MAX_SIZE 200 // longer than the rate of SHAKE128
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct {
+    const char* name;
+    const char* digest;
+} vector_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+// digests of the bytes 0, 1, 2... of LENGTH bytes, SHAKE128 on 32 bytes,
+// SHAKE256 on 64 bytes
+static const vector_t hash_vectors[] = {
+    {"SHA1", "bf77ecf143ceb21f1676c34b8d89c8bb3c43cc4e"},
+    {"SHA224", "0c82e586f274c06fe5393d20f3692908d3a78ff0034e4c221959f75a"},
+    {"SHA256", "7728ae2f2c36e2aaafbe79ca14c87ae2f89e7c88c4390ecbbf82dce88706958d"},
+    {"SM3", "11f3940f10ce70ef1f7bd8032b0a728b1124e52ce78c048f1090367776feb2e4"},
+    {"SHA384", "69672aca50c4279e4cdf788380294d7655bc68c7949e273318d60817f3262cff54e8c78ceaae0853e0a7adf36f392d38"},
+    {"SHA512", "f1dca2eb677b303265b0b9baff0e061202818f35c1470a69bbaa9bb66025e948"
+            "d90e565e69642506c6213aef3cf9e929357a59da263deb34d1236dbdcda279b3"},
+    {"SHA512_224", "482604d8459e2a3acfeaa168ce00427d87e67751748e4768666e318c"},
+    {"SHA512_256", "e8c6690786f704dcd81e091a37ade62feec7150ecdf56885de3c50c01136d17c"},
+    {"SHA3_224", "fc40ee40f2595a8ced1537bf5fb47d1ca83d6857007056f2b3eaee98"},
+    {"SHA3_256", "815c06bbeb8520ce61add33a5f47bc558bf00e6361a5640c972d5d4634c58101"},
+    {"SHA3_384", "47aefea93608f52318d433e3bc58bd296f9a88954a9ab47bd7e462468d59eeece908f5e861ee208a44c361831802f11e"},
+    {"SHA3_512", "fa288fe9f54b8301e3012051fb1b275fd3f278a281ef149bb878fd322a647d3f"
+            "51dc24908905550ed4883870c94f8d297f0690f8661b14d8222e9a46eebcbdf6"},
+    {"SHAKE128", "acbf138b9ceb3b4f0b2a78bf886f2f2b286af964f200f8784af97e6db5885558"},
+    {"SHAKE256", "bced6f4208dce0e6bc155ae057d0589bbfa798b46c7866d107e8d14aee3a46e9"
+            "a292d82d60f77802cadfa9a46c8142a7268863fbb6f64007d6e9fd44334f0ece"},
+};
+
+// HMAC of the same message with HMAC_KEY_SIZE bytes 0xaa
+static const vector_t hmac_vectors[] = {
+    {"SHA1", "bc685fabab754f5e3c715d4a3adfdeeaa2c9cf98"},
+    {"SHA224", "2176725cd5dcd06031b9bb27c60398e7a9e811c0e7f017a63abbc06d"},
+    {"SHA256", "03affe135c49e4dbf135ce52d9ea08edb964f097e888e27277f20aee48f87598"},
+    {"SHA384", "351e6f22b79e456ac1c24e5feb97af42dff0b12b26deb611364fe907bbe4cff3a8fc592cf4219930d4193164a8fe3bcb"},
+    {"SHA512", "16d69fdeea64bdee9c8eb9b4c9d0caf603d34fc8e00e7754370e6842619888f4"
+            "09dabec4959e83d3e1696c8eb611009b37b7272d1138f2be5822e285cff55802"},
+    {"SHA512_224", "e4f63a1f3efb969dbefcfcf12cd72ec300336199b7588c6360fe48f4"},
+    {"SHA512_256", "2b8b87329260617478ab79364dc395deac5f829bfbabfef2b843fe330a37a364"},
+    {"SM3", "da6a8cd11f7b47ea33c1e452cfbef8ba4f98436e2496ef2b049cad0d4b10a708"},
+};
+
+static uint8_t message[LENGTH];
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void test_hashes(void);
+static void test_hash_handles(void);
+static void check_hash_handle(cmox_hash_handle_t* hash, cmox_hash_algo_t algo, size_t size);
+static void test_hmac(void);
+static void test_kmac(void);
+static void test_cmac(void);
+static void test_mac_handles(void);
+static void check_mac_handle(cmox_mac_handle_t* mac, cmox_mac_algo_t algo, const uint8_t* key, size_t key_size,
+        const char* custom_data, size_t size);
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    for (uint32_t i = 0; i < LENGTH; i++) {
+        message[i] = i;
+    }
+
+    test_hashes();
+    test_hash_handles();
+    test_hmac();
+    test_kmac();
+    test_cmac();
+    test_mac_handles();
+    return test_result();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void test_hashes(void)
+{
+    const cmox_hash_algo_t algos[] = {
+        CMOX_SHA1_ALGO, CMOX_SHA224_ALGO, CMOX_SHA256_ALGO, CMOX_SM3_ALGO,
+        CMOX_SHA384_ALGO, CMOX_SHA512_ALGO, CMOX_SHA512_224_ALGO, CMOX_SHA512_256_ALGO,
+        CMOX_SHA3_224_ALGO, CMOX_SHA3_256_ALGO, CMOX_SHA3_384_ALGO, CMOX_SHA3_512_ALGO,
+        CMOX_SHAKE128_ALGO, CMOX_SHAKE256_ALGO,
+    };
+
+    for (uint32_t i = 0; i < sizeof(algos) / sizeof(algos[0]); i++) {
+        uint8_t expected[MAX_SIZE];
+        uint8_t digest[MAX_SIZE];
+        size_t computed = 0;
+
+        uint32_t size = test_hex(hash_vectors[i].digest, expected);
+        memset(digest, 0, sizeof(digest));
+        CHECK(cmox_hash_compute(algos[i], message, LENGTH, digest, size, &computed) == CMOX_HASH_SUCCESS);
+        CHECK(computed == size);
+        CHECK(memcmp(digest, expected, size) == 0);
+    }
+
+    // the truncated SHA-256, not longer than the digest but any size for SHAKE
+    uint8_t digest[MAX_SIZE];
+    uint8_t expected[MAX_SIZE];
+    test_hex(hash_vectors[2].digest, expected);
+    CHECK(cmox_hash_compute(CMOX_SHA256_ALGO, message, LENGTH, digest, 16, NULL) == CMOX_HASH_SUCCESS);
+    CHECK(memcmp(digest, expected, 16) == 0);
+    CHECK(cmox_hash_compute(CMOX_SHA256_ALGO, message, LENGTH, digest, 33, NULL) == CMOX_HASH_ERR_BAD_TAG_SIZE);
+    CHECK(cmox_hash_compute(CMOX_SHAKE128_ALGO, message, LENGTH, digest, MAX_SIZE, NULL) == CMOX_HASH_SUCCESS);
+}
+
+/**
+ * A handle of every family of hash
+ */
+static void test_hash_handles(void)
+{
+    cmox_sha1_handle_t sha1;
+    cmox_sha512_handle_t sha512;
+    cmox_sha3_handle_t sha3;
+    cmox_sm3_handle_t sm3;
+
+    check_hash_handle(cmox_sha1_construct(&sha1), CMOX_SHA1_ALGO, 20);
+    check_hash_handle(cmox_sha512_224_construct(&sha512), CMOX_SHA512_224_ALGO, 28);
+    check_hash_handle(cmox_sha3_384_construct(&sha3), CMOX_SHA3_384_ALGO, 48);
+    check_hash_handle(cmox_shake128_construct(&sha3), CMOX_SHAKE128_ALGO, MAX_SIZE);
+    check_hash_handle(cmox_sm3_construct(&sm3), CMOX_SM3_ALGO, 32);
+}
+
+/**
+ * The message is appended by pieces of 0, 1, 2... bytes
+ */
+static void check_hash_handle(cmox_hash_handle_t* hash, cmox_hash_algo_t algo, size_t size)
+{
+    uint8_t expected[MAX_SIZE];
+    uint8_t digest[MAX_SIZE];
+    size_t computed = 0;
+
+    CHECK(cmox_hash_compute(algo, message, LENGTH, expected, size, NULL) == CMOX_HASH_SUCCESS);
+
+    CHECK(cmox_hash_init(hash) == CMOX_HASH_SUCCESS);
+    CHECK(cmox_hash_setTagLen(hash, size) == CMOX_HASH_SUCCESS);
+    for (uint32_t offset = 0, piece = 0; offset < LENGTH; offset += piece, piece++) {
+        piece = piece < LENGTH - offset ? piece : LENGTH - offset;
+        CHECK(cmox_hash_append(hash, &message[offset], piece) == CMOX_HASH_SUCCESS);
+    }
+    memset(digest, 0, sizeof(digest));
+    CHECK(cmox_hash_generateTag(hash, digest, &computed) == CMOX_HASH_SUCCESS);
+    CHECK(computed == size);
+    CHECK(memcmp(digest, expected, size) == 0);
+    CHECK(cmox_hash_cleanup(hash) == CMOX_HASH_SUCCESS);
+}
+
+static void test_hmac(void)
+{
+    const cmox_mac_algo_t algos[] = {
+        CMOX_HMAC_SHA1_ALGO, CMOX_HMAC_SHA224_ALGO, CMOX_HMAC_SHA256_ALGO, CMOX_HMAC_SHA384_ALGO,
+        CMOX_HMAC_SHA512_ALGO, CMOX_HMAC_SHA512_224_ALGO, CMOX_HMAC_SHA512_256_ALGO, CMOX_HMAC_SM3_ALGO,
+    };
+    uint8_t key[HMAC_KEY_SIZE];
+
+    memset(key, 0xaa, sizeof(key));
+    for (uint32_t i = 0; i < sizeof(algos) / sizeof(algos[0]); i++) {
+        uint8_t expected[MAX_SIZE];
+        uint8_t tag[MAX_SIZE];
+
+        uint32_t size = test_hex(hmac_vectors[i].digest, expected);
+        CHECK(cmox_mac_compute(algos[i], message, LENGTH, key, sizeof(key), NULL, 0, tag, size, NULL) == CMOX_MAC_SUCCESS);
+        CHECK(memcmp(tag, expected, size) == 0);
+        CHECK(cmox_mac_verify(algos[i], message, LENGTH, key, sizeof(key), NULL, 0, expected, size) == CMOX_MAC_AUTH_SUCCESS);
+        expected[0] ^= 1;
+        CHECK(cmox_mac_verify(algos[i], message, LENGTH, key, sizeof(key), NULL, 0, expected, size) == CMOX_MAC_AUTH_FAIL);
+    }
+
+    // RFC 4231 test case 2, a key shorter than a block
+    uint8_t expected[32];
+    uint8_t tag[32];
+    const char* data = "what do ya want for nothing?";
+    test_hex("5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843", expected);
+    CHECK(cmox_mac_compute(CMOX_HMAC_SHA256_ALGO, (const uint8_t*)data, strlen(data),
+            (const uint8_t*)"Jefe", 4, NULL, 0, tag, sizeof(tag), NULL) == CMOX_MAC_SUCCESS);
+    CHECK(memcmp(tag, expected, sizeof(tag)) == 0);
+}
+
+/**
+ * Samples 1, 2 and 6 of SP 800-185, then the message of the other tests
+ */
+static void test_kmac(void)
+{
+    uint8_t key[32];
+    uint8_t data[200];
+    uint8_t expected[64];
+    uint8_t tag[64];
+    const char* custom_data = "My Tagged Application";
+
+    for (uint32_t i = 0; i < sizeof(key); i++) {
+        key[i] = 0x40 + i;
+    }
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = i;
+    }
+
+    test_hex("e5780b0d3ea6f7d3a429c5706aa43a00fadbd7d49628839e3187243f456ee14e", expected);
+    CHECK(cmox_mac_compute(CMOX_KMAC_128_ALGO, data, 4, key, sizeof(key), NULL, 0, tag, 32, NULL) == CMOX_MAC_SUCCESS);
+    CHECK(memcmp(tag, expected, 32) == 0);
+
+    test_hex("3b1fba963cd8b0b59e8c1a6d71888b7143651af8ba0a7070c0979e2811324aa5", expected);
+    CHECK(cmox_mac_compute(CMOX_KMAC_128_ALGO, data, 4, key, sizeof(key),
+            (const uint8_t*)custom_data, strlen(custom_data), tag, 32, NULL) == CMOX_MAC_SUCCESS);
+    CHECK(memcmp(tag, expected, 32) == 0);
+
+    test_hex("b58618f71f92e1d56c1b8c55ddd7cd188b97b4ca4d99831eb2699a837da2e4d9"
+            "70fbacfde50033aea585f1a2708510c32d07880801bd182898fe476876fc8965", expected);
+    CHECK(cmox_mac_compute(CMOX_KMAC_256_ALGO, data, sizeof(data), key, sizeof(key),
+            (const uint8_t*)custom_data, strlen(custom_data), tag, 64, NULL) == CMOX_MAC_SUCCESS);
+    CHECK(memcmp(tag, expected, 64) == 0);
+
+    test_hex("531d84438a6097d231b126a7bcd07db2aea277c910659b60c6ec0e4cd0707520", expected);
+    CHECK(cmox_mac_compute(CMOX_KMAC_128_ALGO, message, LENGTH, key, sizeof(key), NULL, 0, tag, 32, NULL) == CMOX_MAC_SUCCESS);
+    CHECK(memcmp(tag, expected, 32) == 0);
+    CHECK(cmox_mac_verify(CMOX_KMAC_128_ALGO, message, LENGTH, key, sizeof(key), NULL, 0, expected, 32) == CMOX_MAC_AUTH_SUCCESS);
+}
+
+/**
+ * RFC 4493, the empty message, a block and four blocks
+ */
+static void test_cmac(void)
+{
+    uint8_t key[16];
+    uint8_t data[64];
+    uint8_t expected[16];
+    uint8_t tag[16];
+
+    test_hex("2b7e151628aed2a6abf7158809cf4f3c", key);
+    test_hex("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+            "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710", data);
+
+    test_hex("bb1d6929e95937287fa37d129b756746", expected);
+    CHECK(cmox_mac_compute(CMOX_CMAC_AESFAST_ALGO, data, 0, key, sizeof(key), NULL, 0, tag, 16, NULL) == CMOX_MAC_SUCCESS);
+    CHECK(memcmp(tag, expected, 16) == 0);
+
+    test_hex("070a16b46b4d4144f79bdd9dd04a287c", expected);
+    CHECK(cmox_mac_compute(CMOX_CMAC_AESFAST_ALGO, data, 16, key, sizeof(key), NULL, 0, tag, 16, NULL) == CMOX_MAC_SUCCESS);
+    CHECK(memcmp(tag, expected, 16) == 0);
+
+    test_hex("51f0bebf7e3b9d92fc49741779363cfe", expected);
+    CHECK(cmox_mac_compute(CMOX_CMAC_AESSMALL_ALGO, data, 64, key, sizeof(key), NULL, 0, tag, 16, NULL) == CMOX_MAC_SUCCESS);
+    CHECK(memcmp(tag, expected, 16) == 0);
+
+    CHECK(cmox_mac_compute(CMOX_CMAC_AESFAST_ALGO, data, 64, key, 20, NULL, 0, tag, 16, NULL) == CMOX_MAC_ERR_BAD_PARAMETER);
+    CHECK(cmox_mac_compute(CMOX_CMAC_AESFAST_ALGO, data, 64, key, 16, NULL, 0, tag, 17, NULL) == CMOX_MAC_ERR_BAD_PARAMETER);
+}
+
+static void test_mac_handles(void)
+{
+    cmox_hmac_handle_t hmac;
+    cmox_kmac_handle_t kmac;
+    cmox_cmac_handle_t cmac;
+    uint8_t key[HMAC_KEY_SIZE];
+
+    memset(key, 0xaa, sizeof(key));
+    check_mac_handle(cmox_hmac_construct(&hmac, CMOX_HMAC_SHA256), CMOX_HMAC_SHA256_ALGO, key, sizeof(key), NULL, 32);
+    check_mac_handle(cmox_hmac_construct(&hmac, CMOX_HMAC_SHA384), CMOX_HMAC_SHA384_ALGO, key, 20, NULL, 48);
+    check_mac_handle(cmox_kmac_construct(&kmac, CMOX_KMAC_256), CMOX_KMAC_256_ALGO, key, 32, "OTA", 64);
+    check_mac_handle(cmox_cmac_construct(&cmac, CMOX_CMAC_AESFAST), CMOX_CMAC_AESFAST_ALGO, key, 32, NULL, 16);
+
+    // the key is needed before the data
+    cmox_mac_handle_t* mac = cmox_hmac_construct(&hmac, CMOX_HMAC_SHA256);
+    CHECK(cmox_mac_init(mac) == CMOX_MAC_SUCCESS);
+    CHECK(cmox_mac_append(mac, message, LENGTH) == CMOX_MAC_ERR_BAD_OPERATION);
+    CHECK(cmox_mac_cleanup(mac) == CMOX_MAC_SUCCESS);
+}
+
+/**
+ * The message is appended by pieces of 0, 1, 2... bytes, the tag is
+ * generated then verified by a second handle
+ */
+static void check_mac_handle(cmox_mac_handle_t* mac, cmox_mac_algo_t algo, const uint8_t* key, size_t key_size,
+        const char* custom_data, size_t size)
+{
+    const cmox_mac_vtable_t table = mac->table;
+    size_t custom_size = custom_data != NULL ? strlen(custom_data) : 0;
+    uint8_t expected[MAX_SIZE];
+    uint8_t tag[MAX_SIZE];
+    size_t computed = 0;
+
+    CHECK(cmox_mac_compute(algo, message, LENGTH, key, key_size, (const uint8_t*)custom_data, custom_size,
+            expected, size, NULL) == CMOX_MAC_SUCCESS);
+
+    for (int verify = 0; verify < 2; verify++) {
+        mac->table = table;
+        CHECK(cmox_mac_init(mac) == CMOX_MAC_SUCCESS);
+        CHECK(cmox_mac_setTagLen(mac, size) == CMOX_MAC_SUCCESS);
+        CHECK(cmox_mac_setCustomData(mac, (const uint8_t*)custom_data, custom_size) == CMOX_MAC_SUCCESS);
+        CHECK(cmox_mac_setKey(mac, key, key_size) == CMOX_MAC_SUCCESS);
+        for (uint32_t offset = 0, piece = 0; offset < LENGTH; offset += piece, piece++) {
+            piece = piece < LENGTH - offset ? piece : LENGTH - offset;
+            CHECK(cmox_mac_append(mac, &message[offset], piece) == CMOX_MAC_SUCCESS);
+        }
+        if (verify) {
+            uint32_t fault_check = 0;
+            CHECK(cmox_mac_verifyTag(mac, expected, &fault_check) == CMOX_MAC_AUTH_SUCCESS);
+            CHECK(fault_check == CMOX_MAC_AUTH_SUCCESS);
+        } else {
+            memset(tag, 0, sizeof(tag));
+            CHECK(cmox_mac_generateTag(mac, tag, &computed) == CMOX_MAC_SUCCESS);
+            CHECK(computed == size);
+            CHECK(memcmp(tag, expected, size) == 0);
+        }
+        CHECK(cmox_mac_cleanup(mac) == CMOX_MAC_SUCCESS);
+    }
+}
@@ -0,0 +1,350 @@
+/**
+ ******************************************************************************
+ * @file    test_legacy_v3.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   tests of the legacy_v3 cipher wrappers on the CMOX shim
+ *
+ * The wrappers are those of the Middlewares, the outputs are checked against
+ * SP 800-38A and SP 800-38C, the GCM against the one-shot function of the
+ * shim. The messages are appended in several pieces.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "cmox_crypto.h"
+#include "err_codes.h"
+#include "cipher/legacy_v3_aes_cbc.h"
+#include "cipher/legacy_v3_aes_ccm.h"
+#include "cipher/legacy_v3_aes_cfb.h"
+#include "cipher/legacy_v3_aes_ctr.h"
+#include "cipher/legacy_v3_aes_ecb.h"
+#include "cipher/legacy_v3_aes_gcm.h"
+#include "cipher/legacy_v3_aes_ofb.h"
+
+#include "test.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define LENGTH 64
+#define FIRST_PIECE 16 // the rest of the message is the second append
+#define BLOCK_SIZE 16
+#define GCM_IV_SIZE 12
+#define GCM_AAD_SIZE 20
+
+/* Private variables ---------------------------------------------------------*/
+
+// SP 800-38A
+static const char* const sp800_38a_key = "2b7e151628aed2a6abf7158809cf4f3c";
+static const char* const sp800_38a_plain = "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+        "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+
+static uint8_t key[32];
+static uint8_t init_vector[BLOCK_SIZE];
+static uint8_t plain_data[LENGTH];
+static uint8_t cipher_data[LENGTH];
+static uint8_t output[LENGTH + BLOCK_SIZE];
+static uint8_t expected[LENGTH + BLOCK_SIZE];
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void test_ecb(void);
+static void test_cbc(void);
+static void test_cfb(void);
+static void test_ofb(void);
+static void test_ctr(void);
+static void test_ccm(void);
+static void test_gcm(void);
+static void set_vector(const char* iv, const char* result);
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    test_ecb();
+    test_cbc();
+    test_cfb();
+    test_ofb();
+    test_ctr();
+    test_ccm();
+    test_gcm();
+    return test_result();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+ * SP 800-38A F.1.1 and F.1.2
+ */
+static void test_ecb(void)
+{
+    AESECBctx_stt context = {.mFlags = E_SK_DEFAULT, .mKeySize = CRL_AES128_KEY};
+    int32_t size = 0;
+
+    set_vector(NULL, "3ad77bb40d7a3660a89ecaf32466ef97f5d3d58503b9699de785895a96fdbaaf"
+            "43b1cd7f598ece23881b00e3ed0306887b0c785e27e8ad3f8223207104725dd4");
+
+    CHECK(AES_ECB_Encrypt_Init(&context, key, NULL) == AES_SUCCESS);
+    CHECK(AES_ECB_Encrypt_Append(&context, plain_data, FIRST_PIECE, cipher_data, &size) == AES_SUCCESS);
+    CHECK(size == FIRST_PIECE);
+    CHECK(AES_ECB_Encrypt_Append(&context, plain_data + FIRST_PIECE, LENGTH - FIRST_PIECE, cipher_data + FIRST_PIECE,
+            &size) == AES_SUCCESS);
+    CHECK(AES_ECB_Encrypt_Finish(&context, NULL, &size) == AES_SUCCESS);
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+
+    CHECK(AES_ECB_Decrypt_Init(&context, key, NULL) == AES_SUCCESS);
+    CHECK(AES_ECB_Decrypt_Append(&context, cipher_data, LENGTH, output, &size) == AES_SUCCESS);
+    CHECK(AES_ECB_Decrypt_Finish(&context, NULL, &size) == AES_SUCCESS);
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+
+    // whole blocks only
+    CHECK(AES_ECB_Encrypt_Init(&context, key, NULL) == AES_SUCCESS);
+    CHECK(AES_ECB_Encrypt_Append(&context, plain_data, FIRST_PIECE + 1, cipher_data, &size) != AES_SUCCESS);
+}
+
+/**
+ * SP 800-38A F.2.1 and F.2.2
+ */
+static void test_cbc(void)
+{
+    AESCBCctx_stt context = {.mFlags = E_SK_DEFAULT, .mKeySize = CRL_AES128_KEY, .mIvSize = BLOCK_SIZE};
+    int32_t size = 0;
+
+    set_vector("000102030405060708090a0b0c0d0e0f",
+            "7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2"
+            "73bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7");
+
+    CHECK(AES_CBC_Encrypt_Init(&context, key, init_vector) == AES_SUCCESS);
+    CHECK(AES_CBC_Encrypt_Append(&context, plain_data, FIRST_PIECE, cipher_data, &size) == AES_SUCCESS);
+    CHECK(AES_CBC_Encrypt_Append(&context, plain_data + FIRST_PIECE, LENGTH - FIRST_PIECE, cipher_data + FIRST_PIECE,
+            &size) == AES_SUCCESS);
+    CHECK(size == LENGTH - FIRST_PIECE);
+    CHECK(AES_CBC_Encrypt_Finish(&context, NULL, &size) == AES_SUCCESS);
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+
+    CHECK(AES_CBC_Decrypt_Init(&context, key, init_vector) == AES_SUCCESS);
+    CHECK(AES_CBC_Decrypt_Append(&context, cipher_data, FIRST_PIECE, output, &size) == AES_SUCCESS);
+    CHECK(AES_CBC_Decrypt_Append(&context, cipher_data + FIRST_PIECE, LENGTH - FIRST_PIECE, output + FIRST_PIECE,
+            &size) == AES_SUCCESS);
+    CHECK(AES_CBC_Decrypt_Finish(&context, NULL, &size) == AES_SUCCESS);
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+}
+
+/**
+ * SP 800-38A F.3.13 and F.3.14
+ */
+static void test_cfb(void)
+{
+    AESCFBctx_stt context = {.mFlags = E_SK_DEFAULT, .mKeySize = CRL_AES128_KEY, .mIvSize = BLOCK_SIZE};
+    int32_t size = 0;
+
+    set_vector("000102030405060708090a0b0c0d0e0f",
+            "3b3fd92eb72dad20333449f8e83cfb4ac8a64537a0b3a93fcde3cdad9f1ce58b"
+            "26751f67a3cbb140b1808cf187a4f4dfc04b05357c5d1c0eeac4c66f9ff7f2e6");
+
+    CHECK(AES_CFB_Encrypt_Init(&context, key, init_vector) == AES_SUCCESS);
+    CHECK(AES_CFB_Encrypt_Append(&context, plain_data, FIRST_PIECE, cipher_data, &size) == AES_SUCCESS);
+    CHECK(AES_CFB_Encrypt_Append(&context, plain_data + FIRST_PIECE, LENGTH - FIRST_PIECE, cipher_data + FIRST_PIECE,
+            &size) == AES_SUCCESS);
+    CHECK(AES_CFB_Encrypt_Finish(&context, NULL, &size) == AES_SUCCESS);
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+
+    CHECK(AES_CFB_Decrypt_Init(&context, key, init_vector) == AES_SUCCESS);
+    CHECK(AES_CFB_Decrypt_Append(&context, cipher_data, FIRST_PIECE, output, &size) == AES_SUCCESS);
+    CHECK(AES_CFB_Decrypt_Append(&context, cipher_data + FIRST_PIECE, LENGTH - FIRST_PIECE, output + FIRST_PIECE,
+            &size) == AES_SUCCESS);
+    CHECK(AES_CFB_Decrypt_Finish(&context, NULL, &size) == AES_SUCCESS);
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+}
+
+/**
+ * SP 800-38A F.4.1 and F.4.2, the last append has a partial block
+ */
+static void test_ofb(void)
+{
+    AESOFBctx_stt context = {.mFlags = E_SK_DEFAULT, .mKeySize = CRL_AES128_KEY, .mIvSize = BLOCK_SIZE};
+    int32_t size = 0;
+
+    set_vector("000102030405060708090a0b0c0d0e0f",
+            "3b3fd92eb72dad20333449f8e83cfb4a7789508d16918f03f53c52dac54ed825"
+            "9740051e9c5fecf64344f7a82260edcc304c6528f659c77866a510d9c1d6ae5e");
+
+    memset(cipher_data, 0, LENGTH);
+    CHECK(AES_OFB_Encrypt_Init(&context, key, init_vector) == AES_SUCCESS);
+    CHECK(AES_OFB_Encrypt_Append(&context, plain_data, FIRST_PIECE, cipher_data, &size) == AES_SUCCESS);
+    CHECK(AES_OFB_Encrypt_Append(&context, plain_data + FIRST_PIECE, LENGTH - FIRST_PIECE - 1,
+            cipher_data + FIRST_PIECE, &size) == AES_SUCCESS);
+    CHECK(size == LENGTH - FIRST_PIECE - 1);
+    CHECK(AES_OFB_Encrypt_Finish(&context, NULL, &size) == AES_SUCCESS);
+    CHECK(memcmp(cipher_data, expected, LENGTH - 1) == 0);
+    CHECK(cipher_data[LENGTH - 1] == 0);
+
+    CHECK(AES_OFB_Decrypt_Init(&context, key, init_vector) == AES_SUCCESS);
+    CHECK(AES_OFB_Decrypt_Append(&context, expected, LENGTH, output, &size) == AES_SUCCESS);
+    CHECK(AES_OFB_Decrypt_Finish(&context, NULL, &size) == AES_SUCCESS);
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+}
+
+/**
+ * SP 800-38A F.5.1 and F.5.2
+ */
+static void test_ctr(void)
+{
+    AESCTRctx_stt context = {.mFlags = E_SK_DEFAULT, .mKeySize = CRL_AES128_KEY, .mIvSize = BLOCK_SIZE};
+    int32_t size = 0;
+
+    set_vector("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff",
+            "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+            "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee");
+
+    CHECK(AES_CTR_Encrypt_Init(&context, key, init_vector) == AES_SUCCESS);
+    CHECK(AES_CTR_Encrypt_Append(&context, plain_data, FIRST_PIECE, cipher_data, &size) == AES_SUCCESS);
+    CHECK(AES_CTR_Encrypt_Append(&context, plain_data + FIRST_PIECE, LENGTH - FIRST_PIECE, cipher_data + FIRST_PIECE,
+            &size) == AES_SUCCESS);
+    CHECK(AES_CTR_Encrypt_Finish(&context, NULL, &size) == AES_SUCCESS);
+    CHECK(memcmp(cipher_data, expected, LENGTH) == 0);
+
+    CHECK(AES_CTR_Decrypt_Init(&context, key, init_vector) == AES_SUCCESS);
+    CHECK(AES_CTR_Decrypt_Append(&context, cipher_data, LENGTH, output, &size) == AES_SUCCESS);
+    CHECK(AES_CTR_Decrypt_Finish(&context, NULL, &size) == AES_SUCCESS);
+    CHECK(memcmp(output, plain_data, LENGTH) == 0);
+}
+
+/**
+ * SP 800-38C examples 1 to 3, the header and the payload of the last one in
+ * two appends, then a wrong tag
+ */
+static void test_ccm(void)
+{
+    static const char* nonces[] = {"10111213141516", "1011121314151617", "101112131415161718191a1b"};
+    static const int32_t aad_lengths[] = {8, 16, 20};
+    static const int32_t lengths[] = {4, 16, 24};
+    static const char* results[] = {
+            "7162015b4dac255d",
+            "d2a1f0e051ea5f62081a7792073d593d1fc64fbfaccd",
+            "e3b201a9f5b71a7a9b1ceaeccd97e70b6176aad9a4428aa5484392fbc1b09951",
+    };
+    uint8_t nonce[13];
+    uint8_t aad[20];
+    uint8_t tag[BLOCK_SIZE];
+
+    test_hex("404142434445464748494a4b4c4d4e4f", key);
+    for (uint32_t i = 0; i < sizeof(aad); i++) {
+        aad[i] = i;
+    }
+    for (uint32_t i = 0; i < LENGTH; i++) {
+        plain_data[i] = 0x20 + i;
+    }
+
+    for (uint32_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        int32_t length = lengths[i];
+        int32_t piece = length > BLOCK_SIZE ? BLOCK_SIZE : length;
+        int32_t aad_piece = aad_lengths[i] / 2;
+        AESCCMctx_stt context = {
+            .mFlags = E_SK_DEFAULT,
+            .mKeySize = CRL_AES128_KEY,
+            .mNonceSize = test_hex(nonces[i], nonce),
+            .mAssDataSize = aad_lengths[i],
+            .mPayloadSize = length,
+            .mTagSize = test_hex(results[i], expected) - length,
+        };
+        int32_t size = 0;
+
+        CHECK(AES_CCM_Encrypt_Init(&context, key, nonce) == AES_SUCCESS);
+        CHECK(AES_CCM_Header_Append(&context, aad, aad_piece) == AES_SUCCESS);
+        CHECK(AES_CCM_Header_Append(&context, aad + aad_piece, aad_lengths[i] - aad_piece) == AES_SUCCESS);
+        CHECK(AES_CCM_Encrypt_Append(&context, plain_data, piece, cipher_data, &size) == AES_SUCCESS);
+        CHECK(AES_CCM_Encrypt_Append(&context, plain_data + piece, length - piece, cipher_data + piece, &size)
+                == AES_SUCCESS);
+        CHECK(AES_CCM_Encrypt_Finish(&context, tag, &size) == AES_SUCCESS);
+        CHECK(size == context.mTagSize);
+        CHECK(memcmp(cipher_data, expected, length) == 0);
+        CHECK(memcmp(tag, expected + length, context.mTagSize) == 0);
+
+        context.pmTag = tag;
+        CHECK(AES_CCM_Decrypt_Init(&context, key, nonce) == AES_SUCCESS);
+        CHECK(AES_CCM_Header_Append(&context, aad, aad_lengths[i]) == AES_SUCCESS);
+        CHECK(AES_CCM_Decrypt_Append(&context, cipher_data, length, output, &size) == AES_SUCCESS);
+        CHECK(AES_CCM_Decrypt_Finish(&context, NULL, &size) == AUTHENTICATION_SUCCESSFUL);
+        CHECK(memcmp(output, plain_data, length) == 0);
+
+        tag[0] ^= 1;
+        CHECK(AES_CCM_Decrypt_Init(&context, key, nonce) == AES_SUCCESS);
+        CHECK(AES_CCM_Header_Append(&context, aad, aad_lengths[i]) == AES_SUCCESS);
+        CHECK(AES_CCM_Decrypt_Append(&context, cipher_data, length, output, &size) == AES_SUCCESS);
+        CHECK(AES_CCM_Decrypt_Finish(&context, NULL, &size) == AUTHENTICATION_FAILED);
+
+        // the tag once all the announced data are appended
+        CHECK(AES_CCM_Encrypt_Init(&context, key, nonce) == AES_SUCCESS);
+        CHECK(AES_CCM_Header_Append(&context, aad, aad_lengths[i]) == AES_SUCCESS);
+        CHECK(AES_CCM_Encrypt_Finish(&context, tag, &size) != AES_SUCCESS);
+    }
+}
+
+/**
+ * A message of several blocks and a partial one, 20 bytes of additional data
+ */
+static void test_gcm(void)
+{
+    AESGCMctx_stt context = {
+        .mFlags = E_SK_DEFAULT,
+        .mKeySize = CRL_AES128_KEY,
+        .mIvSize = GCM_IV_SIZE,
+        .mTagSize = BLOCK_SIZE,
+    };
+    uint8_t aad[GCM_AAD_SIZE];
+    uint8_t tag[BLOCK_SIZE];
+    int32_t size = 0;
+
+    for (uint32_t i = 0; i < sizeof(key); i++) {
+        key[i] = i;
+    }
+    for (uint32_t i = 0; i < sizeof(init_vector); i++) {
+        init_vector[i] = 0xc0 + i;
+    }
+    for (uint32_t i = 0; i < sizeof(aad); i++) {
+        aad[i] = 0xa0 + i;
+    }
+    for (uint32_t i = 0; i < LENGTH; i++) {
+        plain_data[i] = i;
+    }
+    CHECK(cmox_aead_encrypt(CMOX_AESFAST_GCMFAST_ENC_ALGO, plain_data, LENGTH - 1, BLOCK_SIZE, key, CRL_AES128_KEY,
+            init_vector, GCM_IV_SIZE, aad, GCM_AAD_SIZE, expected, NULL) == CMOX_CIPHER_SUCCESS);
+
+    CHECK(AES_GCM_Encrypt_Init(&context, key, init_vector) == AES_SUCCESS);
+    CHECK(AES_GCM_Header_Append(&context, aad, GCM_AAD_SIZE) == AES_SUCCESS);
+    CHECK(AES_GCM_Encrypt_Append(&context, plain_data, FIRST_PIECE, cipher_data, &size) == AES_SUCCESS);
+    CHECK(AES_GCM_Encrypt_Append(&context, plain_data + FIRST_PIECE, LENGTH - FIRST_PIECE - 1,
+            cipher_data + FIRST_PIECE, &size) == AES_SUCCESS);
+    CHECK(AES_GCM_Encrypt_Finish(&context, tag, &size) == AES_SUCCESS);
+    CHECK(memcmp(cipher_data, expected, LENGTH - 1) == 0);
+    CHECK(memcmp(tag, expected + LENGTH - 1, BLOCK_SIZE) == 0);
+
+    context.pmTag = tag;
+    CHECK(AES_GCM_Decrypt_Init(&context, key, init_vector) == AES_SUCCESS);
+    CHECK(AES_GCM_Header_Append(&context, aad, GCM_AAD_SIZE) == AES_SUCCESS);
+    CHECK(AES_GCM_Decrypt_Append(&context, cipher_data, LENGTH - 1, output, &size) == AES_SUCCESS);
+    CHECK(AES_GCM_Decrypt_Finish(&context, NULL, &size) == AUTHENTICATION_SUCCESSFUL);
+    CHECK(memcmp(output, plain_data, LENGTH - 1) == 0);
+}
+
+/**
+ * The SP 800-38A key and plain text, the IV if any and the expected output
+ */
+static void set_vector(const char* iv, const char* result)
+{
+    test_hex(sp800_38a_key, key);
+    test_hex(sp800_38a_plain, plain_data);
+    if (iv != NULL) {
+        test_hex(iv, init_vector);
+    }
+    test_hex(result, expected);
+}
@@ -0,0 +1,484 @@
+/**
+ ******************************************************************************
+ * @file    test_pk_ref.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   known-answer tests of the public key algorithms of the host build
+ *
+ * Through the CMOX API of the shim: ECDSA on P-256 and P-384 with a given k
+ * and ECDH, the Ed25519 sample of RFC 8032, the X25519 sample of RFC 7748
+ * and the RSA-2048 signatures PKCS#1 v1.5 and PSS of a fixed salt, with every
+ * window of the library. The vectors were computed with plain Python
+ * integers, the RSA key is the CRT one of the benchmark.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "cmox_crypto.h"
+
+#include "test.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define BUFFER_SIZE 12288
+#define MAX_SIZE 256
+#define MESSAGE_SIZE 64
+#define SALT_SIZE 32
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct {
+    const char* name;
+    size_t size;
+    const char* d;
+    const char* k;
+    const char* pub;
+    const char* sig;
+    const char* d2;
+    const char* pub2;
+    const char* secret;
+} ecdsa_vector_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+// SHA-256 of the bytes 0, 1, 2... of MESSAGE_SIZE bytes
+static const char digest_hex[] = "fdeab9acf3710362bd2658cdc9a29e8f9c757fcf9811603a8c447cd1d9151108";
+
+static const ecdsa_vector_t ecdsa_vectors[] = {
+    {"P-256", 32,
+        "f3f49249dc28ff90a5aec7978306d03bf38b2ffc80a4df5a51c9bc701e7ea41a",
+        "6bad6be28e7aa6e99f19950499dd251de512148239292d22e255accb1a466885",
+        "f8c06501f7a25f29914b521cae04a0454d4fee0af8dc1eee47100254031fd3f6"
+        "f3d87a13d33131c58cee443fc6c96824bd52a38adbb453ca46600646680c9f04",
+        "45f4600c8a058ddaea76061d9eb761b67b7799eb14fbf231d21bf31f95c60b8e"
+        "60cbfde6dabe770400b6f182a7ca5096725239aa5f6784ac70f747f3b3d3c65a",
+        "7dabe929c4a334bfc6cd75e9bb049a79d7a7a3cc8c3d5f169293de8fc88b2876",
+        "097d2406a589a4cfb7c9bc96b62f2367ecb42b9d661753774ffa0e89e9559075"
+        "155c8d8eb20e75602b2dabd1e318ee63bab7926fd837632a6db4a069bcacbf7c",
+        "57875edceaadf9587ee4fd51834e523f2abf4a5d984f218627e955b652bc36f0"
+        "637994ef77c70a31e49066fd2c0811a92f79a299cea13e96e5749430103091ff",
+    },
+    {"P-384", 48,
+        "1919e93ad11745ad498893101c593af514aa4e719d3c7dec00a61f933d6c51e3"
+        "70eb9a0a96263ae6c5e818fac0433cbe",
+        "59001ac9406329bc65b00a2d35d148805071950eadec6f117d836e77af67d461"
+        "e4163207d094499602f0ee99731c9453",
+        "337f1b2c879274b065bb68c114715c1d6c5af7c94443f21ecaf8121623ffb60a"
+        "ab143773c69d6513dc8d925f76b6085641c8befbbda7e8dfe697e91a2b9d6b62"
+        "85f85676779122244f3c10af3a7a56ab9ea8ad7cf8c85e2874f5eda91f4b2855",
+        "f5b193fe3ff88455c6c95ba3031b2f634136b6c33a8b5ea6889bdaf950b7badb"
+        "71922ea9b13a727e90fc7b0449205358b87dfaaeaa4c6f00deac1a652ef5317c"
+        "210de166c3f170de40c0d07309c4c6346f86ee56f69e58d01fb471cea2550dce",
+        "b91dddd91389b372a341738c837a7935bef7e268ffe976ab60581ccace1d62e0"
+        "5b4c8012ede7bd0cffb88309fadb8909",
+        "bd4bc69c791bb1b87b5577f18139ebeb30ae56d41397add8bd200e5c26a4014f"
+        "bab14fa350da057ef117ce5ac490b46d58010f2f6d5cc0bddaa70ff55711d4a7"
+        "013dc467b50a157391d0f644f39f2338b81097b7daf7c6098bd57d5aad8023e3",
+        "f10b1379ba64687cd85f00cd08f938a8217462fb451c101cb1f5204f17434698"
+        "a7292fb0d0b2e0dac61bbc14a77198a3708aac34376a13dc7abc4deb6bf406bf"
+        "9048cad04fd77c5f95d7e4331f851f35499fbe6f8b177e7286dc8574aa86f767",
+    },
+};
+
+// RFC 8032, section 7.1, test 1
+static const char rfc8032_seed[] = "9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60";
+static const char rfc8032_pub[] = "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a";
+static const char rfc8032_sig[] = "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e06522490155"
+        "5fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b";
+
+// the message of MESSAGE_SIZE bytes
+static const char ed25519_seed[] = "ae2d9593ea489e0cbcbaecd82eccff3bd9fbcb84d7f50c72421934dbf048f675";
+static const char ed25519_pub[] = "ab9b4c0799f3587a1264dd0e3c5127c7abba6dbc7d42687e057685ec4519e800";
+static const char ed25519_sig[] = "ecb3d3825de3ba5ec430102911350c5cb4be798659c7fa04421946230ef812fc"
+        "dcd2055b0207e871f64e852cf5c783091ba6d982ca07bc9ebbb8031060e9e90f";
+
+// RFC 7748, section 5.2, first sample
+static const char rfc7748_scalar[] = "a546e36bf0527c9d3b16154b82465edd62144c0ac1fc5a18506a2244ba449ac4";
+static const char rfc7748_u[] = "e6db6867583030db3594c1a424b15f7c726624ec26b3353b10a903a6d0ab1c4c";
+static const char rfc7748_output[] = "c3da55379de9c6908e94ea4df28d084f32eccf03491c71f754b4075577a28552";
+
+static const char x25519_private[] = "3ee9f080cd9df5cddd67968904104ceafab86685f8eefede1194a2ea32e084e7";
+static const char x25519_public[] = "8f30fafc3069a112cc527617bc3c8fe263e9a101467ad3df1b79c2fbdf8b944b";
+static const char x25519_peer[] = "ad5c9431e386639bdc996b4e03df6d4b5a57e6cd9015d40939de484498b1c05b";
+static const char x25519_secret[] = "6f7b65bc6c54bfec1da3f1a36bb80140abe30de51938f58308b674008c505f7a";
+
+// e = 65537, the signatures of digest_hex, the PSS salt is the bytes 0, 1, 2...
+static const char rsa_n[] = "a15cff8e25742c54c757805987a12d9cb11e2357409aeb4803c01a7e1b78f84b"
+        "dd73311a5b43254646b348de6d507de1b6ff79990ac5953d46df2916686e3faf"
+        "5eb9af674e7415adf47ea218d1e866898f9c4ea3bad1a450c2cd1b7341c635df"
+        "61f2e96978cdcfb824a7a79da8d6acfbef7a74cac8826f02c413823b15019425"
+        "c5c2db852e9d42ead3f5661995b365a9894bb26d2eda203f4aab30351a8ec2b7"
+        "03112e1170c4c237cd518f7280e96cb74455f1b16389cd77e84961b00a2dbc10"
+        "20e63d6d02e7d1f283e740ff872b0b1df6f8b8af604dedf77e5080abc5dd596b"
+        "563ab7d8b729c14aa0e373b253181601f48da189a8c61b0679387e4d88502489";
+static const char rsa_d[] = "747873dd5e1b64842cfe739e2bcfa2e49ed36a1ee87ae9a8a94c57d2fe716a87"
+        "17e8b56098cef670ab476d295f2de22eb1afe54d1a01539f4f3074afbfe11406"
+        "b910be128b062f3fc8623f0e3b34cc0e2ea25c00c22fdfb28b69108f38c2a0d0"
+        "041b196f0fcb3e4b63e9bf8a84fbaf1089e291ba6ccff8e0be3676a1be9fcd15"
+        "f1286bc1df2c34de0622cce5969d442e3c382405d7226beb19435ac579ab1a33"
+        "ffda84d82476a47fa25c1463ebeb2ab79b2fa8db3eb883cf7547173320ea7ed2"
+        "a3a17e6cf1d50b17f99ee5bb14cc403eb247ae353c46f4de88a352868a9a0521"
+        "9ac4f9fa222dc7a5d8d3db54adbe273297a9a360fe3a22622f5affe658991c81";
+static const char rsa_p[] = "cb71d2586b37d135df9428b3e131ab862dc008108fa3b15251559e3c24d4d83f"
+        "99506506db03ba652143c637f2bcb105921ba020513851caef3f321df1e5e430"
+        "1193d1757b69a18f2015be3c86931231bb6774887503039493fb43d8ce7de4d3"
+        "48b4dd07a08851079b9bf79aecf2f5f607642f844fe890bc4c864f84c2c963dd";
+static const char rsa_q[] = "cb0c41f6f9c8d38a4b18195fcc4da0f710b2c2508693a13435645ae5c1a3d094"
+        "cc84048e8a1233d1c4e27f95bb55f4f529081e556a03316d0562f55ef6a75a29"
+        "e82952fe95b9dd89f093208414f2158642b84598f17607d7167bb58feb343fc1"
+        "501e0d63b444210e807c694c78e04db7dad350f9160b8f1271fb7bf890e21e9d";
+static const char rsa_dp[] = "9f4edeeefbee7675e040cd6aa621d5f5b92791691e81891e33b07ebb0c005be1"
+        "d97539d71773a0e7061863447660c9a1da1aa5d608a3b870d7cdbdb9f32d18f5"
+        "871e203c05cade870c11daa8dc9c97f7b78f38928e4630ec8cc08a0d610cf63d"
+        "78c69ffa13fc0aaf916b9d85849c707c1aa79a09dae4fb4968071887965c4b45";
+static const char rsa_dq[] = "03c07f3b8c140ceca24498bb6f7003c86cf390a9a242fa1897dff9da0300feea"
+        "b0f8c388cabe595cc7f1937ff5cd39d089e88f7eee8d8e8d402b3af37d454c62"
+        "37db03a096adaf8d4bf7bc0314cc005fd1bdcbf36e8acacc4bab0f88d044cfe4"
+        "c7913698200d9e3ac15f0b271198bb76e9413c5ecdec7ac1517fdf2391b1cbf5";
+static const char rsa_iq[] = "4125565f783921b1e8fc1e75aeeef88e644d5bb26cfa447f09ff87a9113e679d"
+        "3275e11761f33bd60cb26d3324e8544a968c1bd6808a4d1ec8386f7403d40a41"
+        "76b50598ccbac53d3f6448499c5912743de6256ef5c1f3aa375ad0c14ac9bd1f"
+        "c60709955d1a886c51118501893b2541b8b82a37b29550244bcfdc925d2bfa7d";
+static const char rsa_v15[] = "73ccef7cf8accd79a478352956882d95f6001a1d41cad23125450c16d0d7ae9f"
+        "76c272c971583224f0c2361450e888f26c2b429c797fcde9ab901d814727fb20"
+        "7ed1176b0b2c5b236358d89be68d7aeb29930c4f6da8b60114d63ba5bb8f4988"
+        "d1673f254015ff11bed4497d701ab270d04ce363a7632d9ef5c00e49dc7647c5"
+        "cb76ae9bbc13df76680ed62a1601b62c63ae1d11a7f613bc2cbeafd6d09c878e"
+        "3211d0597ae97efd479b134b5e9eeb5f9ef88ca2ec803a967604854d26decd6c"
+        "556d63f018bc63ba20af1f3aa74d1229756f88073cbaa2c660ef55b8bbdecdf8"
+        "82788413ecc3fb0d515b3e97abfd59cee92feba3f5d0e377fcece038876b1769";
+static const char rsa_pss[] = "9e15a81b2980a629bf3ec884c66d620b02004e35166f432d17c53407042c14a6"
+        "9c4dcca5d84770379c619587e086d28f229f4320fd3ef07087e3ae6e5bea45d7"
+        "3661f737ed6efded7daffb869c851326f780fb906c75bfa53b71742775222a64"
+        "89cf59a98fed4664b1fe74389236839ac06558ef9f79768ae98f4d7f53b67c7f"
+        "1c1621cf2b9fba9486f61c2b60b09abc842cda60bb82b1dd1b5f83448294ecc8"
+        "6df79665dc909b4a193f907b019782ca56fd111be3097ed7f9f2feb4b0e56496"
+        "6b1381cca4fb03f019810475e9574b37e87fe7df1a11641bdc43c001501b533a"
+        "2b2a0d23119a507673c90997971d3576f1012a874cee8701d871a70d757e7b65";
+static const uint8_t rsa_e[] = {0x01, 0x00, 0x01};
+
+static uint8_t buffer[BUFFER_SIZE];
+static uint8_t digest[MAX_SIZE];
+static uint8_t message[MESSAGE_SIZE];
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void test_ecdsa(void);
+static void check_ecdsa(const ecdsa_vector_t* vector, cmox_ecc_impl_t impl, cmox_math_funcs_t math);
+static void test_eddsa(void);
+static void check_eddsa(cmox_ecc_impl_t impl, const char* seed_hex, const char* pub_hex, const char* sig_hex,
+        const uint8_t* input, size_t length);
+static void test_x25519(void);
+static void test_rsa(void);
+static void check_rsa_sign(cmox_modexp_func_t modexp, const cmox_rsa_key_t* key, const uint8_t* v15,
+        const uint8_t* pss, size_t size);
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    for (uint32_t i = 0; i < MESSAGE_SIZE; i++) {
+        message[i] = i;
+    }
+    test_hex(digest_hex, digest);
+
+    test_ecdsa();
+    test_eddsa();
+    test_x25519();
+    test_rsa();
+    return test_result();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void test_ecdsa(void)
+{
+    const cmox_ecc_impl_t impls[][2] = {
+        {CMOX_ECC_SECP256R1_LOWMEM, CMOX_ECC_SECP256R1_HIGHMEM},
+        {CMOX_ECC_SECP384R1_LOWMEM, CMOX_ECC_SECP384R1_HIGHMEM},
+    };
+    const cmox_math_funcs_t maths[] = {CMOX_MATH_FUNCS_SMALL, CMOX_MATH_FUNCS_FAST};
+
+    for (uint32_t i = 0; i < sizeof(ecdsa_vectors) / sizeof(ecdsa_vectors[0]); i++) {
+        for (uint32_t j = 0; j < 2; j++) {
+            for (uint32_t k = 0; k < sizeof(maths) / sizeof(maths[0]); k++) {
+                check_ecdsa(&ecdsa_vectors[i], impls[i][j], maths[k]);
+            }
+        }
+    }
+    check_ecdsa(&ecdsa_vectors[0], CMOX_ECC_SECP256R1_HIGHMEM, CMOX_MATH_FUNCS_SUPERFAST256);
+
+    // P-384 is too long for SUPERFAST256, Ed25519 does not sign with ECDSA
+    cmox_ecc_handle_t ctx;
+    uint8_t key[MAX_SIZE];
+    uint8_t pub[MAX_SIZE];
+    size_t key_size;
+    size_t pub_size;
+    memset(key, 0x11, sizeof(key));
+    cmox_ecc_construct(&ctx, CMOX_MATH_FUNCS_SUPERFAST256, buffer, BUFFER_SIZE);
+    CHECK(cmox_ecdsa_keyGen(&ctx, CMOX_ECC_SECP384R1_LOWMEM, key, 48, key, &key_size, pub, &pub_size)
+            == CMOX_ECC_ERR_MATHCURVE_MISMATCH);
+    CHECK(cmox_ecdsa_keyGen(&ctx, CMOX_ECC_ED25519_OPT_LOWMEM, key, 32, key, &key_size, pub, &pub_size)
+            == CMOX_ECC_ERR_ALGOCURVE_MISMATCH);
+    cmox_ecc_cleanup(&ctx);
+
+    // a private key not lower than n, then a buffer too short
+    memset(key, 0xFF, sizeof(key));
+    cmox_ecc_construct(&ctx, CMOX_MATH_FUNCS_FAST, buffer, BUFFER_SIZE);
+    CHECK(cmox_ecdsa_keyGen(&ctx, CMOX_ECC_SECP256R1_LOWMEM, key, 32, key, &key_size, pub, &pub_size)
+            == CMOX_ECC_ERR_WRONG_RANDOM);
+    cmox_ecc_cleanup(&ctx);
+    cmox_ecc_construct(&ctx, CMOX_MATH_FUNCS_FAST, buffer, 256);
+    CHECK(cmox_ecdsa_keyGen(&ctx, CMOX_ECC_SECP256R1_LOWMEM, key, 32, key, &key_size, pub, &pub_size)
+            == CMOX_ECC_ERR_MEMORY_FAIL);
+    cmox_ecc_cleanup(&ctx);
+}
+
+/**
+ * Key generation from d, signature with k, verification of the signature
+ * and of a modified one, then ECDH with the second key
+ */
+static void check_ecdsa(const ecdsa_vector_t* vector, cmox_ecc_impl_t impl, cmox_math_funcs_t math)
+{
+    cmox_ecc_handle_t ctx;
+    uint8_t d[MAX_SIZE];
+    uint8_t k[MAX_SIZE];
+    uint8_t expected[MAX_SIZE];
+    uint8_t output[MAX_SIZE];
+    uint8_t pub[MAX_SIZE];
+    size_t size = vector->size;
+    size_t computed = 0;
+    size_t pub_size = 0;
+    uint32_t fault_check = 0;
+
+    test_hex(vector->d, d);
+    test_hex(vector->k, k);
+    cmox_ecc_construct(&ctx, math, buffer, BUFFER_SIZE);
+
+    test_hex(vector->pub, expected);
+    CHECK(cmox_ecdsa_keyGen(&ctx, impl, d, size, output, &computed, pub, &pub_size) == CMOX_ECC_SUCCESS);
+    CHECK(computed == size && pub_size == 2 * size);
+    CHECK(memcmp(output, d, size) == 0);
+    CHECK(memcmp(pub, expected, 2 * size) == 0);
+    CHECK(ctx.membuf_str.MaxMemUsed > 0 && ctx.membuf_str.MemBufUsed == 0);
+
+    test_hex(vector->sig, expected);
+    CHECK(cmox_ecdsa_sign(&ctx, impl, k, size, d, size, digest, 32, output, &computed) == CMOX_ECC_SUCCESS);
+    CHECK(computed == 2 * size);
+    CHECK(memcmp(output, expected, 2 * size) == 0);
+
+    CHECK(cmox_ecdsa_verify(&ctx, impl, pub, 2 * size, digest, 32, output, 2 * size, &fault_check)
+            == CMOX_ECC_AUTH_SUCCESS);
+    CHECK(fault_check == CMOX_ECC_AUTH_SUCCESS);
+    output[size] ^= 1;
+    CHECK(cmox_ecdsa_verify(&ctx, impl, pub, 2 * size, digest, 32, output, 2 * size, &fault_check)
+            == CMOX_ECC_AUTH_FAIL);
+    pub[0] ^= 1;
+    CHECK(cmox_ecdsa_verify(&ctx, impl, pub, 2 * size, digest, 32, expected, 2 * size, NULL)
+            == CMOX_ECC_ERR_INVALID_PUBKEY);
+
+    test_hex(vector->pub2, pub);
+    test_hex(vector->secret, expected);
+    CHECK(cmox_ecdh(&ctx, impl, d, size, pub, 2 * size, output, &computed) == CMOX_ECC_SUCCESS);
+    CHECK(computed == 2 * size);
+    CHECK(memcmp(output, expected, 2 * size) == 0);
+    cmox_ecc_cleanup(&ctx);
+}
+
+static void test_eddsa(void)
+{
+    const cmox_ecc_impl_t impls[] = {
+        CMOX_ECC_ED25519_HIGHMEM, CMOX_ECC_ED25519_OPT_LOWMEM, CMOX_ECC_ED25519_OPT_HIGHMEM,
+    };
+
+    for (uint32_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+        check_eddsa(impls[i], rfc8032_seed, rfc8032_pub, rfc8032_sig, NULL, 0);
+        check_eddsa(impls[i], ed25519_seed, ed25519_pub, ed25519_sig, message, MESSAGE_SIZE);
+    }
+}
+
+/**
+ * Key generation from the seed, signature, verification of the signature
+ * and of a modified message
+ */
+static void check_eddsa(cmox_ecc_impl_t impl, const char* seed_hex, const char* pub_hex, const char* sig_hex,
+        const uint8_t* input, size_t length)
+{
+    cmox_ecc_handle_t ctx;
+    uint8_t seed[CMOX_ECC_ED25519_PRIVKEY_LEN];
+    uint8_t private_key[CMOX_ECC_ED25519_PRIVKEY_LEN];
+    uint8_t pub[CMOX_ECC_ED25519_PUBKEY_LEN];
+    uint8_t expected[CMOX_ECC_ED25519_SIG_LEN];
+    uint8_t sig[CMOX_ECC_ED25519_SIG_LEN];
+    uint8_t modified[MESSAGE_SIZE + 1];
+    size_t private_size = 0;
+    size_t pub_size = 0;
+    size_t sig_size = 0;
+    uint32_t fault_check = 0;
+
+    test_hex(seed_hex, seed);
+    cmox_ecc_construct(&ctx, CMOX_MATH_FUNCS_SUPERFAST256, buffer, BUFFER_SIZE);
+
+    test_hex(pub_hex, expected);
+    CHECK(cmox_eddsa_keyGen(&ctx, impl, seed, 32, private_key, &private_size, pub, &pub_size) == CMOX_ECC_SUCCESS);
+    CHECK(private_size == CMOX_ECC_ED25519_PRIVKEY_LEN && pub_size == CMOX_ECC_ED25519_PUBKEY_LEN);
+    CHECK(memcmp(pub, expected, CMOX_ECC_ED25519_PUBKEY_LEN) == 0);
+    CHECK(memcmp(private_key + 32, pub, CMOX_ECC_ED25519_PUBKEY_LEN) == 0);
+
+    test_hex(sig_hex, expected);
+    CHECK(cmox_eddsa_sign(&ctx, impl, private_key, private_size, input, length, sig, &sig_size) == CMOX_ECC_SUCCESS);
+    CHECK(sig_size == CMOX_ECC_ED25519_SIG_LEN);
+    CHECK(memcmp(sig, expected, CMOX_ECC_ED25519_SIG_LEN) == 0);
+
+    CHECK(cmox_eddsa_verify(&ctx, impl, pub, pub_size, input, length, sig, sig_size, &fault_check)
+            == CMOX_ECC_AUTH_SUCCESS);
+    CHECK(fault_check == CMOX_ECC_AUTH_SUCCESS);
+    memset(modified, 0, sizeof(modified));
+    if (length > 0) {
+        memcpy(modified, input, length);
+    }
+    CHECK(cmox_eddsa_verify(&ctx, impl, pub, pub_size, modified, length + 1, sig, sig_size, &fault_check)
+            == CMOX_ECC_AUTH_FAIL);
+    CHECK(fault_check == CMOX_ECC_AUTH_FAIL);
+    cmox_ecc_cleanup(&ctx);
+}
+
+static void test_x25519(void)
+{
+    cmox_ecc_handle_t ctx;
+    uint8_t scalar[CMOX_ECC_CURVE25519_PRIVKEY_LEN];
+    uint8_t u[CMOX_ECC_CURVE25519_PUBKEY_LEN];
+    uint8_t expected[CMOX_ECC_CURVE25519_SECRET_LEN];
+    uint8_t output[CMOX_ECC_CURVE25519_SECRET_LEN];
+    size_t size = 0;
+
+    cmox_ecc_construct(&ctx, CMOX_MATH_FUNCS_FAST, buffer, BUFFER_SIZE);
+    test_hex(rfc7748_scalar, scalar);
+    test_hex(rfc7748_u, u);
+    test_hex(rfc7748_output, expected);
+    CHECK(cmox_ecdh(&ctx, CMOX_ECC_CURVE25519, scalar, sizeof(scalar), u, sizeof(u), output, &size)
+            == CMOX_ECC_SUCCESS);
+    CHECK(size == CMOX_ECC_CURVE25519_SECRET_LEN);
+    CHECK(memcmp(output, expected, sizeof(output)) == 0);
+
+    // the public key is the product with u = 9
+    memset(u, 0, sizeof(u));
+    u[0] = 9;
+    test_hex(x25519_private, scalar);
+    test_hex(x25519_public, expected);
+    CHECK(cmox_ecdh(&ctx, CMOX_ECC_CURVE25519, scalar, sizeof(scalar), u, sizeof(u), output, &size)
+            == CMOX_ECC_SUCCESS);
+    CHECK(memcmp(output, expected, sizeof(output)) == 0);
+    test_hex(x25519_peer, u);
+    test_hex(x25519_secret, expected);
+    CHECK(cmox_ecdh(&ctx, CMOX_ECC_CURVE25519, scalar, sizeof(scalar), u, sizeof(u), output, &size)
+            == CMOX_ECC_SUCCESS);
+    CHECK(memcmp(output, expected, sizeof(output)) == 0);
+    cmox_ecc_cleanup(&ctx);
+}
+
+static void test_rsa(void)
+{
+    static uint8_t n[MAX_SIZE], d[MAX_SIZE], p[MAX_SIZE], q[MAX_SIZE], dp[MAX_SIZE], dq[MAX_SIZE], iq[MAX_SIZE];
+    uint8_t v15[MAX_SIZE];
+    uint8_t pss[MAX_SIZE];
+    uint8_t sig[MAX_SIZE];
+    cmox_rsa_key_t crt_key;
+    cmox_rsa_key_t private_key;
+    cmox_rsa_key_t public_key;
+    cmox_rsa_handle_t ctx;
+    uint32_t fault_check = 0;
+    size_t size = 0;
+
+    uint32_t n_size = test_hex(rsa_n, n);
+    test_hex(rsa_d, d);
+    uint32_t half = test_hex(rsa_p, p);
+    test_hex(rsa_q, q);
+    test_hex(rsa_dp, dp);
+    test_hex(rsa_dq, dq);
+    test_hex(rsa_iq, iq);
+    test_hex(rsa_v15, v15);
+    test_hex(rsa_pss, pss);
+
+    CHECK(cmox_rsa_setKeyCRT(&crt_key, 8 * n_size, dp, half, dq, half, p, half, q, half, iq, half)
+            == CMOX_RSA_SUCCESS);
+    CHECK(cmox_rsa_setKey(&private_key, n, n_size, d, n_size) == CMOX_RSA_SUCCESS);
+    CHECK(cmox_rsa_setKey(&public_key, n, n_size, rsa_e, sizeof(rsa_e)) == CMOX_RSA_SUCCESS);
+
+    const cmox_modexp_func_t modexps[] = {
+        CMOX_MODEXP_PRIVATE_LOWMEM, CMOX_MODEXP_PRIVATE_MIDMEM, CMOX_MODEXP_PRIVATE_HIGHMEM,
+    };
+    for (uint32_t i = 0; i < sizeof(modexps) / sizeof(modexps[0]); i++) {
+        check_rsa_sign(modexps[i], &crt_key, v15, pss, n_size);
+    }
+    check_rsa_sign(CMOX_MODEXP_PRIVATE_MIDMEM, &private_key, v15, pss, n_size);
+
+    // verification with the public key, a modified signature fails
+    cmox_rsa_construct(&ctx, CMOX_MATH_FUNCS_FAST, CMOX_MODEXP_PUBLIC, buffer, BUFFER_SIZE);
+    CHECK(cmox_rsa_pkcs1v15_verify(&ctx, &public_key, digest, CMOX_RSA_PKCS1V15_HASH_SHA256, v15, n_size,
+            &fault_check) == CMOX_RSA_AUTH_SUCCESS);
+    CHECK(fault_check == CMOX_RSA_AUTH_SUCCESS);
+    CHECK(cmox_rsa_pkcs1v22_verify(&ctx, &public_key, digest, CMOX_RSA_PKCS1V22_HASH_SHA256, SALT_SIZE, pss, n_size,
+            &fault_check) == CMOX_RSA_AUTH_SUCCESS);
+    CHECK(fault_check == CMOX_RSA_AUTH_SUCCESS);
+    memcpy(sig, v15, n_size);
+    sig[n_size - 1] ^= 1;
+    CHECK(cmox_rsa_pkcs1v15_verify(&ctx, &public_key, digest, CMOX_RSA_PKCS1V15_HASH_SHA256, sig, n_size,
+            &fault_check) == CMOX_RSA_AUTH_FAIL);
+    memcpy(sig, pss, n_size);
+    sig[n_size - 1] ^= 1;
+    CHECK(cmox_rsa_pkcs1v22_verify(&ctx, &public_key, digest, CMOX_RSA_PKCS1V22_HASH_SHA256, SALT_SIZE, sig, n_size,
+            &fault_check) == CMOX_RSA_AUTH_FAIL);
+    CHECK(cmox_rsa_pkcs1v15_verify(&ctx, &public_key, digest, CMOX_RSA_PKCS1V15_HASH_SHA1, v15, n_size,
+            &fault_check) == CMOX_RSA_AUTH_FAIL);
+
+    // the public modexp does not sign, SUPERFAST256 is for the curves only
+    CHECK(cmox_rsa_pkcs1v15_sign(&ctx, &crt_key, digest, CMOX_RSA_PKCS1V15_HASH_SHA256, sig, &size)
+            == CMOX_RSA_ERR_MEXP_ALGO_MISMATCH);
+    cmox_rsa_cleanup(&ctx);
+    cmox_rsa_construct(&ctx, CMOX_MATH_FUNCS_SUPERFAST256, CMOX_MODEXP_PUBLIC, buffer, BUFFER_SIZE);
+    CHECK(cmox_rsa_pkcs1v15_verify(&ctx, &public_key, digest, CMOX_RSA_PKCS1V15_HASH_SHA256, v15, n_size,
+            &fault_check) == CMOX_RSA_ERR_MATH_ALGO_MISMATCH);
+    cmox_rsa_cleanup(&ctx);
+}
+
+/**
+ * Both signatures, deterministic with the salt, then the peak of the buffer
+ * grows with the window
+ */
+static void check_rsa_sign(cmox_modexp_func_t modexp, const cmox_rsa_key_t* key, const uint8_t* v15,
+        const uint8_t* pss, size_t size)
+{
+    static size_t last_memory;
+    cmox_rsa_handle_t ctx;
+    uint8_t salt[SALT_SIZE];
+    uint8_t sig[MAX_SIZE];
+    size_t computed = 0;
+
+    for (uint32_t i = 0; i < SALT_SIZE; i++) {
+        salt[i] = i;
+    }
+
+    cmox_rsa_construct(&ctx, CMOX_MATH_FUNCS_SMALL, modexp, buffer, BUFFER_SIZE);
+    memset(sig, 0, sizeof(sig));
+    CHECK(cmox_rsa_pkcs1v15_sign(&ctx, key, digest, CMOX_RSA_PKCS1V15_HASH_SHA256, sig, &computed)
+            == CMOX_RSA_SUCCESS);
+    CHECK(computed == size);
+    CHECK(memcmp(sig, v15, size) == 0);
+    memset(sig, 0, sizeof(sig));
+    CHECK(cmox_rsa_pkcs1v22_sign(&ctx, key, digest, CMOX_RSA_PKCS1V22_HASH_SHA256, salt, SALT_SIZE, sig, &computed)
+            == CMOX_RSA_SUCCESS);
+    CHECK(memcmp(sig, pss, size) == 0);
+
+    CHECK(ctx.membuf_str.MaxMemUsed != last_memory && ctx.membuf_str.MemBufUsed == 0);
+    last_memory = ctx.membuf_str.MaxMemUsed;
+    cmox_rsa_cleanup(&ctx);
+}
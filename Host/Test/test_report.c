@@ -0,0 +1,219 @@
+/**
+ ******************************************************************************
+ * @file    test_report.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   tests of the binary frames of the results
+ *
+ * report.c is compiled here without REPORT_TEXT, the frames sent on the UART
+ * are captured and compared to frames built with the CRC32 of zlib.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "stm32l4xx_hal.h"
+
+#include "host.h"
+#include "logger.h"
+#include "report.h"
+#include "usart.h"
+#include "test.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define OUTPUT_SIZE 1024
+#define HEADER_SIZE 3 // start, type, payload length
+#define CRC_SIZE 4
+#define DATA_LENGTH 20
+#define MIC_SIZE 16
+#define RESULT_SIZE 39 // payload of a result frame
+#define COUNTER_SIZE 8 // payload of a counter frame
+#define NAME_NUMBER 300 // more than fit in a byte
+
+/* Private variables ---------------------------------------------------------*/
+
+// zlib.crc32(b"123456789")
+static const uint32_t check_crc = 0xCBF43926;
+
+// the name frame of "counter" (id 0), then its counter frame (256 bits, 7)
+static const char counter_frames[] = "a501090000636f756e746572a85f47ba" "a50408000000010700000060ce95c5";
+
+static uint8_t output[OUTPUT_SIZE];
+static uint32_t output_length;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void run(void);
+static void capture(const uint8_t* data, uint32_t length);
+static uint32_t reference_crc32(const uint8_t* data, uint32_t length);
+static uint32_t read32(const uint8_t* data);
+static void test_crc(void);
+static void test_counter(void);
+static void test_result_frame(void);
+static void test_names(void);
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    host_init();
+    host_run(run);
+    return test_result();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void run(void)
+{
+    HAL_Init();
+    MX_LPUART1_UART_Init();
+    logger_init();
+    report_init();
+    host_set_output(capture);
+
+    test_crc();
+    test_counter();
+    test_result_frame();
+    test_names();
+
+    host_set_output(NULL);
+}
+
+static void capture(const uint8_t* data, uint32_t length)
+{
+    if (output_length + length > OUTPUT_SIZE) {
+        length = OUTPUT_SIZE - output_length;
+    }
+    memcpy(&output[output_length], data, length);
+    output_length += length;
+}
+
+/**
+ * Bitwise CRC32 (zlib), reflected polynomial 0xEDB88320
+ */
+static uint32_t reference_crc32(const uint8_t* data, uint32_t length)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (crc & 1 ? 0xEDB88320 : 0);
+        }
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+static uint32_t read32(const uint8_t* data)
+{
+    return data[0] | data[1] << 8 | data[2] << 16 | (uint32_t)data[3] << 24;
+}
+
+static void test_crc(void)
+{
+    uint8_t data[256];
+
+    CHECK(report_crc32((const uint8_t*)"123456789", 9) == check_crc);
+    CHECK(reference_crc32((const uint8_t*)"123456789", 9) == check_crc);
+
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = 3 * i;
+    }
+    CHECK(report_crc32(data, sizeof(data)) == reference_crc32(data, sizeof(data)));
+    CHECK(report_crc32(data, 0) == 0);
+}
+
+/**
+ * The name is sent before its first record only
+ */
+static void test_counter(void)
+{
+    uint8_t expected[sizeof(counter_frames) / 2];
+    uint32_t length = test_hex(counter_frames, expected);
+
+    report_set_key_size(32);
+    output_length = 0;
+    report_counter("counter", 7);
+    CHECK(output_length == length);
+    CHECK(memcmp(output, expected, length) == 0);
+
+    // the counter frame only
+    output_length = 0;
+    report_counter("counter", 7);
+    CHECK(output_length == length - 16);
+    CHECK(memcmp(output, &expected[16], length - 16) == 0);
+}
+
+/**
+ * The fields of the result frame, the CRC of the output followed by the tag
+ */
+static void test_result_frame(void)
+{
+    bench_stats_t stats = {.min = 10, .median = 11, .p99 = 12, .stddev = 2, .outliers = 3};
+    uint8_t data[DATA_LENGTH + MIC_SIZE];
+
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = i;
+    }
+
+    report_set_key_size(16);
+    output_length = 0;
+    report_result_async("result", DATA_LENGTH, &stats, 100, 200, true, data, &data[DATA_LENGTH]);
+
+    // the name frame, id 1 after "counter"
+    const uint8_t* frame = output;
+    CHECK(frame[0] == REPORT_FRAME_START && frame[1] == REPORT_FRAME_NAME && frame[2] == 8);
+    CHECK(frame[HEADER_SIZE] == 1 && frame[HEADER_SIZE + 1] == 0);
+    CHECK(memcmp(&frame[HEADER_SIZE + 2], "result", 6) == 0);
+    CHECK(read32(&frame[HEADER_SIZE + 8]) == reference_crc32(&frame[HEADER_SIZE], 8));
+
+    frame += HEADER_SIZE + 8 + CRC_SIZE;
+    CHECK(output_length == (uint32_t)(frame - output) + HEADER_SIZE + RESULT_SIZE + CRC_SIZE);
+    CHECK(frame[0] == REPORT_FRAME_START && frame[1] == REPORT_FRAME_RESULT && frame[2] == RESULT_SIZE);
+
+    const uint8_t* record = &frame[HEADER_SIZE];
+    CHECK(record[0] == 1 && record[1] == 0 && record[2] == 1);
+    CHECK(record[3] == 3 && record[4] == 0); // outliers
+    CHECK(record[5] == 128 && record[6] == 0); // key bits
+    CHECK(read32(&record[7]) == DATA_LENGTH);
+    CHECK(read32(&record[11]) == 10 && read32(&record[15]) == 11 && read32(&record[19]) == 12);
+    CHECK(read32(&record[23]) == 2);
+    CHECK(read32(&record[27]) == 100 && read32(&record[31]) == 200);
+    CHECK(read32(&record[35]) == reference_crc32(data, sizeof(data)));
+    CHECK(read32(&record[RESULT_SIZE]) == reference_crc32(record, RESULT_SIZE));
+}
+
+/**
+ * Each new name gets the next id, past the 256 of a byte, a known name keeps its id
+ */
+static void test_names(void)
+{
+    char name[16];
+    bool ok = true;
+
+    for (uint32_t i = 0; i < NAME_NUMBER; i++) {
+        sprintf(name, "name %lu", i);
+        output_length = 0;
+        report_counter(name, i);
+        // the id of the name frame, then the one of the counter frame
+        uint32_t counter = HEADER_SIZE + sizeof(uint16_t) + strlen(name) + CRC_SIZE;
+        uint32_t id = 2 + i;
+        ok &= output[1] == REPORT_FRAME_NAME && output[HEADER_SIZE] == (id & 0xFF) && output[HEADER_SIZE + 1] == id >> 8;
+        ok &= output_length == counter + HEADER_SIZE + COUNTER_SIZE + CRC_SIZE;
+        ok &= output[counter + HEADER_SIZE] == (id & 0xFF) && output[counter + HEADER_SIZE + 1] == id >> 8;
+    }
+    CHECK(ok);
+
+    output_length = 0;
+    report_counter("counter", 7);
+    CHECK(output[1] == REPORT_FRAME_COUNTER && output[HEADER_SIZE] == 0 && output[HEADER_SIZE + 1] == 0);
+}
@@ -0,0 +1,269 @@
+/**
+ ******************************************************************************
+ * @file    test_rng_pool.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   tests of the CTR-DRBG of the host build and of the pool
+ *
+ * Known answers of the DRBG, with AES-128 and AES-256, with and without
+ * additional input and after a reseed, and its errors. The pool gives the
+ * blocks of the DRBG in order, seeded by the sequence of the RNG model, also
+ * across the end of the ring and after a reseed; the errors of the RNG are
+ * recovered. The vectors were computed with a Python model of SP 800-90A.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "stm32l4xx_hal.h"
+
+#include "cmox_crypto.h"
+#include "host.h"
+#include "rng_model.h"
+#include "rng_pool.h"
+#include "test.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define OUTPUT_SIZE 64
+#define BUFFER_SIZE 2000 // larger than the pool
+#define CHECK_SIZE 16
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct {
+    const cmox_ctr_drbg_impl_t* impl;
+    size_t key_size;
+    bool additional;
+    const char* output;
+    const char* reseeded;
+} drbg_vector_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+// entropy 0, 1, 2..., nonce 0x40, 0x41... of half of it, the personalization
+// "personalization", two generations with the additional inputs 0x80... and
+// 0xa0... of 32 bytes, the second reported, then a reseed with the entropy
+// 0x20... and the additional input 0xc0... of 16 bytes and a generation
+static const drbg_vector_t drbg_vectors[] = {
+    {&CMOX_CTR_DRBG_AES128_FAST, 16, false,
+        "421c88ca2dc825f2ca9be3bbe38429396b92d071c14996bd7a2d12d472bd68b2"
+        "d0f2616d327582e4e7d4a879c8b398135517a46885a1050c781d46c72cdf835c",
+        "5332aab24c7fe69fac8e1dc709447e3d97110789be7d2b28c089b36eab04d87c"
+        "30cad389b1fb85b83a60f5068aead76aa48b76041ab9c9d013bec8fac614b78e"},
+    {&CMOX_CTR_DRBG_AES128_SMALL, 16, true,
+        "1fb2f28c66895aa0623250e7c6554d9f904e0f4024ac79ae4ff469f490ba7e9e"
+        "5cc762751c0e1edeb51adb7214dd42410edfceed6f65f2618e476d11910c84c7",
+        "8ec23fea1c191369ac51dca6fe88608698bd75c80fd885fb54b2f3d2369d8855"
+        "be34719c612b3e2dd557843b9142a65d0eafa4e38338db5d80ab9c1577b83b06"},
+    {&CMOX_CTR_DRBG_AES256_SMALL, 32, false,
+        "eca008535c1279a0d386ef7dd1205f7d538c7bd89c8ccc46b686682d66a3a7b7"
+        "289596938ce86bc94bfef50ef3afecebc980965f4ed9d3d34c93fdd0a9a43fbb",
+        "347bf016682cb49e177cd8575b089c00032a514d37adf7c4c0704344e17a7717"
+        "12e9ca506f57b576f08f4e1df2a4858b911e328faff29efb2497a682702d759a"},
+    {&CMOX_CTR_DRBG_AES256_FAST, 32, true,
+        "4e370c63c98baeb4f0a625e68921c3f8dc16beece109eefd51d8d4e853f916fc"
+        "b5b546ca5ed4e357d3a97d1ae9a2f739b041fdb28cd4c0a6bbd16d8628c1dbe6",
+        "a358e8283fa7388e383c41d7cbb90231536efa91c645458f1d395277d0993959"
+        "f729c07aeabe8d756259863b1a3ec444e31db1c896c7e1f926f51f5d2991c5e9"},
+};
+
+static const char personalization[] = "personalization";
+
+// the pool seeded by the words of the model from the first one
+static const char first_nonce[] = "48492ed8d8ebae81c6dfed03";
+static const char end_of_pool[] = "2afead0bc8e8a83189978b1163d8f028";
+static const char wrapped[] = "de83e6a16af1c17f289b01c5c124e54e0e814ea9";
+static const char fallback_end[] = "eea92b2ba0998428bec31a3d616b3a6c";
+static const char first_reseed[] = "8cb227f8c1c6dc5bdac2293dab08582a";
+static const char second_reseed[] = "aad17f663e714040369fd47963cf8fc9";
+
+static uint8_t buffer[BUFFER_SIZE];
+static uint8_t expected[BUFFER_SIZE];
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void run(void);
+static void test_drbg(const drbg_vector_t* vector);
+static void test_drbg_errors(void);
+static void test_pool(void);
+static void drain_until_reseed(uint32_t reseeds);
+static void test_pool_errors(void);
+static void fill(uint8_t* data, uint32_t length, uint8_t first);
+static bool check_hex(const uint8_t* data, const char* hex);
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    host_init();
+    host_run(run);
+    return test_result();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void run(void)
+{
+    HAL_Init();
+
+    for (uint32_t i = 0; i < sizeof(drbg_vectors) / sizeof(drbg_vectors[0]); i++) {
+        test_drbg(&drbg_vectors[i]);
+    }
+    test_drbg_errors();
+    test_pool();
+    test_pool_errors();
+}
+
+static void test_drbg(const drbg_vector_t* vector)
+{
+    cmox_ctr_drbg_handle_t handle;
+    uint8_t entropy[32];
+    uint8_t nonce[16];
+    uint8_t additional[3][32];
+    uint8_t output[OUTPUT_SIZE];
+    size_t additional_size = vector->additional ? sizeof(additional[0]) : 0;
+
+    fill(entropy, vector->key_size, 0x00);
+    fill(nonce, vector->key_size / 2, 0x40);
+    for (uint32_t i = 0; i < 3; i++) {
+        fill(additional[i], sizeof(additional[i]), 0x80 + 0x20 * i);
+    }
+
+    cmox_drbg_handle_t* drbg = cmox_ctr_drbg_construct(&handle, *vector->impl);
+    CHECK(drbg != NULL);
+    CHECK(cmox_drbg_init(drbg, entropy, vector->key_size, (const uint8_t*)personalization,
+            sizeof(personalization) - 1, nonce, vector->key_size / 2) == CMOX_DRBG_SUCCESS);
+    CHECK(cmox_drbg_generate(drbg, additional[0], additional_size, output, sizeof(output)) == CMOX_DRBG_SUCCESS);
+    CHECK(cmox_drbg_generate(drbg, additional[1], additional_size, output, sizeof(output)) == CMOX_DRBG_SUCCESS);
+    CHECK(check_hex(output, vector->output));
+
+    fill(entropy, vector->key_size, 0x20);
+    CHECK(cmox_drbg_reseed(drbg, entropy, vector->key_size, additional[2], additional_size / 2)
+            == CMOX_DRBG_SUCCESS);
+    CHECK(cmox_drbg_generate(drbg, NULL, 0, output, sizeof(output)) == CMOX_DRBG_SUCCESS);
+    CHECK(check_hex(output, vector->reseeded));
+    CHECK(cmox_drbg_cleanup(drbg) == CMOX_DRBG_SUCCESS);
+}
+
+static void test_drbg_errors(void)
+{
+    cmox_ctr_drbg_handle_t handle;
+    uint8_t entropy[32];
+    uint8_t nonce[16];
+
+    fill(entropy, sizeof(entropy), 0x00);
+    fill(nonce, sizeof(nonce), 0x40);
+
+    cmox_drbg_handle_t* drbg = cmox_ctr_drbg_construct(&handle, CMOX_CTR_DRBG_AES256_FAST);
+    CHECK(cmox_drbg_generate(drbg, NULL, 0, buffer, CHECK_SIZE) == CMOX_DRBG_ERR_UNINIT_STATE);
+    CHECK(cmox_drbg_init(drbg, entropy, sizeof(entropy) - 1, NULL, 0, nonce, sizeof(nonce))
+            == CMOX_DRBG_ERR_BAD_ENTROPY_SIZE);
+    CHECK(cmox_drbg_init(drbg, entropy, sizeof(entropy), NULL, 0, nonce, sizeof(nonce) - 1)
+            == CMOX_DRBG_ERR_BAD_NONCE_SIZE);
+    CHECK(cmox_drbg_init(drbg, entropy, sizeof(entropy), NULL, 0, nonce, sizeof(nonce)) == CMOX_DRBG_SUCCESS);
+    CHECK(cmox_drbg_generate(drbg, NULL, 0, buffer, 65537) == CMOX_DRBG_ERR_BAD_REQUEST);
+    CHECK(cmox_drbg_reseed(drbg, entropy, sizeof(entropy) - 1, NULL, 0) == CMOX_DRBG_ERR_BAD_ENTROPY_SIZE);
+    CHECK(cmox_drbg_generate(drbg, NULL, 0, buffer, CHECK_SIZE) == CMOX_DRBG_SUCCESS);
+    CHECK(cmox_drbg_cleanup(drbg) == CMOX_DRBG_SUCCESS);
+}
+
+static void test_pool(void)
+{
+    rng_pool_stats_t stats;
+
+    CHECK(rng_pool_init());
+    rng_pool_get_stats(&stats);
+    CHECK(rng_pool_available() == RNG_POOL_SIZE);
+    CHECK(stats.refills == RNG_POOL_SIZE / RNG_POOL_BLOCK_SIZE);
+    CHECK(stats.errors == 0);
+    // the seed and its nonce polled, the entropy of the reseed by the interrupt
+    CHECK(rng_model_get_words() == 20);
+
+    CHECK(rng_pool_get(buffer, 12));
+    CHECK(check_hex(buffer, first_nonce));
+    CHECK(rng_pool_get(buffer, RNG_POOL_SIZE - 24));
+    CHECK(check_hex(&buffer[RNG_POOL_SIZE - 24 - CHECK_SIZE], end_of_pool));
+    CHECK(rng_pool_available() == 12);
+
+    // the next block is at the start of the ring
+    CHECK(rng_pool_process());
+    CHECK(rng_pool_get(buffer, 20));
+    CHECK(check_hex(buffer, wrapped));
+    CHECK(rng_pool_available() == RNG_POOL_BLOCK_SIZE - 8);
+
+    CHECK(rng_pool_get(buffer, BUFFER_SIZE));
+    CHECK(check_hex(&buffer[BUFFER_SIZE - CHECK_SIZE], fallback_end));
+    rng_pool_get_stats(&stats);
+    CHECK(stats.fallbacks == 1);
+    CHECK(rng_pool_available() == RNG_POOL_BLOCK_SIZE - 8);
+
+    // the entropy collected at startup, then the next one by the interrupt
+    drain_until_reseed(1);
+    rng_pool_get_stats(&stats);
+    CHECK(stats.refills == RNG_POOL_RESEED_BLOCKS + 1);
+    CHECK(rng_model_get_words() == 28);
+    CHECK(rng_pool_generate(buffer, CHECK_SIZE));
+    CHECK(check_hex(buffer, first_reseed));
+}
+
+static void drain_until_reseed(uint32_t reseeds)
+{
+    rng_pool_stats_t stats;
+
+    do {
+        CHECK(rng_pool_get(buffer, rng_pool_available()));
+        while (rng_pool_process()) {
+        }
+        rng_pool_get_stats(&stats);
+    } while (stats.reseeds < reseeds);
+    CHECK(stats.reseeds == reseeds);
+    CHECK(rng_pool_available() == RNG_POOL_SIZE);
+}
+
+static void test_pool_errors(void)
+{
+    rng_pool_stats_t stats;
+
+    // a seed error during the collection discards the words already read
+    rng_model_inject_error(RNG_SR_SEIS);
+    SET_BIT(RNG->CR, RNG_CR_IE);
+    rng_pool_get_stats(&stats);
+    CHECK(stats.errors == 1);
+    CHECK(rng_model_get_words() == 36);
+    CHECK((RNG->SR & (RNG_SR_SEIS | RNG_SR_SECS)) == 0);
+    CHECK((RNG->CR & RNG_CR_IE) == 0);
+
+    drain_until_reseed(2);
+    CHECK(rng_pool_generate(buffer, CHECK_SIZE));
+    CHECK(check_hex(buffer, second_reseed));
+
+    // a clock error during the seed of the startup
+    rng_model_inject_error(RNG_SR_CEIS);
+    CHECK(rng_pool_init());
+    rng_pool_get_stats(&stats);
+    CHECK(stats.errors == 1);
+    CHECK((RNG->SR & (RNG_SR_CEIS | RNG_SR_CECS)) == 0);
+    CHECK(rng_pool_available() == RNG_POOL_SIZE);
+}
+
+static void fill(uint8_t* data, uint32_t length, uint8_t first)
+{
+    for (uint32_t i = 0; i < length; i++) {
+        data[i] = first + i;
+    }
+}
+
+static bool check_hex(const uint8_t* data, const char* hex)
+{
+    uint32_t length = test_hex(hex, expected);
+
+    return memcmp(data, expected, length) == 0;
+}
@@ -0,0 +1,298 @@
+/**
+ ******************************************************************************
+ * @file    test_xts_keywrap.c
+ * @author  nicolas.brunner@heig-vd.ch
+ * @date    16-October-2026
+ * @brief   tests of the XTS and the Key Wrap of the CMOX shim
+ *
+ * The outputs are checked against IEEE 1619 and RFC 3394, the handles
+ * streaming the sectors against the one-shot functions.
+ ******************************************************************************
+ * @copyright HEIG-VD
+ *
+ * License information
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "cmox_crypto.h"
+
+#include "test.h"
+
+/* Private define ------------------------------------------------------------*/
+
+#define MAX_LENGTH 4096
+#define SECTOR_SIZE 512
+#define SECTORS 4
+#define FIRST_SECTOR 0x100
+#define TWEAK_SIZE 16
+#define SEMIBLOCK_SIZE 8
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef struct {
+    uint32_t key_size; // of each of the two keys
+    uint32_t sector;
+    uint32_t length;
+    const char* output; // the last bytes for the long ones
+} xts_vector_t;
+
+typedef struct {
+    uint32_t kek_size;
+    uint32_t key_size;
+    const char* output;
+} keywrap_vector_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+// keys 0, 1, 2..., data 0, 1, 2..., the tweak is the sector number
+static const xts_vector_t xts_vectors[] = {
+    {16, 5, 64, "2dbdc260709c00db30639a42ffb50a6780a3b540429e484f806e2198d6a90ecf"
+            "0bfc60bc5d580d3efe60032b5eb1049682fe5c904ec23a87c59d52fe3ecd0ae6"},
+    {16, 5, 17, "fd5d879923f47c9cd11911fa4884f6b22d"},
+    {16, 5, 47, "2dbdc260709c00db30639a42ffb50a67d50be59190a86836fd88c6213b7ee9d"
+            "280a3b540429e484f806e2198d6a90e"},
+    {32, 0x12345678, 64, "60dae7ec0d3b5c0fa999df0fda183cb2f26c49b80b935fa2bca412b31c668d48"
+            "66aec6ec8aa1448a69024aff76c9f323a6f0c709dbaf543a1429a948a473c78c"},
+    {32, 0x12345678, 4096, "a5384cc8876eabbaddf8492310d4f6157fef8ca561a7f843064fe177f5a9a70b"},
+    {32, 0x12345678, 4095, "41f500ca03dec5383b5fc4d912e4d2e589a5384cc8876eabbaddf8492310d4f6"},
+};
+
+// the first bytes of the sectors FIRST_SECTOR + s, data s, s + 1, s + 2...
+static const char* const sector_outputs[SECTORS] = {
+    "eef211c870e4578542e1b437264b078a",
+    "897bf4322cab1eafaacc3ffeb16c22f0",
+    "2acc3343ee4b739dde9a4b66c7c94adc",
+    "15064d9b3bb186855943f20a30cdc3d3",
+};
+
+// KEK 0, 1, 2..., key 00112233445566778899aabbccddeeff00010203...
+static const keywrap_vector_t keywrap_vectors[] = {
+    {16, 16, "1fa68b0a8112b447aef34bd8fb5a7b829d3e862371d2cfe5"},
+    {24, 24, "031d33264e15d33268f24ec260743edce1c6c7ddee725a936ba814915c6762d2"},
+    {32, 32, "28c9f404c4b810f4cbccb35cfb87f8263f5786e2d80ed326cbc7f0e71a99f43bfb988b9b7a02dd21"},
+    {16, 32, "11826840774d993ff9c2fa02cca3cea0e93b1e1cf96361f93ea6dc2f345194e7b30f964c79f9e61d"},
+};
+
+static const uint8_t default_iv[SEMIBLOCK_SIZE] = {0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6};
+
+static uint8_t key[64];
+static uint8_t plain_data[MAX_LENGTH];
+static uint8_t cipher_data[MAX_LENGTH];
+static uint8_t output[MAX_LENGTH];
+static uint8_t expected[MAX_LENGTH];
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void test_xts(void);
+static void test_xts_ieee(void);
+static void test_xts_sectors(void);
+static void test_xts_errors(void);
+static void test_keywrap(void);
+static void test_keywrap_errors(void);
+static void set_tweak(uint8_t* tweak, uint32_t sector);
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    for (uint32_t i = 0; i < sizeof(key); i++) {
+        key[i] = i;
+    }
+
+    test_xts();
+    test_xts_ieee();
+    test_xts_sectors();
+    test_xts_errors();
+    test_keywrap();
+    test_keywrap_errors();
+    return test_result();
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static void test_xts(void)
+{
+    for (uint32_t i = 0; i < sizeof(xts_vectors) / sizeof(xts_vectors[0]); i++) {
+        const xts_vector_t* vector = &xts_vectors[i];
+        uint8_t tweak[TWEAK_SIZE];
+        size_t computed = 0;
+
+        for (uint32_t j = 0; j < vector->length; j++) {
+            plain_data[j] = j;
+        }
+        set_tweak(tweak, vector->sector);
+        uint32_t size = test_hex(vector->output, expected);
+        CHECK(cmox_cipher_encrypt(CMOX_AESFAST_XTS_ENC_ALGO, plain_data, vector->length, key, 2 * vector->key_size,
+                tweak, TWEAK_SIZE, cipher_data, &computed) == CMOX_CIPHER_SUCCESS);
+        CHECK(computed == vector->length);
+        CHECK(memcmp(cipher_data + vector->length - size, expected, size) == 0);
+
+        // in place
+        memcpy(output, cipher_data, vector->length);
+        CHECK(cmox_cipher_decrypt(CMOX_AESSMALL_XTS_DEC_ALGO, output, vector->length, key, 2 * vector->key_size,
+                tweak, TWEAK_SIZE, output, &computed) == CMOX_CIPHER_SUCCESS);
+        CHECK(memcmp(output, plain_data, vector->length) == 0);
+    }
+}
+
+/**
+ * The first vector of IEEE 1619, the keys are null
+ */
+static void test_xts_ieee(void)
+{
+    uint8_t zero[32] = {0};
+    uint8_t tweak[TWEAK_SIZE] = {0};
+
+    test_hex("917cf69ebd68b2ec9b9fe9a3eadda692cd43d2f59598ed858c02c2652fbf922e", expected);
+    CHECK(cmox_cipher_encrypt(CMOX_AESFAST_XTS_ENC_ALGO, zero, sizeof(zero), zero, sizeof(zero),
+            tweak, TWEAK_SIZE, cipher_data, NULL) == CMOX_CIPHER_SUCCESS);
+    CHECK(memcmp(cipher_data, expected, sizeof(zero)) == 0);
+}
+
+/**
+ * A handle keyed once processes consecutive sectors, a sector in several
+ * appends of whole blocks
+ */
+static void test_xts_sectors(void)
+{
+    cmox_xts_handle_t encrypt_handle;
+    cmox_xts_handle_t decrypt_handle;
+    cmox_cipher_handle_t* encrypt = cmox_xts_construct(&encrypt_handle, CMOX_AESFAST_XTS_ENC);
+    cmox_cipher_handle_t* decrypt = cmox_xts_construct(&decrypt_handle, CMOX_AESSMALL_XTS_DEC);
+
+    CHECK(encrypt != NULL && decrypt != NULL);
+    CHECK(cmox_cipher_init(encrypt) == CMOX_CIPHER_SUCCESS);
+    CHECK(cmox_cipher_init(decrypt) == CMOX_CIPHER_SUCCESS);
+    CHECK(cmox_cipher_setKey(encrypt, key, 32) == CMOX_CIPHER_SUCCESS);
+    CHECK(cmox_cipher_setKey(decrypt, key, 32) == CMOX_CIPHER_SUCCESS);
+
+    for (uint32_t s = 0; s < SECTORS; s++) {
+        uint8_t tweak[TWEAK_SIZE];
+        size_t computed = 0;
+
+        for (uint32_t i = 0; i < SECTOR_SIZE; i++) {
+            plain_data[i] = i + s;
+        }
+        set_tweak(tweak, FIRST_SECTOR + s);
+        CHECK(cmox_cipher_setIV(encrypt, tweak, TWEAK_SIZE) == CMOX_CIPHER_SUCCESS);
+        CHECK(cmox_cipher_append(encrypt, plain_data, 48, cipher_data, &computed) == CMOX_CIPHER_SUCCESS);
+        CHECK(computed == 48);
+        CHECK(cmox_cipher_append(encrypt, plain_data + 48, SECTOR_SIZE - 48, cipher_data + 48, NULL)
+                == CMOX_CIPHER_SUCCESS);
+        test_hex(sector_outputs[s], expected);
+        CHECK(memcmp(cipher_data, expected, TWEAK_SIZE) == 0);
+
+        // the one-shot function gives the whole sector
+        CHECK(cmox_cipher_encrypt(CMOX_AESFAST_XTS_ENC_ALGO, plain_data, SECTOR_SIZE, key, 32,
+                tweak, TWEAK_SIZE, output, NULL) == CMOX_CIPHER_SUCCESS);
+        CHECK(memcmp(cipher_data, output, SECTOR_SIZE) == 0);
+
+        CHECK(cmox_cipher_setIV(decrypt, tweak, TWEAK_SIZE) == CMOX_CIPHER_SUCCESS);
+        CHECK(cmox_cipher_append(decrypt, cipher_data, SECTOR_SIZE, cipher_data, NULL) == CMOX_CIPHER_SUCCESS);
+        CHECK(memcmp(cipher_data, plain_data, SECTOR_SIZE) == 0);
+    }
+    CHECK(cmox_cipher_cleanup(encrypt) == CMOX_CIPHER_SUCCESS);
+    CHECK(cmox_cipher_cleanup(decrypt) == CMOX_CIPHER_SUCCESS);
+}
+
+static void test_xts_errors(void)
+{
+    cmox_xts_handle_t handle;
+    cmox_cipher_handle_t* cipher = cmox_xts_construct(&handle, CMOX_AESFAST_XTS_ENC);
+    uint8_t tweak[TWEAK_SIZE] = {0};
+
+    CHECK(cmox_cipher_init(cipher) == CMOX_CIPHER_SUCCESS);
+    CHECK(cmox_cipher_setKey(cipher, key, 48) == CMOX_CIPHER_SUCCESS);
+    CHECK(cmox_cipher_setKey(cipher, key, 40) == CMOX_CIPHER_ERR_BAD_PARAMETER);
+    CHECK(cmox_cipher_setKey(cipher, key, 33) == CMOX_CIPHER_ERR_BAD_PARAMETER);
+    CHECK(cmox_cipher_setIV(cipher, tweak, 8) == CMOX_CIPHER_ERR_BAD_PARAMETER);
+    CHECK(cmox_cipher_setIV(cipher, tweak, TWEAK_SIZE) == CMOX_CIPHER_SUCCESS);
+    CHECK(cmox_cipher_append(cipher, plain_data, 15, cipher_data, NULL) == CMOX_CIPHER_ERR_BAD_INPUT_SIZE);
+
+    // a partial block ends the data unit until the next tweak
+    CHECK(cmox_cipher_append(cipher, plain_data, 20, cipher_data, NULL) == CMOX_CIPHER_SUCCESS);
+    CHECK(cmox_cipher_append(cipher, plain_data, 16, cipher_data, NULL) == CMOX_CIPHER_ERR_BAD_OPERATION);
+    CHECK(cmox_cipher_setIV(cipher, tweak, TWEAK_SIZE) == CMOX_CIPHER_SUCCESS);
+    CHECK(cmox_cipher_append(cipher, plain_data, 16, cipher_data, NULL) == CMOX_CIPHER_SUCCESS);
+    CHECK(cmox_cipher_cleanup(cipher) == CMOX_CIPHER_SUCCESS);
+}
+
+static void test_keywrap(void)
+{
+    uint8_t key_data[32];
+    uint8_t zero[32] = {0};
+
+    test_hex("00112233445566778899aabbccddeeff000102030405060708090a0b0c0d0e0f", key_data);
+    for (uint32_t i = 0; i < sizeof(keywrap_vectors) / sizeof(keywrap_vectors[0]); i++) {
+        const keywrap_vector_t* vector = &keywrap_vectors[i];
+        size_t computed = 0;
+
+        uint32_t size = test_hex(vector->output, expected);
+        CHECK(size == vector->key_size + SEMIBLOCK_SIZE);
+        CHECK(cmox_cipher_encrypt(CMOX_AESFAST_KEYWRAP_ENC_ALGO, key_data, vector->key_size, key, vector->kek_size,
+                default_iv, SEMIBLOCK_SIZE, cipher_data, &computed) == CMOX_CIPHER_SUCCESS);
+        CHECK(computed == size);
+        CHECK(memcmp(cipher_data, expected, size) == 0);
+
+        memset(output, 0, sizeof(output));
+        CHECK(cmox_cipher_decrypt(CMOX_AESSMALL_KEYWRAP_DEC_ALGO, cipher_data, size, key, vector->kek_size,
+                default_iv, SEMIBLOCK_SIZE, output, &computed) == CMOX_CIPHER_AUTH_SUCCESS);
+        CHECK(computed == vector->key_size);
+        CHECK(memcmp(output, key_data, vector->key_size) == 0);
+
+        // a corrupted wrapped key is rejected and not output
+        cipher_data[size - 1] ^= 1;
+        CHECK(cmox_cipher_decrypt(CMOX_AESFAST_KEYWRAP_DEC_ALGO, cipher_data, size, key, vector->kek_size,
+                default_iv, SEMIBLOCK_SIZE, output, NULL) == CMOX_CIPHER_AUTH_FAIL);
+        CHECK(memcmp(output, zero, vector->key_size) == 0);
+    }
+
+    // in place through a handle
+    cmox_keywrap_handle_t handle;
+    cmox_cipher_handle_t* cipher = cmox_keywrap_construct(&handle, CMOX_AESFAST_KEYWRAP_ENC);
+    memcpy(output, key_data, 16);
+    CHECK(cmox_cipher_init(cipher) == CMOX_CIPHER_SUCCESS);
+    CHECK(cmox_cipher_setKey(cipher, key, 16) == CMOX_CIPHER_SUCCESS);
+    CHECK(cmox_cipher_setIV(cipher, default_iv, SEMIBLOCK_SIZE) == CMOX_CIPHER_SUCCESS);
+    CHECK(cmox_cipher_append(cipher, output, 16, output, NULL) == CMOX_CIPHER_SUCCESS);
+    test_hex(keywrap_vectors[0].output, expected);
+    CHECK(memcmp(output, expected, 16 + SEMIBLOCK_SIZE) == 0);
+    CHECK(cmox_cipher_cleanup(cipher) == CMOX_CIPHER_SUCCESS);
+}
+
+static void test_keywrap_errors(void)
+{
+    uint8_t other_iv[SEMIBLOCK_SIZE] = {0};
+
+    // one semiblock is not wrapped, the length is a multiple of the semiblock
+    CHECK(cmox_cipher_encrypt(CMOX_AESFAST_KEYWRAP_ENC_ALGO, plain_data, 8, key, 16,
+            default_iv, SEMIBLOCK_SIZE, cipher_data, NULL) == CMOX_CIPHER_ERR_BAD_INPUT_SIZE);
+    CHECK(cmox_cipher_encrypt(CMOX_AESFAST_KEYWRAP_ENC_ALGO, plain_data, 20, key, 16,
+            default_iv, SEMIBLOCK_SIZE, cipher_data, NULL) == CMOX_CIPHER_ERR_BAD_INPUT_SIZE);
+    CHECK(cmox_cipher_encrypt(CMOX_AESFAST_KEYWRAP_ENC_ALGO, plain_data, 16, key, 16,
+            default_iv, 16, cipher_data, NULL) == CMOX_CIPHER_ERR_BAD_PARAMETER);
+
+    // the IV of the unwrap must be the one of the wrap
+    CHECK(cmox_cipher_encrypt(CMOX_AESFAST_KEYWRAP_ENC_ALGO, plain_data, 16, key, 16,
+            other_iv, SEMIBLOCK_SIZE, cipher_data, NULL) == CMOX_CIPHER_SUCCESS);
+    CHECK(cmox_cipher_decrypt(CMOX_AESFAST_KEYWRAP_DEC_ALGO, cipher_data, 24, key, 16,
+            default_iv, SEMIBLOCK_SIZE, output, NULL) == CMOX_CIPHER_AUTH_FAIL);
+    CHECK(cmox_cipher_decrypt(CMOX_AESFAST_KEYWRAP_DEC_ALGO, cipher_data, 24, key, 16,
+            other_iv, SEMIBLOCK_SIZE, output, NULL) == CMOX_CIPHER_AUTH_SUCCESS);
+}
+
+/**
+ * The tweak is the sector number, little-endian (IEEE 1619)
+ */
+static void set_tweak(uint8_t* tweak, uint32_t sector)
+{
+    memset(tweak, 0, TWEAK_SIZE);
+    for (int i = 0; i < 4; i++) {
+        tweak[i] = sector >> (8 * i);
+    }
+}